@@ -99,6 +99,7 @@ int dgst_main(int argc, char **argv)
     char *mac_name = NULL;
     char *passinarg = NULL, *passin = NULL;
     const EVP_MD *md = NULL, *m;
+    EVP_MD *fetched_md = NULL;
     const char *outfile = NULL, *keyfile = NULL, *prog = NULL;
     const char *sigfile = NULL;
     const char *md_name = NULL;
@@ -205,7 +206,12 @@ int dgst_main(int argc, char **argv)
                 goto opthelp;
             break;
         case OPT_DIGEST:
-            if (!opt_md(opt_unknown(), &m))
+            /* Some digests are only available from providers */
+            EVP_MD_free(fetched_md);
+            fetched_md = NULL;
+            if ((m = EVP_get_digestbyname(opt_unknown())) == NULL)
+                m = fetched_md = EVP_MD_fetch(NULL, opt_unknown(), NULL);
+            if (m == NULL && !opt_md(opt_unknown(), &m))
                 goto opthelp;
             md = m;
             break;
@@ -439,6 +445,7 @@ int dgst_main(int argc, char **argv)
     sk_OPENSSL_STRING_free(macopts);
     OPENSSL_free(sigbuf);
     BIO_free(bmd);
+    EVP_MD_free(fetched_md);
     release_engine(e);
     return ret;
 }
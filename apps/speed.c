@@ -1444,6 +1444,8 @@ int speed_main(int argc, char **argv)
     const char *prog;
     const char *engine_id = NULL;
     const EVP_CIPHER *evp_cipher = NULL;
+    EVP_CIPHER *fetched_cipher = NULL;
+    EVP_MD *fetched_md = NULL;
     double d = 0.0;
     OPTION_CHOICE o;
     int async_init = 0, multiblock = 0, pr_header = 0;
@@ -1618,9 +1620,19 @@ int speed_main(int argc, char **argv)
             break;
         case OPT_EVP:
             evp_md = NULL;
+            EVP_CIPHER_free(fetched_cipher);
+            fetched_cipher = NULL;
+            EVP_MD_free(fetched_md);
+            fetched_md = NULL;
             evp_cipher = EVP_get_cipherbyname(opt_arg());
+            /* Some ciphers are only available from providers */
+            if (evp_cipher == NULL)
+                evp_cipher = fetched_cipher =
+                    EVP_CIPHER_fetch(NULL, opt_arg(), NULL);
             if (evp_cipher == NULL)
                 evp_md = EVP_get_digestbyname(opt_arg());
+            if (evp_cipher == NULL && evp_md == NULL)
+                evp_md = fetched_md = EVP_MD_fetch(NULL, opt_arg(), NULL);
             if (evp_cipher == NULL && evp_md == NULL) {
                 BIO_printf(bio_err,
                            "%s: %s is an unknown cipher or digest\n",
@@ -2743,10 +2755,16 @@ int speed_main(int argc, char **argv)
                 goto end;
             }
 
-            names[D_EVP] = OBJ_nid2ln(EVP_CIPHER_nid(evp_cipher));
+            if (EVP_CIPHER_nid(evp_cipher) != NID_undef)
+                names[D_EVP] = OBJ_nid2ln(EVP_CIPHER_nid(evp_cipher));
+            else
+                names[D_EVP] = EVP_CIPHER_name(evp_cipher);
 
             if (EVP_CIPHER_mode(evp_cipher) == EVP_CIPH_CCM_MODE) {
                 loopfunc = EVP_Update_loop_ccm;
+            } else if (EVP_CIPHER_mode(evp_cipher) == EVP_CIPH_GCM_SIV_MODE) {
+                /* GCM-SIV only takes whole messages, so time those */
+                loopfunc = EVP_Update_loop_aead;
             } else if (aead && (EVP_CIPHER_flags(evp_cipher) &
                                 EVP_CIPH_FLAG_AEAD_CIPHER)) {
                 loopfunc = EVP_Update_loop_aead;
@@ -2800,7 +2818,10 @@ int speed_main(int argc, char **argv)
                 print_result(D_EVP, testnum, count, d);
             }
         } else if (evp_md != NULL) {
-            names[D_EVP] = OBJ_nid2ln(EVP_MD_type(evp_md));
+            if (EVP_MD_type(evp_md) != NID_undef)
+                names[D_EVP] = OBJ_nid2ln(EVP_MD_type(evp_md));
+            else
+                names[D_EVP] = EVP_MD_name(evp_md);
 
             for (testnum = 0; testnum < size_num; testnum++) {
                 print_message(names[D_EVP], c[D_EVP][testnum], lengths[testnum],
@@ -3694,6 +3715,8 @@ int speed_main(int argc, char **argv)
 
  end:
     ERR_print_errors(bio_err);
+    EVP_CIPHER_free(fetched_cipher);
+    EVP_MD_free(fetched_md);
     for (i = 0; i < loopargs_len; i++) {
         OPENSSL_free(loopargs[i].buf_malloc);
         OPENSSL_free(loopargs[i].buf2_malloc);
@@ -0,0 +1,385 @@
+#! /usr/bin/env perl
+# Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+#
+# Licensed under the Apache License 2.0 (the "License").  You may not use
+# this file except in compliance with the License.  You can obtain a copy
+# in the file LICENSE in the source distribution or at
+# https://www.openssl.org/source/license.html
+
+#
+# AES-XTS with 512-bit VAES and VPCLMULQDQ.
+#
+# aesni_xts_[en|de]crypt in aesni-x86_64.pl do six blocks at a time and
+# compute each tweak from the previous one.  On processors with AVX-512
+# and VAES, Ice Lake and later, this module does 16 blocks, four per %zmm
+# register, per iteration.  The tweaks are kept four per register too, and
+# all four registers are advanced by alpha^16 at once: that is a two byte
+# shift of each 128-bit lane, with the bits shifted out folded back in
+# with one carry-less multiplication by the XTS polynomial.  The blocks
+# left over are done one at a time, including ciphertext stealing, so the
+# functions are drop-in replacements for aesni_xts_[en|de]crypt.
+#
+# Only %xmm0-5 and %xmm16-31 are used, and no stack, so that nothing
+# needs to be saved on Win64 either.
+
+# $output is the last argument if it looks like a file (it has an extension)
+# $flavour is the first argument if it doesn't look like a file
+$output = $#ARGV >= 0 && $ARGV[$#ARGV] =~ m|\.\w+$| ? pop : undef;
+$flavour = $#ARGV >= 0 && $ARGV[0] !~ m|\.| ? shift : undef;
+
+$win64=0; $win64=1 if ($flavour =~ /[nm]asm|mingw64/ || $output =~ /\.asm$/);
+
+$0 =~ m/(.*[\/\\])[^\/\\]+$/; $dir=$1;
+( $xlate="${dir}x86_64-xlate.pl" and -f $xlate ) or
+( $xlate="${dir}../../perlasm/x86_64-xlate.pl" and -f $xlate) or
+die "can't locate x86_64-xlate.pl";
+
+if (`$ENV{CC} -Wa,-v -c -o /dev/null -x assembler /dev/null 2>&1`
+		=~ /GNU assembler version ([2-9]\.[0-9]+)/) {
+	$vaes = ($1>=2.30);
+}
+
+if (!$vaes && $win64 && ($flavour =~ /nasm/ || $ENV{ASM} =~ /nasm/) &&
+	    `nasm -v 2>&1` =~ /NASM version ([2-9]\.[0-9]+)/) {
+	$vaes = ($1>=2.14);
+}
+
+if (!$vaes && `$ENV{CC} -v 2>&1` =~ /((?:^clang|LLVM) version|.*based on LLVM) ([0-9]+\.[0-9]+)/) {
+	$vaes = ($2>=7.0);
+}
+
+open OUT,"| \"$^X\" \"$xlate\" $flavour \"$output\""
+    or die "can't call $xlate: $!";
+*STDOUT=*OUT;
+
+if ($vaes) {{{
+######################################################################
+#
+# void aesni_xts_[en|de]crypt_avx512(const unsigned char *inp,
+#		unsigned char *out, size_t len,
+#		const AES_KEY *key1, const AES_KEY *key2,
+#		const unsigned char iv[16]);
+#
+# Same as aesni_xts_[en|de]crypt, key1 and key2 are aesni_set_*_key
+# schedules.  len must be at least 16.
+my ($inp,$out,$len,$key1,$key2,$ivp)=$win64 ?
+	("%rcx","%rdx","%r8","%r9","%r10","%r11") :
+	("%rdi","%rsi","%rdx","%rcx","%r8","%r9");
+my $rem="%r11";				# len % 16, once $ivp is done with
+
+my @B=map("%zmm$_",(16..19));		# blocks
+my @T=map("%zmm$_",(20..23));		# tweaks, four per register
+my ($rndkey,$poly,$K0,$Klast)=map("%zmm$_",(24..27));
+my @L=map("%zmm$_",(28..31));		# last round key ^ tweaks
+my ($xt,$xt2,$xb)=("%xmm5","%xmm1","%xmm4");
+my $label=0;
+
+# Multiplies the tweak in $src by alpha into $dst.
+sub double {
+my ($dst,$src,$tmp)=@_;
+$code.=<<___;
+	vpshufd		\$0x13,$src,$tmp
+	vpsrad		\$31,$tmp,$tmp
+	vpand		.Lxts_magic(%rip),$tmp,$tmp
+	vpaddq		$src,$src,$dst
+	vpxor		$tmp,$dst,$dst
+___
+}
+
+# Instructions that multiply the tweaks in $t by alpha^(8*$n), $n bytes
+# being at most 8.
+sub advance {
+my ($n,@t)=@_;
+my @insn;
+
+    for (my $i=0; $i<@t; $i++) {
+	my ($t1,$t2)=map("%zmm$_",(2*($i%2),2*($i%2)+1));
+	push @insn,split /\n/,<<___;
+	vpsrldq		\$`16-$n`,$t[$i],$t1
+	vpclmulqdq	\$0x00,$poly,$t1,$t2
+	vpslldq		\$$n,$t[$i],$t[$i]
+	vpxorq		$t2,$t[$i],$t[$i]
+___
+    }
+    return @insn;
+}
+
+# Encrypts or decrypts the block in $blk with the schedule at $key.
+sub aes_1x {
+my ($dir,$blk,$key)=@_;
+my $loop=".Lxts_avx512_1x".$label++;
+
+$code.=<<___;
+	mov		240($key),%eax
+	vpxor		($key),$blk,$blk
+	lea		16($key),%r10
+$loop:
+	vaes$dir	(%r10),$blk,$blk
+	lea		16(%r10),%r10
+	dec		%eax
+	jnz		$loop
+	vaes${dir}last	(%r10),$blk,$blk
+___
+}
+
+# Encrypts or decrypts the next 16*$n bytes, $n being 1 or 4, with the
+# tweaks in @T and the instructions given spread over the rounds common
+# to all key sizes.
+sub aes_zmm {
+my ($dir,$n,@insn)=@_;
+my $per=int((@insn+8)/9);
+my $last=".Lxts_avx512_last".$label++;
+
+    for (my $i=0; $i<$n; $i++) {
+	$code.=<<___;
+	vmovdqu64	`64*$i`($inp),$B[$i]
+	vpternlogq	\$0x96,$K0,$T[$i],$B[$i]
+	vpxorq		$Klast,$T[$i],$L[$i]
+___
+    }
+    for (my $r=1; $r<14; $r++) {
+	$code.=<<___	if ($r==10);
+	cmpl		\$11,240($key1)
+	jb		$last
+___
+	$code.=<<___	if ($r==12);
+	je		$last
+___
+	$code.=<<___;
+	vbroadcasti32x4	`16*$r`($key1),$rndkey
+___
+	for (my $i=0; $i<$n; $i++) {
+	    $code.=<<___;
+	vaes$dir	$rndkey,$B[$i],$B[$i]
+___
+	}
+	$code.=join("\n",splice(@insn,0,$per))."\n"	if ($r<10 && @insn);
+    }
+    $code.="$last:\n";
+    for (my $i=0; $i<$n; $i++) {
+	$code.=<<___;
+	vaes${dir}last	$L[$i],$B[$i],$B[$i]
+	vmovdqu64	$B[$i],`64*$i`($out)
+___
+    }
+$code.=<<___;
+	lea		`64*$n`($inp),$inp
+	lea		`64*$n`($out),$out
+	sub		\$`64*$n`,$len
+___
+}
+
+sub xts_avx512 {
+my $dir=shift;
+my $enc=$dir eq "enc";
+my $pfx=".Lxts_${dir}_avx512";
+
+$code.=<<___;
+.globl	aesni_xts_${dir}rypt_avx512
+.type	aesni_xts_${dir}rypt_avx512,\@abi-omnipotent
+.align	32
+aesni_xts_${dir}rypt_avx512:
+.cfi_startproc
+	endbranch
+	cmp		\$16,$len
+	jb		${pfx}_abort
+___
+$code.=<<___	if ($win64);
+	mov		40(%rsp),$key2
+	mov		48(%rsp),$ivp
+___
+$code.=<<___;
+	vmovdqu		($ivp),%xmm0
+___
+	&aes_1x("enc","%xmm0",$key2);		# the first tweak
+$code.=<<___;
+	vbroadcasti32x4	.Lxts_poly(%rip),$poly
+___
+    # The first eight tweaks one by one, the next eight eight blocks on
+    for (my $i=0; $i<8; $i++) {
+	my $t=$T[$i/4];
+	$code.=<<___;
+	vinserti32x4	\$`$i%4`,%xmm0,$t,$t
+___
+	&double("%xmm0","%xmm0","%xmm1")	if ($i<7);
+    }
+$code.=<<___;
+	vmovdqa64	$T[0],$T[2]
+	vmovdqa64	$T[1],$T[3]
+___
+$code.=join("\n",&advance(1,@T[2..3]))."\n";
+$code.=<<___;
+	vbroadcasti32x4	($key1),$K0
+	mov		240($key1),%eax
+	shl		\$4,%eax
+	vbroadcasti32x4	16($key1,%rax),$Klast
+
+	mov		$len,$rem
+	and		\$15,$rem
+	and		\$-16,$len
+	jz		${pfx}_1x		# can't happen, len >= 16
+	test		$rem,$rem
+	jz		${pfx}_16x
+	sub		\$16,$len		# last block is for stealing
+	jmp		${pfx}_16x
+
+.align	32
+${pfx}_16x_loop:
+___
+	&aes_zmm($dir,4,&advance(2,@T));
+$code.=<<___;
+${pfx}_16x:
+	cmp		\$0x100,$len
+	jae		${pfx}_16x_loop
+
+	cmp		\$0x40,$len
+	jb		${pfx}_1x
+${pfx}_4x_loop:
+___
+	&aes_zmm($dir,1);
+$code.=<<___;
+	vmovdqa64	$T[1],$T[0]
+	vmovdqa64	$T[2],$T[1]
+	vmovdqa64	$T[3],$T[2]
+	cmp		\$0x40,$len
+	jae		${pfx}_4x_loop
+
+${pfx}_1x:
+	vmovdqa64	%xmm20,$xt		# the next tweak
+	test		$len,$len
+	jz		${pfx}_steal
+${pfx}_1x_loop:
+	vpxor		($inp),$xt,$xb
+___
+	&aes_1x($dir,$xb,$key1);
+$code.=<<___;
+	vpxor		$xt,$xb,$xb
+	vmovdqu		$xb,($out)
+	lea		16($inp),$inp
+	lea		16($out),$out
+___
+	&double($xt,$xt,"%xmm0");
+$code.=<<___;
+	sub		\$16,$len
+	jnz		${pfx}_1x_loop
+
+${pfx}_steal:
+	test		$rem,$rem
+	jz		${pfx}_done
+___
+    # When decrypting, the last whole block goes with the tweak after the
+    # one of the partial block
+    my ($tfull,$tpart)=$enc ? ($xt,$xt2) : ($xt2,$xt);
+	&double($xt2,$xt,"%xmm0")	if (!$enc);
+$code.=<<___;
+	vpxor		($inp),$tfull,$xb
+___
+	&aes_1x($dir,$xb,$key1);
+$code.=<<___;
+	vpxor		$tfull,$xb,$xb
+	vmovdqu		$xb,($out)
+	lea		16($inp),$inp
+	lea		16($out),$out
+	mov		$rem,$len
+${pfx}_steal_loop:
+	movzb		($inp),%eax
+	movzb		-16($out),%r10d
+	lea		1($inp),$inp
+	mov		%al,-16($out)
+	mov		%r10b,($out)
+	lea		1($out),$out
+	dec		$rem
+	jnz		${pfx}_steal_loop
+
+	sub		$len,$out
+___
+	&double($xt2,$xt,"%xmm0")	if ($enc);
+$code.=<<___;
+	vpxor		-16($out),$tpart,$xb
+___
+	&aes_1x($dir,$xb,$key1);
+$code.=<<___;
+	vpxor		$tpart,$xb,$xb
+	vmovdqu		$xb,-16($out)
+
+${pfx}_done:
+	vpxor		%xmm0,%xmm0,%xmm0	# wipe the tweaks
+	vpxor		%xmm1,%xmm1,%xmm1
+	vpxor		%xmm5,%xmm5,%xmm5
+	vpxorq		%xmm20,%xmm20,%xmm20
+	vpxorq		%xmm21,%xmm21,%xmm21
+	vpxorq		%xmm22,%xmm22,%xmm22
+	vpxorq		%xmm23,%xmm23,%xmm23
+	vzeroupper
+${pfx}_abort:
+	ret
+.cfi_endproc
+.size	aesni_xts_${dir}rypt_avx512,.-aesni_xts_${dir}rypt_avx512
+___
+}
+
+$code=<<___;
+.text
+
+# int aesni_xts_avx512_eligible(void);
+#
+# Returns 1 as the functions below are real, the caller checks
+# OPENSSL_ia32cap_P for the processor features.
+.globl	aesni_xts_avx512_eligible
+.type	aesni_xts_avx512_eligible,\@abi-omnipotent
+.align	32
+aesni_xts_avx512_eligible:
+.cfi_startproc
+	mov	\$1,%eax
+	ret
+.cfi_endproc
+.size	aesni_xts_avx512_eligible,.-aesni_xts_avx512_eligible
+___
+&xts_avx512("enc");
+&xts_avx512("dec");
+
+$code.=<<___;
+.align	64
+.Lxts_magic:
+	.long	0x87,0,1,0
+.Lxts_poly:
+	.quad	0x87,0
+.asciz	"AVX-512 VAES XTS module for x86_64"
+.align	64
+___
+}}} else {{{
+$code=<<___;	# assembler is too old
+.text
+
+.globl	aesni_xts_encrypt_avx512
+.type	aesni_xts_encrypt_avx512,\@abi-omnipotent
+aesni_xts_encrypt_avx512:
+.cfi_startproc
+	ud2
+.cfi_endproc
+.size	aesni_xts_encrypt_avx512,.-aesni_xts_encrypt_avx512
+
+.globl	aesni_xts_decrypt_avx512
+.type	aesni_xts_decrypt_avx512,\@abi-omnipotent
+aesni_xts_decrypt_avx512:
+.cfi_startproc
+	ud2
+.cfi_endproc
+.size	aesni_xts_decrypt_avx512,.-aesni_xts_decrypt_avx512
+
+.globl	aesni_xts_avx512_eligible
+.type	aesni_xts_avx512_eligible,\@abi-omnipotent
+aesni_xts_avx512_eligible:
+.cfi_startproc
+	xor	%eax,%eax
+	ret
+.cfi_endproc
+.size	aesni_xts_avx512_eligible,.-aesni_xts_avx512_eligible
+___
+}}}
+
+$code =~ s/\`([^\`]*)\`/eval($1)/gem;
+
+print $code;
+
+close STDOUT or die "error closing STDOUT: $!";
@@ -0,0 +1,354 @@
+#! /usr/bin/env perl
+# Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+#
+# Licensed under the Apache License 2.0 (the "License").  You may not use
+# this file except in compliance with the License.  You can obtain a copy
+# in the file LICENSE in the source distribution or at
+# https://www.openssl.org/source/license.html
+
+#
+# BLAKE2b and BLAKE2s compression functions for ARMv8 NEON.
+#
+# As on x86_64, the state is held one row per vector, so the four G
+# functions of a step run in parallel and the rows are rotated between
+# the column and the diagonal step.  A BLAKE2s row fits in one register,
+# a BLAKE2b row takes two, and rotating the BLAKE2b rows is EXT on the
+# register pairs, or just swapping their names for the third row.
+#
+# BLAKE2s gathers the message words of a round with TBL over the whole
+# block, using a table of byte indices per round.  BLAKE2b moves them
+# into place two at a time with INS, as its block doesn't fit in the
+# four registers TBL can take.  Rotations by 32 and 16 bits are REV64
+# and REV32, by 24 and 8 bits TBL, and the rest USHR and SLI.
+
+# $output is the last argument if it looks like a file (it has an extension)
+# $flavour is the first argument if it doesn't look like a file
+$output = $#ARGV >= 0 && $ARGV[$#ARGV] =~ m|\.\w+$| ? pop : undef;
+$flavour = $#ARGV >= 0 && $ARGV[0] !~ m|\.| ? shift : undef;
+
+if ($flavour && $flavour ne "void") {
+    $0 =~ m/(.*[\/\\])[^\/\\]+$/; $dir=$1;
+    ( $xlate="${dir}arm-xlate.pl" and -f $xlate ) or
+    ( $xlate="${dir}../../perlasm/arm-xlate.pl" and -f $xlate) or
+    die "can't locate arm-xlate.pl";
+
+    open OUT,"| \"$^X\" $xlate $flavour \"$output\""
+        or die "can't call $xlate: $!";
+    *STDOUT=*OUT;
+} else {
+    $output and open STDOUT,">$output";
+}
+
+my @sigma = (
+	[  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 ],
+	[ 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 ],
+	[ 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 ],
+	[  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 ],
+	[  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 ],
+	[  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 ],
+	[ 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 ],
+	[ 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 ],
+	[  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 ],
+	[ 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0 ]
+);
+
+# Message words of round $r, in the order the steps take them: the
+# first and second word of each column, then of each diagonal
+sub order { my $s=$sigma[shift()%10]; map($$s[$_],(0,2,4,6,1,3,5,7,8,10,12,14,9,11,13,15)); }
+
+my ($ctx,$inp,$len,$tbl,$inc)=map("x$_",(0..4));
+
+$code=<<___;
+#include "arm_arch.h"
+
+.text
+___
+
+{
+# void blake2s_compress_neon(BLAKE2S_CTX *S, const uint8_t *blocks,
+#                            size_t len);
+#
+# Same contract as blake2s_compress() in C: len is either less than a
+# block, or a multiple of it.
+my ($a,$b,$c,$d,$ivlo,$ivhi)=map("v$_",(0..5));
+my @msg=map("v$_",(16..19));
+my @idx=map("v$_",(20..23));
+my @m=map("v$_",(24..27));
+my ($t,$ror8,$tf)=map("v$_",(28..30));
+my ($t0,$t1,$perm)=("w8","w9","x10");
+
+sub rot32 {
+my ($x,$n)=@_;
+    if ($n==16) {
+	$code.="\trev32	$x.8h,$t.8h\n";
+    } elsif ($n==8) {
+	$code.="\ttbl	$x.16b,{$t.16b},$ror8.16b\n";
+    } else {
+$code.=<<___;
+	ushr	$x.4s,$t.4s,#$n
+	sli	$x.4s,$t.4s,#`32-$n`
+___
+    }
+}
+
+sub half_g32 {
+my ($m,$r0,$r1)=@_;
+$code.=<<___;
+	add	$a.4s,$a.4s,$m.4s
+	add	$a.4s,$a.4s,$b.4s
+	eor	$t.16b,$d.16b,$a.16b
+___
+	&rot32($d,$r0);
+$code.=<<___;
+	add	$c.4s,$c.4s,$d.4s
+	eor	$t.16b,$b.16b,$c.16b
+___
+	&rot32($b,$r1);
+}
+
+$code.=<<___;
+.globl	blake2s_compress_neon
+.type	blake2s_compress_neon,%function
+.align	5
+blake2s_compress_neon:
+	mov	$inc,#64
+	cmp	$len,$inc
+	csel	$inc,$len,$inc,lo		// a partial block is the last one
+	ldp	$t0,$t1,[$ctx,#32]
+	adr	$tbl,.Lblake2s_iv
+	ld1	{$ivlo.4s,$ivhi.4s},[$tbl],#32
+	ld1	{$ror8.16b},[$tbl],#16		// $tbl now points at the indices
+	ld1	{$a.4s,$b.4s},[$ctx]
+	add	x11,$ctx,#40
+	b	.Loop_blake2s
+
+.align	4
+.Loop_blake2s:
+	ld1	{@msg[0].16b-@msg[3].16b},[$inp]
+	add	$inp,$inp,$inc
+	adds	$t0,$t0,w4
+	adc	$t1,$t1,wzr
+	mov	$c.16b,$ivlo.16b
+	ld1	{$tf.2s},[x11]			// f[0] and f[1]
+	fmov	s3,$t0
+	mov	$d.s[1],$t1
+	mov	$d.d[1],$tf.d[0]
+	eor	$d.16b,$d.16b,$ivhi.16b
+	mov	$perm,$tbl
+___
+    for (my $r=0; $r<10; $r++) {
+$code.=<<___;
+	ld1	{@idx[0].16b-@idx[3].16b},[$perm],#64
+	tbl	@m[0].16b,{@msg[0].16b-@msg[3].16b},@idx[0].16b
+	tbl	@m[1].16b,{@msg[0].16b-@msg[3].16b},@idx[1].16b
+	tbl	@m[2].16b,{@msg[0].16b-@msg[3].16b},@idx[2].16b
+	tbl	@m[3].16b,{@msg[0].16b-@msg[3].16b},@idx[3].16b
+___
+	&half_g32(@m[0],16,12);
+	&half_g32(@m[1],8,7);
+$code.=<<___;
+	ext	$b.16b,$b.16b,$b.16b,#4
+	ext	$c.16b,$c.16b,$c.16b,#8
+	ext	$d.16b,$d.16b,$d.16b,#12
+___
+	&half_g32(@m[2],16,12);
+	&half_g32(@m[3],8,7);
+$code.=<<___;
+	ext	$b.16b,$b.16b,$b.16b,#12
+	ext	$c.16b,$c.16b,$c.16b,#8
+	ext	$d.16b,$d.16b,$d.16b,#4
+___
+    }
+$code.=<<___;
+	ld1	{@m[0].4s,@m[1].4s},[$ctx]
+	eor	$a.16b,$a.16b,$c.16b
+	eor	$b.16b,$b.16b,$d.16b
+	eor	$a.16b,$a.16b,@m[0].16b
+	eor	$b.16b,$b.16b,@m[1].16b
+	st1	{$a.4s,$b.4s},[$ctx]
+	subs	$len,$len,$inc
+	b.ne	.Loop_blake2s
+
+	stp	$t0,$t1,[$ctx,#32]
+	ret
+.size	blake2s_compress_neon,.-blake2s_compress_neon
+___
+}
+
+{
+# void blake2b_compress_neon(BLAKE2B_CTX *S, const uint8_t *blocks,
+#                            size_t len);
+#
+# The rows are register pairs, low and high half.  The diagonal step
+# works on copies of the second and fourth row, which are moved back
+# in place afterwards, and on the third row with its halves swapped.
+my @a=map("v$_",(0,1));
+my @b=map("v$_",(2,3));
+my @c=map("v$_",(4,5));
+my @d=map("v$_",(6,7));
+my ($ror24,$ror16)=map("v$_",(8,9));	# d8 and d9 are callee-saved
+my @msg=map("v$_",(16..23));
+my @bd=map("v$_",(24..25));
+my @dd=map("v$_",(26..27));
+my @m=map("v$_",(28,29));
+my @t=map("v$_",(30,31));
+my ($t0,$t1)=("x8","x9");
+
+sub rot64 {
+my ($x,$n)=@_;
+    foreach my $i (0..1) {
+	if ($n==32) {
+	    $code.="\trev64	$$x[$i].4s,$t[$i].4s\n";
+	} elsif ($n==24 || $n==16) {
+	    my $k = $n==24 ? $ror24 : $ror16;
+	    $code.="\ttbl	$$x[$i].16b,{$t[$i].16b},$k.16b\n";
+	} else {
+$code.=<<___;
+	ushr	$$x[$i].2d,$t[$i].2d,#$n
+	sli	$$x[$i].2d,$t[$i].2d,#`64-$n`
+___
+	}
+    }
+}
+
+# Puts four message words in @m
+sub msg64 {
+my @w=@_;
+    foreach my $i (0..3) {
+	$code.="\tmov	$m[$i>>1].d[".($i&1)."],$msg[$w[$i]>>1].d[".($w[$i]&1)."]\n";
+    }
+}
+
+sub half_g64 {
+my ($a,$b,$c,$d,$r0,$r1)=@_;
+$code.=<<___;
+	add	$$a[0].2d,$$a[0].2d,$m[0].2d
+	add	$$a[1].2d,$$a[1].2d,$m[1].2d
+	add	$$a[0].2d,$$a[0].2d,$$b[0].2d
+	add	$$a[1].2d,$$a[1].2d,$$b[1].2d
+	eor	$t[0].16b,$$d[0].16b,$$a[0].16b
+	eor	$t[1].16b,$$d[1].16b,$$a[1].16b
+___
+	&rot64($d,$r0);
+$code.=<<___;
+	add	$$c[0].2d,$$c[0].2d,$$d[0].2d
+	add	$$c[1].2d,$$c[1].2d,$$d[1].2d
+	eor	$t[0].16b,$$b[0].16b,$$c[0].16b
+	eor	$t[1].16b,$$b[1].16b,$$c[1].16b
+___
+	&rot64($b,$r1);
+}
+
+$code.=<<___;
+.globl	blake2b_compress_neon
+.type	blake2b_compress_neon,%function
+.align	5
+blake2b_compress_neon:
+	stp	d8,d9,[sp,#-16]!
+	mov	$inc,#128
+	cmp	$len,$inc
+	csel	$inc,$len,$inc,lo		// a partial block is the last one
+	ldp	$t0,$t1,[$ctx,#64]
+	adr	$tbl,.Lblake2b_iv
+	add	x10,$tbl,#64
+	ld1	{$ror24.16b,$ror16.16b},[x10]
+	ld1	{@a[0].2d,@a[1].2d,@b[0].2d,@b[1].2d},[$ctx]
+	add	x11,$ctx,#80
+	b	.Loop_blake2b
+
+.align	4
+.Loop_blake2b:
+	add	x10,$inp,#64
+	ld1	{@msg[0].16b-@msg[3].16b},[$inp]
+	ld1	{@msg[4].16b-@msg[7].16b},[x10]
+	add	$inp,$inp,$inc
+	adds	$t0,$t0,$inc
+	adc	$t1,$t1,xzr
+	ld1	{@c[0].2d,@c[1].2d,@d[0].2d,@d[1].2d},[$tbl]
+	fmov	d30,$t0
+	mov	$t[0].d[1],$t1
+	ld1	{$t[1].2d},[x11]		// f[0] and f[1]
+	eor	@d[0].16b,@d[0].16b,$t[0].16b
+	eor	@d[1].16b,@d[1].16b,$t[1].16b
+___
+    for (my $r=0; $r<12; $r++) {
+	my @o=order($r);
+	&msg64(@o[0..3]);	&half_g64(\@a,\@b,\@c,\@d,32,24);
+	&msg64(@o[4..7]);	&half_g64(\@a,\@b,\@c,\@d,16,63);
+$code.=<<___;
+	ext	@bd[0].16b,@b[0].16b,@b[1].16b,#8
+	ext	@bd[1].16b,@b[1].16b,@b[0].16b,#8
+	ext	@dd[0].16b,@d[1].16b,@d[0].16b,#8
+	ext	@dd[1].16b,@d[0].16b,@d[1].16b,#8
+___
+	my @cd=(@c[1],@c[0]);
+	&msg64(@o[8..11]);	&half_g64(\@a,\@bd,\@cd,\@dd,32,24);
+	&msg64(@o[12..15]);	&half_g64(\@a,\@bd,\@cd,\@dd,16,63);
+$code.=<<___;
+	ext	@b[0].16b,@bd[1].16b,@bd[0].16b,#8
+	ext	@b[1].16b,@bd[0].16b,@bd[1].16b,#8
+	ext	@d[0].16b,@dd[0].16b,@dd[1].16b,#8
+	ext	@d[1].16b,@dd[1].16b,@dd[0].16b,#8
+___
+    }
+$code.=<<___;
+	ld1	{@msg[0].2d-@msg[3].2d},[$ctx]
+	eor	@a[0].16b,@a[0].16b,@c[0].16b
+	eor	@a[1].16b,@a[1].16b,@c[1].16b
+	eor	@b[0].16b,@b[0].16b,@d[0].16b
+	eor	@b[1].16b,@b[1].16b,@d[1].16b
+	eor	@a[0].16b,@a[0].16b,@msg[0].16b
+	eor	@a[1].16b,@a[1].16b,@msg[1].16b
+	eor	@b[0].16b,@b[0].16b,@msg[2].16b
+	eor	@b[1].16b,@b[1].16b,@msg[3].16b
+	st1	{@a[0].2d,@a[1].2d,@b[0].2d,@b[1].2d},[$ctx]
+	subs	$len,$len,$inc
+	b.ne	.Loop_blake2b
+
+	stp	$t0,$t1,[$ctx,#64]
+	ldp	d8,d9,[sp],#16
+	ret
+.size	blake2b_compress_neon,.-blake2b_compress_neon
+___
+}
+
+$code.=<<___;
+
+.align	6
+.Lblake2b_iv:
+	.quad	0x6a09e667f3bcc908,0xbb67ae8584caa73b
+	.quad	0x3c6ef372fe94f82b,0xa54ff53a5f1d36f1
+	.quad	0x510e527fade682d1,0x9b05688c2b3e6c1f
+	.quad	0x1f83d9abfb41bd6b,0x5be0cd19137e2179
+	// rotations of 64-bit lanes by 24 and 16 bits
+	.byte	3,4,5,6,7,0,1,2,11,12,13,14,15,8,9,10
+	.byte	2,3,4,5,6,7,0,1,10,11,12,13,14,15,8,9
+.Lblake2s_iv:
+	.long	0x6a09e667,0xbb67ae85,0x3c6ef372,0xa54ff53a
+	.long	0x510e527f,0x9b05688c,0x1f83d9ab,0x5be0cd19
+	// rotation of 32-bit lanes by 8 bits
+	.byte	1,2,3,0,5,6,7,4,9,10,11,8,13,14,15,12
+	// byte indices of the message words of each round
+___
+for (my $r=0; $r<10; $r++) {
+    my @o=order($r);
+    for (my $i=0; $i<16; $i+=4) {
+	$code.="\t.byte\t".join(',',map { my $w=$_; map(4*$w+$_,(0..3)) } @o[$i..$i+3])."\n";
+    }
+}
+
+open SELF,$0;
+while(<SELF>) {
+        next if (/^#!/);
+        last if (!s/^#/\/\// and !/^$/);
+        print;
+}
+close SELF;
+
+foreach(split("\n",$code)) {
+	s/\`([^\`]*)\`/eval($1)/ge;
+
+	print $_,"\n";
+}
+
+close STDOUT or die "error closing STDOUT: $!";
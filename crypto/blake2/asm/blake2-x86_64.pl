@@ -0,0 +1,544 @@
+#! /usr/bin/env perl
+# Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+#
+# Licensed under the Apache License 2.0 (the "License").  You may not use
+# this file except in compliance with the License.  You can obtain a copy
+# in the file LICENSE in the source distribution or at
+# https://www.openssl.org/source/license.html
+
+#
+# BLAKE2b and BLAKE2s compression functions for x86_64 with AVX/AVX2,
+# and AVX-512VL.
+#
+# The 4x4 state is held one row per register, so the four G functions
+# of a column or diagonal step run in parallel, and the rows are rotated
+# between the steps.  BLAKE2b takes 256-bit registers and BLAKE2s
+# 128-bit ones.  Rotations by multiples of 8 are byte shuffles, the
+# others are two shifts, or VPRORQ/VPRORD with AVX-512.  What costs is
+# putting the message words in the order of each round: with AVX-512
+# one VPERMI2Q or VPERMD per round and step pair does it, otherwise the
+# words are inserted one at a time.  The AVX-512 code only uses
+# registers 16-31, so it doesn't have to preserve anything on Win64.
+#
+# Cycles per byte for long messages, compared to the C code:
+#
+#		BLAKE2b			BLAKE2s
+#		C	AVX2	AVX512	C	AVX	AVX512
+# Xeon(*)	3.6	2.9	2.7	5.8	4.4	4.1
+#
+# (*)	measured in a virtual machine, 2.1GHz Xeon with AVX-512 and VAES.
+#
+# The caller checks for AVX2 (BLAKE2b) or AVX (BLAKE2s), AVX-512 is
+# picked here.
+
+# $output is the last argument if it looks like a file (it has an extension)
+# $flavour is the first argument if it doesn't look like a file
+$output = $#ARGV >= 0 && $ARGV[$#ARGV] =~ m|\.\w+$| ? pop : undef;
+$flavour = $#ARGV >= 0 && $ARGV[0] !~ m|\.| ? shift : undef;
+
+$win64=0; $win64=1 if ($flavour =~ /[nm]asm|mingw64/ || $output =~ /\.asm$/);
+
+$0 =~ m/(.*[\/\\])[^\/\\]+$/; $dir=$1;
+( $xlate="${dir}x86_64-xlate.pl" and -f $xlate ) or
+( $xlate="${dir}../../perlasm/x86_64-xlate.pl" and -f $xlate) or
+die "can't locate x86_64-xlate.pl";
+
+if (`$ENV{CC} -Wa,-v -c -o /dev/null -x assembler /dev/null 2>&1`
+		=~ /GNU assembler version ([2-9]\.[0-9]+)/) {
+	$avx = ($1>=2.19) + ($1>=2.22) + ($1>=2.25);
+}
+
+if (!$avx && $win64 && ($flavour =~ /nasm/ || $ENV{ASM} =~ /nasm/) &&
+	   `nasm -v 2>&1` =~ /NASM version ([2-9]\.[0-9]+)(?:\.([0-9]+))?/) {
+	$avx = ($1>=2.09) + ($1>=2.10) + ($1>=2.12);
+	$avx += 1 if ($1==2.11 && $2>=8);
+}
+
+if (!$avx && $win64 && ($flavour =~ /masm/ || $ENV{ASM} =~ /ml64/) &&
+	   `ml64 2>&1` =~ /Version ([0-9]+)\./) {
+	$avx = ($1>=10) + ($1>=11);
+}
+
+if (!$avx && `$ENV{CC} -v 2>&1` =~ /((?:^clang|LLVM) version|.*based on LLVM) ([0-9]+\.[0-9]+)/) {
+	$avx = ($2>=3.0) + ($2>3.0) + ($2>=3.6);
+}
+
+open OUT,"| \"$^X\" \"$xlate\" $flavour \"$output\""
+    or die "can't call $xlate: $!";
+*STDOUT=*OUT;
+
+my @sigma = (
+	[  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 ],
+	[ 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 ],
+	[ 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 ],
+	[  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 ],
+	[  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 ],
+	[  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 ],
+	[ 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 ],
+	[ 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 ],
+	[  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 ],
+	[ 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0 ]
+);
+
+# Message words of round $r, in the order the steps take them: the
+# first and second word of each column, then of each diagonal
+sub order { my $s=$sigma[shift()%10]; map($$s[$_],(0,2,4,6,1,3,5,7,8,10,12,14,9,11,13,15)); }
+
+my ($ctx,$inp,$len,$inc,$t0,$t1)=("%rdi","%rsi","%rdx","%r10","%r8","%r9");
+
+if ($avx>1) {{{
+#
+# One half of G on all four rows: a += b + m, d = (d^a)>>>r0,
+# c += d, b = (b^c)>>>r1.  $rot emits a rotation.
+#
+my ($a,$b,$c,$d);
+sub half_g {
+my ($m,$sfx,$r0,$r1,$rot)=@_;
+my $xor = $a =~ /mm(1[6-9]|[23][0-9])/ ? "vpxor$sfx" : "vpxor";	# EVEX
+$code.=<<___;
+	vpadd$sfx	$m,$a,$a
+	vpadd$sfx	$b,$a,$a
+	$xor	$a,$d,$d
+___
+	&$rot($d,$r0);
+$code.=<<___;
+	vpadd$sfx	$d,$c,$c
+	$xor	$c,$b,$b
+___
+	&$rot($b,$r1);
+}
+
+sub diagonalize {
+my $shuf=shift;
+$code.=<<___;
+	$shuf	\$0x39,$b,$b
+	$shuf	\$0x4e,$c,$c
+	$shuf	\$0x93,$d,$d
+___
+}
+
+sub undiagonalize {
+my $shuf=shift;
+$code.=<<___;
+	$shuf	\$0x93,$b,$b
+	$shuf	\$0x4e,$c,$c
+	$shuf	\$0x39,$d,$d
+___
+}
+
+{
+# void blake2b_compress_avx2(BLAKE2B_CTX *S, const uint8_t *blocks,
+#                            size_t len);
+#
+# Same contract as blake2b_compress() in C: len is either less than a
+# block, or a multiple of it.
+($a,$b,$c,$d)=map("%ymm$_",(0..3));
+my ($m,$tmp)=("%ymm4","%ymm5");
+
+sub rot64 {
+my ($x,$n)=@_;
+    if ($n==32) {
+	$code.="\tvpshufd	\$0xb1,$x,$x\n";
+    } elsif ($n==63) {
+$code.=<<___;
+	vpaddq	$x,$x,$tmp
+	vpsrlq	\$63,$x,$x
+	vpor	$tmp,$x,$x
+___
+    } else {
+	$code.="\tvpshufb	.Lror64_$n(%rip),$x,$x\n";
+    }
+}
+
+# Builds a vector of four message words
+sub msg64 {
+my @w=@_;
+$code.=<<___;
+	vmovq	`8*$w[0]`($inp),%xmm4
+	vpinsrq	\$1,`8*$w[1]`($inp),%xmm4,%xmm4
+	vmovq	`8*$w[2]`($inp),%xmm5
+	vpinsrq	\$1,`8*$w[3]`($inp),%xmm5,%xmm5
+	vinserti128	\$1,%xmm5,$m,$m
+___
+}
+
+$code.=<<___;
+.text
+.extern	OPENSSL_ia32cap_P
+
+.globl	blake2b_compress_avx2
+.type	blake2b_compress_avx2,\@function,3
+.align	32
+blake2b_compress_avx2:
+.cfi_startproc
+___
+$code.=<<___ if ($avx>2);
+	mov	OPENSSL_ia32cap_P+8(%rip),%r11d
+	and	\$0x80010000,%r11d	# AVX512F and AVX512VL
+	cmp	\$0x80010000,%r11d
+	je	.Lblake2b_avx512
+___
+$code.=<<___;
+	mov	\$128,$inc
+	cmp	$inc,$len
+	cmovb	$len,$inc		# a partial block is the last one
+	mov	64($ctx),$t0
+	mov	72($ctx),$t1
+	vmovdqu	0($ctx),$a
+	vmovdqu	32($ctx),$b
+	jmp	.Loop_blake2b_avx2
+
+.align	32
+.Loop_blake2b_avx2:
+	add	$inc,$t0
+	adc	\$0,$t1
+	vmovdqa	.Lblake2b_iv(%rip),$c
+	vmovq	$t0,%xmm3
+	vpinsrq	\$1,$t1,%xmm3,%xmm3
+	vinserti128	\$1,80($ctx),$d,$d
+	vpxor	.Lblake2b_iv+32(%rip),$d,$d
+___
+    for (my $r=0; $r<12; $r++) {
+	my @o=order($r);
+	&msg64(@o[0..3]);	&half_g($m,"q",32,24,\&rot64);
+	&msg64(@o[4..7]);	&half_g($m,"q",16,63,\&rot64);
+	&diagonalize("vpermq");
+	&msg64(@o[8..11]);	&half_g($m,"q",32,24,\&rot64);
+	&msg64(@o[12..15]);	&half_g($m,"q",16,63,\&rot64);
+	&undiagonalize("vpermq");
+    }
+$code.=<<___;
+	vpxor	$c,$a,$a
+	vpxor	$d,$b,$b
+	vpxor	0($ctx),$a,$a
+	vpxor	32($ctx),$b,$b
+	vmovdqu	$a,0($ctx)
+	vmovdqu	$b,32($ctx)
+	lea	($inp,$inc),$inp
+	sub	$inc,$len
+	jnz	.Loop_blake2b_avx2
+
+	mov	$t0,64($ctx)
+	mov	$t1,72($ctx)
+	vzeroupper
+	ret
+.cfi_endproc
+.size	blake2b_compress_avx2,.-blake2b_compress_avx2
+___
+}
+
+{
+# void blake2s_compress_avx(BLAKE2S_CTX *S, const uint8_t *blocks,
+#                           size_t len);
+($a,$b,$c,$d)=map("%xmm$_",(0..3));
+my ($m,$tmp)=("%xmm4","%xmm5");
+
+sub rot32 {
+my ($x,$n)=@_;
+    if ($n==16 || $n==8) {
+	$code.="\tvpshufb	.Lror32_$n(%rip),$x,$x\n";
+    } else {
+$code.=<<___;
+	vpslld	\$`32-$n`,$x,$tmp
+	vpsrld	\$$n,$x,$x
+	vpor	$tmp,$x,$x
+___
+    }
+}
+
+sub msg32 {
+my @w=@_;
+$code.=<<___;
+	vmovd	`4*$w[0]`($inp),$m
+	vpinsrd	\$1,`4*$w[1]`($inp),$m,$m
+	vpinsrd	\$2,`4*$w[2]`($inp),$m,$m
+	vpinsrd	\$3,`4*$w[3]`($inp),$m,$m
+___
+}
+
+$code.=<<___;
+.globl	blake2s_compress_avx
+.type	blake2s_compress_avx,\@function,3
+.align	32
+blake2s_compress_avx:
+.cfi_startproc
+___
+$code.=<<___ if ($avx>2);
+	mov	OPENSSL_ia32cap_P+8(%rip),%r11d
+	and	\$0x80010000,%r11d	# AVX512F and AVX512VL
+	cmp	\$0x80010000,%r11d
+	je	.Lblake2s_avx512
+___
+$code.=<<___;
+	mov	\$64,$inc
+	cmp	$inc,$len
+	cmovb	$len,$inc		# a partial block is the last one
+	mov	32($ctx),$t0		# both halves of the counter
+	vmovdqu	0($ctx),$a
+	vmovdqu	16($ctx),$b
+	jmp	.Loop_blake2s_avx
+
+.align	32
+.Loop_blake2s_avx:
+	add	$inc,$t0
+	vmovdqa	.Lblake2s_iv(%rip),$c
+	vmovq	$t0,$d
+	vpinsrq	\$1,40($ctx),$d,$d
+	vpxor	.Lblake2s_iv+16(%rip),$d,$d
+___
+    for (my $r=0; $r<10; $r++) {
+	my @o=order($r);
+	&msg32(@o[0..3]);	&half_g($m,"d",16,12,\&rot32);
+	&msg32(@o[4..7]);	&half_g($m,"d",8,7,\&rot32);
+	&diagonalize("vpshufd");
+	&msg32(@o[8..11]);	&half_g($m,"d",16,12,\&rot32);
+	&msg32(@o[12..15]);	&half_g($m,"d",8,7,\&rot32);
+	&undiagonalize("vpshufd");
+    }
+$code.=<<___;
+	vpxor	$c,$a,$a
+	vpxor	$d,$b,$b
+	vpxor	0($ctx),$a,$a
+	vpxor	16($ctx),$b,$b
+	vmovdqu	$a,0($ctx)
+	vmovdqu	$b,16($ctx)
+	lea	($inp,$inc),$inp
+	sub	$inc,$len
+	jnz	.Loop_blake2s_avx
+
+	mov	$t0,32($ctx)
+	vzeroupper
+	ret
+.cfi_endproc
+.size	blake2s_compress_avx,.-blake2s_compress_avx
+___
+}
+
+if ($avx>2) {
+sub rot_avx512 {
+my ($x,$n)=@_;
+my $sfx = $x =~ /ymm/ ? "q" : "d";
+	$code.="\tvpror$sfx	\$$n,$x,$x\n";
+}
+
+{
+# BLAKE2b with AVX-512VL: the message is in two registers, and each
+# round picks its words with two VPERMI2Q, for the column and for the
+# diagonal step.
+($a,$b,$c,$d)=map("%ymm$_",(16..19));
+my ($mlo,$mhi,$m0,$m1,$m2,$m3)=("%zmm20","%zmm21","%zmm22","%zmm23",
+				"%ymm24","%ymm25");
+(my $m0y=$m0)=~s/zmm/ymm/;
+(my $m1y=$m1)=~s/zmm/ymm/;
+
+$code.=<<___;
+.type	blake2b_compress_avx512,\@function,3
+.align	32
+blake2b_compress_avx512:
+.cfi_startproc
+.Lblake2b_avx512:
+	mov	\$128,$inc
+	cmp	$inc,$len
+	cmovb	$len,$inc
+	mov	64($ctx),$t0
+	mov	72($ctx),$t1
+	vmovdqu64	0($ctx),$a
+	vmovdqu64	32($ctx),$b
+	jmp	.Loop_blake2b_avx512
+
+.align	32
+.Loop_blake2b_avx512:
+	add	$inc,$t0
+	adc	\$0,$t1
+	vmovdqu64	0($inp),$mlo
+	vmovdqu64	64($inp),$mhi
+	vmovdqa64	.Lblake2b_iv(%rip),$c
+	vmovq	$t0,%xmm26
+	vmovq	$t1,%xmm27
+	vpunpcklqdq	%xmm27,%xmm26,%xmm26
+	vinserti32x4	\$1,80($ctx),%ymm26,$d
+	vpxorq	.Lblake2b_iv+32(%rip),$d,$d
+___
+    for (my $r=0; $r<12; $r++) {
+$code.=<<___;
+	vmovdqa64	.Lblake2b_perm+`128*($r%10)`(%rip),$m0
+	vmovdqa64	.Lblake2b_perm+`128*($r%10)+64`(%rip),$m1
+	vpermi2q	$mhi,$mlo,$m0
+	vpermi2q	$mhi,$mlo,$m1
+	vextracti64x4	\$1,$m0,$m2
+	vextracti64x4	\$1,$m1,$m3
+___
+	&half_g($m0y,"q",32,24,\&rot_avx512);
+	&half_g($m2,"q",16,63,\&rot_avx512);
+	&diagonalize("vpermq");
+	&half_g($m1y,"q",32,24,\&rot_avx512);
+	&half_g($m3,"q",16,63,\&rot_avx512);
+	&undiagonalize("vpermq");
+    }
+$code.=<<___;
+	vpternlogq	\$0x96,0($ctx),$c,$a	# a^c^h
+	vpternlogq	\$0x96,32($ctx),$d,$b
+	vmovdqu64	$a,0($ctx)
+	vmovdqu64	$b,32($ctx)
+	lea	($inp,$inc),$inp
+	sub	$inc,$len
+	jnz	.Loop_blake2b_avx512
+
+	mov	$t0,64($ctx)
+	mov	$t1,72($ctx)
+	vzeroupper
+	ret
+.cfi_endproc
+.size	blake2b_compress_avx512,.-blake2b_compress_avx512
+___
+}
+
+{
+# BLAKE2s with AVX-512VL: the whole block fits in one register, and one
+# VPERMD per round puts all of its words in place.
+($a,$b,$c,$d)=map("%xmm$_",(16..19));
+my ($msg,$idx,$perm)=("%zmm20","%zmm21","%zmm22");
+my @m=("%xmm22","%xmm23","%xmm24","%xmm25");
+
+$code.=<<___;
+.type	blake2s_compress_avx512,\@function,3
+.align	32
+blake2s_compress_avx512:
+.cfi_startproc
+.Lblake2s_avx512:
+	mov	\$64,$inc
+	cmp	$inc,$len
+	cmovb	$len,$inc
+	mov	32($ctx),$t0
+	vmovdqu32	0($ctx),$a
+	vmovdqu32	16($ctx),$b
+	jmp	.Loop_blake2s_avx512
+
+.align	32
+.Loop_blake2s_avx512:
+	add	$inc,$t0
+	vmovdqu32	0($inp),$msg
+	vmovdqa32	.Lblake2s_iv(%rip),$c
+	vmovq	$t0,%xmm26
+	vmovq	40($ctx),%xmm27
+	vpunpcklqdq	%xmm27,%xmm26,$d
+	vpxord	.Lblake2s_iv+16(%rip),$d,$d
+___
+    for (my $r=0; $r<10; $r++) {
+$code.=<<___;
+	vmovdqa32	.Lblake2s_perm+`64*$r`(%rip),$idx
+	vpermd	$msg,$idx,$perm
+	vextracti32x4	\$1,$perm,$m[1]
+	vextracti32x4	\$2,$perm,$m[2]
+	vextracti32x4	\$3,$perm,$m[3]
+___
+	&half_g($m[0],"d",16,12,\&rot_avx512);
+	&half_g($m[1],"d",8,7,\&rot_avx512);
+	&diagonalize("vpshufd");
+	&half_g($m[2],"d",16,12,\&rot_avx512);
+	&half_g($m[3],"d",8,7,\&rot_avx512);
+	&undiagonalize("vpshufd");
+    }
+$code.=<<___;
+	vpternlogd	\$0x96,0($ctx),$c,$a
+	vpternlogd	\$0x96,16($ctx),$d,$b
+	vmovdqu32	$a,0($ctx)
+	vmovdqu32	$b,16($ctx)
+	lea	($inp,$inc),$inp
+	sub	$inc,$len
+	jnz	.Loop_blake2s_avx512
+
+	mov	$t0,32($ctx)
+	vzeroupper
+	ret
+.cfi_endproc
+.size	blake2s_compress_avx512,.-blake2s_compress_avx512
+___
+}
+}
+
+$code.=<<___;
+# int blake2_avx_eligible(void);
+#
+# Returns 1 as the functions above are real, the caller checks
+# OPENSSL_ia32cap_P for the processor features.
+.globl	blake2_avx_eligible
+.type	blake2_avx_eligible,\@abi-omnipotent
+.align	32
+blake2_avx_eligible:
+.cfi_startproc
+	mov	\$1,%eax
+	ret
+.cfi_endproc
+.size	blake2_avx_eligible,.-blake2_avx_eligible
+
+.align	64
+.Lblake2b_iv:
+	.quad	0x6a09e667f3bcc908,0xbb67ae8584caa73b
+	.quad	0x3c6ef372fe94f82b,0xa54ff53a5f1d36f1
+	.quad	0x510e527fade682d1,0x9b05688c2b3e6c1f
+	.quad	0x1f83d9abfb41bd6b,0x5be0cd19137e2179
+.Lblake2s_iv:
+	.long	0x6a09e667,0xbb67ae85,0x3c6ef372,0xa54ff53a
+	.long	0x510e527f,0x9b05688c,0x1f83d9ab,0x5be0cd19
+.Lror64_24:
+	.byte	3,4,5,6,7,0,1,2,11,12,13,14,15,8,9,10
+	.byte	3,4,5,6,7,0,1,2,11,12,13,14,15,8,9,10
+.Lror64_16:
+	.byte	2,3,4,5,6,7,0,1,10,11,12,13,14,15,8,9
+	.byte	2,3,4,5,6,7,0,1,10,11,12,13,14,15,8,9
+.Lror32_16:
+	.byte	2,3,0,1,6,7,4,5,10,11,8,9,14,15,12,13
+.Lror32_8:
+	.byte	1,2,3,0,5,6,7,4,9,10,11,8,13,14,15,12
+___
+if ($avx>2) {
+$code.=".align	64\n.Lblake2b_perm:\n";
+    for (my $r=0; $r<10; $r++) {
+	$code.="\t.quad\t".join(',',order($r))."\n";
+    }
+$code.=".Lblake2s_perm:\n";
+    for (my $r=0; $r<10; $r++) {
+	$code.="\t.long\t".join(',',order($r))."\n";
+    }
+}
+$code.=<<___;
+.asciz	"BLAKE2 for x86_64, AVX2/AVX512"
+.align	64
+___
+}}} else {{{
+$code=<<___;	# assembler is too old
+.text
+
+.globl	blake2b_compress_avx2
+.type	blake2b_compress_avx2,\@abi-omnipotent
+blake2b_compress_avx2:
+.cfi_startproc
+	ud2
+.cfi_endproc
+.size	blake2b_compress_avx2,.-blake2b_compress_avx2
+
+.globl	blake2s_compress_avx
+.type	blake2s_compress_avx,\@abi-omnipotent
+blake2s_compress_avx:
+.cfi_startproc
+	ud2
+.cfi_endproc
+.size	blake2s_compress_avx,.-blake2s_compress_avx
+
+.globl	blake2_avx_eligible
+.type	blake2_avx_eligible,\@abi-omnipotent
+blake2_avx_eligible:
+.cfi_startproc
+	xor	%eax,%eax
+	ret
+.cfi_endproc
+.size	blake2_avx_eligible,.-blake2_avx_eligible
+___
+}}}
+
+$code =~ s/\`([^\`]*)\`/eval($1)/gem;
+
+print $code;
+
+close STDOUT or die "error closing STDOUT: $!";
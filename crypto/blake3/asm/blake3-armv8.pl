@@ -0,0 +1,244 @@
+#! /usr/bin/env perl
+# Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+#
+# Licensed under the Apache License 2.0 (the "License").  You may not use
+# this file except in compliance with the License.  You can obtain a copy
+# in the file LICENSE in the source distribution or at
+# https://www.openssl.org/source/license.html
+
+#
+# BLAKE3 for ARMv8 NEON.
+#
+# Like on x86_64, four chunks or parent nodes are hashed at once, one in
+# each 32-bit lane, so that the G functions are vertical operations.
+# LD4 and ST4 to single lanes do the transpositions of the message
+# blocks and chaining values.  The state takes 16 registers, so the
+# message is kept on the stack and the other registers are temporaries
+# and constants.  Rotations by 16 bits are REV32, by 8 bits TBL, and the
+# rest USHR and SLI.
+
+# $output is the last argument if it looks like a file (it has an extension)
+# $flavour is the first argument if it doesn't look like a file
+$output = $#ARGV >= 0 && $ARGV[$#ARGV] =~ m|\.\w+$| ? pop : undef;
+$flavour = $#ARGV >= 0 && $ARGV[0] !~ m|\.| ? shift : undef;
+
+if ($flavour && $flavour ne "void") {
+    $0 =~ m/(.*[\/\\])[^\/\\]+$/; $dir=$1;
+    ( $xlate="${dir}arm-xlate.pl" and -f $xlate ) or
+    ( $xlate="${dir}../../perlasm/arm-xlate.pl" and -f $xlate) or
+    die "can't locate arm-xlate.pl";
+
+    open OUT,"| \"$^X\" $xlate $flavour \"$output\""
+        or die "can't call $xlate: $!";
+    *STDOUT=*OUT;
+} else {
+    $output and open STDOUT,">$output";
+}
+
+my @schedule = (
+	[  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 ],
+	[  2,  6,  3, 10,  7,  0,  4, 13,  1, 11, 12,  5,  9, 14, 15,  8 ],
+	[  3,  4, 10, 12, 13,  2,  7, 14,  6,  5,  9,  0, 11, 15,  8,  1 ],
+	[ 10,  7, 12,  9, 14,  3, 13, 15,  4,  0, 11,  2,  5,  8,  1,  6 ],
+	[ 12, 13,  9, 11, 15, 10, 14,  8,  7,  2,  5,  3,  0,  1,  6,  4 ],
+	[  9, 14, 11,  5,  8, 12, 15,  1, 13,  3,  0, 10,  2,  6,  4,  7 ],
+	[ 11, 15,  5,  0,  1,  9,  8,  6, 14, 10,  2, 12,  3,  4,  7, 13 ]
+);
+
+# The state words each G of the column and of the diagonal step takes
+my @columns = ([0,4,8,12],[1,5,9,13],[2,6,10,14],[3,7,11,15]);
+my @diagonals = ([0,5,10,15],[1,6,11,12],[2,7,8,13],[3,4,9,14]);
+
+# void blake3_hash4_neon(const uint8_t *const inputs[4], size_t blocks,
+#                        const uint32_t key[8], uint64_t counter,
+#                        unsigned int flags, uint8_t *out);
+#
+# Hashes 4 inputs of |blocks| 64-byte blocks, and writes their 32-byte
+# chaining values one after the other to |out|.  Without PARENT in
+# |flags| the inputs are chunks, with consecutive counters from
+# |counter|, and the first and last blocks are flagged.  Parent nodes
+# all have counter 0.
+my ($inputs,$blocks,$key,$counter,$flags,$out)=
+	("x0","x1","x2","x3","w4","x5");
+my ($inc,$bflags,$endflag)=("w6","w7","w8");
+my @ptr=map("x$_",(9..12));
+my @v=map("v$_",(0..15));
+my @m=map("v$_",(16..19));
+my @t=map("v$_",(20..23));
+my ($lo,$hi,$iv,$ror8)=map("v$_",(24..27));
+
+# Four G functions in parallel, with the message words $mx and $my
+sub g4 {
+my ($quads,$mx,$my)=@_;
+
+    for my $half (0,1) {
+	my $w = $half ? $my : $mx;
+	my ($rd,$rb) = $half ? (8,7) : (16,12);
+	for my $i (0..3) {
+	    $code.="\tldr	q".(16+$i).",[sp,#`16*$$w[$i]`]\n";
+	}
+	for my $i (0..3) {
+	    my ($a,$b)=map($v[$_],@{$$quads[$i]}[0,1]);
+	    $code.="\tadd	$a.4s,$a.4s,$m[$i].4s\n";
+	}
+	for my $i (0..3) {
+	    my ($a,$b)=map($v[$_],@{$$quads[$i]}[0,1]);
+	    $code.="\tadd	$a.4s,$a.4s,$b.4s\n";
+	}
+	for my $i (0..3) {
+	    my ($a,$d)=map($v[$_],@{$$quads[$i]}[0,3]);
+	    if ($rd==16) {
+		$code.="\teor	$d.16b,$d.16b,$a.16b\n";
+		$code.="\trev32	$d.8h,$d.8h\n";
+	    } else {
+		$code.="\teor	$t[$i].16b,$d.16b,$a.16b\n";
+		$code.="\ttbl	$d.16b,{$t[$i].16b},$ror8.16b\n";
+	    }
+	}
+	for my $i (0..3) {
+	    my ($c,$d)=map($v[$_],@{$$quads[$i]}[2,3]);
+	    $code.="\tadd	$c.4s,$c.4s,$d.4s\n";
+	}
+	for my $i (0..3) {
+	    my ($b,$c)=map($v[$_],@{$$quads[$i]}[1,2]);
+	    $code.="\teor	$t[$i].16b,$b.16b,$c.16b\n";
+	}
+	for my $i (0..3) {
+	    my $b=$v[$$quads[$i][1]];
+	    $code.="\tushr	$b.4s,$t[$i].4s,#$rb\n";
+	}
+	for my $i (0..3) {
+	    my $b=$v[$$quads[$i][1]];
+	    $code.="\tsli	$b.4s,$t[$i].4s,#`32-$rb`\n";
+	}
+    }
+}
+
+$code=<<___;
+#include "arm_arch.h"
+
+.text
+
+.globl	blake3_hash4_neon
+.type	blake3_hash4_neon,%function
+.align	5
+blake3_hash4_neon:
+	stp	d8,d9,[sp,#-64]!
+	stp	d10,d11,[sp,#16]
+	stp	d12,d13,[sp,#32]
+	stp	d14,d15,[sp,#48]
+	sub	sp,sp,#256			// the message block
+	ldp	@ptr[0],@ptr[1],[$inputs]
+	ldp	@ptr[2],@ptr[3],[$inputs,#16]
+___
+    for (my $i=0; $i<8; $i++) {
+	$code.="\tld1r	{$v[$i].4s},[$key],#4\n";
+    }
+$code.=<<___;
+	adr	x13,.Lblake3_iv
+	ld1	{$iv.16b,$ror8.16b},[x13],#32
+	ld1	{$t[0].4s},[x13]		// lane numbers
+
+	// Chunks get consecutive counters and CHUNK_START/CHUNK_END,
+	// parents don't.  $inc is both the increment and CHUNK_START.
+	ubfx	$inc,$flags,#2,#1		// PARENT
+	eor	$inc,$inc,#1
+	dup	$t[1].4s,$inc
+	mul	$t[0].4s,$t[0].4s,$t[1].4s
+	dup	$lo.4s,w3
+	lsr	x3,x3,#32
+	dup	$hi.4s,w3
+	add	$t[0].4s,$t[0].4s,$lo.4s
+	cmhi	$t[1].4s,$lo.4s,$t[0].4s	// carry is -1
+	sub	$hi.4s,$hi.4s,$t[1].4s
+	mov	$lo.16b,$t[0].16b
+	orr	$bflags,$flags,$inc
+	lsl	$endflag,$inc,#1
+	b	.Loop_blake3
+
+.align	4
+.Loop_blake3:
+	cmp	$blocks,#1
+	b.ne	.Lnot_last
+	orr	$bflags,$bflags,$endflag
+.Lnot_last:
+___
+    # LD4 to a lane puts four consecutive words of a block in the same
+    # lane of four registers, which is the transposition.  The state
+    # registers that aren't set yet are used for it.
+    my @tr=(@v[8..15],@m,@t);
+    for (my $l=0; $l<4; $l++) {
+	for (my $g=0; $g<4; $g++) {
+	    my @r=@tr[4*$g..4*$g+3];
+	    $code.="\tld4	{$r[0].s,$r[1].s,$r[2].s,$r[3].s}[$l],[$ptr[$l]],#16\n";
+	}
+    }
+    for (my $i=0; $i<16; $i+=2) {
+	(my $q0=$tr[$i])=~s/v/q/;
+	(my $q1=$tr[$i+1])=~s/v/q/;
+	$code.="\tstp	$q0,$q1,[sp,#`16*$i`]\n";
+    }
+$code.=<<___;
+	dup	$v[8].4s,$iv.s[0]
+	dup	$v[9].4s,$iv.s[1]
+	dup	$v[10].4s,$iv.s[2]
+	dup	$v[11].4s,$iv.s[3]
+	mov	$v[12].16b,$lo.16b
+	mov	$v[13].16b,$hi.16b
+	movi	$v[14].4s,#64
+	dup	$v[15].4s,$bflags
+___
+    for (my $r=0; $r<7; $r++) {
+	my $s=$schedule[$r];
+	&g4(\@columns, [@$s[0,2,4,6]], [@$s[1,3,5,7]]);
+	&g4(\@diagonals, [@$s[8,10,12,14]], [@$s[9,11,13,15]]);
+    }
+    for (my $i=0; $i<8; $i++) {
+	$code.="\teor	$v[$i].16b,$v[$i].16b,$v[$i+8].16b\n";
+    }
+$code.=<<___;
+	mov	$bflags,$flags
+	subs	$blocks,$blocks,#1
+	b.ne	.Loop_blake3
+
+___
+    for (my $l=0; $l<4; $l++) {
+$code.=<<___;
+	st4	{$v[0].s,$v[1].s,$v[2].s,$v[3].s}[$l],[$out],#16
+	st4	{$v[4].s,$v[5].s,$v[6].s,$v[7].s}[$l],[$out],#16
+___
+    }
+$code.=<<___;
+	add	sp,sp,#256
+	ldp	d10,d11,[sp,#16]
+	ldp	d12,d13,[sp,#32]
+	ldp	d14,d15,[sp,#48]
+	ldp	d8,d9,[sp],#64
+	ret
+.size	blake3_hash4_neon,.-blake3_hash4_neon
+
+.align	6
+.Lblake3_iv:
+	.long	0x6a09e667,0xbb67ae85,0x3c6ef372,0xa54ff53a
+	// rotation of 32-bit lanes by 8 bits
+	.byte	1,2,3,0,5,6,7,4,9,10,11,8,13,14,15,12
+	.long	0,1,2,3
+.asciz	"BLAKE3 for ARMv8, NEON"
+.align	2
+___
+
+open SELF,$0;
+while(<SELF>) {
+        next if (/^#!/);
+        last if (!s/^#/\/\// and !/^$/);
+        print;
+}
+close SELF;
+
+foreach(split("\n",$code)) {
+	s/\`([^\`]*)\`/eval($1)/ge;
+
+	print $_,"\n";
+}
+
+close STDOUT or die "error closing STDOUT: $!";
@@ -0,0 +1,701 @@
+#! /usr/bin/env perl
+# Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+#
+# Licensed under the Apache License 2.0 (the "License").  You may not use
+# this file except in compliance with the License.  You can obtain a copy
+# in the file LICENSE in the source distribution or at
+# https://www.openssl.org/source/license.html
+
+#
+# BLAKE3 for x86_64 with AVX2 and AVX-512F.
+#
+# BLAKE3 chunks are independent, so instead of working on the rows of
+# one state like the BLAKE2 code, these functions hash 8 (AVX2) or 16
+# (AVX-512) chunks, or parent nodes, at once, one in each 32-bit lane.
+# A vector then holds the same state word for all of them, the G
+# functions are plain vertical operations and nothing is shuffled
+# between the steps.  What costs is transposing the message blocks into
+# that layout, and the chaining values back out of it.
+#
+# With AVX2 all 16 registers hold the state, so the message is kept on
+# the stack and a register is spilled for the shifts of the 12 and 7 bit
+# rotations.  With AVX-512 the message takes the other 16 registers and
+# VPRORD does the rotations.
+#
+# Cycles per byte for long messages:
+#
+#		C	AVX2	AVX512
+# Xeon(*)	6.4	0.81	0.48
+#
+# (*)	measured in a virtual machine, 2.1GHz Xeon with AVX-512 and VAES.
+#
+# The caller checks OPENSSL_ia32cap_P, and blake3_avx_eligible() for
+# the code the assembler could take.
+
+# $output is the last argument if it looks like a file (it has an extension)
+# $flavour is the first argument if it doesn't look like a file
+$output = $#ARGV >= 0 && $ARGV[$#ARGV] =~ m|\.\w+$| ? pop : undef;
+$flavour = $#ARGV >= 0 && $ARGV[0] !~ m|\.| ? shift : undef;
+
+$win64=0; $win64=1 if ($flavour =~ /[nm]asm|mingw64/ || $output =~ /\.asm$/);
+
+$0 =~ m/(.*[\/\\])[^\/\\]+$/; $dir=$1;
+( $xlate="${dir}x86_64-xlate.pl" and -f $xlate ) or
+( $xlate="${dir}../../perlasm/x86_64-xlate.pl" and -f $xlate) or
+die "can't locate x86_64-xlate.pl";
+
+if (`$ENV{CC} -Wa,-v -c -o /dev/null -x assembler /dev/null 2>&1`
+		=~ /GNU assembler version ([2-9]\.[0-9]+)/) {
+	$avx = ($1>=2.19) + ($1>=2.22) + ($1>=2.25);
+}
+
+if (!$avx && $win64 && ($flavour =~ /nasm/ || $ENV{ASM} =~ /nasm/) &&
+	   `nasm -v 2>&1` =~ /NASM version ([2-9]\.[0-9]+)(?:\.([0-9]+))?/) {
+	$avx = ($1>=2.09) + ($1>=2.10) + ($1>=2.12);
+	$avx += 1 if ($1==2.11 && $2>=8);
+}
+
+if (!$avx && $win64 && ($flavour =~ /masm/ || $ENV{ASM} =~ /ml64/) &&
+	   `ml64 2>&1` =~ /Version ([0-9]+)\./) {
+	$avx = ($1>=10) + ($1>=11);
+}
+
+if (!$avx && `$ENV{CC} -v 2>&1` =~ /((?:^clang|LLVM) version|.*based on LLVM) ([0-9]+\.[0-9]+)/) {
+	$avx = ($2>=3.0) + ($2>3.0) + ($2>=3.6);
+}
+
+open OUT,"| \"$^X\" \"$xlate\" $flavour \"$output\""
+    or die "can't call $xlate: $!";
+*STDOUT=*OUT;
+
+my @schedule = (
+	[  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 ],
+	[  2,  6,  3, 10,  7,  0,  4, 13,  1, 11, 12,  5,  9, 14, 15,  8 ],
+	[  3,  4, 10, 12, 13,  2,  7, 14,  6,  5,  9,  0, 11, 15,  8,  1 ],
+	[ 10,  7, 12,  9, 14,  3, 13, 15,  4,  0, 11,  2,  5,  8,  1,  6 ],
+	[ 12, 13,  9, 11, 15, 10, 14,  8,  7,  2,  5,  3,  0,  1,  6,  4 ],
+	[  9, 14, 11,  5,  8, 12, 15,  1, 13,  3,  0, 10,  2,  6,  4,  7 ],
+	[ 11, 15,  5,  0,  1,  9,  8,  6, 14, 10,  2, 12,  3,  4,  7, 13 ]
+);
+
+# The state words each G of the column and of the diagonal step takes
+my @columns = ([0,4,8,12],[1,5,9,13],[2,6,10,14],[3,7,11,15]);
+my @diagonals = ([0,5,10,15],[1,6,11,12],[2,7,8,13],[3,4,9,14]);
+
+# void blake3_hashN(const uint8_t *const inputs[N], size_t blocks,
+#                   const uint32_t key[8], uint64_t counter,
+#                   unsigned int flags, uint8_t *out);
+#
+# Hashes N inputs of |blocks| 64-byte blocks, and writes their 32-byte
+# chaining values one after the other to |out|.  Without PARENT in
+# |flags| the inputs are chunks, with consecutive counters from
+# |counter|, and the first and last blocks are flagged.  Parent nodes
+# all have counter 0.
+my ($inputs,$blocks,$key,$counter,$flags,$out)=
+	("%rdi","%rsi","%rdx","%rcx","%r8","%r9");
+# $key and $counter are free after the setup, and $out is moved away to
+# make %r9 the frame register like in the other modules
+my ($bflags,$endflag,$offset,$ptr,$outp)=("%ecx","%edx","%r10","%rax","%r11");
+
+my $xframe = $win64 ? 0xa8 : 8;
+
+sub win64_save {
+$code.=<<___	if ($win64);
+	movaps	%xmm6,-0xa8(%r9)
+	movaps	%xmm7,-0x98(%r9)
+	movaps	%xmm8,-0x88(%r9)
+	movaps	%xmm9,-0x78(%r9)
+	movaps	%xmm10,-0x68(%r9)
+	movaps	%xmm11,-0x58(%r9)
+	movaps	%xmm12,-0x48(%r9)
+	movaps	%xmm13,-0x38(%r9)
+	movaps	%xmm14,-0x28(%r9)
+	movaps	%xmm15,-0x18(%r9)
+___
+}
+
+sub win64_restore {
+$code.=<<___	if ($win64);
+	movaps	-0xa8(%r9),%xmm6
+	movaps	-0x98(%r9),%xmm7
+	movaps	-0x88(%r9),%xmm8
+	movaps	-0x78(%r9),%xmm9
+	movaps	-0x68(%r9),%xmm10
+	movaps	-0x58(%r9),%xmm11
+	movaps	-0x48(%r9),%xmm12
+	movaps	-0x38(%r9),%xmm13
+	movaps	-0x28(%r9),%xmm14
+	movaps	-0x18(%r9),%xmm15
+___
+}
+
+# Chunks get consecutive counters and CHUNK_START/CHUNK_END, parents
+# don't.  %edx is 1 for chunks and 0 for parents, which happens to be
+# both the counter increment and CHUNK_START.
+sub lane_increment {
+$code.=<<___;
+	mov	$flags,%rdx
+	shr	\$2,%edx		# PARENT
+	and	\$1,%edx
+	xor	\$1,%edx
+___
+}
+
+# Once the counters are done with $counter
+sub block_flags {
+$code.=<<___;
+	mov	$flags,%rax
+	or	%edx,%eax
+	mov	%eax,$bflags		# flags of the first block
+	add	%edx,%edx		# CHUNK_END
+	xor	$offset,$offset
+___
+}
+
+if ($avx>1) {{{
+######################################################################
+# AVX2, 8 lanes
+{
+my @v=map("%ymm$_",(0..15));
+my @t=map("%ymm$_",(8..15));
+my ($msg,$lo,$hi,$spill)=(0,512,544,576);	# stack layout
+
+# Four G functions in parallel, with the message words $mx and $my.
+# The c word of the first one is spilled for the two shift rotations.
+sub g4_avx2 {
+my ($quads,$mx,$my)=@_;
+my $tmp=$v[$$quads[0][2]];
+
+    for my $half (0,1) {
+	my $m = $half ? $my : $mx;
+	my ($rd,$rb) = $half ? (8,7) : (16,12);
+	for my $i (0..3) {
+	    my ($a,$b)=map($v[$_],@{$$quads[$i]}[0,1]);
+	    $code.="\tvpaddd	`$msg+32*$$m[$i]`(%rsp),$a,$a\n";
+	    $code.="\tvpaddd	$b,$a,$a\n";
+	}
+	for my $i (0..3) {
+	    my ($a,$d)=map($v[$_],@{$$quads[$i]}[0,3]);
+	    $code.="\tvpxor	$a,$d,$d\n";
+	    $code.="\tvpshufb	.Lrot$rd(%rip),$d,$d\n";
+	}
+	for my $i (0..3) {
+	    my ($b,$c,$d)=map($v[$_],@{$$quads[$i]}[1,2,3]);
+	    $code.="\tvpaddd	$d,$c,$c\n";
+	    $code.="\tvpxor	$c,$b,$b\n";
+	}
+	$code.="\tvmovdqa	$tmp,$spill(%rsp)\n";
+	for my $i (0..3) {
+	    my $b=$v[$$quads[$i][1]];
+	    $code.="\tvpsrld	\$$rb,$b,$tmp\n";
+	    $code.="\tvpslld	\$".(32-$rb).",$b,$b\n";
+	    $code.="\tvpor	$tmp,$b,$b\n";
+	}
+	$code.="\tvmovdqa	$spill(%rsp),$tmp\n";
+    }
+}
+
+# 4x4 transposition of the 32-bit words in each 128-bit lane of $a-$d,
+# with $t0 and $t1; returns the registers with the results in order.
+sub transpose4 {
+my ($a,$b,$c,$d,$t0,$t1)=@_;
+$code.=<<___;
+	vpunpckldq	$b,$a,$t0
+	vpunpckhdq	$b,$a,$a
+	vpunpckldq	$d,$c,$t1
+	vpunpckhdq	$d,$c,$c
+	vpunpcklqdq	$t1,$t0,$b
+	vpunpckhqdq	$t1,$t0,$d
+	vpunpcklqdq	$c,$a,$t0
+	vpunpckhqdq	$c,$a,$t1
+___
+    return ($b,$d,$t0,$t1);
+}
+
+$code.=<<___;
+.text
+.extern	OPENSSL_ia32cap_P
+
+.globl	blake3_hash8_avx2
+.type	blake3_hash8_avx2,\@function,6
+.align	32
+blake3_hash8_avx2:
+.cfi_startproc
+	mov	$out,$outp
+	mov	%rsp,%r9		# frame register
+.cfi_def_cfa_register	%r9
+	sub	\$608+$xframe,%rsp
+	and	\$-32,%rsp
+___
+	&win64_save();
+$code.=<<___;
+.Lhash8_body:
+	vzeroupper
+___
+    for (my $i=0; $i<8; $i++) {
+	$code.="\tvpbroadcastd	`4*$i`($key),$v[$i]\n";
+    }
+	&lane_increment();
+$code.=<<___;
+	vmovd	%edx,%xmm8		# lane counters, without carry
+	vpbroadcastd	%xmm8,%ymm8
+	vpmulld	.Llanes(%rip),%ymm8,%ymm8
+	vmovd	%ecx,%xmm9
+	vpbroadcastd	%xmm9,%ymm9
+	shr	\$32,$counter
+	vmovd	%ecx,%xmm10
+	vpbroadcastd	%xmm10,%ymm10
+	vpaddd	%ymm9,%ymm8,%ymm8
+	vpbroadcastd	.Lsign(%rip),%ymm11
+	vpxor	%ymm11,%ymm8,%ymm12
+	vpxor	%ymm11,%ymm9,%ymm9
+	vpcmpgtd	%ymm12,%ymm9,%ymm9	# carry is -1
+	vpsubd	%ymm9,%ymm10,%ymm10
+	vmovdqa	%ymm8,$lo(%rsp)
+	vmovdqa	%ymm10,$hi(%rsp)
+___
+	&block_flags();
+$code.=<<___;
+	jmp	.Loop_hash8
+
+.align	32
+.Loop_hash8:
+	cmp	\$1,$blocks
+	jne	.Lhash8_not_last
+	or	$endflag,$bflags
+.Lhash8_not_last:
+___
+    # Lanes 0-3 go to the low halves, lanes 4-7 to the high halves, so
+    # after the transposition the words are in lane order.
+    for (my $g=0; $g<4; $g++) {
+	my @r=@t[0..3];
+	for (my $l=0; $l<4; $l++) {
+	    (my $x=$r[$l])=~s/ymm/xmm/;
+$code.=<<___;
+	mov	`8*$l`($inputs),$ptr
+	vmovdqu	`16*$g`($ptr,$offset),$x
+	mov	`8*($l+4)`($inputs),$ptr
+	vinserti128	\$1,`16*$g`($ptr,$offset),$r[$l],$r[$l]
+___
+	}
+	my @w=&transpose4(@r,@t[4,5]);
+	for (my $i=0; $i<4; $i++) {
+	    $code.="\tvmovdqa	$w[$i],`$msg+32*(4*$g+$i)`(%rsp)\n";
+	}
+    }
+$code.=<<___;
+	vpbroadcastd	.Liv+0(%rip),$v[8]
+	vpbroadcastd	.Liv+4(%rip),$v[9]
+	vpbroadcastd	.Liv+8(%rip),$v[10]
+	vpbroadcastd	.Liv+12(%rip),$v[11]
+	vmovdqa	$lo(%rsp),$v[12]
+	vmovdqa	$hi(%rsp),$v[13]
+	vpbroadcastd	.Lblock_len(%rip),$v[14]
+	vmovd	$bflags,%xmm15
+	vpbroadcastd	%xmm15,$v[15]
+___
+    for (my $r=0; $r<7; $r++) {
+	my $s=$schedule[$r];
+	&g4_avx2(\@columns, [@$s[0,2,4,6]], [@$s[1,3,5,7]]);
+	&g4_avx2(\@diagonals, [@$s[8,10,12,14]], [@$s[9,11,13,15]]);
+    }
+    for (my $i=0; $i<8; $i++) {
+	$code.="\tvpxor	$v[$i+8],$v[$i],$v[$i]\n";
+    }
+$code.=<<___;
+	mov	${flags}d,$bflags
+	add	\$64,$offset
+	dec	$blocks
+	jnz	.Loop_hash8
+
+___
+    # Back to one chaining value per lane: the 4x4 transpositions give
+    # the halves, lanes 0-3 in the low 128 bits and lanes 4-7 in the
+    # high ones.
+    my @lo4=&transpose4(@v[0..3],@t[0,1]);
+    my @hi4=&transpose4(@v[4..7],@t[2,3]);
+    for (my $l=0; $l<4; $l++) {
+$code.=<<___;
+	vperm2i128	\$0x20,$hi4[$l],$lo4[$l],$t[4]
+	vperm2i128	\$0x31,$hi4[$l],$lo4[$l],$t[5]
+	vmovdqu	$t[4],`32*$l`($outp)
+	vmovdqu	$t[5],`32*($l+4)`($outp)
+___
+    }
+$code.=<<___;
+	vzeroall
+___
+	&win64_restore();
+$code.=<<___;
+	lea	(%r9),%rsp
+.cfi_def_cfa_register	%rsp
+.Lhash8_epilogue:
+	ret
+.cfi_endproc
+.size	blake3_hash8_avx2,.-blake3_hash8_avx2
+___
+}
+
+if ($avx>2) {
+######################################################################
+# AVX-512F, 16 lanes
+my @v=map("%zmm$_",(0..15));
+my @m=map("%zmm$_",(16..31));
+my @t=map("%zmm$_",(8..15));
+my ($lo,$hi)=(0,64);
+
+sub g4_avx512 {
+my ($quads,$mx,$my)=@_;
+
+    for my $half (0,1) {
+	my $m = $half ? $my : $mx;
+	my ($rd,$rb) = $half ? (8,7) : (16,12);
+	for my $i (0..3) {
+	    my ($a,$b)=map($v[$_],@{$$quads[$i]}[0,1]);
+	    $code.="\tvpaddd	$m[$$m[$i]],$a,$a\n";
+	    $code.="\tvpaddd	$b,$a,$a\n";
+	}
+	for my $i (0..3) {
+	    my ($a,$d)=map($v[$_],@{$$quads[$i]}[0,3]);
+	    $code.="\tvpxord	$a,$d,$d\n";
+	    $code.="\tvprord	\$$rd,$d,$d\n";
+	}
+	for my $i (0..3) {
+	    my ($b,$c,$d)=map($v[$_],@{$$quads[$i]}[1,2,3]);
+	    $code.="\tvpaddd	$d,$c,$c\n";
+	    $code.="\tvpxord	$c,$b,$b\n";
+	    $code.="\tvprord	\$$rb,$b,$b\n";
+	}
+    }
+}
+
+sub transpose4_avx512 {
+my ($a,$b,$c,$d,$t0,$t1,$t2,$t3)=@_;
+$code.=<<___;
+	vpunpckldq	$b,$a,$t0
+	vpunpckhdq	$b,$a,$t1
+	vpunpckldq	$d,$c,$t2
+	vpunpckhdq	$d,$c,$t3
+	vpunpcklqdq	$t2,$t0,$a
+	vpunpckhqdq	$t2,$t0,$b
+	vpunpcklqdq	$t3,$t1,$c
+	vpunpckhqdq	$t3,$t1,$d
+___
+}
+
+$code.=<<___;
+.globl	blake3_hash16_avx512
+.type	blake3_hash16_avx512,\@function,6
+.align	32
+blake3_hash16_avx512:
+.cfi_startproc
+	mov	$out,$outp
+	mov	%rsp,%r9		# frame register
+.cfi_def_cfa_register	%r9
+	sub	\$128+$xframe,%rsp
+	and	\$-64,%rsp
+___
+	&win64_save();
+$code.=<<___;
+.Lhash16_body:
+	vzeroupper
+___
+    for (my $i=0; $i<8; $i++) {
+	$code.="\tvpbroadcastd	`4*$i`($key),$v[$i]\n";
+    }
+	&lane_increment();
+$code.=<<___;
+	vpbroadcastd	%edx,%zmm8
+	vpmulld	.Llanes(%rip),%zmm8,%zmm8
+	vpbroadcastd	%ecx,%zmm9
+	shr	\$32,$counter
+	vpbroadcastd	%ecx,%zmm10
+	vpaddd	%zmm9,%zmm8,%zmm8
+	vpcmpud	\$1,%zmm9,%zmm8,%k1	# carry if lo < counter
+	vpternlogd	\$0xff,%zmm11,%zmm11,%zmm11
+	vpsubd	%zmm11,%zmm10,%zmm10{%k1}
+	vmovdqa32	%zmm8,$lo(%rsp)
+	vmovdqa32	%zmm10,$hi(%rsp)
+___
+	&block_flags();
+$code.=<<___;
+	jmp	.Loop_hash16
+
+.align	32
+.Loop_hash16:
+	cmp	\$1,$blocks
+	jne	.Lhash16_not_last
+	or	$endflag,$bflags
+.Lhash16_not_last:
+___
+    # 128-bit lane j of register l gets lane 4*j+l, so the words come
+    # out of the 4x4 transpositions in lane order.
+    for (my $g=0; $g<4; $g++) {
+	my @r=@m[4*$g..4*$g+3];
+	for (my $l=0; $l<4; $l++) {
+	    (my $x=$r[$l])=~s/zmm/xmm/;
+	    $code.="\tmov	`8*$l`($inputs),$ptr\n";
+	    $code.="\tvmovdqu32	`16*$g`($ptr,$offset),$x\n";
+	    for (my $j=1; $j<4; $j++) {
+		$code.="\tmov	`8*(4*$j+$l)`($inputs),$ptr\n";
+		$code.="\tvinserti32x4	\$$j,`16*$g`($ptr,$offset),$r[$l],$r[$l]\n";
+	    }
+	}
+	&transpose4_avx512(@r,@t[0..3]);
+    }
+$code.=<<___;
+	vpbroadcastd	.Liv+0(%rip),$v[8]
+	vpbroadcastd	.Liv+4(%rip),$v[9]
+	vpbroadcastd	.Liv+8(%rip),$v[10]
+	vpbroadcastd	.Liv+12(%rip),$v[11]
+	vmovdqa32	$lo(%rsp),$v[12]
+	vmovdqa32	$hi(%rsp),$v[13]
+	vpbroadcastd	.Lblock_len(%rip),$v[14]
+	vpbroadcastd	$bflags,$v[15]
+___
+    for (my $r=0; $r<7; $r++) {
+	my $s=$schedule[$r];
+	&g4_avx512(\@columns, [@$s[0,2,4,6]], [@$s[1,3,5,7]]);
+	&g4_avx512(\@diagonals, [@$s[8,10,12,14]], [@$s[9,11,13,15]]);
+    }
+    for (my $i=0; $i<8; $i++) {
+	$code.="\tvpxord	$v[$i+8],$v[$i],$v[$i]\n";
+    }
+$code.=<<___;
+	mov	${flags}d,$bflags
+	add	\$64,$offset
+	dec	$blocks
+	jnz	.Loop_hash16
+
+___
+	&transpose4_avx512(@v[0..3],@t[0..3]);
+	&transpose4_avx512(@v[4..7],@t[0..3]);
+    # Register l has words 0-3 of lane 4*j+l in its 128-bit lane j,
+    # register l+4 words 4-7.
+    for (my $j=0; $j<4; $j++) {
+	for (my $l=0; $l<4; $l++) {
+	    my $lane=4*$j+$l;
+	    if ($j==0) {
+		(my $x0=$v[$l])=~s/zmm/xmm/;
+		(my $x1=$v[$l+4])=~s/zmm/xmm/;
+		$code.="\tvmovdqu	$x0,`32*$lane`($outp)\n";
+		$code.="\tvmovdqu	$x1,`32*$lane+16`($outp)\n";
+	    } else {
+		$code.="\tvextracti32x4	\$$j,$v[$l],`32*$lane`($outp)\n";
+		$code.="\tvextracti32x4	\$$j,$v[$l+4],`32*$lane+16`($outp)\n";
+	    }
+	}
+    }
+$code.=<<___;
+	vzeroall
+___
+	&win64_restore();
+$code.=<<___;
+	lea	(%r9),%rsp
+.cfi_def_cfa_register	%rsp
+.Lhash16_epilogue:
+	ret
+.cfi_endproc
+.size	blake3_hash16_avx512,.-blake3_hash16_avx512
+___
+} else {
+$code.=<<___;	# assembler is too old
+.globl	blake3_hash16_avx512
+.type	blake3_hash16_avx512,\@abi-omnipotent
+blake3_hash16_avx512:
+.cfi_startproc
+	ud2
+.cfi_endproc
+.size	blake3_hash16_avx512,.-blake3_hash16_avx512
+___
+}
+
+$code.=<<___;
+# int blake3_avx_eligible(void);
+#
+# Returns the most lanes the code above does, 16 when the assembler
+# could take the AVX-512 code, 8 when only the AVX2 code.
+.globl	blake3_avx_eligible
+.type	blake3_avx_eligible,\@abi-omnipotent
+.align	32
+blake3_avx_eligible:
+.cfi_startproc
+	mov	\$`$avx>2 ? 16 : 8`,%eax
+	ret
+.cfi_endproc
+.size	blake3_avx_eligible,.-blake3_avx_eligible
+
+.align	64
+.Llanes:
+	.long	0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15
+.Liv:
+	.long	0x6a09e667,0xbb67ae85,0x3c6ef372,0xa54ff53a
+.Lblock_len:
+	.long	64
+.Lsign:
+	.long	0x80000000
+.align	32
+.Lrot16:
+	.byte	2,3,0,1,6,7,4,5,10,11,8,9,14,15,12,13
+	.byte	2,3,0,1,6,7,4,5,10,11,8,9,14,15,12,13
+.Lrot8:
+	.byte	1,2,3,0,5,6,7,4,9,10,11,8,13,14,15,12
+	.byte	1,2,3,0,5,6,7,4,9,10,11,8,13,14,15,12
+.asciz	"BLAKE3 for x86_64, AVX2/AVX512"
+.align	64
+___
+
+# EXCEPTION_DISPOSITION handler (EXCEPTION_RECORD *rec,ULONG64 frame,
+#		CONTEXT *context,DISPATCHER_CONTEXT *disp)
+if ($win64) {
+$rec="%rcx";
+$frame="%rdx";
+$context="%r8";
+$disp="%r9";
+
+$code.=<<___;
+.extern	__imp_RtlVirtualUnwind
+.type	simd_handler,\@abi-omnipotent
+.align	16
+simd_handler:
+	push	%rsi
+	push	%rdi
+	push	%rbx
+	push	%rbp
+	push	%r12
+	push	%r13
+	push	%r14
+	push	%r15
+	pushfq
+	sub	\$64,%rsp
+
+	mov	120($context),%rax	# pull context->Rax
+	mov	248($context),%rbx	# pull context->Rip
+
+	mov	8($disp),%rsi		# disp->ImageBase
+	mov	56($disp),%r11		# disp->HandlerData
+
+	mov	0(%r11),%r10d		# HandlerData[0]
+	lea	(%rsi,%r10),%r10	# prologue label
+	cmp	%r10,%rbx		# context->Rip<prologue label
+	jb	.Lcommon_seh_tail
+
+	mov	192($context),%rax	# pull context->R9
+
+	mov	4(%r11),%r10d		# HandlerData[1]
+	mov	8(%r11),%ecx		# HandlerData[2]
+	lea	(%rsi,%r10),%r10	# epilogue label
+	cmp	%r10,%rbx		# context->Rip>=epilogue label
+	jae	.Lcommon_seh_tail
+
+	neg	%rcx
+	lea	-8(%rax,%rcx),%rsi
+	lea	512($context),%rdi	# &context.Xmm6
+	neg	%ecx
+	shr	\$3,%ecx
+	.long	0xa548f3fc		# cld; rep movsq
+
+.Lcommon_seh_tail:
+	mov	8(%rax),%rdi
+	mov	16(%rax),%rsi
+	mov	%rax,152($context)	# restore context->Rsp
+	mov	%rsi,168($context)	# restore context->Rsi
+	mov	%rdi,176($context)	# restore context->Rdi
+
+	mov	40($disp),%rdi		# disp->ContextRecord
+	mov	$context,%rsi		# context
+	mov	\$154,%ecx		# sizeof(CONTEXT)
+	.long	0xa548f3fc		# cld; rep movsq
+
+	mov	$disp,%rsi
+	xor	%rcx,%rcx		# arg1, UNW_FLAG_NHANDLER
+	mov	8(%rsi),%rdx		# arg2, disp->ImageBase
+	mov	0(%rsi),%r8		# arg3, disp->ControlPc
+	mov	16(%rsi),%r9		# arg4, disp->FunctionEntry
+	mov	40(%rsi),%r10		# disp->ContextRecord
+	lea	56(%rsi),%r11		# &disp->HandlerData
+	lea	24(%rsi),%r12		# &disp->EstablisherFrame
+	mov	%r10,32(%rsp)		# arg5
+	mov	%r11,40(%rsp)		# arg6
+	mov	%r12,48(%rsp)		# arg7
+	mov	%rcx,56(%rsp)		# arg8, (NULL)
+	call	*__imp_RtlVirtualUnwind(%rip)
+
+	mov	\$1,%eax		# ExceptionContinueSearch
+	add	\$64,%rsp
+	popfq
+	pop	%r15
+	pop	%r14
+	pop	%r13
+	pop	%r12
+	pop	%rbp
+	pop	%rbx
+	pop	%rdi
+	pop	%rsi
+	ret
+.size	simd_handler,.-simd_handler
+
+.section	.pdata
+.align	4
+	.rva	.LSEH_begin_blake3_hash8_avx2
+	.rva	.LSEH_end_blake3_hash8_avx2
+	.rva	.LSEH_info_blake3_hash8_avx2
+___
+$code.=<<___ if ($avx>2);
+	.rva	.LSEH_begin_blake3_hash16_avx512
+	.rva	.LSEH_end_blake3_hash16_avx512
+	.rva	.LSEH_info_blake3_hash16_avx512
+___
+$code.=<<___;
+.section	.xdata
+.align	8
+.LSEH_info_blake3_hash8_avx2:
+	.byte	9,0,0,0
+	.rva	simd_handler
+	.rva	.Lhash8_body,.Lhash8_epilogue		# HandlerData[]
+	.long	0xa0,0
+___
+$code.=<<___ if ($avx>2);
+.LSEH_info_blake3_hash16_avx512:
+	.byte	9,0,0,0
+	.rva	simd_handler
+	.rva	.Lhash16_body,.Lhash16_epilogue		# HandlerData[]
+	.long	0xa0,0
+___
+}
+}}} else {{{
+$code=<<___;	# assembler is too old
+.text
+
+.globl	blake3_hash8_avx2
+.type	blake3_hash8_avx2,\@abi-omnipotent
+blake3_hash8_avx2:
+.cfi_startproc
+	ud2
+.cfi_endproc
+.size	blake3_hash8_avx2,.-blake3_hash8_avx2
+
+.globl	blake3_hash16_avx512
+.type	blake3_hash16_avx512,\@abi-omnipotent
+blake3_hash16_avx512:
+.cfi_startproc
+	ud2
+.cfi_endproc
+.size	blake3_hash16_avx512,.-blake3_hash16_avx512
+
+.globl	blake3_avx_eligible
+.type	blake3_avx_eligible,\@abi-omnipotent
+blake3_avx_eligible:
+.cfi_startproc
+	xor	%eax,%eax
+	ret
+.cfi_endproc
+.size	blake3_avx_eligible,.-blake3_avx_eligible
+___
+}}}
+
+$code =~ s/\`([^\`]*)\`/eval($1)/gem;
+
+print $code;
+
+close STDOUT or die "error closing STDOUT: $!";
@@ -1939,6 +1939,475 @@ my @x=map("\"$_\"",@xx);
 	);
 }
 
+########################################################################
+# ChaCha20_Poly1305_8x is 8xAVX2 ChaCha20 with integer-only Poly1305
+# interleaved with its rounds. It handles lengths that are multiple of
+# 512 and hashes as many bytes at 7th argument, which is either input,
+# or, when sealing, output lagging 512 bytes behind. Hash value is
+# accepted in either base 2^64 or base 2^26 and is left in base 2^64,
+# see poly1305-x86_64.pl for layout of its context. Idea is that AVX2
+# ChaCha20 leaves integer units idle, which gives Poly1305 chance to
+# execute virtually for free. On Sapphire Rapids with AVX512 code paths
+# suppressed it's ~25% faster than ChaCha20_8x and poly1305_blocks_avx2
+# one after another. There is no AVX512 counterpart, because there
+# ChaCha20 alone is faster than integer-only Poly1305...
+{
+my ($xb0,$xb1,$xb2,$xb3, $xd0,$xd1,$xd2,$xd3,
+    $xa0,$xa1,$xa2,$xa3, $xt0,$xt1,$xt2,$xt3)=map("%ymm$_",(0..15));
+my ($hash,$poly)=("%rcx","%r11");
+my ($h0,$h1,$h2,$d1,$d2,$d3)=("%r14","%rbx","%rbp","%r8","%r12","%r13");
+my $xframe = $win64 ? 0xa8 : 8;
+
+sub poly1305_block {
+# same as poly1305_iteration in poly1305-x86_64.pl, but with r[0],
+# r[1] and s[1] in memory, and as list, so that it can be interleaved
+	(
+	"add	0($hash),$h0",		# accumulate input
+	"adc	8($hash),$h1",
+	"lea	16($hash),$hash",
+	"adc	\$1,$h2",
+
+	"mov	0x288(%rsp),%rax",
+	"mulq	$h0",			# h0*r1
+	"mov	%rax,$d2",
+	"mov	0x280(%rsp),%rax",
+	"mov	%rdx,$d3",
+
+	"mulq	$h0",			# h0*r0
+	"mov	%rax,$h0",
+	"mov	0x280(%rsp),%rax",
+	"mov	%rdx,$d1",
+
+	"mulq	$h1",			# h1*r0
+	"add	%rax,$d2",
+	"mov	0x290(%rsp),%rax",
+	"adc	%rdx,$d3",
+
+	"mulq	$h1",			# h1*s1
+	"mov	$h2,$h1",
+	"add	%rax,$h0",
+	"adc	%rdx,$d1",
+
+	"imulq	0x290(%rsp),$h1",	# h2*s1
+	"add	$h1,$d2",
+	"mov	$d1,$h1",
+	"adc	\$0,$d3",
+
+	"imulq	0x280(%rsp),$h2",	# h2*r0
+	"add	$d2,$h1",
+	"mov	\$-4,%rax",
+	"adc	$h2,$d3",
+
+	"and	$d3,%rax",		# last reduction step
+	"mov	$d3,$h2",
+	"shr	\$2,$d3",
+	"and	\$3,$h2",
+	"add	$d3,%rax",
+	"add	%rax,$h0",
+	"adc	\$0,$h1",
+	"adc	\$0,$h2"
+	);
+}
+
+sub interleave {
+my ($simd,$ialu)=@_;
+my ($i,$j)=(0,0);
+
+	# %r10 and %r11 are taken, hence rotation masks are loaded
+	# directly, not through pointers...
+	foreach (@$simd) {
+		s/'\(%r10\)'/'.Lrot16(%rip)'/;
+		s/'\(%r11\)'/'.Lrot24(%rip)'/;
+		if (/^&/)	{ eval; }
+		else		{ $code.="\t$_\n"; }
+		for ($j+=@$ialu; $j>=@$simd && $i<@$ialu; $j-=@$simd) {
+			$code.="\t$$ialu[$i++]\n";
+		}
+	}
+	$code.="\t$$ialu[$i++]\n" while ($i<@$ialu);
+}
+
+$code.=<<___;
+.globl	ChaCha20_Poly1305_8x
+.type	ChaCha20_Poly1305_8x,\@function,6
+.align	32
+ChaCha20_Poly1305_8x:
+.cfi_startproc
+___
+$code.=<<___	if ($win64);
+	mov		56(%rsp),%r10		# hash pointer
+___
+$code.=<<___	if (!$win64);
+	mov		8(%rsp),%r10		# hash pointer
+___
+$code.=<<___;
+	push		%rbx
+.cfi_push	%rbx
+	push		%rbp
+.cfi_push	%rbp
+	push		%r12
+.cfi_push	%r12
+	push		%r13
+.cfi_push	%r13
+	push		%r14
+.cfi_push	%r14
+	push		%r15
+.cfi_push	%r15
+	mov		%r9,$poly
+	mov		%rsp,%r9		# frame register
+.cfi_def_cfa_register	%r9
+	sub		\$0x2a0+$xframe,%rsp
+	and		\$-32,%rsp
+___
+$code.=<<___	if ($win64);
+	movaps		%xmm6,-0xa8(%r9)
+	movaps		%xmm7,-0x98(%r9)
+	movaps		%xmm8,-0x88(%r9)
+	movaps		%xmm9,-0x78(%r9)
+	movaps		%xmm10,-0x68(%r9)
+	movaps		%xmm11,-0x58(%r9)
+	movaps		%xmm12,-0x48(%r9)
+	movaps		%xmm13,-0x38(%r9)
+	movaps		%xmm14,-0x28(%r9)
+	movaps		%xmm15,-0x18(%r9)
+___
+$code.=<<___;
+.L8xp_body:
+	vzeroupper
+
+	################ stack layout
+	# +0x00		SIMD equivalent of @x[8-12]
+	# ...
+	# +0x80		constant copy of key[0-2] smashed by lanes
+	# ...
+	# +0x200	SIMD counters (with nonce smashed by lanes)
+	# ...
+	# +0x280	Poly1305 r[0], r[1], s[1] and context pointer
+	# +0x2a0
+
+	vbroadcasti128	.Lsigma(%rip),$xa3	# key[0]
+	vbroadcasti128	($key),$xb3		# key[1]
+	vbroadcasti128	16($key),$xt3		# key[2]
+	vbroadcasti128	($counter),$xd3		# key[3]
+
+	vpshufd		\$0x00,$xa3,$xa0	# smash key by lanes...
+	vpshufd		\$0x55,$xa3,$xa1
+	vmovdqa		$xa0,0x80(%rsp)		# ... and offload
+	vpshufd		\$0xaa,$xa3,$xa2
+	vmovdqa		$xa1,0xa0(%rsp)
+	vpshufd		\$0xff,$xa3,$xa3
+	vmovdqa		$xa2,0xc0(%rsp)
+	vmovdqa		$xa3,0xe0(%rsp)
+
+	vpshufd		\$0x00,$xb3,$xb0
+	vpshufd		\$0x55,$xb3,$xb1
+	vmovdqa		$xb0,0x100(%rsp)
+	vpshufd		\$0xaa,$xb3,$xb2
+	vmovdqa		$xb1,0x120(%rsp)
+	vpshufd		\$0xff,$xb3,$xb3
+	vmovdqa		$xb2,0x140(%rsp)
+	vmovdqa		$xb3,0x160(%rsp)
+
+	vpshufd		\$0x00,$xt3,$xt0	# "xc0"
+	vpshufd		\$0x55,$xt3,$xt1	# "xc1"
+	vmovdqa		$xt0,0x180(%rsp)
+	vpshufd		\$0xaa,$xt3,$xt2	# "xc2"
+	vmovdqa		$xt1,0x1a0(%rsp)
+	vpshufd		\$0xff,$xt3,$xt3	# "xc3"
+	vmovdqa		$xt2,0x1c0(%rsp)
+	vmovdqa		$xt3,0x1e0(%rsp)
+
+	vpshufd		\$0x00,$xd3,$xd0
+	vpshufd		\$0x55,$xd3,$xd1
+	vpaddd		.Lincy(%rip),$xd0,$xd0	# don't save counters yet
+	vpshufd		\$0xaa,$xd3,$xd2
+	vmovdqa		$xd1,0x220(%rsp)
+	vpshufd		\$0xff,$xd3,$xd3
+	vmovdqa		$xd2,0x240(%rsp)
+	vmovdqa		$xd3,0x260(%rsp)
+
+	mov		$len,%r15		# reassign $len
+	mov		%r10,$hash		# reassign hash pointer
+
+	mov		24($poly),$d1		# load r
+	mov		32($poly),$d2
+	mov		$poly,0x298(%rsp)
+	mov		$d2,$d3
+	shr		\$2,$d3
+	mov		$d1,0x280(%rsp)
+	add		$d2,$d3			# s1 = r1 + (r1 >> 2)
+	mov		$d2,0x288(%rsp)
+	mov		$d3,0x290(%rsp)
+
+	mov		0($poly),$d1		# load hash value
+	mov		8($poly),$d2
+	mov		16($poly),$h2
+	cmpl		\$0,20($poly)		# is_base2_26?
+	jne		.Lbase2_26_8xp
+
+	mov		$d1,$h0
+	mov		$d2,$h1
+	jmp		.Loop_enter8xp
+
+.align	16
+.Lbase2_26_8xp:
+	################################# base 2^26 -> base 2^64
+	mov		$d1#d,$h0#d
+	and		\$`-1*(1<<31)`,$d1
+	mov		$d2,%rax
+	mov		$d2#d,$h1#d
+	and		\$`-1*(1<<31)`,$d2
+	mov		$h2#d,$h2#d		# discard is_base2_26
+
+	shr		\$6,$d1
+	shl		\$52,%rax
+	add		$d1,$h0
+	shr		\$12,$h1
+	shr		\$18,$d2
+	add		%rax,$h0
+	adc		$d2,$h1
+
+	mov		$h2,$d1
+	shl		\$40,$d1
+	shr		\$24,$h2
+	add		$d1,$h1
+	adc		\$0,$h2			# can be partially reduced...
+
+	mov		\$-4,$d2		# ... so reduce
+	mov		$h2,$d1
+	and		$h2,$d2
+	shr		\$2,$d1
+	and		\$3,$h2
+	add		$d2,$d1			# =*5
+	add		$d1,$h0
+	adc		\$0,$h1
+	adc		\$0,$h2
+	jmp		.Loop_enter8xp
+
+.align	32
+.Loop_outer8xp:
+	vmovdqa		0x80(%rsp),$xa0		# re-load smashed key
+	vmovdqa		0xa0(%rsp),$xa1
+	vmovdqa		0xc0(%rsp),$xa2
+	vmovdqa		0xe0(%rsp),$xa3
+	vmovdqa		0x100(%rsp),$xb0
+	vmovdqa		0x120(%rsp),$xb1
+	vmovdqa		0x140(%rsp),$xb2
+	vmovdqa		0x160(%rsp),$xb3
+	vmovdqa		0x180(%rsp),$xt0	# "xc0"
+	vmovdqa		0x1a0(%rsp),$xt1	# "xc1"
+	vmovdqa		0x1c0(%rsp),$xt2	# "xc2"
+	vmovdqa		0x1e0(%rsp),$xt3	# "xc3"
+	vmovdqa		0x200(%rsp),$xd0
+	vmovdqa		0x220(%rsp),$xd1
+	vmovdqa		0x240(%rsp),$xd2
+	vmovdqa		0x260(%rsp),$xd3
+	vpaddd		.Leight(%rip),$xd0,$xd0	# next SIMD counters
+
+.Loop_enter8xp:
+	vmovdqa		$xt2,0x40(%rsp)		# SIMD equivalent of "@x[10]"
+	vmovdqa		$xt3,0x60(%rsp)		# SIMD equivalent of "@x[11]"
+	vbroadcasti128	.Lrot16(%rip),$xt3
+	vmovdqa		$xd0,0x200(%rsp)	# save SIMD counters
+	mov		\$10,%r10d
+	jmp		.Loop8xp
+
+.align	32
+.Loop8xp:
+___
+	# 32 blocks are hashed per 512 bytes, 3 in each of 10 double
+	# rounds and 2 more while data is "de-interlaced"...
+	&interleave([&AVX2_lane_ROUND(0, 4, 8,12), &AVX2_lane_ROUND(0, 5,10,15)],
+		    [&poly1305_block(), &poly1305_block(), &poly1305_block()]);
+$code.=<<___;
+	dec		%r10d
+	jnz		.Loop8xp
+
+___
+	my @ialu = (&poly1305_block(), &poly1305_block());
+	my @simd = (
+	"vpaddd		0x80(%rsp),$xa0,$xa0",	# accumulate key
+	"vpaddd		0xa0(%rsp),$xa1,$xa1",
+	"vpaddd		0xc0(%rsp),$xa2,$xa2",
+	"vpaddd		0xe0(%rsp),$xa3,$xa3",
+
+	"vpunpckldq	$xa1,$xa0,$xt2",	# "de-interlace" data
+	"vpunpckldq	$xa3,$xa2,$xt3",
+	"vpunpckhdq	$xa1,$xa0,$xa0",
+	"vpunpckhdq	$xa3,$xa2,$xa2",
+	"vpunpcklqdq	$xt3,$xt2,$xa1",	# "a0"
+	"vpunpckhqdq	$xt3,$xt2,$xt2",	# "a1"
+	"vpunpcklqdq	$xa2,$xa0,$xa3",	# "a2"
+	"vpunpckhqdq	$xa2,$xa0,$xa0"		# "a3"
+	);
+	($xa0,$xa1,$xa2,$xa3,$xt2)=($xa1,$xt2,$xa3,$xa0,$xa2);
+	push @simd, (
+	"vpaddd		0x100(%rsp),$xb0,$xb0",
+	"vpaddd		0x120(%rsp),$xb1,$xb1",
+	"vpaddd		0x140(%rsp),$xb2,$xb2",
+	"vpaddd		0x160(%rsp),$xb3,$xb3",
+
+	"vpunpckldq	$xb1,$xb0,$xt2",
+	"vpunpckldq	$xb3,$xb2,$xt3",
+	"vpunpckhdq	$xb1,$xb0,$xb0",
+	"vpunpckhdq	$xb3,$xb2,$xb2",
+	"vpunpcklqdq	$xt3,$xt2,$xb1",	# "b0"
+	"vpunpckhqdq	$xt3,$xt2,$xt2",	# "b1"
+	"vpunpcklqdq	$xb2,$xb0,$xb3",	# "b2"
+	"vpunpckhqdq	$xb2,$xb0,$xb0"		# "b3"
+	);
+	($xb0,$xb1,$xb2,$xb3,$xt2)=($xb1,$xt2,$xb3,$xb0,$xb2);
+	push @simd, (
+	"vperm2i128	\$0x20,$xb0,$xa0,$xt3",	# "de-interlace" further
+	"vperm2i128	\$0x31,$xb0,$xa0,$xb0",
+	"vperm2i128	\$0x20,$xb1,$xa1,$xa0",
+	"vperm2i128	\$0x31,$xb1,$xa1,$xb1",
+	"vperm2i128	\$0x20,$xb2,$xa2,$xa1",
+	"vperm2i128	\$0x31,$xb2,$xa2,$xb2",
+	"vperm2i128	\$0x20,$xb3,$xa3,$xa2",
+	"vperm2i128	\$0x31,$xb3,$xa3,$xb3"
+	);
+	($xa0,$xa1,$xa2,$xa3,$xt3)=($xt3,$xa0,$xa1,$xa2,$xa3);
+	my ($xc0,$xc1,$xc2,$xc3)=($xt0,$xt1,$xa0,$xa1);
+	push @simd, (
+	"vmovdqa	$xa0,0x00(%rsp)",	# offload $xaN
+	"vmovdqa	$xa1,0x20(%rsp)",
+	"vmovdqa	0x40(%rsp),$xc2",	# $xa0
+	"vmovdqa	0x60(%rsp),$xc3",	# $xa1
+
+	"vpaddd		0x180(%rsp),$xc0,$xc0",
+	"vpaddd		0x1a0(%rsp),$xc1,$xc1",
+	"vpaddd		0x1c0(%rsp),$xc2,$xc2",
+	"vpaddd		0x1e0(%rsp),$xc3,$xc3",
+
+	"vpunpckldq	$xc1,$xc0,$xt2",
+	"vpunpckldq	$xc3,$xc2,$xt3",
+	"vpunpckhdq	$xc1,$xc0,$xc0",
+	"vpunpckhdq	$xc3,$xc2,$xc2",
+	"vpunpcklqdq	$xt3,$xt2,$xc1",	# "c0"
+	"vpunpckhqdq	$xt3,$xt2,$xt2",	# "c1"
+	"vpunpcklqdq	$xc2,$xc0,$xc3",	# "c2"
+	"vpunpckhqdq	$xc2,$xc0,$xc0"		# "c3"
+	);
+	($xc0,$xc1,$xc2,$xc3,$xt2)=($xc1,$xt2,$xc3,$xc0,$xc2);
+	push @simd, (
+	"vpaddd		0x200(%rsp),$xd0,$xd0",
+	"vpaddd		0x220(%rsp),$xd1,$xd1",
+	"vpaddd		0x240(%rsp),$xd2,$xd2",
+	"vpaddd		0x260(%rsp),$xd3,$xd3",
+
+	"vpunpckldq	$xd1,$xd0,$xt2",
+	"vpunpckldq	$xd3,$xd2,$xt3",
+	"vpunpckhdq	$xd1,$xd0,$xd0",
+	"vpunpckhdq	$xd3,$xd2,$xd2",
+	"vpunpcklqdq	$xt3,$xt2,$xd1",	# "d0"
+	"vpunpckhqdq	$xt3,$xt2,$xt2",	# "d1"
+	"vpunpcklqdq	$xd2,$xd0,$xd3",	# "d2"
+	"vpunpckhqdq	$xd2,$xd0,$xd0"		# "d3"
+	);
+	($xd0,$xd1,$xd2,$xd3,$xt2)=($xd1,$xt2,$xd3,$xd0,$xd2);
+	push @simd, (
+	"vperm2i128	\$0x20,$xd0,$xc0,$xt3",	# "de-interlace" further
+	"vperm2i128	\$0x31,$xd0,$xc0,$xd0",
+	"vperm2i128	\$0x20,$xd1,$xc1,$xc0",
+	"vperm2i128	\$0x31,$xd1,$xc1,$xd1",
+	"vperm2i128	\$0x20,$xd2,$xc2,$xc1",
+	"vperm2i128	\$0x31,$xd2,$xc2,$xd2",
+	"vperm2i128	\$0x20,$xd3,$xc3,$xc2",
+	"vperm2i128	\$0x31,$xd3,$xc3,$xd3"
+	);
+	($xc0,$xc1,$xc2,$xc3,$xt3)=($xt3,$xc0,$xc1,$xc2,$xc3);
+	($xb0,$xb1,$xb2,$xb3,$xc0,$xc1,$xc2,$xc3)=
+	($xc0,$xc1,$xc2,$xc3,$xb0,$xb1,$xb2,$xb3);
+	($xa0,$xa1)=($xt2,$xt3);
+	&interleave(\@simd,\@ialu);
+$code.=<<___;
+	vmovdqa		0x00(%rsp),$xa0		# $xaN was offloaded, remember?
+	vmovdqa		0x20(%rsp),$xa1
+
+	vpxor		0x00($inp),$xa0,$xa0	# xor with input
+	vpxor		0x20($inp),$xb0,$xb0
+	vpxor		0x40($inp),$xc0,$xc0
+	vpxor		0x60($inp),$xd0,$xd0
+	vmovdqu		$xa0,0x00($out)
+	vmovdqu		$xb0,0x20($out)
+	vmovdqu		$xc0,0x40($out)
+	vmovdqu		$xd0,0x60($out)
+
+	vpxor		0x80($inp),$xa1,$xa1
+	vpxor		0xa0($inp),$xb1,$xb1
+	vpxor		0xc0($inp),$xc1,$xc1
+	vpxor		0xe0($inp),$xd1,$xd1
+	vmovdqu		$xa1,0x80($out)
+	vmovdqu		$xb1,0xa0($out)
+	vmovdqu		$xc1,0xc0($out)
+	vmovdqu		$xd1,0xe0($out)
+
+	vpxor		0x100($inp),$xa2,$xa2
+	vpxor		0x120($inp),$xb2,$xb2
+	vpxor		0x140($inp),$xc2,$xc2
+	vpxor		0x160($inp),$xd2,$xd2
+	vmovdqu		$xa2,0x100($out)
+	vmovdqu		$xb2,0x120($out)
+	vmovdqu		$xc2,0x140($out)
+	vmovdqu		$xd2,0x160($out)
+
+	vpxor		0x180($inp),$xa3,$xa3
+	vpxor		0x1a0($inp),$xb3,$xb3
+	vpxor		0x1c0($inp),$xc3,$xc3
+	vpxor		0x1e0($inp),$xd3,$xd3
+	lea		0x200($inp),$inp
+	vmovdqu		$xa3,0x180($out)
+	vmovdqu		$xb3,0x1a0($out)
+	vmovdqu		$xc3,0x1c0($out)
+	vmovdqu		$xd3,0x1e0($out)
+	lea		0x200($out),$out
+
+	sub		\$64*8,%r15
+	jnz		.Loop_outer8xp
+
+	mov		0x298(%rsp),$poly
+	mov		$h0,0($poly)		# store hash value
+	mov		$h1,8($poly)
+	mov		$h2,16($poly)		# note that is_base2_26 is zeroed
+
+	vzeroall
+___
+$code.=<<___	if ($win64);
+	movaps		-0xa8(%r9),%xmm6
+	movaps		-0x98(%r9),%xmm7
+	movaps		-0x88(%r9),%xmm8
+	movaps		-0x78(%r9),%xmm9
+	movaps		-0x68(%r9),%xmm10
+	movaps		-0x58(%r9),%xmm11
+	movaps		-0x48(%r9),%xmm12
+	movaps		-0x38(%r9),%xmm13
+	movaps		-0x28(%r9),%xmm14
+	movaps		-0x18(%r9),%xmm15
+___
+$code.=<<___;
+	lea		(%r9),%rsp
+.cfi_def_cfa_register	%rsp
+	pop		%r15
+.cfi_pop	%r15
+	pop		%r14
+.cfi_pop	%r14
+	pop		%r13
+.cfi_pop	%r13
+	pop		%r12
+.cfi_pop	%r12
+	pop		%rbp
+.cfi_pop	%rbp
+	pop		%rbx
+.cfi_pop	%rbx
+	mov		\$1,%eax
+.L8xp_epilogue:
+	ret
+.cfi_endproc
+.size	ChaCha20_Poly1305_8x,.-ChaCha20_Poly1305_8x
+___
+}
+
 my $xframe = $win64 ? 0xa8 : 8;
 
 $code.=<<___;
@@ -2461,6 +2930,16 @@ $code.=<<___;
 .size	ChaCha20_8x,.-ChaCha20_8x
 ___
 }
+if ($avx<2) {
+$code.=<<___;
+.globl	ChaCha20_Poly1305_8x
+.type	ChaCha20_Poly1305_8x,\@abi-omnipotent
+ChaCha20_Poly1305_8x:
+	xor	%eax,%eax		# tell caller to fall back
+	ret
+.size	ChaCha20_Poly1305_8x,.-ChaCha20_Poly1305_8x
+___
+}
 
 ########################################################################
 # AVX512 code paths
@@ -3885,6 +4364,63 @@ simd_handler:
 	jmp	.Lcommon_seh_tail
 .size	simd_handler,.-simd_handler
 
+.type	simd_gpr_handler,\@abi-omnipotent
+.align	16
+simd_gpr_handler:
+	push	%rsi
+	push	%rdi
+	push	%rbx
+	push	%rbp
+	push	%r12
+	push	%r13
+	push	%r14
+	push	%r15
+	pushfq
+	sub	\$64,%rsp
+
+	mov	120($context),%rax	# pull context->Rax
+	mov	248($context),%rbx	# pull context->Rip
+
+	mov	8($disp),%rsi		# disp->ImageBase
+	mov	56($disp),%r11		# disp->HandlerData
+
+	mov	0(%r11),%r10d		# HandlerData[0]
+	lea	(%rsi,%r10),%r10	# prologue label
+	cmp	%r10,%rbx		# context->Rip<prologue label
+	jb	.Lcommon_seh_tail
+
+	mov	152($context),%rax	# pull context->Rsp
+
+	mov	4(%r11),%r10d		# HandlerData[1]
+	lea	(%rsi,%r10),%r10	# epilogue label
+	cmp	%r10,%rbx		# context->Rip>=epilogue label
+	jae	.Lcommon_seh_tail
+
+	mov	192($context),%rax	# pull context->R9
+
+	lea	-0xa8(%rax),%rsi
+	lea	512($context),%rdi	# &context.Xmm6
+	mov	\$20,%ecx
+	.long	0xa548f3fc		# cld; rep movsq
+
+	lea	48(%rax),%rax
+
+	mov	-8(%rax),%rbx
+	mov	-16(%rax),%rbp
+	mov	-24(%rax),%r12
+	mov	-32(%rax),%r13
+	mov	-40(%rax),%r14
+	mov	-48(%rax),%r15
+	mov	%rbx,144($context)	# restore context->Rbx
+	mov	%rbp,160($context)	# restore context->Rbp
+	mov	%r12,216($context)	# restore context->R12
+	mov	%r13,224($context)	# restore context->R13
+	mov	%r14,232($context)	# restore context->R14
+	mov	%r15,240($context)	# restore context->R15
+
+	jmp	.Lcommon_seh_tail
+.size	simd_gpr_handler,.-simd_gpr_handler
+
 .section	.pdata
 .align	4
 	.rva	.LSEH_begin_ChaCha20_ctr32
@@ -3909,6 +4445,10 @@ $code.=<<___ if ($avx);
 	.rva	.LSEH_info_ChaCha20_4xop
 ___
 $code.=<<___ if ($avx>1);
+	.rva	.LSEH_begin_ChaCha20_Poly1305_8x
+	.rva	.LSEH_end_ChaCha20_Poly1305_8x
+	.rva	.LSEH_info_ChaCha20_Poly1305_8x
+
 	.rva	.LSEH_begin_ChaCha20_8x
 	.rva	.LSEH_end_ChaCha20_8x
 	.rva	.LSEH_info_ChaCha20_8x
@@ -3963,6 +4503,11 @@ $code.=<<___ if ($avx);
 	.long	0xa0,0
 ___
 $code.=<<___ if ($avx>1);
+.LSEH_info_ChaCha20_Poly1305_8x:
+	.byte	9,0,0,0
+	.rva	simd_gpr_handler
+	.rva	.L8xp_body,.L8xp_epilogue		# HandlerData[]
+
 .LSEH_info_ChaCha20_8x:
 	.byte	9,0,0,0
 	.rva	simd_handler
@@ -3999,6 +4544,8 @@ ___
 foreach (split("\n",$code)) {
 	s/\`([^\`]*)\`/eval $1/ge;
 
+	s/%r([a-z]+)#d/%e$1/g;
+	s/%r([0-9]+)#d/%r$1d/g;
 	s/%x#%[yz]/%x/g;	# "down-shift"
 
 	print $_,"\n";
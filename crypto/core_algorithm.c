@@ -16,8 +16,11 @@
 struct algorithm_data_st {
     OPENSSL_CTX *libctx;
     int operation_id;            /* May be zero for finding them all */
+    int (*pre)(OSSL_PROVIDER *, int operation_id, void *data, int *result);
     void (*fn)(OSSL_PROVIDER *, const OSSL_ALGORITHM *, int no_store,
                void *data);
+    int (*post)(OSSL_PROVIDER *, int operation_id, int no_store, void *data,
+                int *result);
     void *data;
 };
 
@@ -28,7 +31,6 @@ static int algorithm_do_this(OSSL_PROVIDER *provider, void *cbdata)
     int first_operation = 1;
     int last_operation = OSSL_OP__HIGHEST;
     int cur_operation;
-    int ok = 0;
 
     if (data->operation_id != 0)
         first_operation = last_operation = data->operation_id;
@@ -36,36 +38,66 @@ static int algorithm_do_this(OSSL_PROVIDER *provider, void *cbdata)
     for (cur_operation = first_operation;
          cur_operation <= last_operation;
          cur_operation++) {
-        const OSSL_ALGORITHM *map =
-            ossl_provider_query_operation(provider, data->operation_id,
-                                          &no_store);
+        const OSSL_ALGORITHM *map = NULL;
+        int ret;
 
+        /* Do we fulfill pre-conditions? */
+        if (data->pre == NULL) {
+            /* If there is no pre-condition function, assume "yes" */
+            ret = 1;
+        } else if (!data->pre(provider, cur_operation, data->data, &ret)) {
+            /* Error, bail out! */
+            return 0;
+        }
+
+        /* If pre-condition not fulfilled, go to the next operation */
+        if (!ret)
+            continue;
+
+        map = ossl_provider_query_operation(provider, cur_operation,
+                                            &no_store);
+        /*
+         * A provider without algorithms for this operation is no reason to
+         * stop the walk through the other providers.
+         */
         if (map == NULL)
-            break;
+            continue;
 
-        ok = 1;                  /* As long as we've found *something* */
         while (map->algorithm_names != NULL) {
             const OSSL_ALGORITHM *thismap = map++;
 
             data->fn(provider, thismap, no_store, data->data);
         }
+
+        /* Do we fulfill post-conditions? */
+        if (data->post != NULL
+            && !data->post(provider, cur_operation, no_store, data->data,
+                           &ret))
+            return 0;
     }
 
-    return ok;
+    return 1;
 }
 
 void ossl_algorithm_do_all(OPENSSL_CTX *libctx, int operation_id,
                            OSSL_PROVIDER *provider,
+                           int (*pre)(OSSL_PROVIDER *, int operation_id,
+                                      void *data, int *result),
                            void (*fn)(OSSL_PROVIDER *provider,
                                       const OSSL_ALGORITHM *algo,
                                       int no_store, void *data),
+                           int (*post)(OSSL_PROVIDER *, int operation_id,
+                                       int no_store, void *data,
+                                       int *result),
                            void *data)
 {
     struct algorithm_data_st cbdata;
 
     cbdata.libctx = libctx;
     cbdata.operation_id = operation_id;
+    cbdata.pre = pre;
     cbdata.fn = fn;
+    cbdata.post = post;
     cbdata.data = data;
 
     if (provider == NULL)
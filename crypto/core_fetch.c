@@ -22,8 +22,45 @@ struct construct_data_st {
     int force_store;
     OSSL_METHOD_CONSTRUCT_METHOD *mcm;
     void *mcm_data;
+    /* Set when a method of the current provider couldn't be made or stored */
+    int failed;
 };
 
+static int ossl_method_construct_precondition(OSSL_PROVIDER *provider,
+                                              int operation_id, void *cbdata,
+                                              int *result)
+{
+    /*
+     * If all of the provider's methods for this operation are already in
+     * the global store, constructing them again from the dispatch tables
+     * would only give us copies of what's there already.
+     */
+    struct construct_data_st *data = cbdata;
+
+    if (!ossl_provider_test_operation_bit(provider, operation_id, result))
+        return 0;
+    *result = !*result;
+    data->failed = 0;
+    return 1;
+}
+
+static int ossl_method_construct_postcondition(OSSL_PROVIDER *provider,
+                                               int operation_id, int no_store,
+                                               void *cbdata, int *result)
+{
+    struct construct_data_st *data = cbdata;
+
+    *result = 1;
+    /*
+     * The operation bit says that every method is in the global store, so
+     * it must not be set if any of them didn't make it there.  The next fetch
+     * that needs one of those will then try again.
+     */
+    if ((data->force_store || !no_store) && !data->failed)
+        return ossl_provider_set_operation_bit(provider, operation_id);
+    return 1;
+}
+
 static void ossl_method_construct_this(OSSL_PROVIDER *provider,
                                        const OSSL_ALGORITHM *algo,
                                        int no_store, void *cbdata)
@@ -32,15 +69,18 @@ static void ossl_method_construct_this(OSSL_PROVIDER *provider,
     void *method = NULL;
 
     if ((method = data->mcm->construct(algo, provider, data->mcm_data))
-        == NULL)
+        == NULL) {
+        data->failed = 1;
         return;
+    }
 
     /*
      * Note regarding putting the method in stores:
      *
-     * we don't need to care if it actually got in or not here.
-     * If it didn't get in, it will simply not be available when
-     * ossl_method_construct() tries to get it from the store.
+     * we don't need to care if it actually got in or not here, other than
+     * not marking the operation as done in the global store.  If it didn't
+     * get in, it will simply not be available when ossl_method_construct()
+     * tries to get it from the store.
      *
      * It is *expected* that the put function increments the refcnt
      * of the passed method.
@@ -51,14 +91,23 @@ static void ossl_method_construct_this(OSSL_PROVIDER *provider,
          * If we haven't been told not to store,
          * add to the global store
          */
-        data->mcm->put(data->libctx, NULL, method, provider,
-                       data->operation_id, algo->algorithm_names,
-                       algo->property_definition, data->mcm_data);
+        if (!data->mcm->put(data->libctx, NULL, method, provider,
+                            data->operation_id, algo->algorithm_names,
+                            algo->property_definition, data->mcm_data))
+            data->failed = 1;
     }
 
-    data->mcm->put(data->libctx, data->store, method, provider,
-                   data->operation_id, algo->algorithm_names,
-                   algo->property_definition, data->mcm_data);
+    /*
+     * The temporary store is only made when there's something to put in
+     * it, since fetches of algorithms that no provider has often end up
+     * not constructing anything at all.
+     */
+    if (data->store == NULL)
+        data->store = data->mcm->alloc_tmp_store(data->libctx);
+    if (data->store != NULL)
+        data->mcm->put(data->libctx, data->store, method, provider,
+                       data->operation_id, algo->algorithm_names,
+                       algo->property_definition, data->mcm_data);
 
     /* refcnt-- because we're dropping the reference */
     data->mcm->destruct(method, data->mcm_data);
@@ -77,21 +126,24 @@ void *ossl_method_construct(OPENSSL_CTX *libctx, int operation_id,
          * We have a temporary store to be able to easily search among new
          * items, or items that should find themselves in the global store.
          */
-        if ((cbdata.store = mcm->alloc_tmp_store(libctx)) == NULL)
-            goto fin;
-
+        cbdata.store = NULL;
         cbdata.libctx = libctx;
         cbdata.operation_id = operation_id;
         cbdata.force_store = force_store;
         cbdata.mcm = mcm;
         cbdata.mcm_data = mcm_data;
+        cbdata.failed = 0;
         ossl_algorithm_do_all(libctx, operation_id, NULL,
-                              ossl_method_construct_this, &cbdata);
+                              ossl_method_construct_precondition,
+                              ossl_method_construct_this,
+                              ossl_method_construct_postcondition,
+                              &cbdata);
 
-        method = mcm->get(libctx, cbdata.store, mcm_data);
-        mcm->dealloc_tmp_store(cbdata.store);
+        if (cbdata.store != NULL) {
+            method = mcm->get(libctx, cbdata.store, mcm_data);
+            mcm->dealloc_tmp_store(cbdata.store);
+        }
     }
 
- fin:
     return method;
 }
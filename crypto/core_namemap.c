@@ -9,8 +9,11 @@
 
 #include "e_os.h"                /* strcasecmp */
 #include "internal/namemap.h"
+#include "internal/tsan_assist.h"
 #include <openssl/lhash.h>
 #include "crypto/lhash.h"      /* openssl_lh_strcasehash */
+#include "crypto/ctype.h"
+#include "namemap_builtin.h"
 
 /*-
  * The namenum entry
@@ -35,8 +38,52 @@ struct ossl_namemap_st {
     CRYPTO_RWLOCK *lock;
     LHASH_OF(NAMENUM_ENTRY) *namenum;  /* Name->number mapping */
     int max_number;                    /* Current max number */
+
+    /*
+     * The numbers of the names in namemap_builtin_names[], 0 for those that
+     * haven't been added yet.  They're also in |namenum|, but can be looked
+     * up here without taking the lock.
+     */
+    TSAN_QUALIFIER int builtin[NAMEMAP_BUILTIN_NUM];
 };
 
+/*-
+ * Built-in names
+ * ==============
+ *
+ * namemap_builtin.h has a perfect hash table of all the algorithm names the
+ * built-in providers know of, see crypto/namemap_builtin.pl.
+ */
+
+static uint32_t namemap_builtin_hash(uint32_t seed, const char *name,
+                                     size_t name_len)
+{
+    uint32_t h = 2166136261U ^ seed;
+
+    while (name_len-- > 0) {
+        h ^= (unsigned char)ossl_tolower(*name++);
+        h *= 16777619U;
+    }
+    return h;
+}
+
+/* Returns the index of |name| in namemap_builtin_names[], or -1 */
+static int namemap_builtin_index(const char *name, size_t name_len)
+{
+    uint32_t h = namemap_builtin_hash(0, name, name_len);
+    uint32_t seed = namemap_builtin_seeds[h & (NAMEMAP_BUILTIN_BUCKETS - 1)];
+    int i;
+
+    h = namemap_builtin_hash(seed, name, name_len);
+    i = namemap_builtin_slots[h & (NAMEMAP_BUILTIN_SLOTS - 1)];
+
+    if (i < 0
+        || strncasecmp(namemap_builtin_names[i], name, name_len) != 0
+        || namemap_builtin_names[i][name_len] != '\0')
+        return -1;
+    return i;
+}
+
 /* LHASH callbacks */
 
 static unsigned long namenum_hash(const NAMENUM_ENTRY *n)
@@ -130,12 +177,38 @@ void ossl_namemap_doall_names(const OSSL_NAMEMAP *namemap, int number,
     CRYPTO_THREAD_unlock(namemap->lock);
 }
 
-int ossl_namemap_name2num_n(const OSSL_NAMEMAP *namemap,
-                            const char *name, size_t name_len)
+/* Looks |name| up in |namemap->namenum|, which must be locked */
+static int namemap_name2num_n(const OSSL_NAMEMAP *namemap,
+                              const char *name, size_t name_len)
 {
     NAMENUM_ENTRY *namenum_entry, namenum_tmpl;
+    char buf[64];
     int number = 0;
 
+    /* Most names are short enough not to need an allocation */
+    if (name_len < sizeof(buf)) {
+        memcpy(buf, name, name_len);
+        buf[name_len] = '\0';
+        namenum_tmpl.name = buf;
+    } else if ((namenum_tmpl.name = OPENSSL_strndup(name, name_len)) == NULL) {
+        return 0;
+    }
+    namenum_tmpl.number = 0;
+    namenum_entry =
+        lh_NAMENUM_ENTRY_retrieve(namemap->namenum, &namenum_tmpl);
+    if (namenum_entry != NULL)
+        number = namenum_entry->number;
+    if (namenum_tmpl.name != buf)
+        OPENSSL_free(namenum_tmpl.name);
+
+    return number;
+}
+
+int ossl_namemap_name2num_n(const OSSL_NAMEMAP *namemap,
+                            const char *name, size_t name_len)
+{
+    int number, i;
+
 #ifndef FIPS_MODE
     if (namemap == NULL)
         namemap = ossl_namemap_stored(NULL);
@@ -144,16 +217,12 @@ int ossl_namemap_name2num_n(const OSSL_NAMEMAP *namemap,
     if (namemap == NULL)
         return 0;
 
-    if ((namenum_tmpl.name = OPENSSL_strndup(name, name_len)) == NULL)
-        return 0;
-    namenum_tmpl.number = 0;
+    if ((i = namemap_builtin_index(name, name_len)) >= 0)
+        return tsan_load(&namemap->builtin[i]);
+
     CRYPTO_THREAD_read_lock(namemap->lock);
-    namenum_entry =
-        lh_NAMENUM_ENTRY_retrieve(namemap->namenum, &namenum_tmpl);
-    if (namenum_entry != NULL)
-        number = namenum_entry->number;
+    number = namemap_name2num_n(namemap, name, name_len);
     CRYPTO_THREAD_unlock(namemap->lock);
-    OPENSSL_free(namenum_tmpl.name);
 
     return number;
 }
@@ -196,7 +265,7 @@ int ossl_namemap_add_name_n(OSSL_NAMEMAP *namemap, int number,
                             const char *name, size_t name_len)
 {
     NAMENUM_ENTRY *namenum = NULL;
-    int tmp_number;
+    int tmp_number, i;
 
 #ifndef FIPS_MODE
     if (namemap == NULL)
@@ -211,6 +280,12 @@ int ossl_namemap_add_name_n(OSSL_NAMEMAP *namemap, int number,
 
     CRYPTO_THREAD_write_lock(namemap->lock);
 
+    /* Someone else may have added it while we weren't holding the lock */
+    if ((tmp_number = namemap_name2num_n(namemap, name, name_len)) != 0) {
+        CRYPTO_THREAD_unlock(namemap->lock);
+        return tmp_number;
+    }
+
     if ((namenum = OPENSSL_zalloc(sizeof(*namenum))) == NULL
         || (namenum->name = OPENSSL_strndup(name, name_len)) == NULL)
         goto err;
@@ -221,6 +296,8 @@ int ossl_namemap_add_name_n(OSSL_NAMEMAP *namemap, int number,
 
     if (lh_NAMENUM_ENTRY_error(namemap->namenum))
         goto err;
+    if ((i = namemap_builtin_index(name, name_len)) >= 0)
+        tsan_store(&namemap->builtin[i], tmp_number);
 
     CRYPTO_THREAD_unlock(namemap->lock);
 
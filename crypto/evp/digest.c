@@ -18,6 +18,10 @@
 #include "internal/provider.h"
 #include "evp_local.h"
 
+#ifndef FIPS_MODE
+static EVP_MD *evp_md_implicit_fetch(int nid);
+#endif
+
 /* This call frees resources associated with the context */
 int EVP_MD_CTX_reset(EVP_MD_CTX *ctx)
 {
@@ -34,7 +38,7 @@ int EVP_MD_CTX_reset(EVP_MD_CTX *ctx)
         EVP_PKEY_CTX_free(ctx->pctx);
 #endif
 
-    EVP_MD_free(ctx->fetched_digest);
+    evp_md_ctx_unref(ctx->fetched_digest);
     ctx->fetched_digest = NULL;
     ctx->reqdigest = NULL;
 
@@ -151,7 +155,7 @@ int EVP_DigestInit_ex(EVP_MD_CTX *ctx, const EVP_MD *type, ENGINE *impl)
             || (ctx->flags & EVP_MD_CTX_FLAG_NO_INIT) != 0) {
         if (ctx->digest == ctx->fetched_digest)
             ctx->digest = NULL;
-        EVP_MD_free(ctx->fetched_digest);
+        evp_md_ctx_unref(ctx->fetched_digest);
         ctx->fetched_digest = NULL;
         goto legacy;
     }
@@ -169,14 +173,14 @@ int EVP_DigestInit_ex(EVP_MD_CTX *ctx, const EVP_MD *type, ENGINE *impl)
         EVPerr(EVP_F_EVP_DIGESTINIT_EX, EVP_R_INITIALIZATION_ERROR);
         return 0;
 #else
-        EVP_MD *provmd = EVP_MD_fetch(NULL, OBJ_nid2sn(type->type), "");
+        EVP_MD *provmd = evp_md_implicit_fetch(type->type);
 
         if (provmd == NULL) {
             EVPerr(EVP_F_EVP_DIGESTINIT_EX, EVP_R_INITIALIZATION_ERROR);
             return 0;
         }
         type = provmd;
-        EVP_MD_free(ctx->fetched_digest);
+        evp_md_ctx_unref(ctx->fetched_digest);
         ctx->fetched_digest = provmd;
 #endif
     }
@@ -434,15 +438,13 @@ int EVP_MD_CTX_copy_ex(EVP_MD_CTX *out, const EVP_MD_CTX *in)
     }
 
     EVP_MD_CTX_reset(out);
-    if (out->fetched_digest != NULL)
-        EVP_MD_free(out->fetched_digest);
+    evp_md_ctx_unref(out->fetched_digest);
     *out = *in;
     /* NULL out pointers in case of error */
     out->pctx = NULL;
     out->provctx = NULL;
 
-    if (in->fetched_digest != NULL)
-        EVP_MD_up_ref(in->fetched_digest);
+    evp_md_ctx_ref(in->fetched_digest);
 
     out->provctx = in->digest->dupctx(in->provctx);
     if (out->provctx == NULL) {
@@ -544,6 +546,36 @@ int EVP_Digest(const void *data, size_t count,
     return ret;
 }
 
+int EVP_Digest_many(size_t num, const void *const data[],
+                    const size_t count[], unsigned char *const md[],
+                    const EVP_MD *type, ENGINE *impl)
+{
+    EVP_MD_CTX *ctx;
+    size_t i;
+    int ret;
+
+    if (num == 0)
+        return 1;
+    if ((ctx = EVP_MD_CTX_new()) == NULL)
+        return 0;
+    EVP_MD_CTX_set_flags(ctx, EVP_MD_CTX_FLAG_ONESHOT);
+    ret = EVP_DigestInit_ex(ctx, type, impl);
+    if (ret && ctx->digest->prov != NULL && ctx->digest->digest_many != NULL) {
+        ret = ctx->digest->digest_many(ossl_provider_ctx(ctx->digest->prov),
+                                       num,
+                                       (const unsigned char *const *)data,
+                                       count, md, EVP_MD_size(ctx->digest));
+    } else {
+        for (i = 0; ret && i < num; i++)
+            ret = (i == 0 || EVP_DigestInit_ex(ctx, type, impl))
+                && EVP_DigestUpdate(ctx, data[i], count[i])
+                && EVP_DigestFinal_ex(ctx, md[i], NULL);
+    }
+    EVP_MD_CTX_free(ctx);
+
+    return ret;
+}
+
 int EVP_MD_get_params(const EVP_MD *digest, OSSL_PARAM params[])
 {
     if (digest != NULL && digest->get_params != NULL)
@@ -844,6 +876,10 @@ static void *evp_md_from_dispatch(int name_id,
                 md->gettable_ctx_params =
                     OSSL_get_OP_digest_gettable_ctx_params(fns);
             break;
+        case OSSL_FUNC_DIGEST_DIGEST_MANY:
+            if (md->digest_many == NULL)
+                md->digest_many = OSSL_get_OP_digest_digest_many(fns);
+            break;
         }
     }
     if ((fncnt != 0 && fncnt != 5)
@@ -875,6 +911,20 @@ static void evp_md_free(void *md)
     EVP_MD_free(md);
 }
 
+#ifndef FIPS_MODE
+static void *evp_md_fetch_default(const char *algorithm)
+{
+    return EVP_MD_fetch(NULL, algorithm, "");
+}
+
+/* Fetch the provided counterpart of the legacy digest |nid| */
+static EVP_MD *evp_md_implicit_fetch(int nid)
+{
+    return evp_implicit_fetch(OSSL_OP_DIGEST, nid, OBJ_nid2sn(nid),
+                              evp_md_fetch_default, evp_md_free);
+}
+#endif
+
 EVP_MD *EVP_MD_fetch(OPENSSL_CTX *ctx, const char *algorithm,
                      const char *properties)
 {
@@ -885,6 +935,14 @@ EVP_MD *EVP_MD_fetch(OPENSSL_CTX *ctx, const char *algorithm,
     return md;
 }
 
+EVP_MD *EVP_MD_fetch_query(OPENSSL_CTX *ctx, const char *algorithm,
+                           OSSL_PROPERTY_QUERY *query)
+{
+    return evp_generic_fetch_query(ctx, OSSL_OP_DIGEST, algorithm, query,
+                                   evp_md_from_dispatch, evp_md_up_ref,
+                                   evp_md_free);
+}
+
 int EVP_MD_up_ref(EVP_MD *md)
 {
     int ref = 0;
@@ -893,6 +951,21 @@ int EVP_MD_up_ref(EVP_MD *md)
     return 1;
 }
 
+/*
+ * The references an EVP_MD_CTX holds on its |fetched_digest|.  They aren't
+ * counted for immortal digests, see evp_method_set_immortal().
+ */
+int evp_md_ctx_ref(EVP_MD *md)
+{
+    return md == NULL || md->immortal || EVP_MD_up_ref(md);
+}
+
+void evp_md_ctx_unref(EVP_MD *md)
+{
+    if (md != NULL && !md->immortal)
+        EVP_MD_free(md);
+}
+
 void EVP_MD_free(EVP_MD *md)
 {
     int i;
@@ -137,7 +137,8 @@ static void ctr64_inc(unsigned char *counter)
 #if defined(AESNI_CAPABLE)
 # if defined(__x86_64) || defined(__x86_64__) || defined(_M_AMD64) || defined(_M_X64)
 #  define AES_GCM_ASM2(gctx)      (gctx->gcm.block==(block128_f)aesni_encrypt && \
-                                 gctx->gcm.ghash==gcm_ghash_avx)
+                                 (gctx->gcm.ghash==gcm_ghash_avx || \
+                                  gctx->gcm.ghash==ossl_gcm_ghash_avx512))
 #  undef AES_GCM_ASM2          /* minor size optimization */
 # endif
 
@@ -286,10 +287,18 @@ static int aesni_xts_init_key(EVP_CIPHER_CTX *ctx, const unsigned char *key,
             aesni_set_encrypt_key(key, bits, &xctx->ks1.ks);
             xctx->xts.block1 = (block128_f) aesni_encrypt;
             xctx->stream = aesni_xts_encrypt;
+# ifdef AESNI_XTS_AVX512_CAPABLE
+            if (AESNI_XTS_AVX512_CAPABLE)
+                xctx->stream = aesni_xts_encrypt_avx512;
+# endif
         } else {
             aesni_set_decrypt_key(key, bits, &xctx->ks1.ks);
             xctx->xts.block1 = (block128_f) aesni_decrypt;
             xctx->stream = aesni_xts_decrypt;
+# ifdef AESNI_XTS_AVX512_CAPABLE
+            if (AESNI_XTS_AVX512_CAPABLE)
+                xctx->stream = aesni_xts_decrypt_avx512;
+# endif
         }
 
         aesni_set_encrypt_key(key + bytes, bits, &xctx->ks2.ks);
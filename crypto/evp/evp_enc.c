@@ -21,6 +21,10 @@
 #include "internal/provider.h"
 #include "evp_local.h"
 
+#ifndef FIPS_MODE
+static EVP_CIPHER *evp_cipher_implicit_fetch(int nid);
+#endif
+
 int EVP_CIPHER_CTX_reset(EVP_CIPHER_CTX *ctx)
 {
     if (ctx == NULL)
@@ -34,8 +38,7 @@ int EVP_CIPHER_CTX_reset(EVP_CIPHER_CTX *ctx)
             ctx->cipher->freectx(ctx->provctx);
         ctx->provctx = NULL;
     }
-    if (ctx->fetched_cipher != NULL)
-        EVP_CIPHER_free(ctx->fetched_cipher);
+    evp_cipher_ctx_unref(ctx->fetched_cipher);
     memset(ctx, 0, sizeof(*ctx));
 
     return 1;
@@ -133,7 +136,7 @@ int EVP_CipherInit_ex(EVP_CIPHER_CTX *ctx, const EVP_CIPHER *cipher,
             || impl != NULL) {
         if (ctx->cipher == ctx->fetched_cipher)
             ctx->cipher = NULL;
-        EVP_CIPHER_free(ctx->fetched_cipher);
+        evp_cipher_ctx_unref(ctx->fetched_cipher);
         ctx->fetched_cipher = NULL;
         goto legacy;
     }
@@ -326,18 +329,14 @@ int EVP_CipherInit_ex(EVP_CIPHER_CTX *ctx, const EVP_CIPHER *cipher,
         EVPerr(EVP_F_EVP_CIPHERINIT_EX, EVP_R_INITIALIZATION_ERROR);
         return 0;
 #else
-        EVP_CIPHER *provciph =
-            EVP_CIPHER_fetch(NULL,
-                             cipher->nid == NID_undef ? "NULL"
-                                                      : OBJ_nid2sn(cipher->nid),
-                             "");
+        EVP_CIPHER *provciph = evp_cipher_implicit_fetch(cipher->nid);
 
         if (provciph == NULL) {
             EVPerr(EVP_F_EVP_CIPHERINIT_EX, EVP_R_INITIALIZATION_ERROR);
             return 0;
         }
         cipher = provciph;
-        EVP_CIPHER_free(ctx->fetched_cipher);
+        evp_cipher_ctx_unref(ctx->fetched_cipher);
         ctx->fetched_cipher = provciph;
 #endif
     }
@@ -546,6 +545,73 @@ int EVP_CipherFinal(EVP_CIPHER_CTX *ctx, unsigned char *out, int *outl)
         return EVP_DecryptFinal(ctx, out, outl);
 }
 
+/*
+ * One-shot AEAD operation on top of the streaming interface, for legacy
+ * ciphers and for providers that don't implement OSSL_FUNC_CIPHER_AEAD_CIPHER
+ */
+static int evp_cipher_aead_stream(EVP_CIPHER_CTX *ctx,
+                                  unsigned char *out, size_t *outl,
+                                  const unsigned char *in, size_t inl,
+                                  const unsigned char *iv, size_t ivlen,
+                                  const unsigned char *aad, size_t aadlen,
+                                  unsigned char *tag, size_t taglen)
+{
+    int len, lenf;
+
+    if (inl > INT_MAX || aadlen > INT_MAX || taglen > INT_MAX) {
+        ERR_raise(ERR_LIB_EVP, EVP_R_UPDATE_ERROR);
+        return 0;
+    }
+    if (ivlen != (size_t)EVP_CIPHER_CTX_iv_length(ctx)) {
+        ERR_raise(ERR_LIB_EVP, EVP_R_INVALID_IV_LENGTH);
+        return 0;
+    }
+    if (EVP_CipherInit_ex(ctx, NULL, NULL, NULL, iv, -1) <= 0
+        || (!ctx->encrypt
+            && EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_TAG, (int)taglen,
+                                   tag) <= 0))
+        return 0;
+
+    /* CCM must know the total plaintext length before it gets any AAD */
+    if ((EVP_CIPHER_CTX_mode(ctx) == EVP_CIPH_CCM_MODE
+         && EVP_CipherUpdate(ctx, NULL, &len, NULL, (int)inl) <= 0)
+        || (aadlen > 0
+            && EVP_CipherUpdate(ctx, NULL, &len, aad, (int)aadlen) <= 0)
+        || EVP_CipherUpdate(ctx, out, &len, in, (int)inl) <= 0
+        || EVP_CipherFinal_ex(ctx, out + len, &lenf) <= 0)
+        return 0;
+
+    if (ctx->encrypt
+        && EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_GET_TAG, (int)taglen,
+                               tag) <= 0)
+        return 0;
+    *outl = (size_t)len + lenf;
+    return 1;
+}
+
+int EVP_CipherAEAD(EVP_CIPHER_CTX *ctx, unsigned char *out, size_t *outl,
+                   const unsigned char *in, size_t inl,
+                   const unsigned char *iv, size_t ivlen,
+                   const unsigned char *aad, size_t aadlen,
+                   unsigned char *tag, size_t taglen)
+{
+    if (ctx == NULL || ctx->cipher == NULL) {
+        ERR_raise(ERR_LIB_EVP, EVP_R_NO_CIPHER_SET);
+        return 0;
+    }
+    if ((EVP_CIPHER_flags(ctx->cipher) & EVP_CIPH_FLAG_AEAD_CIPHER) == 0) {
+        ERR_raise(ERR_LIB_EVP, EVP_R_UNSUPPORTED_CIPHER);
+        return 0;
+    }
+
+    if (ctx->cipher->prov != NULL && ctx->cipher->aead_cipher != NULL)
+        return ctx->cipher->aead_cipher(ctx->provctx, out, outl, inl, in, inl,
+                                        iv, ivlen, aad, aadlen, tag, taglen);
+
+    return evp_cipher_aead_stream(ctx, out, outl, in, inl, iv, ivlen,
+                                  aad, aadlen, tag, taglen);
+}
+
 int EVP_EncryptInit(EVP_CIPHER_CTX *ctx, const EVP_CIPHER *cipher,
                     const unsigned char *key, const unsigned char *iv)
 {
@@ -1374,7 +1440,7 @@ int EVP_CIPHER_CTX_copy(EVP_CIPHER_CTX *out, const EVP_CIPHER_CTX *in)
     *out = *in;
     out->provctx = NULL;
 
-    if (in->fetched_cipher != NULL && !EVP_CIPHER_up_ref(in->fetched_cipher)) {
+    if (!evp_cipher_ctx_ref(in->fetched_cipher)) {
         out->fetched_cipher = NULL;
         return 0;
     }
@@ -1571,6 +1637,11 @@ static void *evp_cipher_from_dispatch(const int name_id,
             cipher->settable_ctx_params =
                 OSSL_get_OP_cipher_settable_ctx_params(fns);
             break;
+        case OSSL_FUNC_CIPHER_AEAD_CIPHER:
+            if (cipher->aead_cipher != NULL)
+                break;
+            cipher->aead_cipher = OSSL_get_OP_cipher_aead_cipher(fns);
+            break;
         }
     }
     if ((fnciphcnt != 0 && fnciphcnt != 3 && fnciphcnt != 4)
@@ -1603,6 +1674,21 @@ static void evp_cipher_free(void *cipher)
     EVP_CIPHER_free(cipher);
 }
 
+#ifndef FIPS_MODE
+static void *evp_cipher_fetch_default(const char *algorithm)
+{
+    return EVP_CIPHER_fetch(NULL, algorithm, "");
+}
+
+/* Fetch the provided counterpart of the legacy cipher |nid| */
+static EVP_CIPHER *evp_cipher_implicit_fetch(int nid)
+{
+    return evp_implicit_fetch(OSSL_OP_CIPHER, nid,
+                              nid == NID_undef ? "NULL" : OBJ_nid2sn(nid),
+                              evp_cipher_fetch_default, evp_cipher_free);
+}
+#endif
+
 EVP_CIPHER *EVP_CIPHER_fetch(OPENSSL_CTX *ctx, const char *algorithm,
                              const char *properties)
 {
@@ -1618,6 +1704,21 @@ EVP_CIPHER *EVP_CIPHER_fetch(OPENSSL_CTX *ctx, const char *algorithm,
     return cipher;
 }
 
+EVP_CIPHER *EVP_CIPHER_fetch_query(OPENSSL_CTX *ctx, const char *algorithm,
+                                   OSSL_PROPERTY_QUERY *query)
+{
+    EVP_CIPHER *cipher =
+        evp_generic_fetch_query(ctx, OSSL_OP_CIPHER, algorithm, query,
+                                evp_cipher_from_dispatch, evp_cipher_up_ref,
+                                evp_cipher_free);
+
+    if (cipher != NULL && !evp_cipher_cache_constants(cipher)) {
+        EVP_CIPHER_free(cipher);
+        cipher = NULL;
+    }
+    return cipher;
+}
+
 int EVP_CIPHER_up_ref(EVP_CIPHER *cipher)
 {
     int ref = 0;
@@ -1626,6 +1727,21 @@ int EVP_CIPHER_up_ref(EVP_CIPHER *cipher)
     return 1;
 }
 
+/*
+ * The references an EVP_CIPHER_CTX holds on its |fetched_cipher|.  They
+ * aren't counted for immortal ciphers, see evp_method_set_immortal().
+ */
+int evp_cipher_ctx_ref(EVP_CIPHER *cipher)
+{
+    return cipher == NULL || cipher->immortal || EVP_CIPHER_up_ref(cipher);
+}
+
+void evp_cipher_ctx_unref(EVP_CIPHER *cipher)
+{
+    if (cipher != NULL && !cipher->immortal)
+        EVP_CIPHER_free(cipher);
+}
+
 void EVP_CIPHER_free(EVP_CIPHER *cipher)
 {
     int i;
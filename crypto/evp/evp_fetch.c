@@ -17,6 +17,7 @@
 #include "internal/core.h"
 #include "internal/provider.h"
 #include "internal/namemap.h"
+#include "crypto/cryptlib.h"
 #include "crypto/evp.h"    /* evp_local.h needs it */
 #include "evp_local.h"
 
@@ -46,6 +47,7 @@ struct evp_method_data_st {
     int name_id;                 /* For get_evp_method_from_store() */
     const char *names;           /* For get_evp_method_from_store() */
     const char *propquery;       /* For get_evp_method_from_store() */
+    OSSL_PROPERTY_QUERY *query;  /* Precompiled |propquery|, or NULL */
     void *(*method_from_dispatch)(int name_id, const OSSL_DISPATCH *,
                                   OSSL_PROVIDER *);
     int (*refcnt_up_method)(void *method);
@@ -123,12 +125,36 @@ static void *get_evp_method_from_store(OPENSSL_CTX *libctx, void *store,
         && (store = get_evp_method_store(libctx)) == NULL)
         return NULL;
 
-    if (!ossl_method_store_fetch(store, meth_id, methdata->propquery,
-                                 &method))
+    if (methdata->query != NULL) {
+        if (!ossl_method_store_fetch_query(store, meth_id, methdata->query,
+                                           &method))
+            return NULL;
+    } else if (!ossl_method_store_fetch(store, meth_id, methdata->propquery,
+                                        &method)) {
         return NULL;
+    }
     return method;
 }
 
+/*
+ * Methods in the global method store stay there until their library context
+ * is freed, so contexts don't have to count their references to them.  That
+ * keeps contexts that are used by many threads at once from bouncing the
+ * cache line with the reference count between CPUs.  This is only done for
+ * digests and ciphers, which is where contexts come and go the most.
+ */
+static void evp_method_set_immortal(int operation_id, void *method, int on)
+{
+    switch (operation_id) {
+    case OSSL_OP_DIGEST:
+        ((EVP_MD *)method)->immortal = on;
+        break;
+    case OSSL_OP_CIPHER:
+        ((EVP_CIPHER *)method)->immortal = on;
+        break;
+    }
+}
+
 static int put_evp_method_in_store(OPENSSL_CTX *libctx, void *store,
                                    void *method, const OSSL_PROVIDER *prov,
                                    int operation_id, const char *names,
@@ -157,13 +183,23 @@ static int put_evp_method_in_store(OPENSSL_CTX *libctx, void *store,
         || (meth_id = evp_method_id(operation_id, name_id)) == 0)
         return 0;
 
-    if (store == NULL
-        && (store = get_evp_method_store(libctx)) == NULL)
+    if (store != NULL)
+        return ossl_method_store_add(store, prov, meth_id, propdef, method,
+                                     methdata->refcnt_up_method,
+                                     methdata->destruct_method);
+
+    if ((store = get_evp_method_store(libctx)) == NULL)
         return 0;
 
-    return ossl_method_store_add(store, prov, meth_id, propdef, method,
-                                 methdata->refcnt_up_method,
-                                 methdata->destruct_method);
+    /* Nothing else can see |method| yet, so this is safe */
+    evp_method_set_immortal(operation_id, method, 1);
+    if (!ossl_method_store_add(store, prov, meth_id, propdef, method,
+                               methdata->refcnt_up_method,
+                               methdata->destruct_method)) {
+        evp_method_set_immortal(operation_id, method, 0);
+        return 0;
+    }
+    return 1;
 }
 
 /*
@@ -202,7 +238,7 @@ static void destruct_evp_method(void *method, void *data)
 static void *
 inner_evp_generic_fetch(OPENSSL_CTX *libctx, int operation_id,
                         int name_id, const char *name,
-                        const char *properties,
+                        const char *properties, OSSL_PROPERTY_QUERY *query,
                         void *(*new_method)(int name_id,
                                             const OSSL_DISPATCH *fns,
                                             OSSL_PROVIDER *prov),
@@ -246,7 +282,10 @@ inner_evp_generic_fetch(OPENSSL_CTX *libctx, int operation_id,
         return NULL;
 
     if (meth_id == 0
-        || !ossl_method_store_cache_get(store, meth_id, properties, &method)) {
+        || !(query != NULL
+             ? ossl_method_store_cache_get_query(store, meth_id, query, &method)
+             : ossl_method_store_cache_get(store, meth_id, properties,
+                                           &method))) {
         OSSL_METHOD_CONSTRUCT_METHOD mcm = {
             alloc_tmp_evp_method_store,
             dealloc_tmp_evp_method_store,
@@ -263,6 +302,7 @@ inner_evp_generic_fetch(OPENSSL_CTX *libctx, int operation_id,
         mcmdata.name_id = name_id;
         mcmdata.names = name;
         mcmdata.propquery = properties;
+        mcmdata.query = query;
         mcmdata.method_from_dispatch = new_method;
         mcmdata.refcnt_up_method = up_ref_method;
         mcmdata.destruct_method = free_method;
@@ -286,17 +326,19 @@ inner_evp_generic_fetch(OPENSSL_CTX *libctx, int operation_id,
     return method;
 }
 
-void *evp_generic_fetch(OPENSSL_CTX *libctx, int operation_id,
-                        const char *name, const char *properties,
-                        void *(*new_method)(int name_id,
-                                            const OSSL_DISPATCH *fns,
-                                            OSSL_PROVIDER *prov),
-                        int (*up_ref_method)(void *),
-                        void (*free_method)(void *))
+static void *generic_fetch(OPENSSL_CTX *libctx, int operation_id,
+                           const char *name, const char *properties,
+                           OSSL_PROPERTY_QUERY *query,
+                           void *(*new_method)(int name_id,
+                                               const OSSL_DISPATCH *fns,
+                                               OSSL_PROVIDER *prov),
+                           int (*up_ref_method)(void *),
+                           void (*free_method)(void *))
 {
     void *ret = inner_evp_generic_fetch(libctx,
                                         operation_id, 0, name, properties,
-                                        new_method, up_ref_method, free_method);
+                                        query, new_method, up_ref_method,
+                                        free_method);
 
     if (ret == NULL) {
         int code = EVP_R_FETCH_FAILED;
@@ -316,6 +358,35 @@ void *evp_generic_fetch(OPENSSL_CTX *libctx, int operation_id,
     return ret;
 }
 
+void *evp_generic_fetch(OPENSSL_CTX *libctx, int operation_id,
+                        const char *name, const char *properties,
+                        void *(*new_method)(int name_id,
+                                            const OSSL_DISPATCH *fns,
+                                            OSSL_PROVIDER *prov),
+                        int (*up_ref_method)(void *),
+                        void (*free_method)(void *))
+{
+    return generic_fetch(libctx, operation_id, name, properties, NULL,
+                         new_method, up_ref_method, free_method);
+}
+
+/*
+ * evp_generic_fetch_query() is like evp_generic_fetch(), but takes a property
+ * query that has already been parsed, see OSSL_PROPERTY_QUERY_new().
+ */
+void *evp_generic_fetch_query(OPENSSL_CTX *libctx, int operation_id,
+                              const char *name, OSSL_PROPERTY_QUERY *query,
+                              void *(*new_method)(int name_id,
+                                                  const OSSL_DISPATCH *fns,
+                                                  OSSL_PROVIDER *prov),
+                              int (*up_ref_method)(void *),
+                              void (*free_method)(void *))
+{
+    return generic_fetch(libctx, operation_id, name,
+                         ossl_property_query_string(query), query,
+                         new_method, up_ref_method, free_method);
+}
+
 /*
  * evp_generic_fetch_by_number() is special, and only returns methods for
  * already known names, i.e. it refuses to work if no name_id can be found
@@ -333,8 +404,8 @@ void *evp_generic_fetch_by_number(OPENSSL_CTX *libctx, int operation_id,
 {
     void *ret = inner_evp_generic_fetch(libctx,
                                         operation_id, name_id, NULL,
-                                        properties, new_method, up_ref_method,
-                                        free_method);
+                                        properties, NULL, new_method,
+                                        up_ref_method, free_method);
 
     if (ret == NULL) {
         int code = EVP_R_FETCH_FAILED;
@@ -361,6 +432,241 @@ void *evp_generic_fetch_by_number(OPENSSL_CTX *libctx, int operation_id,
     return ret;
 }
 
+#ifndef FIPS_MODE
+/*
+ * A per thread cache of the methods that are implicitly fetched for legacy
+ * EVP_MD and EVP_CIPHER objects, see evp_implicit_fetch() below.  It's
+ * direct mapped on the legacy NID, which is good enough for the handful of
+ * algorithms a thread typically uses over and over again.
+ */
+# define IMPLICIT_FETCH_CACHE_SIZE      32
+
+typedef struct {
+    int operation_id;
+    int nid;
+    int generation;
+    void *method;
+    void (*free_method)(void *);
+} IMPLICIT_FETCH;
+
+typedef struct implicit_fetch_cache_st IMPLICIT_FETCH_CACHE;
+struct implicit_fetch_cache_st {
+    OSSL_METHOD_STORE *store;
+    IMPLICIT_FETCH cache[IMPLICIT_FETCH_CACHE_SIZE];
+    /* All caches, so that those of every thread can be freed */
+    IMPLICIT_FETCH_CACHE *prev, *next;
+};
+
+static CRYPTO_ONCE implicit_fetch_init = CRYPTO_ONCE_STATIC_INIT;
+static CRYPTO_THREAD_LOCAL implicit_fetch_local;
+static CRYPTO_RWLOCK *implicit_fetch_lock = NULL;
+static IMPLICIT_FETCH_CACHE *implicit_fetch_caches = NULL;
+static int implicit_fetch_inited = 0;
+
+static void implicit_fetch_ctx_free(OPENSSL_CTX *libctx);
+
+DEFINE_RUN_ONCE_STATIC(do_implicit_fetch_init)
+{
+    if ((implicit_fetch_lock = CRYPTO_THREAD_lock_new()) == NULL)
+        return 0;
+    if (!CRYPTO_THREAD_init_local(&implicit_fetch_local, NULL)) {
+        CRYPTO_THREAD_lock_free(implicit_fetch_lock);
+        implicit_fetch_lock = NULL;
+        return 0;
+    }
+    /*
+     * The cached methods are tied to the default library context, so they
+     * must all be gone before it is.
+     */
+    if (!openssl_ctx_onfree(openssl_ctx_get_concrete(NULL),
+                            implicit_fetch_ctx_free)) {
+        CRYPTO_THREAD_cleanup_local(&implicit_fetch_local);
+        CRYPTO_THREAD_lock_free(implicit_fetch_lock);
+        implicit_fetch_lock = NULL;
+        return 0;
+    }
+    implicit_fetch_inited = 1;
+    return 1;
+}
+
+/* Must be called with implicit_fetch_lock held */
+static void implicit_fetch_cache_free(IMPLICIT_FETCH_CACHE *c)
+{
+    size_t i;
+
+    if (c->prev != NULL)
+        c->prev->next = c->next;
+    else
+        implicit_fetch_caches = c->next;
+    if (c->next != NULL)
+        c->next->prev = c->prev;
+    for (i = 0; i < OSSL_NELEM(c->cache); i++)
+        if (c->cache[i].method != NULL)
+            c->cache[i].free_method(c->cache[i].method);
+    OPENSSL_free(c);
+}
+
+/*
+ * The thread stop handler.  It frees the cache it was registered with rather
+ * than looking up the one of the current thread, which isn't necessarily the
+ * thread that stopped, nor reliably available while a thread is exiting.
+ */
+static void implicit_fetch_delete_thread_state(void *arg)
+{
+    IMPLICIT_FETCH_CACHE *c = arg;
+
+    if (!implicit_fetch_inited)
+        return;
+    if (CRYPTO_THREAD_get_local(&implicit_fetch_local) == c)
+        CRYPTO_THREAD_set_local(&implicit_fetch_local, NULL);
+    CRYPTO_THREAD_write_lock(implicit_fetch_lock);
+    implicit_fetch_cache_free(c);
+    CRYPTO_THREAD_unlock(implicit_fetch_lock);
+}
+
+/* Free the caches of all threads when the default library context goes */
+static void implicit_fetch_ctx_free(OPENSSL_CTX *libctx)
+{
+    if (!implicit_fetch_inited)
+        return;
+    /* The caches are about to go, so must their thread stop handlers */
+    ossl_init_thread_deregister(&implicit_fetch_local);
+    CRYPTO_THREAD_set_local(&implicit_fetch_local, NULL);
+    CRYPTO_THREAD_write_lock(implicit_fetch_lock);
+    while (implicit_fetch_caches != NULL)
+        implicit_fetch_cache_free(implicit_fetch_caches);
+    CRYPTO_THREAD_unlock(implicit_fetch_lock);
+}
+
+void evp_implicit_fetch_cleanup(void)
+{
+    if (!implicit_fetch_inited)
+        return;
+    /* implicit_fetch_ctx_free() has normally left nothing to free here */
+    while (implicit_fetch_caches != NULL)
+        implicit_fetch_cache_free(implicit_fetch_caches);
+    CRYPTO_THREAD_cleanup_local(&implicit_fetch_local);
+    CRYPTO_THREAD_lock_free(implicit_fetch_lock);
+    implicit_fetch_lock = NULL;
+    implicit_fetch_inited = 0;
+}
+
+static IMPLICIT_FETCH_CACHE *get_implicit_fetch_cache(void)
+{
+    IMPLICIT_FETCH_CACHE *c;
+    OPENSSL_CTX *libctx;
+
+    if (!RUN_ONCE(&implicit_fetch_init, do_implicit_fetch_init)
+            || !implicit_fetch_inited)
+        return NULL;
+    if ((c = CRYPTO_THREAD_get_local(&implicit_fetch_local)) != NULL)
+        return c;
+
+    libctx = openssl_ctx_get_concrete(NULL);
+    if ((c = OPENSSL_zalloc(sizeof(*c))) == NULL)
+        return NULL;
+    if ((c->store = get_evp_method_store(libctx)) == NULL
+            || !CRYPTO_THREAD_set_local(&implicit_fetch_local, c)) {
+        OPENSSL_free(c);
+        return NULL;
+    }
+    if (!ossl_init_thread_start(&implicit_fetch_local, c,
+                                implicit_fetch_delete_thread_state)) {
+        CRYPTO_THREAD_set_local(&implicit_fetch_local, NULL);
+        OPENSSL_free(c);
+        return NULL;
+    }
+    CRYPTO_THREAD_write_lock(implicit_fetch_lock);
+    c->next = implicit_fetch_caches;
+    if (c->next != NULL)
+        c->next->prev = c;
+    implicit_fetch_caches = c;
+    CRYPTO_THREAD_unlock(implicit_fetch_lock);
+    return c;
+}
+
+static int evp_method_is_immortal(int operation_id, const void *method)
+{
+    switch (operation_id) {
+    case OSSL_OP_DIGEST:
+        return ((const EVP_MD *)method)->immortal;
+    case OSSL_OP_CIPHER:
+        return ((const EVP_CIPHER *)method)->immortal;
+    }
+    return 0;
+}
+
+static int evp_method_up_ref(int operation_id, void *method)
+{
+    switch (operation_id) {
+    case OSSL_OP_DIGEST:
+        return EVP_MD_up_ref(method);
+    case OSSL_OP_CIPHER:
+        return EVP_CIPHER_up_ref(method);
+    }
+    return 0;
+}
+
+/*
+ * Fetch the method |name| for the legacy |nid| with |fetch_method|, which
+ * fetches from the default library context with the default properties, the
+ * way it's done implicitly when a legacy EVP_MD or EVP_CIPHER is passed to an
+ * init function.
+ *
+ * Repeating such a fetch is common, so the result is cached per thread and
+ * reused for as long as the method store doesn't change.  That makes a repeat
+ * fetch cost no more than looking at the cache and taking a reference, with
+ * no locks involved.
+ *
+ * The caller gets a context reference, i.e. no reference is taken for
+ * immortal methods, see evp_method_set_immortal().
+ */
+void *evp_implicit_fetch(int operation_id, int nid, const char *name,
+                         void *(*fetch_method)(const char *name),
+                         void (*free_method)(void *))
+{
+    IMPLICIT_FETCH_CACHE *c = get_implicit_fetch_cache();
+    IMPLICIT_FETCH *ent;
+    void *method;
+    int generation;
+
+    if (c == NULL || nid <= 0) {
+        method = fetch_method(name);
+        /* The store keeps immortal methods alive, we needn't */
+        if (method != NULL && evp_method_is_immortal(operation_id, method))
+            free_method(method);
+        return method;
+    }
+
+    ent = &c->cache[nid % IMPLICIT_FETCH_CACHE_SIZE];
+    /* Taken before any fetch, in case the store changes under our feet */
+    generation = ossl_method_store_generation(c->store);
+    if (ent->method != NULL
+            && ent->nid == nid
+            && ent->operation_id == operation_id
+            && ent->generation == generation
+            && (evp_method_is_immortal(operation_id, ent->method)
+                || evp_method_up_ref(operation_id, ent->method)))
+        return ent->method;
+
+    method = fetch_method(name);
+    if (method == NULL)
+        return NULL;
+    if (!evp_method_is_immortal(operation_id, method)
+            && !evp_method_up_ref(operation_id, method))
+        return method;
+
+    if (ent->method != NULL)
+        ent->free_method(ent->method);
+    ent->operation_id = operation_id;
+    ent->nid = nid;
+    ent->generation = generation;
+    ent->method = method;
+    ent->free_method = free_method;
+    return method;
+}
+#endif
+
 int EVP_set_default_properties(OPENSSL_CTX *libctx, const char *propq)
 {
     OSSL_METHOD_STORE *store = get_evp_method_store(libctx);
@@ -412,7 +718,8 @@ void evp_generic_do_all(OPENSSL_CTX *libctx, int operation_id,
     data.free_method = free_method;
     data.user_fn = user_fn;
     data.user_arg = user_arg;
-    ossl_algorithm_do_all(libctx, operation_id, NULL, do_one, &data);
+    ossl_algorithm_do_all(libctx, operation_id, NULL, NULL, do_one, NULL,
+                          &data);
 }
 
 const char *evp_first_name(const OSSL_PROVIDER *prov, int name_id)
@@ -209,6 +209,13 @@ void *evp_generic_fetch(OPENSSL_CTX *ctx, int operation_id,
                                             OSSL_PROVIDER *prov),
                         int (*up_ref_method)(void *),
                         void (*free_method)(void *));
+void *evp_generic_fetch_query(OPENSSL_CTX *ctx, int operation_id,
+                              const char *name, OSSL_PROPERTY_QUERY *query,
+                              void *(*new_method)(int name_id,
+                                                  const OSSL_DISPATCH *fns,
+                                                  OSSL_PROVIDER *prov),
+                              int (*up_ref_method)(void *),
+                              void (*free_method)(void *));
 void *evp_generic_fetch_by_number(OPENSSL_CTX *ctx, int operation_id,
                                   int name_id, const char *properties,
                                   void *(*new_method)(int name_id,
@@ -216,6 +223,13 @@ void *evp_generic_fetch_by_number(OPENSSL_CTX *ctx, int operation_id,
                                                       OSSL_PROVIDER *prov),
                                   int (*up_ref_method)(void *),
                                   void (*free_method)(void *));
+int evp_md_ctx_ref(EVP_MD *md);
+void evp_md_ctx_unref(EVP_MD *md);
+int evp_cipher_ctx_ref(EVP_CIPHER *cipher);
+void evp_cipher_ctx_unref(EVP_CIPHER *cipher);
+void *evp_implicit_fetch(int operation_id, int nid, const char *name,
+                         void *(*fetch_method)(const char *name),
+                         void (*free_method)(void *));
 void evp_generic_do_all(OPENSSL_CTX *libctx, int operation_id,
                         void (*user_fn)(void *method, void *arg),
                         void *user_arg,
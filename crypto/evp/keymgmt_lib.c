@@ -14,6 +14,7 @@
 #include "crypto/asn1.h"
 #include "internal/core.h"
 #include "internal/provider.h"
+#include "internal/rcu.h"
 #include "evp_local.h"
 
 /*
@@ -77,7 +78,7 @@ void *evp_keymgmt_util_export_to_provider(EVP_PKEY *pk, EVP_KEYMGMT *keymgmt)
     /* If this key is already exported to |keymgmt|, no more to do */
     i = evp_keymgmt_util_find_operation_cache_index(pk, keymgmt);
     if (i < OSSL_NELEM(pk->operation_cache)
-        && pk->operation_cache[i].keymgmt != NULL)
+        && ossl_rcu_deref((void **)&pk->operation_cache[i].keymgmt) != NULL)
         return pk->operation_cache[i].keydata;
 
     /* If the "origin" |keymgmt| doesn't support exporting, give up */
@@ -88,21 +89,36 @@ void *evp_keymgmt_util_export_to_provider(EVP_PKEY *pk, EVP_KEYMGMT *keymgmt)
     if (pk->keymgmt->export == NULL)
         return NULL;
 
-    /* Check that we have found an empty slot in the export cache */
     /*
-     * TODO(3.0) Right now, we assume we have ample space.  We will have to
-     * think about a cache aging scheme, though, if |i| indexes outside the
-     * array.
+     * Make sure that the type of the keymgmt to export to matches the type
+     * of the "origin"
      */
-    if (!ossl_assert(i < OSSL_NELEM(pk->operation_cache)))
+    if (!ossl_assert(match_type(pk->keymgmt, keymgmt)))
         return NULL;
 
     /*
-     * Make sure that the type of the keymgmt to export to matches the type
-     * of the "origin"
+     * Cache hits above don't lock, but only one thread at a time may add
+     * to the cache, and it must look again, since another thread may have
+     * done this export while we were waiting for the lock.
      */
-    if (!ossl_assert(match_type(pk->keymgmt, keymgmt)))
+    if (!CRYPTO_THREAD_write_lock(pk->lock))
         return NULL;
+    i = evp_keymgmt_util_find_operation_cache_index(pk, keymgmt);
+    if (i < OSSL_NELEM(pk->operation_cache)
+        && pk->operation_cache[i].keymgmt != NULL) {
+        import_data.keydata = pk->operation_cache[i].keydata;
+        goto end;
+    }
+
+    /* Check that we have found an empty slot in the export cache */
+    /*
+     * TODO(3.0) Right now, we assume we have ample space.  We will have to
+     * think about a cache aging scheme, though, if |i| indexes outside the
+     * array.
+     */
+    import_data.keydata = NULL;
+    if (!ossl_assert(i < OSSL_NELEM(pk->operation_cache)))
+        goto end;
 
     /*
      * We look at the already cached provider keys, and import from the
@@ -111,7 +127,6 @@ void *evp_keymgmt_util_export_to_provider(EVP_PKEY *pk, EVP_KEYMGMT *keymgmt)
      */
 
     /* Setup for the export callback */
-    import_data.keydata = NULL;  /* try_import will create it */
     import_data.keymgmt = keymgmt;
     import_data.selection = OSSL_KEYMGMT_SELECT_ALL;
 
@@ -123,15 +138,18 @@ void *evp_keymgmt_util_export_to_provider(EVP_PKEY *pk, EVP_KEYMGMT *keymgmt)
                             &try_import, &import_data)) {
         /* If there was an error, bail out */
         evp_keymgmt_freedata(keymgmt, import_data.keydata);
-        return NULL;
+        import_data.keydata = NULL;
+        goto end;
     }
 
     /* Add the new export to the operation cache */
     if (!evp_keymgmt_util_cache_keydata(pk, i, keymgmt, import_data.keydata)) {
         evp_keymgmt_freedata(keymgmt, import_data.keydata);
-        return NULL;
+        import_data.keydata = NULL;
     }
 
+ end:
+    CRYPTO_THREAD_unlock(pk->lock);
     return import_data.keydata;
 }
 
@@ -157,8 +175,12 @@ size_t evp_keymgmt_util_find_operation_cache_index(EVP_PKEY *pk,
 {
     size_t i, end = OSSL_NELEM(pk->operation_cache);
 
-    for (i = 0; i < end && pk->operation_cache[i].keymgmt != NULL; i++) {
-        if (keymgmt == pk->operation_cache[i].keymgmt)
+    /* Entries are filled in order, and published by their |keymgmt| */
+    for (i = 0; i < end; i++) {
+        EVP_KEYMGMT *cached =
+            ossl_rcu_deref((void **)&pk->operation_cache[i].keymgmt);
+
+        if (cached == NULL || cached == keymgmt)
             break;
     }
 
@@ -171,8 +193,10 @@ int evp_keymgmt_util_cache_keydata(EVP_PKEY *pk, size_t index,
     if (keydata != NULL) {
         if (!EVP_KEYMGMT_up_ref(keymgmt))
             return 0;
+        /* |keydata| must be visible before lock-free readers see |keymgmt| */
         pk->operation_cache[index].keydata = keydata;
-        pk->operation_cache[index].keymgmt = keymgmt;
+        ossl_rcu_assign_ptr((void **)&pk->operation_cache[index].keymgmt,
+                            keymgmt);
     }
     return 1;
 }
@@ -167,6 +167,9 @@ static int do_sigver_init(EVP_MD_CTX *ctx, EVP_PKEY_CTX **pctx,
              */
             ctx->reqdigest = ctx->fetched_digest =
                 EVP_MD_fetch(locpctx->libctx, mdname, props);
+            /* Only keep a context reference, see evp_md_ctx_ref() */
+            if (ctx->fetched_digest != NULL && ctx->fetched_digest->immortal)
+                EVP_MD_free(ctx->fetched_digest);
         }
     }
 
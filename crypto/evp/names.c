@@ -161,6 +161,7 @@ void evp_cleanup_int(void)
 
     EVP_PBE_cleanup();
     OBJ_sigid_free();
+    evp_implicit_fetch_cleanup();
 
     evp_app_cleanup_int();
 }
@@ -33,6 +33,7 @@
 #include "crypto/asn1.h"
 #include "crypto/evp.h"
 #include "internal/provider.h"
+#include "internal/rcu.h"
 #include "evp_local.h"
 
 static int pkey_set_type(EVP_PKEY *pkey, ENGINE *e, int type, const char *str,
@@ -1183,6 +1184,11 @@ static void evp_pkey_free_it(EVP_PKEY *x)
     /* internal function; x is never NULL */
 
     evp_keymgmt_util_clear_operation_cache(x);
+    EVP_KEYMGMT_free(x->pin_keymgmt);
+    OPENSSL_free(x->pin_propquery);
+    x->pin_keymgmt = NULL;
+    x->pin_propquery = NULL;
+    x->pin_libctx = NULL;
 #ifndef FIPS_MODE
     evp_pkey_free_legacy(x);
 #endif
@@ -1236,6 +1242,7 @@ void *evp_pkey_export_to_provider(EVP_PKEY *pk, OPENSSL_CTX *libctx,
     EVP_KEYMGMT *allocated_keymgmt = NULL;
     EVP_KEYMGMT *tmp_keymgmt = NULL;
     void *keydata = NULL;
+    int locked = 0;
     int check;
 
     if (pk == NULL)
@@ -1273,9 +1280,11 @@ void *evp_pkey_export_to_provider(EVP_PKEY *pk, OPENSSL_CTX *libctx,
     if (tmp_keymgmt == NULL) {
         EVP_PKEY_CTX *ctx = EVP_PKEY_CTX_new_from_pkey(libctx, pk, propquery);
 
-        tmp_keymgmt = ctx->keymgmt;
-        ctx->keymgmt = NULL;
-        EVP_PKEY_CTX_free(ctx);
+        if (ctx != NULL) {
+            allocated_keymgmt = tmp_keymgmt = ctx->keymgmt;
+            ctx->keymgmt = NULL;
+            EVP_PKEY_CTX_free(ctx);
+        }
     }
 
     /* If there's still no keymgmt to be had, give up */
@@ -1288,8 +1297,7 @@ void *evp_pkey_export_to_provider(EVP_PKEY *pk, OPENSSL_CTX *libctx,
 
         /*
          * If the legacy "origin" hasn't changed since last time, we try
-         * to find our keymgmt in the operation cache.  If it has changed,
-         * |i| remains zero, and we will clear the cache further down.
+         * to find our keymgmt in the operation cache, without locking.
          */
         if (pk->ameth->dirty_cnt(pk) == pk->dirty_cnt_copy) {
             i = evp_keymgmt_util_find_operation_cache_index(pk, tmp_keymgmt);
@@ -1300,6 +1308,26 @@ void *evp_pkey_export_to_provider(EVP_PKEY *pk, OPENSSL_CTX *libctx,
              * token copies of the cached pointers, to have token success
              * values to return.
              */
+            if (i < OSSL_NELEM(pk->operation_cache)
+                && ossl_rcu_deref((void **)&pk->operation_cache[i].keymgmt)
+                   != NULL) {
+                keydata = pk->operation_cache[i].keydata;
+                goto end;
+            }
+        }
+
+        /*
+         * Only one thread at a time may export and add to the cache, and it
+         * must look again once it has the lock.  If the legacy "origin" has
+         * changed since last time, |i| remains zero, and we will clear the
+         * cache further down.
+         */
+        if (!CRYPTO_THREAD_write_lock(pk->lock))
+            goto end;
+        locked = 1;
+        i = 0;
+        if (pk->ameth->dirty_cnt(pk) == pk->dirty_cnt_copy) {
+            i = evp_keymgmt_util_find_operation_cache_index(pk, tmp_keymgmt);
             if (i < OSSL_NELEM(pk->operation_cache)
                 && pk->operation_cache[i].keymgmt != NULL) {
                 keydata = pk->operation_cache[i].keydata;
@@ -1359,21 +1387,83 @@ void *evp_pkey_export_to_provider(EVP_PKEY *pk, OPENSSL_CTX *libctx,
     keydata = evp_keymgmt_util_export_to_provider(pk, tmp_keymgmt);
 
  end:
+    if (locked)
+        CRYPTO_THREAD_unlock(pk->lock);
+
     /*
      * If nothing was exported, |tmp_keymgmt| might point at a freed
      * EVP_KEYMGMT, so we clear it to be safe.  It shouldn't be useful for
-     * the caller either way in that case.
+     * the caller either way in that case.  A keymgmt that we fetched
+     * ourselves is otherwise handed over to the caller.
      */
-    if (keydata == NULL)
+    if (keydata == NULL) {
         tmp_keymgmt = NULL;
+        EVP_KEYMGMT_free(allocated_keymgmt);
+    }
 
     if (keymgmt != NULL)
         *keymgmt = tmp_keymgmt;
 
-    EVP_KEYMGMT_free(allocated_keymgmt);
     return keydata;
 }
 
+EVP_KEYMGMT *evp_pkey_pinned_keymgmt(EVP_PKEY *pk, OPENSSL_CTX *libctx,
+                                     const char *propquery)
+{
+    EVP_KEYMGMT *keymgmt = ossl_rcu_deref((void **)&pk->pin_keymgmt);
+
+    if (keymgmt == NULL || pk->pin_libctx != libctx)
+        return NULL;
+    if (propquery == NULL ? pk->pin_propquery != NULL
+        : pk->pin_propquery == NULL || strcmp(propquery, pk->pin_propquery) != 0)
+        return NULL;
+    if (!EVP_KEYMGMT_up_ref(keymgmt))
+        return NULL;
+    return keymgmt;
+}
+
+int EVP_PKEY_pin_to_provider(EVP_PKEY *pkey, OPENSSL_CTX *libctx,
+                             const char *propquery)
+{
+    EVP_KEYMGMT *keymgmt = NULL;
+    char *propq = NULL;
+    int ret = 0;
+
+    if (pkey == NULL) {
+        ERR_raise(ERR_LIB_EVP, ERR_R_PASSED_NULL_PARAMETER);
+        return 0;
+    }
+
+    if (evp_pkey_export_to_provider(pkey, libctx, &keymgmt, propquery) == NULL
+        || keymgmt == NULL) {
+        ERR_raise(ERR_LIB_EVP, EVP_R_KEYMGMT_EXPORT_FAILURE);
+        return 0;
+    }
+
+    /* Only the first pin is kept, since readers don't lock */
+    if (!CRYPTO_THREAD_write_lock(pkey->lock))
+        goto end;
+    if (pkey->pin_keymgmt == NULL) {
+        if (propquery != NULL && (propq = OPENSSL_strdup(propquery)) == NULL) {
+            ERR_raise(ERR_LIB_EVP, ERR_R_MALLOC_FAILURE);
+        } else {
+            pkey->pin_libctx = libctx;
+            pkey->pin_propquery = propq;
+            /* The pin takes over our reference */
+            ossl_rcu_assign_ptr((void **)&pkey->pin_keymgmt, keymgmt);
+            keymgmt = NULL;
+            ret = 1;
+        }
+    } else {
+        ret = 1;
+    }
+    CRYPTO_THREAD_unlock(pkey->lock);
+
+ end:
+    EVP_KEYMGMT_free(keymgmt);
+    return ret;
+}
+
 #ifndef FIPS_MODE
 int evp_pkey_downgrade(EVP_PKEY *pk)
 {
@@ -227,10 +227,15 @@ static EVP_PKEY_CTX *int_ctx_new(OPENSSL_CTX *libctx,
      * implementation.
      */
     if (e == NULL && keytype != NULL) {
-        /* This could fail so ignore errors */
-        ERR_set_mark();
-        keymgmt = EVP_KEYMGMT_fetch(libctx, keytype, propquery);
-        ERR_pop_to_mark();
+        /* A key pinned to a provider knows its keymgmt already */
+        if (pkey != NULL)
+            keymgmt = evp_pkey_pinned_keymgmt(pkey, libctx, propquery);
+        if (keymgmt == NULL) {
+            /* This could fail so ignore errors */
+            ERR_set_mark();
+            keymgmt = EVP_KEYMGMT_fetch(libctx, keytype, propquery);
+            ERR_pop_to_mark();
+        }
     }
 
     ret = OPENSSL_zalloc(sizeof(*ret));
@@ -0,0 +1,371 @@
+#! /usr/bin/env perl
+# Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+#
+# Licensed under the Apache License 2.0 (the "License").  You may not use
+# this file except in compliance with the License.  You can obtain a copy
+# in the file LICENSE in the source distribution or at
+# https://www.openssl.org/source/license.html
+
+#
+# AES-GCM with 512-bit VAES and VPCLMULQDQ.
+#
+# Processors with AVX-512 and the VAES and VPCLMULQDQ extensions, Ice
+# Lake and later, do four AES rounds or carry-less multiplications with
+# one instruction.  This module encrypts 16 counter blocks, four per
+# %zmm register, per iteration and hashes 16 blocks with one reduction,
+# using H^16..H^1 precomputed by gcm_init_avx512 in ghash-x86_64.pl.  When encrypting, the
+# ciphertext of one iteration is hashed during the next one, so that AES
+# and GHASH overlap in both directions.
+#
+# Only whole 256-byte chunks are processed, the caller takes care of
+# the rest with aesni_gcm_[en|de]crypt or CRYPTO_gcm128_[en|de]crypt_ctr32.
+#
+# Only %xmm0-5 and %xmm16-31 are used, and no stack, so that nothing
+# needs to be saved on Win64 either.
+
+# $output is the last argument if it looks like a file (it has an extension)
+# $flavour is the first argument if it doesn't look like a file
+$output = $#ARGV >= 0 && $ARGV[$#ARGV] =~ m|\.\w+$| ? pop : undef;
+$flavour = $#ARGV >= 0 && $ARGV[0] !~ m|\.| ? shift : undef;
+
+$win64=0; $win64=1 if ($flavour =~ /[nm]asm|mingw64/ || $output =~ /\.asm$/);
+
+$0 =~ m/(.*[\/\\])[^\/\\]+$/; $dir=$1;
+( $xlate="${dir}x86_64-xlate.pl" and -f $xlate ) or
+( $xlate="${dir}../../perlasm/x86_64-xlate.pl" and -f $xlate) or
+die "can't locate x86_64-xlate.pl";
+
+if (`$ENV{CC} -Wa,-v -c -o /dev/null -x assembler /dev/null 2>&1`
+		=~ /GNU assembler version ([2-9]\.[0-9]+)/) {
+	$vaes = ($1>=2.30);
+}
+
+if (!$vaes && $win64 && ($flavour =~ /nasm/ || $ENV{ASM} =~ /nasm/) &&
+	    `nasm -v 2>&1` =~ /NASM version ([2-9]\.[0-9]+)/) {
+	$vaes = ($1>=2.14);
+}
+
+if (!$vaes && `$ENV{CC} -v 2>&1` =~ /((?:^clang|LLVM) version|.*based on LLVM) ([0-9]+\.[0-9]+)/) {
+	$vaes = ($2>=7.0);
+}
+
+open OUT,"| \"$^X\" \"$xlate\" $flavour \"$output\""
+    or die "can't call $xlate: $!";
+*STDOUT=*OUT;
+
+if ($vaes) {{{
+
+# Reduces $hi:$lo into $lo, same as reduction_avx512 in ghash-x86_64.pl.
+sub reduction {
+my ($hi,$lo,$t1,$t2)=@_;
+return split /\n/,<<___;
+	vpsllq		\$57,$lo,$t1		# 1st phase
+	vpsllq		\$62,$lo,$t2
+	vpxor		$t1,$t2,$t2
+	vpsllq		\$63,$lo,$t1
+	vpxor		$t1,$t2,$t2
+	vpslldq		\$8,$t2,$t1
+	vpsrldq		\$8,$t2,$t2
+	vpxor		$t1,$lo,$lo
+	vpxor		$t2,$hi,$hi
+	vpsrlq		\$1,$lo,$t2		# 2nd phase
+	vpxor		$lo,$hi,$hi
+	vpxor		$t2,$lo,$lo
+	vpsrlq		\$5,$t2,$t2
+	vpxor		$t2,$lo,$lo
+	vpsrlq		\$1,$lo,$lo
+	vpxor		$hi,$lo,$lo
+___
+}
+
+######################################################################
+#
+# size_t aesni_gcm_[en|de]crypt_avx512(const void *inp, void *out,
+#		size_t len, const AES_KEY *key, unsigned char iv[16],
+#		u64 Xi[2], const u128 *Hpow);
+#
+# Returns the number of bytes processed, a multiple of 256.
+{
+my ($inp,$out,$len,$key,$ivp,$Xip)=$win64 ?
+	("%rcx","%rdx","%r8","%r9","%r10","%r11") :
+	("%rdi","%rsi","%rdx","%rcx","%r8","%r9");
+
+# %zmm0 holds Xi and, while hashing, the low halves of the products
+my ($Xi,$Zhi,$Zmid,$T1,$T2,$Klast)=map("%zmm$_",(0..5));
+my @B=map("%zmm$_",(16..19));		# counter blocks
+my @G=map("%zmm$_",(20..23));		# blocks to hash
+my @H=map("%zmm$_",(24..27));		# H^16..H^1, four per register
+my ($ctr,$inc,$bswap,$rndkey)=map("%zmm$_",(28..31));
+my ($xXi,$xT1)=("%xmm0","%xmm3");
+
+my $label=0;
+
+# Instructions that fold Xi into @G and hash @G into Xi, to be
+# interleaved with AES rounds.
+sub ghash_16x {
+my @insn=split /\n/,<<___;
+	vpxorq		$Xi,$G[0],$G[0]
+	vpclmulqdq	\$0x01,$H[0],$G[0],$Zmid
+	vpclmulqdq	\$0x10,$H[0],$G[0],$T1
+	vpclmulqdq	\$0x11,$H[0],$G[0],$Zhi
+	vpclmulqdq	\$0x00,$H[0],$G[0],$Xi
+	vpxorq		$T1,$Zmid,$Zmid
+___
+    for (my $i=1; $i<4; $i++) {
+	push @insn,split /\n/,<<___;
+	vpclmulqdq	\$0x00,$H[$i],$G[$i],$T1
+	vpclmulqdq	\$0x11,$H[$i],$G[$i],$T2
+	vpxorq		$T1,$Xi,$Xi
+	vpxorq		$T2,$Zhi,$Zhi
+	vpclmulqdq	\$0x01,$H[$i],$G[$i],$T1
+	vpclmulqdq	\$0x10,$H[$i],$G[$i],$T2
+	vpternlogq	\$0x96,$T2,$T1,$Zmid
+___
+    }
+    push @insn,split /\n/,<<___;
+	vpsrldq		\$8,$Zmid,$T1
+	vpslldq		\$8,$Zmid,$T2
+	vpxorq		$T1,$Zhi,$Zhi
+	vpxorq		$T2,$Xi,$Xi
+	vextracti64x4	\$1,$Xi,%ymm3
+	vextracti64x4	\$1,$Zhi,%ymm4
+	vpxor		%ymm3,%ymm0,%ymm0
+	vpxor		%ymm4,%ymm1,%ymm1
+	vextracti128	\$1,%ymm0,%xmm3
+	vextracti128	\$1,%ymm1,%xmm4
+	vpxor		%xmm3,%xmm0,%xmm0
+	vpxor		%xmm4,%xmm1,%xmm1
+___
+    push @insn,&reduction("%xmm1","%xmm0","%xmm3","%xmm4");
+    return @insn;
+}
+
+# Encrypts the next 16 counter blocks into @B, with the instructions
+# given spread over the rounds common to all key sizes.
+sub aes_16x {
+my @insn=@_;
+my $per=int((@insn+8)/9);
+my $last=".Laes_avx512_last".$label++;
+
+$code.=<<___;
+	vpaddd		$inc,$ctr,$B[1]
+	vpshufb		$bswap,$ctr,$B[0]
+	vpaddd		$inc,$B[1],$B[2]
+	vpshufb		$bswap,$B[1],$B[1]
+	vpaddd		$inc,$B[2],$B[3]
+	vpshufb		$bswap,$B[2],$B[2]
+	vpaddd		$inc,$B[3],$ctr
+	vpshufb		$bswap,$B[3],$B[3]
+	vbroadcasti32x4	0x00($key),$rndkey
+	vpxorq		$rndkey,$B[0],$B[0]
+	vpxorq		$rndkey,$B[1],$B[1]
+	vpxorq		$rndkey,$B[2],$B[2]
+	vpxorq		$rndkey,$B[3],$B[3]
+___
+    for (my $r=1; $r<14; $r++) {
+	$code.=<<___	if ($r==10);
+	cmpl		\$11,240($key)
+	jb		$last
+___
+	$code.=<<___	if ($r==12);
+	je		$last
+___
+	$code.=<<___;
+	vbroadcasti32x4	`16*$r`($key),$rndkey
+	vaesenc		$rndkey,$B[0],$B[0]
+	vaesenc		$rndkey,$B[1],$B[1]
+	vaesenc		$rndkey,$B[2],$B[2]
+	vaesenc		$rndkey,$B[3],$B[3]
+___
+	$code.=join("\n",splice(@insn,0,$per))."\n"	if ($r<10 && @insn);
+    }
+$code.=<<___;
+$last:
+	vaesenclast	$Klast,$B[0],$B[0]
+	vaesenclast	$Klast,$B[1],$B[1]
+	vaesenclast	$Klast,$B[2],$B[2]
+	vaesenclast	$Klast,$B[3],$B[3]
+___
+}
+
+# XORs @B with the input and writes it out, and if encrypting, puts the
+# ciphertext aside in @G for hashing.
+sub xor_store {
+my $enc=shift;
+
+    for (my $i=0; $i<4; $i++) {
+	$code.=<<___;
+	vpxorq		`64*$i`($inp),$B[$i],$B[$i]
+	vmovdqu64	$B[$i],`64*$i`($out)
+___
+	$code.=<<___	if ($enc);
+	vpshufb		$bswap,$B[$i],$G[$i]
+___
+    }
+$code.=<<___;
+	lea		0x100($inp),$inp
+	lea		0x100($out),$out
+	add		\$0x100,%rax
+	sub		\$0x100,$len
+___
+}
+
+sub setup {
+$code.=<<___	if ($win64);
+	mov		40(%rsp),$ivp
+	mov		48(%rsp),$Xip
+	mov		56(%rsp),%rax		# Hpow
+___
+$code.=<<___	if (!$win64);
+	mov		8(%rsp),%rax		# Hpow
+___
+$code.=<<___;
+	vmovdqu64	0x00(%rax),$H[0]
+	vmovdqu64	0x40(%rax),$H[1]
+	vmovdqu64	0x80(%rax),$H[2]
+	vmovdqu64	0xc0(%rax),$H[3]
+	mov		240($key),%eax
+	shl		\$4,%eax
+	vbroadcasti32x4	0x10($key,%rax),$Klast
+	xor		%eax,%eax
+
+	vbroadcasti32x4	.Lbswap_mask(%rip),$bswap
+	vbroadcasti32x4	.Lfour(%rip),$inc
+	vmovdqu		($ivp),$xT1
+	vmovdqu		($Xip),$xXi
+	vpshufb		%xmm30,$xT1,$xT1	# 32-bit counter in the low dword
+	vpshufb		%xmm30,$xXi,$xXi
+	vshufi64x2	\$0,$T1,$T1,$ctr
+	vpaddd		.Linc0123(%rip),$ctr,$ctr
+___
+}
+
+sub finish {
+$code.=<<___;
+	vpshufb		%xmm30,$xXi,$xT1
+	vmovdqu		$xT1,($Xip)
+	vpshufb		%xmm30,%xmm28,$xT1
+	vmovdqu		$xT1,($ivp)		# next counter value
+	vzeroupper
+___
+}
+
+$code.=<<___;
+.text
+
+.globl	aesni_gcm_encrypt_avx512
+.type	aesni_gcm_encrypt_avx512,\@abi-omnipotent
+.align	32
+aesni_gcm_encrypt_avx512:
+.cfi_startproc
+	endbranch
+	xor		%eax,%eax
+	cmp		\$0x100,$len
+	jb		.Lenc_avx512_abort
+___
+	&setup();
+	&aes_16x();				# first 16 blocks
+	&xor_store(1);
+$code.=<<___;
+	cmp		\$0x100,$len
+	jb		.Lenc_avx512_tail
+
+.align	32
+.Lenc_avx512_loop:
+___
+	&aes_16x(&ghash_16x());			# previous 16 blocks
+	&xor_store(1);
+$code.=<<___;
+	cmp		\$0x100,$len
+	jae		.Lenc_avx512_loop
+
+.Lenc_avx512_tail:
+___
+	$code.=join("\n",&ghash_16x())."\n";	# last 16 blocks
+	&finish();
+$code.=<<___;
+.Lenc_avx512_abort:
+	ret
+.cfi_endproc
+.size	aesni_gcm_encrypt_avx512,.-aesni_gcm_encrypt_avx512
+
+.globl	aesni_gcm_decrypt_avx512
+.type	aesni_gcm_decrypt_avx512,\@abi-omnipotent
+.align	32
+aesni_gcm_decrypt_avx512:
+.cfi_startproc
+	endbranch
+	xor		%eax,%eax
+	cmp		\$0x100,$len
+	jb		.Ldec_avx512_abort
+___
+	&setup();
+$code.=<<___;
+	jmp		.Ldec_avx512_loop
+
+.align	32
+.Ldec_avx512_loop:
+	vmovdqu64	0x00($inp),$G[0]
+	vmovdqu64	0x40($inp),$G[1]
+	vmovdqu64	0x80($inp),$G[2]
+	vmovdqu64	0xc0($inp),$G[3]
+	vpshufb		$bswap,$G[0],$G[0]
+	vpshufb		$bswap,$G[1],$G[1]
+	vpshufb		$bswap,$G[2],$G[2]
+	vpshufb		$bswap,$G[3],$G[3]
+___
+	&aes_16x(&ghash_16x());
+	&xor_store(0);
+$code.=<<___;
+	cmp		\$0x100,$len
+	jae		.Ldec_avx512_loop
+___
+	&finish();
+$code.=<<___;
+.Ldec_avx512_abort:
+	ret
+.cfi_endproc
+.size	aesni_gcm_decrypt_avx512,.-aesni_gcm_decrypt_avx512
+___
+}
+
+$code.=<<___;
+.align	64
+.Linc0123:
+	.long	0,0,0,0,1,0,0,0,2,0,0,0,3,0,0,0
+.Lfour:
+	.long	4,0,0,0
+.Lbswap_mask:
+	.byte	15,14,13,12,11,10,9,8,7,6,5,4,3,2,1,0
+.asciz	"AVX-512 VAES GCM module for x86_64"
+.align	64
+___
+}}} else {{{
+$code=<<___;	# assembler is too old
+.text
+
+.globl	aesni_gcm_encrypt_avx512
+.type	aesni_gcm_encrypt_avx512,\@abi-omnipotent
+aesni_gcm_encrypt_avx512:
+.cfi_startproc
+	xor	%eax,%eax
+	ret
+.cfi_endproc
+.size	aesni_gcm_encrypt_avx512,.-aesni_gcm_encrypt_avx512
+
+.globl	aesni_gcm_decrypt_avx512
+.type	aesni_gcm_decrypt_avx512,\@abi-omnipotent
+aesni_gcm_decrypt_avx512:
+.cfi_startproc
+	xor	%eax,%eax
+	ret
+.cfi_endproc
+.size	aesni_gcm_decrypt_avx512,.-aesni_gcm_decrypt_avx512
+___
+}}}
+
+$code =~ s/\`([^\`]*)\`/eval($1)/gem;
+
+print $code;
+
+close STDOUT or die "error closing STDOUT: $!";
@@ -121,6 +121,21 @@ if (!$avx && `$ENV{CC} -v 2>&1` =~ /((?:^clang|LLVM) version|.*based on LLVM) ([
 	$avx = ($2>=3.0) + ($2>3.0);
 }
 
+# VPCLMULQDQ on %zmm registers, as in aesni-gcm-avx512-x86_64.pl
+if (`$ENV{CC} -Wa,-v -c -o /dev/null -x assembler /dev/null 2>&1`
+		=~ /GNU assembler version ([2-9]\.[0-9]+)/) {
+	$vaes = ($1>=2.30);
+}
+
+if (!$vaes && $win64 && ($flavour =~ /nasm/ || $ENV{ASM} =~ /nasm/) &&
+	    `nasm -v 2>&1` =~ /NASM version ([2-9]\.[0-9]+)/) {
+	$vaes = ($1>=2.14);
+}
+
+if (!$vaes && `$ENV{CC} -v 2>&1` =~ /((?:^clang|LLVM) version|.*based on LLVM) ([0-9]+\.[0-9]+)/) {
+	$vaes = ($2>=7.0);
+}
+
 open OUT,"| \"$^X\" \"$xlate\" $flavour \"$output\""
     or die "can't call $xlate: $!";
 *STDOUT=*OUT;
@@ -1178,6 +1193,7 @@ gcm_gmult_avx:
 .size	gcm_gmult_avx,.-gcm_gmult_avx
 ___
 
+my $ghash_avx=length($code);
 $code.=<<___;
 .globl	gcm_ghash_avx
 .type	gcm_ghash_avx,\@abi-omnipotent
@@ -1600,14 +1616,302 @@ $code.=<<___;
 .cfi_endproc
 .size	gcm_ghash_avx,.-gcm_ghash_avx
 ___
+
+######################################################################
+#
+# int gcm_polyval_avx(u64 Xi[2], const u128 Htable[16], const u8 *inp,
+#		size_t len);
+#
+# POLYVAL from RFC 8452 takes GHASH blocks with their bytes in reverse
+# order, which is exactly what gcm_ghash_avx turns its input into, so
+# the same code without the input byte swaps hashes POLYVAL blocks.
+# Xi stays in GHASH order.  Returns 1, or 0 if the assembler was too old,
+# in which case the caller has to reverse the blocks itself.
+{
+my $polyval=substr($code,$ghash_avx);
+
+$polyval =~ s/^\s+vpshufb\s+$bswap,($Ii|$Ij),\1\n//gm;
+$polyval =~ s/\bvpshufb(\s+)$bswap,$Ii,$Ij/vmovdqa$1$Ii,$Ij/g;
+$polyval =~ s/gcm_ghash_avx/gcm_polyval_avx/g;
+$polyval =~ s/(\.L(?!SEH_)\w+)_avx\b/$1_polyval_avx/g;
+$polyval =~ s/^(\s+)ret$/$1mov\t\$1,%eax\n$1ret/m;
+$code.=$polyval;
+}
 } else {
 $code.=<<___;
 	jmp	.L_ghash_clmul
 .cfi_endproc
 .size	gcm_ghash_avx,.-gcm_ghash_avx
+
+.globl	gcm_polyval_avx
+.type	gcm_polyval_avx,\@abi-omnipotent
+gcm_polyval_avx:
+.cfi_startproc
+	xor	%eax,%eax
+	ret
+.cfi_endproc
+.size	gcm_polyval_avx,.-gcm_polyval_avx
 ___
 }
 
+if ($vaes) {{{
+# Multiplies $a by $b, both 128 bits, into $hi:$lo.
+sub clmul128_avx512 {
+my ($hi,$lo,$a,$b,$t1,$t2)=@_;
+$code.=<<___;
+	vpclmulqdq	\$0x11,$b,$a,$hi
+	vpclmulqdq	\$0x01,$b,$a,$t1
+	vpclmulqdq	\$0x10,$b,$a,$t2
+	vpclmulqdq	\$0x00,$b,$a,$lo
+	vpxor		$t2,$t1,$t1
+	vpslldq		\$8,$t1,$t2
+	vpsrldq		\$8,$t1,$t1
+	vpxor		$t2,$lo,$lo
+	vpxor		$t1,$hi,$hi
+___
+}
+
+# Reduces $hi:$lo into $lo, the same way as gcm_ghash_avx does.
+sub reduction_avx512 {
+my ($hi,$lo,$t1,$t2)=@_;
+$code.=<<___;
+	vpsllq		\$57,$lo,$t1		# 1st phase
+	vpsllq		\$62,$lo,$t2
+	vpxor		$t1,$t2,$t2
+	vpsllq		\$63,$lo,$t1
+	vpxor		$t1,$t2,$t2
+	vpslldq		\$8,$t2,$t1
+	vpsrldq		\$8,$t2,$t2
+	vpxor		$t1,$lo,$lo
+	vpxor		$t2,$hi,$hi
+	vpsrlq		\$1,$lo,$t2		# 2nd phase
+	vpxor		$lo,$hi,$hi
+	vpxor		$t2,$lo,$lo
+	vpsrlq		\$5,$t2,$t2
+	vpxor		$t2,$lo,$lo
+	vpsrlq		\$1,$lo,$lo
+	vpxor		$hi,$lo,$lo
+___
+}
+
+######################################################################
+#
+# int gcm_init_avx512(u128 Hpow[16], const u128 Htable[16]);
+#
+# Htable is as left by gcm_init_avx, i.e. starts with the "twisted" H.
+# Hpow gets H^16 first and H^1 last, which is the order in which the
+# powers are needed for 16 consecutive blocks.  Returns 1, or 0 if the
+# assembler was too old, in which case the AVX code has to do.
+{
+my ($Hpow,$Htbl)=@_4args;
+
+$code.=<<___;
+.globl	gcm_init_avx512
+.type	gcm_init_avx512,\@abi-omnipotent
+.align	32
+gcm_init_avx512:
+.cfi_startproc
+	endbranch
+	vmovdqu		($Htbl),%xmm1
+	vmovdqa		%xmm1,%xmm0
+	lea		0xf0($Hpow),$Hpow
+	mov		\$15,%eax
+	vmovdqu		%xmm0,($Hpow)		# H^1
+	jmp		.Linit_avx512_loop
+
+.align	32
+.Linit_avx512_loop:
+___
+	&clmul128_avx512("%xmm2","%xmm0","%xmm0","%xmm1","%xmm3","%xmm4");
+	&reduction_avx512("%xmm2","%xmm0","%xmm3","%xmm4");
+$code.=<<___;
+	lea		-0x10($Hpow),$Hpow
+	vmovdqu		%xmm0,($Hpow)		# H^2..16
+	dec		%eax
+	jnz		.Linit_avx512_loop
+
+	mov		\$1,%eax
+	vzeroupper
+	ret
+.cfi_endproc
+.size	gcm_init_avx512,.-gcm_init_avx512
+___
+}
+
+######################################################################
+#
+# void gcm_ghash_avx512(u64 Xi[2], const u128 *Hpow, const u8 *inp,
+#		size_t len);
+#
+# Hashes 16 blocks, four per %zmm register, with one reduction per
+# iteration.  The remaining blocks are multiplied by H^n..H^1 and also
+# reduced just once.  Only %xmm0-5 and %xmm16-31 are used, and no stack,
+# so that nothing needs to be saved on Win64.
+{
+my ($Xip,$Hpow,$inp,$len)=@_4args;
+my ($Xi,$Zhi,$Zmid,$T1,$T2)=map("%zmm$_",(0..4));
+my @G=map("%zmm$_",(20..23));		# blocks to hash
+my @H=map("%zmm$_",(24..27));		# H^16..H^1, four per register
+my $bswap="%zmm30";
+my $ghash_avx512=length($code);
+
+$code.=<<___;
+.globl	gcm_ghash_avx512
+.type	gcm_ghash_avx512,\@abi-omnipotent
+.align	32
+gcm_ghash_avx512:
+.cfi_startproc
+	endbranch
+	vbroadcasti32x4	.Lbswap_mask(%rip),$bswap
+	vmovdqu		($Xip),%xmm0
+	vpshufb		%xmm30,%xmm0,%xmm0
+	cmp		\$0x100,$len
+	jb		.Lghash_avx512_tail
+
+	vmovdqu64	0x00($Hpow),$H[0]
+	vmovdqu64	0x40($Hpow),$H[1]
+	vmovdqu64	0x80($Hpow),$H[2]
+	vmovdqu64	0xc0($Hpow),$H[3]
+	jmp		.Lghash_avx512_loop
+
+.align	32
+.Lghash_avx512_loop:
+___
+    for (my $i=0; $i<4; $i++) {
+	$code.=<<___;
+	vmovdqu64	`64*$i`($inp),$G[$i]
+	vpshufb		$bswap,$G[$i],$G[$i]
+___
+    }
+$code.=<<___;
+	vpxorq		$Xi,$G[0],$G[0]
+	vpclmulqdq	\$0x01,$H[0],$G[0],$Zmid
+	vpclmulqdq	\$0x10,$H[0],$G[0],$T1
+	vpclmulqdq	\$0x11,$H[0],$G[0],$Zhi
+	vpclmulqdq	\$0x00,$H[0],$G[0],$Xi
+	vpxorq		$T1,$Zmid,$Zmid
+___
+    for (my $i=1; $i<4; $i++) {
+	$code.=<<___;
+	vpclmulqdq	\$0x00,$H[$i],$G[$i],$T1
+	vpclmulqdq	\$0x11,$H[$i],$G[$i],$T2
+	vpxorq		$T1,$Xi,$Xi
+	vpxorq		$T2,$Zhi,$Zhi
+	vpclmulqdq	\$0x01,$H[$i],$G[$i],$T1
+	vpclmulqdq	\$0x10,$H[$i],$G[$i],$T2
+	vpternlogq	\$0x96,$T2,$T1,$Zmid
+___
+    }
+$code.=<<___;
+	vpsrldq		\$8,$Zmid,$T1
+	vpslldq		\$8,$Zmid,$T2
+	vpxorq		$T1,$Zhi,$Zhi
+	vpxorq		$T2,$Xi,$Xi
+	vextracti64x4	\$1,$Xi,%ymm3
+	vextracti64x4	\$1,$Zhi,%ymm4
+	vpxor		%ymm3,%ymm0,%ymm0
+	vpxor		%ymm4,%ymm1,%ymm1
+	vextracti128	\$1,%ymm0,%xmm3
+	vextracti128	\$1,%ymm1,%xmm4
+	vpxor		%xmm3,%xmm0,%xmm0
+	vpxor		%xmm4,%xmm1,%xmm1
+___
+	&reduction_avx512("%xmm1","%xmm0","%xmm3","%xmm4");
+$code.=<<___;
+	lea		0x100($inp),$inp
+	sub		\$0x100,$len
+	cmp		\$0x100,$len
+	jae		.Lghash_avx512_loop
+
+.Lghash_avx512_tail:
+	test		$len,$len
+	jz		.Lghash_avx512_done
+	lea		0x100($Hpow),%r10
+	sub		$len,%r10		# H^n for n blocks left
+	vmovdqu		($inp),%xmm3
+	vpshufb		%xmm30,%xmm3,%xmm3
+	vpxor		%xmm0,%xmm3,%xmm3
+	vpxor		%xmm0,%xmm0,%xmm0
+	vpxor		%xmm1,%xmm1,%xmm1
+	vpxor		%xmm2,%xmm2,%xmm2
+	jmp		.Lghash_avx512_tail_mul
+
+.align	32
+.Lghash_avx512_tail_loop:
+	vmovdqu		($inp),%xmm3
+	vpshufb		%xmm30,%xmm3,%xmm3
+.Lghash_avx512_tail_mul:
+	vmovdqu		(%r10),%xmm4
+	vpclmulqdq	\$0x00,%xmm4,%xmm3,%xmm5
+	vpxor		%xmm5,%xmm0,%xmm0
+	vpclmulqdq	\$0x11,%xmm4,%xmm3,%xmm5
+	vpxor		%xmm5,%xmm1,%xmm1
+	vpclmulqdq	\$0x01,%xmm4,%xmm3,%xmm5
+	vpxor		%xmm5,%xmm2,%xmm2
+	vpclmulqdq	\$0x10,%xmm4,%xmm3,%xmm5
+	vpxor		%xmm5,%xmm2,%xmm2
+	lea		0x10($inp),$inp
+	lea		0x10(%r10),%r10
+	sub		\$0x10,$len
+	jnz		.Lghash_avx512_tail_loop
+
+	vpslldq		\$8,%xmm2,%xmm3
+	vpsrldq		\$8,%xmm2,%xmm2
+	vpxor		%xmm3,%xmm0,%xmm0
+	vpxor		%xmm2,%xmm1,%xmm1
+___
+	&reduction_avx512("%xmm1","%xmm0","%xmm3","%xmm4");
+$code.=<<___;
+
+.Lghash_avx512_done:
+	vpshufb		%xmm30,%xmm0,%xmm0
+	vmovdqu		%xmm0,($Xip)
+	vzeroupper
+	ret
+.cfi_endproc
+.size	gcm_ghash_avx512,.-gcm_ghash_avx512
+___
+
+# void gcm_polyval_avx512(u64 Xi[2], const u128 *Hpow, const u8 *inp,
+#		size_t len);
+#
+# The same without the input byte swaps, see gcm_polyval_avx.
+my $polyval=substr($code,$ghash_avx512);
+
+$polyval =~ s/^\s+vpshufb\s+$bswap,(%zmm2[0-3]),\1\n//gm;
+$polyval =~ s/^\s+vpshufb\s+%xmm30,%xmm3,%xmm3\n//gm;
+$polyval =~ s/ghash_avx512/polyval_avx512/g;
+$code.=$polyval;
+}
+}}} else {{{
+$code.=<<___;	# assembler is too old
+.globl	gcm_init_avx512
+.type	gcm_init_avx512,\@abi-omnipotent
+gcm_init_avx512:
+.cfi_startproc
+	xor	%eax,%eax
+	ret
+.cfi_endproc
+.size	gcm_init_avx512,.-gcm_init_avx512
+
+.globl	gcm_ghash_avx512
+.type	gcm_ghash_avx512,\@abi-omnipotent
+gcm_ghash_avx512:
+.cfi_startproc
+	ret			# never called, gcm_init_avx512 failed
+.cfi_endproc
+.size	gcm_ghash_avx512,.-gcm_ghash_avx512
+
+.globl	gcm_polyval_avx512
+.type	gcm_polyval_avx512,\@abi-omnipotent
+gcm_polyval_avx512:
+.cfi_startproc
+	ret			# never called, gcm_init_avx512 failed
+.cfi_endproc
+.size	gcm_polyval_avx512,.-gcm_polyval_avx512
+___
+}}}
+
 $code.=<<___;
 .align	64
 .Lbswap_mask:
@@ -1787,6 +2091,10 @@ $code.=<<___	if ($avx);
 	.rva	.LSEH_begin_gcm_ghash_avx
 	.rva	.LSEH_end_gcm_ghash_avx
 	.rva	.LSEH_info_gcm_ghash_clmul
+
+	.rva	.LSEH_begin_gcm_polyval_avx
+	.rva	.LSEH_end_gcm_polyval_avx
+	.rva	.LSEH_info_gcm_ghash_clmul
 ___
 $code.=<<___;
 .section	.xdata
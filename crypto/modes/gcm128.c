@@ -1,5 +1,5 @@
 /*
- * Copyright 2010-2018 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2010-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -11,6 +11,7 @@
 #include <openssl/crypto.h>
 #include "internal/cryptlib.h"
 #include "crypto/modes.h"
+#include "crypto/aes_platform.h"
 
 #if defined(BSWAP4) && defined(STRICT_ALIGNMENT)
 /* redefine, because alignment is ensured */
@@ -651,6 +652,31 @@ void gcm_init_avx(u128 Htable[16], const u64 Xi[2]);
 void gcm_gmult_avx(u64 Xi[2], const u128 Htable[16]);
 void gcm_ghash_avx(u64 Xi[2], const u128 Htable[16], const u8 *inp,
                    size_t len);
+int gcm_init_avx512(u128 Hpow[16], const u128 Htable[16]);
+void gcm_ghash_avx512(u64 Xi[2], const u128 *Hpow, const u8 *inp,
+                      size_t len);
+void ossl_gcm_ghash_avx512(u64 Xi[2], const u128 Htable[16], const u8 *inp,
+                           size_t len);
+
+/* POLYVAL on the same tables, see ossl_polyval_update() */
+#   define POLYVAL_ASM_AVX
+int gcm_polyval_avx(u64 Xi[2], const u128 Htable[16], const u8 *inp,
+                    size_t len);
+void gcm_polyval_avx512(u64 Xi[2], const u128 *Hpow, const u8 *inp,
+                        size_t len);
+
+/*
+ * The GHASH method is handed Htable, but the AVX-512 code needs the powers
+ * of H, which are at the end of the same context.
+ */
+void ossl_gcm_ghash_avx512(u64 Xi[2], const u128 Htable[16], const u8 *inp,
+                           size_t len)
+{
+    const GCM128_CONTEXT *ctx = (const GCM128_CONTEXT *)
+        ((const char *)Htable - offsetof(GCM128_CONTEXT, Htable));
+
+    gcm_ghash_avx512(Xi, ctx->Hpow, inp, len);
+}
 #  endif
 
 #  if   defined(__i386) || defined(__i386__) || defined(_M_IX86)
@@ -710,6 +736,8 @@ void gcm_ghash_p8(u64 Xi[2], const u128 Htable[16], const u8 *inp,
 # endif
 #endif
 
+static void gcm_init_htable(GCM128_CONTEXT *ctx);
+
 void CRYPTO_gcm128_init(GCM128_CONTEXT *ctx, void *key, block128_f block)
 {
     const union {
@@ -737,6 +765,12 @@ void CRYPTO_gcm128_init(GCM128_CONTEXT *ctx, void *key, block128_f block)
         ctx->H.u[1] = lo;
 #endif
     }
+    gcm_init_htable(ctx);
+}
+
+/* Sets up the multiplication by |ctx->H|, which is in host byte order */
+static void gcm_init_htable(GCM128_CONTEXT *ctx)
+{
 #if     TABLE_BITS==8
     gcm_init_8bit(ctx->Htable, ctx->H.u);
 #elif   TABLE_BITS==4
@@ -752,6 +786,10 @@ void CRYPTO_gcm128_init(GCM128_CONTEXT *ctx, void *key, block128_f block)
             gcm_init_avx(ctx->Htable, ctx->H.u);
             ctx->gmult = gcm_gmult_avx;
             CTX__GHASH(gcm_ghash_avx);
+#   ifdef AVX512_VAES_CAPABLE
+            if (AVX512_VAES_CAPABLE && gcm_init_avx512(ctx->Hpow, ctx->Htable))
+                CTX__GHASH(ossl_gcm_ghash_avx512);
+#   endif
         } else {
             gcm_init_clmul(ctx->Htable, ctx->H.u);
             ctx->gmult = gcm_gmult_clmul;
@@ -1886,3 +1924,101 @@ void CRYPTO_gcm128_release(GCM128_CONTEXT *ctx)
 {
     OPENSSL_clear_free(ctx, sizeof(*ctx));
 }
+
+/*
+ * POLYVAL from RFC 8452, for AES-GCM-SIV.  It's GHASH with the bytes of
+ * every block in reverse order and the key multiplied by x (see appendix A
+ * of the RFC), so it can use the GHASH code above, CLMUL or PMULL included.
+ */
+void ossl_polyval_init(GCM128_CONTEXT *ctx, const unsigned char key[16])
+{
+    u64 hi = 0, lo = 0;
+    int i;
+
+    memset(ctx, 0, sizeof(*ctx));
+
+    /* ByteReverse(key) as a big endian number */
+    for (i = 7; i >= 0; i--) {
+        hi = hi << 8 | key[8 + i];
+        lo = lo << 8 | key[i];
+    }
+    /* mulX_GHASH() */
+    ctx->H.u[0] = (hi >> 1) ^ (U64(0xe100000000000000) & (0 - (lo & 1)));
+    ctx->H.u[1] = (hi << 63) | (lo >> 1);
+    gcm_init_htable(ctx);
+}
+
+#define POLYVAL_CHUNK   512
+
+/* Absorbs |len| bytes, which must be a multiple of 16 */
+void ossl_polyval_update(GCM128_CONTEXT *ctx, const unsigned char *in,
+                         size_t len)
+{
+    u64 buf[POLYVAL_CHUNK / sizeof(u64)];
+    size_t i, n;
+#ifdef GCM_FUNCREF_4BIT
+# ifdef GHASH
+    void (*gcm_ghash_p) (u64 Xi[2], const u128 Htable[16],
+                         const u8 *inp, size_t len) = ctx->ghash;
+# else
+    void (*gcm_gmult_p) (u64 Xi[2], const u128 Htable[16]) = ctx->gmult;
+# endif
+#endif
+
+#ifdef POLYVAL_ASM_AVX
+    /*
+     * The AVX code byte-swaps GHASH blocks on load anyway, so it has
+     * variants that take POLYVAL blocks as they are.
+     */
+    if (len == 0)
+        return;
+# ifdef AVX512_VAES_CAPABLE
+    if (ctx->ghash == ossl_gcm_ghash_avx512) {
+        gcm_polyval_avx512(ctx->Xi.u, ctx->Hpow, in, len);
+        return;
+    }
+# endif
+    if (ctx->gmult == gcm_gmult_avx
+        && gcm_polyval_avx(ctx->Xi.u, ctx->Htable, in, len))
+        return;
+#endif
+
+    while (len > 0) {
+        n = len < POLYVAL_CHUNK ? len : POLYVAL_CHUNK;
+        for (i = 0; i < n / 8; i += 2, in += 16) {
+#ifdef BSWAP8
+            u64 w[2];
+
+            memcpy(w, in, 16);
+            buf[i] = BSWAP8(w[1]);
+            buf[i + 1] = BSWAP8(w[0]);
+#else
+            size_t j;
+
+            for (j = 0; j < 16; j++)
+                ((u8 *)&buf[i])[j] = in[15 - j];
+#endif
+        }
+#ifdef GHASH
+        GHASH(ctx, (const u8 *)buf, n);
+#else
+        for (i = 0; i < n / 8; i += 2) {
+            size_t j;
+
+            for (j = 0; j < 16; j++)
+                ctx->Xi.c[j] ^= ((const u8 *)&buf[i])[j];
+            GCM_MUL(ctx);
+        }
+#endif
+        len -= n;
+    }
+    OPENSSL_cleanse(buf, sizeof(buf));
+}
+
+void ossl_polyval_final(GCM128_CONTEXT *ctx, unsigned char out[16])
+{
+    int i;
+
+    for (i = 0; i < 16; i++)
+        out[i] = ctx->Xi.c[15 - i];
+}
@@ -0,0 +1,373 @@
+/*
+ * WARNING: do not edit!
+ * Generated by crypto/namemap_builtin.pl
+ *
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#define NAMEMAP_BUILTIN_NUM      288
+#define NAMEMAP_BUILTIN_SLOTS    512
+#define NAMEMAP_BUILTIN_BUCKETS  128
+
+static const char *const namemap_builtin_names[NAMEMAP_BUILTIN_NUM] = {
+    "AES-128-CBC",
+    "AES-128-CBC-HMAC-SHA1",
+    "AES-128-CBC-HMAC-SHA256",
+    "AES-128-CCM",
+    "AES-128-CFB",
+    "AES-128-CFB1",
+    "AES-128-CFB8",
+    "AES-128-CTR",
+    "AES-128-ECB",
+    "AES-128-GCM",
+    "AES-128-GCM-SIV",
+    "AES-128-OCB",
+    "AES-128-OFB",
+    "AES-128-SIV",
+    "AES-128-WRAP",
+    "AES-128-WRAP-PAD",
+    "AES-128-XTS",
+    "AES-192-CBC",
+    "AES-192-CCM",
+    "AES-192-CFB",
+    "AES-192-CFB1",
+    "AES-192-CFB8",
+    "AES-192-CTR",
+    "AES-192-ECB",
+    "AES-192-GCM",
+    "AES-192-OCB",
+    "AES-192-OFB",
+    "AES-192-SIV",
+    "AES-192-WRAP",
+    "AES-192-WRAP-PAD",
+    "AES-256-CBC",
+    "AES-256-CBC-HMAC-SHA1",
+    "AES-256-CBC-HMAC-SHA256",
+    "AES-256-CCM",
+    "AES-256-CFB",
+    "AES-256-CFB1",
+    "AES-256-CFB8",
+    "AES-256-CTR",
+    "AES-256-ECB",
+    "AES-256-GCM",
+    "AES-256-GCM-SIV",
+    "AES-256-OCB",
+    "AES-256-OFB",
+    "AES-256-SIV",
+    "AES-256-WRAP",
+    "AES-256-WRAP-PAD",
+    "AES-256-XTS",
+    "AES128-WRAP",
+    "AES128-WRAP-PAD",
+    "AES192-WRAP",
+    "AES192-WRAP-PAD",
+    "AES256-WRAP",
+    "AES256-WRAP-PAD",
+    "ARIA-128-CBC",
+    "ARIA-128-CCM",
+    "ARIA-128-CFB",
+    "ARIA-128-CFB1",
+    "ARIA-128-CFB8",
+    "ARIA-128-CTR",
+    "ARIA-128-ECB",
+    "ARIA-128-GCM",
+    "ARIA-128-OFB",
+    "ARIA-192-CBC",
+    "ARIA-192-CCM",
+    "ARIA-192-CFB",
+    "ARIA-192-CFB1",
+    "ARIA-192-CFB8",
+    "ARIA-192-CTR",
+    "ARIA-192-ECB",
+    "ARIA-192-GCM",
+    "ARIA-192-OFB",
+    "ARIA-256-CBC",
+    "ARIA-256-CCM",
+    "ARIA-256-CFB",
+    "ARIA-256-CFB1",
+    "ARIA-256-CFB8",
+    "ARIA-256-CTR",
+    "ARIA-256-ECB",
+    "ARIA-256-GCM",
+    "ARIA-256-OFB",
+    "ARIA128",
+    "ARIA192",
+    "ARIA256",
+    "BF",
+    "BF-CBC",
+    "BF-CFB",
+    "BF-ECB",
+    "BF-OFB",
+    "BLAKE2B-512",
+    "BLAKE2b512",
+    "BLAKE2BMAC",
+    "BLAKE2S-256",
+    "BLAKE2s256",
+    "BLAKE2SMAC",
+    "BLAKE3",
+    "BLAKE3KDF",
+    "BLAKE3MAC",
+    "BLOWFISH",
+    "CAMELLIA-128-CBC",
+    "CAMELLIA-128-CFB",
+    "CAMELLIA-128-CFB1",
+    "CAMELLIA-128-CFB8",
+    "CAMELLIA-128-CTR",
+    "CAMELLIA-128-ECB",
+    "CAMELLIA-128-OFB",
+    "CAMELLIA-192-CBC",
+    "CAMELLIA-192-CFB",
+    "CAMELLIA-192-CFB1",
+    "CAMELLIA-192-CFB8",
+    "CAMELLIA-192-CTR",
+    "CAMELLIA-192-ECB",
+    "CAMELLIA-192-OFB",
+    "CAMELLIA-256-CBC",
+    "CAMELLIA-256-CFB",
+    "CAMELLIA-256-CFB1",
+    "CAMELLIA-256-CFB8",
+    "CAMELLIA-256-CTR",
+    "CAMELLIA-256-ECB",
+    "CAMELLIA-256-OFB",
+    "CAMELLIA128",
+    "CAMELLIA192",
+    "CAMELLIA256",
+    "CAST",
+    "CAST-CBC",
+    "CAST5-CBC",
+    "CAST5-CFB",
+    "CAST5-ECB",
+    "CAST5-OFB",
+    "ChaCha20",
+    "ChaCha20-Poly1305",
+    "CMAC",
+    "DES",
+    "DES-CBC",
+    "DES-CFB",
+    "DES-CFB1",
+    "DES-CFB8",
+    "DES-ECB",
+    "DES-EDE",
+    "DES-EDE-CBC",
+    "DES-EDE-CFB",
+    "DES-EDE-ECB",
+    "DES-EDE-OFB",
+    "DES-EDE3",
+    "DES-EDE3-CBC",
+    "DES-EDE3-CFB",
+    "DES-EDE3-CFB1",
+    "DES-EDE3-CFB8",
+    "DES-EDE3-ECB",
+    "DES-EDE3-OFB",
+    "DES-OFB",
+    "DES3",
+    "DES3-WRAP",
+    "DESX",
+    "DESX-CBC",
+    "DH",
+    "dhKeyAgreement",
+    "DSA",
+    "dsaEncryption",
+    "EC",
+    "ECDH",
+    "ECDSA",
+    "ED25519",
+    "ED448",
+    "GMAC",
+    "HKDF",
+    "HMAC",
+    "id-aes128-CCM",
+    "id-aes128-GCM",
+    "id-aes128-wrap",
+    "id-aes128-wrap-pad",
+    "id-aes192-CCM",
+    "id-aes192-GCM",
+    "id-aes192-wrap",
+    "id-aes192-wrap-pad",
+    "id-aes256-CCM",
+    "id-aes256-GCM",
+    "id-aes256-wrap",
+    "id-aes256-wrap-pad",
+    "id-ecPublicKey",
+    "id-scrypt",
+    "id-smime-alg-CMS3DESwrap",
+    "IDEA",
+    "IDEA-CBC",
+    "IDEA-CFB",
+    "IDEA-CFB64",
+    "IDEA-ECB",
+    "IDEA-OFB",
+    "IDEA-OFB64",
+    "KangarooTwelve",
+    "KBKDF",
+    "KECCAK-KMAC-128",
+    "KECCAK-KMAC-256",
+    "KECCAK-KMAC128",
+    "KECCAK-KMAC256",
+    "KMAC-128",
+    "KMAC-256",
+    "KMAC128",
+    "KMAC256",
+    "KRB5KDF",
+    "KT128",
+    "KT256",
+    "MD2",
+    "MD4",
+    "MD5",
+    "MD5-SHA1",
+    "MDC2",
+    "NULL",
+    "PARALLELHASH-128",
+    "PARALLELHASH-256",
+    "PARALLELHASH128",
+    "PARALLELHASH256",
+    "PBKDF2",
+    "POLY1305",
+    "RC2-40-CBC",
+    "RC2-64-CBC",
+    "RC2-CBC",
+    "RC2-CFB",
+    "RC2-ECB",
+    "RC2-OFB",
+    "RC4",
+    "RC4-40",
+    "RC4-HMAC-MD5",
+    "RC5-CBC",
+    "RC5-CFB",
+    "RC5-ECB",
+    "RC5-OFB",
+    "RIPEMD",
+    "RIPEMD-160",
+    "RIPEMD160",
+    "RMD160",
+    "RSA",
+    "rsaEncryption",
+    "SCRYPT",
+    "SEED",
+    "SEED-CBC",
+    "SEED-CFB",
+    "SEED-CFB128",
+    "SEED-ECB",
+    "SEED-OFB",
+    "SEED-OFB128",
+    "SHA-1",
+    "SHA-224",
+    "SHA-256",
+    "SHA-384",
+    "SHA-512",
+    "SHA-512/224",
+    "SHA-512/256",
+    "SHA1",
+    "SHA2-224",
+    "SHA2-256",
+    "SHA2-384",
+    "SHA2-512",
+    "SHA2-512/224",
+    "SHA2-512/256",
+    "SHA224",
+    "SHA256",
+    "SHA3-224",
+    "SHA3-256",
+    "SHA3-384",
+    "SHA3-512",
+    "SHA384",
+    "SHA512",
+    "SHA512-224",
+    "SHA512-256",
+    "SHAKE-128",
+    "SHAKE-256",
+    "SHAKE128",
+    "SHAKE256",
+    "SIPHASH",
+    "SM3",
+    "SM4",
+    "SM4-CBC",
+    "SM4-CCM",
+    "SM4-CFB",
+    "SM4-CFB128",
+    "SM4-CTR",
+    "SM4-ECB",
+    "SM4-GCM",
+    "SM4-OFB",
+    "SM4-OFB128",
+    "SSHKDF",
+    "SSKDF",
+    "TLS1-PRF",
+    "WHIRLPOOL",
+    "X25519",
+    "X448",
+    "X942KDF",
+    "X963KDF",
+};
+
+/* Seeds for the second hash, per bucket of the first */
+static const uint32_t namemap_builtin_seeds[NAMEMAP_BUILTIN_BUCKETS] = {
+    3, 7, 4, 1, 2, 2, 3, 2,
+    5, 3, 2, 1, 1, 1, 5, 1,
+    3, 1, 1, 2, 2, 2, 1, 1,
+    1, 0, 2, 2, 4, 3, 2, 1,
+    5, 2, 3, 1, 1, 13, 1, 1,
+    1, 3, 1, 3, 2, 1, 2, 2,
+    1, 4, 1, 2, 1, 6, 1, 2,
+    1, 1, 1, 2, 2, 1, 1, 0,
+    2, 1, 1, 1, 0, 1, 1, 2,
+    1, 0, 6, 3, 1, 0, 1, 2,
+    0, 1, 6, 0, 3, 5, 1, 5,
+    2, 1, 1, 12, 2, 0, 2, 1,
+    1, 2, 6, 1, 7, 1, 5, 1,
+    1, 1, 4, 1, 0, 1, 1, 4,
+    4, 4, 4, 4, 18, 3, 3, 3,
+    5, 1, 7, 1, 2, 1, 2, 0,
+};
+
+/* Index in namemap_builtin_names[] per slot, -1 if the slot is unused */
+static const short namemap_builtin_slots[NAMEMAP_BUILTIN_SLOTS] = {
+    -1, -1, -1, 112, 258, 219, 51, 152, -1, 124, -1, 214,
+    242, -1, 69, 21, -1, 206, -1, -1, -1, -1, 2, -1,
+    -1, 224, 80, -1, 13, 115, -1, 117, 40, -1, 15, -1,
+    -1, -1, 116, 227, 215, 143, 236, 231, 285, 156, 17, -1,
+    269, 14, 221, 250, 243, 28, 94, -1, 217, 37, 193, -1,
+    88, -1, -1, 84, 104, -1, -1, -1, 131, -1, -1, -1,
+    107, 56, -1, -1, -1, -1, 50, 95, -1, 93, -1, 184,
+    -1, 263, -1, 150, -1, 170, 79, 241, 175, 185, 35, -1,
+    -1, -1, -1, -1, 278, 248, 237, 188, 74, -1, -1, -1,
+    109, -1, -1, 49, 86, -1, 128, 207, 64, -1, 138, -1,
+    249, 72, -1, -1, 182, -1, 11, 260, -1, 174, 247, -1,
+    76, -1, 264, 165, -1, -1, 99, 44, 87, 194, 139, 42,
+    145, 38, -1, -1, 230, -1, -1, -1, 222, -1, 34, 225,
+    -1, -1, 25, 65, 123, 209, -1, -1, -1, -1, 146, 55,
+    201, -1, 277, 202, -1, 255, 223, -1, 257, -1, 16, 98,
+    -1, 235, 244, 47, 89, 61, 144, 134, -1, 197, -1, -1,
+    -1, 266, -1, 91, -1, 8, 226, 218, 130, 73, -1, -1,
+    31, -1, -1, -1, -1, 149, 140, -1, -1, 27, 270, 265,
+    -1, -1, -1, -1, 205, 245, 0, 71, -1, 190, -1, 6,
+    186, -1, 129, 179, -1, -1, -1, -1, -1, 196, -1, 52,
+    172, -1, 9, 208, -1, -1, -1, -1, 114, -1, -1, 46,
+    -1, -1, 284, 12, 103, 20, 159, -1, 142, 252, 106, -1,
+    39, -1, -1, 96, 59, 276, 41, 253, -1, -1, 45, -1,
+    191, 48, 283, -1, 273, 232, 18, 211, -1, -1, 85, 26,
+    -1, -1, -1, 125, -1, -1, 24, 169, 58, 254, -1, 147,
+    210, -1, 246, 82, 158, 251, 213, -1, 10, -1, -1, -1,
+    238, -1, 233, 81, -1, -1, 155, -1, -1, -1, -1, 108,
+    -1, -1, -1, 271, 164, -1, -1, 3, 113, 180, 154, 203,
+    -1, 78, -1, 90, 240, -1, 102, -1, -1, 36, 279, 177,
+    -1, -1, 148, 23, -1, 57, 63, -1, -1, -1, 1, 153,
+    -1, -1, 220, 173, 189, 200, 92, -1, -1, 53, -1, 267,
+    160, 97, -1, 132, -1, 171, 162, -1, 32, -1, 110, -1,
+    -1, -1, -1, -1, 7, 133, 163, 68, -1, -1, -1, 4,
+    135, -1, 212, 256, 118, 62, 111, -1, 157, 286, 121, 119,
+    228, -1, -1, 122, 167, 29, 192, -1, -1, -1, -1, 262,
+    66, 280, -1, 67, -1, -1, 127, 19, 30, 60, 275, 176,
+    22, 281, 75, 198, 33, -1, 272, 268, -1, 54, -1, 105,
+    -1, 137, -1, -1, -1, 126, 259, -1, -1, 77, 274, -1,
+    120, 161, 261, -1, 101, -1, 5, -1, -1, -1, -1, -1,
+    181, 43, 239, -1, 229, 234, 204, -1, 83, -1, -1, -1,
+    -1, -1, 216, -1, -1, 282, -1, -1, 70, 141, -1, 136,
+    -1, 187, 178, 168, 166, 199, 287, -1, 183, -1, -1, 100,
+    195, -1, -1, -1, -1, 151, -1, -1,
+};
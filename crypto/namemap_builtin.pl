@@ -0,0 +1,79 @@
+#! /usr/bin/env perl
+# Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+#
+# Licensed under the Apache License 2.0 (the "License").  You may not use
+# this file except in compliance with the License.  You can obtain a copy
+# in the file LICENSE in the source distribution or at
+# https://www.openssl.org/source/license.html
+
+# Generates a perfect hash table of the algorithm names that the built-in
+# providers know of, for crypto/core_namemap.c.  The provider sources are
+# given on the command line, and the result goes to stdout.
+#
+# Names are case insensitive, so they're hashed in lower case.  See
+# OpenSSL::PerfectHash for the hash and how the table is built.
+
+use strict;
+use warnings;
+
+use FindBin;
+use lib "$FindBin::Bin/../util/perl";
+use OpenSSL::PerfectHash qw(perfect_hash format_numbers);
+
+my %names;
+
+foreach my $file (@ARGV) {
+    open my $fh, '<', $file or die "Can't open $file: $!\n";
+    my $src = do { local $/; <$fh> };
+    close $fh;
+
+    # { "NAME:ALIAS", "provider=..." } and ALG("NAME:ALIAS", ...)
+    while ($src =~ m/(?:\{\s*"([^"]+)"\s*,\s*"provider=|ALGC?\(\s*"([^"]+)")/g) {
+        foreach (split /:/, $1 // $2) {
+            $names{lc $_} //= $_;
+        }
+    }
+}
+
+my @names = map { $names{$_} } sort keys %names;
+my $n = scalar @names;
+die "No names found\n" if $n == 0;
+
+my $table = perfect_hash(map { lc } @names);
+
+my $year = (localtime)[5] + 1900;
+print <<"EOF";
+/*
+ * WARNING: do not edit!
+ * Generated by crypto/namemap_builtin.pl
+ *
+ * Copyright $year The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#define NAMEMAP_BUILTIN_NUM      $n
+#define NAMEMAP_BUILTIN_SLOTS    $table->{slots}
+#define NAMEMAP_BUILTIN_BUCKETS  $table->{buckets}
+
+static const char *const namemap_builtin_names[NAMEMAP_BUILTIN_NUM] = {
+EOF
+print "    \"$_\",\n" foreach @names;
+print <<"EOF";
+};
+
+/* Seeds for the second hash, per bucket of the first */
+static const uint32_t namemap_builtin_seeds[NAMEMAP_BUILTIN_BUCKETS] = {
+EOF
+print format_numbers(8, @{$table->{seeds}});
+print <<"EOF";
+};
+
+/* Index in namemap_builtin_names[] per slot, -1 if the slot is unused */
+static const short namemap_builtin_slots[NAMEMAP_BUILTIN_SLOTS] = {
+EOF
+print format_numbers(12, @{$table->{slot}});
+print "};\n";
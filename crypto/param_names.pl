@@ -0,0 +1,126 @@
+#! /usr/bin/env perl
+# Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+#
+# Licensed under the Apache License 2.0 (the "License").  You may not use
+# this file except in compliance with the License.  You can obtain a copy
+# in the file LICENSE in the source distribution or at
+# https://www.openssl.org/source/license.html
+
+# Gives each distinct OSSL_PARAM key in include/openssl/core_names.h an index,
+# so that parameter handlers can switch on it instead of comparing strings.
+#
+# Usage: param_names.pl header|table core_names.h
+#
+# "header" produces include/internal/param_names.h, with a PIDX_ macro for
+# each OSSL_ macro, and "table" produces crypto/params_idx.h, with a perfect
+# hash table of the keys for ossl_param_find_pidx() in crypto/params.c.  See
+# OpenSSL::PerfectHash for the hash and how the table is built.
+
+use strict;
+use warnings;
+
+use FindBin;
+use lib "$FindBin::Bin/../util/perl";
+use OpenSSL::PerfectHash qw(perfect_hash format_numbers);
+
+my ($what, $file) = @ARGV;
+die "Usage: param_names.pl header|table core_names.h\n"
+    unless defined $file && ($what eq 'header' || $what eq 'table');
+
+open my $fh, '<', $file or die "Can't open $file: $!\n";
+my $src = do { local $/; <$fh> };
+close $fh;
+$src =~ s|\\\n| |g;
+$src =~ s|/\*.*?\*/| |gs;
+
+# Macro name => key, in order of appearance
+my @macros;
+my %value;
+foreach (split /\n/, $src) {
+    next unless m/^\s*#\s*define\s+OSSL_(\w+)\s+(.*?)\s*$/;
+    my ($macro, $def) = ($1, $2);
+    my $key;
+
+    if ($def =~ m/^"([^"]*)"$/) {
+        $key = $1;
+    } elsif ($def =~ m/^OSSL_(\w+)$/ && defined $value{$1}) {
+        $key = $value{$1};
+    } else {
+        next;
+    }
+    push @macros, $macro unless defined $value{$macro};
+    $value{$macro} = $key;
+}
+
+my %seen;
+my @keys = sort grep { !$seen{$_}++ } values %value;
+my %index = map { $keys[$_] => $_ } 0 .. $#keys;
+die "No keys found\n" if @keys == 0;
+
+my $year = (localtime)[5] + 1900;
+my $n = scalar @keys;
+
+print <<"EOF";
+/*
+ * WARNING: do not edit!
+ * Generated by crypto/param_names.pl
+ *
+ * Copyright $year The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+EOF
+
+if ($what eq 'header') {
+    print <<"EOF";
+#ifndef OSSL_INTERNAL_PARAM_NAMES_H
+# define OSSL_INTERNAL_PARAM_NAMES_H
+
+/*
+ * PIDX_xxx is the index of the key of OSSL_xxx, as returned by
+ * ossl_param_find_pidx().  Macros with the same key have the same index.
+ */
+EOF
+    foreach (@macros) {
+        printf "# define %-46s %d\n", "PIDX_$_", $index{$value{$_}};
+    }
+    print <<"EOF";
+# define PIDX_NUM $n
+
+int ossl_param_find_pidx(const char *key);
+
+#endif
+EOF
+    exit 0;
+}
+
+my $table = perfect_hash(@keys);
+
+print <<"EOF";
+#define PARAMS_IDX_NUM      $n
+#define PARAMS_IDX_SLOTS    $table->{slots}
+#define PARAMS_IDX_BUCKETS  $table->{buckets}
+
+/* The keys, in PIDX_ order */
+static const char *const params_idx_keys[PARAMS_IDX_NUM] = {
+EOF
+print "    \"$_\",\n" foreach @keys;
+print <<"EOF";
+};
+
+/* Seeds for the second hash, per bucket of the first */
+static const uint32_t params_idx_seeds[PARAMS_IDX_BUCKETS] = {
+EOF
+print format_numbers(8, @{$table->{seeds}});
+print <<"EOF";
+};
+
+/* Index in params_idx_keys[] per slot, -1 if the slot is unused */
+static const short params_idx_slots[PARAMS_IDX_SLOTS] = {
+EOF
+print format_numbers(12, @{$table->{slot}});
+print "};\n";
@@ -12,6 +12,37 @@
 #include <openssl/params.h>
 #include "internal/thread_once.h"
 #include "internal/numbers.h"
+#include "internal/param_names.h"
+#include "params_idx.h"
+
+static uint32_t params_idx_hash(uint32_t seed, const char *key)
+{
+    uint32_t h = 2166136261U ^ seed;
+
+    while (*key != '\0') {
+        h ^= (unsigned char)*key++;
+        h *= 16777619U;
+    }
+    return h;
+}
+
+/*
+ * Returns the PIDX_ index of |key|, or -1 if it isn't one of the keys in
+ * <openssl/core_names.h>.  That's two hashes and one strcmp(), so parameter
+ * handlers can go through their OSSL_PARAM array once and switch on the
+ * index, rather than calling OSSL_PARAM_locate() for each key they know.
+ */
+int ossl_param_find_pidx(const char *key)
+{
+    uint32_t h = params_idx_hash(0, key);
+    uint32_t seed = params_idx_seeds[h & (PARAMS_IDX_BUCKETS - 1)];
+    int i = params_idx_slots[params_idx_hash(seed, key)
+                             & (PARAMS_IDX_SLOTS - 1)];
+
+    if (i < 0 || strcmp(params_idx_keys[i], key) != 0)
+        return -1;
+    return i;
+}
 
 OSSL_PARAM *OSSL_PARAM_locate(OSSL_PARAM *p, const char *key)
 {
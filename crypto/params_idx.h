@@ -0,0 +1,196 @@
+/*
+ * WARNING: do not edit!
+ * Generated by crypto/param_names.pl
+ *
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#define PARAMS_IDX_NUM      139
+#define PARAMS_IDX_SLOTS    256
+#define PARAMS_IDX_BUCKETS  64
+
+/* The keys, in PIDX_ order */
+static const char *const params_idx_keys[PARAMS_IDX_NUM] = {
+    "CMAC",
+    "HKDF",
+    "HMAC",
+    "KBKDF",
+    "KECCAK-KMAC-128",
+    "KECCAK-KMAC-256",
+    "KMAC128",
+    "KMAC256",
+    "KRB5KDF",
+    "MD2",
+    "MD4",
+    "MD5",
+    "MD5-SHA1",
+    "MDC2",
+    "PBKDF2",
+    "RIPEMD160",
+    "SCRYPT",
+    "SHA1",
+    "SHA2-224",
+    "SHA2-256",
+    "SHA2-384",
+    "SHA2-512",
+    "SHA3-224",
+    "SHA3-256",
+    "SHA3-384",
+    "SHA3-512",
+    "SSHKDF",
+    "SSKDF",
+    "TLS1-PRF",
+    "X942KDF",
+    "X963KDF",
+    "alg_id_param",
+    "algorithm-id",
+    "bits",
+    "blocksize",
+    "buildinfo",
+    "cekalg",
+    "cipher",
+    "constant",
+    "curve-name",
+    "custom",
+    "d",
+    "default-digest",
+    "digest",
+    "digest-props",
+    "digest-size",
+    "e",
+    "ecdh-cofactor-mode",
+    "flags",
+    "g",
+    "info",
+    "iter",
+    "iteration",
+    "iv",
+    "ivlen",
+    "kat",
+    "kdf-digest",
+    "kdf-digest-props",
+    "kdf-outlen",
+    "kdf-type",
+    "kdf-ukm",
+    "kdf-ukm-len",
+    "key",
+    "keybits",
+    "keylen",
+    "mac",
+    "mackey",
+    "maclen",
+    "mandatory-digest",
+    "max-size",
+    "maxmem_bytes",
+    "mgf1-digest",
+    "mgf1-properties",
+    "micalg",
+    "mode",
+    "module-filename",
+    "n",
+    "name",
+    "num",
+    "oaep-label",
+    "oaep-label-len",
+    "p",
+    "pad",
+    "pad-mode",
+    "pad_type",
+    "padding",
+    "pass",
+    "passphrase",
+    "pkcs5",
+    "potential",
+    "primes",
+    "priv",
+    "properties",
+    "pss-saltlen",
+    "pub",
+    "q",
+    "r",
+    "randkey",
+    "rounds",
+    "rsa-coefficient",
+    "rsa-exponent",
+    "rsa-factor",
+    "salt",
+    "secret",
+    "security-bits",
+    "seed",
+    "session_id",
+    "size",
+    "speed",
+    "ssl3-ms",
+    "st-desc",
+    "st-phase",
+    "st-type",
+    "tag",
+    "taglen",
+    "threads",
+    "tls-client-version",
+    "tls-negotiated-version",
+    "tls1multi_aad",
+    "tls1multi_aadpacklen",
+    "tls1multi_enc",
+    "tls1multi_encin",
+    "tls1multi_enclen",
+    "tls1multi_interleave",
+    "tls1multi_maxbufsz",
+    "tls1multi_maxsndfrag",
+    "tlsaad",
+    "tlsaadpad",
+    "tlsivfixed",
+    "tlsivgen",
+    "tlsivinv",
+    "type",
+    "ukm",
+    "use-cofactor-flag",
+    "version",
+    "xcghash",
+    "xof",
+    "xoflen",
+    "xts_sector_size",
+};
+
+/* Seeds for the second hash, per bucket of the first */
+static const uint32_t params_idx_seeds[PARAMS_IDX_BUCKETS] = {
+    1, 4, 1, 1, 1, 1, 2, 3,
+    3, 1, 1, 0, 1, 2, 1, 1,
+    3, 2, 2, 1, 0, 1, 3, 2,
+    1, 0, 1, 6, 3, 2, 1, 0,
+    2, 4, 2, 1, 4, 1, 4, 4,
+    2, 0, 6, 2, 1, 1, 8, 1,
+    1, 1, 4, 2, 1, 6, 1, 3,
+    1, 1, 3, 4, 0, 1, 2, 4,
+};
+
+/* Index in params_idx_keys[] per slot, -1 if the slot is unused */
+static const short params_idx_slots[PARAMS_IDX_SLOTS] = {
+    -1, 66, 123, 57, -1, -1, 46, 24, -1, 47, 65, -1,
+    -1, 122, -1, 56, 5, -1, 116, -1, 82, 95, -1, 109,
+    50, -1, -1, 67, -1, -1, -1, -1, 74, 79, 54, 114,
+    -1, 127, -1, 135, -1, 58, 39, 30, -1, 8, 99, -1,
+    -1, -1, 68, -1, 101, -1, -1, -1, 90, 60, 77, 125,
+    -1, 86, -1, -1, -1, -1, 115, -1, -1, 45, -1, 19,
+    0, 36, -1, 4, 3, -1, 10, -1, 28, 105, -1, -1,
+    -1, -1, 120, -1, -1, -1, 26, 55, 81, -1, 59, -1,
+    -1, -1, 25, -1, -1, 21, 70, -1, 132, -1, -1, 71,
+    -1, 118, -1, 108, 87, -1, 100, 61, 9, 16, 40, 126,
+    106, 17, 112, 110, -1, 102, 35, -1, 94, -1, 96, -1,
+    -1, 12, -1, 63, -1, 134, 138, 37, 119, -1, -1, 20,
+    -1, 27, -1, -1, 31, 78, -1, 43, 73, 41, 97, -1,
+    -1, 2, 76, 131, 80, -1, 88, 62, -1, 98, 32, -1,
+    121, 117, -1, -1, 124, -1, 75, -1, 38, -1, 64, 51,
+    33, -1, -1, -1, 13, -1, 18, 104, -1, 84, 22, 89,
+    -1, 6, -1, 52, 44, -1, 23, 107, -1, 34, -1, 15,
+    113, 133, -1, 129, -1, 14, -1, 92, 7, 29, -1, -1,
+    83, -1, -1, 69, -1, 91, -1, 103, 49, 11, -1, -1,
+    -1, -1, 72, -1, -1, -1, -1, 136, 137, 128, -1, -1,
+    -1, 85, -1, 53, -1, 42, -1, 48, -1, -1, -1, 111,
+    1, 130, 93, -1,
+};
@@ -12,11 +12,14 @@
 #include <stdio.h>
 #include <stdarg.h>
 #include <openssl/crypto.h>
+#include <openssl/evp.h>
 #include "internal/property.h"
 #include "crypto/ctype.h"
 #include <openssl/lhash.h>
 #include <openssl/rand.h>
 #include "internal/thread_once.h"
+#include "internal/tsan_assist.h"
+#include "internal/rcu.h"
 #include "crypto/lhash.h"
 #include "crypto/sparse_array.h"
 #include "property_local.h"
@@ -42,18 +45,34 @@ typedef struct {
 
 DEFINE_STACK_OF(IMPLEMENTATION)
 
-typedef struct {
+/*
+ * The query cache, which also holds the default implementation of each
+ * algorithm.  It's a hash table whose buckets are published through RCU, so
+ * that lookups never take the store lock.  Entries don't change once they are
+ * linked in.  Writers hold the store lock and the RCU write lock, link new
+ * entries in at the head of their bucket and unlink old ones.  Those are only
+ * freed after the store lock has been released, see cache_unlock().
+ */
+#define CACHE_BUCKETS   1024
+
+typedef struct query_st QUERY;
+struct query_st {
+    QUERY *next;
+    /* Links unlinked entries that are waiting to be freed */
+    QUERY *retired;
+    int nid;
+    unsigned long hash;
+    /* NULL for the default implementation of |nid| */
     const char *query;
     METHOD method;
     char body[1];
-} QUERY;
-
-DEFINE_LHASH_OF(QUERY);
+};
 
 typedef struct {
     int nid;
     STACK_OF(IMPLEMENTATION) *impls;
-    LHASH_OF(QUERY) *cache;
+    /* The number of queries cached for this algorithm */
+    size_t ncache;
 } ALGORITHM;
 
 struct ossl_method_store_st {
@@ -62,14 +81,36 @@ struct ossl_method_store_st {
     SPARSE_ARRAY_OF(ALGORITHM) *algs;
     OSSL_PROPERTY_LIST *global_properties;
     int need_flush;
+    /* Changed whenever the result of a fetch may have changed */
+    TSAN_QUALIFIER int generation;
+    /* Changed whenever |global_properties| changes, under the store lock */
+    int global_generation;
     CRYPTO_RWLOCK *lock;
+    /* The query cache, see QUERY */
+    QUERY **cache;
+    QUERY *retired;
+    CRYPTO_RCU_LOCK *rcu;
 };
 
-typedef struct {
-    LHASH_OF(QUERY) *cache;
-    size_t nelem;
-    uint32_t seed;
-} IMPL_CACHE_FLUSH;
+/*
+ * A property query that has been parsed once, for callers that use the same
+ * query over and over again.  It's also merged with the global properties of
+ * the first store it's used with, once for each time those change, and the
+ * result is read without locking anything but the store, see query_merge().
+ */
+struct ossl_property_query_st {
+    OPENSSL_CTX *ctx;
+    char *query;
+    unsigned long hash;
+    /* NULL if |query| is NULL or has to be parsed for each use */
+    OSSL_PROPERTY_LIST *list;
+    /* Only taken to pick |merged_store| */
+    CRYPTO_RWLOCK *lock;
+    const OSSL_METHOD_STORE *merged_store;
+    /* These belong to |merged_store| and are protected by its lock */
+    int merged_generation;
+    OSSL_PROPERTY_LIST *merged;
+};
 
 DEFINE_SPARSE_ARRAY_OF(ALGORITHM);
 
@@ -101,16 +142,6 @@ int ossl_property_unlock(OSSL_METHOD_STORE *p)
     return p != 0 ? CRYPTO_THREAD_unlock(p->lock) : 0;
 }
 
-static unsigned long query_hash(const QUERY *a)
-{
-    return OPENSSL_LH_strhash(a->query);
-}
-
-static int query_cmp(const QUERY *a, const QUERY *b)
-{
-    return strcmp(a->query, b->query);
-}
-
 static void impl_free(IMPLEMENTATION *impl)
 {
     if (impl != NULL) {
@@ -131,8 +162,6 @@ static void alg_cleanup(ossl_uintmax_t idx, ALGORITHM *a)
 {
     if (a != NULL) {
         sk_IMPLEMENTATION_pop_free(a->impls, &impl_free);
-        lh_QUERY_doall(a->cache, &impl_cache_free);
-        lh_QUERY_free(a->cache);
         OPENSSL_free(a);
     }
 }
@@ -157,13 +186,33 @@ OSSL_METHOD_STORE *ossl_method_store_new(OPENSSL_CTX *ctx)
             OPENSSL_free(res);
             return NULL;
         }
+        if ((res->rcu = ossl_rcu_lock_new()) == NULL
+                || (res->cache = OPENSSL_zalloc(CACHE_BUCKETS
+                                                * sizeof(*res->cache)))
+                   == NULL) {
+            ossl_rcu_lock_free(res->rcu);
+            CRYPTO_THREAD_lock_free(res->lock);
+            ossl_sa_ALGORITHM_free(res->algs);
+            OPENSSL_free(res);
+            return NULL;
+        }
     }
     return res;
 }
 
 void ossl_method_store_free(OSSL_METHOD_STORE *store)
 {
+    QUERY *e, *next;
+    size_t i;
+
     if (store != NULL) {
+        for (i = 0; i < CACHE_BUCKETS; i++)
+            for (e = store->cache[i]; e != NULL; e = next) {
+                next = e->next;
+                impl_cache_free(e);
+            }
+        OPENSSL_free(store->cache);
+        ossl_rcu_lock_free(store->rcu);
         ossl_sa_ALGORITHM_doall(store->algs, &alg_cleanup);
         ossl_sa_ALGORITHM_free(store->algs);
         ossl_property_free(store->global_properties);
@@ -182,6 +231,158 @@ static int ossl_method_store_insert(OSSL_METHOD_STORE *store, ALGORITHM *alg)
         return ossl_sa_ALGORITHM_set(store->algs, alg->nid, alg);
 }
 
+static QUERY **cache_bucket(OSSL_METHOD_STORE *store, int nid,
+                            unsigned long hash)
+{
+    return &store->cache[(hash ^ ((size_t)nid * 0x9e3779b1U)) % CACHE_BUCKETS];
+}
+
+static int cache_match(const QUERY *e, int nid, const char *query)
+{
+    if (e->nid != nid)
+        return 0;
+    if (query == NULL || e->query == NULL)
+        return query == e->query;
+    return strcmp(e->query, query) == 0;
+}
+
+/*
+ * Look |nid| and |query| up in the cache, a NULL |query| stands for the
+ * default implementation.  Returns 1 and a new reference to the method in
+ * |*method| on a hit.  This doesn't take the store lock.
+ */
+static int cache_lookup(OSSL_METHOD_STORE *store, int nid, const char *query,
+                        unsigned long hash, void **method)
+{
+    QUERY *e;
+    int token, ret = 0;
+
+    if (!ossl_rcu_read_lock(store->rcu, &token))
+        return 0;
+    for (e = ossl_rcu_deref((void **)cache_bucket(store, nid, hash));
+         e != NULL; e = ossl_rcu_deref((void **)&e->next))
+        if (cache_match(e, nid, query))
+            break;
+    if (e != NULL && ossl_method_up_ref(&e->method)) {
+        *method = e->method.method;
+        ret = 1;
+    }
+    ossl_rcu_read_unlock(store->rcu, token);
+    return ret;
+}
+
+/* Lock |store| for changes, cache readers carry on regardless */
+static void cache_write_lock(OSSL_METHOD_STORE *store)
+{
+    ossl_property_write_lock(store);
+    ossl_rcu_write_lock(store->rcu);
+}
+
+/*
+ * Unlock |store|, then free the cache entries that were unlinked while it was
+ * locked once no reader can be looking at them anymore.  That wait is done
+ * without holding the store lock, so that fetches aren't held up by it.
+ */
+static void cache_unlock(OSSL_METHOD_STORE *store)
+{
+    QUERY *e = store->retired, *next;
+
+    store->retired = NULL;
+    ossl_rcu_write_unlock(store->rcu);
+    ossl_property_unlock(store);
+    if (e == NULL)
+        return;
+
+    ossl_rcu_write_lock(store->rcu);
+    ossl_synchronize_rcu(store->rcu);
+    ossl_rcu_write_unlock(store->rcu);
+    for (; e != NULL; e = next) {
+        next = e->retired;
+        impl_cache_free(e);
+    }
+}
+
+/* Unlink |*pp| from the cache, the store must be locked by cache_write_lock */
+static void cache_unlink(OSSL_METHOD_STORE *store, QUERY **pp)
+{
+    QUERY *e = *pp;
+    ALGORITHM *alg;
+
+    ossl_rcu_assign_ptr((void **)pp, e->next);
+    e->retired = store->retired;
+    store->retired = e;
+    if (e->query != NULL) {
+        store->nelem--;
+        if ((alg = ossl_method_store_retrieve(store, e->nid)) != NULL)
+            alg->ncache--;
+    }
+}
+
+static void cache_remove(OSSL_METHOD_STORE *store, int nid, const char *query,
+                         unsigned long hash)
+{
+    QUERY **pp;
+
+    for (pp = cache_bucket(store, nid, hash); *pp != NULL; pp = &(*pp)->next)
+        if (cache_match(*pp, nid, query)) {
+            cache_unlink(store, pp);
+            return;
+        }
+}
+
+/*
+ * Cache |method| for |alg| and |query|, replacing any earlier entry.  The
+ * store must be locked by cache_write_lock.
+ */
+static int cache_insert(OSSL_METHOD_STORE *store, ALGORITHM *alg,
+                        const char *query, unsigned long hash,
+                        const METHOD *method)
+{
+    QUERY **pp = cache_bucket(store, alg->nid, hash);
+    size_t len = query != NULL ? strlen(query) : 0;
+    QUERY *e = OPENSSL_malloc(sizeof(*e) + len);
+
+    if (e == NULL)
+        return 0;
+    e->method = *method;
+    if (!ossl_method_up_ref(&e->method)) {
+        OPENSSL_free(e);
+        return 0;
+    }
+    e->nid = alg->nid;
+    e->hash = hash;
+    e->query = NULL;
+    if (query != NULL)
+        e->query = memcpy(e->body, query, len + 1);
+
+    cache_remove(store, alg->nid, query, hash);
+    e->next = *pp;
+    ossl_rcu_assign_ptr((void **)pp, e);
+    if (query != NULL) {
+        store->nelem++;
+        alg->ncache++;
+    }
+    return 1;
+}
+
+/*
+ * Make the cache agree with the default implementation of |alg|.  Should
+ * that fail, there is no entry, which makes fetches take the locked path.
+ */
+static void cache_set_default(OSSL_METHOD_STORE *store, ALGORITHM *alg)
+{
+    IMPLEMENTATION *impl = sk_IMPLEMENTATION_value(alg->impls, 0);
+    QUERY *e;
+
+    for (e = *cache_bucket(store, alg->nid, 0); e != NULL; e = e->next)
+        if (cache_match(e, alg->nid, NULL))
+            break;
+    if (e != NULL && impl != NULL && e->method.method == impl->method.method)
+        return;
+    if (impl == NULL || !cache_insert(store, alg, NULL, 0, &impl->method))
+        cache_remove(store, alg->nid, NULL, 0);
+}
+
 int ossl_method_store_add(OSSL_METHOD_STORE *store, const OSSL_PROVIDER *prov,
                           int nid, const char *properties, void *method,
                           int (*method_up_ref)(void *),
@@ -216,7 +417,7 @@ int ossl_method_store_add(OSSL_METHOD_STORE *store, const OSSL_PROVIDER *prov,
      * A write lock is used unconditionally because we wend our way down to the
      * property string code which isn't locking friendly.
      */
-    ossl_property_write_lock(store);
+    cache_write_lock(store);
     ossl_method_cache_flush(store, nid);
     if ((impl->properties = ossl_prop_defn_get(store->ctx, properties)) == NULL) {
         impl->properties = ossl_parse_property(store->ctx, properties);
@@ -228,8 +429,7 @@ int ossl_method_store_add(OSSL_METHOD_STORE *store, const OSSL_PROVIDER *prov,
     alg = ossl_method_store_retrieve(store, nid);
     if (alg == NULL) {
         if ((alg = OPENSSL_zalloc(sizeof(*alg))) == NULL
-                || (alg->impls = sk_IMPLEMENTATION_new_null()) == NULL
-                || (alg->cache = lh_QUERY_new(&query_hash, &query_cmp)) == NULL)
+                || (alg->impls = sk_IMPLEMENTATION_new_null()) == NULL)
             goto err;
         alg->nid = nid;
         if (!ossl_method_store_insert(store, alg))
@@ -245,15 +445,17 @@ int ossl_method_store_add(OSSL_METHOD_STORE *store, const OSSL_PROVIDER *prov,
             break;
     }
     if (i == sk_IMPLEMENTATION_num(alg->impls)
-        && sk_IMPLEMENTATION_push(alg->impls, impl))
+        && sk_IMPLEMENTATION_push(alg->impls, impl)) {
+        cache_set_default(store, alg);
         ret = 1;
-    ossl_property_unlock(store);
+    }
+    cache_unlock(store);
     if (ret == 0)
         impl_free(impl);
     return ret;
 
 err:
-    ossl_property_unlock(store);
+    cache_unlock(store);
     alg_cleanup(0, alg);
     impl_free(impl);
     return 0;
@@ -268,11 +470,11 @@ int ossl_method_store_remove(OSSL_METHOD_STORE *store, int nid,
     if (nid <= 0 || method == NULL || store == NULL)
         return 0;
 
-    ossl_property_write_lock(store);
+    cache_write_lock(store);
     ossl_method_cache_flush(store, nid);
     alg = ossl_method_store_retrieve(store, nid);
     if (alg == NULL) {
-        ossl_property_unlock(store);
+        cache_unlock(store);
         return 0;
     }
 
@@ -287,14 +489,47 @@ int ossl_method_store_remove(OSSL_METHOD_STORE *store, int nid,
         if (impl->method.method == method) {
             impl_free(impl);
             sk_IMPLEMENTATION_delete(alg->impls, i);
-            ossl_property_unlock(store);
+            cache_set_default(store, alg);
+            cache_unlock(store);
             return 1;
         }
     }
-    ossl_property_unlock(store);
+    cache_unlock(store);
     return 0;
 }
 
+/*
+ * Pick the implementation of |alg| that best matches |pq|.  The store must be
+ * locked.
+ */
+static METHOD *impl_select(ALGORITHM *alg, const OSSL_PROPERTY_LIST *pq)
+{
+    IMPLEMENTATION *impl;
+    METHOD *best_method = NULL;
+    int j, best = -1, score, optional;
+
+    optional = ossl_property_has_optional(pq);
+    for (j = 0; j < sk_IMPLEMENTATION_num(alg->impls); j++) {
+        impl = sk_IMPLEMENTATION_value(alg->impls, j);
+        score = ossl_property_match_count(pq, impl->properties);
+        if (score > best) {
+            best_method = &impl->method;
+            best = score;
+            if (!optional)
+                break;
+        }
+    }
+    return best_method;
+}
+
+static int method_return(METHOD *best_method, void **method)
+{
+    if (best_method == NULL || !ossl_method_up_ref(best_method))
+        return 0;
+    *method = best_method->method;
+    return 1;
+}
+
 int ossl_method_store_fetch(OSSL_METHOD_STORE *store, int nid,
                             const char *prop_query, void **method)
 {
@@ -302,8 +537,7 @@ int ossl_method_store_fetch(OSSL_METHOD_STORE *store, int nid,
     IMPLEMENTATION *impl;
     OSSL_PROPERTY_LIST *pq = NULL, *p2;
     METHOD *best_method = NULL;
-    int ret = 0;
-    int j, best = -1, score, optional;
+    int ret;
 
 #ifndef FIPS_MODE
     OPENSSL_init_crypto(OPENSSL_INIT_LOAD_CONFIG, NULL);
@@ -312,6 +546,10 @@ int ossl_method_store_fetch(OSSL_METHOD_STORE *store, int nid,
     if (nid <= 0 || method == NULL || store == NULL)
         return 0;
 
+    /* The default implementation of each algorithm is in the cache */
+    if (prop_query == NULL && cache_lookup(store, nid, NULL, 0, method))
+        return 1;
+
     /*
      * This only needs to be a read lock, because queries never create property
      * names or value and thus don't modify any of the property string layer.
@@ -324,10 +562,8 @@ int ossl_method_store_fetch(OSSL_METHOD_STORE *store, int nid,
     }
 
     if (prop_query == NULL) {
-        if ((impl = sk_IMPLEMENTATION_value(alg->impls, 0)) != NULL) {
+        if ((impl = sk_IMPLEMENTATION_value(alg->impls, 0)) != NULL)
             best_method = &impl->method;
-            ret = 1;
-        }
         goto fin;
     }
     pq = ossl_parse_query(store->ctx, prop_query);
@@ -340,28 +576,153 @@ int ossl_method_store_fetch(OSSL_METHOD_STORE *store, int nid,
         ossl_property_free(pq);
         pq = p2;
     }
-    optional = ossl_property_has_optional(pq);
-    for (j = 0; j < sk_IMPLEMENTATION_num(alg->impls); j++) {
-        impl = sk_IMPLEMENTATION_value(alg->impls, j);
-        score = ossl_property_match_count(pq, impl->properties);
-        if (score > best) {
-            best_method = &impl->method;
-            best = score;
-            ret = 1;
-            if (!optional)
-                goto fin;
-        }
-    }
+    best_method = impl_select(alg, pq);
 fin:
-    if (ret && ossl_method_up_ref(best_method))
-        *method = best_method->method;
-    else
-        ret = 0;
+    ret = method_return(best_method, method);
     ossl_property_unlock(store);
     ossl_property_free(pq);
     return ret;
 }
 
+OSSL_PROPERTY_QUERY *OSSL_PROPERTY_QUERY_new(OPENSSL_CTX *libctx,
+                                             const char *propq)
+{
+    OSSL_PROPERTY_QUERY *query = OPENSSL_zalloc(sizeof(*query));
+
+    if (query == NULL)
+        return NULL;
+    query->ctx = openssl_ctx_get_concrete(libctx);
+    if ((query->lock = CRYPTO_THREAD_lock_new()) == NULL)
+        goto err;
+    /* A NULL query stands for the default implementation of an algorithm */
+    if (propq == NULL)
+        return query;
+    if ((query->query = OPENSSL_strdup(propq)) == NULL
+            || (query->list = ossl_parse_query(query->ctx, propq)) == NULL)
+        goto err;
+    query->hash = OPENSSL_LH_strhash(propq);
+    /*
+     * Names and values that no provider has mentioned yet don't parse to
+     * anything useful, so such queries have to be parsed for every fetch.
+     */
+    if (ossl_property_has_unknown(query->list)) {
+        ossl_property_free(query->list);
+        query->list = NULL;
+    }
+    return query;
+ err:
+    OSSL_PROPERTY_QUERY_free(query);
+    return NULL;
+}
+
+void OSSL_PROPERTY_QUERY_free(OSSL_PROPERTY_QUERY *query)
+{
+    if (query == NULL)
+        return;
+    ossl_property_free(query->merged);
+    ossl_property_free(query->list);
+    OPENSSL_free(query->query);
+    CRYPTO_THREAD_lock_free(query->lock);
+    OPENSSL_free(query);
+}
+
+const char *ossl_property_query_string(const OSSL_PROPERTY_QUERY *query)
+{
+    return query != NULL ? query->query : NULL;
+}
+
+/* Check whether |query| holds its merge with the global properties of |store| */
+static int query_is_merged(const OSSL_PROPERTY_QUERY *query,
+                           const OSSL_METHOD_STORE *store)
+{
+    return ossl_rcu_deref((void **)&query->merged_store) == store
+           && query->merged != NULL
+           && query->merged_generation == store->global_generation;
+}
+
+/*
+ * Merge |query| with the global properties of |store|.  Fetches read the
+ * result with only the store read locked, so the merge is done with the store
+ * write locked, which only happens when the global properties have changed.
+ * Only the first store that |query| is used with keeps a merge, for others
+ * the query is parsed for each fetch.
+ */
+static int query_merge(OSSL_PROPERTY_QUERY *query, OSSL_METHOD_STORE *store)
+{
+    const OSSL_METHOD_STORE *owner;
+    OSSL_PROPERTY_LIST *merged;
+    int ret = 0;
+
+    if (!CRYPTO_THREAD_write_lock(query->lock))
+        return 0;
+    if (query->merged_store == NULL)
+        ossl_rcu_assign_ptr((void **)&query->merged_store, store);
+    owner = query->merged_store;
+    CRYPTO_THREAD_unlock(query->lock);
+    if (owner != store)
+        return 0;
+
+    ossl_property_write_lock(store);
+    if (store->global_properties == NULL || query_is_merged(query, store)) {
+        ret = 1;
+    } else if ((merged = ossl_property_merge(query->list,
+                                             store->global_properties))
+               != NULL) {
+        ossl_property_free(query->merged);
+        query->merged = merged;
+        query->merged_generation = store->global_generation;
+        ret = 1;
+    }
+    ossl_property_unlock(store);
+    return ret;
+}
+
+int ossl_method_store_fetch_query(OSSL_METHOD_STORE *store, int nid,
+                                  OSSL_PROPERTY_QUERY *query, void **method)
+{
+    ALGORITHM *alg;
+    METHOD *best_method = NULL;
+    int ret;
+
+    /*
+     * Property names are per library context, so a query compiled for another
+     * one has to be parsed again.
+     */
+    if (query == NULL || query->list == NULL || store == NULL
+            || query->ctx != store->ctx)
+        return ossl_method_store_fetch(store, nid,
+                                       ossl_property_query_string(query),
+                                       method);
+
+#ifndef FIPS_MODE
+    OPENSSL_init_crypto(OPENSSL_INIT_LOAD_CONFIG, NULL);
+#endif
+
+    if (nid <= 0 || method == NULL)
+        return 0;
+
+    ossl_property_read_lock(store);
+    if (store->global_properties != NULL && !query_is_merged(query, store)) {
+        ossl_property_unlock(store);
+        if (!query_merge(query, store))
+            return ossl_method_store_fetch(store, nid, query->query, method);
+        ossl_property_read_lock(store);
+        /* The global properties may have changed again in the meantime */
+        if (store->global_properties != NULL
+                && !query_is_merged(query, store)) {
+            ossl_property_unlock(store);
+            return ossl_method_store_fetch(store, nid, query->query, method);
+        }
+    }
+    alg = ossl_method_store_retrieve(store, nid);
+    if (alg != NULL)
+        best_method = impl_select(alg, store->global_properties == NULL
+                                       ? query->list : query->merged);
+    ret = method_return(best_method, method);
+    ossl_property_unlock(store);
+    return ret;
+}
+
 int ossl_method_store_set_global_properties(OSSL_METHOD_STORE *store,
                                             const char *prop_query) {
     int ret = 0;
@@ -369,44 +730,53 @@ int ossl_method_store_set_global_properties(OSSL_METHOD_STORE *store,
     if (store == NULL)
         return 1;
 
-    ossl_property_write_lock(store);
+    cache_write_lock(store);
     ossl_method_cache_flush_all(store);
+    store->global_generation++;
     if (prop_query == NULL) {
         ossl_property_free(store->global_properties);
         store->global_properties = NULL;
-        ossl_property_unlock(store);
+        cache_unlock(store);
         return 1;
     }
     store->global_properties = ossl_parse_query(store->ctx, prop_query);
     ret = store->global_properties != NULL;
-    ossl_property_unlock(store);
+    cache_unlock(store);
     return ret;
 }
 
-static void impl_cache_flush_alg(ossl_uintmax_t idx, ALGORITHM *alg)
-{
-    lh_QUERY_doall(alg->cache, &impl_cache_free);
-    lh_QUERY_flush(alg->cache);
-}
-
 static void ossl_method_cache_flush(OSSL_METHOD_STORE *store, int nid)
 {
     ALGORITHM *alg = ossl_method_store_retrieve(store, nid);
+    QUERY **pp;
+    size_t i;
 
-    if (alg != NULL) {
-        store->nelem -= lh_QUERY_num_items(alg->cache);
-        impl_cache_flush_alg(0, alg);
-    }
+    tsan_counter(&store->generation);
+    if (alg == NULL)
+        return;
+    for (i = 0; i < CACHE_BUCKETS && alg->ncache > 0; i++)
+        for (pp = &store->cache[i]; *pp != NULL;)
+            if ((*pp)->nid == nid && (*pp)->query != NULL)
+                cache_unlink(store, pp);
+            else
+                pp = &(*pp)->next;
 }
 
+/* The default implementations stay, global properties don't affect them */
 static void ossl_method_cache_flush_all(OSSL_METHOD_STORE *store)
 {
-    ossl_sa_ALGORITHM_doall(store->algs, &impl_cache_flush_alg);
-    store->nelem = 0;
+    QUERY **pp;
+    size_t i;
+
+    tsan_counter(&store->generation);
+    for (i = 0; i < CACHE_BUCKETS && store->nelem > 0; i++)
+        for (pp = &store->cache[i]; *pp != NULL;)
+            if ((*pp)->query != NULL)
+                cache_unlink(store, pp);
+            else
+                pp = &(*pp)->next;
 }
 
-IMPLEMENT_LHASH_DOALL_ARG(QUERY, IMPL_CACHE_FLUSH);
-
 /*
  * Flush an element from the query cache (perhaps).
  *
@@ -423,77 +793,73 @@ IMPLEMENT_LHASH_DOALL_ARG(QUERY, IMPL_CACHE_FLUSH);
  * preferable to a more refined approach that imposes a performance
  * impact.
  */
-static void impl_cache_flush_cache(QUERY *c, IMPL_CACHE_FLUSH *state)
+static void ossl_method_cache_flush_some(OSSL_METHOD_STORE *store)
 {
+    QUERY **pp;
     uint32_t n;
+    size_t i;
 
-    /*
-     * Implement the 32 bit xorshift as suggested by George Marsaglia in:
-     *      https://doi.org/10.18637/jss.v008.i14
-     *
-     * This is a very fast PRNG so there is no need to extract bits one at a
-     * time and use the entire value each time.
-     */
-    n = state->seed;
-    n ^= n << 13;
-    n ^= n >> 17;
-    n ^= n << 5;
-    state->seed = n;
-
-    if ((n & 1) != 0)
-        impl_cache_free(lh_QUERY_delete(state->cache, c));
-    else
-        state->nelem++;
+    if ((n = OPENSSL_rdtsc()) == 0)
+        n = 1;
+    store->need_flush = 0;
+    for (i = 0; i < CACHE_BUCKETS; i++)
+        for (pp = &store->cache[i]; *pp != NULL;) {
+            if ((*pp)->query != NULL) {
+                /*
+                 * Implement the 32 bit xorshift as suggested by George
+                 * Marsaglia in:
+                 *      https://doi.org/10.18637/jss.v008.i14
+                 *
+                 * This is a very fast PRNG so there is no need to extract
+                 * bits one at a time and use the entire value each time.
+                 */
+                n ^= n << 13;
+                n ^= n >> 17;
+                n ^= n << 5;
+                if ((n & 1) != 0) {
+                    cache_unlink(store, pp);
+                    continue;
+                }
+            }
+            pp = &(*pp)->next;
+        }
 }
 
-static void impl_cache_flush_one_alg(ossl_uintmax_t idx, ALGORITHM *alg,
-                                     void *v)
+/*
+ * Returns a number that changes whenever methods are added to or removed from
+ * |store| or its global properties change. This doesn't take any locks, so
+ * that callers can cheaply check whether an earlier fetch result is still
+ * current.
+ */
+int ossl_method_store_generation(OSSL_METHOD_STORE *store)
 {
-    IMPL_CACHE_FLUSH *state = (IMPL_CACHE_FLUSH *)v;
-
-    state->cache = alg->cache;
-    lh_QUERY_doall_IMPL_CACHE_FLUSH(state->cache, &impl_cache_flush_cache,
-                                    state);
+    return tsan_load(&store->generation);
 }
 
-static void ossl_method_cache_flush_some(OSSL_METHOD_STORE *store)
-{
-    IMPL_CACHE_FLUSH state;
-
-    state.nelem = 0;
-    if ((state.seed = OPENSSL_rdtsc()) == 0)
-        state.seed = 1;
-    store->need_flush = 0;
-    ossl_sa_ALGORITHM_doall_arg(store->algs, &impl_cache_flush_one_alg, &state);
-    store->nelem = state.nelem;
-}
 
 int ossl_method_store_cache_get(OSSL_METHOD_STORE *store, int nid,
                                 const char *prop_query, void **method)
 {
-    ALGORITHM *alg;
-    QUERY elem, *r;
-    int res = 0;
-
     if (nid <= 0 || store == NULL)
         return 0;
 
-    ossl_property_read_lock(store);
-    alg = ossl_method_store_retrieve(store, nid);
-    if (alg == NULL)
-        goto err;
+    if (prop_query == NULL)
+        prop_query = "";
+    return cache_lookup(store, nid, prop_query, OPENSSL_LH_strhash(prop_query),
+                        method);
+}
 
-    elem.query = prop_query != NULL ? prop_query : "";
-    r = lh_QUERY_retrieve(alg->cache, &elem);
-    if (r == NULL)
-        goto err;
-    if (ossl_method_up_ref(&r->method)) {
-        *method = r->method.method;
-        res = 1;
-    }
-err:
-    ossl_property_unlock(store);
-    return res;
+int ossl_method_store_cache_get_query(OSSL_METHOD_STORE *store, int nid,
+                                      const OSSL_PROPERTY_QUERY *query,
+                                      void **method)
+{
+    if (nid <= 0 || store == NULL)
+        return 0;
+
+    /* A NULL query is cached as "", whose hash is 0 */
+    if (query == NULL || query->query == NULL)
+        return cache_lookup(store, nid, "", 0, method);
+    return cache_lookup(store, nid, query->query, query->hash, method);
 }
 
 int ossl_method_store_cache_set(OSSL_METHOD_STORE *store, int nid,
@@ -501,9 +867,9 @@ int ossl_method_store_cache_set(OSSL_METHOD_STORE *store, int nid,
                                 int (*method_up_ref)(void *),
                                 void (*method_destruct)(void *))
 {
-    QUERY elem, *old, *p = NULL;
+    METHOD m;
     ALGORITHM *alg;
-    size_t len;
+    unsigned long hash;
     int res = 1;
 
     if (nid <= 0 || store == NULL)
@@ -511,45 +877,23 @@ int ossl_method_store_cache_set(OSSL_METHOD_STORE *store, int nid,
     if (prop_query == NULL)
         return 1;
 
-    ossl_property_write_lock(store);
+    hash = OPENSSL_LH_strhash(prop_query);
+    cache_write_lock(store);
     if (store->need_flush)
         ossl_method_cache_flush_some(store);
     alg = ossl_method_store_retrieve(store, nid);
-    if (alg == NULL)
-        goto err;
-
-    if (method == NULL) {
-        elem.query = prop_query;
-        if ((old = lh_QUERY_delete(alg->cache, &elem)) != NULL) {
-            impl_cache_free(old);
-            store->nelem--;
-        }
-        goto end;
-    }
-    p = OPENSSL_malloc(sizeof(*p) + (len = strlen(prop_query)));
-    if (p != NULL) {
-        p->query = p->body;
-        p->method.method = method;
-        p->method.up_ref = method_up_ref;
-        p->method.free = method_destruct;
-        if (!ossl_method_up_ref(&p->method))
-            goto err;
-        memcpy((char *)p->query, prop_query, len + 1);
-        if ((old = lh_QUERY_insert(alg->cache, p)) != NULL) {
-            impl_cache_free(old);
-            goto end;
-        }
-        if (!lh_QUERY_error(alg->cache)) {
-            if (++store->nelem >= IMPL_CACHE_FLUSH_THRESHOLD)
-                store->need_flush = 1;
-            goto end;
-        }
-        ossl_method_free(&p->method);
+    if (alg == NULL) {
+        res = 0;
+    } else if (method == NULL) {
+        cache_remove(store, nid, prop_query, hash);
+    } else {
+        m.method = method;
+        m.up_ref = method_up_ref;
+        m.free = method_destruct;
+        res = cache_insert(store, alg, prop_query, hash, &m);
+        if (store->nelem >= IMPL_CACHE_FLUSH_THRESHOLD)
+            store->need_flush = 1;
     }
-err:
-    res = 0;
-    OPENSSL_free(p);
-end:
-    ossl_property_unlock(store);
+    cache_unlock(store);
     return res;
 }
@@ -453,6 +453,24 @@ int ossl_property_has_optional(const OSSL_PROPERTY_LIST *query)
     return query->has_optional ? 1 : 0;
 }
 
+/*
+ * Does a property query refer to names or values that weren't known when it
+ * was parsed?  Such a query can parse differently once they become known.
+ */
+int ossl_property_has_unknown(const OSSL_PROPERTY_LIST *query)
+{
+    int i;
+
+    for (i = 0; i < query->n; i++) {
+        const PROPERTY_DEFINITION *q = query->properties + i;
+
+        if (q->name_idx == 0
+                || (q->type == PROPERTY_TYPE_STRING && q->v.str_val == 0))
+            return 1;
+    }
+    return 0;
+}
+
 /*
  * Compare a query against a definition.
  * Return the number of clauses matched or -1 if a mandatory clause is false.
@@ -73,6 +73,14 @@ struct ossl_provider_st {
 
     /* Provider side data */
     void *provctx;
+
+    /*
+     * One bit per operation, set once all the algorithms that this provider
+     * has for the operation are constructed and in the method store of the
+     * library context.  See ossl_method_construct().
+     */
+    unsigned char operation_bits[(OSSL_OP__HIGHEST + 8) / 8];
+    CRYPTO_RWLOCK *opbits_lock;
 };
 DEFINE_STACK_OF(OSSL_PROVIDER)
 
@@ -212,6 +220,7 @@ static OSSL_PROVIDER *provider_new(const char *name,
         || (prov->refcnt_lock = CRYPTO_THREAD_lock_new()) == NULL
 #endif
         || !ossl_provider_up_ref(prov) /* +1 One reference to be returned */
+        || (prov->opbits_lock = CRYPTO_THREAD_lock_new()) == NULL
         || (prov->name = OPENSSL_strdup(name)) == NULL) {
         ossl_provider_free(prov);
         CRYPTOerr(CRYPTO_F_PROVIDER_NEW, ERR_R_MALLOC_FAILURE);
@@ -331,6 +340,7 @@ void ossl_provider_free(OSSL_PROVIDER *prov)
             OPENSSL_free(prov->name);
             OPENSSL_free(prov->path);
             sk_INFOPAIR_pop_free(prov->parameters, free_infopair);
+            CRYPTO_THREAD_lock_free(prov->opbits_lock);
 #ifndef HAVE_ATOMICS
             CRYPTO_THREAD_lock_free(prov->refcnt_lock);
 #endif
@@ -780,6 +790,36 @@ const OSSL_ALGORITHM *ossl_provider_query_operation(const OSSL_PROVIDER *prov,
     return prov->query_operation(prov->provctx, operation_id, no_cache);
 }
 
+int ossl_provider_set_operation_bit(OSSL_PROVIDER *prov, size_t bitnum)
+{
+    size_t byte = bitnum / 8;
+    unsigned char bit = (unsigned char)(1 << (bitnum % 8));
+
+    if (byte >= sizeof(prov->operation_bits))
+        return 0;
+    if (!CRYPTO_THREAD_write_lock(prov->opbits_lock))
+        return 0;
+    prov->operation_bits[byte] |= bit;
+    CRYPTO_THREAD_unlock(prov->opbits_lock);
+    return 1;
+}
+
+int ossl_provider_test_operation_bit(OSSL_PROVIDER *prov, size_t bitnum,
+                                     int *result)
+{
+    size_t byte = bitnum / 8;
+    unsigned char bit = (unsigned char)(1 << (bitnum % 8));
+
+    *result = 0;
+    if (byte >= sizeof(prov->operation_bits))
+        return 1;
+    if (!CRYPTO_THREAD_read_lock(prov->opbits_lock))
+        return 0;
+    *result = (prov->operation_bits[byte] & bit) != 0;
+    CRYPTO_THREAD_unlock(prov->opbits_lock);
+    return 1;
+}
+
 /*-
  * Core functions for the provider
  * ===============================
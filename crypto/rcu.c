@@ -0,0 +1,191 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <string.h>
+#include <openssl/crypto.h>
+#include "internal/cryptlib.h"
+#include "internal/rcu.h"
+
+#if defined(OPENSSL_THREADS) && !defined(OPENSSL_DEV_NO_ATOMICS) \
+    && defined(__GNUC__) && defined(__ATOMIC_SEQ_CST)
+# define RCU_USE_ATOMICS
+#endif
+
+#ifdef RCU_USE_ATOMICS
+/*
+ * Readers are counted in slots, and each thread sticks to the slot picked by
+ * a hash of its thread id.  There are enough slots for threads not to have to
+ * share one most of the time, and each lives in a cache line of its own, so
+ * that readers don't bounce cache lines between CPUs.  Sharing a slot is
+ * harmless other than that.
+ *
+ * Each slot has two counters.  Readers count themselves in the one for the
+ * current phase.  A writer flips the phase and waits for the counters of the
+ * previous phase to drain, which new readers can't hold up.  Doing that twice
+ * also catches readers that picked up the phase just before a flip.
+ */
+# define RCU_SLOTS      64
+# define RCU_LINE       64
+
+typedef struct {
+    int count[2];
+    unsigned char pad[RCU_LINE - 2 * sizeof(int)];
+} RCU_SLOT;
+#endif
+
+struct ossl_rcu_lock_st {
+    CRYPTO_RWLOCK *lock;
+#ifdef RCU_USE_ATOMICS
+    int phase;
+    RCU_SLOT *slots;
+    void *slots_alloc;
+#endif
+};
+
+CRYPTO_RCU_LOCK *ossl_rcu_lock_new(void)
+{
+    CRYPTO_RCU_LOCK *lock = OPENSSL_zalloc(sizeof(*lock));
+
+    if (lock == NULL)
+        return NULL;
+    if ((lock->lock = CRYPTO_THREAD_lock_new()) == NULL) {
+        OPENSSL_free(lock);
+        return NULL;
+    }
+#ifdef RCU_USE_ATOMICS
+    lock->slots_alloc = OPENSSL_zalloc(sizeof(RCU_SLOT) * RCU_SLOTS + RCU_LINE);
+    if (lock->slots_alloc == NULL) {
+        CRYPTO_THREAD_lock_free(lock->lock);
+        OPENSSL_free(lock);
+        return NULL;
+    }
+    lock->slots = (RCU_SLOT *)(((size_t)lock->slots_alloc + RCU_LINE - 1)
+                               & ~(size_t)(RCU_LINE - 1));
+#endif
+    return lock;
+}
+
+void ossl_rcu_lock_free(CRYPTO_RCU_LOCK *lock)
+{
+    if (lock == NULL)
+        return;
+#ifdef RCU_USE_ATOMICS
+    OPENSSL_free(lock->slots_alloc);
+#endif
+    CRYPTO_THREAD_lock_free(lock->lock);
+    OPENSSL_free(lock);
+}
+
+#ifdef RCU_USE_ATOMICS
+/*
+ * The slot of the current thread.  This deliberately avoids a thread local
+ * key, of which there are only a few, so that any number of locks can exist.
+ */
+static size_t rcu_thread_slot(void)
+{
+    CRYPTO_THREAD_ID id = CRYPTO_THREAD_get_current_id();
+    uint64_t h = 0;
+
+    memcpy(&h, &id, sizeof(id) < sizeof(h) ? sizeof(id) : sizeof(h));
+    /* Fibonacci hashing, thread ids tend to differ in their middle bits */
+    return (size_t)((h * 0x9e3779b97f4a7c15ULL) >> 58) % RCU_SLOTS;
+}
+#endif
+
+/*
+ * Enter a read side critical section.  |*token| must be passed to the
+ * matching ossl_rcu_read_unlock().
+ */
+int ossl_rcu_read_lock(CRYPTO_RCU_LOCK *lock, int *token)
+{
+#ifdef RCU_USE_ATOMICS
+    size_t slot = rcu_thread_slot();
+    int phase;
+
+    phase = __atomic_load_n(&lock->phase, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&lock->slots[slot].count[phase], 1, __ATOMIC_RELAXED);
+    /* Pairs with the fences in ossl_synchronize_rcu() */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    *token = (int)slot * 2 + phase;
+    return 1;
+#else
+    *token = 0;
+    return CRYPTO_THREAD_read_lock(lock->lock);
+#endif
+}
+
+void ossl_rcu_read_unlock(CRYPTO_RCU_LOCK *lock, int token)
+{
+#ifdef RCU_USE_ATOMICS
+    __atomic_fetch_sub(&lock->slots[token / 2].count[token % 2], 1,
+                       __ATOMIC_RELEASE);
+#else
+    CRYPTO_THREAD_unlock(lock->lock);
+#endif
+}
+
+/* Writers must hold the write lock while updating and synchronising */
+int ossl_rcu_write_lock(CRYPTO_RCU_LOCK *lock)
+{
+    return CRYPTO_THREAD_write_lock(lock->lock);
+}
+
+void ossl_rcu_write_unlock(CRYPTO_RCU_LOCK *lock)
+{
+    CRYPTO_THREAD_unlock(lock->lock);
+}
+
+#ifdef RCU_USE_ATOMICS
+static void rcu_flip_and_wait(CRYPTO_RCU_LOCK *lock)
+{
+    int old = __atomic_load_n(&lock->phase, __ATOMIC_RELAXED);
+    size_t i;
+
+    __atomic_store_n(&lock->phase, !old, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    for (i = 0; i < RCU_SLOTS; i++)
+        while (__atomic_load_n(&lock->slots[i].count[old],
+                               __ATOMIC_ACQUIRE) != 0)
+            continue;
+}
+#endif
+
+/*
+ * Wait until every reader that might have seen data replaced before this
+ * call has left its read side critical section.  The write lock must be
+ * held.
+ */
+void ossl_synchronize_rcu(CRYPTO_RCU_LOCK *lock)
+{
+#ifdef RCU_USE_ATOMICS
+    /* Order the updates of the caller before looking at the readers */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    rcu_flip_and_wait(lock);
+    rcu_flip_and_wait(lock);
+#endif
+    /* Without atomics, holding the write lock already excludes readers */
+}
+
+void *ossl_rcu_deref(void **p)
+{
+#ifdef RCU_USE_ATOMICS
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#else
+    return *p;
+#endif
+}
+
+void ossl_rcu_assign_ptr(void **p, void *v)
+{
+#ifdef RCU_USE_ATOMICS
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+#else
+    *p = v;
+#endif
+}
@@ -418,7 +418,7 @@ void OSSL_SERIALIZER_do_all_provided(OPENSSL_CTX *libctx,
     data.user_fn = (void (*)(void *, void *))fn;
     data.user_arg = arg;
     ossl_algorithm_do_all(libctx, OSSL_OP_SERIALIZER, NULL,
-                          serializer_do_one, &data);
+                          NULL, serializer_do_one, NULL, &data);
 }
 
 void OSSL_SERIALIZER_names_do_all(const OSSL_SERIALIZER *ser,
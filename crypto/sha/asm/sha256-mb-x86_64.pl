@@ -60,12 +60,13 @@ $avx=0;
 
 if (`$ENV{CC} -Wa,-v -c -o /dev/null -x assembler /dev/null 2>&1`
 		=~ /GNU assembler version ([2-9]\.[0-9]+)/) {
-	$avx = ($1>=2.19) + ($1>=2.22);
+	$avx = ($1>=2.19) + ($1>=2.22) + ($1>=2.25);
 }
 
 if (!$avx && $win64 && ($flavour =~ /nasm/ || $ENV{ASM} =~ /nasm/) &&
-	   `nasm -v 2>&1` =~ /NASM version ([2-9]\.[0-9]+)/) {
-	$avx = ($1>=2.09) + ($1>=2.10);
+	   `nasm -v 2>&1` =~ /NASM version ([2-9]\.[0-9]+)(?:\.([0-9]+))?/) {
+	$avx = ($1>=2.09) + ($1>=2.10) + ($1>=2.12);
+	$avx += 1 if ($1==2.11 && $2>=8);
 }
 
 if (!$avx && $win64 && ($flavour =~ /masm/ || $ENV{ASM} =~ /ml64/) &&
@@ -312,7 +313,7 @@ ___
 }
 $code.=<<___;
 	test	$num,$num
-	jz	.Ldone
+	jz	.Lnext_grande		# skip idle lanes
 
 	movdqu	0x00-0x80($ctx),$A		# load context
 	 lea	128(%rsp),%rax
@@ -399,6 +400,7 @@ $code.=<<___;
 	dec	$num
 	jnz	.Loop
 
+.Lnext_grande:
 	mov	`$REG_SZ*17+8`(%rsp),$num
 	lea	$REG_SZ($ctx),$ctx
 	lea	`$inp_elm_size*$REG_SZ/4`($inp),$inp
@@ -494,7 +496,7 @@ ___
 }
 $code.=<<___;
 	test	$num,$num
-	jz	.Ldone_shaext
+	jz	.Lnext_grande_shaext	# skip idle lanes
 
 	movq		0x00-0x80($ctx),$ABEF0		# A1.A0
 	movq		0x20-0x80($ctx),@MSG0[0]	# B1.B0
@@ -736,8 +738,6 @@ $code.=<<___;
 	dec		$num
 	jnz		.Loop_shaext
 
-	mov		`$REG_SZ*17+8`(%rsp),$num
-
 	pshufd		\$0b00011011,$ABEF0,$ABEF0
 	pshufd		\$0b00011011,$CDGH0,$CDGH0
 	pshufd		\$0b00011011,$ABEF1,$ABEF1
@@ -764,6 +764,8 @@ $code.=<<___;
 	movq		$CDGH0,0x60-0x80($ctx)		# D1.D0
 	movq		@MSG0[1],0xe0-0x80($ctx)	# H1.H0
 
+.Lnext_grande_shaext:
+	mov	`$REG_SZ*17+8`(%rsp),$num
 	lea	`$REG_SZ/2`($ctx),$ctx
 	lea	`$inp_elm_size*2`($inp),$inp
 	dec	$num
@@ -1017,7 +1019,7 @@ ___
 }
 $code.=<<___;
 	test	$num,$num
-	jz	.Ldone_avx
+	jz	.Lnext_grande_avx		# skip idle lanes
 
 	vmovdqu	0x00-0x80($ctx),$A		# load context
 	 lea	128(%rsp),%rax
@@ -1102,6 +1104,7 @@ $code.=<<___;
 	dec	$num
 	jnz	.Loop_avx
 
+.Lnext_grande_avx:
 	mov	`$REG_SZ*17+8`(%rsp),$num
 	lea	$REG_SZ($ctx),$ctx
 	lea	`$inp_elm_size*$REG_SZ/4`($inp),$inp
@@ -1339,6 +1342,227 @@ $code.=<<___;
 .size	sha256_multi_block_avx2,.-sha256_multi_block_avx2
 ___
 					}	}}}
+						if ($avx>2) {{{
+######################################################################
+#
+# int sha256_multi_block_avx512(SHA256_MB_CTX ctx[2], const HASH_DESC inp[16]);
+#
+# 16 lanes, one per 32-bit element of a %zmm register, with the rotates
+# and three-input boolean functions done by vprord and vpternlogd.  Lanes
+# 0-7 are in ctx[0] and lanes 8-15 in ctx[1], which is the layout two
+# calls to sha256_multi_block(ctx, inp, 2) would use.  Input words are
+# gathered with one vpgatherqd per 8 lanes.  Returns 0 without doing
+# anything if the processor doesn't do AVX512F and AVX512BW.
+
+my @W=map("%zmm$_",(0..15));
+my @V=my ($A,$B,$C,$D,$E,$F,$G,$H)=map("%zmm$_",(16..23));
+my ($T1,$T2,$T3,$BSWAP,$P0,$P1,$CNT)=map("%zmm$_",(24..30));
+my ($T1y,$T2y,$BSWAPy)=map("%ymm$_",(24,25,27));
+my $hi=8*8*4;					# offset of ctx[1]
+
+sub ROUND_00_15_avx512 {
+my ($i,$a,$b,$c,$d,$e,$f,$g,$h)=@_;
+my $Wi=$W[$i%16];
+(my $Wy=$Wi)=~s/zmm/ymm/;
+(my $T3y=$T3)=~s/zmm/ymm/;
+
+$code.=<<___ if ($i<16);
+	kxnorw		%k2,%k2,%k2
+	kxnorw		%k3,%k3,%k3
+	vpgatherqd	`4*$i`(,$P0,1),$Wy\{%k2\}
+	vpgatherqd	`4*$i`(,$P1,1),$T3y\{%k3\}
+	vinserti64x4	\$1,$T3y,$Wi,$Wi
+	vpshufb		$BSWAP,$Wi,$Wi
+___
+$code.=<<___;
+	vpbroadcastd	`32*$i`($Tbl),$T3
+	vpaddd		$Wi,$T3,$T3			# W[i]+K[i]
+	vprord		\$6,$e,$T1
+	vprord		\$11,$e,$T2
+	vpaddd		$T3,$h,$h
+	vprord		\$25,$e,$T3
+	vpternlogd	\$0x96,$T3,$T2,$T1		# Sigma1(e)
+	vmovdqa32	$e,$T2
+	vpternlogd	\$0xca,$g,$f,$T2		# Ch(e,f,g)
+	vpaddd		$T1,$h,$h
+	vprord		\$2,$a,$T1
+	vpaddd		$T2,$h,$h			# h=T1
+	vprord		\$13,$a,$T2
+	vpaddd		$h,$d,$d			# d+=T1
+	vprord		\$22,$a,$T3
+	vpternlogd	\$0x96,$T3,$T2,$T1		# Sigma0(a)
+	vmovdqa32	$a,$T2
+	vpternlogd	\$0xe8,$c,$b,$T2		# Maj(a,b,c)
+	vpaddd		$T1,$h,$h
+	vpaddd		$T2,$h,$h			# h=T1+T2
+___
+}
+
+sub ROUND_16_XX_avx512 {
+my $i=shift;
+my ($Wi,$W1,$W9,$W14)=map($W[($i+$_)%16],(0,1,9,14));
+
+$code.=<<___;
+	vprord		\$7,$W1,$T1
+	vprord		\$18,$W1,$T2
+	vpsrld		\$3,$W1,$T3
+	vpaddd		$W9,$Wi,$Wi			# W[i]+=W[i+9]
+	vpternlogd	\$0x96,$T3,$T2,$T1		# sigma0(W[i+1])
+	vprord		\$17,$W14,$T2
+	vpaddd		$T1,$Wi,$Wi
+	vprord		\$19,$W14,$T1
+	vpsrld		\$10,$W14,$T3
+	vpternlogd	\$0x96,$T3,$T2,$T1		# sigma1(W[i+14])
+	vpaddd		$T1,$Wi,$Wi
+___
+	&ROUND_00_15_avx512($i,@_);
+}
+
+$code.=<<___;
+.globl	sha256_multi_block_avx512
+.type	sha256_multi_block_avx512,\@function,2
+.align	32
+sha256_multi_block_avx512:
+.cfi_startproc
+	mov	OPENSSL_ia32cap_P+8(%rip),%ecx
+	and	\$`1<<16|1<<30`,%ecx		# AVX512F and AVX512BW
+	cmp	\$`1<<16|1<<30`,%ecx
+	je	.Lavx512
+	xor	%eax,%eax
+	ret
+.align	32
+.Lavx512:
+	mov	%rsp,%rax
+.cfi_def_cfa_register	%rax
+	push	%rbx
+.cfi_push	%rbx
+	push	%rbp
+.cfi_push	%rbp
+___
+$code.=<<___ if ($win64);
+	lea	-0xa8(%rsp),%rsp
+	movaps	%xmm6,(%rsp)
+	movaps	%xmm7,0x10(%rsp)
+	movaps	%xmm8,0x20(%rsp)
+	movaps	%xmm9,0x30(%rsp)
+	movaps	%xmm10,-0x78(%rax)
+	movaps	%xmm11,-0x68(%rax)
+	movaps	%xmm12,-0x58(%rax)
+	movaps	%xmm13,-0x48(%rax)
+	movaps	%xmm14,-0x38(%rax)
+	movaps	%xmm15,-0x28(%rax)
+___
+$code.=<<___;
+	sub	\$`16*18`,%rsp
+	and	\$-64,%rsp
+	mov	%rax,`16*17`(%rsp)		# original %rsp
+.cfi_cfa_expression	%rsp+`16*17`,deref,+8
+.Lbody_avx512:
+	lea	K256(%rip),$Tbl
+___
+for($i=0;$i<16;$i++) {
+    $ptr_reg=&pointer_register($flavour,"%r8");
+    $code.=<<___;
+	mov	`$inp_elm_size*$i+0`($inp),$ptr_reg
+	mov	`$inp_elm_size*$i+$ptr_size`($inp),%ecx
+	test	%ecx,%ecx
+	cmovle	$Tbl,%r8			# cancel input
+	mov	%r8,`8*$i`(%rsp)
+	mov	%ecx,`128+4*$i`(%rsp)
+___
+}
+$code.=<<___;
+	vpxord		$T1,$T1,$T1
+	vmovdqu64	0x00(%rsp),$P0			# input pointers
+	vmovdqu64	0x40(%rsp),$P1
+	vpmaxsd		0x80(%rsp),$T1,$CNT		# block counters
+	vmovdqu32	.Lpbswap(%rip),$BSWAPy
+	vinserti64x4	\$1,$BSWAPy,$BSWAP,$BSWAP
+___
+for($i=0;$i<8;$i++) {
+    (my $Vy=$V[$i])=~s/zmm/ymm/;
+    $code.=<<___;
+	vmovdqu32	`32*$i`($ctx),$Vy
+	vmovdqu32	`$hi+32*$i`($ctx),$T2y
+	vinserti64x4	\$1,$T2y,$V[$i],$V[$i]
+___
+}
+$code.=<<___;
+	jmp	.Loop_avx512
+
+.align	32
+.Loop_avx512:
+	vptestmd	$CNT,$CNT,%k1			# lanes still active
+	kortestw	%k1,%k1
+	jz		.Ldone_avx512
+___
+for($i=0;$i<16;$i++)	{ &ROUND_00_15_avx512($i,@V); unshift(@V,pop(@V)); }
+for(;$i<64;$i++)	{ &ROUND_16_XX_avx512($i,@V); unshift(@V,pop(@V)); }
+for($i=0;$i<8;$i++) {
+    $code.=<<___;
+	vmovdqu32	`32*$i`($ctx),$T1y
+	vmovdqu32	`$hi+32*$i`($ctx),$T2y
+	vinserti64x4	\$1,$T2y,$T1,$T1
+	vpaddd		$V[$i],$T1,${T1}\{%k1\}	# feed-forward active lanes
+	vextracti64x4	\$1,$T1,$T2y
+	vmovdqu32	$T1y,`32*$i`($ctx)
+	vmovdqu32	$T2y,`$hi+32*$i`($ctx)
+	vmovdqa32	$T1,$V[$i]
+___
+}
+$code.=<<___;
+	vpternlogd	\$0xff,$T1,$T1,$T1
+	mov		\$64,%ecx
+	vpaddd		$T1,$CNT,${CNT}\{%k1\}		# counters--
+	vpbroadcastq	%rcx,$T2
+	vpaddq		$T2,$P0,$P0
+	vpaddq		$T2,$P1,$P1
+	vptestnmd	$CNT,$CNT,%k2			# lanes done
+	kshiftrw	\$8,%k2,%k3
+	vpbroadcastq	$Tbl,${P0}\{%k2\}		# cancel input
+	vpbroadcastq	$Tbl,${P1}\{%k3\}
+	jmp		.Loop_avx512
+
+.Ldone_avx512:
+	mov	`16*17`(%rsp),%rax		# original %rsp
+.cfi_def_cfa	%rax,8
+	vzeroupper
+___
+$code.=<<___ if ($win64);
+	movaps	-0xb8(%rax),%xmm6
+	movaps	-0xa8(%rax),%xmm7
+	movaps	-0x98(%rax),%xmm8
+	movaps	-0x88(%rax),%xmm9
+	movaps	-0x78(%rax),%xmm10
+	movaps	-0x68(%rax),%xmm11
+	movaps	-0x58(%rax),%xmm12
+	movaps	-0x48(%rax),%xmm13
+	movaps	-0x38(%rax),%xmm14
+	movaps	-0x28(%rax),%xmm15
+___
+$code.=<<___;
+	mov	-16(%rax),%rbp
+.cfi_restore	%rbp
+	mov	-8(%rax),%rbx
+.cfi_restore	%rbx
+	lea	(%rax),%rsp
+.cfi_def_cfa_register	%rsp
+	mov	\$1,%eax
+.Lepilogue_avx512:
+	ret
+.cfi_endproc
+.size	sha256_multi_block_avx512,.-sha256_multi_block_avx512
+___
+						}}} else {
+$code.=<<___;
+.globl	sha256_multi_block_avx512
+.type	sha256_multi_block_avx512,\@abi-omnipotent
+sha256_multi_block_avx512:
+	xor	%eax,%eax
+	ret
+.size	sha256_multi_block_avx512,.-sha256_multi_block_avx512
+___
+						}
 $code.=<<___;
 .align	256
 K256:
@@ -1561,6 +1785,11 @@ $code.=<<___ if ($avx>1);
 	.rva	.LSEH_end_sha256_multi_block_avx2
 	.rva	.LSEH_info_sha256_multi_block_avx2
 ___
+$code.=<<___ if ($avx>2);
+	.rva	.LSEH_begin_sha256_multi_block_avx512
+	.rva	.LSEH_end_sha256_multi_block_avx512
+	.rva	.LSEH_info_sha256_multi_block_avx512
+___
 $code.=<<___;
 .section	.xdata
 .align	8
@@ -1585,6 +1814,12 @@ $code.=<<___ if ($avx>1);
 	.rva	avx2_handler
 	.rva	.Lbody_avx2,.Lepilogue_avx2		# HandlerData[]
 ___
+$code.=<<___ if ($avx>2);
+.LSEH_info_sha256_multi_block_avx512:
+	.byte	9,0,0,0
+	.rva	se_handler
+	.rva	.Lbody_avx512,.Lepilogue_avx512		# HandlerData[]
+___
 }
 ####################################################################
 
@@ -0,0 +1,280 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <string.h>
+#include <openssl/crypto.h>
+#include "internal/sha3.h"
+
+/*
+ * Keccak-p[1600] sponges with a given number of rounds, such as the 12 of
+ * TurboSHAKE and KangarooTwelve, and the hashing of many leaves of a tree
+ * hash at once.  The states here are plain arrays of lanes, A[y][x], which
+ * isn't necessarily the layout SHA3_absorb() keeps them in, so the two must
+ * not be mixed.
+ */
+
+void SHA3_squeeze(uint64_t A[5][5], unsigned char *out, size_t len, size_t r);
+
+static const unsigned char rhotates[5][5] = {
+    {  0,  1, 62, 28, 27 },
+    { 36, 44,  6, 55, 20 },
+    {  3, 10, 43, 25, 39 },
+    { 41, 45, 15, 21,  8 },
+    { 18,  2, 61, 56, 14 }
+};
+
+static const uint64_t iotas[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+    0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+static uint64_t ROL64(uint64_t val, int offset)
+{
+    return offset == 0 ? val : (val << offset) | (val >> (64 - offset));
+}
+
+/* The KECCAK_1X round of keccak1600.c */
+static void Round(uint64_t A[5][5], size_t i)
+{
+    uint64_t C[5], D[5], T[2][5];
+
+    C[0] = A[0][0] ^ A[1][0] ^ A[2][0] ^ A[3][0] ^ A[4][0];
+    C[1] = A[0][1] ^ A[1][1] ^ A[2][1] ^ A[3][1] ^ A[4][1];
+    C[2] = A[0][2] ^ A[1][2] ^ A[2][2] ^ A[3][2] ^ A[4][2];
+    C[3] = A[0][3] ^ A[1][3] ^ A[2][3] ^ A[3][3] ^ A[4][3];
+    C[4] = A[0][4] ^ A[1][4] ^ A[2][4] ^ A[3][4] ^ A[4][4];
+
+    D[0] = ROL64(C[1], 1) ^ C[4];
+    D[1] = ROL64(C[2], 1) ^ C[0];
+    D[2] = ROL64(C[3], 1) ^ C[1];
+    D[3] = ROL64(C[4], 1) ^ C[2];
+    D[4] = ROL64(C[0], 1) ^ C[3];
+
+    T[0][0] = A[3][0] ^ D[0];
+    T[0][1] = A[0][1] ^ D[1];
+    T[0][2] = A[0][2] ^ D[2];
+    T[0][3] = A[0][3] ^ D[3];
+    T[0][4] = A[0][4] ^ D[4];
+
+    C[0] =       A[0][0] ^ D[0];
+    C[1] = ROL64(A[1][1] ^ D[1], rhotates[1][1]);
+    C[2] = ROL64(A[2][2] ^ D[2], rhotates[2][2]);
+    C[3] = ROL64(A[3][3] ^ D[3], rhotates[3][3]);
+    C[4] = ROL64(A[4][4] ^ D[4], rhotates[4][4]);
+
+    A[0][0] = C[0] ^ (~C[1] & C[2]) ^ iotas[i];
+    A[0][1] = C[1] ^ (~C[2] & C[3]);
+    A[0][2] = C[2] ^ (~C[3] & C[4]);
+    A[0][3] = C[3] ^ (~C[4] & C[0]);
+    A[0][4] = C[4] ^ (~C[0] & C[1]);
+
+    T[1][0] = A[1][0] ^ D[0];
+    T[1][1] = A[2][1] ^ D[1];
+    T[1][2] = A[1][2] ^ D[2];
+    T[1][3] = A[1][3] ^ D[3];
+    T[1][4] = A[2][4] ^ D[4];
+
+    C[0] = ROL64(T[0][3],        rhotates[0][3]);
+    C[1] = ROL64(A[1][4] ^ D[4], rhotates[1][4]);
+    C[2] = ROL64(A[2][0] ^ D[0], rhotates[2][0]);
+    C[3] = ROL64(A[3][1] ^ D[1], rhotates[3][1]);
+    C[4] = ROL64(A[4][2] ^ D[2], rhotates[4][2]);
+
+    A[1][0] = C[0] ^ (~C[1] & C[2]);
+    A[1][1] = C[1] ^ (~C[2] & C[3]);
+    A[1][2] = C[2] ^ (~C[3] & C[4]);
+    A[1][3] = C[3] ^ (~C[4] & C[0]);
+    A[1][4] = C[4] ^ (~C[0] & C[1]);
+
+    C[0] = ROL64(T[0][1],        rhotates[0][1]);
+    C[1] = ROL64(T[1][2],        rhotates[1][2]);
+    C[2] = ROL64(A[2][3] ^ D[3], rhotates[2][3]);
+    C[3] = ROL64(A[3][4] ^ D[4], rhotates[3][4]);
+    C[4] = ROL64(A[4][0] ^ D[0], rhotates[4][0]);
+
+    A[2][0] = C[0] ^ (~C[1] & C[2]);
+    A[2][1] = C[1] ^ (~C[2] & C[3]);
+    A[2][2] = C[2] ^ (~C[3] & C[4]);
+    A[2][3] = C[3] ^ (~C[4] & C[0]);
+    A[2][4] = C[4] ^ (~C[0] & C[1]);
+
+    C[0] = ROL64(T[0][4],        rhotates[0][4]);
+    C[1] = ROL64(T[1][0],        rhotates[1][0]);
+    C[2] = ROL64(T[1][1],        rhotates[2][1]);
+    C[3] = ROL64(A[3][2] ^ D[2], rhotates[3][2]);
+    C[4] = ROL64(A[4][3] ^ D[3], rhotates[4][3]);
+
+    A[3][0] = C[0] ^ (~C[1] & C[2]);
+    A[3][1] = C[1] ^ (~C[2] & C[3]);
+    A[3][2] = C[2] ^ (~C[3] & C[4]);
+    A[3][3] = C[3] ^ (~C[4] & C[0]);
+    A[3][4] = C[4] ^ (~C[0] & C[1]);
+
+    C[0] = ROL64(T[0][2],        rhotates[0][2]);
+    C[1] = ROL64(T[1][3],        rhotates[1][3]);
+    C[2] = ROL64(T[1][4],        rhotates[2][4]);
+    C[3] = ROL64(T[0][0],        rhotates[3][0]);
+    C[4] = ROL64(A[4][1] ^ D[1], rhotates[4][1]);
+
+    A[4][0] = C[0] ^ (~C[1] & C[2]);
+    A[4][1] = C[1] ^ (~C[2] & C[3]);
+    A[4][2] = C[2] ^ (~C[3] & C[4]);
+    A[4][3] = C[3] ^ (~C[4] & C[0]);
+    A[4][4] = C[4] ^ (~C[0] & C[1]);
+}
+
+/* The last |rounds| rounds of Keccak-f[1600] */
+static void KeccakP1600(uint64_t A[5][5], size_t rounds)
+{
+    size_t i;
+
+    for (i = 24 - rounds; i < 24; i++)
+        Round(A, i);
+}
+
+size_t ossl_keccak1600_absorb(uint64_t A[5][5], const unsigned char *inp,
+                              size_t len, size_t r, size_t rounds)
+{
+    uint64_t *A_flat = (uint64_t *)A;
+    size_t i, w = r / 8;
+
+    while (len >= r) {
+        for (i = 0; i < w; i++, inp += 8)
+            A_flat[i] ^= (uint64_t)inp[0]       | (uint64_t)inp[1] << 8  |
+                         (uint64_t)inp[2] << 16 | (uint64_t)inp[3] << 24 |
+                         (uint64_t)inp[4] << 32 | (uint64_t)inp[5] << 40 |
+                         (uint64_t)inp[6] << 48 | (uint64_t)inp[7] << 56;
+        KeccakP1600(A, rounds);
+        len -= r;
+    }
+
+    return len;
+}
+
+void ossl_keccak1600_squeeze(uint64_t A[5][5], unsigned char *out, size_t len,
+                             size_t r, size_t rounds)
+{
+    const uint64_t *A_flat = (const uint64_t *)A;
+    size_t i;
+
+    for (;;) {
+        for (i = 0; i < r && len != 0; i++, len--)
+            *out++ = (unsigned char)(A_flat[i / 8] >> (8 * (i % 8)));
+        if (len == 0)
+            break;
+        KeccakP1600(A, rounds);
+    }
+}
+
+/* Sets up the final block of a message with |rem| bytes left over */
+static void keccak1600_pad(unsigned char *block, const unsigned char *rest,
+                           size_t rem, size_t r, unsigned char pad)
+{
+    memcpy(block, rest, rem);
+    memset(block + rem, 0, r - rem);
+    block[rem] = pad;
+    block[r - 1] |= 0x80;
+}
+
+static void keccak1600_hash1(unsigned char *out, size_t outlen,
+                             const unsigned char *inp, size_t len,
+                             size_t r, unsigned char pad, size_t rounds)
+{
+    uint64_t A[5][5];
+    unsigned char block[KECCAK1600_WIDTH / 8 - 32];
+    size_t rem;
+
+    memset(A, 0, sizeof(A));
+    if (rounds == 24) {
+        /* The platform's own SHA-3 code, with its own layout of A */
+        rem = SHA3_absorb(A, inp, len, r);
+        keccak1600_pad(block, inp + len - rem, rem, r, pad);
+        (void)SHA3_absorb(A, block, r, r);
+        SHA3_squeeze(A, out, outlen, r);
+    } else {
+        rem = ossl_keccak1600_absorb(A, inp, len, r, rounds);
+        keccak1600_pad(block, inp + len - rem, rem, r, pad);
+        (void)ossl_keccak1600_absorb(A, block, r, r, rounds);
+        ossl_keccak1600_squeeze(A, out, outlen, r, rounds);
+    }
+    OPENSSL_cleanse(A, sizeof(A));
+    OPENSSL_cleanse(block, sizeof(block));
+}
+
+#if defined(KECCAK1600_ASM) && (defined(__x86_64) || defined(__x86_64__) \
+                                || defined(_M_AMD64) || defined(_M_X64))
+# define KECCAK1600_X8
+
+int keccak1600_absorb_x8_avx512(uint64_t A[25][8],
+                                const unsigned char *const inp[8],
+                                size_t blocks, size_t bsz, size_t rounds);
+
+/*
+ * Hashes up to 8 messages in the lanes of the AVX-512 code, or returns 0 if
+ * the processor can't run it.  Lanes past |num| hash the first message
+ * again, and are thrown away.
+ */
+static int keccak1600_hash_x8(unsigned char *out, size_t outlen,
+                              const unsigned char *inp, size_t len,
+                              size_t num, size_t r, unsigned char pad,
+                              size_t rounds)
+{
+    uint64_t A[25][8];
+    unsigned char block[8][KECCAK1600_WIDTH / 8 - 32];
+    const unsigned char *ptr[8];
+    size_t i, j, rem = len % r;
+
+    memset(A, 0, sizeof(A));
+    for (j = 0; j < 8; j++)
+        ptr[j] = inp + (j < num ? j : 0) * len;
+    if (!keccak1600_absorb_x8_avx512(A, ptr, len / r, r, rounds))
+        return 0;
+
+    for (j = 0; j < 8; j++) {
+        keccak1600_pad(block[j], ptr[j] + len - rem, rem, r, pad);
+        ptr[j] = block[j];
+    }
+    (void)keccak1600_absorb_x8_avx512(A, ptr, 1, r, rounds);
+
+    for (j = 0; j < num; j++, out += outlen)
+        for (i = 0; i < outlen; i++)
+            out[i] = (unsigned char)(A[i / 8][j] >> (8 * (i % 8)));
+
+    OPENSSL_cleanse(A, sizeof(A));
+    OPENSSL_cleanse(block, sizeof(block));
+    return 1;
+}
+#endif
+
+void ossl_keccak1600_hash_many(unsigned char *out, size_t outlen,
+                               const unsigned char *inp, size_t len,
+                               size_t num, size_t r, unsigned char pad,
+                               size_t rounds)
+{
+#ifdef KECCAK1600_X8
+    /* A lone message is as quick on its own */
+    while (num >= 2) {
+        size_t n = num < 8 ? num : 8;
+
+        if (!keccak1600_hash_x8(out, outlen, inp, len, n, r, pad, rounds))
+            break;
+        out += n * outlen;
+        inp += n * len;
+        num -= n;
+    }
+#endif
+    for (; num > 0; num--, out += outlen, inp += len)
+        keccak1600_hash1(out, outlen, inp, len, r, pad, rounds);
+}
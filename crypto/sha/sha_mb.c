@@ -0,0 +1,320 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * SHA low level APIs are deprecated for public use, but still ok for
+ * internal use.
+ */
+#include "internal/deprecated.h"
+
+#include <limits.h>
+#include <string.h>
+#include <openssl/crypto.h>
+#include <openssl/sha.h>
+#include "crypto/sha.h"
+
+/*
+ * Digests of many independent messages at once.  Where the multi-buffer
+ * assembler is available, up to 16 messages are hashed in parallel, one per
+ * SIMD lane; elsewhere the messages are simply hashed one after the other.
+ */
+
+#if defined(SHA256_ASM) && (defined(__x86_64) || defined(__x86_64__) \
+                            || defined(_M_AMD64) || defined(_M_X64))
+
+# define MB_LANES        16
+# define MB_MAX_WORDS    8
+
+typedef struct {
+    const unsigned char *ptr;
+    int blocks;
+} HASH_DESC;
+
+/*
+ * The state of lane i is in ctx[i / 8], as {A[8], B[8], ...}, which is what
+ * the assembler expects.
+ */
+typedef struct {
+    unsigned int A[8], B[8], C[8], D[8], E[8];
+} SHA1_MB_CTX;
+
+typedef struct {
+    unsigned int A[8], B[8], C[8], D[8], E[8], F[8], G[8], H[8];
+} SHA256_MB_CTX;
+
+void sha1_multi_block(SHA1_MB_CTX *, const HASH_DESC *, int);
+int sha1_multi_block_avx512(SHA1_MB_CTX *, const HASH_DESC *);
+void sha1_block_data_order(SHA_CTX *c, const void *p, size_t num);
+void sha256_multi_block(SHA256_MB_CTX *, const HASH_DESC *, int);
+int sha256_multi_block_avx512(SHA256_MB_CTX *, const HASH_DESC *);
+void sha256_block_data_order(SHA256_CTX *ctx, const void *in, size_t num);
+
+static void sha1_mb16(unsigned int *st, const HASH_DESC *inp)
+{
+    SHA1_MB_CTX *ctx = (SHA1_MB_CTX *)st;
+
+    if (!sha1_multi_block_avx512(ctx, inp)) {
+        sha1_multi_block(&ctx[0], inp, 2);
+        sha1_multi_block(&ctx[1], inp + 8, 2);
+    }
+}
+
+static void sha1_block1(unsigned int *h, const unsigned char *in, size_t num)
+{
+    SHA_CTX c;
+
+    c.h0 = h[0];
+    c.h1 = h[1];
+    c.h2 = h[2];
+    c.h3 = h[3];
+    c.h4 = h[4];
+    sha1_block_data_order(&c, in, num);
+    h[0] = c.h0;
+    h[1] = c.h1;
+    h[2] = c.h2;
+    h[3] = c.h3;
+    h[4] = c.h4;
+}
+
+static void sha256_mb16(unsigned int *st, const HASH_DESC *inp)
+{
+    SHA256_MB_CTX *ctx = (SHA256_MB_CTX *)st;
+
+    if (!sha256_multi_block_avx512(ctx, inp)) {
+        sha256_multi_block(&ctx[0], inp, 2);
+        sha256_multi_block(&ctx[1], inp + 8, 2);
+    }
+}
+
+static void sha256_block1(unsigned int *h, const unsigned char *in,
+                          size_t num)
+{
+    SHA256_CTX c;
+
+    memcpy(c.h, h, sizeof(c.h));
+    sha256_block_data_order(&c, in, num);
+    memcpy(h, c.h, sizeof(c.h));
+}
+
+typedef struct {
+    size_t words;               /* of state */
+    size_t mdlen;
+    const unsigned int *iv;
+    void (*mb16)(unsigned int *st, const HASH_DESC *inp);
+    void (*block1)(unsigned int *h, const unsigned char *in, size_t num);
+} SHA_MB_METHOD;
+
+static const unsigned int sha1_iv[5] = {
+    0x67452301U, 0xefcdab89U, 0x98badcfeU, 0x10325476U, 0xc3d2e1f0U
+};
+static const unsigned int sha224_iv[8] = {
+    0xc1059ed8U, 0x367cd507U, 0x3070dd17U, 0xf70e5939U,
+    0xffc00b31U, 0x68581511U, 0x64f98fa7U, 0xbefa4fa4U
+};
+static const unsigned int sha256_iv[8] = {
+    0x6a09e667U, 0xbb67ae85U, 0x3c6ef372U, 0xa54ff53aU,
+    0x510e527fU, 0x9b05688cU, 0x1f83d9abU, 0x5be0cd19U
+};
+
+static const SHA_MB_METHOD sha1_mb = {
+    5, SHA_DIGEST_LENGTH, sha1_iv, sha1_mb16, sha1_block1
+};
+static const SHA_MB_METHOD sha224_mb = {
+    8, SHA224_DIGEST_LENGTH, sha224_iv, sha256_mb16, sha256_block1
+};
+static const SHA_MB_METHOD sha256_mb = {
+    8, SHA256_DIGEST_LENGTH, sha256_iv, sha256_mb16, sha256_block1
+};
+
+typedef struct {
+    size_t msg;                 /* index of the message, or num if idle */
+    const unsigned char *ptr;   /* next block to hash */
+    size_t blocks;              /* left to hash at |ptr| */
+    int padded;                 /* |ptr| points at |pad| */
+    unsigned char pad[2 * SHA_CBLOCK];
+} SHA_MB_LANE;
+
+/* Sets up the one or two final blocks of |len| bytes of |in| */
+static void lane_pad(SHA_MB_LANE *lane, const unsigned char *in, size_t len)
+{
+    size_t rem = len % SHA_CBLOCK;
+    uint64_t bits = (uint64_t)len << 3;
+    size_t n = rem < SHA_CBLOCK - 8 ? SHA_CBLOCK : 2 * SHA_CBLOCK;
+    int i;
+
+    memcpy(lane->pad, in + len - rem, rem);
+    lane->pad[rem] = 0x80;
+    memset(lane->pad + rem + 1, 0, n - rem - 1 - 8);
+    for (i = 0; i < 8; i++)
+        lane->pad[n - 1 - i] = (unsigned char)(bits >> (8 * i));
+    lane->ptr = lane->pad;
+    lane->blocks = n / SHA_CBLOCK;
+    lane->padded = 1;
+}
+
+static void lane_output(const SHA_MB_METHOD *meth, const unsigned int *h,
+                        unsigned char *md)
+{
+    size_t i;
+
+    for (i = 0; i < meth->mdlen / 4; i++, md += 4) {
+        md[0] = (unsigned char)(h[i] >> 24);
+        md[1] = (unsigned char)(h[i] >> 16);
+        md[2] = (unsigned char)(h[i] >> 8);
+        md[3] = (unsigned char)h[i];
+    }
+}
+
+/* Idle lanes point here so that the SIMD code never sees a wild pointer */
+static const unsigned char idle_block[SHA_CBLOCK];
+
+static int sha_digest_many(const SHA_MB_METHOD *meth, size_t num,
+                           const unsigned char *const in[],
+                           const size_t inl[], unsigned char *const out[])
+{
+    unsigned int st[2 * MB_MAX_WORDS * 8], h[MB_MAX_WORDS];
+    SHA_MB_LANE lane[MB_LANES];
+    HASH_DESC desc[MB_LANES];
+    size_t next = 0, active = 0, step, i, w;
+
+/* Word |w| of the state of lane |i| */
+# define ST(i, w)   st[((i) / 8 * meth->words + (w)) * 8 + (i) % 8]
+
+    for (i = 0; i < MB_LANES; i++) {
+        lane[i].msg = num;
+        lane[i].ptr = idle_block;
+        lane[i].blocks = 0;
+        lane[i].padded = 0;
+    }
+
+    for (;;) {
+        /* Start the next messages on idle lanes */
+        for (i = 0; i < MB_LANES && next < num; i++) {
+            if (lane[i].msg != num)
+                continue;
+            lane[i].msg = next;
+            lane[i].ptr = in[next];
+            lane[i].blocks = inl[next] / SHA_CBLOCK;
+            lane[i].padded = 0;
+            if (lane[i].blocks == 0)
+                lane_pad(&lane[i], in[next], inl[next]);
+            for (w = 0; w < meth->words; w++)
+                ST(i, w) = meth->iv[w];
+            next++;
+            active++;
+        }
+
+        /*
+         * The SIMD code costs the same however few lanes are busy, so once
+         * there is nothing left to start, a few remaining messages are better
+         * finished one at a time.
+         */
+        if (next == num && 2 * active <= MB_LANES)
+            break;
+
+        /* Run all busy lanes up to the first one to finish */
+        step = INT_MAX;
+        for (i = 0; i < MB_LANES; i++)
+            if (lane[i].msg != num && lane[i].blocks < step)
+                step = lane[i].blocks;
+        for (i = 0; i < MB_LANES; i++) {
+            if (lane[i].msg != num) {
+                desc[i].ptr = lane[i].ptr;
+                desc[i].blocks = (int)step;
+            } else {
+                desc[i].ptr = idle_block;
+                desc[i].blocks = 0;
+            }
+        }
+        meth->mb16(st, desc);
+
+        for (i = 0; i < MB_LANES; i++) {
+            SHA_MB_LANE *l = &lane[i];
+
+            if (l->msg == num)
+                continue;
+            l->ptr += step * SHA_CBLOCK;
+            if ((l->blocks -= step) != 0)
+                continue;
+            if (!l->padded) {
+                lane_pad(l, in[l->msg], inl[l->msg]);
+                continue;
+            }
+            for (w = 0; w < meth->words; w++)
+                h[w] = ST(i, w);
+            lane_output(meth, h, out[l->msg]);
+            l->msg = num;
+            l->ptr = idle_block;
+            active--;
+        }
+    }
+
+    for (i = 0; i < MB_LANES; i++) {
+        SHA_MB_LANE *l = &lane[i];
+
+        if (l->msg == num)
+            continue;
+        for (w = 0; w < meth->words; w++)
+            h[w] = ST(i, w);
+        meth->block1(h, l->ptr, l->blocks);
+        if (!l->padded) {
+            lane_pad(l, in[l->msg], inl[l->msg]);
+            meth->block1(h, l->ptr, l->blocks);
+        }
+        lane_output(meth, h, out[l->msg]);
+    }
+# undef ST
+
+    OPENSSL_cleanse(st, sizeof(st));
+    OPENSSL_cleanse(h, sizeof(h));
+    OPENSSL_cleanse(lane, sizeof(lane));
+    return 1;
+}
+
+int sha1_digest_many(size_t num, const unsigned char *const in[],
+                     const size_t inl[], unsigned char *const out[])
+{
+    return sha_digest_many(&sha1_mb, num, in, inl, out);
+}
+
+int sha224_digest_many(size_t num, const unsigned char *const in[],
+                       const size_t inl[], unsigned char *const out[])
+{
+    return sha_digest_many(&sha224_mb, num, in, inl, out);
+}
+
+int sha256_digest_many(size_t num, const unsigned char *const in[],
+                       const size_t inl[], unsigned char *const out[])
+{
+    return sha_digest_many(&sha256_mb, num, in, inl, out);
+}
+
+#else
+
+# define IMPLEMENT_digest_many(name, CTX, init, update, final)                 \
+int name##_digest_many(size_t num, const unsigned char *const in[],           \
+                       const size_t inl[], unsigned char *const out[])        \
+{                                                                              \
+    CTX c;                                                                     \
+    size_t i;                                                                  \
+                                                                               \
+    for (i = 0; i < num; i++)                                                  \
+        if (!init(&c) || !update(&c, in[i], inl[i]) || !final(out[i], &c))    \
+            return 0;                                                          \
+    OPENSSL_cleanse(&c, sizeof(c));                                            \
+    return 1;                                                                  \
+}
+
+IMPLEMENT_digest_many(sha1, SHA_CTX, SHA1_Init, SHA1_Update, SHA1_Final)
+IMPLEMENT_digest_many(sha224, SHA256_CTX,
+                      SHA224_Init, SHA224_Update, SHA224_Final)
+IMPLEMENT_digest_many(sha256, SHA256_CTX,
+                      SHA256_Init, SHA256_Update, SHA256_Final)
+
+#endif
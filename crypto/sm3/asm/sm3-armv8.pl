@@ -0,0 +1,167 @@
+#! /usr/bin/env perl
+# Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+#
+# Licensed under the Apache License 2.0 (the "License").  You may not use
+# this file except in compliance with the License.  You can obtain a copy
+# in the file LICENSE in the source distribution or at
+# https://www.openssl.org/source/license.html
+
+#
+# SM3 for ARMv8 processors with the SM3 extension (ARMv8.2-SM3).
+#
+# The state is kept as ABCD and EFGH vectors with A and E in lane 3,
+# which is the layout SM3SS1, SM3TT1x and SM3TT2x work on.  One round
+# is SM3SS1, SM3TT1x and SM3TT2x, and the round constant is rotated in
+# a vector register on the side.  Four words of the message schedule
+# come from SM3PARTW1 and SM3PARTW2 every four rounds, using a rolling
+# window of five registers, so the expansion of W[j+16..j+19] overlaps
+# the rounds that consume W[j..j+3].
+#
+# Instructions are emitted as .inst, so that no assembler support for
+# the extension is needed.
+
+# $output is the last argument if it looks like a file (it has an extension)
+# $flavour is the first argument if it doesn't look like a file
+$output = $#ARGV >= 0 && $ARGV[$#ARGV] =~ m|\.\w+$| ? pop : undef;
+$flavour = $#ARGV >= 0 && $ARGV[0] !~ m|\.| ? shift : undef;
+
+if ($flavour && $flavour ne "void") {
+    $0 =~ m/(.*[\/\\])[^\/\\]+$/; $dir=$1;
+    ( $xlate="${dir}arm-xlate.pl" and -f $xlate ) or
+    ( $xlate="${dir}../../perlasm/arm-xlate.pl" and -f $xlate) or
+    die "can't locate arm-xlate.pl";
+
+    open OUT,"| \"$^X\" $xlate $flavour \"$output\""
+        or die "can't call $xlate: $!";
+    *STDOUT=*OUT;
+} else {
+    $output and open STDOUT,">$output";
+}
+
+my ($ctx,$inp,$num)=map("x$_",(0..2));
+my @W=map("v$_",(0..4));
+my ($ss1,$t0,$t1)=map("v$_",(5..7));
+my ($abcd,$efgh,$abcd0,$efgh0,$wp,$tj,$tj1,$k)=map("v$_",(16..23));
+
+# Four rounds, and the expansion of the schedule four words ahead if
+# @W has all five registers.  $ab is "a" for rounds 0-15 and "b" after.
+sub qround {
+my ($ab,@s)=@_;
+    if (@s==5) {
+$code.=<<___;
+	ext	@s[4].16b,@s[1].16b,@s[2].16b,#12
+	ext	$t0.16b,@s[0].16b,@s[1].16b,#12
+	ext	$t1.16b,@s[2].16b,@s[3].16b,#8
+	sm3partw1	@s[4].4s,@s[0].4s,@s[3].4s
+___
+    }
+$code.=<<___;
+	eor	$wp.16b,@s[0].16b,@s[1].16b
+___
+    foreach my $i (0..3) {
+$code.=<<___;
+	sm3ss1	$ss1.4s,$abcd.4s,$tj.4s,$efgh.4s
+	shl	$tj1.4s,$tj.4s,#1
+	sri	$tj1.4s,$tj.4s,#31
+	sm3tt1$ab	$abcd.4s,$ss1.4s,$wp.s[$i]
+	sm3tt2$ab	$efgh.4s,$ss1.4s,@s[0].s[$i]
+___
+	($tj,$tj1)=($tj1,$tj);
+    }
+$code.=<<___ if (@s==5);
+	sm3partw2	@s[4].4s,$t1.4s,$t0.4s
+___
+}
+
+$code=<<___;
+#include "arm_arch.h"
+
+.text
+
+// void sm3_v8_block_data_order(SM3_CTX *ctx, const void *inp, size_t num);
+.globl	sm3_v8_block_data_order
+.type	sm3_v8_block_data_order,%function
+.align	5
+sm3_v8_block_data_order:
+	ld1	{$abcd.4s,$efgh.4s},[$ctx]
+	adr	x3,.Lsm3_tj
+	ld1	{$k.4s},[x3]
+	rev64	$abcd.4s,$abcd.4s
+	rev64	$efgh.4s,$efgh.4s
+	ext	$abcd.16b,$abcd.16b,$abcd.16b,#8
+	ext	$efgh.16b,$efgh.16b,$efgh.16b,#8
+
+.Loop:
+	ld1	{@W[0].16b-@W[3].16b},[$inp],#64
+	sub	$num,$num,#1
+	mov	$abcd0.16b,$abcd.16b
+	mov	$efgh0.16b,$efgh.16b
+	rev32	@W[0].16b,@W[0].16b
+	rev32	@W[1].16b,@W[1].16b
+	rev32	@W[2].16b,@W[2].16b
+	rev32	@W[3].16b,@W[3].16b
+	dup	$tj.4s,$k.s[0]
+___
+    foreach my $q (0..15) {
+	if ($q==4) {
+	    $code.="\tdup\t$tj.4s,$k.s[1]\n";
+	}
+	&qround($q<4 ? "a" : "b", $q<13 ? @W : @W[0..1]);
+	push(@W,shift(@W));
+    }
+$code.=<<___;
+	eor	$abcd.16b,$abcd.16b,$abcd0.16b
+	eor	$efgh.16b,$efgh.16b,$efgh0.16b
+	cbnz	$num,.Loop
+
+	rev64	$abcd.4s,$abcd.4s
+	rev64	$efgh.4s,$efgh.4s
+	ext	$abcd.16b,$abcd.16b,$abcd.16b,#8
+	ext	$efgh.16b,$efgh.16b,$efgh.16b,#8
+	st1	{$abcd.4s,$efgh.4s},[$ctx]
+	ret
+.size	sm3_v8_block_data_order,.-sm3_v8_block_data_order
+
+.align	4
+.Lsm3_tj:
+	// T0 for rounds 0-15, and T1<<<16 for rounds 16-63
+	.long	0x79cc4519,0x9d8a7a87,0,0
+___
+
+{   my  %opcode = (
+	"sm3ss1"	=> 0xce400000,	"sm3tt1a"	=> 0xce408000,
+	"sm3tt1b"	=> 0xce408400,	"sm3tt2a"	=> 0xce408800,
+	"sm3tt2b"	=> 0xce408c00,	"sm3partw1"	=> 0xce60c000,
+	"sm3partw2"	=> 0xce60c400	);
+
+    sub unsm3 {
+	my ($mnemonic,$arg)=@_;
+	my @r = ($arg =~ m/[qv]([0-9]+)/g);
+	my $word = $opcode{$mnemonic}|$r[0]|($r[1]<<5)|($r[2]<<16);
+
+	if ($mnemonic eq "sm3ss1") {
+	    $word |= $r[3]<<10;
+	} elsif ($arg =~ m/\[([0-3])\]/) {
+	    $word |= $1<<12;
+	}
+	sprintf ".inst\t0x%08x\t//%s %s",$word,$mnemonic,$arg;
+    }
+}
+
+open SELF,$0;
+while(<SELF>) {
+        next if (/^#!/);
+        last if (!s/^#/\/\// and !/^$/);
+        print;
+}
+close SELF;
+
+foreach(split("\n",$code)) {
+	s/\`([^\`]*)\`/eval($1)/ge;
+
+	s/\b(sm3\w+)\s+([qv].*)/unsm3($1,$2)/ge;
+
+	print $_,"\n";
+}
+
+close STDOUT or die "error closing STDOUT: $!";
@@ -0,0 +1,520 @@
+#! /usr/bin/env perl
+# Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+#
+# Licensed under the Apache License 2.0 (the "License").  You may not use
+# this file except in compliance with the License.  You can obtain a copy
+# in the file LICENSE in the source distribution or at
+# https://www.openssl.org/source/license.html
+
+#
+# SM3 for x86_64 with AVX2 and BMI1/BMI2.
+#
+# The compression function is serial, so the rounds are done in the
+# integer unit with RORX and ANDN, and what is left to vectorise is the
+# message expansion.  It is done four words at a time for two blocks,
+# one in each 128-bit lane: W[j+3] depends on W[j], so the fourth word
+# is fixed up afterwards, which works because P1 is linear.  W[j] and
+# W'[j] = W[j]^W[j+4] for both blocks are kept on the stack, and the
+# expansion of the next four words is interleaved with the rounds of
+# the first block.  An odd block at the end is hashed with a copy of
+# itself in the upper lane, whose rounds are then skipped.
+#
+# Cycles per byte, 16KB messages:
+#
+#		AVX2	C
+# Xeon		7.9	13.9
+#
+# The caller checks for AVX2, BMI1 and BMI2.
+
+# $output is the last argument if it looks like a file (it has an extension)
+# $flavour is the first argument if it doesn't look like a file
+$output = $#ARGV >= 0 && $ARGV[$#ARGV] =~ m|\.\w+$| ? pop : undef;
+$flavour = $#ARGV >= 0 && $ARGV[0] !~ m|\.| ? shift : undef;
+
+$win64=0; $win64=1 if ($flavour =~ /[nm]asm|mingw64/ || $output =~ /\.asm$/);
+
+$0 =~ m/(.*[\/\\])[^\/\\]+$/; $dir=$1;
+( $xlate="${dir}x86_64-xlate.pl" and -f $xlate ) or
+( $xlate="${dir}../../perlasm/x86_64-xlate.pl" and -f $xlate) or
+die "can't locate x86_64-xlate.pl";
+
+if (`$ENV{CC} -Wa,-v -c -o /dev/null -x assembler /dev/null 2>&1`
+		=~ /GNU assembler version ([2-9]\.[0-9]+)/) {
+	$avx = ($1>=2.19) + ($1>=2.22);
+}
+
+if (!$avx && $win64 && ($flavour =~ /nasm/ || $ENV{ASM} =~ /nasm/) &&
+	   `nasm -v 2>&1` =~ /NASM version ([2-9]\.[0-9]+)/) {
+	$avx = ($1>=2.09) + ($1>=2.10);
+}
+
+if (!$avx && $win64 && ($flavour =~ /masm/ || $ENV{ASM} =~ /ml64/) &&
+	   `ml64 2>&1` =~ /Version ([0-9]+)\./) {
+	$avx = ($1>=10) + ($1>=11);
+}
+
+if (!$avx && `$ENV{CC} -v 2>&1` =~ /((?:^clang|LLVM) version|.*based on LLVM) ([0-9]+\.[0-9]+)/) {
+	$avx = ($2>=3.0) + ($2>3.0);
+}
+
+open OUT,"| \"$^X\" \"$xlate\" $flavour \"$output\""
+    or die "can't call $xlate: $!";
+*STDOUT=*OUT;
+
+$func="sm3_block_data_order_avx2";
+
+if ($avx>1) {{{
+my ($ctx,$inp,$end)=("%rdi","%rsi","%rbp");
+my @V=("%eax","%ebx","%ecx","%edx","%r8d","%r9d","%r10d","%r11d");
+my @T=("%r12d","%r13d","%r14d","%r15d");
+my @X=map("%ymm$_",(0..4));		# 4 groups of W and a spare
+my ($t0,$t1,$t2)=map("%ymm$_",(5..7));
+
+my $Wp=16*32;				# W' is after W
+my $_rsp="`2*16*32+8`(%rsp)";		# saved %rsp
+my $frame=2*16*32+16+($win64?2*16:0);
+
+sub r64 { my $r=shift; $r=~s/%e(\w)x/%r$1x/ or $r=~s/d$//; $r; }
+
+# One round, as a list of instructions.  @V is renamed by the caller.
+sub round {
+my ($j,$blk)=@_;
+my ($a,$b,$c,$d,$e,$f,$g,$h)=@V;
+my $w=32*($j>>2)+16*$blk+4*($j&3);
+my $tj=($j<16 ? 0x79cc4519 : 0x7a879d8a);
+   $tj=(($tj<<($j%32))|($tj>>(32-$j%32)))&0xffffffff if ($j%32);
+   $tj-=1<<32 if ($tj>=1<<31);		# disp32 is signed
+my @r;
+
+	push(@r,
+	"rorx	\$20,$a,$T[0]",			# A<<<12
+	"lea	$tj(".r64($T[0]).",".r64($e)."),$T[1]",
+	"rorx	\$25,$T[1],$T[1]",		# SS1
+	"add	$w(%rsp),$h",
+	"xor	$T[1],$T[0]",			# SS2
+	"add	`$Wp+$w`(%rsp),$d",
+	"add	$T[1],$h",
+	"add	$T[0],$d");
+    if ($j<16) {
+	push(@r,
+	"mov	$b,$T[2]",
+	"mov	$f,$T[3]",
+	"xor	$c,$T[2]",
+	"xor	$g,$T[3]",
+	"xor	$a,$T[2]",			# FF0
+	"xor	$e,$T[3]",			# GG0
+	"add	$T[2],$d",
+	"add	$T[3],$h");
+    } else {
+	push(@r,
+	"mov	$a,$T[2]",
+	"mov	$a,$T[3]",
+	"or	$b,$T[2]",
+	"and	$b,$T[3]",
+	"and	$c,$T[2]",
+	"andn	$g,$e,$T[0]",			# ~E&G
+	"or	$T[3],$T[2]",			# FF1
+	"mov	$f,$T[1]",
+	"and	$e,$T[1]",
+	"add	$T[2],$d",
+	"or	$T[0],$T[1]",			# GG1
+	"add	$T[1],$h");
+    }
+	push(@r,
+	"rorx	\$23,$b,$b",			# B<<<9
+	"rorx	\$13,$f,$f",			# F<<<19
+	"rorx	\$23,$h,$T[0]",
+	"rorx	\$15,$h,$T[1]",
+	"xor	$T[0],$h",
+	"xor	$T[1],$h");			# P0(TT2)
+	@r;
+}
+
+# Expansion of W[j..j+3], j=4*$k, in $X[4] from $X[0..3], which hold
+# W[j-16..j-1].  W[k] and W'[k-1] are stored.
+sub expand {
+my $k=shift;
+my @r;
+
+	push(@r,
+	"vpalignr	\$12,$X[1],$X[2],$t0",	# W[j-9]
+	"vpsrldq	\$4,$X[3],$t1",		# W[j-3], lane 3 is 0
+	"vpxor		$X[0],$t0,$t0",
+	"vpslld		\$15,$t1,$t2",
+	"vpsrld		\$17,$t1,$t1",
+	"vpxor		$t2,$t0,$t0",
+	"vpxor		$t1,$t0,$t0",
+	"vpslld		\$15,$t0,$t1",		# P1
+	"vpsrld		\$17,$t0,$t2",
+	"vpxor		$t1,$t0,$X[4]",
+	"vpslld		\$23,$t0,$t1",
+	"vpxor		$t2,$X[4],$X[4]",
+	"vpsrld		\$9,$t0,$t2",
+	"vpxor		$t1,$X[4],$X[4]",
+	"vpalignr	\$12,$X[0],$X[1],$t0",	# W[j-13]
+	"vpxor		$t2,$X[4],$X[4]",
+	"vpslld		\$7,$t0,$t1",
+	"vpsrld		\$25,$t0,$t0",
+	"vpxor		$t1,$X[4],$X[4]",
+	"vpalignr	\$8,$X[2],$X[3],$t1",	# W[j-6]
+	"vpxor		$t0,$X[4],$X[4]",
+	"vpxor		$t1,$X[4],$X[4]",
+	# W[j+3] ^= P1(W[j]<<<15)
+	"vpslldq	\$12,$X[4],$t0",
+	"vpslld		\$15,$t0,$t1",
+	"vpsrld		\$17,$t0,$t2",
+	"vpxor		$t1,$X[4],$X[4]",
+	"vpslld		\$30,$t0,$t1",
+	"vpxor		$t2,$X[4],$X[4]",
+	"vpsrld		\$2,$t0,$t2",
+	"vpxor		$t1,$X[4],$X[4]",
+	"vpslld		\$6,$t0,$t1",
+	"vpxor		$t2,$X[4],$X[4]",
+	"vpsrld		\$26,$t0,$t2",
+	"vpxor		$t1,$X[4],$X[4]",
+	"vpxor		$t2,$X[4],$X[4]");
+	push(@r,
+	"vmovdqa	$X[4],`32*$k`(%rsp)") if ($k<16);
+	push(@r,
+	"vpxor		$X[4],$X[3],$t0",
+	"vmovdqa	$t0,`$Wp+32*($k-1)`(%rsp)");
+	@r;
+}
+
+$code.=<<___;
+.text
+
+# void sm3_block_data_order_avx2(SM3_CTX *ctx, const void *inp,
+#                                size_t num);
+.globl	$func
+.type	$func,\@function,3
+.align	64
+$func:
+.cfi_startproc
+	mov	%rsp,%rax		# copy %rsp
+.cfi_def_cfa_register	%rax
+	push	%rbx
+.cfi_push	%rbx
+	push	%rbp
+.cfi_push	%rbp
+	push	%r12
+.cfi_push	%r12
+	push	%r13
+.cfi_push	%r13
+	push	%r14
+.cfi_push	%r14
+	push	%r15
+.cfi_push	%r15
+	sub	\$$frame,%rsp
+	and	\$-64,%rsp		# align stack frame
+	mov	%rax,$_rsp		# save copy of %rsp
+.cfi_cfa_expression	$_rsp,deref,+8
+___
+$code.=<<___ if ($win64);
+	movaps	%xmm6,`2*16*32+16`(%rsp)
+	movaps	%xmm7,`2*16*32+32`(%rsp)
+___
+$code.=<<___;
+.Lprologue_avx2:
+
+	vzeroupper
+	shl	\$6,%rdx
+	lea	($inp,%rdx),$end	# end of input
+	mov	0($ctx),$V[0]
+	mov	4($ctx),$V[1]
+	mov	8($ctx),$V[2]
+	mov	12($ctx),$V[3]
+	mov	16($ctx),$V[4]
+	mov	20($ctx),$V[5]
+	mov	24($ctx),$V[6]
+	mov	28($ctx),$V[7]
+	jmp	.Loop_avx2
+
+.align	32
+.Loop_avx2:
+	lea	64($inp),%r12
+	vmovdqa	.Lbswap(%rip),$t2
+	cmp	$end,%r12
+	cmove	$inp,%r12		# last block goes to both lanes
+	vmovdqu	0($inp),%xmm0
+	vmovdqu	16($inp),%xmm1
+	vmovdqu	32($inp),%xmm2
+	vmovdqu	48($inp),%xmm3
+	vinserti128	\$1,0(%r12),$X[0],$X[0]
+	vinserti128	\$1,16(%r12),$X[1],$X[1]
+	vinserti128	\$1,32(%r12),$X[2],$X[2]
+	vinserti128	\$1,48(%r12),$X[3],$X[3]
+	vpshufb	$t2,$X[0],$X[0]
+	vpshufb	$t2,$X[1],$X[1]
+	vpshufb	$t2,$X[2],$X[2]
+	vpshufb	$t2,$X[3],$X[3]
+	vmovdqa	$X[0],0x00(%rsp)
+	vpxor	$X[1],$X[0],$t0
+	vmovdqa	$X[1],0x20(%rsp)
+	vpxor	$X[2],$X[1],$t1
+	vmovdqa	$X[2],0x40(%rsp)
+	vpxor	$X[3],$X[2],$t2
+	vmovdqa	$X[3],0x60(%rsp)
+	vmovdqa	$t0,`$Wp+0x00`(%rsp)
+	vmovdqa	$t1,`$Wp+0x20`(%rsp)
+	vmovdqa	$t2,`$Wp+0x40`(%rsp)
+___
+
+    # first block, with the expansion four words ahead of the rounds
+    for (my $k=0; $k<16; $k++) {
+	my (@r,@e);
+	for (my $j=4*$k; $j<4*$k+4; $j++) {
+	    push(@r,&round($j,0));
+	    @V=@V[3,0,1,2,7,4,5,6];
+	}
+	@e=&expand($k+4) if ($k+4<=16);
+	my $n=@e;
+	for (my $i=0; $i<@r; $i++) {
+	    $code.="\t$r[$i]\n";
+	    $code.="\t".shift(@e)."\n" while ($n-@e < int(($i+1)*$n/@r));
+	}
+	push(@X,shift(@X)) if ($k+4<=16);
+    }
+$code.=<<___;
+	xor	0($ctx),$V[0]
+	xor	4($ctx),$V[1]
+	xor	8($ctx),$V[2]
+	xor	12($ctx),$V[3]
+	xor	16($ctx),$V[4]
+	xor	20($ctx),$V[5]
+	xor	24($ctx),$V[6]
+	xor	28($ctx),$V[7]
+	mov	$V[0],0($ctx)
+	mov	$V[1],4($ctx)
+	mov	$V[2],8($ctx)
+	mov	$V[3],12($ctx)
+	mov	$V[4],16($ctx)
+	mov	$V[5],20($ctx)
+	mov	$V[6],24($ctx)
+	mov	$V[7],28($ctx)
+	lea	64($inp),$inp
+	cmp	$end,$inp
+	je	.Ldone_avx2
+___
+
+    # second block, all of whose schedule is there already
+    for (my $j=0; $j<64; $j++) {
+	$code.="\t$_\n" foreach (&round($j,1));
+	@V=@V[3,0,1,2,7,4,5,6];
+    }
+$code.=<<___;
+	xor	0($ctx),$V[0]
+	xor	4($ctx),$V[1]
+	xor	8($ctx),$V[2]
+	xor	12($ctx),$V[3]
+	xor	16($ctx),$V[4]
+	xor	20($ctx),$V[5]
+	xor	24($ctx),$V[6]
+	xor	28($ctx),$V[7]
+	mov	$V[0],0($ctx)
+	mov	$V[1],4($ctx)
+	mov	$V[2],8($ctx)
+	mov	$V[3],12($ctx)
+	mov	$V[4],16($ctx)
+	mov	$V[5],20($ctx)
+	mov	$V[6],24($ctx)
+	mov	$V[7],28($ctx)
+	lea	64($inp),$inp
+	cmp	$end,$inp
+	jne	.Loop_avx2
+
+.Ldone_avx2:
+	vzeroupper
+	mov	$_rsp,%rsi
+.cfi_def_cfa	%rsi,8
+___
+$code.=<<___ if ($win64);
+	movaps	`2*16*32+16`(%rsp),%xmm6
+	movaps	`2*16*32+32`(%rsp),%xmm7
+___
+$code.=<<___;
+	mov	-48(%rsi),%r15
+.cfi_restore	%r15
+	mov	-40(%rsi),%r14
+.cfi_restore	%r14
+	mov	-32(%rsi),%r13
+.cfi_restore	%r13
+	mov	-24(%rsi),%r12
+.cfi_restore	%r12
+	mov	-16(%rsi),%rbp
+.cfi_restore	%rbp
+	mov	-8(%rsi),%rbx
+.cfi_restore	%rbx
+	lea	(%rsi),%rsp
+.cfi_def_cfa_register	%rsp
+.Lepilogue_avx2:
+	ret
+.cfi_endproc
+.size	$func,.-$func
+
+# int sm3_avx2_eligible(void);
+#
+# Returns 1 as the function above is real, the caller checks
+# OPENSSL_ia32cap_P for the processor features.
+.globl	sm3_avx2_eligible
+.type	sm3_avx2_eligible,\@abi-omnipotent
+.align	32
+sm3_avx2_eligible:
+.cfi_startproc
+	mov	\$1,%eax
+	ret
+.cfi_endproc
+.size	sm3_avx2_eligible,.-sm3_avx2_eligible
+
+.align	64
+.Lbswap:
+	.byte	3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12
+	.byte	3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12
+.asciz	"SM3 for x86_64, AVX2/BMI2"
+.align	64
+___
+
+# EXCEPTION_DISPOSITION handler (EXCEPTION_RECORD *rec,ULONG64 frame,
+#		CONTEXT *context,DISPATCHER_CONTEXT *disp)
+if ($win64) {
+$rec="%rcx";
+$frame="%rdx";
+$context="%r8";
+$disp="%r9";
+
+$code.=<<___;
+.extern	__imp_RtlVirtualUnwind
+.type	se_handler,\@abi-omnipotent
+.align	16
+se_handler:
+	push	%rsi
+	push	%rdi
+	push	%rbx
+	push	%rbp
+	push	%r12
+	push	%r13
+	push	%r14
+	push	%r15
+	pushfq
+	sub	\$64,%rsp
+
+	mov	120($context),%rax	# pull context->Rax
+	mov	248($context),%rbx	# pull context->Rip
+
+	mov	8($disp),%rsi		# disp->ImageBase
+	mov	56($disp),%r11		# disp->HandlerData
+
+	mov	0(%r11),%r10d		# HandlerData[0]
+	lea	(%rsi,%r10),%r10	# prologue label
+	cmp	%r10,%rbx		# context->Rip<prologue label
+	jb	.Lin_prologue
+
+	mov	152($context),%rax	# pull context->Rsp
+
+	mov	4(%r11),%r10d		# HandlerData[1]
+	lea	(%rsi,%r10),%r10	# epilogue label
+	cmp	%r10,%rbx		# context->Rip>=epilogue label
+	jae	.Lin_prologue
+
+	lea	`2*16*32+16`(%rax),%rsi	# Xmm6- save area
+	mov	`2*16*32+8`(%rax),%rax	# pull saved %rsp
+
+	mov	-8(%rax),%rbx
+	mov	-16(%rax),%rbp
+	mov	-24(%rax),%r12
+	mov	-32(%rax),%r13
+	mov	-40(%rax),%r14
+	mov	-48(%rax),%r15
+	mov	%rbx,144($context)	# restore context->Rbx
+	mov	%rbp,160($context)	# restore context->Rbp
+	mov	%r12,216($context)	# restore context->R12
+	mov	%r13,224($context)	# restore context->R13
+	mov	%r14,232($context)	# restore context->R14
+	mov	%r15,240($context)	# restore context->R15
+
+	lea	512($context),%rdi	# &context.Xmm6
+	mov	\$4,%ecx
+	.long	0xa548f3fc		# cld; rep movsq
+
+.Lin_prologue:
+	mov	8(%rax),%rdi
+	mov	16(%rax),%rsi
+	mov	%rax,152($context)	# restore context->Rsp
+	mov	%rsi,168($context)	# restore context->Rsi
+	mov	%rdi,176($context)	# restore context->Rdi
+
+	mov	40($disp),%rdi		# disp->ContextRecord
+	mov	$context,%rsi		# context
+	mov	\$154,%ecx		# sizeof(CONTEXT)
+	.long	0xa548f3fc		# cld; rep movsq
+
+	mov	$disp,%rsi
+	xor	%rcx,%rcx		# arg1, UNW_FLAG_NHANDLER
+	mov	8(%rsi),%rdx		# arg2, disp->ImageBase
+	mov	0(%rsi),%r8		# arg3, disp->ControlPc
+	mov	16(%rsi),%r9		# arg4, disp->FunctionEntry
+	mov	40(%rsi),%r10		# disp->ContextRecord
+	lea	56(%rsi),%r11		# &disp->HandlerData
+	lea	24(%rsi),%r12		# &disp->EstablisherFrame
+	mov	%r10,32(%rsp)		# arg5
+	mov	%r11,40(%rsp)		# arg6
+	mov	%r12,48(%rsp)		# arg7
+	mov	%rcx,56(%rsp)		# arg8, (NULL)
+	call	*__imp_RtlVirtualUnwind(%rip)
+
+	mov	\$1,%eax		# ExceptionContinueSearch
+	add	\$64,%rsp
+	popfq
+	pop	%r15
+	pop	%r14
+	pop	%r13
+	pop	%r12
+	pop	%rbp
+	pop	%rbx
+	pop	%rdi
+	pop	%rsi
+	ret
+.size	se_handler,.-se_handler
+
+.section	.pdata
+.align	4
+	.rva	.LSEH_begin_$func
+	.rva	.LSEH_end_$func
+	.rva	.LSEH_info_$func
+
+.section	.xdata
+.align	8
+.LSEH_info_$func:
+	.byte	9,0,0,0
+	.rva	se_handler
+	.rva	.Lprologue_avx2,.Lepilogue_avx2	# HandlerData[]
+___
+}
+}}} else {{{
+$code=<<___;	# assembler is too old
+.text
+
+.globl	$func
+.type	$func,\@abi-omnipotent
+$func:
+.cfi_startproc
+	ud2
+.cfi_endproc
+.size	$func,.-$func
+
+.globl	sm3_avx2_eligible
+.type	sm3_avx2_eligible,\@abi-omnipotent
+sm3_avx2_eligible:
+.cfi_startproc
+	xor	%eax,%eax
+	ret
+.cfi_endproc
+.size	sm3_avx2_eligible,.-sm3_avx2_eligible
+___
+}}}
+
+$code =~ s/\`([^\`]*)\`/eval($1)/gem;
+
+print $code;
+
+close STDOUT or die "error closing STDOUT: $!";
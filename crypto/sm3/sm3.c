@@ -26,7 +26,7 @@ int sm3_init(SM3_CTX *c)
     return 1;
 }
 
-void sm3_block_data_order(SM3_CTX *ctx, const void *p, size_t num)
+static void sm3_block_data_order_c(SM3_CTX *ctx, const void *p, size_t num)
 {
     const unsigned char *data = p;
     register unsigned MD32_REG_T A, B, C, D, E, F, G, H;
@@ -194,3 +194,19 @@ void sm3_block_data_order(SM3_CTX *ctx, const void *p, size_t num)
     }
 }
 
+void sm3_block_data_order(SM3_CTX *ctx, const void *p, size_t num)
+{
+#ifdef HWSM3_CAPABLE
+    if (HWSM3_CAPABLE) {
+        HWSM3_block_data_order(ctx, p, num);
+        return;
+    }
+#endif
+#ifdef SM3_AVX2_CAPABLE
+    if (SM3_AVX2_CAPABLE) {
+        sm3_block_data_order_avx2(ctx, p, num);
+        return;
+    }
+#endif
+    sm3_block_data_order_c(ctx, p, num);
+}
@@ -37,6 +37,32 @@
 void sm3_block_data_order(SM3_CTX *c, const void *p, size_t num);
 void sm3_transform(SM3_CTX *c, const unsigned char *data);
 
+/*
+ * The assembler functions take the context as is, as A to H are the
+ * first eight words of it.
+ */
+#if defined(SM3_ASM) && defined(OPENSSL_CPUID_OBJ)
+# if defined(__aarch64__)
+#  include "arm_arch.h"
+#  define HWSM3_CAPABLE (OPENSSL_armcap_P & ARMV8_SM3)
+#  define HWSM3_block_data_order sm3_v8_block_data_order
+
+void sm3_v8_block_data_order(SM3_CTX *c, const void *p, size_t num);
+# endif
+
+# if defined(__x86_64) || defined(__x86_64__) || \
+     defined(_M_AMD64) || defined(_M_X64)
+#  include "internal/cryptlib.h"
+/* AVX2, BMI1 and BMI2, and an assembler that knows them */
+#  define SM3_AVX2_CAPABLE                                        \
+        ((OPENSSL_ia32cap_P[2] & ((1 << 3) | (1 << 5) | (1 << 8))) \
+         == ((1 << 3) | (1 << 5) | (1 << 8)) && sm3_avx2_eligible())
+
+int sm3_avx2_eligible(void);
+void sm3_block_data_order_avx2(SM3_CTX *c, const void *p, size_t num);
+# endif
+#endif
+
 #include "crypto/md32_common.h"
 
 #define P0(X) (X ^ ROTATE(X, 9) ^ ROTATE(X, 17))
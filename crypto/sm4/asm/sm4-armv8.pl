@@ -0,0 +1,352 @@
+#! /usr/bin/env perl
+# Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+#
+# Licensed under the Apache License 2.0 (the "License").  You may not use
+# this file except in compliance with the License.  You can obtain a copy
+# in the file LICENSE in the source distribution or at
+# https://www.openssl.org/source/license.html
+
+#
+# SM4 for ARMv8 processors with the SM4 extension (ARMv8.2-SM4).
+#
+# SM4E performs four rounds on a block held as four 32-bit words in
+# lanes 0-3, with four round keys in another register.  Eight of them
+# make the whole cipher, so the kernel is little more than byte
+# swapping and interleaving of independent blocks to hide the latency
+# of the instruction.  Key schedule is left to the C code, because the
+# layout of its round keys is exactly what SM4E takes; decryption
+# simply loads the same round keys in reverse order.
+#
+# Up to eight blocks are processed in parallel in ECB, CBC decrypt and
+# CTR modes.  CBC encrypt is inherently serial.
+#
+# Instructions are emitted as .inst, so that no assembler support for
+# the extension is needed.
+
+# $output is the last argument if it looks like a file (it has an extension)
+# $flavour is the first argument if it doesn't look like a file
+$output = $#ARGV >= 0 && $ARGV[$#ARGV] =~ m|\.\w+$| ? pop : undef;
+$flavour = $#ARGV >= 0 && $ARGV[0] !~ m|\.| ? shift : undef;
+
+if ($flavour && $flavour ne "void") {
+    $0 =~ m/(.*[\/\\])[^\/\\]+$/; $dir=$1;
+    ( $xlate="${dir}arm-xlate.pl" and -f $xlate ) or
+    ( $xlate="${dir}../../perlasm/arm-xlate.pl" and -f $xlate) or
+    die "can't locate arm-xlate.pl";
+
+    open OUT,"| \"$^X\" $xlate $flavour \"$output\""
+        or die "can't call $xlate: $!";
+    *STDOUT=*OUT;
+} else {
+    $output and open STDOUT,">$output";
+}
+
+my ($inp,$out,$len,$key,$ivp,$enc)=map("x$_",(0..5));
+my @rk=map("v$_",(16..23));
+my @x=map("v$_",(0..7));
+my @t=map("v$_",(24..31));
+my $iv="v8";
+
+# Loads the round keys, in reverse order for decryption
+sub load_keys {
+my $dir=shift;
+    if ($dir eq "enc") {
+$code.=<<___;
+	ld1	{@rk[0].4s-@rk[3].4s},[$key],#64
+	ld1	{@rk[4].4s-@rk[7].4s},[$key]
+	sub	$key,$key,#64
+___
+    } else {
+$code.=<<___;
+	add	x9,$key,#112
+	mov	x10,#-16
+___
+	foreach (@rk) {
+$code.=<<___;
+	ld1	{$_.4s},[x9],x10
+	rev64	$_.4s,$_.4s
+	ext	$_.16b,$_.16b,$_.16b,#8
+___
+	}
+    }
+}
+
+# Encrypts the blocks in the given registers, which must be byte swapped
+# on input; the output is in memory order
+sub sm4_blocks {
+my @b=@_;
+    foreach my $r (@rk) {
+	$code.="\tsm4e\t$_.4s,$r.4s\n" foreach (@b);
+    }
+    foreach (@b) {
+$code.=<<___;
+	rev64	$_.4s,$_.4s
+	ext	$_.16b,$_.16b,$_.16b,#8
+	rev32	$_.16b,$_.16b
+___
+    }
+}
+
+$code=<<___;
+#include "arm_arch.h"
+
+.text
+___
+
+{
+my ($name,$dir);
+foreach $dir ("enc","dec") {
+$name = $dir eq "enc" ? "sm4_v8_encrypt" : "sm4_v8_decrypt";
+$key="x2";
+$code.=<<___;
+.globl	$name
+.type	$name,%function
+.align	5
+$name:
+___
+	&load_keys($dir);
+$code.=<<___;
+	ld1	{@x[0].16b},[$inp]
+	rev32	@x[0].16b,@x[0].16b
+___
+	&sm4_blocks(@x[0]);
+$code.=<<___;
+	st1	{@x[0].16b},[$out]
+	ret
+.size	$name,.-$name
+___
+}
+$key="x3";
+}
+
+{
+# void sm4_v8_ecb_encrypt(const unsigned char *in, unsigned char *out,
+#                         size_t len, const SM4_KEY *key, int enc);
+$code.=<<___;
+.globl	sm4_v8_ecb_encrypt
+.type	sm4_v8_ecb_encrypt,%function
+.align	5
+sm4_v8_ecb_encrypt:
+	cbz	w4,.Lecb_dec_keys
+___
+	&load_keys("enc");
+$code.=<<___;
+	b	.Lecb_keys_done
+.Lecb_dec_keys:
+___
+	&load_keys("dec");
+$code.=<<___;
+.Lecb_keys_done:
+	lsr	$len,$len,#4
+	subs	$len,$len,#8
+	b.lo	.Lecb_tail
+
+.Lecb_loop8:
+	ld1	{@x[0].16b-@x[3].16b},[$inp],#64
+	ld1	{@x[4].16b-@x[7].16b},[$inp],#64
+___
+	$code.="\trev32\t$_.16b,$_.16b\n" foreach (@x);
+	&sm4_blocks(@x);
+$code.=<<___;
+	st1	{@x[0].16b-@x[3].16b},[$out],#64
+	st1	{@x[4].16b-@x[7].16b},[$out],#64
+	subs	$len,$len,#8
+	b.hs	.Lecb_loop8
+
+.Lecb_tail:
+	adds	$len,$len,#8
+	b.eq	.Lecb_done
+.Lecb_loop1:
+	ld1	{@x[0].16b},[$inp],#16
+	rev32	@x[0].16b,@x[0].16b
+___
+	&sm4_blocks(@x[0]);
+$code.=<<___;
+	st1	{@x[0].16b},[$out],#16
+	subs	$len,$len,#1
+	b.ne	.Lecb_loop1
+.Lecb_done:
+	ret
+.size	sm4_v8_ecb_encrypt,.-sm4_v8_ecb_encrypt
+___
+}
+
+{
+# void sm4_v8_cbc_encrypt(const unsigned char *in, unsigned char *out,
+#                         size_t len, const SM4_KEY *key,
+#                         unsigned char ivec[16], int enc);
+#
+# The ciphertext of a batch is kept in @t until the plaintext has been
+# recovered, so that in-place operation works.  v8 holds the IV, which
+# means that d8 has to be preserved.
+$code.=<<___;
+.globl	sm4_v8_cbc_encrypt
+.type	sm4_v8_cbc_encrypt,%function
+.align	5
+sm4_v8_cbc_encrypt:
+	str	d8,[sp,#-16]!
+	lsr	$len,$len,#4
+	ld1	{$iv.16b},[$ivp]
+	cbz	w5,.Lcbc_dec
+___
+	&load_keys("enc");
+$code.=<<___;
+	cbz	$len,.Lcbc_done
+.Lcbc_enc_loop:
+	ld1	{@x[0].16b},[$inp],#16
+	eor	@x[0].16b,@x[0].16b,$iv.16b
+	rev32	@x[0].16b,@x[0].16b
+___
+	&sm4_blocks(@x[0]);
+$code.=<<___;
+	mov	$iv.16b,@x[0].16b
+	st1	{@x[0].16b},[$out],#16
+	subs	$len,$len,#1
+	b.ne	.Lcbc_enc_loop
+	b	.Lcbc_done
+
+.Lcbc_dec:
+___
+	&load_keys("dec");
+$code.=<<___;
+	subs	$len,$len,#8
+	b.lo	.Lcbc_dec_tail
+
+.Lcbc_dec_loop8:
+	ld1	{@t[0].16b-@t[3].16b},[$inp],#64
+	ld1	{@t[4].16b-@t[7].16b},[$inp],#64
+___
+	$code.="\trev32\t@x[$_].16b,@t[$_].16b\n" foreach (0..7);
+	&sm4_blocks(@x);
+$code.=<<___;
+	eor	@x[0].16b,@x[0].16b,$iv.16b
+___
+	$code.="\teor\t@x[$_].16b,@x[$_].16b,@t[$_-1].16b\n" foreach (1..7);
+$code.=<<___;
+	mov	$iv.16b,@t[7].16b
+	st1	{@x[0].16b-@x[3].16b},[$out],#64
+	st1	{@x[4].16b-@x[7].16b},[$out],#64
+	subs	$len,$len,#8
+	b.hs	.Lcbc_dec_loop8
+
+.Lcbc_dec_tail:
+	adds	$len,$len,#8
+	b.eq	.Lcbc_done
+.Lcbc_dec_loop1:
+	ld1	{@t[0].16b},[$inp],#16
+	rev32	@x[0].16b,@t[0].16b
+___
+	&sm4_blocks(@x[0]);
+$code.=<<___;
+	eor	@x[0].16b,@x[0].16b,$iv.16b
+	mov	$iv.16b,@t[0].16b
+	st1	{@x[0].16b},[$out],#16
+	subs	$len,$len,#1
+	b.ne	.Lcbc_dec_loop1
+
+.Lcbc_done:
+	st1	{$iv.16b},[$ivp]
+	ldr	d8,[sp],#16
+	ret
+.size	sm4_v8_cbc_encrypt,.-sm4_v8_cbc_encrypt
+___
+}
+
+{
+# void sm4_v8_ctr32_encrypt_blocks(const unsigned char *in,
+#                                  unsigned char *out, size_t blocks,
+#                                  const SM4_KEY *key,
+#                                  const unsigned char ivec[16]);
+#
+# The byte swapped counter block is what SM4E takes, so each block is
+# made by inserting the native counter into lane 3 of it.
+my $ctr="w6";
+$code.=<<___;
+.globl	sm4_v8_ctr32_encrypt_blocks
+.type	sm4_v8_ctr32_encrypt_blocks,%function
+.align	5
+sm4_v8_ctr32_encrypt_blocks:
+	str	d8,[sp,#-16]!
+___
+	&load_keys("enc");
+$code.=<<___;
+	ld1	{$iv.16b},[$ivp]
+	rev32	$iv.16b,$iv.16b
+	mov	$ctr,$iv.s[3]
+	subs	$len,$len,#8
+	b.lo	.Lctr32_tail
+
+.Lctr32_loop8:
+___
+	foreach (0..7) {
+$code.=<<___;
+	mov	@x[$_].16b,$iv.16b
+	mov	@x[$_].s[3],$ctr
+	add	$ctr,$ctr,#1
+___
+	}
+	&sm4_blocks(@x);
+$code.=<<___;
+	ld1	{@t[0].16b-@t[3].16b},[$inp],#64
+	ld1	{@t[4].16b-@t[7].16b},[$inp],#64
+___
+	$code.="\teor\t@x[$_].16b,@x[$_].16b,@t[$_].16b\n" foreach (0..7);
+$code.=<<___;
+	st1	{@x[0].16b-@x[3].16b},[$out],#64
+	st1	{@x[4].16b-@x[7].16b},[$out],#64
+	subs	$len,$len,#8
+	b.hs	.Lctr32_loop8
+
+.Lctr32_tail:
+	adds	$len,$len,#8
+	b.eq	.Lctr32_done
+.Lctr32_loop1:
+	mov	@x[0].16b,$iv.16b
+	mov	@x[0].s[3],$ctr
+	add	$ctr,$ctr,#1
+___
+	&sm4_blocks(@x[0]);
+$code.=<<___;
+	ld1	{@t[0].16b},[$inp],#16
+	eor	@x[0].16b,@x[0].16b,@t[0].16b
+	st1	{@x[0].16b},[$out],#16
+	subs	$len,$len,#1
+	b.ne	.Lctr32_loop1
+.Lctr32_done:
+	ldr	d8,[sp],#16
+	ret
+.size	sm4_v8_ctr32_encrypt_blocks,.-sm4_v8_ctr32_encrypt_blocks
+___
+}
+
+{   my  %opcode = (
+	"sm4e"		=> 0xcec08400,	"sm4ekey"	=> 0xce60c800	);
+
+    sub unsm4 {
+	my ($mnemonic,$arg)=@_;
+
+	$arg =~ m/[qv]([0-9]+)[^,]*,\s*[qv]([0-9]+)[^,]*(?:,\s*[qv]([0-9]+))?/o
+	&&
+	sprintf ".inst\t0x%08x\t//%s %s",
+			$opcode{$mnemonic}|$1|($2<<5)|($3<<16),
+			$mnemonic,$arg;
+    }
+}
+
+open SELF,$0;
+while(<SELF>) {
+        next if (/^#!/);
+        last if (!s/^#/\/\// and !/^$/);
+        print;
+}
+close SELF;
+
+foreach(split("\n",$code)) {
+	s/\`([^\`]*)\`/eval($1)/ge;
+
+	s/\b(sm4e\w*)\s+([qv].*)/unsm4($1,$2)/ge;
+
+	print $_,"\n";
+}
+
+close STDOUT or die "error closing STDOUT: $!";
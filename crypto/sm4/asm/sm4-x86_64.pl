@@ -0,0 +1,834 @@
+#! /usr/bin/env perl
+# Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+#
+# Licensed under the Apache License 2.0 (the "License").  You may not use
+# this file except in compliance with the License.  You can obtain a copy
+# in the file LICENSE in the source distribution or at
+# https://www.openssl.org/source/license.html
+
+#
+# SM4 for x86_64 with AES-NI and AVX or AVX2, or GFNI.
+#
+# The SM4 S-box and the AES one are both inversion in GF(2^8), with
+# different polynomials, wrapped in affine maps.  So the SM4 S-box is
+# an affine map, then the AES S-box, then another affine map, with the
+# field isomorphism folded into the two.  The affine maps are done a
+# nibble at a time with VPSHUFB, and the AES S-box with VAESENCLAST.
+# VAESENCLAST also does ShiftRows, which the byte shuffles of the linear
+# transform L undo for free.  With GFNI, the whole S-box is one
+# VGF2P8AFFINEQB and one VGF2P8AFFINEINVQB.
+#
+# Each register holds the same word of four blocks, so blocks are
+# transposed on the way in and out.  The rounds of one block depend on
+# each other, so two groups of blocks are interleaved to hide latency:
+# 8 blocks per iteration with AVX, 16 with AVX2.  Without VAES,
+# VAESENCLAST only does 128 bits, so the AVX2 code splits the registers
+# for it.
+#
+# In CTR mode the counter blocks are built transposed, which saves the
+# transposition on the way in.
+#
+# Cycles per byte, ECB encryption of 16KB:
+#
+#		AVX	AVX2	+VAES	+GFNI	C
+# Ice Lake	6.2	3.7	3.2	2.1	22
+#
+# Only sm4_avx_ecb_encrypt and sm4_avx_ctr32_encrypt_blocks are public.
+# The caller checks for AES-NI and AVX, the rest is picked here.
+
+# $output is the last argument if it looks like a file (it has an extension)
+# $flavour is the first argument if it doesn't look like a file
+$output = $#ARGV >= 0 && $ARGV[$#ARGV] =~ m|\.\w+$| ? pop : undef;
+$flavour = $#ARGV >= 0 && $ARGV[0] !~ m|\.| ? shift : undef;
+
+$win64=0; $win64=1 if ($flavour =~ /[nm]asm|mingw64/ || $output =~ /\.asm$/);
+
+$0 =~ m/(.*[\/\\])[^\/\\]+$/; $dir=$1;
+( $xlate="${dir}x86_64-xlate.pl" and -f $xlate ) or
+( $xlate="${dir}../../perlasm/x86_64-xlate.pl" and -f $xlate) or
+die "can't locate x86_64-xlate.pl";
+
+if (`$ENV{CC} -Wa,-v -c -o /dev/null -x assembler /dev/null 2>&1`
+		=~ /GNU assembler version ([2-9]\.[0-9]+)/) {
+	$avx = ($1>=2.19) + ($1>=2.22);
+	$gfni = ($1>=2.30);		# and VAES
+}
+
+if (!$avx && $win64 && ($flavour =~ /nasm/ || $ENV{ASM} =~ /nasm/) &&
+	   `nasm -v 2>&1` =~ /NASM version ([2-9]\.[0-9]+)/) {
+	$avx = ($1>=2.09) + ($1>=2.10);
+	$gfni = ($1>=2.14);
+}
+
+if (!$avx && $win64 && ($flavour =~ /masm/ || $ENV{ASM} =~ /ml64/) &&
+	   `ml64 2>&1` =~ /Version ([0-9]+)\./) {
+	$avx = ($1>=10) + ($1>=11);
+}
+
+if (!$avx && `$ENV{CC} -v 2>&1` =~ /((?:^clang|LLVM) version|.*based on LLVM) ([0-9]+\.[0-9]+)/) {
+	$avx = ($2>=3.0) + ($2>3.0);
+	$gfni = ($2>=7.0);
+}
+
+open OUT,"| \"$^X\" \"$xlate\" $flavour \"$output\""
+    or die "can't call $xlate: $!";
+*STDOUT=*OUT;
+
+if ($avx>1) {{{
+my ($inp,$out,$len,$key,$arg5)=("%rdi","%rsi","%rdx","%rcx","%r8");
+my $rk="%r10";				# round keys in use
+my $xframe = $win64 ? 0xa8 : 8;
+
+# Two groups of four registers with the state, and three temporaries each
+my @XA=(0..3);
+my @TA=(4..6);
+my @XB=(7..10);
+my @TB=(11..13);
+my $mask=14;				# 0x0f in every byte
+my $tmp=15;
+
+# Register $n for the width $w, "x" or "y"
+sub reg { my ($w,$n)=@_; return "%${w}mm$n"; }
+
+# The instructions for round $r%4 of one group, with the keys at %r11.
+sub round {
+my ($v,$w,$r,$X,$T)=@_;
+my ($x0,$x1,$x2,$x3)=map(reg($w,$X->[($r+$_)%4]),(0..3));
+my ($t0,$t1,$t2)=map(reg($w,$_),@$T);
+my ($t0x,$t1x)=map(reg("x",$_),@$T[0..1]);
+my $m=reg($w,$mask);
+my $mx=reg("x",$mask);
+my $bcast=$w eq "y" ? "vpbroadcastd" : "vbroadcastss";
+my @insn;
+
+    push @insn,split /\n/,<<___;
+	$bcast	`4*$r`(%r11),$t0
+	vpxor	$x1,$t0,$t0
+	vpxor	$x2,$t0,$t0
+	vpxor	$x3,$t0,$t0
+___
+    if ($v eq "gfni") {
+	push @insn,split /\n/,<<___;
+	vgf2p8affineqb	\$0x3e,.Lgfni_pre(%rip),$t0,$t0
+	vgf2p8affineinvqb	\$0xd3,.Lgfni_post(%rip),$t0,$t0
+	vpshufb	.Lrol8(%rip),$t0,$t2
+	vpxor	$t0,$x0,$x0
+	vpxor	$t0,$t2,$t2
+	vpshufb	.Lrol16(%rip),$t0,$t1
+	vpxor	$t1,$t2,$t2
+	vpshufb	.Lrol24(%rip),$t0,$t0
+___
+    } else {
+	push @insn,split /\n/,<<___;
+	vpsrld	\$4,$t0,$t1
+	vpand	$m,$t0,$t0
+	vpand	$m,$t1,$t1
+	vmovdqa	.Lpre_lo(%rip),$t2
+	vpshufb	$t0,$t2,$t0
+	vmovdqa	.Lpre_hi(%rip),$t2
+	vpshufb	$t1,$t2,$t1
+	vpxor	$t1,$t0,$t0
+___
+	if ($v eq "vaes") {
+	    push @insn,"	vaesenclast	$m,$t0,$t0";
+	} elsif ($w eq "y") {
+	    push @insn,split /\n/,<<___;
+	vextracti128	\$1,$t0,$t1x
+	vaesenclast	$mx,$t0x,$t0x
+	vaesenclast	$mx,$t1x,$t1x
+	vinserti128	\$1,$t1x,$t0,$t0
+___
+	} else {
+	    push @insn,"	vaesenclast	$mx,$t0x,$t0x";
+	}
+	push @insn,split /\n/,<<___;
+	vpsrld	\$4,$t0,$t1
+	vpand	$m,$t0,$t0
+	vpand	$m,$t1,$t1
+	vmovdqa	.Lpost_lo(%rip),$t2
+	vpshufb	$t0,$t2,$t0
+	vmovdqa	.Lpost_hi(%rip),$t2
+	vpshufb	$t1,$t2,$t1
+	vpxor	$t1,$t0,$t0
+	vpshufb	.Linvsr(%rip),$t0,$t1
+	vpshufb	.Linvsr_rol8(%rip),$t0,$t2
+	vpxor	$t1,$x0,$x0
+	vpxor	$t1,$t2,$t2
+	vpshufb	.Linvsr_rol16(%rip),$t0,$t1
+	vpxor	$t1,$t2,$t2
+	vpshufb	.Linvsr_rol24(%rip),$t0,$t0
+___
+    }
+    # x0 ^= s ^ (s <<< 24) ^ ((s ^ (s <<< 8) ^ (s <<< 16)) <<< 2)
+    push @insn,split /\n/,<<___;
+	vpxor	$t0,$x0,$x0
+	vpslld	\$2,$t2,$t1
+	vpsrld	\$30,$t2,$t2
+	vpxor	$t1,$x0,$x0
+	vpxor	$t2,$x0,$x0
+___
+    return @insn;
+}
+
+# Transposes the 4x4 matrix of words in each 128-bit lane of @r.
+sub transpose {
+my ($w,$r,$t)=@_;
+my ($r0,$r1,$r2,$r3)=map(reg($w,$_),@$r);
+my ($t0,$t1,$t2)=map(reg($w,$_),@$t);
+
+$code.=<<___;
+	vpunpckldq	$r1,$r0,$t0
+	vpunpckhdq	$r1,$r0,$t1
+	vpunpckldq	$r3,$r2,$t2
+	vpunpckhdq	$r3,$r2,$r3
+	vpunpcklqdq	$t2,$t0,$r0
+	vpunpckhqdq	$t2,$t0,$r1
+	vpunpcklqdq	$r3,$t1,$r2
+	vpunpckhqdq	$r3,$t1,$r3
+___
+}
+
+# The output registers, in the order of the blocks
+my @OA=reverse(@XA);
+my @OB=reverse(@XB);
+
+######################################################################
+#
+# _sm4_[aesni|vaes|gfni]_[x|y]
+#
+# Encrypts two groups of four (%xmm) or eight (%ymm) transposed and byte
+# swapped blocks in @XA and @XB with the round keys at $rk, and leaves the
+# blocks in @OA and @OB, in the original order and byte order.  Clobbers
+# %eax, %r11 and the temporaries.
+sub core {
+my ($v,$w)=@_;
+my $name="_sm4_${v}_$w";
+my $m=reg($w,$mask);
+
+$code.=<<___;
+.type	$name,\@abi-omnipotent
+.align	32
+$name:
+.cfi_startproc
+	vmovdqa		.Lmask4(%rip),$m
+	mov		$rk,%r11
+	mov		\$8,%eax
+	jmp		.Loop$name
+.align	32
+.Loop$name:
+___
+    for (my $r=0; $r<4; $r++) {
+	my @a=round($v,$w,$r,\@XA,\@TA);
+	my @b=round($v,$w,$r,\@XB,\@TB);
+
+	while (@a || @b) {
+	    $code.=shift(@a)."\n" if (@a);
+	    $code.=shift(@b)."\n" if (@b);
+	}
+    }
+$code.=<<___;
+	lea		16(%r11),%r11
+	dec		%eax
+	jnz		.Loop$name
+
+___
+    &transpose($w,\@OA,\@TA);
+    &transpose($w,\@OB,\@TB);
+    $code.="	vmovdqa		.Lbswap32(%rip),".reg($w,$tmp)."\n";
+    foreach (@OA,@OB) {
+	$code.="	vpshufb		".reg($w,$tmp).",".reg($w,$_).",".reg($w,$_)."\n";
+    }
+$code.=<<___;
+	ret
+.cfi_endproc
+.size	$name,.-$name
+___
+}
+
+&core("aesni","x");
+&core("aesni","y");
+&core("vaes","y") if ($gfni);
+&core("gfni","y") if ($gfni);
+
+# Sets up the frame and saves the registers Win64 wants kept.
+sub prologue {
+my ($name,$body)=@_;
+
+$code.=<<___;
+.globl	$name
+.type	$name,\@function,5
+.align	32
+$name:
+.cfi_startproc
+	mov		%rsp,%r9		# frame register
+.cfi_def_cfa_register	%r9
+	sub		\$0x180+$xframe,%rsp
+	and		\$-32,%rsp
+___
+$code.=<<___	if ($win64);
+	movaps		%xmm6,-0xa8(%r9)
+	movaps		%xmm7,-0x98(%r9)
+	movaps		%xmm8,-0x88(%r9)
+	movaps		%xmm9,-0x78(%r9)
+	movaps		%xmm10,-0x68(%r9)
+	movaps		%xmm11,-0x58(%r9)
+	movaps		%xmm12,-0x48(%r9)
+	movaps		%xmm13,-0x38(%r9)
+	movaps		%xmm14,-0x28(%r9)
+	movaps		%xmm15,-0x18(%r9)
+___
+$code.=<<___;
+$body:
+	vzeroupper
+___
+}
+
+# Wipes the stack and the registers, and returns.
+sub epilogue {
+my ($name,$epilogue)=@_;
+
+$code.=<<___;
+	vpxor		%xmm0,%xmm0,%xmm0
+___
+    for (my $i=0; $i<0x180; $i+=32) {
+	$code.="	vmovdqa		%ymm0,$i(%rsp)\n";
+    }
+$code.=<<___;
+	vzeroall
+___
+$code.=<<___	if ($win64);
+	movaps		-0xa8(%r9),%xmm6
+	movaps		-0x98(%r9),%xmm7
+	movaps		-0x88(%r9),%xmm8
+	movaps		-0x78(%r9),%xmm9
+	movaps		-0x68(%r9),%xmm10
+	movaps		-0x58(%r9),%xmm11
+	movaps		-0x48(%r9),%xmm12
+	movaps		-0x38(%r9),%xmm13
+	movaps		-0x28(%r9),%xmm14
+	movaps		-0x18(%r9),%xmm15
+___
+$code.=<<___;
+	lea		(%r9),%rsp
+.cfi_def_cfa_register	%rsp
+$epilogue:
+	ret
+.cfi_endproc
+.size	$name,.-$name
+___
+}
+
+# Jumps to the GFNI, VAES or AVX2 code if there is AVX2, else to the
+# AVX code.
+sub dispatch {
+my $pfx=shift;
+
+$code.=<<___;
+	mov		OPENSSL_ia32cap_P+8(%rip),%eax
+	test		\$0x20,%eax		# AVX2?
+	jz		${pfx}_avx
+___
+$code.=<<___	if ($gfni);
+	mov		OPENSSL_ia32cap_P+12(%rip),%eax
+	test		\$0x100,%eax		# GFNI?
+	jnz		${pfx}_gfni
+	test		\$0x200,%eax		# VAES?
+	jnz		${pfx}_vaes
+___
+$code.=<<___;
+	jmp		${pfx}_avx2
+___
+}
+
+######################################################################
+#
+# void sm4_avx_ecb_encrypt(const unsigned char *in, unsigned char *out,
+#			size_t len, const SM4_KEY *key, const int enc);
+#
+# len is in bytes, and a multiple of 16.  Decryption is encryption with
+# the round keys backwards, so it takes the SM4_set_key() schedule as well.
+{
+my $enc="%r8d";
+
+# Loads, byte swaps and transposes the blocks at $src, 16 bytes apart in
+# each group and 16*4 bytes between the groups for %xmm, 32 and 32*4
+# for %ymm.
+sub load_blocks {
+my ($w,$src)=@_;
+my $sz=$w eq "y" ? 32 : 16;
+my $t=reg($w,$tmp);
+
+    $code.="	vmovdqa		.Lbswap32(%rip),$t\n";
+    for (my $i=0; $i<4; $i++) {
+	my ($a,$b)=(reg($w,$XA[$i]),reg($w,$XB[$i]));
+	$code.=<<___;
+	vmovdqu		`$sz*$i`($src),$a
+	vmovdqu		`$sz*(4+$i)`($src),$b
+	vpshufb		$t,$a,$a
+	vpshufb		$t,$b,$b
+___
+    }
+    &transpose($w,\@XA,\@TA);
+    &transpose($w,\@XB,\@TB);
+}
+
+sub store_blocks {
+my ($w,$dst)=@_;
+my $sz=$w eq "y" ? 32 : 16;
+
+    for (my $i=0; $i<4; $i++) {
+	my ($a,$b)=(reg($w,$OA[$i]),reg($w,$OB[$i]));
+	$code.=<<___;
+	vmovdqu		$a,`$sz*$i`($dst)
+	vmovdqu		$b,`$sz*(4+$i)`($dst)
+___
+    }
+}
+
+&prologue("sm4_avx_ecb_encrypt",".Lecb_body");
+$code.=<<___;
+	shr		\$4,$len
+	jz		.Lecb_done
+	mov		$key,$rk
+	test		$enc,$enc
+	jnz		.Lecb_key
+	lea		0x100(%rsp),$rk		# reversed round keys
+___
+for (my $i=0; $i<8; $i++) {
+$code.=<<___;
+	vpshufd		\$0x1b,`16*(7-$i)`($key),%xmm0
+	vmovdqa		%xmm0,`16*$i`($rk)
+___
+}
+$code.=<<___;
+.Lecb_key:
+___
+&dispatch(".Lecb");
+
+foreach my $v ("aesni", $gfni ? ("vaes","gfni") : ()) {
+my $pfx=$v eq "aesni" ? ".Lecb_avx2" : ".Lecb_$v";
+$code.=<<___;
+.align	32
+$pfx:
+	cmp		\$16,$len
+	jb		.Lecb_avx
+___
+&load_blocks("y",$inp);
+$code.=<<___;
+	call		_sm4_${v}_y
+___
+&store_blocks("y",$out);
+$code.=<<___;
+	lea		0x100($inp),$inp
+	lea		0x100($out),$out
+	sub		\$16,$len
+	jmp		$pfx
+___
+}
+
+$code.=<<___;
+.align	32
+.Lecb_avx:
+	cmp		\$8,$len
+	jb		.Lecb_tail
+___
+&load_blocks("x",$inp);
+$code.=<<___;
+	call		_sm4_aesni_x
+___
+&store_blocks("x",$out);
+$code.=<<___;
+	lea		0x80($inp),$inp
+	lea		0x80($out),$out
+	sub		\$8,$len
+	jmp		.Lecb_avx
+
+.Lecb_tail:
+	test		$len,$len
+	jz		.Lecb_done
+	shl		\$4,$len
+	xor		%eax,%eax
+.Lecb_tail_in:
+	vmovdqu		($inp,%rax),%xmm0
+	vmovdqa		%xmm0,(%rsp,%rax)
+	add		\$16,%rax
+	cmp		$len,%rax
+	jb		.Lecb_tail_in
+___
+&load_blocks("x","%rsp");
+$code.=<<___;
+	call		_sm4_aesni_x
+___
+&store_blocks("x","%rsp");
+$code.=<<___;
+	xor		%eax,%eax
+.Lecb_tail_out:
+	vmovdqa		(%rsp,%rax),%xmm0
+	vmovdqu		%xmm0,($out,%rax)
+	add		\$16,%rax
+	cmp		$len,%rax
+	jb		.Lecb_tail_out
+
+.Lecb_done:
+___
+&epilogue("sm4_avx_ecb_encrypt",".Lecb_epilogue");
+}
+
+######################################################################
+#
+# void sm4_avx_ctr32_encrypt_blocks(const unsigned char *in,
+#			unsigned char *out, size_t blocks,
+#			const SM4_KEY *key, const unsigned char ivec[16]);
+#
+# Like the other ctr32 functions, only the last 32 bits of ivec count,
+# as a big endian number, and ivec is left as it is.
+{
+my $ivp="%r8";
+my $ctr="%r8d";				# once ivec is loaded
+
+# Builds the counter blocks, already transposed.  The words of the IV
+# are at 0x100(%rsp).
+sub counter_blocks {
+my ($w)=@_;
+my $bcast=$w eq "y" ? "vpbroadcastd" : "vbroadcastss";
+my $add=$w eq "y" ? ".Lctr_add_y" : ".Lctr_add_x";
+my $sz=$w eq "y" ? 32 : 16;
+my $t=reg($w,$tmp);
+
+    for (my $i=0; $i<3; $i++) {
+	my ($a,$b)=(reg($w,$XA[$i]),reg($w,$XB[$i]));
+	$code.=<<___;
+	$bcast	`0x100+4*$i`(%rsp),$a
+	vmovdqa		$a,$b
+___
+    }
+    $code.="	vmovd		$ctr,".reg("x",$tmp)."\n";
+    if ($w eq "y") {
+	$code.="	vpbroadcastd	".reg("x",$tmp).",$t\n";
+    } else {
+	$code.="	vpshufd		\$0,$t,$t\n";
+    }
+$code.=<<___;
+	vpaddd		$add(%rip),$t,@{[reg($w,$XA[3])]}
+	vpaddd		$add+$sz(%rip),$t,@{[reg($w,$XB[3])]}
+___
+}
+
+sub xor_blocks {
+my ($w)=@_;
+my $sz=$w eq "y" ? 32 : 16;
+
+    for (my $i=0; $i<4; $i++) {
+	my ($a,$b)=(reg($w,$OA[$i]),reg($w,$OB[$i]));
+	$code.=<<___;
+	vpxor		`$sz*$i`($inp),$a,$a
+	vpxor		`$sz*(4+$i)`($inp),$b,$b
+	vmovdqu		$a,`$sz*$i`($out)
+	vmovdqu		$b,`$sz*(4+$i)`($out)
+___
+    }
+}
+
+&prologue("sm4_avx_ctr32_encrypt_blocks",".Lctr32_body");
+$code.=<<___;
+	test		$len,$len
+	jz		.Lctr32_done
+	mov		$key,$rk
+	vmovdqu		($ivp),%xmm0
+	vpshufb		.Lbswap32(%rip),%xmm0,%xmm0
+	vmovdqa		%xmm0,0x100(%rsp)
+	vpextrd		\$3,%xmm0,$ctr
+___
+&dispatch(".Lctr32");
+
+foreach my $v ("aesni", $gfni ? ("vaes","gfni") : ()) {
+my $pfx=$v eq "aesni" ? ".Lctr32_avx2" : ".Lctr32_$v";
+$code.=<<___;
+.align	32
+$pfx:
+	cmp		\$16,$len
+	jb		.Lctr32_avx
+___
+&counter_blocks("y");
+$code.=<<___;
+	call		_sm4_${v}_y
+___
+&xor_blocks("y");
+$code.=<<___;
+	add		\$16,$ctr
+	lea		0x100($inp),$inp
+	lea		0x100($out),$out
+	sub		\$16,$len
+	jmp		$pfx
+___
+}
+
+$code.=<<___;
+.align	32
+.Lctr32_avx:
+	cmp		\$8,$len
+	jb		.Lctr32_tail
+___
+&counter_blocks("x");
+$code.=<<___;
+	call		_sm4_aesni_x
+___
+&xor_blocks("x");
+$code.=<<___;
+	add		\$8,$ctr
+	lea		0x80($inp),$inp
+	lea		0x80($out),$out
+	sub		\$8,$len
+	jmp		.Lctr32_avx
+
+.Lctr32_tail:
+	test		$len,$len
+	jz		.Lctr32_done
+___
+&counter_blocks("x");
+$code.=<<___;
+	call		_sm4_aesni_x
+___
+&store_blocks("x","%rsp");
+$code.=<<___;
+	shl		\$4,$len
+	xor		%eax,%eax
+.Lctr32_tail_loop:
+	vmovdqu		($inp,%rax),%xmm0
+	vpxor		(%rsp,%rax),%xmm0,%xmm0
+	vmovdqu		%xmm0,($out,%rax)
+	add		\$16,%rax
+	cmp		$len,%rax
+	jb		.Lctr32_tail_loop
+
+.Lctr32_done:
+___
+&epilogue("sm4_avx_ctr32_encrypt_blocks",".Lctr32_epilogue");
+}
+
+$code.=<<___;
+# int sm4_avx_eligible(void);
+#
+# Returns 1 as the functions above are real, the caller checks
+# OPENSSL_ia32cap_P for the processor features.
+.globl	sm4_avx_eligible
+.type	sm4_avx_eligible,\@abi-omnipotent
+.align	32
+sm4_avx_eligible:
+.cfi_startproc
+	mov	\$1,%eax
+	ret
+.cfi_endproc
+.size	sm4_avx_eligible,.-sm4_avx_eligible
+
+.align	64
+# Everything is repeated for both 128-bit lanes
+.Lbswap32:
+	.byte	3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12
+	.byte	3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12
+.Lmask4:
+	.quad	0x0f0f0f0f0f0f0f0f,0x0f0f0f0f0f0f0f0f
+	.quad	0x0f0f0f0f0f0f0f0f,0x0f0f0f0f0f0f0f0f
+# The affine map before the AES S-box, by low and high nibble
+.Lpre_lo:
+	.quad	0x078b37bb820eb23e,0x9814a8241d912da1
+	.quad	0x078b37bb820eb23e,0x9814a8241d912da1
+.Lpre_hi:
+	.quad	0x37eb19c5f22edc00,0x3fe311cdfa26d408
+	.quad	0x37eb19c5f22edc00,0x3fe311cdfa26d408
+# The affine map after it, including the 0x0f round key
+.Lpost_lo:
+	.quad	0x0bb3c179358dff47,0x6cd4a61e52ea9820
+	.quad	0x0bb3c179358dff47,0x6cd4a61e52ea9820
+.Lpost_hi:
+	.quad	0x2dcd7d9db050e000,0xed0dbd5d709020c0
+	.quad	0x2dcd7d9db050e000,0xed0dbd5d709020c0
+# Inverse ShiftRows, then rotation of each word by 0, 8, 16, 24 bits
+.Linvsr:
+	.quad	0x0b0e0104070a0d00,0x0306090c0f020508
+	.quad	0x0b0e0104070a0d00,0x0306090c0f020508
+.Linvsr_rol8:
+	.quad	0x0e01040b0a0d0007,0x06090c030205080f
+	.quad	0x0e01040b0a0d0007,0x06090c030205080f
+.Linvsr_rol16:
+	.quad	0x01040b0e0d00070a,0x090c030605080f02
+	.quad	0x01040b0e0d00070a,0x090c030605080f02
+.Linvsr_rol24:
+	.quad	0x040b0e0100070a0d,0x0c030609080f0205
+	.quad	0x040b0e0100070a0d,0x0c030609080f0205
+.Lrol8:
+	.quad	0x0605040702010003,0x0e0d0c0f0a09080b
+	.quad	0x0605040702010003,0x0e0d0c0f0a09080b
+.Lrol16:
+	.quad	0x0504070601000302,0x0d0c0f0e09080b0a
+	.quad	0x0504070601000302,0x0d0c0f0e09080b0a
+.Lrol24:
+	.quad	0x0407060500030201,0x0c0f0e0d080b0a09
+	.quad	0x0407060500030201,0x0c0f0e0d080b0a09
+# The matrices of the affine maps around the inversion, for GFNI
+.Lgfni_pre:
+	.quad	0x4c287db91a22505d,0x4c287db91a22505d
+	.quad	0x4c287db91a22505d,0x4c287db91a22505d
+.Lgfni_post:
+	.quad	0xf3ab34a974a6b589,0xf3ab34a974a6b589
+	.quad	0xf3ab34a974a6b589,0xf3ab34a974a6b589
+# Counter offsets, the %ymm ones in the order the blocks are transposed
+.Lctr_add_x:
+	.long	0,1,2,3,4,5,6,7
+.Lctr_add_y:
+	.long	0,2,4,6,1,3,5,7,8,10,12,14,9,11,13,15
+.asciz	"SM4 for x86_64, AES-NI/AVX2/GFNI"
+.align	64
+___
+
+# EXCEPTION_DISPOSITION handler (EXCEPTION_RECORD *rec,ULONG64 frame,
+#		CONTEXT *context,DISPATCHER_CONTEXT *disp)
+if ($win64) {
+$rec="%rcx";
+$frame="%rdx";
+$context="%r8";
+$disp="%r9";
+
+$code.=<<___;
+.extern	__imp_RtlVirtualUnwind
+.type	simd_handler,\@abi-omnipotent
+.align	16
+simd_handler:
+	push	%rsi
+	push	%rdi
+	push	%rbx
+	push	%rbp
+	push	%r12
+	push	%r13
+	push	%r14
+	push	%r15
+	pushfq
+	sub	\$64,%rsp
+
+	mov	120($context),%rax	# pull context->Rax
+	mov	248($context),%rbx	# pull context->Rip
+
+	mov	8($disp),%rsi		# disp->ImageBase
+	mov	56($disp),%r11		# disp->HandlerData
+
+	mov	0(%r11),%r10d		# HandlerData[0]
+	lea	(%rsi,%r10),%r10	# prologue label
+	cmp	%r10,%rbx		# context->Rip<prologue label
+	jb	.Lcommon_seh_tail
+
+	mov	192($context),%rax	# pull context->R9
+
+	mov	4(%r11),%r10d		# HandlerData[1]
+	mov	8(%r11),%ecx		# HandlerData[2]
+	lea	(%rsi,%r10),%r10	# epilogue label
+	cmp	%r10,%rbx		# context->Rip>=epilogue label
+	jae	.Lcommon_seh_tail
+
+	neg	%rcx
+	lea	-8(%rax,%rcx),%rsi
+	lea	512($context),%rdi	# &context.Xmm6
+	neg	%ecx
+	shr	\$3,%ecx
+	.long	0xa548f3fc		# cld; rep movsq
+
+.Lcommon_seh_tail:
+	mov	8(%rax),%rdi
+	mov	16(%rax),%rsi
+	mov	%rax,152($context)	# restore context->Rsp
+	mov	%rsi,168($context)	# restore context->Rsi
+	mov	%rdi,176($context)	# restore context->Rdi
+
+	mov	40($disp),%rdi		# disp->ContextRecord
+	mov	$context,%rsi		# context
+	mov	\$154,%ecx		# sizeof(CONTEXT)
+	.long	0xa548f3fc		# cld; rep movsq
+
+	mov	$disp,%rsi
+	xor	%rcx,%rcx		# arg1, UNW_FLAG_NHANDLER
+	mov	8(%rsi),%rdx		# arg2, disp->ImageBase
+	mov	0(%rsi),%r8		# arg3, disp->ControlPc
+	mov	16(%rsi),%r9		# arg4, disp->FunctionEntry
+	mov	40(%rsi),%r10		# disp->ContextRecord
+	lea	56(%rsi),%r11		# &disp->HandlerData
+	lea	24(%rsi),%r12		# &disp->EstablisherFrame
+	mov	%r10,32(%rsp)		# arg5
+	mov	%r11,40(%rsp)		# arg6
+	mov	%r12,48(%rsp)		# arg7
+	mov	%rcx,56(%rsp)		# arg8, (NULL)
+	call	*__imp_RtlVirtualUnwind(%rip)
+
+	mov	\$1,%eax		# ExceptionContinueSearch
+	add	\$64,%rsp
+	popfq
+	pop	%r15
+	pop	%r14
+	pop	%r13
+	pop	%r12
+	pop	%rbp
+	pop	%rbx
+	pop	%rdi
+	pop	%rsi
+	ret
+.size	simd_handler,.-simd_handler
+
+.section	.pdata
+.align	4
+	.rva	.LSEH_begin_sm4_avx_ecb_encrypt
+	.rva	.LSEH_end_sm4_avx_ecb_encrypt
+	.rva	.LSEH_info_sm4_avx_ecb_encrypt
+
+	.rva	.LSEH_begin_sm4_avx_ctr32_encrypt_blocks
+	.rva	.LSEH_end_sm4_avx_ctr32_encrypt_blocks
+	.rva	.LSEH_info_sm4_avx_ctr32_encrypt_blocks
+
+.section	.xdata
+.align	8
+.LSEH_info_sm4_avx_ecb_encrypt:
+	.byte	9,0,0,0
+	.rva	simd_handler
+	.rva	.Lecb_body,.Lecb_epilogue
+	.long	0xa0,0
+
+.LSEH_info_sm4_avx_ctr32_encrypt_blocks:
+	.byte	9,0,0,0
+	.rva	simd_handler
+	.rva	.Lctr32_body,.Lctr32_epilogue
+	.long	0xa0,0
+___
+}
+}}} else {{{
+$code=<<___;	# assembler is too old
+.text
+
+.globl	sm4_avx_ecb_encrypt
+.type	sm4_avx_ecb_encrypt,\@abi-omnipotent
+sm4_avx_ecb_encrypt:
+.cfi_startproc
+	ud2
+.cfi_endproc
+.size	sm4_avx_ecb_encrypt,.-sm4_avx_ecb_encrypt
+
+.globl	sm4_avx_ctr32_encrypt_blocks
+.type	sm4_avx_ctr32_encrypt_blocks,\@abi-omnipotent
+sm4_avx_ctr32_encrypt_blocks:
+.cfi_startproc
+	ud2
+.cfi_endproc
+.size	sm4_avx_ctr32_encrypt_blocks,.-sm4_avx_ctr32_encrypt_blocks
+
+.globl	sm4_avx_eligible
+.type	sm4_avx_eligible,\@abi-omnipotent
+sm4_avx_eligible:
+.cfi_startproc
+	xor	%eax,%eax
+	ret
+.cfi_endproc
+.size	sm4_avx_eligible,.-sm4_avx_eligible
+___
+}}}
+
+$code =~ s/\`([^\`]*)\`/eval($1)/gem;
+
+print $code;
+
+close STDOUT or die "error closing STDOUT: $!";
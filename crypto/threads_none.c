@@ -9,6 +9,7 @@
 
 #include <openssl/crypto.h>
 #include "internal/cryptlib.h"
+#include "internal/thread.h"
 
 #if !defined(OPENSSL_THREADS) || defined(CRYPTO_TDEBUG)
 
@@ -133,6 +134,17 @@ int CRYPTO_atomic_add(int *val, int amount, int *ret, CRYPTO_RWLOCK *lock)
     return 1;
 }
 
+CRYPTO_THREAD *ossl_crypto_thread_start(void (*routine)(void *data),
+                                        void *data)
+{
+    return NULL;
+}
+
+int ossl_crypto_thread_join(CRYPTO_THREAD *thread)
+{
+    return 0;
+}
+
 int openssl_init_fork_handlers(void)
 {
     return 0;
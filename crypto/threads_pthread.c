@@ -9,6 +9,7 @@
 
 #include <openssl/crypto.h>
 #include "internal/cryptlib.h"
+#include "internal/thread.h"
 
 #if defined(__sun)
 # include <atomic.h>
@@ -190,6 +191,48 @@ int CRYPTO_atomic_add(int *val, int amount, int *ret, CRYPTO_RWLOCK *lock)
     return 1;
 }
 
+struct crypto_thread_st {
+    pthread_t handle;
+    void (*routine)(void *data);
+    void *data;
+};
+
+static void *thread_start_thunk(void *vthread)
+{
+    CRYPTO_THREAD *thread = vthread;
+
+    thread->routine(thread->data);
+    return NULL;
+}
+
+CRYPTO_THREAD *ossl_crypto_thread_start(void (*routine)(void *data),
+                                        void *data)
+{
+    CRYPTO_THREAD *thread;
+
+    if ((thread = OPENSSL_malloc(sizeof(*thread))) == NULL)
+        return NULL;
+    thread->routine = routine;
+    thread->data = data;
+    if (pthread_create(&thread->handle, NULL, thread_start_thunk,
+                       thread) != 0) {
+        OPENSSL_free(thread);
+        return NULL;
+    }
+    return thread;
+}
+
+int ossl_crypto_thread_join(CRYPTO_THREAD *thread)
+{
+    int ret;
+
+    if (thread == NULL)
+        return 0;
+    ret = pthread_join(thread->handle, NULL) == 0;
+    OPENSSL_free(thread);
+    return ret;
+}
+
 # ifndef FIPS_MODE
 /* TODO(3.0): No fork protection in FIPS module yet! */
 
@@ -12,6 +12,7 @@
 #endif
 
 #include <openssl/crypto.h>
+#include "internal/thread.h"
 
 #if defined(OPENSSL_THREADS) && !defined(CRYPTO_TDEBUG) && defined(OPENSSL_SYS_WINDOWS)
 
@@ -159,6 +160,50 @@ int CRYPTO_atomic_add(int *val, int amount, int *ret, CRYPTO_RWLOCK *lock)
     return 1;
 }
 
+struct crypto_thread_st {
+    HANDLE handle;
+    void (*routine)(void *data);
+    void *data;
+};
+
+static DWORD WINAPI thread_start_thunk(LPVOID vthread)
+{
+    CRYPTO_THREAD *thread = vthread;
+
+    thread->routine(thread->data);
+    return 0;
+}
+
+CRYPTO_THREAD *ossl_crypto_thread_start(void (*routine)(void *data),
+                                        void *data)
+{
+    CRYPTO_THREAD *thread;
+
+    if ((thread = OPENSSL_malloc(sizeof(*thread))) == NULL)
+        return NULL;
+    thread->routine = routine;
+    thread->data = data;
+    thread->handle = CreateThread(NULL, 0, thread_start_thunk, thread, 0,
+                                  NULL);
+    if (thread->handle == NULL) {
+        OPENSSL_free(thread);
+        return NULL;
+    }
+    return thread;
+}
+
+int ossl_crypto_thread_join(CRYPTO_THREAD *thread)
+{
+    int ret;
+
+    if (thread == NULL)
+        return 0;
+    ret = WaitForSingleObject(thread->handle, INFINITE) == WAIT_OBJECT_0;
+    CloseHandle(thread->handle);
+    OPENSSL_free(thread);
+    return ret;
+}
+
 int openssl_init_fork_handlers(void)
 {
     return 0;
@@ -12,6 +12,16 @@
 
 # include "openssl/aes.h"
 
+# if defined(__x86_64) || defined(__x86_64__) || defined(_M_AMD64) || defined(_M_X64)
+/*
+ * AVX512F+BW+VL and VAES+VPCLMULQDQ, for the AVX-512 AES-GCM code and the
+ * GHASH code that CRYPTO_gcm128_init() sets up for it.
+ */
+#  define AVX512_VAES_CAPABLE \
+        ((OPENSSL_ia32cap_P[2] & 0xc0010000) == 0xc0010000 && \
+         (OPENSSL_ia32cap_P[3] & 0x600) == 0x600)
+# endif
+
 # ifdef VPAES_ASM
 int vpaes_set_encrypt_key(const unsigned char *userKey, int bits,
                           AES_KEY *key);
@@ -216,11 +226,55 @@ size_t aesni_gcm_encrypt(const unsigned char *in, unsigned char *out, size_t len
 size_t aesni_gcm_decrypt(const unsigned char *in, unsigned char *out, size_t len,
                          const void *key, unsigned char ivec[16], u64 *Xi);
 void gcm_ghash_avx(u64 Xi[2], const u128 Htable[16], const u8 *in, size_t len);
+void ossl_gcm_ghash_avx512(u64 Xi[2], const u128 Htable[16], const u8 *in,
+                           size_t len);
+size_t aesni_gcm_encrypt_avx512(const unsigned char *in, unsigned char *out,
+                                size_t len, const void *key,
+                                unsigned char ivec[16], u64 *Xi,
+                                const u128 *Hpow);
+size_t aesni_gcm_decrypt_avx512(const unsigned char *in, unsigned char *out,
+                                size_t len, const void *key,
+                                unsigned char ivec[16], u64 *Xi,
+                                const u128 *Hpow);
 
-#   define AES_gcm_encrypt aesni_gcm_encrypt
-#   define AES_gcm_decrypt aesni_gcm_decrypt
+/*
+ * The AVX-512 code uses the powers of H that CRYPTO_gcm128_init() sets up
+ * on the same processors, at the end of the context that |Xi| belongs to.
+ * It only does 256 bytes at a time, so shorter input is left to the AVX
+ * code.
+ */
+#   define AESNI_GCM_AVX512_CAPABLE AVX512_VAES_CAPABLE
+#   define AESNI_GCM_HPOW(xi) \
+        (((const GCM128_CONTEXT *)((const char *)(xi) \
+                                   - offsetof(GCM128_CONTEXT, Xi)))->Hpow)
+#   define AES_gcm_encrypt(in, out, len, key, ivec, Xi) \
+        ((len) >= 256 && AESNI_GCM_AVX512_CAPABLE \
+         ? aesni_gcm_encrypt_avx512(in, out, len, key, ivec, Xi, \
+                                    AESNI_GCM_HPOW(Xi)) \
+         : aesni_gcm_encrypt(in, out, len, key, ivec, Xi))
+#   define AES_gcm_decrypt(in, out, len, key, ivec, Xi) \
+        ((len) >= 256 && AESNI_GCM_AVX512_CAPABLE \
+         ? aesni_gcm_decrypt_avx512(in, out, len, key, ivec, Xi, \
+                                    AESNI_GCM_HPOW(Xi)) \
+         : aesni_gcm_decrypt(in, out, len, key, ivec, Xi))
 #   define AES_GCM_ASM(ctx)    (ctx->ctr == aesni_ctr32_encrypt_blocks && \
-                                ctx->gcm.ghash == gcm_ghash_avx)
+                                (ctx->gcm.ghash == gcm_ghash_avx || \
+                                 ctx->gcm.ghash == ossl_gcm_ghash_avx512))
+
+void aesni_xts_encrypt_avx512(const unsigned char *in, unsigned char *out,
+                              size_t length, const AES_KEY *key1,
+                              const AES_KEY *key2, const unsigned char iv[16]);
+void aesni_xts_decrypt_avx512(const unsigned char *in, unsigned char *out,
+                              size_t length, const AES_KEY *key1,
+                              const AES_KEY *key2, const unsigned char iv[16]);
+int aesni_xts_avx512_eligible(void);
+
+/*
+ * The same features as the GCM code, and an assembler that knew them.
+ * The AVX-512 functions take the place of aesni_xts_[en|de]crypt.
+ */
+#   define AESNI_XTS_AVX512_CAPABLE \
+        (AESNI_GCM_AVX512_CAPABLE && aesni_xts_avx512_eligible())
 #  endif
 
 
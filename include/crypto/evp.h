@@ -216,6 +216,8 @@ struct evp_md_st {
     OSSL_PROVIDER *prov;
     CRYPTO_REF_COUNT refcnt;
     CRYPTO_RWLOCK *lock;
+    /* Kept alive by the method store, see evp_method_set_immortal() */
+    int immortal;
     OSSL_OP_digest_newctx_fn *newctx;
     OSSL_OP_digest_init_fn *dinit;
     OSSL_OP_digest_update_fn *dupdate;
@@ -229,6 +231,7 @@ struct evp_md_st {
     OSSL_OP_digest_gettable_params_fn *gettable_params;
     OSSL_OP_digest_settable_ctx_params_fn *settable_ctx_params;
     OSSL_OP_digest_gettable_ctx_params_fn *gettable_ctx_params;
+    OSSL_OP_digest_digest_many_fn *digest_many;
 
 } /* EVP_MD */ ;
 
@@ -269,6 +272,8 @@ struct evp_cipher_st {
     OSSL_PROVIDER *prov;
     CRYPTO_REF_COUNT refcnt;
     CRYPTO_RWLOCK *lock;
+    /* Kept alive by the method store, see evp_method_set_immortal() */
+    int immortal;
     OSSL_OP_cipher_newctx_fn *newctx;
     OSSL_OP_cipher_encrypt_init_fn *einit;
     OSSL_OP_cipher_decrypt_init_fn *dinit;
@@ -283,6 +288,7 @@ struct evp_cipher_st {
     OSSL_OP_cipher_gettable_params_fn *gettable_params;
     OSSL_OP_cipher_gettable_ctx_params_fn *gettable_ctx_params;
     OSSL_OP_cipher_settable_ctx_params_fn *settable_ctx_params;
+    OSSL_OP_cipher_aead_cipher_fn *aead_cipher;
 } /* EVP_CIPHER */ ;
 
 /* Macros to code block cipher wrappers */
@@ -597,6 +603,15 @@ struct evp_pkey_st {
      */
     size_t dirty_cnt_copy;
 
+    /*
+     * Set once by EVP_PKEY_pin_to_provider(): the keymgmt that provider
+     * operations with |pin_libctx| and |pin_propquery| use, so that they
+     * don't have to fetch one.  |pin_keymgmt| is published last.
+     */
+    OPENSSL_CTX *pin_libctx;
+    char *pin_propquery;
+    EVP_KEYMGMT *pin_keymgmt;
+
     /* Cache of key object information */
     struct {
         int bits;
@@ -626,10 +641,13 @@ struct evp_pkey_st {
 void openssl_add_all_ciphers_int(void);
 void openssl_add_all_digests_int(void);
 void evp_cleanup_int(void);
+void evp_implicit_fetch_cleanup(void);
 void evp_app_cleanup_int(void);
 void *evp_pkey_export_to_provider(EVP_PKEY *pk, OPENSSL_CTX *libctx,
                                   EVP_KEYMGMT **keymgmt,
                                   const char *propquery);
+EVP_KEYMGMT *evp_pkey_pinned_keymgmt(EVP_PKEY *pk, OPENSSL_CTX *libctx,
+                                     const char *propquery);
 #ifndef FIPS_MODE
 int evp_pkey_downgrade(EVP_PKEY *pk);
 void evp_pkey_free_legacy(EVP_PKEY *x);
@@ -135,8 +135,19 @@ struct gcm128_context {
 #if !defined(OPENSSL_SMALL_FOOTPRINT)
     unsigned char Xn[48];
 #endif
+#if defined(__x86_64) || defined(__x86_64__) || \
+    defined(_M_AMD64) || defined(_M_X64)
+    /* H^16..H^1 for the AVX-512 code */
+    u128 Hpow[16];
+#endif
 };
 
+/* POLYVAL, RFC 8452, on top of the GHASH code */
+void ossl_polyval_init(GCM128_CONTEXT *ctx, const unsigned char key[16]);
+void ossl_polyval_update(GCM128_CONTEXT *ctx, const unsigned char *in,
+                         size_t len);
+void ossl_polyval_final(GCM128_CONTEXT *ctx, unsigned char out[16]);
+
 /*
  * The maximum permitted number of cipher blocks per data unit in XTS mode.
  * Reference IEEE Std 1619-2018.
@@ -17,4 +17,12 @@ int sha512_224_init(SHA512_CTX *);
 int sha512_256_init(SHA512_CTX *);
 int sha1_ctrl(SHA_CTX *ctx, int cmd, int mslen, void *ms);
 
+/* Digests of |num| messages, in parallel where the platform allows it */
+int sha1_digest_many(size_t num, const unsigned char *const in[],
+                     const size_t inl[], unsigned char *const out[]);
+int sha224_digest_many(size_t num, const unsigned char *const in[],
+                       const size_t inl[], unsigned char *const out[]);
+int sha256_digest_many(size_t num, const unsigned char *const in[],
+                       const size_t inl[], unsigned char *const out[]);
+
 #endif
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#ifndef OSSL_SM4_PLATFORM_H
+# define OSSL_SM4_PLATFORM_H
+
+# include <stddef.h>
+# include "crypto/sm4.h"
+
+/*
+ * All assembler SM4 code uses the round keys made by SM4_set_key(), and
+ * the functions that can decrypt take them in encryption order.
+ */
+# if defined(SM4_ASM) && defined(OPENSSL_CPUID_OBJ)
+#  if defined(__aarch64__)
+#   include "arm_arch.h"
+#   define HWSM4_CAPABLE (OPENSSL_armcap_P & ARMV8_SM4)
+#   define HWSM4_encrypt sm4_v8_encrypt
+#   define HWSM4_decrypt sm4_v8_decrypt
+#   define HWSM4_cbc_encrypt sm4_v8_cbc_encrypt
+#   define HWSM4_ecb_encrypt sm4_v8_ecb_encrypt
+#   define HWSM4_ctr32_encrypt_blocks sm4_v8_ctr32_encrypt_blocks
+
+void sm4_v8_encrypt(const unsigned char *in, unsigned char *out,
+                    const SM4_KEY *key);
+void sm4_v8_decrypt(const unsigned char *in, unsigned char *out,
+                    const SM4_KEY *key);
+void sm4_v8_cbc_encrypt(const unsigned char *in, unsigned char *out,
+                        size_t length, const SM4_KEY *key,
+                        unsigned char *ivec, const int enc);
+void sm4_v8_ecb_encrypt(const unsigned char *in, unsigned char *out,
+                        size_t length, const SM4_KEY *key, const int enc);
+void sm4_v8_ctr32_encrypt_blocks(const unsigned char *in, unsigned char *out,
+                                 size_t blocks, const SM4_KEY *key,
+                                 const unsigned char ivec[16]);
+#  endif /* __aarch64__ */
+
+#  if defined(__x86_64) || defined(__x86_64__) || \
+      defined(_M_AMD64) || defined(_M_X64)
+/* AES-NI and AVX, and an assembler that knows AVX2 */
+#   define SM4_AVX_CAPABLE                                              \
+        ((OPENSSL_ia32cap_P[1] & ((1 << (57 - 32)) | (1 << (60 - 32))))  \
+         == ((1 << (57 - 32)) | (1 << (60 - 32))) && sm4_avx_eligible())
+
+int sm4_avx_eligible(void);
+void sm4_avx_ecb_encrypt(const unsigned char *in, unsigned char *out,
+                         size_t length, const SM4_KEY *key, int enc);
+void sm4_avx_ctr32_encrypt_blocks(const unsigned char *in, unsigned char *out,
+                                  size_t blocks, const SM4_KEY *key,
+                                  const unsigned char ivec[16]);
+#  endif /* x86_64 */
+# endif /* SM4_ASM && OPENSSL_CPUID_OBJ */
+
+#endif /* OSSL_SM4_PLATFORM_H */
@@ -48,11 +48,22 @@ void *ossl_method_construct(OPENSSL_CTX *ctx, int operation_id,
                             int force_cache,
                             OSSL_METHOD_CONSTRUCT_METHOD *mcm, void *mcm_data);
 
+/*
+ * |pre| and |post| are optional, and are called before and after |fn| has
+ * been called for all the algorithms of one operation of one provider.
+ * |pre| may set |*result| to zero to skip that operation for that provider.
+ * Both return zero on error, which stops the walk through that provider.
+ */
 void ossl_algorithm_do_all(OPENSSL_CTX *libctx, int operation_id,
                            OSSL_PROVIDER *provider,
+                           int (*pre)(OSSL_PROVIDER *, int operation_id,
+                                      void *data, int *result),
                            void (*fn)(OSSL_PROVIDER *provider,
                                       const OSSL_ALGORITHM *algo,
                                       int no_store, void *data),
+                           int (*post)(OSSL_PROVIDER *, int operation_id,
+                                       int no_store, void *data,
+                                       int *result),
                            void *data);
 
 #endif
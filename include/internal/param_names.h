@@ -0,0 +1,201 @@
+/*
+ * WARNING: do not edit!
+ * Generated by crypto/param_names.pl
+ *
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#ifndef OSSL_INTERNAL_PARAM_NAMES_H
+# define OSSL_INTERNAL_PARAM_NAMES_H
+
+/*
+ * PIDX_xxx is the index of the key of OSSL_xxx, as returned by
+ * ossl_param_find_pidx().  Macros with the same key have the same index.
+ */
+# define PIDX_PROV_PARAM_NAME                           77
+# define PIDX_PROV_PARAM_VERSION                        134
+# define PIDX_PROV_PARAM_BUILDINFO                      35
+# define PIDX_PROV_PARAM_MODULE_FILENAME                75
+# define PIDX_PROV_PARAM_SELF_TEST_PHASE                111
+# define PIDX_PROV_PARAM_SELF_TEST_TYPE                 112
+# define PIDX_PROV_PARAM_SELF_TEST_DESC                 110
+# define PIDX_ALG_PARAM_DIGEST                          43
+# define PIDX_ALG_PARAM_CIPHER                          37
+# define PIDX_ALG_PARAM_MAC                             65
+# define PIDX_ALG_PARAM_PROPERTIES                      92
+# define PIDX_CIPHER_PARAM_PADDING                      85
+# define PIDX_CIPHER_PARAM_MODE                         74
+# define PIDX_CIPHER_PARAM_BLOCK_SIZE                   34
+# define PIDX_CIPHER_PARAM_FLAGS                        48
+# define PIDX_CIPHER_PARAM_KEYLEN                       64
+# define PIDX_CIPHER_PARAM_IVLEN                        54
+# define PIDX_CIPHER_PARAM_IV                           53
+# define PIDX_CIPHER_PARAM_NUM                          78
+# define PIDX_CIPHER_PARAM_ROUNDS                       98
+# define PIDX_CIPHER_PARAM_AEAD_TAG                     113
+# define PIDX_CIPHER_PARAM_AEAD_TLS1_AAD                126
+# define PIDX_CIPHER_PARAM_AEAD_TLS1_AAD_PAD            127
+# define PIDX_CIPHER_PARAM_AEAD_TLS1_IV_FIXED           128
+# define PIDX_CIPHER_PARAM_AEAD_TLS1_GET_IV_GEN         129
+# define PIDX_CIPHER_PARAM_AEAD_TLS1_SET_IV_INV         130
+# define PIDX_CIPHER_PARAM_AEAD_IVLEN                   54
+# define PIDX_CIPHER_PARAM_AEAD_TAGLEN                  114
+# define PIDX_CIPHER_PARAM_AEAD_MAC_KEY                 66
+# define PIDX_CIPHER_PARAM_RANDOM_KEY                   97
+# define PIDX_CIPHER_PARAM_RC2_KEYBITS                  63
+# define PIDX_CIPHER_PARAM_SPEED                        108
+# define PIDX_CIPHER_PARAM_XTS_SECTOR_SIZE              138
+# define PIDX_CIPHER_PARAM_ALG_ID                       31
+# define PIDX_CIPHER_PARAM_TLS1_MULTIBLOCK_MAX_SEND_FRAGMENT 125
+# define PIDX_CIPHER_PARAM_TLS1_MULTIBLOCK_MAX_BUFSIZE  124
+# define PIDX_CIPHER_PARAM_TLS1_MULTIBLOCK_INTERLEAVE   123
+# define PIDX_CIPHER_PARAM_TLS1_MULTIBLOCK_AAD          118
+# define PIDX_CIPHER_PARAM_TLS1_MULTIBLOCK_AAD_PACKLEN  119
+# define PIDX_CIPHER_PARAM_TLS1_MULTIBLOCK_ENC          120
+# define PIDX_CIPHER_PARAM_TLS1_MULTIBLOCK_ENC_IN       121
+# define PIDX_CIPHER_PARAM_TLS1_MULTIBLOCK_ENC_LEN      122
+# define PIDX_DIGEST_PARAM_XOFLEN                       137
+# define PIDX_DIGEST_PARAM_SSL3_MS                      109
+# define PIDX_DIGEST_PARAM_PAD_TYPE                     84
+# define PIDX_DIGEST_PARAM_MICALG                       73
+# define PIDX_DIGEST_PARAM_BLOCK_SIZE                   34
+# define PIDX_DIGEST_PARAM_SIZE                         107
+# define PIDX_DIGEST_PARAM_FLAGS                        48
+# define PIDX_DIGEST_PARAM_THREADS                      115
+# define PIDX_DIGEST_PARAM_CUSTOM                       40
+# define PIDX_DIGEST_NAME_MD5                           11
+# define PIDX_DIGEST_NAME_MD5_SHA1                      12
+# define PIDX_DIGEST_NAME_SHA1                          17
+# define PIDX_DIGEST_NAME_SHA2_224                      18
+# define PIDX_DIGEST_NAME_SHA2_256                      19
+# define PIDX_DIGEST_NAME_SHA2_384                      20
+# define PIDX_DIGEST_NAME_SHA2_512                      21
+# define PIDX_DIGEST_NAME_MD2                           9
+# define PIDX_DIGEST_NAME_MD4                           10
+# define PIDX_DIGEST_NAME_MDC2                          13
+# define PIDX_DIGEST_NAME_RIPEMD160                     15
+# define PIDX_DIGEST_NAME_SHA3_224                      22
+# define PIDX_DIGEST_NAME_SHA3_256                      23
+# define PIDX_DIGEST_NAME_SHA3_384                      24
+# define PIDX_DIGEST_NAME_SHA3_512                      25
+# define PIDX_DIGEST_NAME_KECCAK_KMAC128                4
+# define PIDX_DIGEST_NAME_KECCAK_KMAC256                5
+# define PIDX_MAC_PARAM_KEY                             62
+# define PIDX_MAC_PARAM_IV                              53
+# define PIDX_MAC_PARAM_CUSTOM                          40
+# define PIDX_MAC_PARAM_SALT                            102
+# define PIDX_MAC_PARAM_XOF                             136
+# define PIDX_MAC_PARAM_FLAGS                           48
+# define PIDX_MAC_PARAM_CIPHER                          37
+# define PIDX_MAC_PARAM_DIGEST                          43
+# define PIDX_MAC_PARAM_PROPERTIES                      92
+# define PIDX_MAC_PARAM_SIZE                            107
+# define PIDX_MAC_PARAM_BLOCK_SIZE                      34
+# define PIDX_MAC_NAME_CMAC                             0
+# define PIDX_MAC_NAME_HMAC                             2
+# define PIDX_MAC_NAME_KMAC128                          6
+# define PIDX_MAC_NAME_KMAC256                          7
+# define PIDX_KDF_PARAM_SECRET                          103
+# define PIDX_KDF_PARAM_KEY                             62
+# define PIDX_KDF_PARAM_SALT                            102
+# define PIDX_KDF_PARAM_PASSWORD                        86
+# define PIDX_KDF_PARAM_DIGEST                          43
+# define PIDX_KDF_PARAM_CIPHER                          37
+# define PIDX_KDF_PARAM_MAC                             65
+# define PIDX_KDF_PARAM_MAC_SIZE                        67
+# define PIDX_KDF_PARAM_PROPERTIES                      92
+# define PIDX_KDF_PARAM_ITER                            51
+# define PIDX_KDF_PARAM_MODE                            74
+# define PIDX_KDF_PARAM_PKCS5                           88
+# define PIDX_KDF_PARAM_UKM                             132
+# define PIDX_KDF_PARAM_CEK_ALG                         36
+# define PIDX_KDF_PARAM_SCRYPT_N                        76
+# define PIDX_KDF_PARAM_SCRYPT_R                        96
+# define PIDX_KDF_PARAM_SCRYPT_P                        81
+# define PIDX_KDF_PARAM_SCRYPT_MAXMEM                   70
+# define PIDX_KDF_PARAM_INFO                            50
+# define PIDX_KDF_PARAM_SEED                            105
+# define PIDX_KDF_PARAM_SSHKDF_XCGHASH                  135
+# define PIDX_KDF_PARAM_SSHKDF_SESSION_ID               106
+# define PIDX_KDF_PARAM_SSHKDF_TYPE                     131
+# define PIDX_KDF_PARAM_SIZE                            107
+# define PIDX_KDF_PARAM_CONSTANT                        38
+# define PIDX_KDF_NAME_HKDF                             1
+# define PIDX_KDF_NAME_PBKDF2                           14
+# define PIDX_KDF_NAME_SCRYPT                           16
+# define PIDX_KDF_NAME_SSHKDF                           26
+# define PIDX_KDF_NAME_SSKDF                            27
+# define PIDX_KDF_NAME_TLS1_PRF                         28
+# define PIDX_KDF_NAME_X942KDF                          29
+# define PIDX_KDF_NAME_X963KDF                          30
+# define PIDX_KDF_NAME_KBKDF                            3
+# define PIDX_KDF_NAME_KRB5KDF                          8
+# define PIDX_PKEY_PARAM_BITS                           33
+# define PIDX_PKEY_PARAM_MAX_SIZE                       69
+# define PIDX_PKEY_PARAM_SECURITY_BITS                  104
+# define PIDX_PKEY_PARAM_DIGEST                         43
+# define PIDX_PKEY_PARAM_PROPERTIES                     92
+# define PIDX_PKEY_PARAM_DEFAULT_DIGEST                 42
+# define PIDX_PKEY_PARAM_MANDATORY_DIGEST               68
+# define PIDX_PKEY_PARAM_PAD_MODE                       83
+# define PIDX_PKEY_PARAM_DIGEST_SIZE                    45
+# define PIDX_PKEY_PARAM_MGF1_DIGEST                    71
+# define PIDX_PKEY_PARAM_MGF1_PROPERTIES                72
+# define PIDX_PKEY_PARAM_PUB_KEY                        94
+# define PIDX_PKEY_PARAM_PRIV_KEY                       91
+# define PIDX_PKEY_PARAM_FFC_P                          81
+# define PIDX_PKEY_PARAM_FFC_G                          49
+# define PIDX_PKEY_PARAM_FFC_Q                          95
+# define PIDX_PKEY_PARAM_EC_NAME                        39
+# define PIDX_PKEY_PARAM_USE_COFACTOR_FLAG              133
+# define PIDX_PKEY_PARAM_USE_COFACTOR_ECDH              133
+# define PIDX_PKEY_PARAM_RSA_N                          76
+# define PIDX_PKEY_PARAM_RSA_E                          46
+# define PIDX_PKEY_PARAM_RSA_D                          41
+# define PIDX_PKEY_PARAM_RSA_FACTOR                     101
+# define PIDX_PKEY_PARAM_RSA_EXPONENT                   100
+# define PIDX_PKEY_PARAM_RSA_COEFFICIENT                99
+# define PIDX_PKEY_PARAM_RSA_BITS                       33
+# define PIDX_PKEY_PARAM_RSA_PRIMES                     90
+# define PIDX_EXCHANGE_PARAM_PAD                        82
+# define PIDX_EXCHANGE_PARAM_EC_ECDH_COFACTOR_MODE      47
+# define PIDX_EXCHANGE_PARAM_KDF_TYPE                   59
+# define PIDX_EXCHANGE_PARAM_KDF_DIGEST                 56
+# define PIDX_EXCHANGE_PARAM_KDF_DIGEST_PROPS           57
+# define PIDX_EXCHANGE_PARAM_KDF_OUTLEN                 58
+# define PIDX_EXCHANGE_PARAM_KDF_UKM                    60
+# define PIDX_EXCHANGE_PARAM_KDF_UKM_LEN                61
+# define PIDX_SIGNATURE_PARAM_ALGORITHM_ID              32
+# define PIDX_SIGNATURE_PARAM_PAD_MODE                  83
+# define PIDX_SIGNATURE_PARAM_DIGEST                    43
+# define PIDX_SIGNATURE_PARAM_PROPERTIES                92
+# define PIDX_SIGNATURE_PARAM_PSS_SALTLEN               93
+# define PIDX_SIGNATURE_PARAM_MGF1_DIGEST               71
+# define PIDX_SIGNATURE_PARAM_MGF1_PROPERTIES           72
+# define PIDX_SIGNATURE_PARAM_DIGEST_SIZE               45
+# define PIDX_SIGNATURE_PARAM_KAT                       55
+# define PIDX_ASYM_CIPHER_PARAM_PAD_MODE                83
+# define PIDX_ASYM_CIPHER_PARAM_MGF1_DIGEST             71
+# define PIDX_ASYM_CIPHER_PARAM_MGF1_DIGEST_PROPS       72
+# define PIDX_ASYM_CIPHER_PARAM_OAEP_DIGEST             43
+# define PIDX_ASYM_CIPHER_PARAM_OAEP_DIGEST_PROPS       44
+# define PIDX_ASYM_CIPHER_PARAM_OAEP_LABEL              79
+# define PIDX_ASYM_CIPHER_PARAM_OAEP_LABEL_LEN          80
+# define PIDX_ASYM_CIPHER_PARAM_TLS_CLIENT_VERSION      116
+# define PIDX_ASYM_CIPHER_PARAM_TLS_NEGOTIATED_VERSION  117
+# define PIDX_SERIALIZER_PARAM_CIPHER                   37
+# define PIDX_SERIALIZER_PARAM_PROPERTIES               92
+# define PIDX_SERIALIZER_PARAM_PASS                     87
+# define PIDX_PASSPHRASE_PARAM_INFO                     50
+# define PIDX_GEN_PARAM_POTENTIAL                       89
+# define PIDX_GEN_PARAM_ITERATION                       52
+# define PIDX_NUM 139
+
+int ossl_param_find_pidx(const char *key);
+
+#endif
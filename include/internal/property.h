@@ -28,6 +28,8 @@ int ossl_property_match_count(const OSSL_PROPERTY_LIST *query,
                               const OSSL_PROPERTY_LIST *defn);
 /* Free a parsed property list */
 void ossl_property_free(OSSL_PROPERTY_LIST *p);
+/* The string a precompiled query was made from */
+const char *ossl_property_query_string(const OSSL_PROPERTY_QUERY *query);
 
 
 /* Implementation store functions */
@@ -41,12 +43,18 @@ int ossl_method_store_remove(OSSL_METHOD_STORE *store, int nid,
                              const void *method);
 int ossl_method_store_fetch(OSSL_METHOD_STORE *store, int nid,
                             const char *prop_query, void **result);
+int ossl_method_store_fetch_query(OSSL_METHOD_STORE *store, int nid,
+                                  OSSL_PROPERTY_QUERY *query, void **result);
 int ossl_method_store_set_global_properties(OSSL_METHOD_STORE *store,
                                             const char *prop_query);
+int ossl_method_store_generation(OSSL_METHOD_STORE *store);
 
 /* property query cache functions */
 int ossl_method_store_cache_get(OSSL_METHOD_STORE *store, int nid,
                                 const char *prop_query, void **result);
+int ossl_method_store_cache_get_query(OSSL_METHOD_STORE *store, int nid,
+                                      const OSSL_PROPERTY_QUERY *query,
+                                      void **result);
 int ossl_method_store_cache_set(OSSL_METHOD_STORE *store, int nid,
                                 const char *prop_query, void *result,
                                 int (*method_up_ref)(void *),
@@ -74,6 +74,11 @@ const OSSL_ALGORITHM *ossl_provider_query_operation(const OSSL_PROVIDER *prov,
                                                     int operation_id,
                                                     int *no_cache);
 
+/* Cache of operations whose methods are all in the method store */
+int ossl_provider_set_operation_bit(OSSL_PROVIDER *prov, size_t bitnum);
+int ossl_provider_test_operation_bit(OSSL_PROVIDER *prov, size_t bitnum,
+                                     int *result);
+
 /* Configuration */
 void ossl_provider_add_conf_module(void);
 
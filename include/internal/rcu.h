@@ -0,0 +1,43 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#ifndef OSSL_INTERNAL_RCU_H
+# define OSSL_INTERNAL_RCU_H
+
+/*
+ * Read-copy-update locks, for data that is read a lot and written rarely.
+ *
+ * Readers access data published with ossl_rcu_assign_ptr() through
+ * ossl_rcu_deref() between ossl_rcu_read_lock() and ossl_rcu_read_unlock().
+ * That never blocks and, where atomics are available, only writes memory that
+ * is private to the reading thread's slot.
+ *
+ * Writers serialise with ossl_rcu_write_lock(), publish a new copy of the data
+ * and then call ossl_synchronize_rcu() before freeing the old copy.  Once that
+ * returns, no reader can still be looking at the old copy.
+ *
+ * Without atomics, all of this falls back to an ordinary CRYPTO_RWLOCK.
+ */
+
+typedef struct ossl_rcu_lock_st CRYPTO_RCU_LOCK;
+
+CRYPTO_RCU_LOCK *ossl_rcu_lock_new(void);
+void ossl_rcu_lock_free(CRYPTO_RCU_LOCK *lock);
+
+int ossl_rcu_read_lock(CRYPTO_RCU_LOCK *lock, int *token);
+void ossl_rcu_read_unlock(CRYPTO_RCU_LOCK *lock, int token);
+
+int ossl_rcu_write_lock(CRYPTO_RCU_LOCK *lock);
+void ossl_rcu_write_unlock(CRYPTO_RCU_LOCK *lock);
+void ossl_synchronize_rcu(CRYPTO_RCU_LOCK *lock);
+
+void *ossl_rcu_deref(void **p);
+void ossl_rcu_assign_ptr(void **p, void *v);
+
+#endif
@@ -49,4 +49,19 @@ int sha3_final(unsigned char *md, KECCAK1600_CTX *ctx);
 size_t SHA3_absorb(uint64_t A[5][5], const unsigned char *inp, size_t len,
                    size_t r);
 
+/*
+ * Keccak-p[1600] with the last |rounds| rounds of Keccak-f[1600], on plain
+ * lanes.  ossl_keccak1600_hash_many() hashes |num| messages of |len| bytes
+ * each, one after the other at |inp|, with domain byte |pad|, and writes
+ * |outlen| bytes, at most |r|, of each digest one after the other to |out|.
+ */
+size_t ossl_keccak1600_absorb(uint64_t A[5][5], const unsigned char *inp,
+                              size_t len, size_t r, size_t rounds);
+void ossl_keccak1600_squeeze(uint64_t A[5][5], unsigned char *out, size_t len,
+                             size_t r, size_t rounds);
+void ossl_keccak1600_hash_many(unsigned char *out, size_t outlen,
+                               const unsigned char *inp, size_t len,
+                               size_t num, size_t r, unsigned char pad,
+                               size_t rounds);
+
 #endif /* OSSL_INTERNAL_SHA3_H */
@@ -0,0 +1,31 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#ifndef OSSL_INTERNAL_THREAD_H
+# define OSSL_INTERNAL_THREAD_H
+
+/*
+ * Native threads, for work that can be split between processors.
+ *
+ * ossl_crypto_thread_start() runs |routine| with |data| in a new thread, and
+ * ossl_crypto_thread_join() waits for it to return and frees the handle.
+ * The routine must not use the error stack or anything else that keeps
+ * thread local state, as nothing cleans up after it.
+ *
+ * Without thread support ossl_crypto_thread_start() always returns NULL, and
+ * callers are expected to run the work themselves in that case.
+ */
+
+typedef struct crypto_thread_st CRYPTO_THREAD;
+
+CRYPTO_THREAD *ossl_crypto_thread_start(void (*routine)(void *data),
+                                        void *data);
+int ossl_crypto_thread_join(CRYPTO_THREAD *thread);
+
+#endif
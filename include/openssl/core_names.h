@@ -57,6 +57,7 @@ extern "C" {
 #define OSSL_CIPHER_PARAM_RANDOM_KEY           "randkey"    /* octet_string */
 #define OSSL_CIPHER_PARAM_RC2_KEYBITS          "keybits"    /* size_t */
 #define OSSL_CIPHER_PARAM_SPEED                "speed"      /* uint */
+#define OSSL_CIPHER_PARAM_XTS_SECTOR_SIZE      "xts_sector_size" /* size_t */
 /* For passing the AlgorithmIdentifier parameter in DER form */
 #define OSSL_CIPHER_PARAM_ALG_ID               "alg_id_param" /* octet_string */
 
@@ -85,6 +86,8 @@ extern "C" {
 #define OSSL_DIGEST_PARAM_BLOCK_SIZE "blocksize" /* size_t */
 #define OSSL_DIGEST_PARAM_SIZE       "size"      /* size_t */
 #define OSSL_DIGEST_PARAM_FLAGS      "flags"     /* ulong */
+#define OSSL_DIGEST_PARAM_THREADS    "threads"   /* uint */
+#define OSSL_DIGEST_PARAM_CUSTOM     "custom"    /* octet string */
 
 /* Known DIGEST names (not a complete list) */
 #define OSSL_DIGEST_NAME_MD5            "MD5"
@@ -120,6 +123,7 @@ extern "C" {
 #define OSSL_MAC_PARAM_DIGEST       OSSL_ALG_PARAM_DIGEST     /* utf8 string */
 #define OSSL_MAC_PARAM_PROPERTIES   OSSL_ALG_PARAM_PROPERTIES /* utf8 string */
 #define OSSL_MAC_PARAM_SIZE         "size"       /* size_t */
+#define OSSL_MAC_PARAM_BLOCK_SIZE   "blocksize"  /* size_t */
 
 /* Known MAC names (not a complete list) */
 #define OSSL_MAC_NAME_CMAC          "CMAC"
@@ -1101,7 +1101,8 @@ typedef enum {
     TLS_ST_EARLY_DATA,
     TLS_ST_PENDING_EARLY_DATA_END,
     TLS_ST_CW_END_OF_EARLY_DATA,
-    TLS_ST_SR_END_OF_EARLY_DATA
+    TLS_ST_SR_END_OF_EARLY_DATA,
+    TLS_ST_CR_COMP_CERT
 } OSSL_HANDSHAKE_STATE;
 
 /*
@@ -2223,6 +2224,24 @@ size_t SSL_get_num_tickets(const SSL *s);
 int SSL_CTX_set_num_tickets(SSL_CTX *ctx, size_t num_tickets);
 size_t SSL_CTX_get_num_tickets(const SSL_CTX *ctx);
 
+/* Certificate compression (RFC 8879) */
+__owur int SSL_CTX_set1_cert_comp_preference(SSL_CTX *ctx, int *algs,
+                                             size_t len);
+__owur int SSL_set1_cert_comp_preference(SSL *ssl, int *algs, size_t len);
+int SSL_get_negotiated_server_cert_comp_alg(const SSL *s);
+typedef int (*SSL_cert_comp_cb_fn)(SSL *s, unsigned char *out, size_t outlen,
+                                   const unsigned char *in, size_t inlen,
+                                   void *arg);
+__owur int SSL_CTX_set_cert_comp_callbacks(SSL_CTX *ctx, int alg,
+                                           SSL_cert_comp_cb_fn compress,
+                                           SSL_cert_comp_cb_fn expand,
+                                           void *arg);
+
+/* Pool of pregenerated ephemeral keys for key exchange */
+__owur int SSL_CTX_set_key_share_pool_size(SSL_CTX *ctx, size_t size);
+size_t SSL_CTX_get_key_share_pool_size(const SSL_CTX *ctx);
+int SSL_CTX_fill_key_share_pool(SSL_CTX *ctx);
+
 # ifndef OPENSSL_NO_DEPRECATED_1_1_0
 #  define SSL_cache_hit(s) SSL_session_reused(s)
 # endif
@@ -136,6 +136,9 @@ extern "C" {
 /* ExtensionType value from RFC7627 */
 # define TLSEXT_TYPE_extended_master_secret      23
 
+/* ExtensionType value from RFC8879 */
+# define TLSEXT_TYPE_compress_certificate        27
+
 /* ExtensionType value from RFC4507 */
 # define TLSEXT_TYPE_session_ticket              35
 
@@ -226,6 +229,14 @@ extern "C" {
 int SSL_CTX_set_tlsext_max_fragment_length(SSL_CTX *ctx, uint8_t mode);
 int SSL_set_tlsext_max_fragment_length(SSL *ssl, uint8_t mode);
 
+/* CertificateCompressionAlgorithm values from RFC8879 */
+# define TLSEXT_comp_cert_none                  0
+# define TLSEXT_comp_cert_zlib                  1
+# define TLSEXT_comp_cert_brotli                2
+# define TLSEXT_comp_cert_zstd                  3
+/* One more than the highest value above */
+# define TLSEXT_comp_cert_limit                 4
+
 # define TLSEXT_MAXLEN_host_name 255
 
 __owur const char *SSL_get_servername(const SSL *s, const int type);
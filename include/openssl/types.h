@@ -204,6 +204,7 @@ typedef struct ossl_item_st OSSL_ITEM;
 typedef struct ossl_algorithm_st OSSL_ALGORITHM;
 typedef struct ossl_param_st OSSL_PARAM;
 typedef struct ossl_param_bld_st OSSL_PARAM_BLD;
+typedef struct ossl_property_query_st OSSL_PROPERTY_QUERY;
 
 typedef int pem_password_cb (char *buf, int size, int rwflag, void *userdata);
 
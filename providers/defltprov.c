@@ -113,6 +113,10 @@ static const OSSL_ALGORITHM deflt_digests[] = {
     { "SHAKE-128:SHAKE128", "provider=default", shake_128_functions },
     { "SHAKE-256:SHAKE256", "provider=default", shake_256_functions },
 
+    /* RFC 9861 names, and the original name of KT128 */
+    { "KT128:KangarooTwelve", "provider=default", kt128_functions },
+    { "KT256", "provider=default", kt256_functions },
+
 #ifndef OPENSSL_NO_BLAKE2
     /*
      * https://blake2.net/ doesn't specify size variants,
@@ -125,6 +129,10 @@ static const OSSL_ALGORITHM deflt_digests[] = {
     { "BLAKE2B-512:BLAKE2b512", "provider=default", blake2b512_functions },
 #endif /* OPENSSL_NO_BLAKE2 */
 
+#ifndef OPENSSL_NO_BLAKE3
+    { "BLAKE3", "provider=default", blake3_functions },
+#endif /* OPENSSL_NO_BLAKE3 */
+
 #ifndef OPENSSL_NO_SM3
     { "SM3", "provider=default", sm3_functions },
 #endif /* OPENSSL_NO_SM3 */
@@ -171,6 +179,8 @@ static const OSSL_ALGORITHM_CAPABLE deflt_ciphers[] = {
     ALG("AES-128-SIV", aes128siv_functions),
     ALG("AES-192-SIV", aes192siv_functions),
     ALG("AES-256-SIV", aes256siv_functions),
+    ALG("AES-128-GCM-SIV", aes128gcm_siv_functions),
+    ALG("AES-256-GCM-SIV", aes256gcm_siv_functions),
 #endif /* OPENSSL_NO_SIV */
     ALG("AES-256-GCM:id-aes256-GCM", aes256gcm_functions),
     ALG("AES-192-GCM:id-aes192-GCM", aes192gcm_functions),
@@ -297,6 +307,8 @@ static const OSSL_ALGORITHM_CAPABLE deflt_ciphers[] = {
     ALG("SM4-CTR", sm4128ctr_functions),
     ALG("SM4-OFB:SM4-OFB128", sm4128ofb128_functions),
     ALG("SM4-CFB:SM4-CFB128", sm4128cfb128_functions),
+    ALG("SM4-GCM", sm4128gcm_functions),
+    ALG("SM4-CCM", sm4128ccm_functions),
 #endif /* OPENSSL_NO_SM4 */
 #ifndef OPENSSL_NO_RC4
     ALG("RC4", rc4128_functions),
@@ -334,6 +346,9 @@ static const OSSL_ALGORITHM deflt_macs[] = {
     { "BLAKE2BMAC", "provider=default", blake2bmac_functions },
     { "BLAKE2SMAC", "provider=default", blake2smac_functions },
 #endif
+#ifndef OPENSSL_NO_BLAKE3
+    { "BLAKE3MAC", "provider=default", blake3mac_functions },
+#endif
 #ifndef OPENSSL_NO_CMAC
     { "CMAC", "provider=default", cmac_functions },
 #endif
@@ -341,6 +356,10 @@ static const OSSL_ALGORITHM deflt_macs[] = {
     { "HMAC", "provider=default", hmac_functions },
     { "KMAC-128:KMAC128", "provider=default", kmac128_functions },
     { "KMAC-256:KMAC256", "provider=default", kmac256_functions },
+    { "PARALLELHASH-128:PARALLELHASH128", "provider=default",
+      parallelhash128_functions },
+    { "PARALLELHASH-256:PARALLELHASH256", "provider=default",
+      parallelhash256_functions },
 #ifndef OPENSSL_NO_SIPHASH
     { "SIPHASH", "provider=default", siphash_functions },
 #endif
@@ -365,6 +384,9 @@ static const OSSL_ALGORITHM deflt_kdfs[] = {
     { "SCRYPT:id-scrypt", "provider=default", kdf_scrypt_functions },
 #endif
     { "KRB5KDF", "provider=default", kdf_krb5kdf_functions },
+#ifndef OPENSSL_NO_BLAKE3
+    { "BLAKE3KDF", "provider=default", kdf_blake3_functions },
+#endif
     { NULL, NULL, NULL }
 };
 
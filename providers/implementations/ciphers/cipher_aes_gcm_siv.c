@@ -0,0 +1,462 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/* Dispatch functions for AES GCM-SIV mode, RFC 8452 */
+
+/*
+ * This file uses the low level AES functions (which are deprecated for
+ * non-internal use) in order to implement provider AES ciphers.
+ */
+#include "internal/deprecated.h"
+
+#include <string.h>
+#include <openssl/crypto.h>
+#include "cipher_aes_gcm_siv.h"
+#include "prov/implementations.h"
+#include "prov/providercommonerr.h"
+#include "prov/ciphercommon_aead.h"
+
+/*
+ * The tag depends on the whole plaintext and the ciphertext on the tag, so
+ * the message must be passed in a single update call.  The AAD may come in
+ * as many calls as needed before that.
+ */
+
+static void *aes_gcm_siv_newctx(void *provctx, size_t keybits)
+{
+    PROV_AES_GCM_SIV_CTX *ctx = OPENSSL_zalloc(sizeof(*ctx));
+
+    if (ctx != NULL) {
+        ctx->keylen = keybits / 8;
+        ctx->hw = PROV_CIPHER_HW_aes_gcm_siv(keybits);
+    }
+    return ctx;
+}
+
+static void aes_gcm_siv_freectx(void *vctx)
+{
+    PROV_AES_GCM_SIV_CTX *ctx = (PROV_AES_GCM_SIV_CTX *)vctx;
+
+    OPENSSL_clear_free(ctx, sizeof(*ctx));
+}
+
+static void *aes_gcm_siv_dupctx(void *vctx)
+{
+    PROV_AES_GCM_SIV_CTX *in = (PROV_AES_GCM_SIV_CTX *)vctx;
+    PROV_AES_GCM_SIV_CTX *ret = OPENSSL_malloc(sizeof(*ret));
+
+    if (ret == NULL) {
+        ERR_raise(ERR_LIB_PROV, ERR_R_MALLOC_FAILURE);
+        return NULL;
+    }
+    *ret = *in;
+    return ret;
+}
+
+static int gcm_siv_init(void *vctx, const unsigned char *key, size_t keylen,
+                        const unsigned char *iv, size_t ivlen, int enc)
+{
+    PROV_AES_GCM_SIV_CTX *ctx = (PROV_AES_GCM_SIV_CTX *)vctx;
+
+    ctx->enc = enc;
+    if (key != NULL) {
+        if (keylen != ctx->keylen) {
+            ERR_raise(ERR_LIB_PROV, PROV_R_INVALID_KEY_LENGTH);
+            return 0;
+        }
+        if (!ctx->hw->initkey(ctx, key, keylen))
+            return 0;
+        ctx->key_set = 1;
+    }
+    if (iv != NULL) {
+        if (ivlen != GCM_SIV_NONCE_LEN) {
+            ERR_raise(ERR_LIB_PROV, PROV_R_INVALID_IV_LENGTH);
+            return 0;
+        }
+        memcpy(ctx->nonce, iv, ivlen);
+        ctx->iv_set = 1;
+    }
+    ctx->started = 0;
+    ctx->done = 0;
+    ctx->tag_ok = 0;
+    ctx->aadlen = 0;
+    ctx->aadres = 0;
+    return 1;
+}
+
+static int gcm_siv_einit(void *vctx, const unsigned char *key, size_t keylen,
+                         const unsigned char *iv, size_t ivlen)
+{
+    return gcm_siv_init(vctx, key, keylen, iv, ivlen, 1);
+}
+
+static int gcm_siv_dinit(void *vctx, const unsigned char *key, size_t keylen,
+                         const unsigned char *iv, size_t ivlen)
+{
+    return gcm_siv_init(vctx, key, keylen, iv, ivlen, 0);
+}
+
+static int gcm_siv_start(PROV_AES_GCM_SIV_CTX *ctx)
+{
+    if (ctx->started)
+        return 1;
+    if (!ctx->key_set) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_NO_KEY_SET);
+        return 0;
+    }
+    if (!ctx->iv_set) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_CIPHER_OPERATION_FAILED);
+        return 0;
+    }
+    if (!ctx->hw->setiv(ctx))
+        return 0;
+    ctx->started = 1;
+    return 1;
+}
+
+static int gcm_siv_aad(PROV_AES_GCM_SIV_CTX *ctx, const unsigned char *aad,
+                       size_t len)
+{
+    size_t n;
+
+    if (ctx->done) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_CIPHER_OPERATION_FAILED);
+        return 0;
+    }
+    if (len > GCM_SIV_MAX_LEN - ctx->aadlen) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_BAD_LENGTH);
+        return 0;
+    }
+    if (!gcm_siv_start(ctx))
+        return 0;
+    if (len == 0)
+        return 1;
+    ctx->aadlen += len;
+
+    if (ctx->aadres > 0) {
+        n = sizeof(ctx->aadbuf) - ctx->aadres;
+        if (n > len)
+            n = len;
+        memcpy(ctx->aadbuf + ctx->aadres, aad, n);
+        ctx->aadres += n;
+        aad += n;
+        len -= n;
+        if (ctx->aadres < sizeof(ctx->aadbuf))
+            return 1;
+        ossl_polyval_update(&ctx->polyval, ctx->aadbuf, sizeof(ctx->aadbuf));
+        ctx->aadres = 0;
+    }
+    n = len & ~(size_t)15;
+    ossl_polyval_update(&ctx->polyval, aad, n);
+    memcpy(ctx->aadbuf, aad + n, len - n);
+    ctx->aadres = len - n;
+    return 1;
+}
+
+/* RFC 8452 section 4, from the POLYVAL of the padded plaintext onwards */
+static void gcm_siv_tag(PROV_AES_GCM_SIV_CTX *ctx, const unsigned char *in,
+                        size_t len, unsigned char tag[GCM_SIV_TAG_LEN])
+{
+    unsigned char blk[16];
+    uint64_t bits;
+    size_t n = len & ~(size_t)15;
+    int i;
+
+    ossl_polyval_update(&ctx->polyval, in, n);
+    if (len > n) {
+        memset(blk, 0, sizeof(blk));
+        memcpy(blk, in + n, len - n);
+        ossl_polyval_update(&ctx->polyval, blk, sizeof(blk));
+    }
+    for (i = 0, bits = ctx->aadlen * 8; i < 8; i++, bits >>= 8)
+        blk[i] = (unsigned char)bits;
+    for (i = 8, bits = (uint64_t)len * 8; i < 16; i++, bits >>= 8)
+        blk[i] = (unsigned char)bits;
+    ossl_polyval_update(&ctx->polyval, blk, sizeof(blk));
+
+    ossl_polyval_final(&ctx->polyval, blk);
+    for (i = 0; i < GCM_SIV_NONCE_LEN; i++)
+        blk[i] ^= ctx->nonce[i];
+    blk[15] &= 0x7f;
+    ctx->block(blk, tag, &ctx->ek.ks);
+    OPENSSL_cleanse(blk, sizeof(blk));
+}
+
+/* Encrypts or decrypts the whole message */
+static int gcm_siv_message(PROV_AES_GCM_SIV_CTX *ctx, unsigned char *out,
+                           const unsigned char *in, size_t len)
+{
+    unsigned char ctr[GCM_SIV_TAG_LEN], tag[GCM_SIV_TAG_LEN];
+
+    if (ctx->done) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_CIPHER_OPERATION_FAILED);
+        return 0;
+    }
+    if (len > GCM_SIV_MAX_LEN) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_BAD_LENGTH);
+        return 0;
+    }
+    if (!gcm_siv_start(ctx))
+        return 0;
+    ctx->done = 1;
+
+    if (ctx->aadres > 0) {
+        memset(ctx->aadbuf + ctx->aadres, 0,
+               sizeof(ctx->aadbuf) - ctx->aadres);
+        ossl_polyval_update(&ctx->polyval, ctx->aadbuf, sizeof(ctx->aadbuf));
+        ctx->aadres = 0;
+    }
+
+    if (ctx->enc) {
+        gcm_siv_tag(ctx, in, len, ctx->tag);
+        memcpy(ctr, ctx->tag, sizeof(ctr));
+        ctr[15] |= 0x80;
+        ctx->hw->ctr32(ctx, out, in, len, ctr);
+        return 1;
+    }
+
+    memcpy(ctr, ctx->tag, sizeof(ctr));
+    ctr[15] |= 0x80;
+    ctx->hw->ctr32(ctx, out, in, len, ctr);
+    gcm_siv_tag(ctx, out, len, tag);
+    ctx->tag_ok = CRYPTO_memcmp(tag, ctx->tag, sizeof(tag)) == 0;
+    OPENSSL_cleanse(tag, sizeof(tag));
+    if (!ctx->tag_ok) {
+        OPENSSL_cleanse(out, len);
+        return 0;
+    }
+    return 1;
+}
+
+static int gcm_siv_stream_update(void *vctx, unsigned char *out, size_t *outl,
+                                 size_t outsize, const unsigned char *in,
+                                 size_t inl)
+{
+    PROV_AES_GCM_SIV_CTX *ctx = (PROV_AES_GCM_SIV_CTX *)vctx;
+
+    if (inl == 0) {
+        *outl = 0;
+        return 1;
+    }
+
+    if (out == NULL) {
+        if (!gcm_siv_aad(ctx, in, inl))
+            return 0;
+        *outl = inl;
+        return 1;
+    }
+
+    if (outsize < inl) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_OUTPUT_BUFFER_TOO_SMALL);
+        return 0;
+    }
+    if (!gcm_siv_message(ctx, out, in, inl))
+        return 0;
+    *outl = inl;
+    return 1;
+}
+
+static int gcm_siv_stream_final(void *vctx, unsigned char *out, size_t *outl,
+                                size_t outsize)
+{
+    PROV_AES_GCM_SIV_CTX *ctx = (PROV_AES_GCM_SIV_CTX *)vctx;
+
+    /* An empty message, which still has a tag */
+    if (!ctx->done && !gcm_siv_message(ctx, NULL, NULL, 0))
+        return 0;
+    if (!ctx->enc && !ctx->tag_ok)
+        return 0;
+    *outl = 0;
+    return 1;
+}
+
+static int gcm_siv_cipher(void *vctx, unsigned char *out, size_t *outl,
+                          size_t outsize, const unsigned char *in, size_t inl)
+{
+    if (in == NULL)
+        return gcm_siv_stream_final(vctx, out, outl, outsize);
+    return gcm_siv_stream_update(vctx, out, outl, outsize, in, inl);
+}
+
+static int gcm_siv_aead_cipher(void *vctx,
+                               unsigned char *out, size_t *outl,
+                               size_t outsize,
+                               const unsigned char *in, size_t inl,
+                               const unsigned char *iv, size_t ivlen,
+                               const unsigned char *aad, size_t aadlen,
+                               unsigned char *tag, size_t taglen)
+{
+    PROV_AES_GCM_SIV_CTX *ctx = (PROV_AES_GCM_SIV_CTX *)vctx;
+
+    if (outsize < inl) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_OUTPUT_BUFFER_TOO_SMALL);
+        return 0;
+    }
+    if (taglen != GCM_SIV_TAG_LEN) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_INVALID_TAGLEN);
+        return 0;
+    }
+    if (!gcm_siv_init(ctx, NULL, 0, iv, ivlen, ctx->enc))
+        return 0;
+    if (!ctx->enc)
+        memcpy(ctx->tag, tag, taglen);
+
+    if (!gcm_siv_aad(ctx, aad, aadlen)
+        || !gcm_siv_message(ctx, out, in, inl))
+        return 0;
+    if (ctx->enc)
+        memcpy(tag, ctx->tag, taglen);
+
+    *outl = inl;
+    return 1;
+}
+
+static int aes_gcm_siv_get_ctx_params(void *vctx, OSSL_PARAM params[])
+{
+    PROV_AES_GCM_SIV_CTX *ctx = (PROV_AES_GCM_SIV_CTX *)vctx;
+    OSSL_PARAM *p;
+
+    p = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_AEAD_TAG);
+    if (p != NULL && p->data_type == OSSL_PARAM_OCTET_STRING) {
+        if (!ctx->enc || !ctx->done
+            || p->data_size != GCM_SIV_TAG_LEN
+            || !OSSL_PARAM_set_octet_string(p, ctx->tag, GCM_SIV_TAG_LEN)) {
+            ERR_raise(ERR_LIB_PROV, PROV_R_FAILED_TO_SET_PARAMETER);
+            return 0;
+        }
+    }
+    p = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_AEAD_TAGLEN);
+    if (p != NULL && !OSSL_PARAM_set_size_t(p, GCM_SIV_TAG_LEN)) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_FAILED_TO_SET_PARAMETER);
+        return 0;
+    }
+    p = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_IVLEN);
+    if (p != NULL && !OSSL_PARAM_set_size_t(p, GCM_SIV_NONCE_LEN)) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_FAILED_TO_SET_PARAMETER);
+        return 0;
+    }
+    p = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_KEYLEN);
+    if (p != NULL && !OSSL_PARAM_set_size_t(p, ctx->keylen)) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_FAILED_TO_SET_PARAMETER);
+        return 0;
+    }
+    return 1;
+}
+
+static const OSSL_PARAM aes_gcm_siv_known_gettable_ctx_params[] = {
+    OSSL_PARAM_size_t(OSSL_CIPHER_PARAM_KEYLEN, NULL),
+    OSSL_PARAM_size_t(OSSL_CIPHER_PARAM_IVLEN, NULL),
+    OSSL_PARAM_size_t(OSSL_CIPHER_PARAM_AEAD_TAGLEN, NULL),
+    OSSL_PARAM_octet_string(OSSL_CIPHER_PARAM_AEAD_TAG, NULL, 0),
+    OSSL_PARAM_END
+};
+static const OSSL_PARAM *aes_gcm_siv_gettable_ctx_params(void)
+{
+    return aes_gcm_siv_known_gettable_ctx_params;
+}
+
+static int aes_gcm_siv_set_ctx_params(void *vctx, const OSSL_PARAM params[])
+{
+    PROV_AES_GCM_SIV_CTX *ctx = (PROV_AES_GCM_SIV_CTX *)vctx;
+    const OSSL_PARAM *p;
+    size_t sz;
+
+    p = OSSL_PARAM_locate_const(params, OSSL_CIPHER_PARAM_AEAD_TAG);
+    if (p != NULL) {
+        if (p->data_type != OSSL_PARAM_OCTET_STRING) {
+            ERR_raise(ERR_LIB_PROV, PROV_R_FAILED_TO_GET_PARAMETER);
+            return 0;
+        }
+        if (p->data_size != GCM_SIV_TAG_LEN) {
+            ERR_raise(ERR_LIB_PROV, PROV_R_INVALID_TAGLEN);
+            return 0;
+        }
+        /* Only the length is given when encrypting, and it's fixed anyway */
+        if (p->data != NULL) {
+            if (ctx->enc || ctx->done) {
+                ERR_raise(ERR_LIB_PROV, PROV_R_TAG_NOT_NEEDED);
+                return 0;
+            }
+            memcpy(ctx->tag, p->data, GCM_SIV_TAG_LEN);
+        }
+    }
+    p = OSSL_PARAM_locate_const(params, OSSL_CIPHER_PARAM_IVLEN);
+    if (p != NULL) {
+        if (!OSSL_PARAM_get_size_t(p, &sz)) {
+            ERR_raise(ERR_LIB_PROV, PROV_R_FAILED_TO_GET_PARAMETER);
+            return 0;
+        }
+        if (sz != GCM_SIV_NONCE_LEN) {
+            ERR_raise(ERR_LIB_PROV, PROV_R_INVALID_IV_LENGTH);
+            return 0;
+        }
+    }
+    p = OSSL_PARAM_locate_const(params, OSSL_CIPHER_PARAM_KEYLEN);
+    if (p != NULL) {
+        if (!OSSL_PARAM_get_size_t(p, &sz)) {
+            ERR_raise(ERR_LIB_PROV, PROV_R_FAILED_TO_GET_PARAMETER);
+            return 0;
+        }
+        /* The key length can not be modified */
+        if (sz != ctx->keylen)
+            return 0;
+    }
+    return 1;
+}
+
+static const OSSL_PARAM aes_gcm_siv_known_settable_ctx_params[] = {
+    OSSL_PARAM_size_t(OSSL_CIPHER_PARAM_KEYLEN, NULL),
+    OSSL_PARAM_size_t(OSSL_CIPHER_PARAM_IVLEN, NULL),
+    OSSL_PARAM_octet_string(OSSL_CIPHER_PARAM_AEAD_TAG, NULL, 0),
+    OSSL_PARAM_END
+};
+static const OSSL_PARAM *aes_gcm_siv_settable_ctx_params(void)
+{
+    return aes_gcm_siv_known_settable_ctx_params;
+}
+
+#define IMPLEMENT_cipher(alg, lc, UCMODE, flags, kbits, blkbits, ivbits)       \
+static OSSL_OP_cipher_get_params_fn alg##_##kbits##_##lc##_get_params;         \
+static int alg##_##kbits##_##lc##_get_params(OSSL_PARAM params[])              \
+{                                                                              \
+    return cipher_generic_get_params(params, EVP_CIPH_##UCMODE##_MODE,         \
+                                     flags, kbits, blkbits, ivbits);           \
+}                                                                              \
+static OSSL_OP_cipher_newctx_fn alg##kbits##lc##_newctx;                       \
+static void * alg##kbits##lc##_newctx(void *provctx)                           \
+{                                                                              \
+    return alg##_##lc##_newctx(provctx, kbits);                                \
+}                                                                              \
+const OSSL_DISPATCH alg##kbits##lc##_functions[] = {                           \
+    { OSSL_FUNC_CIPHER_NEWCTX, (void (*)(void))alg##kbits##lc##_newctx },      \
+    { OSSL_FUNC_CIPHER_FREECTX, (void (*)(void))alg##_##lc##_freectx },        \
+    { OSSL_FUNC_CIPHER_DUPCTX, (void (*)(void))alg##_##lc##_dupctx },          \
+    { OSSL_FUNC_CIPHER_ENCRYPT_INIT, (void (*)(void)) lc##_einit },            \
+    { OSSL_FUNC_CIPHER_DECRYPT_INIT, (void (*)(void)) lc##_dinit },            \
+    { OSSL_FUNC_CIPHER_UPDATE, (void (*)(void)) lc##_stream_update },          \
+    { OSSL_FUNC_CIPHER_FINAL, (void (*)(void)) lc##_stream_final },            \
+    { OSSL_FUNC_CIPHER_CIPHER, (void (*)(void)) lc##_cipher },                 \
+    { OSSL_FUNC_CIPHER_AEAD_CIPHER, (void (*)(void)) lc##_aead_cipher },       \
+    { OSSL_FUNC_CIPHER_GET_PARAMS,                                             \
+      (void (*)(void)) alg##_##kbits##_##lc##_get_params },                    \
+    { OSSL_FUNC_CIPHER_GETTABLE_PARAMS,                                        \
+      (void (*)(void))cipher_generic_gettable_params },                        \
+    { OSSL_FUNC_CIPHER_GET_CTX_PARAMS,                                         \
+      (void (*)(void)) alg##_##lc##_get_ctx_params },                          \
+    { OSSL_FUNC_CIPHER_GETTABLE_CTX_PARAMS,                                    \
+      (void (*)(void)) alg##_##lc##_gettable_ctx_params },                     \
+    { OSSL_FUNC_CIPHER_SET_CTX_PARAMS,                                         \
+      (void (*)(void)) alg##_##lc##_set_ctx_params },                          \
+    { OSSL_FUNC_CIPHER_SETTABLE_CTX_PARAMS,                                    \
+      (void (*)(void)) alg##_##lc##_settable_ctx_params },                     \
+    { 0, NULL }                                                                \
+};
+
+IMPLEMENT_cipher(aes, gcm_siv, GCM_SIV, AEAD_FLAGS, 128, 8, 96)
+IMPLEMENT_cipher(aes, gcm_siv, GCM_SIV, AEAD_FLAGS, 256, 8, 96)
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <openssl/aes.h>
+#include "prov/ciphercommon.h"
+#include "crypto/aes_platform.h"
+
+#define GCM_SIV_NONCE_LEN   12
+#define GCM_SIV_TAG_LEN     16
+/* RFC 8452 section 6: 2^36 bytes for the message and for the AAD */
+#define GCM_SIV_MAX_LEN     ((uint64_t)1 << 36)
+
+typedef struct prov_aes_gcm_siv_ctx_st PROV_AES_GCM_SIV_CTX;
+
+typedef struct prov_cipher_hw_aes_gcm_siv_st {
+    /* Sets up the key generating key */
+    int (*initkey)(PROV_AES_GCM_SIV_CTX *ctx, const unsigned char *key,
+                   size_t keylen);
+    /* Derives the authentication and encryption keys for the nonce */
+    int (*setiv)(PROV_AES_GCM_SIV_CTX *ctx);
+    /* CTR mode with the little endian 32 bit counter in the first word */
+    void (*ctr32)(PROV_AES_GCM_SIV_CTX *ctx, unsigned char *out,
+                  const unsigned char *in, size_t len,
+                  const unsigned char ctr[16]);
+} PROV_CIPHER_HW_AES_GCM_SIV;
+
+struct prov_aes_gcm_siv_ctx_st {
+    unsigned int enc : 1;       /* Set to 1 if we are encrypting */
+    unsigned int key_set : 1;   /* The key generating key is set */
+    unsigned int iv_set : 1;    /* The nonce is set */
+    unsigned int started : 1;   /* The keys for the nonce are derived */
+    unsigned int done : 1;      /* The message has been processed */
+    unsigned int tag_ok : 1;    /* Result of the tag check on decryption */
+    size_t keylen;
+    uint64_t aadlen;
+    size_t aadres;              /* Number of bytes in |aadbuf| */
+    union {
+        OSSL_UNION_ALIGN;
+        AES_KEY ks;
+    } kgk, ek;                  /* key generating and encryption keys */
+    block128_f block;
+    ecb128_f ecb;               /* Optional, for many blocks at once */
+    GCM128_CONTEXT polyval;
+    unsigned char nonce[GCM_SIV_NONCE_LEN];
+    unsigned char tag[GCM_SIV_TAG_LEN];
+    unsigned char aadbuf[16];
+    const PROV_CIPHER_HW_AES_GCM_SIV *hw;
+};
+
+const PROV_CIPHER_HW_AES_GCM_SIV *PROV_CIPHER_HW_aes_gcm_siv(size_t keybits);
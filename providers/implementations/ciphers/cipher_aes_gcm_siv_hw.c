@@ -0,0 +1,156 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * This file uses the low level AES functions (which are deprecated for
+ * non-internal use) in order to implement provider AES ciphers.
+ */
+#include "internal/deprecated.h"
+
+#include <string.h>
+#include "cipher_aes_gcm_siv.h"
+#include "prov/providercommonerr.h"
+
+/* Number of counter blocks encrypted at a time */
+#define CTR_BLOCKS      32
+
+/* Sets up |ks| for encryption, with the fastest AES code there is */
+static int aes_gcm_siv_setkey(PROV_AES_GCM_SIV_CTX *ctx, AES_KEY *ks,
+                              const unsigned char *key, size_t keylen)
+{
+    int ret;
+
+    ctx->ecb = NULL;
+#ifdef AESNI_CAPABLE
+    if (AESNI_CAPABLE) {
+        ret = aesni_set_encrypt_key(key, keylen * 8, ks);
+        ctx->block = (block128_f)aesni_encrypt;
+        ctx->ecb = (ecb128_f)aesni_ecb_encrypt;
+    } else
+#endif
+#ifdef HWAES_CAPABLE
+    if (HWAES_CAPABLE) {
+        ret = HWAES_set_encrypt_key(key, keylen * 8, ks);
+        ctx->block = (block128_f)HWAES_encrypt;
+# ifdef HWAES_ecb_encrypt
+        ctx->ecb = (ecb128_f)HWAES_ecb_encrypt;
+# endif
+    } else
+#endif
+#ifdef VPAES_CAPABLE
+    if (VPAES_CAPABLE) {
+        ret = vpaes_set_encrypt_key(key, keylen * 8, ks);
+        ctx->block = (block128_f)vpaes_encrypt;
+    } else
+#endif
+    {
+        ret = AES_set_encrypt_key(key, keylen * 8, ks);
+        ctx->block = (block128_f)AES_encrypt;
+    }
+
+    if (ret < 0) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_AES_KEY_SETUP_FAILED);
+        return 0;
+    }
+    return 1;
+}
+
+static int aes_gcm_siv_initkey(PROV_AES_GCM_SIV_CTX *ctx,
+                               const unsigned char *key, size_t keylen)
+{
+    return aes_gcm_siv_setkey(ctx, &ctx->kgk.ks, key, keylen);
+}
+
+/* RFC 8452 section 4: the per nonce keys are 8 bytes of each of a few blocks */
+static int aes_gcm_siv_setiv(PROV_AES_GCM_SIV_CTX *ctx)
+{
+    unsigned char in[16], out[16], keys[16 + 32];
+    size_t i, n = (16 + ctx->keylen) / 8;
+    int ret;
+
+    memcpy(in + 4, ctx->nonce, GCM_SIV_NONCE_LEN);
+    for (i = 0; i < n; i++) {
+        in[0] = (unsigned char)i;
+        in[1] = in[2] = in[3] = 0;
+        ctx->block(in, out, &ctx->kgk.ks);
+        memcpy(keys + 8 * i, out, 8);
+    }
+    ossl_polyval_init(&ctx->polyval, keys);
+    ret = aes_gcm_siv_setkey(ctx, &ctx->ek.ks, keys + 16, ctx->keylen);
+
+    OPENSSL_cleanse(out, sizeof(out));
+    OPENSSL_cleanse(keys, sizeof(keys));
+    return ret;
+}
+
+/*
+ * The counter only wraps around in its first 32 bits, in little endian order,
+ * so none of the assembler ctr32 routines fit.  Instead, the counter blocks
+ * are made up here and encrypted many at a time in ECB mode, which runs as
+ * fast as CTR mode where it's available.
+ */
+static void aes_gcm_siv_ctr32(PROV_AES_GCM_SIV_CTX *ctx, unsigned char *out,
+                              const unsigned char *in, size_t len,
+                              const unsigned char ivec[16])
+{
+    union {
+        OSSL_UNION_ALIGN;
+        unsigned char c[CTR_BLOCKS * 16];
+    } ctr, ks;
+    uint32_t c = (uint32_t)ivec[0] | (uint32_t)ivec[1] << 8
+                 | (uint32_t)ivec[2] << 16 | (uint32_t)ivec[3] << 24;
+    size_t i, n, blocks, used = (len + 15) / 16;
+
+    if (used > CTR_BLOCKS)
+        used = CTR_BLOCKS;
+    for (i = 0; i < used; i++)
+        memcpy(ctr.c + 16 * i, ivec, 16);
+
+    while (len > 0) {
+        n = len < sizeof(ks.c) ? len : sizeof(ks.c);
+        blocks = (n + 15) / 16;
+        for (i = 0; i < blocks; i++, c++) {
+            ctr.c[16 * i] = (unsigned char)c;
+            ctr.c[16 * i + 1] = (unsigned char)(c >> 8);
+            ctr.c[16 * i + 2] = (unsigned char)(c >> 16);
+            ctr.c[16 * i + 3] = (unsigned char)(c >> 24);
+        }
+        if (ctx->ecb != NULL) {
+            ctx->ecb(ctr.c, ks.c, blocks * 16, &ctx->ek.ks, 1);
+        } else {
+            for (i = 0; i < blocks; i++)
+                ctx->block(ctr.c + 16 * i, ks.c + 16 * i, &ctx->ek.ks);
+        }
+        for (i = 0; i + sizeof(size_t) <= n; i += sizeof(size_t)) {
+            size_t a, b;
+
+            memcpy(&a, in + i, sizeof(a));
+            memcpy(&b, ks.c + i, sizeof(b));
+            a ^= b;
+            memcpy(out + i, &a, sizeof(a));
+        }
+        for (; i < n; i++)
+            out[i] = in[i] ^ ks.c[i];
+        in += n;
+        out += n;
+        len -= n;
+    }
+    OPENSSL_cleanse(ks.c, used * 16);
+}
+
+static const PROV_CIPHER_HW_AES_GCM_SIV aes_gcm_siv_hw = {
+    aes_gcm_siv_initkey,
+    aes_gcm_siv_setiv,
+    aes_gcm_siv_ctr32
+};
+
+const PROV_CIPHER_HW_AES_GCM_SIV *PROV_CIPHER_HW_aes_gcm_siv(size_t keybits)
+{
+    return &aes_gcm_siv_hw;
+}
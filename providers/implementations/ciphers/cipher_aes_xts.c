@@ -1,5 +1,5 @@
 /*
- * Copyright 2019 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2019-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -145,10 +145,25 @@ static void *aes_xts_dupctx(void *vctx)
     return ret;
 }
 
+/* Encrypts or decrypts one data unit with the tweak in |iv| */
+static int aes_xts_data_unit(PROV_AES_XTS_CTX *ctx, unsigned char *out,
+                             const unsigned char *in, size_t len,
+                             const unsigned char *iv)
+{
+    if (ctx->stream != NULL)
+        (*ctx->stream)(in, out, len, ctx->xts.key1, ctx->xts.key2, iv);
+    else if (CRYPTO_xts128_encrypt(&ctx->xts, iv, in, out, len,
+                                   ctx->base.enc))
+        return 0;
+    return 1;
+}
+
 static int aes_xts_cipher(void *vctx, unsigned char *out, size_t *outl,
                           size_t outsize, const unsigned char *in, size_t inl)
 {
     PROV_AES_XTS_CTX *ctx = (PROV_AES_XTS_CTX *)vctx;
+    unsigned char *iv = ctx->base.iv;
+    size_t done, i;
 
     if (ctx->xts.key1 == NULL
             || ctx->xts.key2 == NULL
@@ -158,23 +173,39 @@ static int aes_xts_cipher(void *vctx, unsigned char *out, size_t *outl,
             || inl < AES_BLOCK_SIZE)
         return 0;
 
+    if (ctx->sector_size == 0) {
+        /*
+         * Impose a limit of 2^20 blocks per data unit as specified by
+         * IEEE Std 1619-2018.  The earlier and obsolete IEEE Std 1619-2007
+         * indicated that this was a SHOULD NOT rather than a MUST NOT.
+         * NIST SP 800-38E mandates the same limit.
+         */
+        if (inl > XTS_MAX_BLOCKS_PER_DATA_UNIT * AES_BLOCK_SIZE) {
+            ERR_raise(ERR_LIB_PROV, PROV_R_XTS_DATA_UNIT_IS_TOO_LARGE);
+            return 0;
+        }
+        if (!aes_xts_data_unit(ctx, out, in, inl, iv))
+            return 0;
+        *outl = inl;
+        return 1;
+    }
+
     /*
-     * Impose a limit of 2^20 blocks per data unit as specified by
-     * IEEE Std 1619-2018.  The earlier and obsolete IEEE Std 1619-2007
-     * indicated that this was a SHOULD NOT rather than a MUST NOT.
-     * NIST SP 800-38E mandates the same limit.
+     * Consecutive sectors, the tweak of each being that of the previous one
+     * plus one, as a little endian number.  The next call carries on with
+     * the sector after the last one done here.
      */
-    if (inl > XTS_MAX_BLOCKS_PER_DATA_UNIT * AES_BLOCK_SIZE) {
-        ERR_raise(ERR_LIB_PROV, PROV_R_XTS_DATA_UNIT_IS_TOO_LARGE);
+    if (inl % ctx->sector_size != 0) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_BAD_LENGTH);
         return 0;
     }
-
-    if (ctx->stream != NULL)
-        (*ctx->stream)(in, out, inl, ctx->xts.key1, ctx->xts.key2, ctx->base.iv);
-    else if (CRYPTO_xts128_encrypt(&ctx->xts, ctx->base.iv, in, out, inl,
-                                   ctx->base.enc))
-        return 0;
-
+    for (done = 0; done < inl; done += ctx->sector_size) {
+        if (!aes_xts_data_unit(ctx, out + done, in + done, ctx->sector_size,
+                               iv))
+            return 0;
+        for (i = 0; i < AES_BLOCK_SIZE && ++iv[i] == 0; i++)
+            continue;
+    }
     *outl = inl;
     return 1;
 }
@@ -207,6 +238,7 @@ static int aes_xts_stream_final(void *vctx, unsigned char *out, size_t *outl,
 
 static const OSSL_PARAM aes_xts_known_settable_ctx_params[] = {
     OSSL_PARAM_size_t(OSSL_CIPHER_PARAM_KEYLEN, NULL),
+    OSSL_PARAM_size_t(OSSL_CIPHER_PARAM_XTS_SECTOR_SIZE, NULL),
     OSSL_PARAM_END
 };
 
@@ -217,7 +249,8 @@ static const OSSL_PARAM *aes_xts_settable_ctx_params(void)
 
 static int aes_xts_set_ctx_params(void *vctx, const OSSL_PARAM params[])
 {
-    PROV_CIPHER_CTX *ctx = (PROV_CIPHER_CTX *)vctx;
+    PROV_AES_XTS_CTX *xctx = (PROV_AES_XTS_CTX *)vctx;
+    PROV_CIPHER_CTX *ctx = &xctx->base;
     const OSSL_PARAM *p;
 
     /*
@@ -237,6 +270,25 @@ static int aes_xts_set_ctx_params(void *vctx, const OSSL_PARAM params[])
             return 0;
     }
 
+    p = OSSL_PARAM_locate_const(params, OSSL_CIPHER_PARAM_XTS_SECTOR_SIZE);
+    if (p != NULL) {
+        size_t sector_size;
+
+        if (!OSSL_PARAM_get_size_t(p, &sector_size)) {
+            ERR_raise(ERR_LIB_PROV, PROV_R_FAILED_TO_GET_PARAMETER);
+            return 0;
+        }
+        if (sector_size > XTS_MAX_BLOCKS_PER_DATA_UNIT * AES_BLOCK_SIZE) {
+            ERR_raise(ERR_LIB_PROV, PROV_R_XTS_DATA_UNIT_IS_TOO_LARGE);
+            return 0;
+        }
+        if (sector_size != 0 && sector_size < AES_BLOCK_SIZE) {
+            ERR_raise(ERR_LIB_PROV, PROV_R_BAD_LENGTH);
+            return 0;
+        }
+        xctx->sector_size = sector_size;
+    }
+
     return 1;
 }
 
@@ -1,5 +1,5 @@
 /*
- * Copyright 2019 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2019-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -103,6 +103,11 @@ static int cipher_hw_aesni_xts_initkey(PROV_CIPHER_CTX *ctx,
     XTS_SET_KEY_FN(aesni_set_encrypt_key, aesni_set_decrypt_key,
                    aesni_encrypt, aesni_decrypt,
                    aesni_xts_encrypt, aesni_xts_decrypt);
+# ifdef AESNI_XTS_AVX512_CAPABLE
+    if (AESNI_XTS_AVX512_CAPABLE)
+        xctx->stream = ctx->enc ? aesni_xts_encrypt_avx512
+                                : aesni_xts_decrypt_avx512;
+# endif
     return 1;
 }
 
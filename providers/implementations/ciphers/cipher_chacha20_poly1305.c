@@ -36,6 +36,7 @@ static OSSL_OP_cipher_get_ctx_params_fn chacha20_poly1305_get_ctx_params;
 static OSSL_OP_cipher_set_ctx_params_fn chacha20_poly1305_set_ctx_params;
 static OSSL_OP_cipher_cipher_fn chacha20_poly1305_cipher;
 static OSSL_OP_cipher_final_fn chacha20_poly1305_final;
+static OSSL_OP_cipher_aead_cipher_fn chacha20_poly1305_aead_cipher;
 static OSSL_OP_cipher_gettable_ctx_params_fn chacha20_poly1305_gettable_ctx_params;
 #define chacha20_poly1305_settable_ctx_params cipher_aead_settable_ctx_params
 #define chacha20_poly1305_gettable_params cipher_generic_gettable_params
@@ -293,6 +294,62 @@ static int chacha20_poly1305_final(void *vctx, unsigned char *out, size_t *outl,
     return 1;
 }
 
+/*
+ * See OP_cipher_aead_cipher() in provider-cipher(7).  The nonce goes into the
+ * ChaCha20 counter block, from which a fresh Poly1305 key is derived, and any
+ * TLS record state left in the context is discarded.
+ */
+static int chacha20_poly1305_aead_cipher(void *vctx, unsigned char *out,
+                                         size_t *outl, size_t outsize,
+                                         const unsigned char *in, size_t inl,
+                                         const unsigned char *iv,
+                                         size_t ivlen,
+                                         const unsigned char *aad,
+                                         size_t aadlen,
+                                         unsigned char *tag, size_t taglen)
+{
+    PROV_CHACHA20_POLY1305_CTX *ctx = (PROV_CHACHA20_POLY1305_CTX *)vctx;
+    PROV_CIPHER_HW_CHACHA20_POLY1305 *hw =
+        (PROV_CIPHER_HW_CHACHA20_POLY1305 *)ctx->base.hw;
+    size_t olen;
+
+    if (outsize < inl) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_OUTPUT_BUFFER_TOO_SMALL);
+        return 0;
+    }
+    if (ivlen != ctx->nonce_len) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_INVALID_IV_LENGTH);
+        return 0;
+    }
+    if (taglen == 0 || taglen > POLY1305_BLOCK_SIZE) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_INVALID_TAGLEN);
+        return 0;
+    }
+
+    memcpy(ctx->base.oiv, iv, ivlen);
+    if (!hw->initiv(&ctx->base))
+        return 0;
+    ctx->mac_inited = 0;
+    ctx->tls_payload_length = NO_TLS_PAYLOAD_LENGTH;
+    if (!ctx->base.enc) {
+        memcpy(ctx->tag, tag, taglen);
+        ctx->tag_len = taglen;
+    }
+
+    if ((aadlen > 0 && !hw->aead_cipher(&ctx->base, NULL, &olen, aad, aadlen))
+        || (inl > 0 && !hw->aead_cipher(&ctx->base, out, &olen, in, inl))
+        || !hw->aead_cipher(&ctx->base, NULL, &olen, NULL, 0)) {
+        if (!ctx->base.enc)
+            OPENSSL_cleanse(out, inl);
+        return 0;
+    }
+    if (ctx->base.enc)
+        memcpy(tag, ctx->tag, taglen);
+
+    *outl = inl;
+    return 1;
+}
+
 /* chacha20_poly1305_functions */
 const OSSL_DISPATCH chacha20_poly1305_functions[] = {
     { OSSL_FUNC_CIPHER_NEWCTX, (void (*)(void))chacha20_poly1305_newctx },
@@ -302,6 +359,8 @@ const OSSL_DISPATCH chacha20_poly1305_functions[] = {
     { OSSL_FUNC_CIPHER_UPDATE, (void (*)(void))chacha20_poly1305_update },
     { OSSL_FUNC_CIPHER_FINAL, (void (*)(void))chacha20_poly1305_final },
     { OSSL_FUNC_CIPHER_CIPHER, (void (*)(void))chacha20_poly1305_cipher },
+    { OSSL_FUNC_CIPHER_AEAD_CIPHER,
+        (void (*)(void))chacha20_poly1305_aead_cipher },
     { OSSL_FUNC_CIPHER_GET_PARAMS,
         (void (*)(void))chacha20_poly1305_get_params },
     { OSSL_FUNC_CIPHER_GETTABLE_PARAMS,
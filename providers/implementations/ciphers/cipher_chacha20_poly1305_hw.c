@@ -95,6 +95,114 @@ static int chacha20_poly1305_initiv(PROV_CIPHER_CTX *bctx)
     return ret;
 }
 
+/*
+ * Bulk data is encrypted and authenticated one chunk at a time rather than in
+ * two passes over the whole buffer, so that Poly1305 reads what ChaCha20 has
+ * just written (or ChaCha20 what Poly1305 has just read) from the L1 cache.
+ * 8KB of input and output fit in L1 together, and are still long enough for
+ * the wide SIMD code paths of both primitives.
+ */
+#define CHACHA20_POLY1305_CHUNK (128 * CHACHA_BLK_SIZE)
+
+#if defined(POLY1305_ASM) && (defined(__x86_64) || defined(__x86_64__) \
+    || defined(_M_AMD64) || defined(_M_X64))
+/*
+ * ChaCha20_Poly1305_8x encrypts |len| bytes, a multiple of 512, with AVX2
+ * ChaCha20 and hashes as many bytes at |hash| with integer-only Poly1305
+ * in the same loop.  It returns 0 if the assembler could not build it.
+ * It is not used when AVX512F or AVX512VL is available: ChaCha20 and vector
+ * Poly1305 one after the other are faster there, and Poly1305 may keep its
+ * hash in a format the kernel doesn't accept.
+ */
+# define CHACHA20_POLY1305_8X_BLOCK (8 * CHACHA_BLK_SIZE)
+# define CHACHA20_POLY1305_8X_CAPABLE \
+    ((OPENSSL_ia32cap_P[2] & ((1 << 5) | (1 << 16) | (1U << 31))) \
+     == (1 << 5))
+
+int ChaCha20_Poly1305_8x(unsigned char *out, const unsigned char *inp,
+                         size_t len, const unsigned int key[8],
+                         const unsigned int counter[4], void *poly,
+                         const unsigned char *hash);
+
+/*
+ * Returns the number of leading bytes of |in| that were encrypted or
+ * decrypted and authenticated, which can be none.
+ */
+static size_t chacha20_poly1305_8x(PROV_CHACHA20_POLY1305_CTX *ctx,
+                                   unsigned char *out,
+                                   const unsigned char *in, size_t len)
+{
+    PROV_CHACHA20_CTX *cctx = &ctx->chacha;
+    POLY1305 *poly = &ctx->poly1305;
+    size_t n = len / CHACHA20_POLY1305_8X_BLOCK, max;
+
+    if (!CHACHA20_POLY1305_8X_CAPABLE
+        || cctx->partial_len != 0 || poly->num != 0)
+        return 0;
+
+    /* the 32-bit block counter must not wrap within the kernel */
+    max = (0xffffffffU - cctx->counter[0]) / 8;
+    if (n > max)
+        n = max;
+    n *= CHACHA20_POLY1305_8X_BLOCK;
+
+    if (ctx->base.enc) {
+        /*
+         * Ciphertext is hashed one 512-byte block behind, so the first
+         * block is only encrypted and the last one only hashed.
+         */
+        if (n < 2 * CHACHA20_POLY1305_8X_BLOCK)
+            return 0;
+        ChaCha20_ctr32(out, in, CHACHA20_POLY1305_8X_BLOCK, cctx->key.d,
+                       cctx->counter);
+        cctx->counter[0] += 8;
+        if (!ChaCha20_Poly1305_8x(out + CHACHA20_POLY1305_8X_BLOCK,
+                                  in + CHACHA20_POLY1305_8X_BLOCK,
+                                  n - CHACHA20_POLY1305_8X_BLOCK,
+                                  cctx->key.d, cctx->counter, poly->opaque,
+                                  out))
+            n = CHACHA20_POLY1305_8X_BLOCK;
+        else
+            cctx->counter[0] += (unsigned int)(n / CHACHA_BLK_SIZE) - 8;
+        Poly1305_Update(poly, out + n - CHACHA20_POLY1305_8X_BLOCK,
+                        CHACHA20_POLY1305_8X_BLOCK);
+    } else {
+        if (n == 0
+            || !ChaCha20_Poly1305_8x(out, in, n, cctx->key.d, cctx->counter,
+                                     poly->opaque, in))
+            return 0;
+        cctx->counter[0] += (unsigned int)(n / CHACHA_BLK_SIZE);
+    }
+    return n;
+}
+#endif
+
+static void chacha20_poly1305_stitch(PROV_CHACHA20_POLY1305_CTX *ctx,
+                                     unsigned char *out,
+                                     const unsigned char *in, size_t len)
+{
+    PROV_CIPHER_CTX *cctx = &ctx->chacha.base;
+    POLY1305 *poly = &ctx->poly1305;
+    size_t n;
+
+#ifdef CHACHA20_POLY1305_8X_BLOCK
+    n = chacha20_poly1305_8x(ctx, out, in, len);
+    in += n;
+    out += n;
+    len -= n;
+#endif
+    for (; len > 0; in += n, out += n, len -= n) {
+        n = len < CHACHA20_POLY1305_CHUNK ? len : CHACHA20_POLY1305_CHUNK;
+        if (ctx->base.enc) {
+            cctx->hw->cipher(cctx, out, in, n);
+            Poly1305_Update(poly, out, n);
+        } else {
+            Poly1305_Update(poly, in, n);
+            cctx->hw->cipher(cctx, out, in, n);
+        }
+    }
+}
+
 #if !defined(OPENSSL_SMALL_FOOTPRINT)
 
 # if defined(POLY1305_ASM) && (defined(__x86_64) || defined(__x86_64__) \
@@ -200,13 +308,7 @@ static int chacha20_poly1305_tls_cipher(PROV_CIPHER_CTX *bctx,
         ctx->len.aad = EVP_AEAD_TLS1_AAD_LEN;
         ctx->len.text = plen;
 
-        if (bctx->enc) {
-            ChaCha20_ctr32(out, in, plen, ctx->chacha.key.d, ctx->chacha.counter);
-            Poly1305_Update(poly, out, plen);
-        } else {
-            Poly1305_Update(poly, in, plen);
-            ChaCha20_ctr32(out, in, plen, ctx->chacha.key.d, ctx->chacha.counter);
-        }
+        chacha20_poly1305_stitch(ctx, out, in, plen);
 
         in += plen;
         out += plen;
@@ -316,19 +418,10 @@ static int chacha20_poly1305_aead_cipher(PROV_CIPHER_CTX *bctx,
             else if (inl != plen + POLY1305_BLOCK_SIZE)
                 goto err;
 
-            if (bctx->enc) { /* plaintext */
-                ctx->chacha.base.hw->cipher(&ctx->chacha.base, out, in, plen);
-                Poly1305_Update(poly, out, plen);
-                in += plen;
-                out += plen;
-                ctx->len.text += plen;
-            } else { /* ciphertext */
-                Poly1305_Update(poly, in, plen);
-                ctx->chacha.base.hw->cipher(&ctx->chacha.base, out, in, plen);
-                in += plen;
-                out += plen;
-                ctx->len.text += plen;
-            }
+            chacha20_poly1305_stitch(ctx, out, in, plen);
+            in += plen;
+            out += plen;
+            ctx->len.text += plen;
         }
     }
     /* explicit final, or tls mode */
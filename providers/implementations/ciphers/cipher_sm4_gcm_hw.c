@@ -0,0 +1,73 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*-
+ * Generic support for SM4 GCM.
+ */
+
+#include "cipher_sm4_gcm.h"
+
+static int sm4_gcm_initkey(PROV_GCM_CTX *ctx, const unsigned char *key,
+                           size_t keylen)
+{
+    PROV_SM4_GCM_CTX *actx = (PROV_SM4_GCM_CTX *)ctx;
+    SM4_KEY *ks = &actx->ks.ks;
+
+    ctx->ks = ks;
+    SM4_set_key(key, ks);
+    ctx->ctr = NULL;
+#ifdef HWSM4_CAPABLE
+    if (HWSM4_CAPABLE) {
+        CRYPTO_gcm128_init(&ctx->gcm, ks, (block128_f)HWSM4_encrypt);
+        ctx->ctr = (ctr128_f)HWSM4_ctr32_encrypt_blocks;
+    } else
+#endif
+    {
+        CRYPTO_gcm128_init(&ctx->gcm, ks, (block128_f)SM4_encrypt);
+#ifdef SM4_AVX_CAPABLE
+        if (SM4_AVX_CAPABLE)
+            ctx->ctr = (ctr128_f)sm4_avx_ctr32_encrypt_blocks;
+#endif
+    }
+    ctx->key_set = 1;
+    return 1;
+}
+
+/*
+ * With a many block CTR routine, CRYPTO_gcm128_[en|de]crypt_ctr32() keep
+ * the counter blocks and GHASH going over large chunks of data.
+ */
+static int sm4_gcm_cipher_update(PROV_GCM_CTX *ctx, const unsigned char *in,
+                                 size_t len, unsigned char *out)
+{
+    if (ctx->ctr == NULL)
+        return gcm_cipher_update(ctx, in, len, out);
+
+    if (ctx->enc) {
+        if (CRYPTO_gcm128_encrypt_ctr32(&ctx->gcm, in, out, len, ctx->ctr))
+            return 0;
+    } else {
+        if (CRYPTO_gcm128_decrypt_ctr32(&ctx->gcm, in, out, len, ctx->ctr))
+            return 0;
+    }
+    return 1;
+}
+
+static const PROV_GCM_HW sm4_gcm = {
+    sm4_gcm_initkey,
+    gcm_setiv,
+    gcm_aad_update,
+    sm4_gcm_cipher_update,
+    gcm_cipher_final,
+    gcm_one_shot
+};
+const PROV_GCM_HW *PROV_SM4_HW_gcm(size_t keybits)
+{
+    return &sm4_gcm;
+}
@@ -7,22 +7,80 @@
  * https://www.openssl.org/source/license.html
  */
 
+#include <string.h>
 #include "cipher_sm4.h"
 
+#ifdef SM4_AVX_CAPABLE
+/*
+ * There is no assembler CBC mode on x86_64: encryption is serial anyway,
+ * and decryption is done many blocks at a time with the ECB code.
+ */
+static void sm4_avx_cbc_encrypt(const unsigned char *in, unsigned char *out,
+                                size_t len, const SM4_KEY *key,
+                                unsigned char ivec[16], int enc)
+{
+    unsigned char buf[16 * 16], iv[16];
+    size_t i, n;
+
+    if (enc) {
+        CRYPTO_cbc128_encrypt(in, out, len, key, ivec,
+                              (block128_f)SM4_encrypt);
+        return;
+    }
+
+    while (len >= 16) {
+        n = len < sizeof(buf) ? len & ~(size_t)15 : sizeof(buf);
+        sm4_avx_ecb_encrypt(in, buf, n, key, 0);
+        memcpy(iv, in + n - 16, 16);
+        /* Backwards, so that |in| can be |out| */
+        for (i = n; i-- > 16; )
+            out[i] = buf[i] ^ in[i - 16];
+        for (i = 0; i < 16; i++)
+            out[i] = buf[i] ^ ivec[i];
+        memcpy(ivec, iv, 16);
+        in += n;
+        out += n;
+        len -= n;
+    }
+    OPENSSL_cleanse(buf, sizeof(buf));
+}
+#endif
+
 static int cipher_hw_sm4_initkey(PROV_CIPHER_CTX *ctx,
                                  const unsigned char *key, size_t keylen)
 {
     PROV_SM4_CTX *sctx =  (PROV_SM4_CTX *)ctx;
     SM4_KEY *ks = &sctx->ks.ks;
+    int dec = !ctx->enc && (ctx->mode == EVP_CIPH_ECB_MODE
+                            || ctx->mode == EVP_CIPH_CBC_MODE);
 
     SM4_set_key(key, ks);
     ctx->ks = ks;
-    if (ctx->enc
-            || (ctx->mode != EVP_CIPH_ECB_MODE
-                && ctx->mode != EVP_CIPH_CBC_MODE))
-        ctx->block = (block128_f)SM4_encrypt;
-    else
-        ctx->block = (block128_f)SM4_decrypt;
+    ctx->stream.cbc = NULL;
+#ifdef HWSM4_CAPABLE
+    if (HWSM4_CAPABLE) {
+        ctx->block = dec ? (block128_f)HWSM4_decrypt
+                         : (block128_f)HWSM4_encrypt;
+        if (ctx->mode == EVP_CIPH_CBC_MODE)
+            ctx->stream.cbc = (cbc128_f)HWSM4_cbc_encrypt;
+        else if (ctx->mode == EVP_CIPH_ECB_MODE)
+            ctx->stream.ecb = (ecb128_f)HWSM4_ecb_encrypt;
+        else if (ctx->mode == EVP_CIPH_CTR_MODE)
+            ctx->stream.ctr = (ctr128_f)HWSM4_ctr32_encrypt_blocks;
+        return 1;
+    }
+#endif
+    ctx->block = dec ? (block128_f)SM4_decrypt : (block128_f)SM4_encrypt;
+#ifdef SM4_AVX_CAPABLE
+    if (SM4_AVX_CAPABLE) {
+        if (ctx->mode == EVP_CIPH_CBC_MODE)
+            ctx->stream.cbc = (cbc128_f)sm4_avx_cbc_encrypt;
+        else if (ctx->mode == EVP_CIPH_ECB_MODE)
+            ctx->stream.ecb = (ecb128_f)sm4_avx_ecb_encrypt;
+        else if (ctx->mode == EVP_CIPH_CTR_MODE)
+            ctx->stream.ctr = (ctr128_f)sm4_avx_ctr32_encrypt_blocks;
+    }
+#endif
     return 1;
 }
 
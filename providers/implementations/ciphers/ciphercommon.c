@@ -14,6 +14,7 @@
 #include "ciphercommon_local.h"
 #include "prov/provider_ctx.h"
 #include "prov/providercommonerr.h"
+#include "internal/param_names.h"
 
 /*-
  * Generic cipher functions for OSSL_PARAM gettables and settables
@@ -347,31 +348,31 @@ int cipher_generic_get_ctx_params(void *vctx, OSSL_PARAM params[])
 {
     PROV_CIPHER_CTX *ctx = (PROV_CIPHER_CTX *)vctx;
     OSSL_PARAM *p;
+    int ok = 1;
 
-    p = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_IVLEN);
-    if (p != NULL && !OSSL_PARAM_set_size_t(p, ctx->ivlen)) {
-        ERR_raise(ERR_LIB_PROV, PROV_R_FAILED_TO_SET_PARAMETER);
-        return 0;
-    }
-    p = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_PADDING);
-    if (p != NULL && !OSSL_PARAM_set_uint(p, ctx->pad)) {
-        ERR_raise(ERR_LIB_PROV, PROV_R_FAILED_TO_SET_PARAMETER);
-        return 0;
-    }
-    p = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_IV);
-    if (p != NULL
-        && !OSSL_PARAM_set_octet_ptr(p, &ctx->oiv, ctx->ivlen)
-        && !OSSL_PARAM_set_octet_string(p, &ctx->oiv, ctx->ivlen)) {
-        ERR_raise(ERR_LIB_PROV, PROV_R_FAILED_TO_SET_PARAMETER);
-        return 0;
-    }
-    p = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_NUM);
-    if (p != NULL && !OSSL_PARAM_set_uint(p, ctx->num)) {
-        ERR_raise(ERR_LIB_PROV, PROV_R_FAILED_TO_SET_PARAMETER);
-        return 0;
+    if (params == NULL)
+        return 1;
+    for (p = params; ok && p->key != NULL; p++) {
+        switch (ossl_param_find_pidx(p->key)) {
+        case PIDX_CIPHER_PARAM_IVLEN:
+            ok = OSSL_PARAM_set_size_t(p, ctx->ivlen);
+            break;
+        case PIDX_CIPHER_PARAM_PADDING:
+            ok = OSSL_PARAM_set_uint(p, ctx->pad);
+            break;
+        case PIDX_CIPHER_PARAM_IV:
+            ok = OSSL_PARAM_set_octet_ptr(p, &ctx->oiv, ctx->ivlen)
+                 || OSSL_PARAM_set_octet_string(p, &ctx->oiv, ctx->ivlen);
+            break;
+        case PIDX_CIPHER_PARAM_NUM:
+            ok = OSSL_PARAM_set_uint(p, ctx->num);
+            break;
+        case PIDX_CIPHER_PARAM_KEYLEN:
+            ok = OSSL_PARAM_set_size_t(p, ctx->keylen);
+            break;
+        }
     }
-    p = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_KEYLEN);
-    if (p != NULL && !OSSL_PARAM_set_size_t(p, ctx->keylen)) {
+    if (!ok) {
         ERR_raise(ERR_LIB_PROV, PROV_R_FAILED_TO_SET_PARAMETER);
         return 0;
     }
@@ -382,26 +383,27 @@ int cipher_generic_set_ctx_params(void *vctx, const OSSL_PARAM params[])
 {
     PROV_CIPHER_CTX *ctx = (PROV_CIPHER_CTX *)vctx;
     const OSSL_PARAM *p;
+    unsigned int u;
 
-    p = OSSL_PARAM_locate_const(params, OSSL_CIPHER_PARAM_PADDING);
-    if (p != NULL) {
-        unsigned int pad;
-
-        if (!OSSL_PARAM_get_uint(p, &pad)) {
-            ERR_raise(ERR_LIB_PROV, PROV_R_FAILED_TO_GET_PARAMETER);
-            return 0;
-        }
-        ctx->pad = pad ? 1 : 0;
-    }
-    p = OSSL_PARAM_locate_const(params, OSSL_CIPHER_PARAM_NUM);
-    if (p != NULL) {
-        unsigned int num;
-
-        if (!OSSL_PARAM_get_uint(p, &num)) {
-            ERR_raise(ERR_LIB_PROV, PROV_R_FAILED_TO_GET_PARAMETER);
-            return 0;
+    if (params == NULL)
+        return 1;
+    for (p = params; p->key != NULL; p++) {
+        switch (ossl_param_find_pidx(p->key)) {
+        case PIDX_CIPHER_PARAM_PADDING:
+            if (!OSSL_PARAM_get_uint(p, &u)) {
+                ERR_raise(ERR_LIB_PROV, PROV_R_FAILED_TO_GET_PARAMETER);
+                return 0;
+            }
+            ctx->pad = u ? 1 : 0;
+            break;
+        case PIDX_CIPHER_PARAM_NUM:
+            if (!OSSL_PARAM_get_uint(p, &u)) {
+                ERR_raise(ERR_LIB_PROV, PROV_R_FAILED_TO_GET_PARAMETER);
+                return 0;
+            }
+            ctx->num = u;
+            break;
         }
-        ctx->num = num;
     }
     return 1;
 }
@@ -288,6 +288,57 @@ int ccm_cipher(void *vctx,
     return 1;
 }
 
+/*
+ * See OP_cipher_aead_cipher() in provider-cipher(7).  Knowing the message
+ * length up front lets CCM set up the IV and the length block in one go, and
+ * the tag length must be the M the key was set up with.
+ */
+int ccm_aead_cipher(void *vctx,
+                    unsigned char *out, size_t *outl, size_t outsize,
+                    const unsigned char *in, size_t inl,
+                    const unsigned char *iv, size_t ivlen,
+                    const unsigned char *aad, size_t aadlen,
+                    unsigned char *tag, size_t taglen)
+{
+    PROV_CCM_CTX *ctx = (PROV_CCM_CTX *)vctx;
+    const PROV_CCM_HW *hw = ctx->hw;
+    int rv;
+
+    if (!ctx->key_set || ctx->tls_aad_len != UNINITIALISED_SIZET)
+        return 0;
+    if (outsize < inl) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_OUTPUT_BUFFER_TOO_SMALL);
+        return 0;
+    }
+    if (ivlen != ccm_get_ivlen(ctx)) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_INVALID_IVLEN);
+        return 0;
+    }
+    /* M is fixed when the key is set */
+    if (taglen != ctx->m) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_INVALID_TAGLEN);
+        return 0;
+    }
+
+    memcpy(ctx->iv, iv, ivlen);
+    if (!hw->setiv(ctx, ctx->iv, ivlen, inl)
+        || (aadlen > 0 && !hw->setaad(ctx, aad, aadlen)))
+        rv = 0;
+    else if (ctx->enc)
+        rv = hw->auth_encrypt(ctx, in, out, inl, tag, taglen);
+    else
+        rv = hw->auth_decrypt(ctx, in, out, inl, tag, taglen);
+
+    /* The IV mustn't be used again */
+    ctx->iv_set = 0;
+    ctx->tag_set = 0;
+    ctx->len_set = 0;
+    if (!rv)
+        return 0;
+    *outl = inl;
+    return 1;
+}
+
 /* Copy the buffered iv */
 static int ccm_set_iv(PROV_CCM_CTX *ctx, size_t mlen)
 {
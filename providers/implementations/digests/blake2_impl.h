@@ -127,3 +127,34 @@ static ossl_inline uint64_t rotr64(const uint64_t w, const unsigned int c)
 {
     return (w >> c) | (w << (64 - c));
 }
+
+/*
+ * Assembler compression functions.  They take the same arguments as
+ * blake2b_compress() and blake2s_compress(), and work on the state in
+ * BLAKE2B_CTX and BLAKE2S_CTX directly.
+ */
+#if defined(BLAKE2_ASM) && defined(OPENSSL_CPUID_OBJ)
+# include "prov/blake2.h"
+# if defined(__x86_64) || defined(__x86_64__) || \
+     defined(_M_AMD64) || defined(_M_X64)
+#  include "internal/cryptlib.h"
+/* AVX2 for BLAKE2b and AVX for BLAKE2s, AVX-512VL is picked by the callee */
+#  define BLAKE2B_ASM_CAPABLE \
+        ((OPENSSL_ia32cap_P[2] & (1 << 5)) && blake2_avx_eligible())
+#  define BLAKE2S_ASM_CAPABLE \
+        ((OPENSSL_ia32cap_P[1] & (1 << (60 - 32))) && blake2_avx_eligible())
+#  define blake2b_compress_asm blake2b_compress_avx2
+#  define blake2s_compress_asm blake2s_compress_avx
+
+int blake2_avx_eligible(void);
+# elif defined(__aarch64__)
+#  include "arm_arch.h"
+#  define BLAKE2B_ASM_CAPABLE (OPENSSL_armcap_P & ARMV7_NEON)
+#  define BLAKE2S_ASM_CAPABLE (OPENSSL_armcap_P & ARMV7_NEON)
+#  define blake2b_compress_asm blake2b_compress_neon
+#  define blake2s_compress_asm blake2s_compress_neon
+# endif
+
+void blake2b_compress_asm(BLAKE2B_CTX *S, const uint8_t *blocks, size_t len);
+void blake2s_compress_asm(BLAKE2S_CTX *S, const uint8_t *blocks, size_t len);
+#endif
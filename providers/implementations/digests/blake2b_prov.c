@@ -148,9 +148,9 @@ int blake2b_init_key(BLAKE2B_CTX *c, const BLAKE2B_PARAM *P, const void *key)
 }
 
 /* Permute the state while xoring in the block of data. */
-static void blake2b_compress(BLAKE2B_CTX *S,
-                            const uint8_t *blocks,
-                            size_t len)
+static void blake2b_compress_c(BLAKE2B_CTX *S,
+                              const uint8_t *blocks,
+                              size_t len)
 {
     uint64_t m[16];
     uint64_t v[16];
@@ -251,6 +251,19 @@ static void blake2b_compress(BLAKE2B_CTX *S,
     } while (len);
 }
 
+static void blake2b_compress(BLAKE2B_CTX *S,
+                             const uint8_t *blocks,
+                             size_t len)
+{
+#ifdef BLAKE2B_ASM_CAPABLE
+    if (BLAKE2B_ASM_CAPABLE) {
+        blake2b_compress_asm(S, blocks, len);
+        return;
+    }
+#endif
+    blake2b_compress_c(S, blocks, len);
+}
+
 /* Absorb the input data into the hash state.  Always returns 1. */
 int blake2b_update(BLAKE2B_CTX *c, const void *data, size_t datalen)
 {
@@ -141,9 +141,9 @@ int blake2s_init_key(BLAKE2S_CTX *c, const BLAKE2S_PARAM *P, const void *key)
 }
 
 /* Permute the state while xoring in the block of data. */
-static void blake2s_compress(BLAKE2S_CTX *S,
-                            const uint8_t *blocks,
-                            size_t len)
+static void blake2s_compress_c(BLAKE2S_CTX *S,
+                              const uint8_t *blocks,
+                              size_t len)
 {
     uint32_t m[16];
     uint32_t v[16];
@@ -242,6 +242,19 @@ static void blake2s_compress(BLAKE2S_CTX *S,
     } while (len);
 }
 
+static void blake2s_compress(BLAKE2S_CTX *S,
+                             const uint8_t *blocks,
+                             size_t len)
+{
+#ifdef BLAKE2S_ASM_CAPABLE
+    if (BLAKE2S_ASM_CAPABLE) {
+        blake2s_compress_asm(S, blocks, len);
+        return;
+    }
+#endif
+    blake2s_compress_c(S, blocks, len);
+}
+
 /* Absorb the input data into the hash state.  Always returns 1. */
 int blake2s_update(BLAKE2S_CTX *c, const void *data, size_t datalen)
 {
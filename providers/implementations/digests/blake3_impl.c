@@ -0,0 +1,780 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * BLAKE3, as specified in https://github.com/BLAKE3-team/BLAKE3-specs.
+ *
+ * The input is split in 1 KiB chunks, which are the leaves of a binary
+ * tree.  Chunks are independent of each other, so whenever enough input is
+ * available, whole subtrees are hashed with hash_many(), which compresses
+ * several chunks or parent nodes at once with the assembler code.  Big
+ * subtrees can also be split between threads.
+ */
+
+#include <string.h>
+#include <openssl/crypto.h>
+#include "internal/thread.h"
+#include "prov/blake3.h"
+
+#define CHUNK_START         (1 << 0)
+#define CHUNK_END           (1 << 1)
+#define PARENT              (1 << 2)
+#define ROOT                (1 << 3)
+#define KEYED_HASH          (1 << 4)
+#define DERIVE_KEY_CONTEXT  (1 << 5)
+#define DERIVE_KEY_MATERIAL (1 << 6)
+
+/* The most chunks hash_many() takes at once */
+#define MAX_SIMD_DEGREE     16
+
+/*
+ * Input is split between two threads when each gets at least this much,
+ * which is far longer than it takes to start a thread.
+ */
+#define MIN_THREAD_LEN      (512 * 1024)
+
+/*
+ * The assembler code hashes a fixed number of inputs in parallel.  With
+ * PARENT in |flags|, each input is one parent node, |blocks| is 1 and
+ * |counter| 0.  Otherwise they are consecutive chunks of |blocks| blocks,
+ * with the chunk counter of the first in |counter|.  The chaining values go
+ * to |out|, one after the other.
+ */
+#if defined(BLAKE3_ASM) && defined(OPENSSL_CPUID_OBJ)
+# if defined(__x86_64) || defined(__x86_64__) || \
+     defined(_M_AMD64) || defined(_M_X64)
+#  include "internal/cryptlib.h"
+#  define BLAKE3_HASH16_CAPABLE \
+        ((OPENSSL_ia32cap_P[2] & 0x80010000) == 0x80010000 \
+         && blake3_avx_eligible() >= 16)
+#  define BLAKE3_HASH8_CAPABLE \
+        ((OPENSSL_ia32cap_P[2] & (1 << 5)) && blake3_avx_eligible() >= 8)
+#  define blake3_hash16 blake3_hash16_avx512
+#  define blake3_hash8 blake3_hash8_avx2
+
+int blake3_avx_eligible(void);
+void blake3_hash16_avx512(const uint8_t *const inputs[16], size_t blocks,
+                          const uint32_t key[8], uint64_t counter,
+                          unsigned int flags, uint8_t *out);
+void blake3_hash8_avx2(const uint8_t *const inputs[8], size_t blocks,
+                       const uint32_t key[8], uint64_t counter,
+                       unsigned int flags, uint8_t *out);
+# elif defined(__aarch64__) && !defined(__AARCH64EB__)
+#  include "arm_arch.h"
+#  define BLAKE3_HASH4_CAPABLE (OPENSSL_armcap_P & ARMV7_NEON)
+#  define blake3_hash4 blake3_hash4_neon
+
+void blake3_hash4_neon(const uint8_t *const inputs[4], size_t blocks,
+                       const uint32_t key[8], uint64_t counter,
+                       unsigned int flags, uint8_t *out);
+# endif
+#endif
+
+static const uint32_t IV[8] = {
+    0x6A09E667UL, 0xBB67AE85UL, 0x3C6EF372UL, 0xA54FF53AUL,
+    0x510E527FUL, 0x9B05688CUL, 0x1F83D9ABUL, 0x5BE0CD19UL
+};
+
+static const uint8_t MSG_SCHEDULE[7][16] = {
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8 },
+    { 3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1 },
+    { 10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6 },
+    { 12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4 },
+    { 9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7 },
+    { 11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13 },
+};
+
+static ossl_inline uint32_t load32(const uint8_t *src)
+{
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8)
+           | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+static ossl_inline void store32(uint8_t *dst, uint32_t w)
+{
+    dst[0] = (uint8_t)w;
+    dst[1] = (uint8_t)(w >> 8);
+    dst[2] = (uint8_t)(w >> 16);
+    dst[3] = (uint8_t)(w >> 24);
+}
+
+static ossl_inline void load_key(uint32_t key[8], const uint8_t *bytes)
+{
+    int i;
+
+    for (i = 0; i < 8; i++)
+        key[i] = load32(bytes + 4 * i);
+}
+
+static ossl_inline void store_cv(uint8_t *bytes, const uint32_t cv[8])
+{
+    int i;
+
+    for (i = 0; i < 8; i++)
+        store32(bytes + 4 * i, cv[i]);
+}
+
+static ossl_inline uint32_t rotr32(uint32_t w, unsigned int c)
+{
+    return (w >> c) | (w << (32 - c));
+}
+
+static unsigned int popcnt(uint64_t x)
+{
+    unsigned int count = 0;
+
+    for (; x != 0; x &= x - 1)
+        count++;
+    return count;
+}
+
+static uint64_t round_down_to_power_of_2(uint64_t x)
+{
+    while ((x & (x - 1)) != 0)
+        x &= x - 1;
+    return x;
+}
+
+#define G(a, b, c, d, x, y)                     \
+    do {                                        \
+        a = a + b + x;                          \
+        d = rotr32(d ^ a, 16);                  \
+        c = c + d;                              \
+        b = rotr32(b ^ c, 12);                  \
+        a = a + b + y;                          \
+        d = rotr32(d ^ a, 8);                   \
+        c = c + d;                              \
+        b = rotr32(b ^ c, 7);                   \
+    } while (0)
+
+static void compress_pre(uint32_t v[16], const uint32_t cv[8],
+                         const uint8_t block[BLAKE3_BLOCK_LEN],
+                         uint8_t block_len, uint64_t counter, uint8_t flags)
+{
+    uint32_t m[16];
+    int i;
+
+    for (i = 0; i < 16; i++)
+        m[i] = load32(block + 4 * i);
+    for (i = 0; i < 8; i++)
+        v[i] = cv[i];
+    v[8] = IV[0];
+    v[9] = IV[1];
+    v[10] = IV[2];
+    v[11] = IV[3];
+    v[12] = (uint32_t)counter;
+    v[13] = (uint32_t)(counter >> 32);
+    v[14] = block_len;
+    v[15] = flags;
+
+    for (i = 0; i < 7; i++) {
+        const uint8_t *s = MSG_SCHEDULE[i];
+
+        G(v[0], v[4], v[8], v[12], m[s[0]], m[s[1]]);
+        G(v[1], v[5], v[9], v[13], m[s[2]], m[s[3]]);
+        G(v[2], v[6], v[10], v[14], m[s[4]], m[s[5]]);
+        G(v[3], v[7], v[11], v[15], m[s[6]], m[s[7]]);
+        G(v[0], v[5], v[10], v[15], m[s[8]], m[s[9]]);
+        G(v[1], v[6], v[11], v[12], m[s[10]], m[s[11]]);
+        G(v[2], v[7], v[8], v[13], m[s[12]], m[s[13]]);
+        G(v[3], v[4], v[9], v[14], m[s[14]], m[s[15]]);
+    }
+}
+
+static void compress_in_place(uint32_t cv[8],
+                              const uint8_t block[BLAKE3_BLOCK_LEN],
+                              uint8_t block_len, uint64_t counter,
+                              uint8_t flags)
+{
+    uint32_t v[16];
+    int i;
+
+    compress_pre(v, cv, block, block_len, counter, flags);
+    for (i = 0; i < 8; i++)
+        cv[i] = v[i] ^ v[i + 8];
+}
+
+static void compress_xof(const uint32_t cv[8],
+                         const uint8_t block[BLAKE3_BLOCK_LEN],
+                         uint8_t block_len, uint64_t counter, uint8_t flags,
+                         uint8_t out[64])
+{
+    uint32_t v[16];
+    int i;
+
+    compress_pre(v, cv, block, block_len, counter, flags);
+    for (i = 0; i < 8; i++) {
+        store32(out + 4 * i, v[i] ^ v[i + 8]);
+        store32(out + 32 + 4 * i, v[i + 8] ^ cv[i]);
+    }
+}
+
+/* See the assembler functions above for the arguments */
+static void hash_one(const uint8_t *input, size_t blocks,
+                     const uint32_t key[8], uint64_t counter,
+                     unsigned int flags, uint8_t out[BLAKE3_OUT_LEN])
+{
+    uint32_t cv[8];
+    uint8_t block_flags = (uint8_t)flags;
+
+    if ((flags & PARENT) == 0)
+        block_flags |= CHUNK_START;
+    memcpy(cv, key, sizeof(cv));
+    for (; blocks > 0; blocks--, input += BLAKE3_BLOCK_LEN) {
+        if (blocks == 1 && (flags & PARENT) == 0)
+            block_flags |= CHUNK_END;
+        compress_in_place(cv, input, BLAKE3_BLOCK_LEN, counter, block_flags);
+        block_flags = (uint8_t)flags;
+    }
+    store_cv(out, cv);
+}
+
+static void hash_many(const uint8_t *const *inputs, size_t num_inputs,
+                      size_t blocks, const uint32_t key[8], uint64_t counter,
+                      unsigned int flags, uint8_t *out)
+{
+    size_t inc = (flags & PARENT) != 0 ? 0 : 1;
+
+#ifdef BLAKE3_HASH16_CAPABLE
+    if (BLAKE3_HASH16_CAPABLE) {
+        for (; num_inputs >= 16; num_inputs -= 16) {
+            blake3_hash16(inputs, blocks, key, counter, flags, out);
+            inputs += 16;
+            counter += 16 * inc;
+            out += 16 * BLAKE3_OUT_LEN;
+        }
+    }
+#endif
+#ifdef BLAKE3_HASH8_CAPABLE
+    if (BLAKE3_HASH8_CAPABLE) {
+        for (; num_inputs >= 8; num_inputs -= 8) {
+            blake3_hash8(inputs, blocks, key, counter, flags, out);
+            inputs += 8;
+            counter += 8 * inc;
+            out += 8 * BLAKE3_OUT_LEN;
+        }
+    }
+#endif
+#ifdef BLAKE3_HASH4_CAPABLE
+    if (BLAKE3_HASH4_CAPABLE) {
+        for (; num_inputs >= 4; num_inputs -= 4) {
+            blake3_hash4(inputs, blocks, key, counter, flags, out);
+            inputs += 4;
+            counter += 4 * inc;
+            out += 4 * BLAKE3_OUT_LEN;
+        }
+    }
+#endif
+    for (; num_inputs > 0; num_inputs--) {
+        hash_one(*inputs++, blocks, key, counter, flags, out);
+        counter += inc;
+        out += BLAKE3_OUT_LEN;
+    }
+}
+
+/* How many chunks it pays to give hash_many() */
+static size_t simd_degree(void)
+{
+#ifdef BLAKE3_HASH16_CAPABLE
+    if (BLAKE3_HASH16_CAPABLE)
+        return 16;
+#endif
+#ifdef BLAKE3_HASH8_CAPABLE
+    if (BLAKE3_HASH8_CAPABLE)
+        return 8;
+#endif
+#ifdef BLAKE3_HASH4_CAPABLE
+    if (BLAKE3_HASH4_CAPABLE)
+        return 4;
+#endif
+    return 1;
+}
+
+static void chunk_init(BLAKE3_CHUNK *chunk, const uint32_t key[8],
+                       uint64_t chunk_counter, uint8_t flags)
+{
+    memcpy(chunk->cv, key, sizeof(chunk->cv));
+    chunk->chunk_counter = chunk_counter;
+    memset(chunk->buf, 0, sizeof(chunk->buf));
+    chunk->buf_len = 0;
+    chunk->blocks_compressed = 0;
+    chunk->flags = flags;
+}
+
+static ossl_inline size_t chunk_len(const BLAKE3_CHUNK *chunk)
+{
+    return BLAKE3_BLOCK_LEN * (size_t)chunk->blocks_compressed
+           + chunk->buf_len;
+}
+
+static ossl_inline uint8_t chunk_start_flag(const BLAKE3_CHUNK *chunk)
+{
+    return chunk->blocks_compressed == 0 ? CHUNK_START : 0;
+}
+
+static size_t chunk_fill_buf(BLAKE3_CHUNK *chunk, const uint8_t *input,
+                             size_t len)
+{
+    size_t take = BLAKE3_BLOCK_LEN - chunk->buf_len;
+
+    if (take > len)
+        take = len;
+    memcpy(chunk->buf + chunk->buf_len, input, take);
+    chunk->buf_len += (uint8_t)take;
+    return take;
+}
+
+/* |len| must not take the chunk past BLAKE3_CHUNK_LEN */
+static void chunk_update(BLAKE3_CHUNK *chunk, const uint8_t *input,
+                         size_t len)
+{
+    size_t take;
+
+    if (chunk->buf_len > 0) {
+        take = chunk_fill_buf(chunk, input, len);
+        input += take;
+        len -= take;
+        if (len == 0)
+            return;
+        compress_in_place(chunk->cv, chunk->buf, BLAKE3_BLOCK_LEN,
+                          chunk->chunk_counter,
+                          chunk->flags | chunk_start_flag(chunk));
+        chunk->blocks_compressed++;
+        chunk->buf_len = 0;
+        memset(chunk->buf, 0, sizeof(chunk->buf));
+    }
+
+    /* The last block stays in the buffer, it might need CHUNK_END */
+    for (; len > BLAKE3_BLOCK_LEN; len -= BLAKE3_BLOCK_LEN) {
+        compress_in_place(chunk->cv, input, BLAKE3_BLOCK_LEN,
+                          chunk->chunk_counter,
+                          chunk->flags | chunk_start_flag(chunk));
+        chunk->blocks_compressed++;
+        input += BLAKE3_BLOCK_LEN;
+    }
+
+    chunk_fill_buf(chunk, input, len);
+}
+
+/*
+ * The inputs of the last compression of a node, which are kept until it is
+ * known whether it is the root.
+ */
+typedef struct {
+    uint32_t input_cv[8];
+    uint64_t counter;
+    uint8_t block[BLAKE3_BLOCK_LEN];
+    uint8_t block_len;
+    uint8_t flags;
+} OUTPUT;
+
+static void chunk_output(const BLAKE3_CHUNK *chunk, OUTPUT *output)
+{
+    memcpy(output->input_cv, chunk->cv, sizeof(output->input_cv));
+    memcpy(output->block, chunk->buf, sizeof(output->block));
+    output->block_len = chunk->buf_len;
+    output->counter = chunk->chunk_counter;
+    output->flags = chunk->flags | chunk_start_flag(chunk) | CHUNK_END;
+}
+
+static void parent_output(const uint8_t block[BLAKE3_BLOCK_LEN],
+                          const uint32_t key[8], uint8_t flags,
+                          OUTPUT *output)
+{
+    memcpy(output->input_cv, key, sizeof(output->input_cv));
+    memcpy(output->block, block, sizeof(output->block));
+    output->block_len = BLAKE3_BLOCK_LEN;
+    output->counter = 0;
+    output->flags = flags | PARENT;
+}
+
+static void output_chaining_value(const OUTPUT *output,
+                                  uint8_t cv[BLAKE3_OUT_LEN])
+{
+    uint32_t cv_words[8];
+
+    memcpy(cv_words, output->input_cv, sizeof(cv_words));
+    compress_in_place(cv_words, output->block, output->block_len,
+                      output->counter, output->flags);
+    store_cv(cv, cv_words);
+}
+
+static void output_root_bytes(const OUTPUT *output, uint8_t *out,
+                              size_t outlen)
+{
+    uint64_t counter;
+    uint8_t wide_buf[64];
+    size_t n;
+
+    for (counter = 0; outlen > 0; counter++) {
+        compress_xof(output->input_cv, output->block, output->block_len,
+                     counter, output->flags | ROOT, wide_buf);
+        n = outlen < sizeof(wide_buf) ? outlen : sizeof(wide_buf);
+        memcpy(out, wide_buf, n);
+        out += n;
+        outlen -= n;
+    }
+    OPENSSL_cleanse(wide_buf, sizeof(wide_buf));
+}
+
+/*
+ * Hashes up to simd_degree() chunks, of which the last may be partial, and
+ * returns the number of chaining values written to |out|.
+ */
+static size_t compress_chunks_parallel(const uint8_t *input, size_t input_len,
+                                       const uint32_t key[8],
+                                       uint64_t chunk_counter, uint8_t flags,
+                                       uint8_t *out)
+{
+    const uint8_t *chunks[MAX_SIMD_DEGREE];
+    size_t n = 0;
+    BLAKE3_CHUNK chunk;
+    OUTPUT output;
+
+    for (; input_len >= BLAKE3_CHUNK_LEN; input_len -= BLAKE3_CHUNK_LEN) {
+        chunks[n++] = input;
+        input += BLAKE3_CHUNK_LEN;
+    }
+    hash_many(chunks, n, BLAKE3_CHUNK_LEN / BLAKE3_BLOCK_LEN, key,
+              chunk_counter, flags, out);
+
+    if (input_len == 0)
+        return n;
+
+    chunk_init(&chunk, key, chunk_counter + n, flags);
+    chunk_update(&chunk, input, input_len);
+    chunk_output(&chunk, &output);
+    output_chaining_value(&output, out + n * BLAKE3_OUT_LEN);
+    return n + 1;
+}
+
+/*
+ * Hashes pairs of chaining values into their parents, and returns the
+ * number of chaining values written to |out|, including an odd one that is
+ * just copied.
+ */
+static size_t compress_parents_parallel(const uint8_t *child_cvs,
+                                        size_t num_cvs, const uint32_t key[8],
+                                        uint8_t flags, uint8_t *out)
+{
+    const uint8_t *parents[MAX_SIMD_DEGREE];
+    size_t n;
+
+    for (n = 0; num_cvs - 2 * n >= 2; n++)
+        parents[n] = child_cvs + 2 * n * BLAKE3_OUT_LEN;
+    hash_many(parents, n, 1, key, 0, flags | PARENT, out);
+
+    if (num_cvs == 2 * n)
+        return n;
+    memcpy(out + n * BLAKE3_OUT_LEN, child_cvs + 2 * n * BLAKE3_OUT_LEN,
+           BLAKE3_OUT_LEN);
+    return n + 1;
+}
+
+/* The length of the left subtree of a node, a power of 2 number of chunks */
+static size_t left_len(size_t content_len)
+{
+    size_t full_chunks = (content_len - 1) / BLAKE3_CHUNK_LEN;
+
+    return (size_t)round_down_to_power_of_2(full_chunks) * BLAKE3_CHUNK_LEN;
+}
+
+typedef struct {
+    const uint8_t *input;
+    size_t input_len;
+    const uint32_t *key;
+    uint64_t chunk_counter;
+    uint8_t flags;
+    uint8_t *out;
+    unsigned int threads;
+    size_t num_cvs;
+} SUBTREE_JOB;
+
+static void compress_subtree_job(void *vjob);
+
+/*
+ * Hashes a subtree of up to 2 * simd_degree() wide levels down to at most
+ * MAX_SIMD_DEGREE chaining values (or 2 when that is 1), without merging
+ * them all the way up, so that each level is done with wide hash_many()
+ * calls.  Returns the number of chaining values in |out|.
+ */
+static size_t compress_subtree_wide(const uint8_t *input, size_t input_len,
+                                    const uint32_t key[8],
+                                    uint64_t chunk_counter, uint8_t flags,
+                                    uint8_t *out, unsigned int threads)
+{
+    uint8_t cv_array[2 * MAX_SIMD_DEGREE * BLAKE3_OUT_LEN];
+    size_t degree = simd_degree();
+    size_t left_input_len, right_input_len, left_n, right_n;
+    SUBTREE_JOB left;
+    CRYPTO_THREAD *thread = NULL;
+
+    if (input_len <= degree * BLAKE3_CHUNK_LEN)
+        return compress_chunks_parallel(input, input_len, key, chunk_counter,
+                                        flags, out);
+
+    left_input_len = left_len(input_len);
+    right_input_len = input_len - left_input_len;
+    if (left_input_len > BLAKE3_CHUNK_LEN && degree == 1)
+        degree = 2;
+
+    left.input = input;
+    left.input_len = left_input_len;
+    left.key = key;
+    left.chunk_counter = chunk_counter;
+    left.flags = flags;
+    left.out = cv_array;
+    left.threads = 1;
+    if (threads > 1 && right_input_len >= MIN_THREAD_LEN) {
+        left.threads = threads / 2;
+        threads -= left.threads;
+        thread = ossl_crypto_thread_start(compress_subtree_job, &left);
+    }
+    if (thread == NULL)
+        compress_subtree_job(&left);
+
+    right_n = compress_subtree_wide(input + left_input_len, right_input_len,
+                                    key,
+                                    chunk_counter
+                                    + left_input_len / BLAKE3_CHUNK_LEN,
+                                    flags, cv_array + degree * BLAKE3_OUT_LEN,
+                                    threads);
+    /*
+     * If the helper can't be joined we don't know that it ever got to write
+     * |left.out|, so hash the left half again here rather than trust it.
+     */
+    if (thread != NULL && !ossl_crypto_thread_join(thread)) {
+        left.threads = 1;
+        compress_subtree_job(&left);
+    }
+    left_n = left.num_cvs;
+
+    /* Don't merge the root, the caller has to do that */
+    if (left_n == 1) {
+        memcpy(out, cv_array, 2 * BLAKE3_OUT_LEN);
+        return 2;
+    }
+    return compress_parents_parallel(cv_array, left_n + right_n, key, flags,
+                                     out);
+}
+
+static void compress_subtree_job(void *vjob)
+{
+    SUBTREE_JOB *job = vjob;
+
+    job->num_cvs = compress_subtree_wide(job->input, job->input_len, job->key,
+                                         job->chunk_counter, job->flags,
+                                         job->out, job->threads);
+}
+
+/*
+ * Hashes a subtree of more than one chunk down to the two chaining values
+ * of its root.
+ */
+static void compress_subtree_to_parent_node(const uint8_t *input,
+                                            size_t input_len,
+                                            const uint32_t key[8],
+                                            uint64_t chunk_counter,
+                                            uint8_t flags,
+                                            uint8_t out[2 * BLAKE3_OUT_LEN],
+                                            unsigned int threads)
+{
+    uint8_t cv_array[MAX_SIMD_DEGREE * BLAKE3_OUT_LEN];
+    uint8_t out_array[MAX_SIMD_DEGREE * BLAKE3_OUT_LEN / 2];
+    size_t num_cvs;
+
+    num_cvs = compress_subtree_wide(input, input_len, key, chunk_counter,
+                                    flags, cv_array, threads);
+    while (num_cvs > 2) {
+        num_cvs = compress_parents_parallel(cv_array, num_cvs, key, flags,
+                                            out_array);
+        memcpy(cv_array, out_array, num_cvs * BLAKE3_OUT_LEN);
+    }
+    memcpy(out, cv_array, 2 * BLAKE3_OUT_LEN);
+}
+
+static void blake3_init_base(BLAKE3_CTX *ctx, const uint32_t key[8],
+                             uint8_t flags)
+{
+    memcpy(ctx->key, key, sizeof(ctx->key));
+    chunk_init(&ctx->chunk, key, 0, flags);
+    ctx->cv_stack_len = 0;
+    ctx->md_size = BLAKE3_OUT_LEN;
+    ctx->threads = 1;
+}
+
+void ossl_blake3_init(BLAKE3_CTX *ctx)
+{
+    blake3_init_base(ctx, IV, 0);
+}
+
+void ossl_blake3_init_keyed(BLAKE3_CTX *ctx,
+                            const unsigned char key[BLAKE3_KEY_LEN])
+{
+    uint32_t key_words[8];
+
+    load_key(key_words, key);
+    blake3_init_base(ctx, key_words, KEYED_HASH);
+    OPENSSL_cleanse(key_words, sizeof(key_words));
+}
+
+void ossl_blake3_init_derive_key(BLAKE3_CTX *ctx, const void *context,
+                                 size_t context_len)
+{
+    BLAKE3_CTX context_ctx;
+    uint8_t context_key[BLAKE3_KEY_LEN];
+    uint32_t key_words[8];
+
+    blake3_init_base(&context_ctx, IV, DERIVE_KEY_CONTEXT);
+    ossl_blake3_update(&context_ctx, context, context_len);
+    ossl_blake3_final(&context_ctx, context_key, sizeof(context_key));
+    load_key(key_words, context_key);
+    blake3_init_base(ctx, key_words, DERIVE_KEY_MATERIAL);
+    OPENSSL_cleanse(&context_ctx, sizeof(context_ctx));
+    OPENSSL_cleanse(context_key, sizeof(context_key));
+    OPENSSL_cleanse(key_words, sizeof(key_words));
+}
+
+/*
+ * Merges the chaining values on the stack that belong to complete subtrees,
+ * which leaves one per bit set in |total_len|, the number of chunks so far.
+ * The last one always stays on the stack, because it might be the root,
+ * which is only known once more input arrives or the hash is finalised.
+ */
+static void merge_cv_stack(BLAKE3_CTX *ctx, uint64_t total_len)
+{
+    size_t post_merge_len = popcnt(total_len);
+    uint8_t *parent_node;
+    OUTPUT output;
+
+    while (ctx->cv_stack_len > post_merge_len) {
+        parent_node = ctx->cv_stack + (ctx->cv_stack_len - 2) * BLAKE3_OUT_LEN;
+        parent_output(parent_node, ctx->key, ctx->chunk.flags, &output);
+        output_chaining_value(&output, parent_node);
+        ctx->cv_stack_len--;
+    }
+}
+
+static void push_cv(BLAKE3_CTX *ctx, const uint8_t new_cv[BLAKE3_OUT_LEN],
+                    uint64_t chunk_counter)
+{
+    merge_cv_stack(ctx, chunk_counter);
+    memcpy(ctx->cv_stack + ctx->cv_stack_len * BLAKE3_OUT_LEN, new_cv,
+           BLAKE3_OUT_LEN);
+    ctx->cv_stack_len++;
+}
+
+void ossl_blake3_update(BLAKE3_CTX *ctx, const void *data, size_t len)
+{
+    const uint8_t *input = data;
+    uint8_t cv_pair[2 * BLAKE3_OUT_LEN];
+    BLAKE3_CHUNK chunk;
+    OUTPUT output;
+    size_t take, subtree_len;
+    uint64_t subtree_chunks;
+
+    if (len == 0)
+        return;
+
+    /* Finish the current chunk, if there is one */
+    if (chunk_len(&ctx->chunk) > 0) {
+        take = BLAKE3_CHUNK_LEN - chunk_len(&ctx->chunk);
+        if (take > len)
+            take = len;
+        chunk_update(&ctx->chunk, input, take);
+        input += take;
+        len -= take;
+        if (len == 0)
+            return;
+        chunk_output(&ctx->chunk, &output);
+        output_chaining_value(&output, cv_pair);
+        push_cv(ctx, cv_pair, ctx->chunk.chunk_counter);
+        chunk_init(&ctx->chunk, ctx->key, ctx->chunk.chunk_counter + 1,
+                   ctx->chunk.flags);
+    }
+
+    /*
+     * Hash the biggest whole subtrees the input allows, as long as more than
+     * a chunk is left, as the last chunk could be the root.  A subtree has
+     * to be a power of 2 chunks, and start at a multiple of its size.
+     */
+    while (len > BLAKE3_CHUNK_LEN) {
+        subtree_len = (size_t)round_down_to_power_of_2(len);
+        while (((subtree_len - 1)
+                & (ctx->chunk.chunk_counter * BLAKE3_CHUNK_LEN)) != 0)
+            subtree_len /= 2;
+        subtree_chunks = subtree_len / BLAKE3_CHUNK_LEN;
+
+        if (subtree_len <= BLAKE3_CHUNK_LEN) {
+            chunk_init(&chunk, ctx->key, ctx->chunk.chunk_counter,
+                       ctx->chunk.flags);
+            chunk_update(&chunk, input, subtree_len);
+            chunk_output(&chunk, &output);
+            output_chaining_value(&output, cv_pair);
+            push_cv(ctx, cv_pair, chunk.chunk_counter);
+        } else {
+            compress_subtree_to_parent_node(input, subtree_len, ctx->key,
+                                            ctx->chunk.chunk_counter,
+                                            ctx->chunk.flags, cv_pair,
+                                            ctx->threads);
+            push_cv(ctx, cv_pair, ctx->chunk.chunk_counter);
+            push_cv(ctx, cv_pair + BLAKE3_OUT_LEN,
+                    ctx->chunk.chunk_counter + subtree_chunks / 2);
+        }
+        ctx->chunk.chunk_counter += subtree_chunks;
+        input += subtree_len;
+        len -= subtree_len;
+    }
+
+    if (len > 0) {
+        chunk_update(&ctx->chunk, input, len);
+        merge_cv_stack(ctx, ctx->chunk.chunk_counter);
+    }
+}
+
+void ossl_blake3_final(const BLAKE3_CTX *ctx, unsigned char *out,
+                       size_t outlen)
+{
+    uint8_t parent_block[BLAKE3_BLOCK_LEN];
+    size_t cvs_remaining;
+    OUTPUT output;
+
+    if (outlen == 0)
+        return;
+
+    /* A single chunk is the root itself */
+    if (ctx->cv_stack_len == 0) {
+        chunk_output(&ctx->chunk, &output);
+        output_root_bytes(&output, out, outlen);
+        return;
+    }
+
+    /*
+     * Otherwise merge everything on the stack into the root.  The stack
+     * isn't merged eagerly, so if the current chunk is empty, the root is
+     * the parent of the two last chaining values.
+     */
+    if (chunk_len(&ctx->chunk) > 0) {
+        cvs_remaining = ctx->cv_stack_len;
+        chunk_output(&ctx->chunk, &output);
+    } else {
+        cvs_remaining = ctx->cv_stack_len - 2;
+        parent_output(ctx->cv_stack + cvs_remaining * BLAKE3_OUT_LEN,
+                      ctx->key, ctx->chunk.flags, &output);
+    }
+    while (cvs_remaining > 0) {
+        cvs_remaining--;
+        memcpy(parent_block, ctx->cv_stack + cvs_remaining * BLAKE3_OUT_LEN,
+               BLAKE3_OUT_LEN);
+        output_chaining_value(&output, parent_block + BLAKE3_OUT_LEN);
+        parent_output(parent_block, ctx->key, ctx->chunk.flags, &output);
+    }
+    output_root_bytes(&output, out, outlen);
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <openssl/core_names.h>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/params.h>
+#include <openssl/err.h>
+#include "prov/blake3.h"
+#include "prov/digestcommon.h"
+#include "prov/implementations.h"
+#include "prov/providercommonerr.h"
+
+/* The most threads a single BLAKE3 update may use */
+#define BLAKE3_MAX_THREADS 64
+
+static OSSL_OP_digest_newctx_fn blake3_newctx;
+static OSSL_OP_digest_init_fn blake3_init;
+static OSSL_OP_digest_update_fn blake3_update;
+static OSSL_OP_digest_final_fn blake3_final;
+static OSSL_OP_digest_freectx_fn blake3_freectx;
+static OSSL_OP_digest_dupctx_fn blake3_dupctx;
+static OSSL_OP_digest_set_ctx_params_fn blake3_set_ctx_params;
+static OSSL_OP_digest_settable_ctx_params_fn blake3_settable_ctx_params;
+
+static void *blake3_newctx(void *provctx)
+{
+    BLAKE3_CTX *ctx = OPENSSL_zalloc(sizeof(*ctx));
+
+    if (ctx != NULL)
+        ossl_blake3_init(ctx);
+    return ctx;
+}
+
+static int blake3_init(void *vctx)
+{
+    BLAKE3_CTX *ctx = vctx;
+    unsigned int threads = ctx->threads;
+
+    /* The thread count is a property of the context, not of the message */
+    ossl_blake3_init(ctx);
+    ctx->threads = threads;
+    return 1;
+}
+
+static int blake3_update(void *vctx, const unsigned char *inp, size_t len)
+{
+    ossl_blake3_update((BLAKE3_CTX *)vctx, inp, len);
+    return 1;
+}
+
+static int blake3_final(void *vctx, unsigned char *out, size_t *outl,
+                        size_t outsz)
+{
+    BLAKE3_CTX *ctx = vctx;
+
+    if (outsz < ctx->md_size)
+        return 0;
+    ossl_blake3_final(ctx, out, ctx->md_size);
+    *outl = ctx->md_size;
+    return 1;
+}
+
+static void blake3_freectx(void *vctx)
+{
+    BLAKE3_CTX *ctx = (BLAKE3_CTX *)vctx;
+
+    OPENSSL_clear_free(ctx,  sizeof(*ctx));
+}
+
+static void *blake3_dupctx(void *ctx)
+{
+    BLAKE3_CTX *in = (BLAKE3_CTX *)ctx;
+    BLAKE3_CTX *ret = OPENSSL_malloc(sizeof(*ret));
+
+    if (ret != NULL)
+        *ret = *in;
+    return ret;
+}
+
+static const OSSL_PARAM known_blake3_settable_ctx_params[] = {
+    {OSSL_DIGEST_PARAM_XOFLEN, OSSL_PARAM_UNSIGNED_INTEGER, NULL, 0, 0},
+    {OSSL_DIGEST_PARAM_THREADS, OSSL_PARAM_UNSIGNED_INTEGER, NULL, 0, 0},
+    OSSL_PARAM_END
+};
+static const OSSL_PARAM *blake3_settable_ctx_params(void)
+{
+    return known_blake3_settable_ctx_params;
+}
+
+static int blake3_set_ctx_params(void *vctx, const OSSL_PARAM params[])
+{
+    const OSSL_PARAM *p;
+    BLAKE3_CTX *ctx = (BLAKE3_CTX *)vctx;
+    unsigned int threads;
+
+    if (ctx != NULL && params != NULL) {
+        p = OSSL_PARAM_locate_const(params, OSSL_DIGEST_PARAM_XOFLEN);
+        if (p != NULL && !OSSL_PARAM_get_size_t(p, &ctx->md_size)) {
+            ERR_raise(ERR_LIB_PROV, PROV_R_FAILED_TO_GET_PARAMETER);
+            return 0;
+        }
+        p = OSSL_PARAM_locate_const(params, OSSL_DIGEST_PARAM_THREADS);
+        if (p != NULL) {
+            if (!OSSL_PARAM_get_uint(p, &threads)) {
+                ERR_raise(ERR_LIB_PROV, PROV_R_FAILED_TO_GET_PARAMETER);
+                return 0;
+            }
+            if (threads == 0)
+                threads = 1;
+            else if (threads > BLAKE3_MAX_THREADS)
+                threads = BLAKE3_MAX_THREADS;
+            ctx->threads = threads;
+        }
+        return 1;
+    }
+    return 0; /* Null Parameter */
+}
+
+PROV_FUNC_DIGEST_GET_PARAM(blake3, BLAKE3_BLOCK_LEN, BLAKE3_OUT_LEN,
+                           EVP_MD_FLAG_XOF)
+const OSSL_DISPATCH blake3_functions[] = {
+    { OSSL_FUNC_DIGEST_NEWCTX, (void (*)(void))blake3_newctx },
+    { OSSL_FUNC_DIGEST_INIT, (void (*)(void))blake3_init },
+    { OSSL_FUNC_DIGEST_UPDATE, (void (*)(void))blake3_update },
+    { OSSL_FUNC_DIGEST_FINAL, (void (*)(void))blake3_final },
+    { OSSL_FUNC_DIGEST_FREECTX, (void (*)(void))blake3_freectx },
+    { OSSL_FUNC_DIGEST_DUPCTX, (void (*)(void))blake3_dupctx },
+    PROV_DISPATCH_FUNC_DIGEST_GET_PARAMS(blake3),
+    { OSSL_FUNC_DIGEST_SET_CTX_PARAMS, (void (*)(void))blake3_set_ctx_params },
+    { OSSL_FUNC_DIGEST_SETTABLE_CTX_PARAMS,
+      (void (*)(void))blake3_settable_ctx_params },
+    { 0, NULL }
+};
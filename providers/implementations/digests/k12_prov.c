@@ -0,0 +1,327 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <string.h>
+#include <openssl/core_names.h>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/params.h>
+#include <openssl/err.h>
+#include "internal/sha3.h"
+#include "prov/digestcommon.h"
+#include "prov/implementations.h"
+#include "prov/providercommonerr.h"
+
+/*
+ * KangarooTwelve, as KT128 and KT256 of RFC 9861.
+ *
+ * The message M, the customization string C and length_encode(|C|) make up
+ * the string S, which is cut into chunks of 8192 bytes.  If there is only
+ * one, the digest is TurboSHAKE(S) with the domain byte 0x07.  Otherwise the
+ * first chunk goes into the final node as it is, followed by 03 00^7, the
+ * chaining values of the other chunks, which are their TurboSHAKE with the
+ * domain byte 0x0B, length_encode() of their number and FF FF.  The digest
+ * is TurboSHAKE of the final node with the domain byte 0x06.
+ *
+ * The chunks after the first don't depend on one another, so they are
+ * collected until there are K12_LANES of them and then hashed all at once
+ * by ossl_keccak1600_hash_many(), which uses SIMD lanes where it can.
+ */
+#define K12_CHUNK       8192
+#define K12_LANES       8
+#define K12_ROUNDS      12
+#define K12_MAX_RATE    168
+#define K12_MAX_CV      64
+
+static OSSL_OP_digest_newctx_fn kt128_newctx;
+static OSSL_OP_digest_newctx_fn kt256_newctx;
+static OSSL_OP_digest_init_fn k12_init;
+static OSSL_OP_digest_update_fn k12_update;
+static OSSL_OP_digest_final_fn k12_final;
+static OSSL_OP_digest_freectx_fn k12_freectx;
+static OSSL_OP_digest_dupctx_fn k12_dupctx;
+static OSSL_OP_digest_set_ctx_params_fn k12_set_ctx_params;
+static OSSL_OP_digest_settable_ctx_params_fn k12_settable_ctx_params;
+
+typedef struct {
+    uint64_t A[5][5];                   /* the final node */
+    size_t rate;                        /* of TurboSHAKE, in bytes */
+    size_t cv_len;                      /* length of the chaining values */
+    size_t md_size;                     /* output length, variable in XOF */
+    size_t bufsz;                       /* used bytes in below buffer */
+    unsigned char buf[K12_MAX_RATE];
+    size_t first;                       /* bytes of the first chunk */
+    uint64_t leaves;                    /* chaining values in the node */
+    size_t leafsz;                      /* used bytes in below buffer */
+    unsigned char leaf[K12_LANES * K12_CHUNK];
+    unsigned char *custom;
+    size_t custom_len;
+} K12_CTX;
+
+static void *k12_newctx(size_t rate, size_t cv_len)
+{
+    K12_CTX *ctx = OPENSSL_zalloc(sizeof(*ctx));
+
+    if (ctx == NULL) {
+        ERR_raise(ERR_LIB_PROV, ERR_R_MALLOC_FAILURE);
+        return NULL;
+    }
+    ctx->rate = rate;
+    ctx->cv_len = cv_len;
+    ctx->md_size = cv_len;
+    return ctx;
+}
+
+static void *kt128_newctx(void *provctx)
+{
+    return k12_newctx(168, 32);
+}
+
+static void *kt256_newctx(void *provctx)
+{
+    return k12_newctx(136, 64);
+}
+
+static int k12_init(void *vctx)
+{
+    K12_CTX *ctx = vctx;
+
+    /* The customization string stays for the next messages */
+    memset(ctx->A, 0, sizeof(ctx->A));
+    ctx->md_size = ctx->cv_len;
+    ctx->bufsz = 0;
+    ctx->first = 0;
+    ctx->leaves = 0;
+    ctx->leafsz = 0;
+    return 1;
+}
+
+static void k12_node_absorb(K12_CTX *ctx, const unsigned char *inp,
+                            size_t len)
+{
+    size_t rate = ctx->rate, rem;
+
+    if (ctx->bufsz != 0) {
+        rem = rate - ctx->bufsz;
+        if (len < rem) {
+            memcpy(ctx->buf + ctx->bufsz, inp, len);
+            ctx->bufsz += len;
+            return;
+        }
+        memcpy(ctx->buf + ctx->bufsz, inp, rem);
+        inp += rem;
+        len -= rem;
+        (void)ossl_keccak1600_absorb(ctx->A, ctx->buf, rate, rate, K12_ROUNDS);
+        ctx->bufsz = 0;
+    }
+    rem = ossl_keccak1600_absorb(ctx->A, inp, len, rate, K12_ROUNDS);
+    memcpy(ctx->buf, inp + len - rem, rem);
+    ctx->bufsz = rem;
+}
+
+/* Hashes |num| leaves of |len| bytes at |inp| into the final node */
+static void k12_leaves(K12_CTX *ctx, const unsigned char *inp, size_t num,
+                       size_t len)
+{
+    unsigned char cv[K12_LANES * K12_MAX_CV];
+    size_t n;
+
+    while (num != 0) {
+        n = num < K12_LANES ? num : K12_LANES;
+        ossl_keccak1600_hash_many(cv, ctx->cv_len, inp, len, n, ctx->rate,
+                                  0x0B, K12_ROUNDS);
+        k12_node_absorb(ctx, cv, n * ctx->cv_len);
+        ctx->leaves += n;
+        inp += n * len;
+        num -= n;
+    }
+}
+
+/* Adds the next |len| bytes of S */
+static void k12_absorb(K12_CTX *ctx, const unsigned char *inp, size_t len)
+{
+    static const unsigned char marker[8] = { 0x03 };
+    size_t n;
+
+    if (ctx->first < K12_CHUNK) {
+        n = K12_CHUNK - ctx->first;
+        if (n > len)
+            n = len;
+        k12_node_absorb(ctx, inp, n);
+        ctx->first += n;
+        inp += n;
+        len -= n;
+    }
+    if (len == 0)
+        return;
+
+    /* S doesn't fit in one chunk, so this is a tree */
+    if (ctx->leaves == 0 && ctx->leafsz == 0)
+        k12_node_absorb(ctx, marker, sizeof(marker));
+
+    if (ctx->leafsz != 0) {
+        n = sizeof(ctx->leaf) - ctx->leafsz;
+        if (n > len)
+            n = len;
+        memcpy(ctx->leaf + ctx->leafsz, inp, n);
+        ctx->leafsz += n;
+        inp += n;
+        len -= n;
+        if (ctx->leafsz < sizeof(ctx->leaf))
+            return;
+        k12_leaves(ctx, ctx->leaf, K12_LANES, K12_CHUNK);
+        ctx->leafsz = 0;
+    }
+
+    /* Whole batches of leaves are hashed where they are */
+    n = len / sizeof(ctx->leaf) * K12_LANES;
+    k12_leaves(ctx, inp, n, K12_CHUNK);
+    inp += n * K12_CHUNK;
+    len -= n * K12_CHUNK;
+
+    memcpy(ctx->leaf, inp, len);
+    ctx->leafsz = len;
+}
+
+static size_t length_encode(unsigned char *out, uint64_t x)
+{
+    size_t n = 0, i;
+
+    while (n < 8 && (x >> (8 * n)) != 0)
+        n++;
+    for (i = 0; i < n; i++)
+        out[i] = (unsigned char)(x >> (8 * (n - 1 - i)));
+    out[n] = (unsigned char)n;
+    return n + 1;
+}
+
+static int k12_update(void *vctx, const unsigned char *inp, size_t len)
+{
+    k12_absorb((K12_CTX *)vctx, inp, len);
+    return 1;
+}
+
+static int k12_final(void *vctx, unsigned char *out, size_t *outl,
+                     size_t outsz)
+{
+    static const unsigned char tail[2] = { 0xFF, 0xFF };
+    K12_CTX *ctx = vctx;
+    unsigned char enc[9];
+    unsigned char pad = 0x07;
+    size_t full;
+
+    if (outsz < ctx->md_size)
+        return 0;
+
+    k12_absorb(ctx, ctx->custom, ctx->custom_len);
+    k12_absorb(ctx, enc, length_encode(enc, ctx->custom_len));
+
+    if (ctx->leaves != 0 || ctx->leafsz != 0) {
+        /* All but the last leaf are whole chunks */
+        full = ctx->leafsz / K12_CHUNK;
+        k12_leaves(ctx, ctx->leaf, full, K12_CHUNK);
+        if (ctx->leafsz % K12_CHUNK != 0)
+            k12_leaves(ctx, ctx->leaf + full * K12_CHUNK, 1,
+                       ctx->leafsz % K12_CHUNK);
+        k12_node_absorb(ctx, enc, length_encode(enc, ctx->leaves));
+        k12_node_absorb(ctx, tail, sizeof(tail));
+        pad = 0x06;
+    }
+
+    memset(ctx->buf + ctx->bufsz, 0, ctx->rate - ctx->bufsz);
+    ctx->buf[ctx->bufsz] = pad;
+    ctx->buf[ctx->rate - 1] |= 0x80;
+    (void)ossl_keccak1600_absorb(ctx->A, ctx->buf, ctx->rate, ctx->rate,
+                                 K12_ROUNDS);
+    ossl_keccak1600_squeeze(ctx->A, out, ctx->md_size, ctx->rate, K12_ROUNDS);
+    *outl = ctx->md_size;
+    return 1;
+}
+
+static void k12_freectx(void *vctx)
+{
+    K12_CTX *ctx = (K12_CTX *)vctx;
+
+    OPENSSL_clear_free(ctx->custom, ctx->custom_len);
+    OPENSSL_clear_free(ctx, sizeof(*ctx));
+}
+
+static void *k12_dupctx(void *vctx)
+{
+    K12_CTX *in = (K12_CTX *)vctx;
+    K12_CTX *ret = OPENSSL_malloc(sizeof(*ret));
+
+    if (ret == NULL)
+        return NULL;
+    *ret = *in;
+    if (in->custom != NULL
+        && (ret->custom = OPENSSL_memdup(in->custom, in->custom_len)) == NULL) {
+        OPENSSL_clear_free(ret, sizeof(*ret));
+        return NULL;
+    }
+    return ret;
+}
+
+static const OSSL_PARAM known_k12_settable_ctx_params[] = {
+    {OSSL_DIGEST_PARAM_XOFLEN, OSSL_PARAM_UNSIGNED_INTEGER, NULL, 0, 0},
+    OSSL_PARAM_octet_string(OSSL_DIGEST_PARAM_CUSTOM, NULL, 0),
+    OSSL_PARAM_END
+};
+static const OSSL_PARAM *k12_settable_ctx_params(void)
+{
+    return known_k12_settable_ctx_params;
+}
+
+static int k12_set_ctx_params(void *vctx, const OSSL_PARAM params[])
+{
+    const OSSL_PARAM *p;
+    K12_CTX *ctx = (K12_CTX *)vctx;
+
+    if (ctx != NULL && params != NULL) {
+        p = OSSL_PARAM_locate_const(params, OSSL_DIGEST_PARAM_XOFLEN);
+        if (p != NULL && !OSSL_PARAM_get_size_t(p, &ctx->md_size)) {
+            ERR_raise(ERR_LIB_PROV, PROV_R_FAILED_TO_GET_PARAMETER);
+            return 0;
+        }
+        p = OSSL_PARAM_locate_const(params, OSSL_DIGEST_PARAM_CUSTOM);
+        if (p != NULL) {
+            OPENSSL_clear_free(ctx->custom, ctx->custom_len);
+            ctx->custom = NULL;
+            ctx->custom_len = 0;
+            if (!OSSL_PARAM_get_octet_string(p, (void **)&ctx->custom, 0,
+                                             &ctx->custom_len)) {
+                ERR_raise(ERR_LIB_PROV, PROV_R_FAILED_TO_GET_PARAMETER);
+                return 0;
+            }
+        }
+        return 1;
+    }
+    return 0; /* Null Parameter */
+}
+
+#define IMPLEMENT_K12_functions(name, rate, cv_len)                            \
+PROV_FUNC_DIGEST_GET_PARAM(name, rate, cv_len, EVP_MD_FLAG_XOF)                \
+const OSSL_DISPATCH name##_functions[] = {                                     \
+    { OSSL_FUNC_DIGEST_NEWCTX, (void (*)(void))name##_newctx },                \
+    { OSSL_FUNC_DIGEST_INIT, (void (*)(void))k12_init },                       \
+    { OSSL_FUNC_DIGEST_UPDATE, (void (*)(void))k12_update },                   \
+    { OSSL_FUNC_DIGEST_FINAL, (void (*)(void))k12_final },                     \
+    { OSSL_FUNC_DIGEST_FREECTX, (void (*)(void))k12_freectx },                 \
+    { OSSL_FUNC_DIGEST_DUPCTX, (void (*)(void))k12_dupctx },                   \
+    PROV_DISPATCH_FUNC_DIGEST_GET_PARAMS(name),                                \
+    { OSSL_FUNC_DIGEST_SET_CTX_PARAMS, (void (*)(void))k12_set_ctx_params },   \
+    { OSSL_FUNC_DIGEST_SETTABLE_CTX_PARAMS,                                    \
+      (void (*)(void))k12_settable_ctx_params },                               \
+    { 0, NULL }                                                                \
+};
+
+/* kt128_functions */
+IMPLEMENT_K12_functions(kt128, 168, 32)
+/* kt256_functions */
+IMPLEMENT_K12_functions(kt256, 136, 64)
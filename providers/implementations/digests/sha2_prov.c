@@ -52,22 +52,29 @@ static int sha1_set_ctx_params(void *vctx, const OSSL_PARAM params[])
 }
 
 /* sha1_functions */
-IMPLEMENT_digest_functions_with_settable_ctx(
+PROV_FUNC_DIGEST_DIGEST_MANY(sha1, SHA_DIGEST_LENGTH, sha1_digest_many)
+PROV_DISPATCH_FUNC_DIGEST_CONSTRUCT_START(
     sha1, SHA_CTX, SHA_CBLOCK, SHA_DIGEST_LENGTH, EVP_MD_FLAG_DIGALGID_ABSENT,
-    SHA1_Init, SHA1_Update, SHA1_Final,
-    sha1_settable_ctx_params, sha1_set_ctx_params)
+    SHA1_Init, SHA1_Update, SHA1_Final),
+{ OSSL_FUNC_DIGEST_SETTABLE_CTX_PARAMS,
+  (void (*)(void))sha1_settable_ctx_params },
+{ OSSL_FUNC_DIGEST_SET_CTX_PARAMS, (void (*)(void))sha1_set_ctx_params },
+PROV_DISPATCH_FUNC_DIGEST_DIGEST_MANY(sha1),
+PROV_DISPATCH_FUNC_DIGEST_CONSTRUCT_END
 
 /* sha224_functions */
-IMPLEMENT_digest_functions(sha224, SHA256_CTX,
-                           SHA256_CBLOCK, SHA224_DIGEST_LENGTH,
-                           EVP_MD_FLAG_DIGALGID_ABSENT,
-                           SHA224_Init, SHA224_Update, SHA224_Final)
+IMPLEMENT_digest_functions_with_many(sha224, SHA256_CTX,
+                                     SHA256_CBLOCK, SHA224_DIGEST_LENGTH,
+                                     EVP_MD_FLAG_DIGALGID_ABSENT,
+                                     SHA224_Init, SHA224_Update, SHA224_Final,
+                                     sha224_digest_many)
 
 /* sha256_functions */
-IMPLEMENT_digest_functions(sha256, SHA256_CTX,
-                           SHA256_CBLOCK, SHA256_DIGEST_LENGTH,
-                           EVP_MD_FLAG_DIGALGID_ABSENT,
-                           SHA256_Init, SHA256_Update, SHA256_Final)
+IMPLEMENT_digest_functions_with_many(sha256, SHA256_CTX,
+                                     SHA256_CBLOCK, SHA256_DIGEST_LENGTH,
+                                     EVP_MD_FLAG_DIGALGID_ABSENT,
+                                     SHA256_Init, SHA256_Update, SHA256_Final,
+                                     sha256_digest_many)
 
 /* sha384_functions */
 IMPLEMENT_digest_functions(sha384, SHA512_CTX,
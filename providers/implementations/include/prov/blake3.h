@@ -0,0 +1,57 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#ifndef OSSL_PROV_BLAKE3_H
+# define OSSL_PROV_BLAKE3_H
+
+# include <openssl/e_os2.h>
+# include <stddef.h>
+
+# define BLAKE3_KEY_LEN     32
+# define BLAKE3_OUT_LEN     32
+# define BLAKE3_BLOCK_LEN   64
+# define BLAKE3_CHUNK_LEN   1024
+# define BLAKE3_MAX_DEPTH   54
+
+/* The chunk being absorbed */
+typedef struct blake3_chunk_st {
+    uint32_t cv[8];
+    uint64_t chunk_counter;
+    uint8_t buf[BLAKE3_BLOCK_LEN];
+    uint8_t buf_len;
+    uint8_t blocks_compressed;
+    uint8_t flags;
+} BLAKE3_CHUNK;
+
+/*
+ * The hashing state: the current chunk, and a stack with the chaining
+ * values of the complete subtrees to its left.  Whole subtrees of input
+ * are hashed straight into the stack, several chunks at a time, and by
+ * several threads when |threads| is above 1.
+ */
+typedef struct blake3_ctx_st {
+    uint32_t key[8];
+    BLAKE3_CHUNK chunk;
+    uint8_t cv_stack_len;
+    uint8_t cv_stack[(BLAKE3_MAX_DEPTH + 1) * BLAKE3_OUT_LEN];
+    size_t md_size;
+    unsigned int threads;
+} BLAKE3_CTX;
+
+void ossl_blake3_init(BLAKE3_CTX *ctx);
+void ossl_blake3_init_keyed(BLAKE3_CTX *ctx,
+                            const unsigned char key[BLAKE3_KEY_LEN]);
+void ossl_blake3_init_derive_key(BLAKE3_CTX *ctx, const void *context,
+                                 size_t context_len);
+void ossl_blake3_update(BLAKE3_CTX *ctx, const void *data, size_t len);
+/* Doesn't change |ctx|, so more input can follow */
+void ossl_blake3_final(const BLAKE3_CTX *ctx, unsigned char *out,
+                       size_t outlen);
+
+#endif /* OSSL_PROV_BLAKE3_H */
@@ -85,6 +85,7 @@ OSSL_OP_cipher_set_ctx_params_fn ccm_set_ctx_params;
 OSSL_OP_cipher_update_fn ccm_stream_update;
 OSSL_OP_cipher_final_fn ccm_stream_final;
 OSSL_OP_cipher_cipher_fn ccm_cipher;
+OSSL_OP_cipher_aead_cipher_fn ccm_aead_cipher;
 void ccm_initctx(PROV_CCM_CTX *ctx, size_t keybits, const PROV_CCM_HW *hw);
 
 int ccm_generic_setiv(PROV_CCM_CTX *ctx, const unsigned char *nonce,
@@ -30,6 +30,20 @@ static int name##_get_params(OSSL_PARAM params[])                              \
 { OSSL_FUNC_DIGEST_GETTABLE_PARAMS,                                            \
   (void (*)(void))digest_default_gettable_params }
 
+#define PROV_FUNC_DIGEST_DIGEST_MANY(name, dgstsize, many)                     \
+static OSSL_OP_digest_digest_many_fn name##_internal_digest_many;              \
+static int name##_internal_digest_many(void *provctx, size_t num,              \
+                                       const unsigned char *const in[],        \
+                                       const size_t inl[],                     \
+                                       unsigned char *const out[],             \
+                                       size_t outsz)                           \
+{                                                                              \
+    return outsz >= dgstsize && many(num, in, inl, out);                       \
+}
+
+#define PROV_DISPATCH_FUNC_DIGEST_DIGEST_MANY(name)                            \
+{ OSSL_FUNC_DIGEST_DIGEST_MANY, (void (*)(void))name##_internal_digest_many }
+
 # define PROV_DISPATCH_FUNC_DIGEST_CONSTRUCT_START(                            \
     name, CTX, blksize, dgstsize, flags, init, upd, fin)                       \
 static OSSL_OP_digest_newctx_fn name##_newctx;                                 \
@@ -92,6 +106,14 @@ PROV_DISPATCH_FUNC_DIGEST_CONSTRUCT_START(name, CTX, blksize, dgstsize, flags, \
 { OSSL_FUNC_DIGEST_SET_CTX_PARAMS, (void (*)(void))set_ctx_params },           \
 PROV_DISPATCH_FUNC_DIGEST_CONSTRUCT_END
 
+# define IMPLEMENT_digest_functions_with_many(                                 \
+    name, CTX, blksize, dgstsize, flags, init, upd, fin, many)                 \
+PROV_FUNC_DIGEST_DIGEST_MANY(name, dgstsize, many)                             \
+PROV_DISPATCH_FUNC_DIGEST_CONSTRUCT_START(name, CTX, blksize, dgstsize, flags, \
+                                          init, upd, fin),                     \
+PROV_DISPATCH_FUNC_DIGEST_DIGEST_MANY(name),                                   \
+PROV_DISPATCH_FUNC_DIGEST_CONSTRUCT_END
+
 
 const OSSL_PARAM *digest_default_gettable_params(void);
 int digest_default_get_params(OSSL_PARAM params[], size_t blksz, size_t paramsz,
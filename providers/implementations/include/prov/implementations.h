@@ -23,8 +23,11 @@ extern const OSSL_DISPATCH keccak_kmac_128_functions[];
 extern const OSSL_DISPATCH keccak_kmac_256_functions[];
 extern const OSSL_DISPATCH shake_128_functions[];
 extern const OSSL_DISPATCH shake_256_functions[];
+extern const OSSL_DISPATCH kt128_functions[];
+extern const OSSL_DISPATCH kt256_functions[];
 extern const OSSL_DISPATCH blake2s256_functions[];
 extern const OSSL_DISPATCH blake2b512_functions[];
+extern const OSSL_DISPATCH blake3_functions[];
 extern const OSSL_DISPATCH md5_functions[];
 extern const OSSL_DISPATCH md5_sha1_functions[];
 extern const OSSL_DISPATCH sm3_functions[];
@@ -163,6 +166,8 @@ extern const OSSL_DISPATCH sm4128cbc_functions[];
 extern const OSSL_DISPATCH sm4128ctr_functions[];
 extern const OSSL_DISPATCH sm4128ofb128_functions[];
 extern const OSSL_DISPATCH sm4128cfb128_functions[];
+extern const OSSL_DISPATCH sm4128gcm_functions[];
+extern const OSSL_DISPATCH sm4128ccm_functions[];
 #endif /* OPENSSL_NO_SM4 */
 #ifndef OPENSSL_NO_RC5
 extern const OSSL_DISPATCH rc5128ecb_functions[];
@@ -223,16 +228,21 @@ extern const OSSL_DISPATCH chacha20_poly1305_functions[];
 extern const OSSL_DISPATCH aes128siv_functions[];
 extern const OSSL_DISPATCH aes192siv_functions[];
 extern const OSSL_DISPATCH aes256siv_functions[];
+extern const OSSL_DISPATCH aes128gcm_siv_functions[];
+extern const OSSL_DISPATCH aes256gcm_siv_functions[];
 #endif /* OPENSSL_NO_SIV */
 
 /* MACs */
 extern const OSSL_DISPATCH blake2bmac_functions[];
 extern const OSSL_DISPATCH blake2smac_functions[];
+extern const OSSL_DISPATCH blake3mac_functions[];
 extern const OSSL_DISPATCH cmac_functions[];
 extern const OSSL_DISPATCH gmac_functions[];
 extern const OSSL_DISPATCH hmac_functions[];
 extern const OSSL_DISPATCH kmac128_functions[];
 extern const OSSL_DISPATCH kmac256_functions[];
+extern const OSSL_DISPATCH parallelhash128_functions[];
+extern const OSSL_DISPATCH parallelhash256_functions[];
 extern const OSSL_DISPATCH siphash_functions[];
 extern const OSSL_DISPATCH poly1305_functions[];
 
@@ -251,6 +261,7 @@ extern const OSSL_DISPATCH kdf_kbkdf_functions[];
 extern const OSSL_DISPATCH kdf_x942_kdf_functions[];
 #endif
 extern const OSSL_DISPATCH kdf_krb5kdf_functions[];
+extern const OSSL_DISPATCH kdf_blake3_functions[];
 
 
 /* Key management */
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <string.h>
+#include <openssl/core_numbers.h>
+#include <openssl/kdf.h>
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#include "internal/cryptlib.h"
+#include "prov/blake3.h"
+#include "prov/providercommonerr.h"
+#include "prov/implementations.h"
+
+/*
+ * The BLAKE3 derive_key mode: the context string, which should be fixed for
+ * the application and purpose, keys the hashing of the key material.
+ */
+static OSSL_OP_kdf_newctx_fn kdf_blake3_new;
+static OSSL_OP_kdf_freectx_fn kdf_blake3_free;
+static OSSL_OP_kdf_reset_fn kdf_blake3_reset;
+static OSSL_OP_kdf_derive_fn kdf_blake3_derive;
+static OSSL_OP_kdf_settable_ctx_params_fn kdf_blake3_settable_ctx_params;
+static OSSL_OP_kdf_set_ctx_params_fn kdf_blake3_set_ctx_params;
+static OSSL_OP_kdf_gettable_ctx_params_fn kdf_blake3_gettable_ctx_params;
+static OSSL_OP_kdf_get_ctx_params_fn kdf_blake3_get_ctx_params;
+
+typedef struct {
+    void *provctx;
+    unsigned char *key;
+    size_t key_len;
+    unsigned char *context;
+    size_t context_len;
+} KDF_BLAKE3;
+
+static void *kdf_blake3_new(void *provctx)
+{
+    KDF_BLAKE3 *ctx;
+
+    if ((ctx = OPENSSL_zalloc(sizeof(*ctx))) == NULL) {
+        ERR_raise(ERR_LIB_PROV, ERR_R_MALLOC_FAILURE);
+        return NULL;
+    }
+    ctx->provctx = provctx;
+    return ctx;
+}
+
+static void kdf_blake3_free(void *vctx)
+{
+    KDF_BLAKE3 *ctx = (KDF_BLAKE3 *)vctx;
+
+    if (ctx != NULL) {
+        kdf_blake3_reset(ctx);
+        OPENSSL_free(ctx);
+    }
+}
+
+static void kdf_blake3_reset(void *vctx)
+{
+    KDF_BLAKE3 *ctx = (KDF_BLAKE3 *)vctx;
+    void *provctx = ctx->provctx;
+
+    OPENSSL_clear_free(ctx->key, ctx->key_len);
+    OPENSSL_free(ctx->context);
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->provctx = provctx;
+}
+
+static int blake3_set_membuf(unsigned char **dst, size_t *dst_len,
+                             const OSSL_PARAM *p)
+{
+    OPENSSL_clear_free(*dst, *dst_len);
+    *dst = NULL;
+    *dst_len = 0;
+    return OSSL_PARAM_get_octet_string(p, (void **)dst, 0, dst_len);
+}
+
+static int kdf_blake3_derive(void *vctx, unsigned char *key, size_t keylen)
+{
+    KDF_BLAKE3 *ctx = (KDF_BLAKE3 *)vctx;
+    BLAKE3_CTX b3;
+
+    if (ctx->key == NULL) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_MISSING_KEY);
+        return 0;
+    }
+    ossl_blake3_init_derive_key(&b3, ctx->context, ctx->context_len);
+    ossl_blake3_update(&b3, ctx->key, ctx->key_len);
+    ossl_blake3_final(&b3, key, keylen);
+    OPENSSL_cleanse(&b3, sizeof(b3));
+    return 1;
+}
+
+static int kdf_blake3_set_ctx_params(void *vctx, const OSSL_PARAM params[])
+{
+    const OSSL_PARAM *p;
+    KDF_BLAKE3 *ctx = vctx;
+
+    if ((p = OSSL_PARAM_locate_const(params, OSSL_KDF_PARAM_KEY)) != NULL)
+        if (!blake3_set_membuf(&ctx->key, &ctx->key_len, p))
+            return 0;
+
+    if ((p = OSSL_PARAM_locate_const(params, OSSL_KDF_PARAM_INFO)) != NULL)
+        if (!blake3_set_membuf(&ctx->context, &ctx->context_len, p))
+            return 0;
+    return 1;
+}
+
+static const OSSL_PARAM *kdf_blake3_settable_ctx_params(void)
+{
+    static const OSSL_PARAM known_settable_ctx_params[] = {
+        OSSL_PARAM_octet_string(OSSL_KDF_PARAM_KEY, NULL, 0),
+        OSSL_PARAM_octet_string(OSSL_KDF_PARAM_INFO, NULL, 0),
+        OSSL_PARAM_END
+    };
+    return known_settable_ctx_params;
+}
+
+static int kdf_blake3_get_ctx_params(void *vctx, OSSL_PARAM params[])
+{
+    OSSL_PARAM *p;
+
+    if ((p = OSSL_PARAM_locate(params, OSSL_KDF_PARAM_SIZE)) != NULL)
+        return OSSL_PARAM_set_size_t(p, SIZE_MAX);
+    return -2;
+}
+
+static const OSSL_PARAM *kdf_blake3_gettable_ctx_params(void)
+{
+    static const OSSL_PARAM known_gettable_ctx_params[] = {
+        OSSL_PARAM_size_t(OSSL_KDF_PARAM_SIZE, NULL),
+        OSSL_PARAM_END
+    };
+    return known_gettable_ctx_params;
+}
+
+const OSSL_DISPATCH kdf_blake3_functions[] = {
+    { OSSL_FUNC_KDF_NEWCTX, (void(*)(void))kdf_blake3_new },
+    { OSSL_FUNC_KDF_FREECTX, (void(*)(void))kdf_blake3_free },
+    { OSSL_FUNC_KDF_RESET, (void(*)(void))kdf_blake3_reset },
+    { OSSL_FUNC_KDF_DERIVE, (void(*)(void))kdf_blake3_derive },
+    { OSSL_FUNC_KDF_SETTABLE_CTX_PARAMS,
+      (void(*)(void))kdf_blake3_settable_ctx_params },
+    { OSSL_FUNC_KDF_SET_CTX_PARAMS, (void(*)(void))kdf_blake3_set_ctx_params },
+    { OSSL_FUNC_KDF_GETTABLE_CTX_PARAMS,
+      (void(*)(void))kdf_blake3_gettable_ctx_params },
+    { OSSL_FUNC_KDF_GET_CTX_PARAMS, (void(*)(void))kdf_blake3_get_ctx_params },
+    { 0, NULL }
+};
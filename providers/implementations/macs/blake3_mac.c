@@ -0,0 +1,181 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <openssl/core_numbers.h>
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+
+#include "prov/blake3.h"
+#include "internal/cryptlib.h"
+#include "prov/providercommonerr.h"
+#include "prov/implementations.h"
+
+/*
+ * Forward declaration of everything implemented here.  This is not strictly
+ * necessary for the compiler, but provides an assurance that the signatures
+ * of the functions in the dispatch table are correct.
+ */
+static OSSL_OP_mac_newctx_fn blake3_mac_new;
+static OSSL_OP_mac_dupctx_fn blake3_mac_dup;
+static OSSL_OP_mac_freectx_fn blake3_mac_free;
+static OSSL_OP_mac_gettable_ctx_params_fn blake3_gettable_ctx_params;
+static OSSL_OP_mac_get_ctx_params_fn blake3_get_ctx_params;
+static OSSL_OP_mac_settable_ctx_params_fn blake3_mac_settable_ctx_params;
+static OSSL_OP_mac_set_ctx_params_fn blake3_mac_set_ctx_params;
+static OSSL_OP_mac_init_fn blake3_mac_init;
+static OSSL_OP_mac_update_fn blake3_mac_update;
+static OSSL_OP_mac_final_fn blake3_mac_final;
+
+struct blake3_mac_data_st {
+    BLAKE3_CTX ctx;
+    unsigned char key[BLAKE3_KEY_LEN];
+    int key_set;
+    size_t out_len;
+};
+
+static void *blake3_mac_new(void *unused_provctx)
+{
+    struct blake3_mac_data_st *macctx = OPENSSL_zalloc(sizeof(*macctx));
+
+    /* ctx initialization is deferred to init() */
+    if (macctx != NULL)
+        macctx->out_len = BLAKE3_OUT_LEN;
+    return macctx;
+}
+
+static void *blake3_mac_dup(void *vsrc)
+{
+    struct blake3_mac_data_st *dst;
+    struct blake3_mac_data_st *src = vsrc;
+
+    dst = OPENSSL_zalloc(sizeof(*dst));
+    if (dst == NULL)
+        return NULL;
+
+    *dst = *src;
+    return dst;
+}
+
+static void blake3_mac_free(void *vmacctx)
+{
+    OPENSSL_clear_free(vmacctx, sizeof(struct blake3_mac_data_st));
+}
+
+static int blake3_mac_init(void *vmacctx)
+{
+    struct blake3_mac_data_st *macctx = vmacctx;
+
+    /* Check key has been set */
+    if (!macctx->key_set) {
+        ERR_raise(ERR_LIB_PROV, PROV_R_NO_KEY_SET);
+        return 0;
+    }
+
+    ossl_blake3_init_keyed(&macctx->ctx, macctx->key);
+    return 1;
+}
+
+static int blake3_mac_update(void *vmacctx,
+                             const unsigned char *data, size_t datalen)
+{
+    struct blake3_mac_data_st *macctx = vmacctx;
+
+    ossl_blake3_update(&macctx->ctx, data, datalen);
+    return 1;
+}
+
+static int blake3_mac_final(void *vmacctx,
+                            unsigned char *out, size_t *outl,
+                            size_t outsize)
+{
+    struct blake3_mac_data_st *macctx = vmacctx;
+
+    if (outsize < macctx->out_len)
+        return 0;
+    ossl_blake3_final(&macctx->ctx, out, macctx->out_len);
+    *outl = macctx->out_len;
+    return 1;
+}
+
+static const OSSL_PARAM known_gettable_ctx_params[] = {
+    OSSL_PARAM_size_t(OSSL_MAC_PARAM_SIZE, NULL),
+    OSSL_PARAM_END
+};
+static const OSSL_PARAM *blake3_gettable_ctx_params(void)
+{
+    return known_gettable_ctx_params;
+}
+
+static int blake3_get_ctx_params(void *vmacctx, OSSL_PARAM params[])
+{
+    struct blake3_mac_data_st *macctx = vmacctx;
+    OSSL_PARAM *p;
+
+    if ((p = OSSL_PARAM_locate(params, OSSL_MAC_PARAM_SIZE)) != NULL)
+        return OSSL_PARAM_set_size_t(p, macctx->out_len);
+
+    return 1;
+}
+
+static const OSSL_PARAM known_settable_ctx_params[] = {
+    OSSL_PARAM_size_t(OSSL_MAC_PARAM_SIZE, NULL),
+    OSSL_PARAM_octet_string(OSSL_MAC_PARAM_KEY, NULL, 0),
+    OSSL_PARAM_END
+};
+static const OSSL_PARAM *blake3_mac_settable_ctx_params(void)
+{
+    return known_settable_ctx_params;
+}
+
+/*
+ * ALL parameters should be set before init().
+ */
+static int blake3_mac_set_ctx_params(void *vmacctx, const OSSL_PARAM params[])
+{
+    struct blake3_mac_data_st *macctx = vmacctx;
+    const OSSL_PARAM *p;
+
+    if ((p = OSSL_PARAM_locate_const(params, OSSL_MAC_PARAM_SIZE)) != NULL) {
+        size_t size;
+
+        /* BLAKE3 is an XOF, so any output length will do */
+        if (!OSSL_PARAM_get_size_t(p, &size) || size < 1) {
+            ERR_raise(ERR_LIB_PROV, PROV_R_NOT_XOF_OR_INVALID_LENGTH);
+            return 0;
+        }
+        macctx->out_len = size;
+    }
+
+    if ((p = OSSL_PARAM_locate_const(params, OSSL_MAC_PARAM_KEY)) != NULL) {
+        if (p->data_type != OSSL_PARAM_OCTET_STRING
+            || p->data_size != BLAKE3_KEY_LEN) {
+            ERR_raise(ERR_LIB_PROV, PROV_R_INVALID_KEY_LENGTH);
+            return 0;
+        }
+        memcpy(macctx->key, p->data, BLAKE3_KEY_LEN);
+        macctx->key_set = 1;
+    }
+    return 1;
+}
+
+const OSSL_DISPATCH blake3mac_functions[] = {
+    { OSSL_FUNC_MAC_NEWCTX, (void (*)(void))blake3_mac_new },
+    { OSSL_FUNC_MAC_DUPCTX, (void (*)(void))blake3_mac_dup },
+    { OSSL_FUNC_MAC_FREECTX, (void (*)(void))blake3_mac_free },
+    { OSSL_FUNC_MAC_INIT, (void (*)(void))blake3_mac_init },
+    { OSSL_FUNC_MAC_UPDATE, (void (*)(void))blake3_mac_update },
+    { OSSL_FUNC_MAC_FINAL, (void (*)(void))blake3_mac_final },
+    { OSSL_FUNC_MAC_GETTABLE_CTX_PARAMS,
+      (void (*)(void))blake3_gettable_ctx_params },
+    { OSSL_FUNC_MAC_GET_CTX_PARAMS, (void (*)(void))blake3_get_ctx_params },
+    { OSSL_FUNC_MAC_SETTABLE_CTX_PARAMS,
+      (void (*)(void))blake3_mac_settable_ctx_params },
+    { OSSL_FUNC_MAC_SET_CTX_PARAMS, (void (*)(void))blake3_mac_set_ctx_params },
+    { 0, NULL }
+};
@@ -0,0 +1,317 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * ParallelHash of SP800-185 section 6, with the block size B in bytes:
+ *
+ * ParallelHash128(X, B, L, S)
+ * {
+ *     n = ceil(len(X) / B).
+ *     z = left_encode(B) || SHAKE128(X[0], 256) || ...
+ *         || SHAKE128(X[n-1], 256) || right_encode(n) || right_encode(L).
+ *     return cSHAKE128(z, L, "ParallelHash", S).
+ * }
+ *
+ * ParallelHash256 uses SHAKE256(X[i], 512) and cSHAKE256, and the XOF
+ * variants use right_encode(0) instead of right_encode(L).  The SHAKE of the
+ * blocks X[i] don't depend on one another, so they are computed several at
+ * a time with ossl_keccak1600_hash_many().
+ */
+
+/*
+ * ParallelHash is built on the same cSHAKE and encodings as KMAC, but it is
+ * kept out of kmac_prov.c so that the FIPS provider, which has KMAC, doesn't
+ * pull in ossl_keccak1600_hash_many().
+ */
+#include "kmac_impl.c"
+#include "internal/sha3.h"
+
+static OSSL_OP_mac_newctx_fn parallelhash128_new;
+static OSSL_OP_mac_newctx_fn parallelhash256_new;
+static OSSL_OP_mac_dupctx_fn parallelhash_dup;
+static OSSL_OP_mac_settable_ctx_params_fn parallelhash_settable_ctx_params;
+static OSSL_OP_mac_set_ctx_params_fn parallelhash_set_ctx_params;
+static OSSL_OP_mac_init_fn parallelhash_init;
+static OSSL_OP_mac_update_fn parallelhash_update;
+static OSSL_OP_mac_final_fn parallelhash_final;
+
+/* Fixed value of encode_string("ParallelHash") */
+static const unsigned char parallelhash_string[] = {
+    0x01, 0x60, 0x50, 0x61, 0x72, 0x61, 0x6C, 0x6C, 0x65, 0x6C, 0x48, 0x61,
+    0x73, 0x68
+};
+
+/* ParallelHash blocks hashed at once, and the largest SHAKE output of one */
+#define PARALLELHASH_LANES          8
+#define PARALLELHASH_MAX_LEAF       64
+#define PARALLELHASH_DEFAULT_BLOCK  8192
+
+/*
+ * Convert an integer into bytes, with the number of bytes prepended.
+ *
+ * e.g if x = 8192, out[3] = { 0x02, 0x20, 0x00 }
+ */
+static int left_encode(unsigned char *out, int *out_len, size_t x)
+{
+    unsigned int len = get_encode_size(x);
+    int i;
+
+    out[0] = (unsigned char)len;
+    for (i = len; i > 0; --i) {
+        out[i] = (unsigned char)(x & 0xFF);
+        x >>= 8;
+    }
+    *out_len = len + 1;
+    return 1;
+}
+
+/*
+ * ParallelHash.  It has no key, and its blocks are SHAKE hashed in batches
+ * of PARALLELHASH_LANES, so update() holds up to that many back.
+ */
+static void *parallelhash_new(void *provctx, const OSSL_PARAM *params)
+{
+    struct kmac_data_st *kctx = kmac_fetch_new(provctx, params);
+
+    if (kctx != NULL)
+        kctx->block_size = PARALLELHASH_DEFAULT_BLOCK;
+    return kctx;
+}
+
+static void *parallelhash128_new(void *provctx)
+{
+    static const OSSL_PARAM parallelhash128_params[] = {
+        OSSL_PARAM_utf8_string("digest", OSSL_DIGEST_NAME_KECCAK_KMAC128,
+                               sizeof(OSSL_DIGEST_NAME_KECCAK_KMAC128)),
+        OSSL_PARAM_END
+    };
+    return parallelhash_new(provctx, parallelhash128_params);
+}
+
+static void *parallelhash256_new(void *provctx)
+{
+    static const OSSL_PARAM parallelhash256_params[] = {
+        OSSL_PARAM_utf8_string("digest", OSSL_DIGEST_NAME_KECCAK_KMAC256,
+                               sizeof(OSSL_DIGEST_NAME_KECCAK_KMAC256)),
+        OSSL_PARAM_END
+    };
+    return parallelhash_new(provctx, parallelhash256_params);
+}
+
+static void *parallelhash_dup(void *vsrc)
+{
+    struct kmac_data_st *src = vsrc;
+    struct kmac_data_st *dst = kmac_dup(src);
+
+    if (dst == NULL)
+        return NULL;
+
+    dst->block_size = src->block_size;
+    dst->blocks = src->blocks;
+    if (src->buf != NULL) {
+        if ((dst->buf = OPENSSL_memdup(src->buf, src->buf_len)) == NULL) {
+            kmac_free(dst);
+            return NULL;
+        }
+        dst->buf_len = src->buf_len;
+        dst->bufsz = src->bufsz;
+    }
+    return dst;
+}
+
+static int parallelhash_init(void *vmacctx)
+{
+    struct kmac_data_st *kctx = vmacctx;
+    EVP_MD_CTX *ctx = kctx->ctx;
+    unsigned char out[KMAC_MAX_BLOCKSIZE * 2];
+    unsigned char encoded_block_size[sizeof(size_t) + 1];
+    int out_len, len, block_len;
+    size_t buf_len = PARALLELHASH_LANES * kctx->block_size;
+
+    if (!EVP_DigestInit_ex(kctx->ctx, ossl_prov_digest_md(&kctx->digest),
+                           NULL))
+        return 0;
+
+    block_len = EVP_MD_block_size(ossl_prov_digest_md(&kctx->digest));
+
+    /* Set default custom string if it is not already set */
+    if (kctx->custom_len == 0) {
+        const OSSL_PARAM params[] = {
+            OSSL_PARAM_octet_string(OSSL_MAC_PARAM_CUSTOM, "", 0),
+            OSSL_PARAM_END
+        };
+        (void)kmac_set_ctx_params(kctx, params);
+    }
+
+    if (kctx->buf_len != buf_len) {
+        OPENSSL_clear_free(kctx->buf, kctx->buf_len);
+        kctx->buf_len = 0;
+        if ((kctx->buf = OPENSSL_malloc(buf_len)) == NULL) {
+            ERR_raise(ERR_LIB_PROV, ERR_R_MALLOC_FAILURE);
+            return 0;
+        }
+        kctx->buf_len = buf_len;
+    }
+    kctx->blocks = 0;
+    kctx->bufsz = 0;
+
+    return bytepad(out, &out_len, parallelhash_string,
+                   sizeof(parallelhash_string),
+                   kctx->custom, kctx->custom_len, block_len)
+           && left_encode(encoded_block_size, &len, kctx->block_size)
+           && EVP_DigestUpdate(ctx, out, out_len)
+           && EVP_DigestUpdate(ctx, encoded_block_size, len);
+}
+
+/* Feeds the SHAKE of |num| blocks of |len| bytes at |in| to the cSHAKE */
+static int parallelhash_blocks(struct kmac_data_st *kctx,
+                               const unsigned char *in, size_t num,
+                               size_t len)
+{
+    const EVP_MD *md = ossl_prov_digest_md(&kctx->digest);
+    unsigned char z[PARALLELHASH_LANES * PARALLELHASH_MAX_LEAF];
+    size_t z_len = EVP_MD_size(md), n;
+
+    while (num != 0) {
+        n = num < PARALLELHASH_LANES ? num : PARALLELHASH_LANES;
+        ossl_keccak1600_hash_many(z, z_len, in, len, n, EVP_MD_block_size(md),
+                                  0x1F, 24);
+        if (!EVP_DigestUpdate(kctx->ctx, z, n * z_len))
+            return 0;
+        kctx->blocks += n;
+        in += n * len;
+        num -= n;
+    }
+    return 1;
+}
+
+static int parallelhash_update(void *vmacctx, const unsigned char *data,
+                               size_t datalen)
+{
+    struct kmac_data_st *kctx = vmacctx;
+    size_t n;
+
+    if (kctx->bufsz != 0) {
+        n = kctx->buf_len - kctx->bufsz;
+        if (n > datalen)
+            n = datalen;
+        memcpy(kctx->buf + kctx->bufsz, data, n);
+        kctx->bufsz += n;
+        data += n;
+        datalen -= n;
+        if (kctx->bufsz < kctx->buf_len)
+            return 1;
+        if (!parallelhash_blocks(kctx, kctx->buf, PARALLELHASH_LANES,
+                                 kctx->block_size))
+            return 0;
+        kctx->bufsz = 0;
+    }
+
+    /* Whole batches of blocks are hashed where they are */
+    n = datalen / kctx->buf_len * PARALLELHASH_LANES;
+    if (!parallelhash_blocks(kctx, data, n, kctx->block_size))
+        return 0;
+    data += n * kctx->block_size;
+    datalen -= n * kctx->block_size;
+
+    memcpy(kctx->buf, data, datalen);
+    kctx->bufsz = datalen;
+    return 1;
+}
+
+static int parallelhash_final(void *vmacctx, unsigned char *out, size_t *outl,
+                              size_t outsize)
+{
+    struct kmac_data_st *kctx = vmacctx;
+    size_t full = kctx->bufsz / kctx->block_size;
+    size_t rem = kctx->bufsz % kctx->block_size;
+    unsigned char encoded_blocks[sizeof(size_t) + 1];
+    int len;
+
+    /* Only the last block can be short */
+    if (!parallelhash_blocks(kctx, kctx->buf, full, kctx->block_size)
+        || (rem != 0
+            && !parallelhash_blocks(kctx, kctx->buf + full * kctx->block_size,
+                                    1, rem))
+        || !right_encode(encoded_blocks, &len, kctx->blocks)
+        || !EVP_DigestUpdate(kctx->ctx, encoded_blocks, len))
+        return 0;
+    kctx->bufsz = 0;
+
+    return kmac_final(kctx, out, outl, outsize);
+}
+
+static const OSSL_PARAM known_parallelhash_settable_ctx_params[] = {
+    OSSL_PARAM_int(OSSL_MAC_PARAM_XOF, NULL),
+    OSSL_PARAM_size_t(OSSL_MAC_PARAM_SIZE, NULL),
+    OSSL_PARAM_octet_string(OSSL_MAC_PARAM_CUSTOM, NULL, 0),
+    OSSL_PARAM_size_t(OSSL_MAC_PARAM_BLOCK_SIZE, NULL),
+    OSSL_PARAM_END
+};
+static const OSSL_PARAM *parallelhash_settable_ctx_params(void)
+{
+    return known_parallelhash_settable_ctx_params;
+}
+
+/*
+ * As for KMAC, except that there is no key, and that the "blocksize" B
+ * should be set before init().
+ */
+static int parallelhash_set_ctx_params(void *vmacctx, const OSSL_PARAM *params)
+{
+    struct kmac_data_st *kctx = vmacctx;
+    const OSSL_PARAM *p;
+    size_t block_size;
+
+    if ((p = OSSL_PARAM_locate_const(params, OSSL_MAC_PARAM_BLOCK_SIZE))
+        != NULL) {
+        if (!OSSL_PARAM_get_size_t(p, &block_size))
+            return 0;
+        if (block_size == 0 || block_size > SIZE_MAX / PARALLELHASH_LANES) {
+            ERR_raise(ERR_LIB_PROV, PROV_R_BAD_LENGTH);
+            return 0;
+        }
+        kctx->block_size = block_size;
+    }
+    return kmac_set_ctx_params(kctx, params);
+}
+
+const OSSL_DISPATCH parallelhash128_functions[] = {
+    { OSSL_FUNC_MAC_NEWCTX, (void (*)(void))parallelhash128_new },
+    { OSSL_FUNC_MAC_DUPCTX, (void (*)(void))parallelhash_dup },
+    { OSSL_FUNC_MAC_FREECTX, (void (*)(void))kmac_free },
+    { OSSL_FUNC_MAC_INIT, (void (*)(void))parallelhash_init },
+    { OSSL_FUNC_MAC_UPDATE, (void (*)(void))parallelhash_update },
+    { OSSL_FUNC_MAC_FINAL, (void (*)(void))parallelhash_final },
+    { OSSL_FUNC_MAC_GETTABLE_CTX_PARAMS,
+      (void (*)(void))kmac_gettable_ctx_params },
+    { OSSL_FUNC_MAC_GET_CTX_PARAMS, (void (*)(void))kmac_get_ctx_params },
+    { OSSL_FUNC_MAC_SETTABLE_CTX_PARAMS,
+      (void (*)(void))parallelhash_settable_ctx_params },
+    { OSSL_FUNC_MAC_SET_CTX_PARAMS,
+      (void (*)(void))parallelhash_set_ctx_params },
+    { 0, NULL }
+};
+
+const OSSL_DISPATCH parallelhash256_functions[] = {
+    { OSSL_FUNC_MAC_NEWCTX, (void (*)(void))parallelhash256_new },
+    { OSSL_FUNC_MAC_DUPCTX, (void (*)(void))parallelhash_dup },
+    { OSSL_FUNC_MAC_FREECTX, (void (*)(void))kmac_free },
+    { OSSL_FUNC_MAC_INIT, (void (*)(void))parallelhash_init },
+    { OSSL_FUNC_MAC_UPDATE, (void (*)(void))parallelhash_update },
+    { OSSL_FUNC_MAC_FINAL, (void (*)(void))parallelhash_final },
+    { OSSL_FUNC_MAC_GETTABLE_CTX_PARAMS,
+      (void (*)(void))kmac_gettable_ctx_params },
+    { OSSL_FUNC_MAC_GET_CTX_PARAMS, (void (*)(void))kmac_get_ctx_params },
+    { OSSL_FUNC_MAC_SETTABLE_CTX_PARAMS,
+      (void (*)(void))parallelhash_settable_ctx_params },
+    { OSSL_FUNC_MAC_SET_CTX_PARAMS,
+      (void (*)(void))parallelhash_set_ctx_params },
+    { 0, NULL }
+};
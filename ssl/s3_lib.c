@@ -3210,13 +3210,29 @@ static int cipher_compare(const void *a, const void *b)
     return ap->id < bp->id ? -1 : 1;
 }
 
+/* Every cipher must have its own bit in an SSL_CIPHER_SET */
+typedef char ssl_cipher_set_check[TLS13_NUM_CIPHERS + SSL3_NUM_CIPHERS
+                                  + SSL3_NUM_SCSVS <= SSL_CIPHER_SET_BITS
+                                  ? 1 : -1];
+
 void ssl_sort_cipher_list(void)
 {
+    size_t i;
+    int n = 0;
+
     qsort(tls13_ciphers, TLS13_NUM_CIPHERS, sizeof(tls13_ciphers[0]),
           cipher_compare);
     qsort(ssl3_ciphers, SSL3_NUM_CIPHERS, sizeof(ssl3_ciphers[0]),
           cipher_compare);
     qsort(ssl3_scsvs, SSL3_NUM_SCSVS, sizeof(ssl3_scsvs[0]), cipher_compare);
+
+    /* Give every cipher its own bit in an SSL_CIPHER_SET */
+    for (i = 0; i < TLS13_NUM_CIPHERS; i++)
+        tls13_ciphers[i].set_index = n++;
+    for (i = 0; i < SSL3_NUM_CIPHERS; i++)
+        ssl3_ciphers[i].set_index = n++;
+    for (i = 0; i < SSL3_NUM_SCSVS; i++)
+        ssl3_scsvs[i].set_index = n++;
 }
 
 static int ssl_undefined_function_1(SSL *ssl, unsigned char *r, size_t s,
@@ -3498,7 +3514,7 @@ long ssl3_ctrl(SSL *s, int cmd, long larg, void *parg)
                 return 0;
             return tls1_set_groups(&s->ext.supportedgroups,
                                    &s->ext.supportedgroups_len,
-                                   &nid, 1);
+                                   &s->ext.supportedgroups_set, &nid, 1);
         }
         break;
 #endif                          /* !OPENSSL_NO_EC */
@@ -3652,11 +3668,13 @@ long ssl3_ctrl(SSL *s, int cmd, long larg, void *parg)
 
     case SSL_CTRL_SET_GROUPS:
         return tls1_set_groups(&s->ext.supportedgroups,
-                               &s->ext.supportedgroups_len, parg, larg);
+                               &s->ext.supportedgroups_len,
+                               &s->ext.supportedgroups_set, parg, larg);
 
     case SSL_CTRL_SET_GROUPS_LIST:
         return tls1_set_groups_list(&s->ext.supportedgroups,
-                                    &s->ext.supportedgroups_len, parg);
+                                    &s->ext.supportedgroups_len,
+                                    &s->ext.supportedgroups_set, parg);
 
     case SSL_CTRL_GET_SHARED_GROUP:
         {
@@ -3791,6 +3809,17 @@ long ssl3_callback_ctrl(SSL *s, int cmd, void (*fp) (void))
     return ret;
 }
 
+/*
+ * The ClientHello templates of |ctx| depend on its groups and signature
+ * algorithms, so forget them when either is changed successfully.
+ */
+static long ctx_client_hello_changed(SSL_CTX *ctx, long ret)
+{
+    if (ret > 0)
+        ssl_ctx_client_hello_changed(ctx);
+    return ret;
+}
+
 long ssl3_ctx_ctrl(SSL_CTX *ctx, int cmd, long larg, void *parg)
 {
     switch (cmd) {
@@ -3847,7 +3876,7 @@ long ssl3_ctx_ctrl(SSL_CTX *ctx, int cmd, long larg, void *parg)
                 return 0;
             return tls1_set_groups(&ctx->ext.supportedgroups,
                                    &ctx->ext.supportedgroups_len,
-                                   &nid, 1);
+                                   &ctx->ext.supportedgroups_set, &nid, 1);
         }
 #endif                          /* !OPENSSL_NO_EC */
     case SSL_CTRL_SET_TLSEXT_SERVERNAME_ARG:
@@ -3947,27 +3976,33 @@ long ssl3_ctx_ctrl(SSL_CTX *ctx, int cmd, long larg, void *parg)
 
 #if !defined(OPENSSL_NO_EC) || !defined(OPENSSL_NO_DH)
     case SSL_CTRL_SET_GROUPS:
-        return tls1_set_groups(&ctx->ext.supportedgroups,
-                               &ctx->ext.supportedgroups_len,
-                               parg, larg);
+        return ctx_client_hello_changed(ctx,
+                   tls1_set_groups(&ctx->ext.supportedgroups,
+                                   &ctx->ext.supportedgroups_len,
+                                   &ctx->ext.supportedgroups_set, parg, larg));
 
     case SSL_CTRL_SET_GROUPS_LIST:
-        return tls1_set_groups_list(&ctx->ext.supportedgroups,
-                                    &ctx->ext.supportedgroups_len,
-                                    parg);
+        return ctx_client_hello_changed(ctx,
+                   tls1_set_groups_list(&ctx->ext.supportedgroups,
+                                        &ctx->ext.supportedgroups_len,
+                                        &ctx->ext.supportedgroups_set, parg));
 #endif /* !defined(OPENSSL_NO_EC) || !defined(OPENSSL_NO_DH) */
 
     case SSL_CTRL_SET_SIGALGS:
-        return tls1_set_sigalgs(ctx->cert, parg, larg, 0);
+        return ctx_client_hello_changed(ctx,
+                   tls1_set_sigalgs(ctx->cert, parg, larg, 0));
 
     case SSL_CTRL_SET_SIGALGS_LIST:
-        return tls1_set_sigalgs_list(ctx->cert, parg, 0);
+        return ctx_client_hello_changed(ctx,
+                   tls1_set_sigalgs_list(ctx->cert, parg, 0));
 
     case SSL_CTRL_SET_CLIENT_SIGALGS:
-        return tls1_set_sigalgs(ctx->cert, parg, larg, 1);
+        return ctx_client_hello_changed(ctx,
+                   tls1_set_sigalgs(ctx->cert, parg, larg, 1));
 
     case SSL_CTRL_SET_CLIENT_SIGALGS_LIST:
-        return tls1_set_sigalgs_list(ctx->cert, parg, 1);
+        return ctx_client_hello_changed(ctx,
+                   tls1_set_sigalgs_list(ctx->cert, parg, 1));
 
     case SSL_CTRL_SET_CLIENT_CERT_TYPES:
         return ssl3_set_req_cert_type(ctx->cert, parg, larg);
@@ -4183,7 +4218,9 @@ const SSL_CIPHER *ssl3_choose_cipher(SSL *s, STACK_OF(SSL_CIPHER) *clnt,
 {
     const SSL_CIPHER *c, *ret = NULL;
     STACK_OF(SSL_CIPHER) *prio, *allow;
-    int i, ii, ok, prefer_sha256 = 0;
+    SSL_CIPHER_SET allow_tmp;
+    const SSL_CIPHER_SET *allow_set;
+    int i, ok, prefer_sha256 = 0;
     unsigned long alg_k = 0, alg_a = 0, mask_k = 0, mask_a = 0;
 #ifndef OPENSSL_NO_CHACHA
     STACK_OF(SSL_CIPHER) *prio_chacha = NULL;
@@ -4191,13 +4228,6 @@ const SSL_CIPHER *ssl3_choose_cipher(SSL *s, STACK_OF(SSL_CIPHER) *clnt,
 
     /* Let's see which ciphers we can support */
 
-    /*
-     * Do not set the compare functions, because this may lead to a
-     * reordering by "id". We want to keep the original ordering. We may pay
-     * a price in performance during sk_SSL_CIPHER_find(), but would have to
-     * pay with the price of sk_SSL_CIPHER_dup().
-     */
-
     OSSL_TRACE_BEGIN(TLS_CIPHER) {
         BIO_printf(trc_out, "Server has %d from %p:\n",
                    sk_SSL_CIPHER_num(srvr), (void *)srvr);
@@ -4265,6 +4295,20 @@ const SSL_CIPHER *ssl3_choose_cipher(SSL *s, STACK_OF(SSL_CIPHER) *clnt,
         allow = srvr;
     }
 
+    /*
+     * Turn the allowed list into a bitmap so that each check below is a single
+     * bit test rather than a search. Our own list is kept as one by the SSL or
+     * the SSL_CTX it comes from, so only the peer's list is converted here.
+     */
+    if (allow == s->cipher_list) {
+        allow_set = &s->cipher_set;
+    } else if (allow == s->ctx->cipher_list) {
+        allow_set = &s->ctx->cipher_set;
+    } else {
+        ssl_cipher_set_from_list(&allow_tmp, allow);
+        allow_set = &allow_tmp;
+    }
+
     if (SSL_IS_TLS13(s)) {
 #ifndef OPENSSL_NO_PSK
         int j;
@@ -4341,8 +4385,7 @@ const SSL_CIPHER *ssl3_choose_cipher(SSL *s, STACK_OF(SSL_CIPHER) *clnt,
             if (!ok)
                 continue;
         }
-        ii = sk_SSL_CIPHER_find(allow, c);
-        if (ii >= 0) {
+        if (ssl_cipher_set_has(allow_set, c)) {
             /* Check security callback permits this cipher */
             if (!ssl_security(s, SSL_SECOP_CIPHER_SHARED,
                               c->strength_bits, 0, (void *)c))
@@ -4351,27 +4394,25 @@ const SSL_CIPHER *ssl3_choose_cipher(SSL *s, STACK_OF(SSL_CIPHER) *clnt,
             if ((alg_k & SSL_kECDHE) && (alg_a & SSL_aECDSA)
                 && s->s3.is_probably_safari) {
                 if (!ret)
-                    ret = sk_SSL_CIPHER_value(allow, ii);
+                    ret = c;
                 continue;
             }
 #endif
             if (prefer_sha256) {
-                const SSL_CIPHER *tmp = sk_SSL_CIPHER_value(allow, ii);
-
                 /*
                  * TODO: When there are no more legacy digests we can just use
                  * OSSL_DIGEST_NAME_SHA2_256 instead of calling OBJ_nid2sn
                  */
-                if (EVP_MD_is_a(ssl_md(s->ctx, tmp->algorithm2),
+                if (EVP_MD_is_a(ssl_md(s->ctx, c->algorithm2),
                                        OBJ_nid2sn(NID_sha256))) {
-                    ret = tmp;
+                    ret = c;
                     break;
                 }
                 if (ret == NULL)
-                    ret = tmp;
+                    ret = c;
                 continue;
             }
-            ret = sk_SSL_CIPHER_value(allow, ii);
+            ret = c;
             break;
         }
     }
@@ -4744,9 +4785,13 @@ EVP_PKEY *ssl_generate_pkey(SSL *s, EVP_PKEY *pm)
     return pkey;
 }
 
-/* Generate a private key from a group ID */
+/*
+ * Generate a private key from a group ID. This doesn't depend on any particular
+ * connection so that it can also be used to fill the key share pool. On error
+ * the reason code is left in |*reason|.
+ */
 #if !defined(OPENSSL_NO_DH) || !defined(OPENSSL_NO_EC)
-EVP_PKEY *ssl_generate_pkey_group(SSL *s, uint16_t id)
+static EVP_PKEY *generate_pkey_group(SSL_CTX *ctx, uint16_t id, int *reason)
 {
     const TLS_GROUP_INFO *ginf = tls1_group_id_lookup(id);
     EVP_PKEY_CTX *pctx = NULL;
@@ -4757,8 +4802,7 @@ EVP_PKEY *ssl_generate_pkey_group(SSL *s, uint16_t id)
 # endif
 
     if (ginf == NULL) {
-        SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_GENERATE_PKEY_GROUP,
-                 ERR_R_INTERNAL_ERROR);
+        *reason = ERR_R_INTERNAL_ERROR;
         goto err;
     }
     gtype = ginf->flags & TLS_GROUP_TYPE;
@@ -4783,13 +4827,11 @@ EVP_PKEY *ssl_generate_pkey_group(SSL *s, uint16_t id)
     }
 # endif
     if (pctx == NULL) {
-        SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_GENERATE_PKEY_GROUP,
-                 ERR_R_MALLOC_FAILURE);
+        *reason = ERR_R_MALLOC_FAILURE;
         goto err;
     }
     if (EVP_PKEY_keygen_init(pctx) <= 0) {
-        SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_GENERATE_PKEY_GROUP,
-                 ERR_R_EVP_LIB);
+        *reason = ERR_R_EVP_LIB;
         goto err;
     }
 # ifndef OPENSSL_NO_DH
@@ -4797,16 +4839,14 @@ EVP_PKEY *ssl_generate_pkey_group(SSL *s, uint16_t id)
         if ((pkey = EVP_PKEY_new()) == NULL
                 || (dh = DH_new_by_nid(ginf->nid)) == NULL
                 || !EVP_PKEY_assign(pkey, EVP_PKEY_DH, dh)) {
-            SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_GENERATE_PKEY_GROUP,
-                     ERR_R_EVP_LIB);
+            *reason = ERR_R_EVP_LIB;
             DH_free(dh);
             EVP_PKEY_free(pkey);
             pkey = NULL;
             goto err;
         }
         if (EVP_PKEY_CTX_set_dh_nid(pctx, ginf->nid) <= 0) {
-            SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_GENERATE_PKEY_GROUP,
-                     ERR_R_EVP_LIB);
+            *reason = ERR_R_EVP_LIB;
             EVP_PKEY_free(pkey);
             pkey = NULL;
             goto err;
@@ -4820,15 +4860,13 @@ EVP_PKEY *ssl_generate_pkey_group(SSL *s, uint16_t id)
     {
         if (gtype != TLS_GROUP_CURVE_CUSTOM
                 && EVP_PKEY_CTX_set_ec_paramgen_curve_nid(pctx, ginf->nid) <= 0) {
-            SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_GENERATE_PKEY_GROUP,
-                     ERR_R_EVP_LIB);
+            *reason = ERR_R_EVP_LIB;
             goto err;
         }
     }
 # endif
     if (EVP_PKEY_keygen(pctx, &pkey) <= 0) {
-        SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_GENERATE_PKEY_GROUP,
-                 ERR_R_EVP_LIB);
+        *reason = ERR_R_EVP_LIB;
         EVP_PKEY_free(pkey);
         pkey = NULL;
     }
@@ -4837,6 +4875,32 @@ EVP_PKEY *ssl_generate_pkey_group(SSL *s, uint16_t id)
     EVP_PKEY_CTX_free(pctx);
     return pkey;
 }
+
+EVP_PKEY *ssl_ctx_generate_pkey_group(SSL_CTX *ctx, uint16_t id)
+{
+    EVP_PKEY *pkey;
+    int reason;
+
+    if ((pkey = generate_pkey_group(ctx, id, &reason)) == NULL)
+        SSLerr(SSL_F_SSL_CTX_GENERATE_PKEY_GROUP, reason);
+
+    return pkey;
+}
+
+/* Generate a private key from a group ID, or take one from the pool */
+EVP_PKEY *ssl_generate_pkey_group(SSL *s, uint16_t id)
+{
+    EVP_PKEY *pkey;
+    int reason;
+
+    if ((pkey = ssl_key_share_pool_get(s->ctx, id)) != NULL)
+        return pkey;
+    if ((pkey = generate_pkey_group(s->ctx, id, &reason)) == NULL)
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_GENERATE_PKEY_GROUP,
+                 reason);
+
+    return pkey;
+}
 #endif
 
 /*
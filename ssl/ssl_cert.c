@@ -62,6 +62,7 @@ CERT *ssl_cert_new(void)
     ret->sec_cb = ssl_security_default_callback;
     ret->sec_level = OPENSSL_TLS_SECURITY_LEVEL;
     ret->sec_ex = NULL;
+    ret->conf_sigalgs_set = tls12_default_sigalg_set();
     ret->lock = CRYPTO_THREAD_lock_new();
     if (ret->lock == NULL) {
         SSLerr(SSL_F_SSL_CERT_NEW, ERR_R_MALLOC_FAILURE);
@@ -72,6 +73,104 @@ CERT *ssl_cert_new(void)
     return ret;
 }
 
+SSL_CERT_CACHE *ssl_cert_cache_new(void)
+{
+    SSL_CERT_CACHE *ret = OPENSSL_zalloc(sizeof(*ret));
+
+    if (ret == NULL) {
+        SSLerr(0, ERR_R_MALLOC_FAILURE);
+        return NULL;
+    }
+
+    ret->references = 1;
+    ret->lock = CRYPTO_THREAD_lock_new();
+    if (ret->lock == NULL) {
+        SSLerr(0, ERR_R_MALLOC_FAILURE);
+        OPENSSL_free(ret);
+        return NULL;
+    }
+
+    return ret;
+}
+
+int ssl_cert_cache_up_ref(SSL_CERT_CACHE *cache)
+{
+    int i;
+
+    if (CRYPTO_UP_REF(&cache->references, &i, cache->lock) <= 0)
+        return 0;
+
+    REF_PRINT_COUNT("SSL_CERT_CACHE", cache);
+    REF_ASSERT_ISNT(i < 2);
+    return i > 1 ? 1 : 0;
+}
+
+void ssl_cert_cache_free(SSL_CERT_CACHE *cache)
+{
+    int i;
+
+    if (cache == NULL)
+        return;
+    CRYPTO_DOWN_REF(&cache->references, &i, cache->lock);
+    REF_PRINT_COUNT("SSL_CERT_CACHE", cache);
+    if (i > 0)
+        return;
+    REF_ASSERT_ISNT(i < 0);
+
+    OPENSSL_free(cache->chain);
+    for (i = 0; i < TLSEXT_comp_cert_limit; i++)
+        OPENSSL_free(cache->comp[i].data);
+    CRYPTO_THREAD_lock_free(cache->lock);
+    OPENSSL_free(cache);
+}
+
+/*
+ * Returns the value of |*flag|, a field of |cache| which only ever gains bits
+ * and is only updated with ssl_cert_cache_set_flag(). Where the compiler
+ * allows this doesn't take the cache lock. Anything stored in |cache| before
+ * the bits were set is visible to the caller once it sees them.
+ */
+int ssl_cert_cache_get_flag(SSL_CERT_CACHE *cache, TSAN_QUALIFIER int *flag)
+{
+#ifdef tsan_ld_acq
+    return tsan_ld_acq(flag);
+#else
+    int ret;
+
+    if (!CRYPTO_THREAD_read_lock(cache->lock))
+        return 0;
+    ret = *flag;
+    CRYPTO_THREAD_unlock(cache->lock);
+    return ret;
+#endif
+}
+
+/* Add |bits| to |*flag|. The cache lock must be held for writing. */
+void ssl_cert_cache_set_flag(TSAN_QUALIFIER int *flag, int bits)
+{
+#ifdef tsan_st_rel
+    tsan_st_rel(flag, *flag | bits);
+#else
+    *flag |= bits;
+#endif
+}
+
+/*
+ * Give |cpk| a new, empty, cache. This must be called whenever the certificate
+ * or chain of |cpk| changes. Copies of the CERT that were made earlier keep
+ * using the old cache.
+ */
+int ssl_cert_pkey_reset_cache(CERT_PKEY *cpk)
+{
+    SSL_CERT_CACHE *cache = ssl_cert_cache_new();
+
+    if (cache == NULL)
+        return 0;
+    ssl_cert_cache_free(cpk->cache);
+    cpk->cache = cache;
+    return 1;
+}
+
 CERT *ssl_cert_dup(CERT *cert)
 {
     CERT *ret = OPENSSL_zalloc(sizeof(*ret));
@@ -131,6 +230,11 @@ CERT *ssl_cert_dup(CERT *cert)
             memcpy(ret->pkeys[i].serverinfo,
                    cert->pkeys[i].serverinfo, cert->pkeys[i].serverinfo_length);
         }
+        if (cpk->cache != NULL) {
+            if (!ssl_cert_cache_up_ref(cpk->cache))
+                goto err;
+            rpk->cache = cpk->cache;
+        }
     }
 
     /* Configured sigalgs copied across */
@@ -144,6 +248,7 @@ CERT *ssl_cert_dup(CERT *cert)
         ret->conf_sigalgslen = cert->conf_sigalgslen;
     } else
         ret->conf_sigalgs = NULL;
+    ret->conf_sigalgs_set = cert->conf_sigalgs_set;
 
     if (cert->client_sigalgs) {
         ret->client_sigalgs = OPENSSL_malloc(cert->client_sigalgslen
@@ -155,6 +260,7 @@ CERT *ssl_cert_dup(CERT *cert)
         ret->client_sigalgslen = cert->client_sigalgslen;
     } else
         ret->client_sigalgs = NULL;
+    ret->client_sigalgs_set = cert->client_sigalgs_set;
     /* Copy any custom client certificate types */
     if (cert->ctype) {
         ret->ctype = OPENSSL_memdup(cert->ctype, cert->ctype_len);
@@ -217,6 +323,8 @@ void ssl_cert_clear_certs(CERT *c)
         OPENSSL_free(cpk->serverinfo);
         cpk->serverinfo = NULL;
         cpk->serverinfo_length = 0;
+        ssl_cert_cache_free(cpk->cache);
+        cpk->cache = NULL;
     }
 }
 
@@ -272,6 +380,8 @@ int ssl_cert_set0_chain(SSL *s, SSL_CTX *ctx, STACK_OF(X509) *chain)
             return 0;
         }
     }
+    if (!ssl_cert_pkey_reset_cache(cpk))
+        return 0;
     sk_X509_pop_free(cpk->chain, X509_free);
     cpk->chain = chain;
     return 1;
@@ -303,6 +413,8 @@ int ssl_cert_add0_chain_cert(SSL *s, SSL_CTX *ctx, X509 *x)
         SSLerr(SSL_F_SSL_CERT_ADD0_CHAIN_CERT, r);
         return 0;
     }
+    if (!ssl_cert_pkey_reset_cache(cpk))
+        return 0;
     if (!cpk->chain)
         cpk->chain = sk_X509_new_null();
     if (!cpk->chain || !sk_X509_push(cpk->chain, x))
@@ -926,6 +1038,11 @@ int ssl_build_cert_chain(SSL *s, SSL_CTX *ctx, int flags)
             goto err;
         }
     }
+    if (!ssl_cert_pkey_reset_cache(cpk)) {
+        sk_X509_pop_free(chain, X509_free);
+        rv = 0;
+        goto err;
+    }
     sk_X509_pop_free(cpk->chain, X509_free);
     cpk->chain = chain;
     if (rv == 0)
@@ -1035,6 +1152,15 @@ static int ssl_security_default_callback(const SSL *s, const SSL_CTX *ctx,
     return 1;
 }
 
+/*
+ * Returns 1 if |c| uses the built in security callback, whose decisions only
+ * depend on the security level.
+ */
+int ssl_cert_default_security(const CERT *c)
+{
+    return c->sec_cb == ssl_security_default_callback;
+}
+
 int ssl_security(const SSL *s, int op, int bits, int nid, void *other)
 {
     return s->cert->sec_cb(s, NULL, op, bits, nid, other, s->cert->sec_ex);
@@ -0,0 +1,310 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * TLS certificate compression (RFC 8879)
+ */
+
+#include <limits.h>
+#include <string.h>
+#include <openssl/objects.h>
+#include <openssl/comp.h>
+#include "internal/nelem.h"
+#include "ssl_local.h"
+
+#ifndef OPENSSL_NO_COMP
+static COMP_METHOD *cert_comp_method(int alg)
+{
+    switch (alg) {
+    case TLSEXT_comp_cert_zlib:
+        return COMP_zlib_oneshot();
+    case TLSEXT_comp_cert_brotli:
+        return COMP_brotli_oneshot();
+    default:
+        return NULL;
+    }
+}
+#endif
+
+/*
+ * Returns 1 if the certificate compression algorithm |alg| (one of the
+ * TLSEXT_comp_cert_* values) has callbacks in |ctx| or is supported by this
+ * build, or 0 otherwise.
+ */
+int ssl_cert_comp_alg_available(const SSL_CTX *ctx, int alg)
+{
+#ifndef OPENSSL_NO_COMP
+    COMP_METHOD *meth;
+#endif
+
+    if (alg <= TLSEXT_comp_cert_none || alg >= TLSEXT_comp_cert_limit)
+        return 0;
+    if (ctx->cert_comp_cbs[alg].compress != NULL)
+        return 1;
+#ifndef OPENSSL_NO_COMP
+    meth = cert_comp_method(alg);
+
+    return meth != NULL && COMP_get_type(meth) != NID_undef;
+#else
+    return 0;
+#endif
+}
+
+/* Returns 1 if |alg| is one of the certificate compression algorithms of |s| */
+int ssl_cert_comp_alg_enabled(const SSL *s, int alg)
+{
+    size_t i;
+
+    if (alg == TLSEXT_comp_cert_none)
+        return 0;
+    for (i = 0; i < OSSL_NELEM(s->cert_comp_prefs); i++)
+        if (s->cert_comp_prefs[i] == alg)
+            return 1;
+    return 0;
+}
+
+static int set_cert_comp_prefs(const SSL_CTX *ctx, int *prefs, int *algs,
+                               size_t len)
+{
+    int tmp[TLSEXT_comp_cert_limit];
+    size_t i, j, n = 0;
+
+    if (len >= TLSEXT_comp_cert_limit) {
+        SSLerr(0, ERR_R_PASSED_INVALID_ARGUMENT);
+        return 0;
+    }
+    for (i = 0; i < len; i++) {
+        if (algs[i] <= TLSEXT_comp_cert_none
+                || algs[i] >= TLSEXT_comp_cert_limit) {
+            SSLerr(0, SSL_R_UNSUPPORTED_COMPRESSION_ALGORITHM);
+            return 0;
+        }
+        for (j = 0; j < i; j++) {
+            if (algs[j] == algs[i]) {
+                SSLerr(0, ERR_R_PASSED_INVALID_ARGUMENT);
+                return 0;
+            }
+        }
+        /* Silently skip anything this build can't do */
+        if (ssl_cert_comp_alg_available(ctx, algs[i]))
+            tmp[n++] = algs[i];
+    }
+    while (n < OSSL_NELEM(tmp))
+        tmp[n++] = TLSEXT_comp_cert_none;
+
+    memcpy(prefs, tmp, sizeof(tmp));
+    return 1;
+}
+
+int SSL_CTX_set1_cert_comp_preference(SSL_CTX *ctx, int *algs, size_t len)
+{
+    return set_cert_comp_prefs(ctx, ctx->cert_comp_prefs, algs, len);
+}
+
+int SSL_set1_cert_comp_preference(SSL *ssl, int *algs, size_t len)
+{
+    return set_cert_comp_prefs(ssl->ctx, ssl->cert_comp_prefs, algs, len);
+}
+
+int SSL_CTX_set_cert_comp_callbacks(SSL_CTX *ctx, int alg,
+                                    SSL_cert_comp_cb_fn compress,
+                                    SSL_cert_comp_cb_fn expand, void *arg)
+{
+    if (alg <= TLSEXT_comp_cert_none || alg >= TLSEXT_comp_cert_limit) {
+        SSLerr(0, SSL_R_UNSUPPORTED_COMPRESSION_ALGORITHM);
+        return 0;
+    }
+    if ((compress == NULL) != (expand == NULL)) {
+        SSLerr(0, ERR_R_PASSED_NULL_PARAMETER);
+        return 0;
+    }
+    ctx->cert_comp_cbs[alg].compress = compress;
+    ctx->cert_comp_cbs[alg].expand = expand;
+    ctx->cert_comp_cbs[alg].arg = arg;
+    return 1;
+}
+
+int SSL_get_negotiated_server_cert_comp_alg(const SSL *s)
+{
+    return s->ext.server_cert_comp_alg;
+}
+
+/*
+ * Compress |inlen| bytes at |in| with |alg| into the |outlen| bytes at |out|,
+ * or expand them if |expand| is set. Returns the number of bytes written, or
+ * 0 or less on error.
+ */
+static int cert_comp_transform(SSL *s, int alg, int expand,
+                               unsigned char *out, size_t outlen,
+                               const unsigned char *in, size_t inlen)
+{
+    SSL_cert_comp_cb_fn cb = expand ? s->ctx->cert_comp_cbs[alg].expand
+                                    : s->ctx->cert_comp_cbs[alg].compress;
+#ifndef OPENSSL_NO_COMP
+    COMP_CTX *cctx;
+    int ret;
+#endif
+
+    if (cb != NULL)
+        return cb(s, out, outlen, in, inlen, s->ctx->cert_comp_cbs[alg].arg);
+#ifndef OPENSSL_NO_COMP
+    if ((cctx = COMP_CTX_new(cert_comp_method(alg))) == NULL)
+        return 0;
+    ret = expand
+        ? COMP_expand_block(cctx, out, (int)outlen, (unsigned char *)in,
+                            (int)inlen)
+        : COMP_compress_block(cctx, out, (int)outlen, (unsigned char *)in,
+                              (int)inlen);
+    COMP_CTX_free(cctx);
+    return ret;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Compress |inlen| bytes at |in| with |alg|. On success the result is
+ * returned in a newly allocated buffer |*out| of |*outlen| bytes.
+ */
+static int cert_comp_compress(SSL *s, int alg, const unsigned char *in,
+                              size_t inlen, unsigned char **out,
+                              size_t *outlen)
+{
+    unsigned char *buf;
+    /* Comfortably above the worst case expansion of all supported methods */
+    size_t buflen = inlen + (inlen >> 3) + 64;
+    int ret;
+
+    if (!ssl_cert_comp_alg_available(s->ctx, alg) || inlen > INT_MAX / 2)
+        return 0;
+    if ((buf = OPENSSL_malloc(buflen)) == NULL)
+        return 0;
+
+    ret = cert_comp_transform(s, alg, 0, buf, buflen, in, inlen);
+    if (ret <= 0 || (size_t)ret > buflen) {
+        OPENSSL_free(buf);
+        return 0;
+    }
+
+    *out = buf;
+    *outlen = (size_t)ret;
+    return 1;
+}
+
+/*
+ * Write the cached CompressedCertificate message body for |cpk| compressed
+ * with |alg| to |pkt|. Must only be called if ssl_cert_chain_is_static() is
+ * true for |cpk|. Returns 1 if it was written, 0 if there is nothing cached
+ * yet, or -1 on error.
+ */
+int ssl_add_cached_compressed_certificate(SSL *s, CERT_PKEY *cpk, int alg,
+                                          WPACKET *pkt)
+{
+    SSL_CERT_CACHE *cache = cpk->cache;
+
+    if (!ssl_cert_cache_get_flag(cache, &cache->comp[alg].cached))
+        return 0;
+
+    /* The entry never changes once |cached| is set */
+    if (!WPACKET_put_bytes_u16(pkt, alg)
+            || !WPACKET_put_bytes_u24(pkt, cache->comp[alg].orig_len)
+            || !WPACKET_sub_memcpy_u24(pkt, cache->comp[alg].data,
+                                       cache->comp[alg].len)) {
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR,
+                 SSL_F_SSL_ADD_CACHED_COMPRESSED_CERTIFICATE,
+                 ERR_R_INTERNAL_ERROR);
+        return -1;
+    }
+    return 1;
+}
+
+/*
+ * Write the body of a CompressedCertificate message to |pkt|, given the body
+ * |in| of the Certificate message that it replaces. If |cpk| is not NULL the
+ * Certificate message is fully determined by it, and the compressed form is
+ * kept in its cache for ssl_add_cached_compressed_certificate() to use.
+ */
+int ssl_compress_certificate(SSL *s, CERT_PKEY *cpk, int alg,
+                             const unsigned char *in, size_t inlen,
+                             WPACKET *pkt)
+{
+    SSL_CERT_CACHE *cache = cpk != NULL ? cpk->cache : NULL;
+    unsigned char *out = NULL;
+    size_t outlen;
+
+    if (!WPACKET_put_bytes_u16(pkt, alg)
+            || !WPACKET_put_bytes_u24(pkt, inlen)) {
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_COMPRESS_CERTIFICATE,
+                 ERR_R_INTERNAL_ERROR);
+        return 0;
+    }
+    if (!cert_comp_compress(s, alg, in, inlen, &out, &outlen)) {
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_COMPRESS_CERTIFICATE,
+                 SSL_R_COMPRESSION_FAILURE);
+        return 0;
+    }
+    if (!WPACKET_sub_memcpy_u24(pkt, out, outlen)) {
+        OPENSSL_free(out);
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_COMPRESS_CERTIFICATE,
+                 ERR_R_INTERNAL_ERROR);
+        return 0;
+    }
+
+    /*
+     * Failing to update the cache isn't fatal, we'll just try next time. If
+     * another thread got here first we keep theirs.
+     */
+    if (cache != NULL && CRYPTO_THREAD_write_lock(cache->lock)) {
+        if (!cache->comp[alg].cached) {
+            cache->comp[alg].data = out;
+            cache->comp[alg].len = outlen;
+            cache->comp[alg].orig_len = inlen;
+            ssl_cert_cache_set_flag(&cache->comp[alg].cached, 1);
+            out = NULL;
+        }
+        CRYPTO_THREAD_unlock(cache->lock);
+    }
+    OPENSSL_free(out);
+
+    return 1;
+}
+
+/*
+ * Decompress the |inlen| bytes at |in| of a CompressedCertificate message
+ * with |alg|. The result must be exactly |outlen| bytes long and is returned
+ * in a newly allocated buffer |*out|.
+ */
+int ssl_expand_certificate(SSL *s, int alg, const unsigned char *in,
+                           size_t inlen, unsigned char **out, size_t outlen)
+{
+    unsigned char *buf;
+    int ret;
+
+    if (inlen > INT_MAX || outlen > INT_MAX) {
+        SSLfatal(s, SSL_AD_BAD_CERTIFICATE, SSL_F_SSL_EXPAND_CERTIFICATE,
+                 SSL_R_BAD_DECOMPRESSION);
+        return 0;
+    }
+    if ((buf = OPENSSL_malloc(outlen)) == NULL) {
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_EXPAND_CERTIFICATE,
+                 ERR_R_MALLOC_FAILURE);
+        return 0;
+    }
+
+    ret = cert_comp_transform(s, alg, 1, buf, outlen, in, inlen);
+    if (ret <= 0 || (size_t)ret != outlen) {
+        OPENSSL_free(buf);
+        SSLfatal(s, SSL_AD_BAD_CERTIFICATE, SSL_F_SSL_EXPAND_CERTIFICATE,
+                 SSL_R_BAD_DECOMPRESSION);
+        return 0;
+    }
+
+    *out = buf;
+    return 1;
+}
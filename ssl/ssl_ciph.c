@@ -316,6 +316,20 @@ static uint32_t disabled_mac_mask;
 static uint32_t disabled_mkey_mask;
 static uint32_t disabled_auth_mask;
 
+/* Set |set| to the ciphers in |sk| */
+void ssl_cipher_set_from_list(SSL_CIPHER_SET *set,
+                              const STACK_OF(SSL_CIPHER) *sk)
+{
+    const SSL_CIPHER *c;
+    int i;
+
+    memset(set, 0, sizeof(*set));
+    for (i = 0; i < sk_SSL_CIPHER_num(sk); i++) {
+        c = sk_SSL_CIPHER_value(sk, i);
+        set->bits[c->set_index / 64] |= (uint64_t)1 << (c->set_index % 64);
+    }
+}
+
 int ssl_load_ciphers(SSL_CTX *ctx)
 {
     size_t i;
@@ -325,7 +339,8 @@ int ssl_load_ciphers(SSL_CTX *ctx)
     for (i = 0, t = ssl_cipher_table_cipher; i < SSL_ENC_NUM_IDX; i++, t++) {
         if (t->nid != NID_undef) {
             const EVP_CIPHER *cipher
-                = ssl_evp_cipher_fetch(ctx->libctx, t->nid, ctx->propq);
+                = ssl_evp_cipher_fetch(ctx->libctx, t->nid,
+                                       ctx->propq_query);
 
             ctx->ssl_cipher_methods[i] = cipher;
             if (cipher == NULL)
@@ -335,7 +350,7 @@ int ssl_load_ciphers(SSL_CTX *ctx)
     disabled_mac_mask = 0;
     for (i = 0, t = ssl_cipher_table_mac; i < SSL_MD_NUM_IDX; i++, t++) {
         const EVP_MD *md
-            = ssl_evp_md_fetch(ctx->libctx, t->nid, ctx->propq);
+            = ssl_evp_md_fetch(ctx->libctx, t->nid, ctx->propq_query);
 
         ctx->ssl_digest_methods[i] = md;
         if (md == NULL) {
@@ -450,10 +465,11 @@ int ssl_cipher_get_evp_cipher(SSL_CTX *ctx, const SSL_CIPHER *sslc,
         if (i == SSL_ENC_NULL_IDX) {
             /*
              * We assume we don't care about this coming from an ENGINE so
-             * just do a normal EVP_CIPHER_fetch instead of
+             * just do a normal EVP_CIPHER_fetch_query() instead of
              * ssl_evp_cipher_fetch()
              */
-            *enc = EVP_CIPHER_fetch(ctx->libctx, "NULL", ctx->propq);
+            *enc = EVP_CIPHER_fetch_query(ctx->libctx, "NULL",
+                                          ctx->propq_query);
             if (*enc == NULL)
                 return 0;
         } else {
@@ -540,27 +556,27 @@ int ssl_cipher_get_evp(SSL_CTX *ctx, const SSL_SESSION *s,
         if (c->algorithm_enc == SSL_RC4
                 && c->algorithm_mac == SSL_MD5)
             evp = ssl_evp_cipher_fetch(ctx->libctx, NID_rc4_hmac_md5,
-                                       ctx->propq);
+                                       ctx->propq_query);
         else if (c->algorithm_enc == SSL_AES128
                     && c->algorithm_mac == SSL_SHA1)
             evp = ssl_evp_cipher_fetch(ctx->libctx,
                                        NID_aes_128_cbc_hmac_sha1,
-                                       ctx->propq);
+                                       ctx->propq_query);
         else if (c->algorithm_enc == SSL_AES256
                     && c->algorithm_mac == SSL_SHA1)
              evp = ssl_evp_cipher_fetch(ctx->libctx,
                                         NID_aes_256_cbc_hmac_sha1,
-                                        ctx->propq);
+                                        ctx->propq_query);
         else if (c->algorithm_enc == SSL_AES128
                     && c->algorithm_mac == SSL_SHA256)
             evp = ssl_evp_cipher_fetch(ctx->libctx,
                                        NID_aes_128_cbc_hmac_sha256,
-                                       ctx->propq);
+                                       ctx->propq_query);
         else if (c->algorithm_enc == SSL_AES256
                     && c->algorithm_mac == SSL_SHA256)
             evp = ssl_evp_cipher_fetch(ctx->libctx,
                                        NID_aes_256_cbc_hmac_sha256,
-                                       ctx->propq);
+                                       ctx->propq_query);
 
         if (evp != NULL) {
             ssl_evp_cipher_free(*enc);
@@ -1370,9 +1386,11 @@ int SSL_CTX_set_ciphersuites(SSL_CTX *ctx, const char *str)
 {
     int ret = set_ciphersuites(&(ctx->tls13_ciphersuites), str);
 
-    if (ret && ctx->cipher_list != NULL)
-        return update_cipher_list(&ctx->cipher_list, &ctx->cipher_list_by_id,
-                                  ctx->tls13_ciphersuites);
+    if (ret && ctx->cipher_list != NULL) {
+        ret = update_cipher_list(&ctx->cipher_list, &ctx->cipher_list_by_id,
+                                 ctx->tls13_ciphersuites);
+        ssl_ctx_cipher_list_changed(ctx);
+    }
 
     return ret;
 }
@@ -1386,9 +1404,11 @@ int SSL_set_ciphersuites(SSL *s, const char *str)
         if ((cipher_list = SSL_get_ciphers(s)) != NULL)
             s->cipher_list = sk_SSL_CIPHER_dup(cipher_list);
     }
-    if (ret && s->cipher_list != NULL)
-        return update_cipher_list(&s->cipher_list, &s->cipher_list_by_id,
-                                  s->tls13_ciphersuites);
+    if (ret && s->cipher_list != NULL) {
+        ret = update_cipher_list(&s->cipher_list, &s->cipher_list_by_id,
+                                 s->tls13_ciphersuites);
+        ssl_cipher_set_from_list(&s->cipher_set, s->cipher_list);
+    }
 
     return ret;
 }
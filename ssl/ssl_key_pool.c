@@ -0,0 +1,224 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * A pool of pregenerated ephemeral keys for (EC)DHE key exchange.
+ *
+ * Handshakes take keys out of the pool instead of generating them, which moves
+ * key generation off the handshake's critical path. The pool is refilled by
+ * the application calling SSL_CTX_fill_key_share_pool(), typically from a
+ * thread of its own. Keys are only ever handed out once.
+ */
+
+#include <limits.h>
+#include "ssl_local.h"
+
+/*
+ * The slots of the pools are only touched with the SSL_CTX lock held, which
+ * is only ever held briefly: keys are generated without it. The group and
+ * the number of keys of a pool can also be read without the lock where we
+ * have atomics, so that SSL_CTX_fill_key_share_pool() can see which pools
+ * need keys without waiting for handshakes.
+ */
+
+/* The group of |pool|, which is set at most once with |ctx->lock| held */
+static uint16_t pool_group(SSL_CTX *ctx, SSL_KEY_SHARE_POOL *pool)
+{
+#ifdef tsan_ld_acq
+    return tsan_ld_acq(&pool->group_id);
+#else
+    uint16_t id;
+
+    if (!CRYPTO_THREAD_read_lock(ctx->lock))
+        return 0;
+    id = pool->group_id;
+    CRYPTO_THREAD_unlock(ctx->lock);
+    return id;
+#endif
+}
+
+/* Empty the pool slot |slot| and return the key that was in it, if any */
+static EVP_PKEY *slot_take(SSL_KEY_SHARE_POOL *pool, EVP_PKEY **slot)
+{
+    EVP_PKEY *pkey = *slot;
+
+    if (pkey != NULL) {
+        *slot = NULL;
+        tsan_decr(&pool->num);
+    }
+    return pkey;
+}
+
+/* Put |pkey| into the pool slot |slot| if it is empty */
+static int slot_put(SSL_KEY_SHARE_POOL *pool, EVP_PKEY **slot, EVP_PKEY *pkey)
+{
+    if (*slot != NULL)
+        return 0;
+    *slot = pkey;
+    tsan_counter(&pool->num);
+    return 1;
+}
+
+/*
+ * Free all keys in the pool of |ctx|. The pool must not be in use by any other
+ * thread.
+ */
+void ssl_key_share_pool_free(SSL_CTX *ctx)
+{
+    SSL_KEY_SHARE_POOL *pool;
+    size_t i, j;
+
+    for (i = 0; i < OSSL_NELEM(ctx->key_share_pool); i++) {
+        pool = &ctx->key_share_pool[i];
+        if (pool->keys != NULL)
+            for (j = 0; j < ctx->key_share_pool_size; j++)
+                EVP_PKEY_free(pool->keys[j]);
+        OPENSSL_free(pool->keys);
+        pool->keys = NULL;
+        pool->num = 0;
+        pool->group_id = 0;
+    }
+}
+
+/*
+ * Set up a pool for group |id| in |ctx| if there is a free one, so that the
+ * next call to SSL_CTX_fill_key_share_pool() will generate keys for it.
+ */
+static void key_share_pool_add_group(SSL_CTX *ctx, uint16_t id)
+{
+    SSL_KEY_SHARE_POOL *pool, *unused = NULL;
+    size_t i;
+
+    if (!CRYPTO_THREAD_write_lock(ctx->lock))
+        return;
+
+    /* Another thread may have got here first */
+    for (i = 0; i < OSSL_NELEM(ctx->key_share_pool); i++) {
+        pool = &ctx->key_share_pool[i];
+        if (pool->group_id == id)
+            goto end;
+        if (pool->group_id == 0 && unused == NULL)
+            unused = pool;
+    }
+    if (unused == NULL)
+        goto end;
+
+    unused->keys = OPENSSL_zalloc(ctx->key_share_pool_size
+                                  * sizeof(*unused->keys));
+    if (unused->keys == NULL)
+        goto end;
+#ifdef tsan_st_rel
+    tsan_st_rel(&unused->group_id, id);
+#else
+    unused->group_id = id;
+#endif
+
+ end:
+    CRYPTO_THREAD_unlock(ctx->lock);
+}
+
+/*
+ * Take a key for group |id| out of the pool of |ctx|. Returns NULL if there
+ * isn't one, in which case |id| is remembered if there is room for it.
+ */
+EVP_PKEY *ssl_key_share_pool_get(SSL_CTX *ctx, uint16_t id)
+{
+    SSL_KEY_SHARE_POOL *pool;
+    EVP_PKEY *pkey = NULL;
+    size_t i, j;
+    int unused = 0;
+    uint16_t group;
+
+    if (ctx->key_share_pool_size == 0
+            || !CRYPTO_THREAD_write_lock(ctx->lock))
+        return NULL;
+
+    for (i = 0; i < OSSL_NELEM(ctx->key_share_pool); i++) {
+        pool = &ctx->key_share_pool[i];
+        group = pool->group_id;
+        if (group == id)
+            break;
+        if (group == 0)
+            unused = 1;
+    }
+    if (i < OSSL_NELEM(ctx->key_share_pool)) {
+        /* Take the newest key */
+        for (j = ctx->key_share_pool_size; pkey == NULL && j-- > 0; )
+            pkey = slot_take(pool, &pool->keys[j]);
+        unused = 0;
+    }
+    CRYPTO_THREAD_unlock(ctx->lock);
+
+    /* First use of this group */
+    if (unused)
+        key_share_pool_add_group(ctx, id);
+
+    return pkey;
+}
+
+int SSL_CTX_set_key_share_pool_size(SSL_CTX *ctx, size_t size)
+{
+    if (size > INT_MAX || size > SIZE_MAX / sizeof(EVP_PKEY *)) {
+        SSLerr(0, ERR_R_PASSED_INVALID_ARGUMENT);
+        return 0;
+    }
+    ssl_key_share_pool_free(ctx);
+    ctx->key_share_pool_size = size;
+    return 1;
+}
+
+size_t SSL_CTX_get_key_share_pool_size(const SSL_CTX *ctx)
+{
+    return ctx->key_share_pool_size;
+}
+
+int SSL_CTX_fill_key_share_pool(SSL_CTX *ctx)
+{
+#if !defined(OPENSSL_NO_DH) || !defined(OPENSSL_NO_EC)
+    SSL_KEY_SHARE_POOL *pool;
+    EVP_PKEY *pkey;
+    uint16_t id;
+    size_t i, j;
+    int added = 0;
+
+    for (i = 0; i < OSSL_NELEM(ctx->key_share_pool); i++) {
+        pool = &ctx->key_share_pool[i];
+        if ((id = pool_group(ctx, pool)) == 0)
+            continue;
+        while ((size_t)tsan_load(&pool->num) < ctx->key_share_pool_size) {
+            /* Key generation is slow, so we don't hold the lock for it */
+            if ((pkey = ssl_ctx_generate_pkey_group(ctx, id)) == NULL)
+                return -1;
+
+            if (!CRYPTO_THREAD_write_lock(ctx->lock)) {
+                EVP_PKEY_free(pkey);
+                return -1;
+            }
+            for (j = 0; j < ctx->key_share_pool_size; j++) {
+                if (slot_put(pool, &pool->keys[j], pkey)) {
+                    pkey = NULL;
+                    added++;
+                    break;
+                }
+            }
+            CRYPTO_THREAD_unlock(ctx->lock);
+
+            /* Another thread filled the pool while we weren't looking */
+            if (pkey != NULL) {
+                EVP_PKEY_free(pkey);
+                break;
+            }
+        }
+    }
+
+    return added;
+#else
+    return 0;
+#endif
+}
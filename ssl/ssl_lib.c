@@ -669,6 +669,7 @@ int SSL_CTX_set_ssl_version(SSL_CTX *ctx, const SSL_METHOD *meth)
                                 &(ctx->cipher_list),
                                 &(ctx->cipher_list_by_id),
                                 OSSL_default_cipher_list(), ctx->cert);
+    ssl_ctx_cipher_list_changed(ctx);
     if ((sk == NULL) || (sk_SSL_CIPHER_num(sk) <= 0)) {
         SSLerr(SSL_F_SSL_CTX_SET_SSL_VERSION, SSL_R_SSL_LIBRARY_HAS_NO_CIPHERS);
         return 0;
@@ -712,6 +713,8 @@ SSL *SSL_new(SSL_CTX *ctx)
     s->max_early_data = ctx->max_early_data;
     s->recv_max_early_data = ctx->recv_max_early_data;
     s->num_tickets = ctx->num_tickets;
+    memcpy(s->cert_comp_prefs, ctx->cert_comp_prefs,
+           sizeof(s->cert_comp_prefs));
     s->pha_enabled = ctx->pha_enabled;
 
     /* Shallow copy of the ciphersuites stack */
@@ -795,6 +798,7 @@ SSL *SSL_new(SSL_CTX *ctx)
             goto err;
         s->ext.supportedgroups_len = ctx->ext.supportedgroups_len;
     }
+    s->ext.supportedgroups_set = ctx->ext.supportedgroups_set;
 
 #ifndef OPENSSL_NO_NEXTPROTONEG
     s->ext.npn = NULL;
@@ -2482,7 +2486,7 @@ long SSL_CTX_ctrl(SSL_CTX *ctx, int cmd, long larg, void *parg)
         switch (cmd) {
 #ifndef OPENSSL_NO_EC
         case SSL_CTRL_SET_GROUPS_LIST:
-            return tls1_set_groups_list(NULL, NULL, parg);
+            return tls1_set_groups_list(NULL, NULL, NULL, parg);
 #endif
         case SSL_CTRL_SET_SIGALGS_LIST:
         case SSL_CTRL_SET_CLIENT_SIGALGS_LIST:
@@ -2735,6 +2739,39 @@ static int cipher_list_tls12_num(STACK_OF(SSL_CIPHER) *sk)
     return num;
 }
 
+/*
+ * Update everything derived from the cipher list of |ctx|. This must be called
+ * whenever the cipher list of |ctx| has changed.
+ */
+void ssl_ctx_cipher_list_changed(SSL_CTX *ctx)
+{
+    ssl_cipher_set_from_list(&ctx->cipher_set, ctx->cipher_list);
+    ssl_ctx_client_hello_changed(ctx);
+}
+
+/*
+ * Forget the ClientHello templates of |ctx|. This must be called whenever
+ * the cipher list, groups or signature algorithms of |ctx| change.
+ */
+void ssl_ctx_client_hello_changed(SSL_CTX *ctx)
+{
+    if (!CRYPTO_THREAD_write_lock(ctx->lock))
+        return;
+    ssl_ctx_free_client_hello_templates(ctx);
+    CRYPTO_THREAD_unlock(ctx->lock);
+}
+
+void ssl_ctx_free_client_hello_templates(SSL_CTX *ctx)
+{
+    int i, j;
+
+    for (i = 0; i < SSL_CLIENT_HELLO_FIELDS; i++) {
+        for (j = 0; j < ctx->num_client_hello_templates[i]; j++)
+            OPENSSL_free(ctx->client_hello_templates[i][j].data);
+        ctx->num_client_hello_templates[i] = 0;
+    }
+}
+
 /** specify the ciphers to be used by default by the SSL_CTX */
 int SSL_CTX_set_cipher_list(SSL_CTX *ctx, const char *str)
 {
@@ -2743,6 +2780,7 @@ int SSL_CTX_set_cipher_list(SSL_CTX *ctx, const char *str)
     sk = ssl_create_cipher_list(ctx->method, ctx->tls13_ciphersuites,
                                 &ctx->cipher_list, &ctx->cipher_list_by_id, str,
                                 ctx->cert);
+    ssl_ctx_cipher_list_changed(ctx);
     /*
      * ssl_create_cipher_list may return an empty stack if it was unable to
      * find a cipher matching the given rule string (for example if the rule
@@ -2767,6 +2805,7 @@ int SSL_set_cipher_list(SSL *s, const char *str)
     sk = ssl_create_cipher_list(s->ctx->method, s->tls13_ciphersuites,
                                 &s->cipher_list, &s->cipher_list_by_id, str,
                                 s->cert);
+    ssl_cipher_set_from_list(&s->cipher_set, s->cipher_list);
     /* see comment in SSL_CTX_set_cipher_list */
     if (sk == NULL)
         return 0;
@@ -3181,6 +3220,8 @@ SSL_CTX *SSL_CTX_new_with_libctx(OPENSSL_CTX *libctx, const char *propq,
         if (ret->propq == NULL)
             goto err;
     }
+    if ((ret->propq_query = OSSL_PROPERTY_QUERY_new(libctx, propq)) == NULL)
+        goto err;
 
     ret->method = meth;
     ret->min_proto_version = 0;
@@ -3229,6 +3270,7 @@ SSL_CTX *SSL_CTX_new_with_libctx(OPENSSL_CTX *libctx, const char *propq,
         SSLerr(0, SSL_R_LIBRARY_HAS_NO_CIPHERS);
         goto err2;
     }
+    ssl_ctx_cipher_list_changed(ret);
 
     ret->param = X509_VERIFY_PARAM_new();
     if (ret->param == NULL)
@@ -3238,8 +3280,8 @@ SSL_CTX *SSL_CTX_new_with_libctx(OPENSSL_CTX *libctx, const char *propq,
      * If these aren't available from the provider we'll get NULL returns.
      * That's fine but will cause errors later if SSLv3 is negotiated
      */
-    ret->md5 = ssl_evp_md_fetch(libctx, NID_md5, propq);
-    ret->sha1 = ssl_evp_md_fetch(libctx, NID_sha1, propq);
+    ret->md5 = ssl_evp_md_fetch(libctx, NID_md5, ret->propq_query);
+    ret->sha1 = ssl_evp_md_fetch(libctx, NID_sha1, ret->propq_query);
 
     if ((ret->ca_names = sk_X509_NAME_new_null()) == NULL)
         goto err;
@@ -3311,6 +3353,7 @@ SSL_CTX *SSL_CTX_new_with_libctx(OPENSSL_CTX *libctx, const char *propq,
     ret->options |= SSL_OP_NO_COMPRESSION | SSL_OP_ENABLE_MIDDLEBOX_COMPAT;
 
     ret->ext.status_type = TLSEXT_STATUSTYPE_nothing;
+    ret->ext.supportedgroups_set = tls1_default_group_set();
 
     /*
      * We cannot usefully set a default max_early_data here (which gets
@@ -3414,6 +3457,8 @@ void SSL_CTX_free(SSL_CTX *a)
     CTLOG_STORE_free(a->ctlog_store);
 #endif
     sk_SSL_CIPHER_free(a->cipher_list);
+    ssl_ctx_free_client_hello_templates(a);
+    ssl_key_share_pool_free(a);
     sk_SSL_CIPHER_free(a->cipher_list_by_id);
     sk_SSL_CIPHER_free(a->tls13_ciphersuites);
     ssl_cert_free(a->cert);
@@ -3466,6 +3511,7 @@ void SSL_CTX_free(SSL_CTX *a)
 #endif
 
     OPENSSL_free(a->propq);
+    OSSL_PROPERTY_QUERY_free(a->propq_query);
 
     OPENSSL_free(a);
 }
@@ -4118,6 +4164,7 @@ SSL *SSL_dup(SSL *s)
     if (s->cipher_list != NULL) {
         if ((ret->cipher_list = sk_SSL_CIPHER_dup(s->cipher_list)) == NULL)
             goto err;
+        ret->cipher_set = s->cipher_set;
     }
     if (s->cipher_list_by_id != NULL)
         if ((ret->cipher_list_by_id = sk_SSL_CIPHER_dup(s->cipher_list_by_id))
@@ -5940,7 +5987,7 @@ void SSL_set_allow_early_data_cb(SSL *s,
 
 const EVP_CIPHER *ssl_evp_cipher_fetch(OPENSSL_CTX *libctx,
                                        int nid,
-                                       const char *properties)
+                                       OSSL_PROPERTY_QUERY *query)
 {
     EVP_CIPHER *ciph;
 
@@ -5960,7 +6007,7 @@ const EVP_CIPHER *ssl_evp_cipher_fetch(OPENSSL_CTX *libctx,
 
     /* Otherwise we do an explicit fetch. This may fail and that could be ok */
     ERR_set_mark();
-    ciph = EVP_CIPHER_fetch(libctx, OBJ_nid2sn(nid), properties);
+    ciph = EVP_CIPHER_fetch_query(libctx, OBJ_nid2sn(nid), query);
     ERR_pop_to_mark();
     return ciph;
 }
@@ -5995,7 +6042,7 @@ void ssl_evp_cipher_free(const EVP_CIPHER *cipher)
 
 const EVP_MD *ssl_evp_md_fetch(OPENSSL_CTX *libctx,
                                int nid,
-                               const char *properties)
+                               OSSL_PROPERTY_QUERY *query)
 {
     EVP_MD *md;
 
@@ -6015,7 +6062,7 @@ const EVP_MD *ssl_evp_md_fetch(OPENSSL_CTX *libctx,
 
     /* Otherwise we do an explicit fetch */
     ERR_set_mark();
-    md = EVP_MD_fetch(libctx, OBJ_nid2sn(nid), properties);
+    md = EVP_MD_fetch_query(libctx, OBJ_nid2sn(nid), query);
     ERR_pop_to_mark();
     return md;
 }
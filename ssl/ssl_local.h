@@ -468,8 +468,23 @@ struct ssl_cipher_st {
     uint32_t algorithm2;        /* Extra flags */
     int32_t strength_bits;      /* Number of bits really used */
     uint32_t alg_bits;          /* Number of bits for algorithm */
+    int set_index;              /* Bit used for this cipher in SSL_CIPHER_SET */
 };
 
+/*
+ * A set of ciphers as a bitmap, indexed by |set_index| of the built-in
+ * ciphers. This has room for all of the built-in cipher tables.
+ */
+# define SSL_CIPHER_SET_WORDS   8
+# define SSL_CIPHER_SET_BITS    (SSL_CIPHER_SET_WORDS * 64)
+
+typedef struct ssl_cipher_set_st {
+    uint64_t bits[SSL_CIPHER_SET_WORDS];
+} SSL_CIPHER_SET;
+
+# define ssl_cipher_set_has(set, c) \
+    (((set)->bits[(c)->set_index / 64] >> ((c)->set_index % 64)) & 1)
+
 /* Used to hold SSL/TLS functions */
 struct ssl_method_st {
     int version;
@@ -798,6 +813,7 @@ typedef enum tlsext_index_en {
     TLSEXT_IDX_early_data,
     TLSEXT_IDX_certificate_authorities,
     TLSEXT_IDX_esni,
+    TLSEXT_IDX_compress_certificate,
     TLSEXT_IDX_padding,
     TLSEXT_IDX_psk,
     /* Dummy index - must always be the last entry */
@@ -842,6 +858,45 @@ int ssl_hmac_final(SSL_HMAC *ctx, unsigned char *md, size_t *len,
                    size_t max_size);
 size_t ssl_hmac_size(const SSL_HMAC *ctx);
 
+/* The number of different groups kept in the key share pool of an SSL_CTX */
+# define SSL_KEY_SHARE_POOL_GROUPS 4
+
+typedef struct ssl_key_share_pool_st {
+    /* The group of the keys, or 0 if this pool is unused */
+    TSAN_QUALIFIER uint16_t group_id;
+    /* |key_share_pool_size| slots, each holding an unused key or NULL */
+    EVP_PKEY **keys;
+    /* The number of keys in |keys| */
+    TSAN_QUALIFIER int num;
+} SSL_KEY_SHARE_POOL;
+
+/* The ClientHello fields kept as templates in an SSL_CTX */
+# define SSL_CLIENT_HELLO_CIPHERS       0   /* cipher_suites */
+# define SSL_CLIENT_HELLO_GROUPS        1   /* supported_groups extension */
+# define SSL_CLIENT_HELLO_SIGALGS       2   /* signature_algorithms extension */
+# define SSL_CLIENT_HELLO_FIELDS        3
+
+/* The number of templates kept for each field */
+# define SSL_CLIENT_HELLO_TEMPLATES_MAX 4
+
+/*
+ * A template for a field of a ClientHello, along with the parameters it was
+ * made with.
+ */
+typedef struct ssl_client_hello_template_st {
+    unsigned char *data;
+    size_t len;
+    const SSL_METHOD *method;
+    int version;
+    int min_ver;
+    int max_ver;
+    uint32_t mask_k;
+    uint32_t mask_a;
+    int sec_level;
+    uint32_t suiteb;
+    int scsv;
+} SSL_CLIENT_HELLO_TEMPLATE;
+
 struct ssl_ctx_st {
     OPENSSL_CTX *libctx;
 
@@ -849,8 +904,25 @@ struct ssl_ctx_st {
     STACK_OF(SSL_CIPHER) *cipher_list;
     /* same as above but sorted for lookup */
     STACK_OF(SSL_CIPHER) *cipher_list_by_id;
+    /* same as above as a bitmap, for fast intersection with a peer's list */
+    SSL_CIPHER_SET cipher_set;
     /* TLSv1.3 specific ciphersuites */
     STACK_OF(SSL_CIPHER) *tls13_ciphersuites;
+    /*
+     * Templates for the cipher_suites, supported_groups and
+     * signature_algorithms fields of a ClientHello built from the
+     * configuration of this SSL_CTX. This avoids filtering the same lists
+     * again for every connection made with the same settings. Templates are
+     * only added, with |lock| held, and |num_client_hello_templates| is
+     * increased after each one is complete, so readers don't need the lock.
+     * They are all discarded when the cipher list, groups or signature
+     * algorithms change, which like any other change to the SSL_CTX must not
+     * happen while it is in use.
+     */
+    SSL_CLIENT_HELLO_TEMPLATE
+        client_hello_templates[SSL_CLIENT_HELLO_FIELDS]
+                              [SSL_CLIENT_HELLO_TEMPLATES_MAX];
+    TSAN_QUALIFIER int num_client_hello_templates[SSL_CLIENT_HELLO_FIELDS];
     struct x509_store_st /* X509_STORE */ *cert_store;
     LHASH_OF(SSL_SESSION) *sessions;
     /*
@@ -1069,6 +1141,8 @@ struct ssl_ctx_st {
 
         size_t supportedgroups_len;
         uint16_t *supportedgroups;
+        /* The groups above (or the default ones) as a tls1_group_set() */
+        uint64_t supportedgroups_set;
 
         /*
          * ALPN information (we are in the process of transitioning from NPN to
@@ -1196,6 +1270,27 @@ struct ssl_ctx_st {
     /* The number of TLS1.3 tickets to automatically send */
     size_t num_tickets;
 
+    /*
+     * Certificate compression algorithms (TLSEXT_comp_cert_*) in order of
+     * preference, terminated by TLSEXT_comp_cert_none.
+     */
+    int cert_comp_prefs[TLSEXT_comp_cert_limit];
+    /* Compression callbacks, see SSL_CTX_set_cert_comp_callbacks() */
+    struct {
+        SSL_cert_comp_cb_fn compress;
+        SSL_cert_comp_cb_fn expand;
+        void *arg;
+    } cert_comp_cbs[TLSEXT_comp_cert_limit];
+
+    /*
+     * Pregenerated ephemeral keys for key exchange, see
+     * SSL_CTX_set_key_share_pool_size(). |key_share_pool_size| is the maximum
+     * number of keys kept per group. The groups are set up with |lock| held,
+     * see ssl_key_pool.c for how keys are added and removed.
+     */
+    size_t key_share_pool_size;
+    SSL_KEY_SHARE_POOL key_share_pool[SSL_KEY_SHARE_POOL_GROUPS];
+
     /* Callback to determine if early_data is acceptable or not */
     SSL_allow_early_data_cb_fn allow_early_data_cb;
     void *allow_early_data_cb_data;
@@ -1208,6 +1303,8 @@ struct ssl_ctx_st {
     void *async_cb_arg;
 
     char *propq;
+    /* |propq| parsed once, for the fetches done during handshakes */
+    OSSL_PROPERTY_QUERY *propq_query;
 
     const EVP_CIPHER *ssl_cipher_methods[SSL_ENC_NUM_IDX];
     const EVP_MD *ssl_digest_methods[SSL_MD_NUM_IDX];
@@ -1368,6 +1465,8 @@ struct ssl_st {
             /* Size of above arrays */
             size_t peer_sigalgslen;
             size_t peer_cert_sigalgslen;
+            /* |peer_sigalgs| as a tls12_sigalg_set() */
+            uint64_t peer_sigalgs_set;
             /* Sigalg peer actually uses */
             const struct sigalg_lookup_st *peer_sigalg;
             /*
@@ -1455,6 +1554,8 @@ struct ssl_st {
     STACK_OF(SSL_CIPHER) *peer_ciphers;
     STACK_OF(SSL_CIPHER) *cipher_list;
     STACK_OF(SSL_CIPHER) *cipher_list_by_id;
+    /* |cipher_list| as a bitmap, when it is set */
+    SSL_CIPHER_SET cipher_set;
     /* TLSv1.3 specific ciphersuites */
     STACK_OF(SSL_CIPHER) *tls13_ciphersuites;
     /*
@@ -1635,10 +1736,14 @@ struct ssl_st {
         size_t supportedgroups_len;
         /* our list */
         uint16_t *supportedgroups;
+        /* our list (or the default one) as a tls1_group_set() */
+        uint64_t supportedgroups_set;
 
         size_t peer_supportedgroups_len;
          /* peer's list */
         uint16_t *peer_supportedgroups;
+        /* peer's list as a tls1_group_set() */
+        uint64_t peer_supportedgroups_set;
 
         /* TLS Session Ticket extension override */
         TLS_SESSION_TICKET_EXT *session_ticket;
@@ -1698,6 +1803,17 @@ struct ssl_st {
          * selected.
          */
         int tick_identity;
+
+        /*
+         * The algorithm used to compress the server Certificate message
+         * (RFC 8879), or TLSEXT_comp_cert_none if it was not compressed.
+         */
+        int server_cert_comp_alg;
+        /*
+         * Server side: the algorithm selected from the client's
+         * compress_certificate extension, or TLSEXT_comp_cert_none.
+         */
+        int compress_certificate_sel;
     } ext;
 
     /*
@@ -1815,6 +1931,9 @@ struct ssl_st {
     /* The next nonce value to use when we send a ticket on this connection */
     uint64_t next_ticket_nonce;
 
+    /* Certificate compression preferences, see the SSL_CTX equivalent */
+    int cert_comp_prefs[TLSEXT_comp_cert_limit];
+
     /* Callback to determine if early_data is acceptable or not */
     SSL_allow_early_data_cb_fn allow_early_data_cb;
     void *allow_early_data_cb_data;
@@ -1993,6 +2112,45 @@ typedef struct dtls1_state_st {
 #  define NAMED_CURVE_TYPE           3
 # endif                         /* OPENSSL_NO_EC */
 
+/*
+ * Data derived from a certificate and its chain which is shared between a
+ * CERT and all of its copies (i.e. an SSL_CTX and the SSL objects created from
+ * it) so that it only has to be computed once. A CERT_PKEY gets a fresh cache
+ * whenever its certificate or chain is changed.
+ */
+typedef struct ssl_cert_cache_st {
+    /*
+     * The certificate_list of the Certificate message, i.e. the DER encoding
+     * of each certificate preceded by its 3 byte length, without any TLSv1.3
+     * per-certificate extensions. Only used for a certificate with an
+     * explicitly configured chain. It is set at most once, after which
+     * |chain_cached| is set and it can be read without holding |lock|.
+     */
+    unsigned char *chain;
+    size_t chain_len;
+    TSAN_QUALIFIER int chain_cached;
+    /*
+     * Bit N is set once the certificate and chain have passed the security
+     * checks of the default security callback at security level N.
+     */
+    TSAN_QUALIFIER int sec_levels_ok;
+    /*
+     * CompressedCertificate message bodies indexed by TLSEXT_comp_cert_*, and
+     * the length of the Certificate message each one replaces. Only used when
+     * the Certificate message is fully determined by the CERT_PKEY, see
+     * ssl_cert_chain_is_static(). An entry is set at most once, after which
+     * |cached| is set and the entry can be read without holding |lock|.
+     */
+    struct {
+        unsigned char *data;
+        size_t len;
+        size_t orig_len;
+        TSAN_QUALIFIER int cached;
+    } comp[TLSEXT_comp_cert_limit];
+    CRYPTO_REF_COUNT references;
+    CRYPTO_RWLOCK *lock;
+} SSL_CERT_CACHE;
+
 struct cert_pkey_st {
     X509 *x509;
     EVP_PKEY *privatekey;
@@ -2007,6 +2165,8 @@ struct cert_pkey_st {
      */
     unsigned char *serverinfo;
     size_t serverinfo_length;
+    /* Shared cache of encodings of the above, may be NULL */
+    SSL_CERT_CACHE *cache;
 };
 /* Retrieve Suite B flags */
 # define tls1_suiteb(s)  (s->cert->cert_flags & SSL_CERT_FLAG_SUITEB_128_LOS)
@@ -2083,6 +2243,8 @@ typedef struct cert_st {
     uint16_t *conf_sigalgs;
     /* Size of above array */
     size_t conf_sigalgslen;
+    /* Above array (or the default one) as a tls12_sigalg_set() */
+    uint64_t conf_sigalgs_set;
     /*
      * Client authentication signature algorithms, if not set then uses
      * conf_sigalgs. On servers these will be the signature algorithms sent
@@ -2093,6 +2255,8 @@ typedef struct cert_st {
     uint16_t *client_sigalgs;
     /* Size of above array */
     size_t client_sigalgslen;
+    /* Above array as a tls12_sigalg_set() */
+    uint64_t client_sigalgs_set;
     /*
      * Certificate setup callback: if set is called whenever a certificate
      * may be required (client or server). the callback can then examine any
@@ -2437,6 +2601,26 @@ __owur CERT *ssl_cert_new(void);
 __owur CERT *ssl_cert_dup(CERT *cert);
 void ssl_cert_clear_certs(CERT *c);
 void ssl_cert_free(CERT *c);
+__owur SSL_CERT_CACHE *ssl_cert_cache_new(void);
+__owur int ssl_cert_cache_up_ref(SSL_CERT_CACHE *cache);
+void ssl_cert_cache_free(SSL_CERT_CACHE *cache);
+int ssl_cert_cache_get_flag(SSL_CERT_CACHE *cache, TSAN_QUALIFIER int *flag);
+void ssl_cert_cache_set_flag(TSAN_QUALIFIER int *flag, int bits);
+__owur int ssl_cert_pkey_reset_cache(CERT_PKEY *cpk);
+int ssl_cert_default_security(const CERT *c);
+void ssl_ctx_cipher_list_changed(SSL_CTX *ctx);
+void ssl_ctx_client_hello_changed(SSL_CTX *ctx);
+void ssl_ctx_free_client_hello_templates(SSL_CTX *ctx);
+__owur int ssl_cert_comp_alg_available(const SSL_CTX *ctx, int alg);
+__owur int ssl_cert_comp_alg_enabled(const SSL *s, int alg);
+__owur int ssl_compress_certificate(SSL *s, CERT_PKEY *cpk, int alg,
+                                    const unsigned char *in, size_t inlen,
+                                    WPACKET *pkt);
+__owur int ssl_add_cached_compressed_certificate(SSL *s, CERT_PKEY *cpk,
+                                                int alg, WPACKET *pkt);
+__owur int ssl_expand_certificate(SSL *s, int alg, const unsigned char *in,
+                                  size_t inlen, unsigned char **out,
+                                  size_t outlen);
 __owur int ssl_generate_session_id(SSL *s, SSL_SESSION *ss);
 __owur int ssl_get_new_session(SSL *s, int session);
 __owur SSL_SESSION *lookup_sess_in_cache(SSL *s, const unsigned char *sess_id,
@@ -2504,7 +2688,10 @@ void ssl_set_masks(SSL *s);
 __owur STACK_OF(SSL_CIPHER) *ssl_get_ciphers_by_id(SSL *s);
 __owur int ssl_x509err2alert(int type);
 void ssl_sort_cipher_list(void);
+void tls1_init_lookup_tables(void);
 int ssl_load_ciphers(SSL_CTX *ctx);
+void ssl_cipher_set_from_list(SSL_CIPHER_SET *set,
+                              const STACK_OF(SSL_CIPHER) *sk);
 __owur int ssl_fill_hello_random(SSL *s, int server, unsigned char *field,
                                  size_t len, DOWNGRADE dgrd);
 __owur int ssl_generate_master_secret(SSL *s, unsigned char *pms, size_t pmslen,
@@ -2544,6 +2731,7 @@ __owur int ssl3_finish_mac(SSL *s, const unsigned char *buf, size_t len);
 void ssl3_free_digest_list(SSL *s);
 __owur unsigned long ssl3_output_cert_chain(SSL *s, WPACKET *pkt,
                                             CERT_PKEY *cpk);
+__owur int ssl_cert_chain_is_static(SSL *s, CERT_PKEY *cpk);
 __owur const SSL_CIPHER *ssl3_choose_cipher(SSL *ssl,
                                             STACK_OF(SSL_CIPHER) *clnt,
                                             STACK_OF(SSL_CIPHER) *srvr);
@@ -2694,14 +2882,20 @@ __owur int ssl_check_srvr_ecc_cert_and_alg(X509 *x, SSL *s);
 SSL_COMP *ssl3_comp_find(STACK_OF(SSL_COMP) *sk, int n);
 
 __owur const TLS_GROUP_INFO *tls1_group_id_lookup(uint16_t curve_id);
+__owur const SIGALG_LOOKUP *tls1_lookup_sigalg(uint16_t sigalg);
 __owur int tls1_group_id2nid(uint16_t group_id);
 __owur int tls1_check_group_id(SSL *s, uint16_t group_id, int check_own_curves);
 __owur uint16_t tls1_shared_group(SSL *s, int nmatch);
-__owur int tls1_set_groups(uint16_t **pext, size_t *pextlen,
+__owur int tls1_set_groups(uint16_t **pext, size_t *pextlen, uint64_t *pset,
                            int *curves, size_t ncurves);
 __owur int tls1_set_groups_list(uint16_t **pext, size_t *pextlen,
-                                const char *str);
+                                uint64_t *pset, const char *str);
+uint64_t tls1_group_set(const uint16_t *groups, size_t ngroups);
+uint64_t tls1_default_group_set(void);
 __owur EVP_PKEY *ssl_generate_pkey_group(SSL *s, uint16_t id);
+__owur EVP_PKEY *ssl_ctx_generate_pkey_group(SSL_CTX *ctx, uint16_t id);
+__owur EVP_PKEY *ssl_key_share_pool_get(SSL_CTX *ctx, uint16_t id);
+void ssl_key_share_pool_free(SSL_CTX *ctx);
 __owur int tls_valid_group(SSL *s, uint16_t group_id, int version);
 __owur EVP_PKEY *ssl_generate_param_group(SSL *s, uint16_t id);
 #  ifndef OPENSSL_NO_EC
@@ -2747,6 +2941,7 @@ __owur DH *ssl_get_auto_dh(SSL *s);
 __owur int ssl_security_cert(SSL *s, SSL_CTX *ctx, X509 *x, int vfy, int is_ee);
 __owur int ssl_security_cert_chain(SSL *s, STACK_OF(X509) *sk, X509 *ex,
                                    int vfy);
+__owur int ssl_security_cert_pkey_chain(SSL *s, CERT_PKEY *cpk);
 
 int tls_choose_sigalg(SSL *s, int fatalerrs);
 
@@ -2762,6 +2957,8 @@ __owur int tls1_set_peer_legacy_sigalg(SSL *s, const EVP_PKEY *pkey);
 __owur int tls1_lookup_md(SSL_CTX *ctx, const SIGALG_LOOKUP *lu,
                           const EVP_MD **pmd);
 __owur size_t tls12_get_psigalgs(SSL *s, int sent, const uint16_t **psigs);
+uint64_t tls12_sigalg_set(const uint16_t *psig, size_t psiglen);
+uint64_t tls12_default_sigalg_set(void);
 #  ifndef OPENSSL_NO_EC
 __owur int tls_check_sigalg_curve(const SSL *s, int curve);
 #  endif
@@ -2851,12 +3048,12 @@ void ssl_ctx_system_config(SSL_CTX *ctx);
 
 const EVP_CIPHER *ssl_evp_cipher_fetch(OPENSSL_CTX *libctx,
                                        int nid,
-                                       const char *properties);
+                                       OSSL_PROPERTY_QUERY *query);
 int ssl_evp_cipher_up_ref(const EVP_CIPHER *cipher);
 void ssl_evp_cipher_free(const EVP_CIPHER *cipher);
 const EVP_MD *ssl_evp_md_fetch(OPENSSL_CTX *libctx,
                                int nid,
-                               const char *properties);
+                               OSSL_PROPERTY_QUERY *query);
 int ssl_evp_md_up_ref(const EVP_MD *md);
 void ssl_evp_md_free(const EVP_MD *md);
 
@@ -130,6 +130,18 @@ int SSL_use_RSAPrivateKey(SSL *ssl, RSA *rsa)
 }
 #endif
 
+/*
+ * Private keys are usually used for many handshakes, so we convert them
+ * for the provider that will use them once, up front.  Keys that can't be
+ * converted, like ENGINE keys, are simply used as they are.
+ */
+static void ssl_pin_pkey(SSL_CTX *ctx, EVP_PKEY *pkey)
+{
+    ERR_set_mark();
+    EVP_PKEY_pin_to_provider(pkey, ctx->libctx, ctx->propq);
+    ERR_pop_to_mark();
+}
+
 static int ssl_set_pkey(CERT *c, EVP_PKEY *pkey)
 {
     size_t i;
@@ -243,6 +255,8 @@ int SSL_use_PrivateKey(SSL *ssl, EVP_PKEY *pkey)
         return 0;
     }
     ret = ssl_set_pkey(ssl->cert, pkey);
+    if (ret)
+        ssl_pin_pkey(ssl->ctx, pkey);
     return ret;
 }
 
@@ -374,6 +388,10 @@ static int ssl_set_cert(CERT *c, X509 *x)
         }
     }
 
+    if (!ssl_cert_pkey_reset_cache(&c->pkeys[i])) {
+        SSLerr(SSL_F_SSL_SET_CERT, ERR_R_MALLOC_FAILURE);
+        return 0;
+    }
     X509_free(c->pkeys[i].x509);
     X509_up_ref(x);
     c->pkeys[i].x509 = x;
@@ -530,7 +548,10 @@ int SSL_CTX_use_PrivateKey(SSL_CTX *ctx, EVP_PKEY *pkey)
         SSLerr(SSL_F_SSL_CTX_USE_PRIVATEKEY, ERR_R_PASSED_NULL_PARAMETER);
         return 0;
     }
-    return ssl_set_pkey(ctx->cert, pkey);
+    if (!ssl_set_pkey(ctx->cert, pkey))
+        return 0;
+    ssl_pin_pkey(ctx, pkey);
+    return 1;
 }
 
 int SSL_CTX_use_PrivateKey_file(SSL_CTX *ctx, const char *file, int type)
@@ -1127,6 +1148,12 @@ static int ssl_set_cert_and_key(SSL *ssl, SSL_CTX *ctx, X509 *x509, EVP_PKEY *pr
         }
     }
 
+    if (!ssl_cert_pkey_reset_cache(&c->pkeys[i])) {
+        SSLerr(SSL_F_SSL_SET_CERT_AND_KEY, ERR_R_MALLOC_FAILURE);
+        sk_X509_pop_free(dup_chain, X509_free);
+        goto out;
+    }
+
     sk_X509_pop_free(c->pkeys[i].chain, X509_free);
     c->pkeys[i].chain = dup_chain;
 
@@ -305,12 +305,51 @@ EXT_RETURN tls_construct_ctos_ec_pt_formats(SSL *s, WPACKET *pkt,
 #endif
 
 #if !defined(OPENSSL_NO_DH) || !defined(OPENSSL_NO_EC)
+/* Add the groups of |s| usable with its maximum version to |pkt| */
+static int client_supported_groups(SSL *s, WPACKET *pkt)
+{
+    const uint16_t *pgroups = NULL;
+    size_t num_groups = 0, i;
+
+    tls1_get_supported_groups(s, &pgroups, &num_groups);
+
+    /* Copy group ID if supported */
+    for (i = 0; i < num_groups; i++) {
+        uint16_t ctmp = pgroups[i];
+
+        if (tls_valid_group(s, ctmp, s->s3.tmp.max_ver)
+                && tls_group_allowed(s, ctmp, SSL_SECOP_CURVE_SUPPORTED)) {
+            if (!WPACKET_put_bytes_u16(pkt, ctmp)) {
+                SSLfatal(s, SSL_AD_INTERNAL_ERROR,
+                         SSL_F_TLS_CONSTRUCT_CTOS_SUPPORTED_GROUPS,
+                         ERR_R_INTERNAL_ERROR);
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
+/*
+ * Whether the groups of |s| are those of its SSL_CTX, so that the
+ * supported_groups list can be taken from the templates of the SSL_CTX.
+ */
+static int client_supported_groups_static(SSL *s)
+{
+    if (!ssl_client_hello_ciphers_static(s)
+            || s->ext.supportedgroups_len != s->ctx->ext.supportedgroups_len)
+        return 0;
+    return s->ext.supportedgroups_len == 0
+           || memcmp(s->ext.supportedgroups, s->ctx->ext.supportedgroups,
+                     s->ext.supportedgroups_len
+                     * sizeof(*s->ext.supportedgroups)) == 0;
+}
+
 EXT_RETURN tls_construct_ctos_supported_groups(SSL *s, WPACKET *pkt,
                                                unsigned int context, X509 *x,
                                                size_t chainidx)
 {
-    const uint16_t *pgroups = NULL;
-    size_t num_groups = 0, i;
     int min_version, max_version, reason;
 
     reason = ssl_get_min_max_version(s, &min_version, &max_version, NULL);
@@ -331,8 +370,6 @@ EXT_RETURN tls_construct_ctos_supported_groups(SSL *s, WPACKET *pkt,
     /*
      * Add TLS extension supported_groups to the ClientHello message
      */
-    tls1_get_supported_groups(s, &pgroups, &num_groups);
-
     if (!WPACKET_put_bytes_u16(pkt, TLSEXT_TYPE_supported_groups)
                /* Sub-packet for supported_groups extension */
             || !WPACKET_start_sub_packet_u16(pkt)
@@ -343,19 +380,15 @@ EXT_RETURN tls_construct_ctos_supported_groups(SSL *s, WPACKET *pkt,
                  ERR_R_INTERNAL_ERROR);
         return EXT_RETURN_FAIL;
     }
-    /* Copy group ID if supported */
-    for (i = 0; i < num_groups; i++) {
-        uint16_t ctmp = pgroups[i];
-
-        if (tls_valid_group(s, ctmp, max_version)
-                && tls_group_allowed(s, ctmp, SSL_SECOP_CURVE_SUPPORTED)) {
-            if (!WPACKET_put_bytes_u16(pkt, ctmp)) {
-                SSLfatal(s, SSL_AD_INTERNAL_ERROR,
-                         SSL_F_TLS_CONSTRUCT_CTOS_SUPPORTED_GROUPS,
-                         ERR_R_INTERNAL_ERROR);
-                return EXT_RETURN_FAIL;
-            }
+    if (client_supported_groups_static(s)) {
+        if (!ssl_construct_client_hello_field(s, SSL_CLIENT_HELLO_GROUPS,
+                                              client_supported_groups, pkt)) {
+            /* SSLfatal() already called */
+            return EXT_RETURN_FAIL;
         }
+    } else if (!client_supported_groups(s, pkt)) {
+        /* SSLfatal() already called */
+        return EXT_RETURN_FAIL;
     }
     if (!WPACKET_close(pkt) || !WPACKET_close(pkt)) {
         SSLfatal(s, SSL_AD_INTERNAL_ERROR,
@@ -412,25 +445,66 @@ EXT_RETURN tls_construct_ctos_session_ticket(SSL *s, WPACKET *pkt,
     return EXT_RETURN_SENT;
 }
 
-EXT_RETURN tls_construct_ctos_sig_algs(SSL *s, WPACKET *pkt,
-                                       unsigned int context, X509 *x,
-                                       size_t chainidx)
+/* Add the signature algorithms offered by |s| to |pkt| */
+static int client_sig_algs(SSL *s, WPACKET *pkt)
 {
     size_t salglen;
     const uint16_t *salg;
 
+    salglen = tls12_get_psigalgs(s, 1, &salg);
+    if (!tls12_copy_sigalgs(s, pkt, salg, salglen)) {
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_TLS_CONSTRUCT_CTOS_SIG_ALGS,
+                 ERR_R_INTERNAL_ERROR);
+        return 0;
+    }
+
+    return 1;
+}
+
+/*
+ * Whether the signature algorithms of |s| are those of its SSL_CTX, so that
+ * the signature_algorithms list can be taken from the templates of the
+ * SSL_CTX.
+ */
+static int client_sig_algs_static(SSL *s)
+{
+    const CERT *c = s->cert, *ctxc = s->ctx->cert;
+
+    if (!ssl_client_hello_ciphers_static(s)
+            || c->conf_sigalgslen != ctxc->conf_sigalgslen)
+        return 0;
+    return c->conf_sigalgslen == 0
+           || memcmp(c->conf_sigalgs, ctxc->conf_sigalgs,
+                     c->conf_sigalgslen * sizeof(*c->conf_sigalgs)) == 0;
+}
+
+EXT_RETURN tls_construct_ctos_sig_algs(SSL *s, WPACKET *pkt,
+                                       unsigned int context, X509 *x,
+                                       size_t chainidx)
+{
     if (!SSL_CLIENT_USE_SIGALGS(s))
         return EXT_RETURN_NOT_SENT;
 
-    salglen = tls12_get_psigalgs(s, 1, &salg);
     if (!WPACKET_put_bytes_u16(pkt, TLSEXT_TYPE_signature_algorithms)
                /* Sub-packet for sig-algs extension */
             || !WPACKET_start_sub_packet_u16(pkt)
                /* Sub-packet for the actual list */
-            || !WPACKET_start_sub_packet_u16(pkt)
-            || !tls12_copy_sigalgs(s, pkt, salg, salglen)
-            || !WPACKET_close(pkt)
-            || !WPACKET_close(pkt)) {
+            || !WPACKET_start_sub_packet_u16(pkt)) {
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_TLS_CONSTRUCT_CTOS_SIG_ALGS,
+                 ERR_R_INTERNAL_ERROR);
+        return EXT_RETURN_FAIL;
+    }
+    if (client_sig_algs_static(s)) {
+        if (!ssl_construct_client_hello_field(s, SSL_CLIENT_HELLO_SIGALGS,
+                                              client_sig_algs, pkt)) {
+            /* SSLfatal() already called */
+            return EXT_RETURN_FAIL;
+        }
+    } else if (!client_sig_algs(s, pkt)) {
+        /* SSLfatal() already called */
+        return EXT_RETURN_FAIL;
+    }
+    if (!WPACKET_close(pkt) || !WPACKET_close(pkt)) {
         SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_TLS_CONSTRUCT_CTOS_SIG_ALGS,
                  ERR_R_INTERNAL_ERROR);
         return EXT_RETURN_FAIL;
@@ -1099,6 +1173,42 @@ EXT_RETURN tls_construct_ctos_early_data(SSL *s, WPACKET *pkt,
     return EXT_RETURN_SENT;
 }
 
+EXT_RETURN tls_construct_ctos_compress_certificate(SSL *s, WPACKET *pkt,
+                                                   unsigned int context,
+                                                   X509 *x, size_t chainidx)
+{
+    size_t i;
+
+    if (s->cert_comp_prefs[0] == TLSEXT_comp_cert_none)
+        return EXT_RETURN_NOT_SENT;
+
+    if (!WPACKET_put_bytes_u16(pkt, TLSEXT_TYPE_compress_certificate)
+            || !WPACKET_start_sub_packet_u16(pkt)
+            || !WPACKET_start_sub_packet_u8(pkt)) {
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR,
+                 SSL_F_TLS_CONSTRUCT_CTOS_COMPRESS_CERTIFICATE,
+                 ERR_R_INTERNAL_ERROR);
+        return EXT_RETURN_FAIL;
+    }
+    for (i = 0; i < OSSL_NELEM(s->cert_comp_prefs)
+                && s->cert_comp_prefs[i] != TLSEXT_comp_cert_none; i++) {
+        if (!WPACKET_put_bytes_u16(pkt, s->cert_comp_prefs[i])) {
+            SSLfatal(s, SSL_AD_INTERNAL_ERROR,
+                     SSL_F_TLS_CONSTRUCT_CTOS_COMPRESS_CERTIFICATE,
+                     ERR_R_INTERNAL_ERROR);
+            return EXT_RETURN_FAIL;
+        }
+    }
+    if (!WPACKET_close(pkt) || !WPACKET_close(pkt)) {
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR,
+                 SSL_F_TLS_CONSTRUCT_CTOS_COMPRESS_CERTIFICATE,
+                 ERR_R_INTERNAL_ERROR);
+        return EXT_RETURN_FAIL;
+    }
+
+    return EXT_RETURN_SENT;
+}
+
 #define F5_WORKAROUND_MIN_MSG_LEN   0xff
 #define F5_WORKAROUND_MAX_MSG_LEN   0x200
 
@@ -626,6 +626,45 @@ int tls_parse_ctos_psk_kex_modes(SSL *s, PACKET *pkt, unsigned int context,
     return 1;
 }
 
+/*
+ * Process a compress_certificate extension received in the ClientHello. We
+ * select the first of our own preferences that the client also offered.
+ */
+int tls_parse_ctos_compress_certificate(SSL *s, PACKET *pkt,
+                                        unsigned int context, X509 *x,
+                                        size_t chainidx)
+{
+    PACKET algs;
+    unsigned int alg;
+    size_t i;
+    int offered[TLSEXT_comp_cert_limit] = { 0 };
+
+    if (!PACKET_as_length_prefixed_1(pkt, &algs)
+            || PACKET_remaining(&algs) == 0
+            || (PACKET_remaining(&algs) % 2) != 0) {
+        SSLfatal(s, SSL_AD_DECODE_ERROR,
+                 SSL_F_TLS_PARSE_CTOS_COMPRESS_CERTIFICATE,
+                 SSL_R_BAD_EXTENSION);
+        return 0;
+    }
+
+    while (PACKET_get_net_2(&algs, &alg)) {
+        if (alg < TLSEXT_comp_cert_limit)
+            offered[alg] = 1;
+    }
+
+    s->ext.compress_certificate_sel = TLSEXT_comp_cert_none;
+    for (i = 0; i < OSSL_NELEM(s->cert_comp_prefs); i++) {
+        if (s->cert_comp_prefs[i] != TLSEXT_comp_cert_none
+                && offered[s->cert_comp_prefs[i]]) {
+            s->ext.compress_certificate_sel = s->cert_comp_prefs[i];
+            break;
+        }
+    }
+
+    return 1;
+}
+
 /*
  * Process a key_share extension received in the ClientHello. |pkt| contains
  * the raw PACKET data for the extension. Returns 1 on success or 0 on failure.
@@ -1010,6 +1049,7 @@ int tls_parse_ctos_supported_groups(SSL *s, PACKET *pkt, unsigned int context,
         OPENSSL_free(s->ext.peer_supportedgroups);
         s->ext.peer_supportedgroups = NULL;
         s->ext.peer_supportedgroups_len = 0;
+        s->ext.peer_supportedgroups_set = 0;
         if (!tls1_save_u16(&supported_groups_list,
                            &s->ext.peer_supportedgroups,
                            &s->ext.peer_supportedgroups_len)) {
@@ -1018,6 +1058,9 @@ int tls_parse_ctos_supported_groups(SSL *s, PACKET *pkt, unsigned int context,
                      ERR_R_INTERNAL_ERROR);
             return 0;
         }
+        s->ext.peer_supportedgroups_set =
+            tls1_group_set(s->ext.peer_supportedgroups,
+                           s->ext.peer_supportedgroups_len);
     }
 
     return 1;
@@ -1768,7 +1811,8 @@ EXT_RETURN tls_construct_stoc_key_share(SSL *s, WPACKET *pkt,
         return EXT_RETURN_FAIL;
     }
 
-    skey = ssl_generate_pkey(s, ckey);
+    if ((skey = ssl_key_share_pool_get(s->ctx, s->s3.group_id)) == NULL)
+        skey = ssl_generate_pkey(s, ckey);
     if (skey == NULL) {
         SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_TLS_CONSTRUCT_STOC_KEY_SHARE,
                  ERR_R_MALLOC_FAILURE);
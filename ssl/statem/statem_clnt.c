@@ -130,6 +130,12 @@ static int ossl_statem_client13_read_transition(SSL *s, int mt)
                 st->hand_state = TLS_ST_CR_CERT;
                 return 1;
             }
+            if (mt == SSL3_MT_COMPRESSED_CERTIFICATE
+                    && (s->ext.extflags[TLSEXT_IDX_compress_certificate]
+                        & SSL_EXT_FLAG_SENT) != 0) {
+                st->hand_state = TLS_ST_CR_COMP_CERT;
+                return 1;
+            }
         }
         break;
 
@@ -138,9 +144,16 @@ static int ossl_statem_client13_read_transition(SSL *s, int mt)
             st->hand_state = TLS_ST_CR_CERT;
             return 1;
         }
+        if (mt == SSL3_MT_COMPRESSED_CERTIFICATE
+                && (s->ext.extflags[TLSEXT_IDX_compress_certificate]
+                    & SSL_EXT_FLAG_SENT) != 0) {
+            st->hand_state = TLS_ST_CR_COMP_CERT;
+            return 1;
+        }
         break;
 
     case TLS_ST_CR_CERT:
+    case TLS_ST_CR_COMP_CERT:
         if (mt == SSL3_MT_CERTIFICATE_VERIFY) {
             st->hand_state = TLS_ST_CR_CERT_VRFY;
             return 1;
@@ -985,6 +998,7 @@ size_t ossl_statem_client_max_message_size(SSL *s)
         return HELLO_VERIFY_REQUEST_MAX_LENGTH;
 
     case TLS_ST_CR_CERT:
+    case TLS_ST_CR_COMP_CERT:
         return s->max_cert_list;
 
     case TLS_ST_CR_CERT_VRFY:
@@ -1050,6 +1064,9 @@ MSG_PROCESS_RETURN ossl_statem_client_process_message(SSL *s, PACKET *pkt)
     case TLS_ST_CR_CERT:
         return tls_process_server_certificate(s, pkt);
 
+    case TLS_ST_CR_COMP_CERT:
+        return tls_process_server_compressed_certificate(s, pkt);
+
     case TLS_ST_CR_CERT_VRFY:
         return tls_process_cert_verify(s, pkt);
 
@@ -2198,6 +2215,63 @@ MSG_PROCESS_RETURN tls_process_server_certificate(SSL *s, PACKET *pkt)
     return ret;
 }
 
+/*
+ * Process a TLSv1.3 CompressedCertificate message (RFC 8879) by expanding it
+ * and handing the result on to the ordinary Certificate message processing.
+ */
+MSG_PROCESS_RETURN tls_process_server_compressed_certificate(SSL *s,
+                                                             PACKET *pkt)
+{
+    unsigned int alg;
+    unsigned long expected_len;
+    PACKET comp, cert;
+    unsigned char *buf = NULL;
+    MSG_PROCESS_RETURN ret;
+
+    if (!PACKET_get_net_2(pkt, &alg)
+            || !PACKET_get_net_3(pkt, &expected_len)
+            || !PACKET_get_length_prefixed_3(pkt, &comp)
+            || PACKET_remaining(pkt) != 0
+            || expected_len == 0
+            || PACKET_remaining(&comp) == 0) {
+        SSLfatal(s, SSL_AD_DECODE_ERROR,
+                 SSL_F_TLS_PROCESS_SERVER_COMPRESSED_CERTIFICATE,
+                 SSL_R_LENGTH_MISMATCH);
+        return MSG_PROCESS_ERROR;
+    }
+    if (!ssl_cert_comp_alg_enabled(s, (int)alg)) {
+        SSLfatal(s, SSL_AD_ILLEGAL_PARAMETER,
+                 SSL_F_TLS_PROCESS_SERVER_COMPRESSED_CERTIFICATE,
+                 SSL_R_UNSUPPORTED_COMPRESSION_ALGORITHM);
+        return MSG_PROCESS_ERROR;
+    }
+    if (expected_len > s->max_cert_list) {
+        SSLfatal(s, SSL_AD_BAD_CERTIFICATE,
+                 SSL_F_TLS_PROCESS_SERVER_COMPRESSED_CERTIFICATE,
+                 SSL_R_EXCESSIVE_MESSAGE_SIZE);
+        return MSG_PROCESS_ERROR;
+    }
+
+    if (!ssl_expand_certificate(s, (int)alg, PACKET_data(&comp),
+                                PACKET_remaining(&comp), &buf,
+                                expected_len)) {
+        /* SSLfatal() already called */
+        return MSG_PROCESS_ERROR;
+    }
+    if (!PACKET_buf_init(&cert, buf, expected_len)) {
+        OPENSSL_free(buf);
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR,
+                 SSL_F_TLS_PROCESS_SERVER_COMPRESSED_CERTIFICATE,
+                 ERR_R_INTERNAL_ERROR);
+        return MSG_PROCESS_ERROR;
+    }
+
+    s->ext.server_cert_comp_alg = (int)alg;
+    ret = tls_process_server_certificate(s, &cert);
+    OPENSSL_free(buf);
+    return ret;
+}
+
 static int tls_process_ske_psk_preamble(SSL *s, PACKET *pkt)
 {
 #ifndef OPENSSL_NO_PSK
@@ -2890,7 +2964,8 @@ MSG_PROCESS_RETURN tls_process_new_session_ticket(SSL *s, PACKET *pkt)
      * elsewhere in OpenSSL. The session ID is set to the SHA256 hash of the
      * ticket.
      */
-    sha256 = EVP_MD_fetch(s->ctx->libctx, "SHA2-256", s->ctx->propq);
+    sha256 = EVP_MD_fetch_query(s->ctx->libctx, "SHA2-256",
+                                s->ctx->propq_query);
     if (sha256 == NULL) {
         SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_TLS_PROCESS_NEW_SESSION_TICKET,
                  SSL_R_ALGORITHM_FETCH_FAILED);
@@ -3928,25 +4003,13 @@ int ssl_do_client_cert_cb(SSL *s, X509 **px509, EVP_PKEY **ppkey)
     return i;
 }
 
-int ssl_cipher_list_to_bytes(SSL *s, STACK_OF(SSL_CIPHER) *sk, WPACKET *pkt)
+static int cipher_list_to_bytes(SSL *s, STACK_OF(SSL_CIPHER) *sk,
+                                WPACKET *pkt)
 {
     int i;
     size_t totlen = 0, len, maxlen, maxverok = 0;
     int empty_reneg_info_scsv = !s->renegotiate;
 
-    /* Set disabled masks for this session */
-    if (!ssl_set_client_disabled(s)) {
-        SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_CIPHER_LIST_TO_BYTES,
-                 SSL_R_NO_PROTOCOLS_AVAILABLE);
-        return 0;
-    }
-
-    if (sk == NULL) {
-        SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_CIPHER_LIST_TO_BYTES,
-                 ERR_R_INTERNAL_ERROR);
-        return 0;
-    }
-
 #ifdef OPENSSL_MAX_TLS1_2_CIPHER_LENGTH
 # if OPENSSL_MAX_TLS1_2_CIPHER_LENGTH < 6
 #  error Max cipher length too short
@@ -4035,6 +4098,173 @@ int ssl_cipher_list_to_bytes(SSL *s, STACK_OF(SSL_CIPHER) *sk, WPACKET *pkt)
     return 1;
 }
 
+/* Which of the signalling cipher suites |s| needs to add */
+static int client_hello_scsv(SSL *s)
+{
+    return (s->renegotiate ? 0 : 1)
+           | ((s->mode & SSL_MODE_SEND_FALLBACK_SCSV) != 0 ? 2 : 0);
+}
+
+/*
+ * Returns 1 if the ClientHello template |t| for |field| was made with the
+ * same parameters as are in use by |s| now.
+ */
+static int client_hello_template_match(SSL *s, int field,
+                                       const SSL_CLIENT_HELLO_TEMPLATE *t)
+{
+    return t->method == s->method
+           && t->version == s->version
+           && t->min_ver == s->s3.tmp.min_ver
+           && t->max_ver == s->s3.tmp.max_ver
+           && t->mask_k == s->s3.tmp.mask_k
+           && t->mask_a == s->s3.tmp.mask_a
+           && t->sec_level == SSL_get_security_level(s)
+           && t->suiteb == tls1_suiteb(s)
+           && t->scsv == (field == SSL_CLIENT_HELLO_CIPHERS
+                          ? client_hello_scsv(s) : 0);
+}
+
+/* The number of complete ClientHello templates for |field| in |ctx| */
+static int client_hello_template_num(SSL_CTX *ctx, int field)
+{
+#ifdef tsan_ld_acq
+    return tsan_ld_acq(&ctx->num_client_hello_templates[field]);
+#else
+    int num;
+
+    if (!CRYPTO_THREAD_read_lock(ctx->lock))
+        return 0;
+    num = ctx->num_client_hello_templates[field];
+    CRYPTO_THREAD_unlock(ctx->lock);
+    return num;
+#endif
+}
+
+/*
+ * Write the ClientHello |field| to |pkt|, either from a template in the
+ * SSL_CTX or by calling |build|, which then calls SSLfatal() if it fails.
+ * The caller must have checked that |field| only depends on the SSL_CTX wide
+ * configuration and the parameters recorded in the template.
+ */
+int ssl_construct_client_hello_field(SSL *s, int field,
+                                     int (*build)(SSL *s, WPACKET *pkt),
+                                     WPACKET *pkt)
+{
+    SSL_CTX *ctx = s->ctx;
+    SSL_CLIENT_HELLO_TEMPLATE *t;
+    BUF_MEM *buf = NULL;
+    WPACKET tmppkt;
+    size_t len;
+    int i, num, ok = 0;
+
+    num = client_hello_template_num(ctx, field);
+    for (i = 0; i < num; i++) {
+        t = &ctx->client_hello_templates[field][i];
+        if (client_hello_template_match(s, field, t)) {
+            if (!WPACKET_memcpy(pkt, t->data, t->len)) {
+                SSLfatal(s, SSL_AD_INTERNAL_ERROR, 0, ERR_R_INTERNAL_ERROR);
+                return 0;
+            }
+            return 1;
+        }
+    }
+
+    if ((buf = BUF_MEM_new()) == NULL || !WPACKET_init(&tmppkt, buf)) {
+        BUF_MEM_free(buf);
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR, 0, ERR_R_MALLOC_FAILURE);
+        return 0;
+    }
+    if (!build(s, &tmppkt)) {
+        /* SSLfatal() already called */
+        WPACKET_cleanup(&tmppkt);
+        goto err;
+    }
+    if (!WPACKET_get_total_written(&tmppkt, &len)
+            || !WPACKET_finish(&tmppkt)
+            || !WPACKET_memcpy(pkt, buf->data, len)) {
+        WPACKET_cleanup(&tmppkt);
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR, 0, ERR_R_INTERNAL_ERROR);
+        goto err;
+    }
+    ok = 1;
+
+    /*
+     * Failing to add the template isn't fatal, and once all slots are used we
+     * just don't add any more. Another thread may have added the same one
+     * since we looked.
+     */
+    if (num < SSL_CLIENT_HELLO_TEMPLATES_MAX
+            && CRYPTO_THREAD_write_lock(ctx->lock)) {
+        num = ctx->num_client_hello_templates[field];
+        for (i = 0; i < num; i++) {
+            t = &ctx->client_hello_templates[field][i];
+            if (client_hello_template_match(s, field, t))
+                break;
+        }
+        if (i == num && num < SSL_CLIENT_HELLO_TEMPLATES_MAX) {
+            t = &ctx->client_hello_templates[field][num];
+            t->data = (unsigned char *)buf->data;
+            t->len = len;
+            buf->data = NULL;
+            t->method = s->method;
+            t->version = s->version;
+            t->min_ver = s->s3.tmp.min_ver;
+            t->max_ver = s->s3.tmp.max_ver;
+            t->mask_k = s->s3.tmp.mask_k;
+            t->mask_a = s->s3.tmp.mask_a;
+            t->sec_level = SSL_get_security_level(s);
+            t->suiteb = tls1_suiteb(s);
+            t->scsv = field == SSL_CLIENT_HELLO_CIPHERS ? client_hello_scsv(s)
+                                                        : 0;
+#ifdef tsan_st_rel
+            tsan_st_rel(&ctx->num_client_hello_templates[field], num + 1);
+#else
+            ctx->num_client_hello_templates[field] = num + 1;
+#endif
+        }
+        CRYPTO_THREAD_unlock(ctx->lock);
+    }
+ err:
+    BUF_MEM_free(buf);
+    return ok;
+}
+
+/*
+ * Returns 1 if the ClientHello fields of |s| that depend on the cipher list
+ * and the security callback can come from a template of the SSL_CTX.
+ */
+int ssl_client_hello_ciphers_static(SSL *s)
+{
+    return SSL_get_ciphers(s) == s->ctx->cipher_list
+           && ssl_cert_default_security(s->cert);
+}
+
+static int ctx_cipher_list_to_bytes(SSL *s, WPACKET *pkt)
+{
+    return cipher_list_to_bytes(s, s->ctx->cipher_list, pkt);
+}
+
+int ssl_cipher_list_to_bytes(SSL *s, STACK_OF(SSL_CIPHER) *sk, WPACKET *pkt)
+{
+    /* Set disabled masks for this session */
+    if (!ssl_set_client_disabled(s)) {
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_CIPHER_LIST_TO_BYTES,
+                 SSL_R_NO_PROTOCOLS_AVAILABLE);
+        return 0;
+    }
+
+    if (sk == NULL) {
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_CIPHER_LIST_TO_BYTES,
+                 ERR_R_INTERNAL_ERROR);
+        return 0;
+    }
+
+    if (sk != s->ctx->cipher_list || !ssl_client_hello_ciphers_static(s))
+        return cipher_list_to_bytes(s, sk, pkt);
+    return ssl_construct_client_hello_field(s, SSL_CLIENT_HELLO_CIPHERS,
+                                            ctx_cipher_list_to_bytes, pkt);
+}
+
 int tls_construct_end_of_early_data(SSL *s, WPACKET *pkt)
 {
     if (s->early_data_state != SSL_EARLY_DATA_WRITE_RETRY
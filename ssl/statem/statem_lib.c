@@ -96,6 +96,8 @@ int tls_setup_handshake(SSL *s)
 
     /* Reset any extension flags */
     memset(s->ext.extflags, 0, sizeof(s->ext.extflags));
+    s->ext.server_cert_comp_alg = TLSEXT_comp_cert_none;
+    s->ext.compress_certificate_sel = TLSEXT_comp_cert_none;
 
     if (s->server) {
         STACK_OF(SSL_CIPHER) *ciphers = SSL_get_ciphers(s);
@@ -923,6 +925,122 @@ static int ssl_add_cert_to_wpacket(SSL *s, WPACKET *pkt, X509 *x, int chain)
     return 1;
 }
 
+/*
+ * Get the encoded certificate_list for |cpk| from its cache, creating it first
+ * if necessary. The certificates are |cpk->x509| followed by |cpk->chain|.
+ */
+static int ssl_get_cached_cert_chain(SSL *s, CERT_PKEY *cpk,
+                                     const unsigned char **chain,
+                                     size_t *chain_len)
+{
+    SSL_CERT_CACHE *cache = cpk->cache;
+    BUF_MEM *buf = NULL;
+    WPACKET tmppkt;
+    unsigned char *outbytes;
+    X509 *x;
+    size_t len;
+    int i, derlen;
+
+    if (ssl_cert_cache_get_flag(cache, &cache->chain_cached)) {
+        *chain = cache->chain;
+        *chain_len = cache->chain_len;
+        return 1;
+    }
+
+    if ((buf = BUF_MEM_new()) == NULL || !WPACKET_init(&tmppkt, buf)) {
+        BUF_MEM_free(buf);
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_GET_CACHED_CERT_CHAIN,
+                 ERR_R_MALLOC_FAILURE);
+        return 0;
+    }
+    for (i = -1; i < sk_X509_num(cpk->chain); i++) {
+        x = i < 0 ? cpk->x509 : sk_X509_value(cpk->chain, i);
+        derlen = i2d_X509(x, NULL);
+        if (derlen < 0
+                || !WPACKET_sub_allocate_bytes_u24(&tmppkt, derlen, &outbytes)
+                || i2d_X509(x, &outbytes) != derlen) {
+            WPACKET_cleanup(&tmppkt);
+            BUF_MEM_free(buf);
+            SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_GET_CACHED_CERT_CHAIN,
+                     ERR_R_INTERNAL_ERROR);
+            return 0;
+        }
+    }
+    if (!WPACKET_get_total_written(&tmppkt, &len)
+            || !WPACKET_finish(&tmppkt)
+            || !CRYPTO_THREAD_write_lock(cache->lock)) {
+        WPACKET_cleanup(&tmppkt);
+        BUF_MEM_free(buf);
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_GET_CACHED_CERT_CHAIN,
+                 ERR_R_INTERNAL_ERROR);
+        return 0;
+    }
+    /* Another thread may have got here first, in which case use theirs */
+    if (!cache->chain_cached) {
+        cache->chain = (unsigned char *)buf->data;
+        cache->chain_len = len;
+        buf->data = NULL;
+        ssl_cert_cache_set_flag(&cache->chain_cached, 1);
+    }
+    *chain = cache->chain;
+    *chain_len = cache->chain_len;
+    CRYPTO_THREAD_unlock(cache->lock);
+    BUF_MEM_free(buf);
+
+    return 1;
+}
+
+/*
+ * Add the certificate chain of |cpk| to |pkt| using its cached encoding. Only
+ * the TLSv1.3 per-certificate extensions need to be constructed each time.
+ */
+static int ssl_add_cached_cert_chain(SSL *s, WPACKET *pkt, CERT_PKEY *cpk)
+{
+    const unsigned char *chain, *cert;
+    size_t chain_len, chainidx;
+    unsigned long certlen;
+    PACKET certs;
+    X509 *x;
+
+    if (!ssl_get_cached_cert_chain(s, cpk, &chain, &chain_len)) {
+        /* SSLfatal() already called */
+        return 0;
+    }
+
+    if (!SSL_IS_TLS13(s)) {
+        if (!WPACKET_memcpy(pkt, chain, chain_len)) {
+            SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_ADD_CACHED_CERT_CHAIN,
+                     ERR_R_INTERNAL_ERROR);
+            return 0;
+        }
+        return 1;
+    }
+
+    if (!PACKET_buf_init(&certs, chain, chain_len)) {
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_ADD_CACHED_CERT_CHAIN,
+                 ERR_R_INTERNAL_ERROR);
+        return 0;
+    }
+    for (chainidx = 0; PACKET_remaining(&certs) > 0; chainidx++) {
+        x = chainidx == 0 ? cpk->x509
+                          : sk_X509_value(cpk->chain, (int)chainidx - 1);
+        if (!PACKET_peek_net_3(&certs, &certlen)
+                || !PACKET_get_bytes(&certs, &cert, certlen + 3)
+                || !WPACKET_memcpy(pkt, cert, certlen + 3)) {
+            SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_ADD_CACHED_CERT_CHAIN,
+                     ERR_R_INTERNAL_ERROR);
+            return 0;
+        }
+        if (!tls_construct_extensions(s, pkt, SSL_EXT_TLS1_3_CERTIFICATE, x,
+                                      chainidx)) {
+            /* SSLfatal() already called */
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
 /* Add certificate chain to provided WPACKET */
 static int ssl_add_cert_chain(SSL *s, WPACKET *pkt, CERT_PKEY *cpk)
 {
@@ -999,6 +1117,17 @@ static int ssl_add_cert_chain(SSL *s, WPACKET *pkt, CERT_PKEY *cpk)
             }
         }
         X509_STORE_CTX_free(xs_ctx);
+    } else if (cpk->cache != NULL && extra_certs == cpk->chain) {
+        /*
+         * The legacy SSL_CTX wide extra certs can change independently of
+         * |cpk|, so we only cache certificates with their own chain.
+         */
+        i = ssl_security_cert_pkey_chain(s, cpk);
+        if (i != 1) {
+            SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_SSL_ADD_CERT_CHAIN, i);
+            return 0;
+        }
+        return ssl_add_cached_cert_chain(s, pkt, cpk);
     } else {
         i = ssl_security_cert_chain(s, extra_certs, x, 0);
         if (i != 1) {
@@ -1040,6 +1169,38 @@ unsigned long ssl3_output_cert_chain(SSL *s, WPACKET *pkt, CERT_PKEY *cpk)
     return 1;
 }
 
+/*
+ * Returns 1 if the certificate_list that ssl3_output_cert_chain() writes for
+ * |cpk| on |s| depends on nothing but |cpk|, including any TLSv1.3
+ * per-certificate extensions. Anything derived from it can then be kept in
+ * |cpk->cache|, which is replaced whenever the certificate or chain changes.
+ */
+int ssl_cert_chain_is_static(SSL *s, CERT_PKEY *cpk)
+{
+    size_t i;
+
+    if (cpk == NULL || cpk->x509 == NULL || cpk->cache == NULL)
+        return 0;
+    /* See ssl_add_cert_chain() */
+    if (cpk->chain == NULL
+            && (s->ctx->extra_certs != NULL
+                || (s->mode & SSL_MODE_NO_AUTO_CHAIN) == 0))
+        return 0;
+
+    if (!SSL_IS_TLS13(s))
+        return 1;
+    if (s->ext.status_expected)
+        return 0;
+    for (i = 0; i < s->cert->custext.meths_count; i++) {
+        const custom_ext_method *meth = s->cert->custext.meths + i;
+
+        if ((meth->context & SSL_EXT_TLS1_3_CERTIFICATE) != 0
+                && (meth->ext_flags & SSL_EXT_FLAG_RECEIVED) != 0)
+            return 0;
+    }
+    return 1;
+}
+
 /*
  * Tidy up after the end of a handshake. In the case of SCTP this may result
  * in NBIO events. If |clearbufs| is set then init_buf and the wbio buffer is
@@ -1054,8 +1054,14 @@ int ossl_statem_server_construct_message(SSL *s, WPACKET *pkt,
         break;
 
     case TLS_ST_SW_CERT:
-        *confunc = tls_construct_server_certificate;
-        *mt = SSL3_MT_CERTIFICATE;
+        if (SSL_IS_TLS13(s)
+                && s->ext.compress_certificate_sel != TLSEXT_comp_cert_none) {
+            *confunc = tls_construct_server_compressed_certificate;
+            *mt = SSL3_MT_COMPRESSED_CERTIFICATE;
+        } else {
+            *confunc = tls_construct_server_certificate;
+            *mt = SSL3_MT_CERTIFICATE;
+        }
         break;
 
     case TLS_ST_SW_CERT_VRFY:
@@ -1968,6 +1974,7 @@ static int tls_early_post_process_client_hello(SSL *s)
             s->session->cipher = pref_cipher;
             sk_SSL_CIPHER_free(s->cipher_list);
             s->cipher_list = sk_SSL_CIPHER_dup(s->peer_ciphers);
+            ssl_cipher_set_from_list(&s->cipher_set, s->cipher_list);
             sk_SSL_CIPHER_free(s->cipher_list_by_id);
             s->cipher_list_by_id = sk_SSL_CIPHER_dup(s->peer_ciphers);
         }
@@ -3747,6 +3754,76 @@ int tls_construct_server_certificate(SSL *s, WPACKET *pkt)
     return 1;
 }
 
+/*
+ * Construct a TLSv1.3 CompressedCertificate message (RFC 8879). The ordinary
+ * Certificate message body is built and then compressed with the algorithm
+ * selected from the client's compress_certificate extension. If that body is
+ * fully determined by the certificate and its chain, this is done once and
+ * later handshakes send the cached result without building anything.
+ */
+int tls_construct_server_compressed_certificate(SSL *s, WPACKET *pkt)
+{
+    CERT_PKEY *cpk = s->s3.tmp.cert;
+    int alg = s->ext.compress_certificate_sel;
+    BUF_MEM *buf = NULL;
+    WPACKET cpkt;
+    size_t len;
+    int ret = 0, cacheable, i;
+
+    cacheable = ssl_cert_chain_is_static(s, cpk);
+    if (cacheable) {
+        /* Done by ssl_add_cert_chain() when the message is built */
+        i = ssl_security_cert_pkey_chain(s, cpk);
+        if (i != 1) {
+            SSLfatal(s, SSL_AD_INTERNAL_ERROR,
+                     SSL_F_TLS_CONSTRUCT_SERVER_COMPRESSED_CERTIFICATE, i);
+            return 0;
+        }
+        i = ssl_add_cached_compressed_certificate(s, cpk, alg, pkt);
+        if (i < 0) {
+            /* SSLfatal() already called */
+            return 0;
+        }
+        if (i > 0) {
+            s->ext.server_cert_comp_alg = alg;
+            return 1;
+        }
+    }
+
+    if ((buf = BUF_MEM_new()) == NULL
+            || !WPACKET_init(&cpkt, buf)) {
+        BUF_MEM_free(buf);
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR,
+                 SSL_F_TLS_CONSTRUCT_SERVER_COMPRESSED_CERTIFICATE,
+                 ERR_R_MALLOC_FAILURE);
+        return 0;
+    }
+    if (!tls_construct_server_certificate(s, &cpkt)) {
+        /* SSLfatal() already called */
+        WPACKET_cleanup(&cpkt);
+        goto err;
+    }
+    if (!WPACKET_get_total_written(&cpkt, &len)
+            || !WPACKET_finish(&cpkt)) {
+        WPACKET_cleanup(&cpkt);
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR,
+                 SSL_F_TLS_CONSTRUCT_SERVER_COMPRESSED_CERTIFICATE,
+                 ERR_R_INTERNAL_ERROR);
+        goto err;
+    }
+    if (!ssl_compress_certificate(s, cacheable ? cpk : NULL, alg,
+                                  (unsigned char *)buf->data, len, pkt)) {
+        /* SSLfatal() already called */
+        goto err;
+    }
+
+    s->ext.server_cert_comp_alg = alg;
+    ret = 1;
+ err:
+    BUF_MEM_free(buf);
+    return ret;
+}
+
 static int create_ticket_prequel(SSL *s, WPACKET *pkt, uint32_t age_add,
                                  unsigned char *tick_nonce)
 {
@@ -3906,8 +3983,9 @@ static int construct_stateless_ticket(SSL *s, WPACKET *pkt, uint32_t age_add,
         }
         iv_len = EVP_CIPHER_CTX_iv_length(ctx);
     } else {
-        EVP_CIPHER *cipher = EVP_CIPHER_fetch(s->ctx->libctx, "AES-256-CBC",
-                                              s->ctx->propq);
+        EVP_CIPHER *cipher = EVP_CIPHER_fetch_query(s->ctx->libctx,
+                                                    "AES-256-CBC",
+                                                    s->ctx->propq_query);
 
         if (cipher == NULL) {
             SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_F_CONSTRUCT_STATELESS_TICKET,
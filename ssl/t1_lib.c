@@ -181,6 +181,9 @@ static const TLS_GROUP_INFO nid_list[] = {
     {NID_ffdhe8192, 192, TLS_GROUP_FFDHE_FOR_TLS1_3, 0x0104}, /* ffdhe8192 (0x0104) */
 # endif /* OPENSSL_NO_DH */
 };
+
+/* Every group must have its own bit in a tls1_group_set() */
+typedef char tls1_group_set_check[OSSL_NELEM(nid_list) <= 64 ? 1 : -1];
 #endif
 
 #ifndef OPENSSL_NO_EC
@@ -218,15 +221,47 @@ static const uint16_t suiteb_curves[] = {
 };
 #endif
 
+/*
+ * Groups and sigalgs are looked up by their 16 bit code point for every entry
+ * of every list a peer sends, so instead of scanning nid_list and
+ * sigalg_lookup_tbl we keep open addressed hash tables mapping each code point
+ * to its index in the table plus one, with 0 for an empty slot. They are
+ * filled in by tls1_init_lookup_tables() when libssl is initialised.
+ */
+#define TLS_LOOKUP_SLOTS 128    /* A power of 2, at least twice the entries */
+
+#if !defined(OPENSSL_NO_DH) || !defined(OPENSSL_NO_EC)
+static unsigned char group_index[TLS_LOOKUP_SLOTS];
+typedef char group_index_check[OSSL_NELEM(nid_list) <= TLS_LOOKUP_SLOTS / 2
+                               ? 1 : -1];
+#endif
+static unsigned char sigalg_index[TLS_LOOKUP_SLOTS];
+
+static size_t tls_lookup_hash(uint16_t code)
+{
+    return ((code * 0x9E37UL) >> 9) & (TLS_LOOKUP_SLOTS - 1);
+}
+
+static void tls_lookup_insert(unsigned char *index, uint16_t code, size_t i)
+{
+    size_t h;
+
+    for (h = tls_lookup_hash(code); index[h] != 0;
+         h = (h + 1) & (TLS_LOOKUP_SLOTS - 1))
+        continue;
+    index[h] = (unsigned char)(i + 1);
+}
+
 const TLS_GROUP_INFO *tls1_group_id_lookup(uint16_t group_id)
 {
 #if !defined(OPENSSL_NO_DH) || !defined(OPENSSL_NO_EC)
-    size_t i;
+    size_t h;
 
     /* ECC curves from RFC 4492 and RFC 7027 FFDHE group from RFC 8446 */
-    for (i = 0; i < OSSL_NELEM(nid_list); i++) {
-        if (nid_list[i].group_id == group_id)
-            return &nid_list[i];
+    for (h = tls_lookup_hash(group_id); group_index[h] != 0;
+         h = (h + 1) & (TLS_LOOKUP_SLOTS - 1)) {
+        if (nid_list[group_index[h] - 1].group_id == group_id)
+            return &nid_list[group_index[h] - 1];
     }
 #endif /* !defined(OPENSSL_NO_DH) || !defined(OPENSSL_NO_EC) */
     return NULL;
@@ -327,14 +362,56 @@ int tls_group_allowed(SSL *s, uint16_t group, int op)
     return ssl_security(s, op, ginfo->secbits, ginfo->nid, (void *)gtmp);
 }
 
-/* Return 1 if "id" is in "list" */
-static int tls1_in_list(uint16_t id, const uint16_t *list, size_t listlen)
+/* Return the bit for |group_id| in a tls1_group_set(), or 0 if it is unknown */
+static uint64_t tls1_group_bit(uint16_t group_id)
+{
+#if !defined(OPENSSL_NO_DH) || !defined(OPENSSL_NO_EC)
+    const TLS_GROUP_INFO *ginf = tls1_group_id_lookup(group_id);
+
+    if (ginf != NULL)
+        return (uint64_t)1 << (ginf - nid_list);
+#endif
+    return 0;
+}
+
+/*
+ * Return the groups in |groups| as a bitmap with a bit for each known group,
+ * so that a group can be found in it without a search. Unknown groups are
+ * left out: they are never shared anyway.
+ */
+uint64_t tls1_group_set(const uint16_t *groups, size_t ngroups)
 {
+    uint64_t set = 0;
     size_t i;
-    for (i = 0; i < listlen; i++)
-        if (list[i] == id)
-            return 1;
+
+    for (i = 0; i < ngroups; i++)
+        set |= tls1_group_bit(groups[i]);
+    return set;
+}
+
+/* Return the default supported groups as a tls1_group_set() */
+uint64_t tls1_default_group_set(void)
+{
+#if !defined(OPENSSL_NO_DH) || !defined(OPENSSL_NO_EC)
+    return tls1_group_set(supported_groups_default,
+                          OSSL_NELEM(supported_groups_default));
+#else
     return 0;
+#endif
+}
+
+/* Return our supported groups as a tls1_group_set() */
+static uint64_t tls1_get_supported_group_set(SSL *s)
+{
+    const uint16_t *groups;
+    size_t ngroups;
+
+    /* The Suite B lists are short and not kept as a set */
+    if (tls1_suiteb(s)) {
+        tls1_get_supported_groups(s, &groups, &ngroups);
+        return tls1_group_set(groups, ngroups);
+    }
+    return s->ext.supportedgroups_set;
 }
 
 /*-
@@ -346,8 +423,9 @@ static int tls1_in_list(uint16_t id, const uint16_t *list, size_t listlen)
  */
 uint16_t tls1_shared_group(SSL *s, int nmatch)
 {
-    const uint16_t *pref, *supp;
-    size_t num_pref, num_supp, i;
+    const uint16_t *pref;
+    size_t num_pref, i;
+    uint64_t supp;
     int k;
 
     /* Can't do anything on client side */
@@ -377,16 +455,16 @@ uint16_t tls1_shared_group(SSL *s, int nmatch)
      */
     if (s->options & SSL_OP_CIPHER_SERVER_PREFERENCE) {
         tls1_get_supported_groups(s, &pref, &num_pref);
-        tls1_get_peer_groups(s, &supp, &num_supp);
+        supp = s->ext.peer_supportedgroups_set;
     } else {
         tls1_get_peer_groups(s, &pref, &num_pref);
-        tls1_get_supported_groups(s, &supp, &num_supp);
+        supp = tls1_get_supported_group_set(s);
     }
 
     for (k = 0, i = 0; i < num_pref; i++) {
         uint16_t id = pref[i];
 
-        if (!tls1_in_list(id, supp, num_supp)
+        if ((supp & tls1_group_bit(id)) == 0
             || !tls_group_allowed(s, id, SSL_SECOP_CURVE_SHARED))
                     continue;
         if (nmatch == k)
@@ -399,7 +477,7 @@ uint16_t tls1_shared_group(SSL *s, int nmatch)
     return 0;
 }
 
-int tls1_set_groups(uint16_t **pext, size_t *pextlen,
+int tls1_set_groups(uint16_t **pext, size_t *pextlen, uint64_t *pset,
                     int *groups, size_t ngroups)
 {
 #if !defined(OPENSSL_NO_EC) || !defined(OPENSSL_NO_DH)
@@ -437,6 +515,7 @@ int tls1_set_groups(uint16_t **pext, size_t *pextlen,
     OPENSSL_free(*pext);
     *pext = glist;
     *pextlen = ngroups;
+    *pset = tls1_group_set(glist, ngroups);
     return 1;
 err:
     OPENSSL_free(glist);
@@ -486,7 +565,8 @@ static int nid_cb(const char *elem, int len, void *arg)
 #endif /* !defined(OPENSSL_NO_EC) || !defined(OPENSSL_NO_DH) */
 
 /* Set groups based on a colon separate list */
-int tls1_set_groups_list(uint16_t **pext, size_t *pextlen, const char *str)
+int tls1_set_groups_list(uint16_t **pext, size_t *pextlen, uint64_t *pset,
+                         const char *str)
 {
 #if !defined(OPENSSL_NO_EC) || !defined(OPENSSL_NO_DH)
     nid_cb_st ncb;
@@ -495,7 +575,7 @@ int tls1_set_groups_list(uint16_t **pext, size_t *pextlen, const char *str)
         return 0;
     if (pext == NULL)
         return 1;
-    return tls1_set_groups(pext, pextlen, ncb.nid_arr, ncb.nidcnt);
+    return tls1_set_groups(pext, pextlen, pset, ncb.nid_arr, ncb.nidcnt);
 #else
     return 0;
 #endif
@@ -528,8 +608,7 @@ int tls1_check_group_id(SSL *s, uint16_t group_id, int check_own_groups)
 
     if (check_own_groups) {
         /* Check group is one of our preferences */
-        tls1_get_supported_groups(s, &groups, &groups_len);
-        if (!tls1_in_list(group_id, groups, groups_len))
+        if ((tls1_get_supported_group_set(s) & tls1_group_bit(group_id)) == 0)
             return 0;
     }
 
@@ -551,7 +630,7 @@ int tls1_check_group_id(SSL *s, uint16_t group_id, int check_own_groups)
      */
     if (groups_len == 0)
             return 1;
-    return tls1_in_list(group_id, groups, groups_len);
+    return (s->ext.peer_supportedgroups_set & tls1_group_bit(group_id)) != 0;
 }
 
 #ifndef OPENSSL_NO_EC
@@ -855,6 +934,11 @@ static const SIGALG_LOOKUP sigalg_lookup_tbl[] = {
      NID_undef, NID_undef}
 #endif
 };
+
+/* Every sigalg must have its own bit in a tls12_sigalg_set() */
+typedef char tls12_sigalg_set_check[OSSL_NELEM(sigalg_lookup_tbl) <= 64
+                                    ? 1 : -1];
+
 /* Legacy sigalgs for TLS < 1.2 RSA TLS signatures */
 static const SIGALG_LOOKUP legacy_rsa_sigalg = {
     "rsa_pkcs1_md5_sha1", 0,
@@ -879,19 +963,61 @@ static const uint16_t tls_default_sigalg[] = {
     0, /* SSL_PKEY_ED448 */
 };
 
-/* Lookup TLS signature algorithm */
-static const SIGALG_LOOKUP *tls1_lookup_sigalg(uint16_t sigalg)
+typedef char sigalg_index_check[OSSL_NELEM(sigalg_lookup_tbl)
+                                <= TLS_LOOKUP_SLOTS / 2 ? 1 : -1];
+
+/* Fill in the lookup tables for groups and sigalgs */
+void tls1_init_lookup_tables(void)
 {
     size_t i;
-    const SIGALG_LOOKUP *s;
 
-    for (i = 0, s = sigalg_lookup_tbl; i < OSSL_NELEM(sigalg_lookup_tbl);
-         i++, s++) {
-        if (s->sigalg == sigalg)
-            return s;
+#if !defined(OPENSSL_NO_DH) || !defined(OPENSSL_NO_EC)
+    for (i = 0; i < OSSL_NELEM(nid_list); i++)
+        tls_lookup_insert(group_index, nid_list[i].group_id, i);
+#endif
+    for (i = 0; i < OSSL_NELEM(sigalg_lookup_tbl); i++)
+        tls_lookup_insert(sigalg_index, sigalg_lookup_tbl[i].sigalg, i);
+}
+
+/* Lookup TLS signature algorithm */
+const SIGALG_LOOKUP *tls1_lookup_sigalg(uint16_t sigalg)
+{
+    size_t h;
+
+    for (h = tls_lookup_hash(sigalg); sigalg_index[h] != 0;
+         h = (h + 1) & (TLS_LOOKUP_SLOTS - 1)) {
+        if (sigalg_lookup_tbl[sigalg_index[h] - 1].sigalg == sigalg)
+            return &sigalg_lookup_tbl[sigalg_index[h] - 1];
     }
     return NULL;
 }
+
+/* Return the bit for |lu| in a tls12_sigalg_set(), or 0 if |lu| is NULL */
+static uint64_t tls12_sigalg_bit(const SIGALG_LOOKUP *lu)
+{
+    return lu == NULL ? 0 : (uint64_t)1 << (lu - sigalg_lookup_tbl);
+}
+
+/*
+ * Return the sigalgs in |psig| as a bitmap with a bit for each known sigalg,
+ * so that a sigalg can be found in it without a search. Unknown sigalgs are
+ * left out: they are never shared anyway.
+ */
+uint64_t tls12_sigalg_set(const uint16_t *psig, size_t psiglen)
+{
+    uint64_t set = 0;
+    size_t i;
+
+    for (i = 0; i < psiglen; i++)
+        set |= tls12_sigalg_bit(tls1_lookup_sigalg(psig[i]));
+    return set;
+}
+
+/* Return the default sigalgs as a tls12_sigalg_set() */
+uint64_t tls12_default_sigalg_set(void)
+{
+    return tls12_sigalg_set(tls12_sigalgs, OSSL_NELEM(tls12_sigalgs));
+}
 /* Lookup hash: return 0 if invalid or not enabled */
 int tls1_lookup_md(SSL_CTX *ctx, const SIGALG_LOOKUP *lu, const EVP_MD **pmd)
 {
@@ -1530,8 +1656,8 @@ SSL_TICKET_STATUS tls_decrypt_ticket(SSL *s, const unsigned char *etick,
             goto end;
         }
 
-        aes256cbc = EVP_CIPHER_fetch(s->ctx->libctx, "AES-256-CBC",
-                                     s->ctx->propq);
+        aes256cbc = EVP_CIPHER_fetch_query(s->ctx->libctx, "AES-256-CBC",
+                                           s->ctx->propq_query);
         if (aes256cbc == NULL
             || ssl_hmac_init(hctx, tctx->ext.secure->tick_hmac_key,
                              sizeof(tctx->ext.secure->tick_hmac_key),
@@ -1833,24 +1959,21 @@ int tls12_copy_sigalgs(SSL *s, WPACKET *pkt,
 /* Given preference and allowed sigalgs set shared sigalgs */
 static size_t tls12_shared_sigalgs(SSL *s, const SIGALG_LOOKUP **shsig,
                                    const uint16_t *pref, size_t preflen,
-                                   const uint16_t *allow, size_t allowlen)
+                                   uint64_t allow)
 {
-    const uint16_t *ptmp, *atmp;
-    size_t i, j, nmatch = 0;
+    const uint16_t *ptmp;
+    size_t i, nmatch = 0;
     for (i = 0, ptmp = pref; i < preflen; i++, ptmp++) {
         const SIGALG_LOOKUP *lu = tls1_lookup_sigalg(*ptmp);
 
         /* Skip disabled hashes or signature algorithms */
         if (!tls12_sigalg_allowed(s, SSL_SECOP_SIGALG_SHARED, lu))
             continue;
-        for (j = 0, atmp = allow; j < allowlen; j++, atmp++) {
-            if (*ptmp == *atmp) {
-                nmatch++;
-                if (shsig)
-                    *shsig++ = lu;
-                break;
-            }
-        }
+        if ((allow & tls12_sigalg_bit(lu)) == 0)
+            continue;
+        nmatch++;
+        if (shsig)
+            *shsig++ = lu;
     }
     return nmatch;
 }
@@ -1858,8 +1981,9 @@ static size_t tls12_shared_sigalgs(SSL *s, const SIGALG_LOOKUP **shsig,
 /* Set shared signature algorithms for SSL structures */
 static int tls1_set_shared_sigalgs(SSL *s)
 {
-    const uint16_t *pref, *allow, *conf;
-    size_t preflen, allowlen, conflen;
+    const uint16_t *pref, *conf;
+    size_t preflen, conflen;
+    uint64_t allow, conf_set;
     size_t nmatch;
     const SIGALG_LOOKUP **salgs = NULL;
     CERT *c = s->cert;
@@ -1872,29 +1996,33 @@ static int tls1_set_shared_sigalgs(SSL *s)
     if (!s->server && c->client_sigalgs && !is_suiteb) {
         conf = c->client_sigalgs;
         conflen = c->client_sigalgslen;
+        conf_set = c->client_sigalgs_set;
     } else if (c->conf_sigalgs && !is_suiteb) {
         conf = c->conf_sigalgs;
         conflen = c->conf_sigalgslen;
-    } else
+        conf_set = c->conf_sigalgs_set;
+    } else {
         conflen = tls12_get_psigalgs(s, 0, &conf);
+        /* The Suite B lists are short and not kept as a set */
+        conf_set = is_suiteb ? tls12_sigalg_set(conf, conflen)
+                             : c->conf_sigalgs_set;
+    }
     if (s->options & SSL_OP_CIPHER_SERVER_PREFERENCE || is_suiteb) {
         pref = conf;
         preflen = conflen;
-        allow = s->s3.tmp.peer_sigalgs;
-        allowlen = s->s3.tmp.peer_sigalgslen;
+        allow = s->s3.tmp.peer_sigalgs_set;
     } else {
-        allow = conf;
-        allowlen = conflen;
+        allow = conf_set;
         pref = s->s3.tmp.peer_sigalgs;
         preflen = s->s3.tmp.peer_sigalgslen;
     }
-    nmatch = tls12_shared_sigalgs(s, NULL, pref, preflen, allow, allowlen);
+    nmatch = tls12_shared_sigalgs(s, NULL, pref, preflen, allow);
     if (nmatch) {
         if ((salgs = OPENSSL_malloc(nmatch * sizeof(*salgs))) == NULL) {
             SSLerr(SSL_F_TLS1_SET_SHARED_SIGALGS, ERR_R_MALLOC_FAILURE);
             return 0;
         }
-        nmatch = tls12_shared_sigalgs(s, salgs, pref, preflen, allow, allowlen);
+        nmatch = tls12_shared_sigalgs(s, salgs, pref, preflen, allow);
     } else {
         salgs = NULL;
     }
@@ -1948,9 +2076,12 @@ int tls1_save_sigalgs(SSL *s, PACKET *pkt, int cert)
     if (cert)
         return tls1_save_u16(pkt, &s->s3.tmp.peer_cert_sigalgs,
                              &s->s3.tmp.peer_cert_sigalgslen);
-    else
-        return tls1_save_u16(pkt, &s->s3.tmp.peer_sigalgs,
-                             &s->s3.tmp.peer_sigalgslen);
+    if (!tls1_save_u16(pkt, &s->s3.tmp.peer_sigalgs,
+                       &s->s3.tmp.peer_sigalgslen))
+        return 0;
+    s->s3.tmp.peer_sigalgs_set = tls12_sigalg_set(s->s3.tmp.peer_sigalgs,
+                                                  s->s3.tmp.peer_sigalgslen);
+    return 1;
 
 }
 
@@ -2157,10 +2288,12 @@ int tls1_set_raw_sigalgs(CERT *c, const uint16_t *psigs, size_t salglen,
         OPENSSL_free(c->client_sigalgs);
         c->client_sigalgs = sigalgs;
         c->client_sigalgslen = salglen;
+        c->client_sigalgs_set = tls12_sigalg_set(sigalgs, salglen);
     } else {
         OPENSSL_free(c->conf_sigalgs);
         c->conf_sigalgs = sigalgs;
         c->conf_sigalgslen = salglen;
+        c->conf_sigalgs_set = tls12_sigalg_set(sigalgs, salglen);
     }
 
     return 1;
@@ -2199,10 +2332,12 @@ int tls1_set_sigalgs(CERT *c, const int *psig_nids, size_t salglen, int client)
         OPENSSL_free(c->client_sigalgs);
         c->client_sigalgs = sigalgs;
         c->client_sigalgslen = salglen / 2;
+        c->client_sigalgs_set = tls12_sigalg_set(sigalgs, salglen / 2);
     } else {
         OPENSSL_free(c->conf_sigalgs);
         c->conf_sigalgs = sigalgs;
         c->conf_sigalgslen = salglen / 2;
+        c->conf_sigalgs_set = tls12_sigalg_set(sigalgs, salglen / 2);
     }
 
     return 1;
@@ -2672,6 +2807,35 @@ int ssl_security_cert_chain(SSL *s, STACK_OF(X509) *sk, X509 *x, int vfy)
     return 1;
 }
 
+/*
+ * Check our certificate and explicit chain in |cpk| with
+ * ssl_security_cert_chain(). The default security callback only looks at the
+ * security level, so with that a pass is remembered in the cache of |cpk|,
+ * which is replaced whenever the certificate or chain changes.
+ */
+int ssl_security_cert_pkey_chain(SSL *s, CERT_PKEY *cpk)
+{
+    SSL_CERT_CACHE *cache = cpk->cache;
+    int level, bit = 0, rv;
+
+    if (ssl_cert_default_security(s->cert)) {
+        /* The default callback treats all levels above 5 like 5 */
+        level = SSL_get_security_level(s);
+        bit = 1 << (level < 0 ? 0 : level > 5 ? 5 : level);
+        if ((ssl_cert_cache_get_flag(cache, &cache->sec_levels_ok) & bit) != 0)
+            return 1;
+    }
+
+    rv = ssl_security_cert_chain(s, cpk->chain, cpk->x509, 0);
+
+    /* Failing to update the cache isn't fatal, we'll just check next time */
+    if (rv == 1 && bit != 0 && CRYPTO_THREAD_write_lock(cache->lock)) {
+        ssl_cert_cache_set_flag(&cache->sec_levels_ok, bit);
+        CRYPTO_THREAD_unlock(cache->lock);
+    }
+    return rv;
+}
+
 /*
  * For TLS 1.2 servers check if we have a certificate which can be used
  * with the signature algorithm "lu" and return index of certificate.
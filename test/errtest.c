@@ -7,8 +7,13 @@
  * https://www.openssl.org/source/license.html
  */
 
+#include <string.h>
+#include <limits.h>
+#include <time.h>
 #include <openssl/opensslconf.h>
 #include <openssl/err.h>
+#include <openssl/bio.h>
+#include <openssl/evp.h>
 
 #include "testutil.h"
 
@@ -74,10 +79,148 @@ static int raised_error(void)
     return 1;
 }
 
+/* Test that error data formats come out the same as with BIO_snprintf() */
+static int raised_error_data_formats(void)
+{
+    static char long_str[ERR_MAX_DATA_SIZE * 2];
+    char expected[ERR_MAX_DATA_SIZE];
+    const char *data, *none = NULL;
+
+    ERR_raise_data(ERR_LIB_SYS, ERR_R_INTERNAL_ERROR,
+                   "%s, Algorithm (%s), Properties (%s)", "unsupported",
+                   "SHA2-256", none);
+    BIO_snprintf(expected, sizeof(expected),
+                 "%s, Algorithm (%s), Properties (%s)", "unsupported",
+                 "SHA2-256", none);
+    ERR_peek_last_error_data(&data, NULL);
+    if (!TEST_str_eq(data, expected))
+        goto err;
+
+    ERR_raise_data(ERR_LIB_SYS, ERR_R_INTERNAL_ERROR,
+                   "%d %d %d %u %u 100%%", 0, INT_MIN, INT_MAX, 0U, UINT_MAX);
+    BIO_snprintf(expected, sizeof(expected),
+                 "%d %d %d %u %u 100%%", 0, INT_MIN, INT_MAX, 0U, UINT_MAX);
+    ERR_peek_last_error_data(&data, NULL);
+    if (!TEST_str_eq(data, expected))
+        goto err;
+
+    /* Too long data is cut short */
+    memset(long_str, 'x', sizeof(long_str) - 1);
+    ERR_raise_data(ERR_LIB_SYS, ERR_R_INTERNAL_ERROR, "<%s>", long_str);
+    ERR_peek_last_error_data(&data, NULL);
+    if (!TEST_size_t_eq(strlen(data), ERR_MAX_DATA_SIZE - 1)
+        || !TEST_char_eq(data[0], '<')
+        || !TEST_char_eq(data[ERR_MAX_DATA_SIZE - 2], 'x'))
+        goto err;
+
+    /* Appending still works on a reused buffer */
+    ERR_raise_data(ERR_LIB_SYS, ERR_R_INTERNAL_ERROR, "%s", "hello ");
+    ERR_add_error_data(1, "world");
+    ERR_peek_last_error_data(&data, NULL);
+    if (!TEST_str_eq(data, "hello world"))
+        goto err;
+
+    ERR_clear_error();
+    return 1;
+ err:
+    ERR_clear_error();
+    return 0;
+}
+
+/*
+ * Time error paths that raise errors only to throw them away, as failed
+ * fetches and failed verifications do.  This only reports the timings, it
+ * can't fail on them.
+ */
+#define ERROR_PATH_ROUNDS 5000
+
+enum {
+    ERROR_PATH_RAISE, ERROR_PATH_MARK, ERROR_PATH_FETCH, ERROR_PATH_PROVIDER,
+    ERROR_PATH_NUM
+};
+
+static const char *error_path_names[ERROR_PATH_NUM] = {
+    "ERR_raise_data() + ERR_clear_error()",
+    "ERR_set_mark() + ERR_raise_data() + ERR_pop_to_mark()",
+    "failed EVP_MD_fetch() + ERR_clear_error()",
+    "provider bad decrypt + ERR_clear_error()"
+};
+
+/* Raise the kind of error a failed fetch raises */
+static void raise_fetch_error(void)
+{
+    ERR_raise_data(ERR_LIB_EVP, EVP_R_UNSUPPORTED_ALGORITHM,
+                   "%s, Algorithm (%s)", "unsupported", "SHA2-256");
+}
+
+/* Returns 1 if the error path |op| was taken as it should be */
+static int error_path(int op, EVP_CIPHER_CTX *ctx)
+{
+    static const unsigned char key[16], in[16];
+    unsigned char out[32];
+    EVP_MD *md;
+    int outl, ok;
+
+    switch (op) {
+    case ERROR_PATH_RAISE:
+        raise_fetch_error();
+        ok = ERR_peek_error() != 0;
+        break;
+    case ERROR_PATH_MARK:
+        ERR_set_mark();
+        raise_fetch_error();
+        /* With an empty queue there is no mark, and everything is popped */
+        ERR_pop_to_mark();
+        return ERR_peek_error() == 0;
+    case ERROR_PATH_FETCH:
+        md = EVP_MD_fetch(NULL, "nonexistent-digest", NULL);
+        ok = md == NULL;
+        EVP_MD_free(md);
+        break;
+    case ERROR_PATH_PROVIDER:
+        /* The zero block doesn't decrypt to valid padding with a zero key */
+        ok = EVP_DecryptInit_ex(ctx, EVP_aes_128_cbc(), NULL, key, in)
+             && EVP_DecryptUpdate(ctx, out, &outl, in, sizeof(in))
+             && !EVP_DecryptFinal_ex(ctx, out + outl, &outl);
+        break;
+    default:
+        return 0;
+    }
+    ok = ok && ERR_peek_error() != 0;
+    ERR_clear_error();
+    return ok;
+}
+
+static int error_path_cost(int op)
+{
+    EVP_CIPHER_CTX *ctx = NULL;
+    clock_t start;
+    int i, ret = 0;
+
+    if (!TEST_ptr(ctx = EVP_CIPHER_CTX_new())
+            /* Once first, so that one-off setup isn't timed */
+            || !TEST_true(error_path(op, ctx)))
+        goto err;
+
+    start = clock();
+    for (i = 0; i < ERROR_PATH_ROUNDS; i++)
+        if (!TEST_true(error_path(op, ctx)))
+            goto err;
+    TEST_info("%s: %.0f ns", error_path_names[op],
+              (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC
+              / ERROR_PATH_ROUNDS);
+    ret = 1;
+ err:
+    EVP_CIPHER_CTX_free(ctx);
+    return ret;
+}
+
 int setup_tests(void)
 {
     ADD_TEST(preserves_system_error);
     ADD_TEST(vdata_appends);
     ADD_TEST(raised_error);
+    ADD_TEST(raised_error_data_formats);
+    ADD_ALL_TESTS(error_path_cost, ERROR_PATH_NUM);
     return 1;
 }
@@ -1540,6 +1540,425 @@ static int test_EVP_PKEY_set1_DH(void)
 }
 #endif
 
+/*
+ * Test that the methods implicitly fetched for legacy EVP_MDs and EVP_CIPHERs
+ * are reused across inits, including after the method store has changed.
+ */
+static int test_implicit_fetch(void)
+{
+    EVP_MD_CTX *mdctx = NULL;
+    EVP_CIPHER_CTX *cctx = NULL;
+    const EVP_CIPHER *cipher = NULL;
+    static const unsigned char key[16];
+    static const unsigned char msg[] = "abc";
+    static const unsigned char expected[] = {
+        0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea,
+        0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+        0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+        0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+    };
+#ifndef OPENSSL_NO_MD4
+    static const unsigned char expected_md4[] = {
+        0xa4, 0x48, 0x01, 0x7a, 0xaf, 0x21, 0xd8, 0x52,
+        0x5f, 0xc1, 0x0a, 0xe8, 0x7a, 0xa6, 0x72, 0x9d
+    };
+    OSSL_PROVIDER *legacy = NULL;
+#endif
+    unsigned char md[EVP_MAX_MD_SIZE];
+    unsigned int mdlen;
+    int i, ret = 0;
+
+    if (!TEST_ptr(mdctx = EVP_MD_CTX_new())
+            || !TEST_ptr(cctx = EVP_CIPHER_CTX_new()))
+        goto err;
+
+    for (i = 0; i < 4; i++) {
+        /* Changing the default properties flushes the method store */
+        if (i == 2
+                && !TEST_true(EVP_set_default_properties(NULL, NULL)))
+            goto err;
+        if (!TEST_true(EVP_DigestInit_ex(mdctx, EVP_sha256(), NULL))
+                || !TEST_true(EVP_DigestUpdate(mdctx, msg, sizeof(msg) - 1))
+                || !TEST_true(EVP_DigestFinal_ex(mdctx, md, &mdlen))
+                || !TEST_mem_eq(md, mdlen, expected, sizeof(expected))
+                || !TEST_true(EVP_EncryptInit_ex(cctx, EVP_aes_128_ecb(), NULL,
+                                                 key, NULL))
+                || !TEST_int_eq(EVP_CIPHER_CTX_block_size(cctx), 16))
+            goto err;
+        /* Until the store changes, the same cached method is handed out */
+        if (i == 0 || i == 2)
+            cipher = EVP_CIPHER_CTX_cipher(cctx);
+        else if (!TEST_ptr_eq(EVP_CIPHER_CTX_cipher(cctx), cipher))
+            goto err;
+    }
+
+    /*
+     * Once the store changes the cache must not be used any more: if it was,
+     * these would still find the methods of the default provider.
+     */
+    if (!TEST_true(EVP_set_default_properties(NULL, "provider=nonexistent"))
+            || !TEST_false(EVP_DigestInit_ex(mdctx, EVP_sha256(), NULL))
+            || !TEST_false(EVP_EncryptInit_ex(cctx, EVP_aes_128_ecb(), NULL,
+                                              key, NULL))
+            || !TEST_true(EVP_set_default_properties(NULL, NULL))
+            || !TEST_true(EVP_DigestInit_ex(mdctx, EVP_sha256(), NULL))
+            || !TEST_true(EVP_EncryptInit_ex(cctx, EVP_aes_128_ecb(), NULL,
+                                             key, NULL)))
+        goto err;
+    ERR_clear_error();
+
+#ifndef OPENSSL_NO_MD4
+    /* Methods of a provider loaded after the first fetch are found too */
+    if (!TEST_false(EVP_DigestInit_ex(mdctx, EVP_md4(), NULL)))
+        goto err;
+    ERR_clear_error();
+    if ((legacy = OSSL_PROVIDER_load(NULL, "legacy")) == NULL) {
+        TEST_note("legacy provider not available, skipping MD4");
+    } else {
+        for (i = 0; i < 2; i++)
+            if (!TEST_true(EVP_DigestInit_ex(mdctx, EVP_md4(), NULL))
+                    || !TEST_true(EVP_DigestUpdate(mdctx, msg,
+                                                   sizeof(msg) - 1))
+                    || !TEST_true(EVP_DigestFinal_ex(mdctx, md, &mdlen))
+                    || !TEST_mem_eq(md, mdlen, expected_md4,
+                                    sizeof(expected_md4)))
+                goto err;
+    }
+#endif
+
+    ret = 1;
+ err:
+#ifndef OPENSSL_NO_MD4
+    OSSL_PROVIDER_unload(legacy);
+#endif
+    EVP_MD_CTX_free(mdctx);
+    EVP_CIPHER_CTX_free(cctx);
+    return ret;
+}
+
+/*
+ * Contexts don't count references to methods kept by the method store, so
+ * check that copies of contexts still work once the original is gone.
+ */
+static int test_ctx_copy_outlives_original(void)
+{
+    EVP_MD_CTX *mdctx = NULL, *mdctx2 = NULL;
+    EVP_CIPHER_CTX *cctx = NULL, *cctx2 = NULL;
+    static const unsigned char key[16];
+    unsigned char md[EVP_MAX_MD_SIZE], out[32];
+    unsigned int mdlen;
+    int outl, ret = 0;
+
+    if (!TEST_ptr(mdctx = EVP_MD_CTX_new())
+            || !TEST_ptr(mdctx2 = EVP_MD_CTX_new())
+            || !TEST_ptr(cctx = EVP_CIPHER_CTX_new())
+            || !TEST_ptr(cctx2 = EVP_CIPHER_CTX_new())
+            || !TEST_true(EVP_DigestInit_ex(mdctx, EVP_sha256(), NULL))
+            || !TEST_true(EVP_MD_CTX_copy_ex(mdctx2, mdctx))
+            || !TEST_true(EVP_EncryptInit_ex(cctx, EVP_aes_128_ecb(), NULL,
+                                             key, NULL))
+            || !TEST_true(EVP_CIPHER_CTX_copy(cctx2, cctx)))
+        goto err;
+    EVP_MD_CTX_free(mdctx);
+    EVP_CIPHER_CTX_free(cctx);
+    mdctx = NULL;
+    cctx = NULL;
+    if (!TEST_true(EVP_DigestUpdate(mdctx2, "abc", 3))
+            || !TEST_true(EVP_DigestFinal_ex(mdctx2, md, &mdlen))
+            || !TEST_uint_eq(mdlen, 32)
+            || !TEST_true(EVP_EncryptUpdate(cctx2, out, &outl, key,
+                                            sizeof(key)))
+            || !TEST_int_eq(outl, 16))
+        goto err;
+    ret = 1;
+ err:
+    EVP_MD_CTX_free(mdctx);
+    EVP_MD_CTX_free(mdctx2);
+    EVP_CIPHER_CTX_free(cctx);
+    EVP_CIPHER_CTX_free(cctx2);
+    return ret;
+}
+
+static const char *fetch_queries[] = {
+    NULL, "", "provider=default", "provider=default, -fips", "?fips=no",
+    "nonexistent.name=1"
+};
+
+/* Fetching with a precompiled query must give what the query string gives */
+static int test_fetch_query(int n)
+{
+    OSSL_PROPERTY_QUERY *query = NULL;
+    EVP_MD *md1 = NULL, *md2 = NULL;
+    EVP_CIPHER *c1 = NULL, *c2 = NULL;
+    int i, ret = 0;
+
+    if (!TEST_ptr(query = OSSL_PROPERTY_QUERY_new(NULL, fetch_queries[n])))
+        goto err;
+    for (i = 0; i < 2; i++) {
+        md1 = EVP_MD_fetch(NULL, "SHA2-256", fetch_queries[n]);
+        md2 = EVP_MD_fetch_query(NULL, "SHA2-256", query);
+        c1 = EVP_CIPHER_fetch(NULL, "AES-128-CBC", fetch_queries[n]);
+        c2 = EVP_CIPHER_fetch_query(NULL, "AES-128-CBC", query);
+        if (!TEST_ptr_eq(md1, md2) || !TEST_ptr_eq(c1, c2))
+            goto err;
+        EVP_MD_free(md1);
+        EVP_MD_free(md2);
+        EVP_CIPHER_free(c1);
+        EVP_CIPHER_free(c2);
+        md1 = md2 = NULL;
+        c1 = c2 = NULL;
+        /* Merging with the default properties is cached in the query */
+        if (!TEST_true(EVP_set_default_properties(NULL,
+                                                  i == 0 ? "fips=no" : NULL)))
+            goto err;
+    }
+    ret = 1;
+ err:
+    EVP_MD_free(md1);
+    EVP_MD_free(md2);
+    EVP_CIPHER_free(c1);
+    EVP_CIPHER_free(c2);
+    OSSL_PROPERTY_QUERY_free(query);
+    return ret;
+}
+
+static const char *aead_ciphers[] = {
+    "AES-128-GCM", "AES-256-CCM", "ChaCha20-Poly1305"
+};
+
+static int aead_ctx_init(EVP_CIPHER_CTX *ctx, EVP_CIPHER *cipher, int enc,
+                         const unsigned char *key)
+{
+    return EVP_CipherInit_ex(ctx, cipher, NULL, NULL, NULL, enc)
+        && EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_IVLEN, 12, NULL) > 0
+        && (EVP_CIPHER_CTX_mode(ctx) != EVP_CIPH_CCM_MODE
+            || EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_TAG, 16, NULL) > 0)
+        && EVP_CipherInit_ex(ctx, NULL, NULL, key, NULL, enc);
+}
+
+/* EVP_CipherAEAD() must agree with the streaming interface */
+static int test_cipher_aead(int n)
+{
+    static const unsigned char key[32] = { 1, 2, 3, 4, 5 };
+    static const unsigned char iv[12] = { 6, 7, 8, 9 };
+    static const unsigned char aad[13] = { 10, 11, 12 };
+    static const unsigned char msg[] = "A message that is longer than a block";
+    unsigned char ct[sizeof(msg)], pt[sizeof(msg)], tag[16];
+    EVP_CIPHER *cipher = NULL;
+    EVP_CIPHER_CTX *ectx = NULL, *dctx = NULL;
+    size_t outl;
+    int len, lenf, ret = 0;
+
+    if (!TEST_ptr(cipher = EVP_CIPHER_fetch(NULL, aead_ciphers[n], NULL))
+        || !TEST_ptr(ectx = EVP_CIPHER_CTX_new())
+        || !TEST_ptr(dctx = EVP_CIPHER_CTX_new())
+        || !TEST_true(aead_ctx_init(ectx, cipher, 1, key))
+        || !TEST_true(EVP_CipherAEAD(ectx, ct, &outl, msg, sizeof(msg),
+                                     iv, sizeof(iv), aad, sizeof(aad),
+                                     tag, sizeof(tag)))
+        || !TEST_size_t_eq(outl, sizeof(msg)))
+        goto err;
+
+    /* Open what was sealed with the streaming interface */
+    if (!TEST_true(aead_ctx_init(dctx, cipher, 0, key))
+        || !TEST_true(EVP_CipherInit_ex(dctx, NULL, NULL, NULL, iv, 0))
+        || !TEST_int_gt(EVP_CIPHER_CTX_ctrl(dctx, EVP_CTRL_AEAD_SET_TAG,
+                                            sizeof(tag), tag), 0)
+        || (EVP_CIPHER_CTX_mode(dctx) == EVP_CIPH_CCM_MODE
+            && !TEST_true(EVP_CipherUpdate(dctx, NULL, &len, NULL,
+                                           sizeof(msg))))
+        || !TEST_true(EVP_CipherUpdate(dctx, NULL, &len, aad, sizeof(aad)))
+        || !TEST_true(EVP_CipherUpdate(dctx, pt, &len, ct, sizeof(ct)))
+        || !TEST_true(EVP_CipherFinal_ex(dctx, pt + len, &lenf))
+        || !TEST_mem_eq(pt, len + lenf, msg, sizeof(msg)))
+        goto err;
+
+    /* Open it again in one go, and fail to with a bad tag */
+    memset(pt, 0, sizeof(pt));
+    if (!TEST_true(EVP_CipherAEAD(dctx, pt, &outl, ct, sizeof(ct),
+                                  iv, sizeof(iv), aad, sizeof(aad),
+                                  tag, sizeof(tag)))
+        || !TEST_mem_eq(pt, outl, msg, sizeof(msg)))
+        goto err;
+    tag[0] ^= 1;
+    if (!TEST_false(EVP_CipherAEAD(dctx, pt, &outl, ct, sizeof(ct),
+                                   iv, sizeof(iv), aad, sizeof(aad),
+                                   tag, sizeof(tag))))
+        goto err;
+    ret = 1;
+ err:
+    EVP_CIPHER_CTX_free(ectx);
+    EVP_CIPHER_CTX_free(dctx);
+    EVP_CIPHER_free(cipher);
+    return ret;
+}
+
+/* A pinned key is converted for its provider once, and spares fetches */
+static int test_pkey_pin_to_provider(void)
+{
+    static const unsigned char msg[] = "A message to sign";
+    unsigned char sig[256];
+    size_t siglen = sizeof(sig);
+    EVP_PKEY *pkey = NULL;
+    EVP_PKEY_CTX *pctx = NULL;
+    EVP_MD_CTX *mdctx = NULL;
+    void *pinned = NULL;
+    int ret = 0;
+
+    if (!TEST_ptr(pkey = load_example_rsa_key())
+        || !TEST_true(EVP_PKEY_pin_to_provider(pkey, NULL, NULL))
+        || !TEST_ptr(pkey->pin_keymgmt)
+        || !TEST_ptr_eq(pkey->operation_cache[0].keymgmt, pkey->pin_keymgmt)
+        || !TEST_ptr(pinned = pkey->operation_cache[0].keydata))
+        goto err;
+
+    /* Only the first pin is kept, and keys that can't be had aren't pinned */
+    if (!TEST_true(EVP_PKEY_pin_to_provider(pkey, NULL, "provider=default"))
+        || !TEST_ptr_null(pkey->pin_propquery)
+        || !TEST_false(EVP_PKEY_pin_to_provider(pkey, NULL,
+                                                "provider=nonexistent")))
+        goto err;
+    ERR_clear_error();
+
+    /* Contexts get the pinned keymgmt, and operations the converted key */
+    if (!TEST_ptr(pctx = EVP_PKEY_CTX_new_from_pkey(NULL, pkey, NULL))
+        || !TEST_ptr_eq(pctx->keymgmt, pkey->pin_keymgmt)
+        || !TEST_ptr(mdctx = EVP_MD_CTX_new())
+        || !TEST_true(EVP_DigestSignInit(mdctx, NULL, EVP_sha256(), NULL,
+                                         pkey))
+        || !TEST_true(EVP_DigestSign(mdctx, sig, &siglen, msg, sizeof(msg)))
+        || !TEST_true(EVP_DigestVerifyInit(mdctx, NULL, EVP_sha256(), NULL,
+                                           pkey))
+        || !TEST_int_eq(EVP_DigestVerify(mdctx, sig, siglen, msg,
+                                         sizeof(msg)), 1)
+        || !TEST_ptr_eq(pkey->operation_cache[0].keydata, pinned)
+        || !TEST_ptr_null(pkey->operation_cache[1].keymgmt))
+        goto err;
+    ret = 1;
+ err:
+    EVP_MD_CTX_free(mdctx);
+    EVP_PKEY_CTX_free(pctx);
+    EVP_PKEY_free(pkey);
+    return ret;
+}
+
+static const char *digest_many_names[] = {
+    "SHA1", "SHA224", "SHA256", "SHA512"
+};
+
+/*
+ * EVP_Digest_many() must agree with EVP_Digest(), whatever the mix of message
+ * lengths and however many messages there are
+ */
+static int test_digest_many(int n)
+{
+    static const size_t nums[] = { 0, 1, 7, 17, 40 };
+    const void *in[40];
+    size_t inl[40];
+    unsigned char md[40][EVP_MAX_MD_SIZE], *out[40], ref[EVP_MAX_MD_SIZE];
+    unsigned char *buf = NULL;
+    unsigned int mdlen;
+    EVP_MD *md_alg = NULL;
+    size_t i, j;
+    int ret = 0;
+
+    if (!TEST_ptr(buf = OPENSSL_malloc(40 * 1024 + 8192))
+        || !TEST_ptr(md_alg = EVP_MD_fetch(NULL, digest_many_names[n], NULL)))
+        goto err;
+    for (i = 0; i < 40 * 1024 + 8192; i++)
+        buf[i] = (unsigned char)(i * 7 + (i >> 8));
+
+    for (j = 0; j < OSSL_NELEM(nums); j++) {
+        /* Lengths around the padding boundaries, some long ones in between */
+        for (i = 0; i < nums[j]; i++) {
+            in[i] = buf + i * 1024;
+            inl[i] = i % 5 == 4 ? 8192 + i * 3 : 50 + (i * 3) % 20;
+            out[i] = md[i];
+        }
+        if (!TEST_true(EVP_Digest_many(nums[j], in, inl, out, md_alg, NULL)))
+            goto err;
+        for (i = 0; i < nums[j]; i++) {
+            if (!TEST_true(EVP_Digest(in[i], inl[i], ref, &mdlen, md_alg,
+                                      NULL))
+                || !TEST_mem_eq(md[i], mdlen, ref, mdlen)) {
+                TEST_info("%zu messages, message %zu", nums[j], i);
+                goto err;
+            }
+        }
+    }
+    ret = 1;
+ err:
+    EVP_MD_free(md_alg);
+    OPENSSL_free(buf);
+    return ret;
+}
+
+/*
+ * With "xts_sector_size" set, sectors are done with consecutive tweaks, and
+ * a call carries on where the previous one stopped
+ */
+static int test_xts_sectors(void)
+{
+    static const unsigned char key[32] = {
+        0x10, 0x13, 0x16, 0x19, 0x1c, 0x1f, 0x22, 0x25,
+        0x28, 0x2b, 0x2e, 0x31, 0x34, 0x37, 0x3a, 0x3d,
+        0x40, 0x43, 0x46, 0x49, 0x4c, 0x4f, 0x52, 0x55,
+        0x58, 0x5b, 0x5e, 0x61, 0x64, 0x67, 0x6a, 0x6d
+    };
+    static const unsigned char iv0[16] = { 0xfe, 0xff };
+    unsigned char iv[16];
+    unsigned char in[4 * 528], out[sizeof(in)], ref[sizeof(in)];
+    size_t sector_size = 528, i, j;
+    OSSL_PARAM params[2];
+    EVP_CIPHER *cipher = NULL;
+    EVP_CIPHER_CTX *ctx = NULL;
+    int outl, ret = 0;
+
+    for (i = 0; i < sizeof(in); i++)
+        in[i] = (unsigned char)(i * 7 + 3);
+    params[0] = OSSL_PARAM_construct_size_t(OSSL_CIPHER_PARAM_XTS_SECTOR_SIZE,
+                                            &sector_size);
+    params[1] = OSSL_PARAM_construct_end();
+
+    if (!TEST_ptr(cipher = EVP_CIPHER_fetch(NULL, "AES-128-XTS", NULL))
+        || !TEST_ptr(ctx = EVP_CIPHER_CTX_new()))
+        goto err;
+
+    /* One sector at a time, the tweak carrying into its third byte */
+    memcpy(iv, iv0, sizeof(iv));
+    for (i = 0; i < sizeof(in); i += sector_size) {
+        if (!TEST_true(EVP_EncryptInit_ex(ctx, cipher, NULL, key, iv))
+            || !TEST_true(EVP_EncryptUpdate(ctx, ref + i, &outl, in + i,
+                                            sector_size)))
+            goto err;
+        for (j = 0; j < sizeof(iv) && ++iv[j] == 0; j++)
+            continue;
+    }
+
+    if (!TEST_true(EVP_EncryptInit_ex(ctx, cipher, NULL, key, iv0))
+        || !TEST_true(EVP_CIPHER_CTX_set_params(ctx, params))
+        || !TEST_true(EVP_EncryptUpdate(ctx, out, &outl, in, sector_size))
+        || !TEST_true(EVP_EncryptUpdate(ctx, out + sector_size, &outl,
+                                        in + sector_size,
+                                        sizeof(in) - sector_size))
+        || !TEST_mem_eq(out, sizeof(out), ref, sizeof(ref))
+        || !TEST_false(EVP_EncryptUpdate(ctx, out, &outl, in,
+                                         sector_size + 16)))
+        goto err;
+    ERR_clear_error();
+
+    if (!TEST_true(EVP_DecryptInit_ex(ctx, cipher, NULL, key, iv0))
+        || !TEST_true(EVP_CIPHER_CTX_set_params(ctx, params))
+        || !TEST_true(EVP_DecryptUpdate(ctx, out, &outl, ref, sizeof(ref)))
+        || !TEST_mem_eq(out, sizeof(out), in, sizeof(in)))
+        goto err;
+    ret = 1;
+ err:
+    EVP_CIPHER_CTX_free(ctx);
+    EVP_CIPHER_free(cipher);
+    return ret;
+}
+
 int setup_tests(void)
 {
     ADD_ALL_TESTS(test_EVP_DigestSignInit, 9);
@@ -1579,6 +1998,13 @@ int setup_tests(void)
 #ifndef OPENSSL_NO_DH
     ADD_TEST(test_EVP_PKEY_set1_DH);
 #endif
+    ADD_TEST(test_implicit_fetch);
+    ADD_TEST(test_ctx_copy_outlives_original);
+    ADD_ALL_TESTS(test_fetch_query, OSSL_NELEM(fetch_queries));
+    ADD_ALL_TESTS(test_cipher_aead, OSSL_NELEM(aead_ciphers));
+    ADD_TEST(test_pkey_pin_to_provider);
+    ADD_ALL_TESTS(test_digest_many, OSSL_NELEM(digest_many_names));
+    ADD_TEST(test_xts_sectors);
 
     return 1;
 }
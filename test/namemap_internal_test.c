@@ -56,6 +56,30 @@ static int test_namemap_stored(void)
         && test_namemap(nm);
 }
 
+/* Names the built-in providers use are looked up through a separate table */
+static int test_namemap_builtin(void)
+{
+    OSSL_NAMEMAP *nm = ossl_namemap_new();
+    int ok = 0, num1, num2;
+
+    if (!TEST_ptr(nm)
+        || !TEST_int_eq(ossl_namemap_name2num(nm, "SHA256"), 0))
+        goto end;
+    num1 = ossl_namemap_add_names(nm, 0, "SHA2-256:SHA-256:SHA256", ':');
+    num2 = ossl_namemap_add_name(nm, 0, "name1");
+    ok = TEST_int_ne(num1, 0)
+        && TEST_int_ne(num2, num1)
+        && TEST_int_eq(ossl_namemap_name2num(nm, "sha256"), num1)
+        && TEST_int_eq(ossl_namemap_name2num(nm, "Sha-256"), num1)
+        && TEST_int_eq(ossl_namemap_name2num_n(nm, "SHA256:x", 6), num1)
+        && TEST_int_eq(ossl_namemap_name2num_n(nm, "SHA2-25", 7), 0)
+        && TEST_int_eq(ossl_namemap_add_name(nm, 0, "SHA2-256"), num1)
+        && TEST_int_eq(ossl_namemap_name2num(nm, "NAME1"), num2);
+ end:
+    ossl_namemap_free(nm);
+    return ok;
+}
+
 /*
  * Test that EVP_get_digestbyname() will use the namemap when it can't find
  * entries in the legacy method database.
@@ -156,6 +180,7 @@ int setup_tests(void)
 {
     ADD_TEST(test_namemap_independent);
     ADD_TEST(test_namemap_stored);
+    ADD_TEST(test_namemap_builtin);
     ADD_TEST(test_digestbyname);
     ADD_TEST(test_cipherbyname);
     ADD_TEST(test_digest_is_a);
@@ -16,7 +16,9 @@
 #include <openssl/bn.h>
 #include <openssl/core.h>
 #include <openssl/params.h>
+#include <openssl/core_names.h>
 #include "internal/nelem.h"
+#include "internal/param_names.h"
 #include "testutil.h"
 
 /*-
@@ -543,8 +545,24 @@ static int test_case(int i)
                                  test_cases[i].prov));
 }
 
+static int test_param_find_pidx(void)
+{
+    return TEST_int_eq(ossl_param_find_pidx(OSSL_CIPHER_PARAM_AEAD_TAG),
+                       PIDX_CIPHER_PARAM_AEAD_TAG)
+        && TEST_int_eq(ossl_param_find_pidx(OSSL_CIPHER_PARAM_AEAD_IVLEN),
+                       PIDX_CIPHER_PARAM_IVLEN)
+        && TEST_int_eq(ossl_param_find_pidx(OSSL_KDF_PARAM_DIGEST),
+                       PIDX_ALG_PARAM_DIGEST)
+        && TEST_int_ne(PIDX_CIPHER_PARAM_AEAD_TAG,
+                       PIDX_CIPHER_PARAM_AEAD_TAGLEN)
+        && TEST_int_eq(ossl_param_find_pidx("ta"), -1)
+        && TEST_int_eq(ossl_param_find_pidx("TAG"), -1)
+        && TEST_int_eq(ossl_param_find_pidx(""), -1);
+}
+
 int setup_tests(void)
 {
     ADD_ALL_TESTS(test_case, OSSL_NELEM(test_cases));
+    ADD_TEST(test_param_find_pidx);
     return 1;
 }
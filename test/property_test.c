@@ -383,6 +383,66 @@ err:
     return res;
 }
 
+/*
+ * Check that lookups don't see stale results after the store or the cache
+ * changes.
+ */
+static int test_query_cache_update(void)
+{
+    OSSL_METHOD_STORE *store;
+    void *result = NULL;
+    int ret = 0;
+
+    if (!TEST_ptr(store = ossl_method_store_new(NULL))
+        || !add_property_names("position", NULL)
+        || !TEST_true(ossl_method_store_add(store, NULL, 2, "position=1", "a",
+                                            &up_ref, &down_ref))
+        || !TEST_true(ossl_method_store_cache_set(store, 2, "position=1", "a",
+                                                  &up_ref, &down_ref))
+        || !TEST_false(ossl_method_store_cache_get(store, 2, "position=2",
+                                                   &result))
+        || !TEST_true(ossl_method_store_cache_get(store, 2, "position=1",
+                                                  &result))
+        || !TEST_str_eq((char *)result, "a")
+        || !TEST_true(ossl_method_store_fetch(store, 2, NULL, &result))
+        || !TEST_str_eq((char *)result, "a"))
+        goto err;
+
+    /* Caching a new query result must make it visible */
+    if (!TEST_true(ossl_method_store_cache_set(store, 2, "position=2", "x",
+                                               &up_ref, &down_ref))
+        || !TEST_true(ossl_method_store_cache_get(store, 2, "position=2",
+                                                  &result))
+        || !TEST_str_eq((char *)result, "x"))
+        goto err;
+
+    /* Adding an implementation flushes the cache */
+    if (!TEST_true(ossl_method_store_add(store, NULL, 2, "position=2", "b",
+                                         &up_ref, &down_ref))
+        || !TEST_false(ossl_method_store_cache_get(store, 2, "position=2",
+                                                   &result))
+        || !TEST_true(ossl_method_store_fetch(store, 2, "position=2",
+                                              &result))
+        || !TEST_str_eq((char *)result, "b"))
+        goto err;
+
+    /* Removing the default implementation changes the default */
+    if (!TEST_true(ossl_method_store_fetch(store, 2, NULL, &result))
+        || !TEST_str_eq((char *)result, "a")
+        || !TEST_true(ossl_method_store_remove(store, 2, "a"))
+        || !TEST_true(ossl_method_store_fetch(store, 2, NULL, &result))
+        || !TEST_str_eq((char *)result, "b")
+        || !TEST_true(ossl_method_store_remove(store, 2, "b"))
+        || !TEST_false(ossl_method_store_cache_get(store, 2, "position=1",
+                                                   &result))
+        || !TEST_false(ossl_method_store_fetch(store, 2, NULL, &result)))
+        goto err;
+    ret = 1;
+err:
+    ossl_method_store_free(store);
+    return ret;
+}
+
 int setup_tests(void)
 {
     ADD_TEST(test_property_string);
@@ -393,5 +453,6 @@ int setup_tests(void)
     ADD_TEST(test_register_deregister);
     ADD_TEST(test_property);
     ADD_TEST(test_query_cache_stochastic);
+    ADD_TEST(test_query_cache_update);
     return 1;
 }
@@ -9,6 +9,9 @@
 
 #include <stddef.h>
 #include <openssl/crypto.h>
+#include <openssl/core_numbers.h>
+#include <openssl/evp.h>
+#include <openssl/provider.h>
 #include "internal/provider.h"
 #include "testutil.h"
 
@@ -84,9 +87,50 @@ static int test_configured_provider(void)
 }
 #endif
 
+/*
+ * Once the methods of an operation are in the store, they must not be
+ * constructed again, not even when a fetch fails.
+ */
+static int test_operation_bits(void)
+{
+    OPENSSL_CTX *libctx = NULL;
+    OSSL_PROVIDER *prov = NULL;
+    EVP_MD *md = NULL;
+    int bit = -1;
+    int ret = 0;
+
+    if (!TEST_ptr(libctx = OPENSSL_CTX_new())
+        || !TEST_ptr(prov = OSSL_PROVIDER_load(libctx, "default"))
+        || !TEST_true(ossl_provider_test_operation_bit(prov, OSSL_OP_DIGEST,
+                                                       &bit))
+        || !TEST_false(bit)
+        || !TEST_ptr(md = EVP_MD_fetch(libctx, "SHA2-256", NULL))
+        || !TEST_true(ossl_provider_test_operation_bit(prov, OSSL_OP_DIGEST,
+                                                       &bit))
+        || !TEST_true(bit)
+        || !TEST_true(ossl_provider_test_operation_bit(prov, OSSL_OP_CIPHER,
+                                                       &bit))
+        || !TEST_false(bit)
+        || !TEST_ptr_null(EVP_MD_fetch(libctx, "NO-SUCH-DIGEST", NULL))
+        || !TEST_true(ossl_provider_test_operation_bit(prov, OSSL_OP_DIGEST,
+                                                       &bit))
+        || !TEST_true(bit)
+        || !TEST_false(ossl_provider_set_operation_bit(prov, 1024))
+        || !TEST_true(ossl_provider_test_operation_bit(prov, 1024, &bit))
+        || !TEST_false(bit))
+        goto err;
+    ret = 1;
+ err:
+    EVP_MD_free(md);
+    OSSL_PROVIDER_unload(prov);
+    OPENSSL_CTX_free(libctx);
+    return ret;
+}
+
 int setup_tests(void)
 {
     ADD_TEST(test_builtin_provider);
+    ADD_TEST(test_operation_bits);
 #ifndef NO_PROVIDER_MODULE
     ADD_TEST(test_loaded_provider);
     ADD_TEST(test_configured_provider);
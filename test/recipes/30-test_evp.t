@@ -33,7 +33,7 @@ push @configs, 'fips.cnf' unless $no_fips;
 
 my @files = qw( evpciph.txt evpdigest.txt evppkey.txt evppkey_ecc.txt);
 my @defltfiles = qw( evpencod.txt evpkdf.txt evppkey_kdf.txt evpmac.txt
-    evppbe.txt evpcase.txt evpccmcavs.txt );
+    evppbe.txt evpcase.txt evpccmcavs.txt evpmd_k12.txt );
 my @ideafiles = qw( evpciph_idea.txt );
 push @defltfiles, @ideafiles unless disabled("idea");
 
@@ -73,6 +73,9 @@ push @defltfiles, @md2files unless disabled("md2");
 my @mdc2files = qw( evpmd_mdc2.txt );
 push @defltfiles, @mdc2files unless disabled("mdc2");
 
+my @blake3files = qw( evpmd_blake3.txt );
+push @defltfiles, @blake3files unless disabled("blake3");
+
 plan tests =>
     ($no_fips ? 0 : 1)          # FIPS install test
     + (scalar(@configs) * scalar(@files))
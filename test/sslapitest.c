@@ -28,6 +28,8 @@
 #include <openssl/aes.h>
 #include <openssl/rand.h>
 #include <openssl/core_names.h>
+#include <openssl/comp.h>
+#include <openssl/objects.h>
 
 #include "ssltestlib.h"
 #include "testutil.h"
@@ -7234,6 +7236,673 @@ static int test_servername(int tst)
     return testresult;
 }
 
+#if !defined(OPENSSL_NO_TLS1_3) \
+    && (!defined(OPENSSL_NO_EC) || !defined(OPENSSL_NO_DH))
+/*
+ * Test the pool of pregenerated key shares: keys are taken out of the pool
+ * and only used once.
+ */
+static int test_key_share_pool(void)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL;
+    EVP_PKEY *ckeys[4] = { NULL }, *skeys[4] = { NULL };
+    int i, j, testresult = 0;
+
+    if (!TEST_true(create_ssl_ctx_pair(TLS_server_method(), TLS_client_method(),
+                                       TLS1_3_VERSION, 0,
+                                       &sctx, &cctx, cert, privkey))
+            || !TEST_true(SSL_CTX_set_key_share_pool_size(cctx, 2))
+            || !TEST_true(SSL_CTX_set_key_share_pool_size(sctx, 2))
+            || !TEST_size_t_eq(SSL_CTX_get_key_share_pool_size(sctx), 2)
+            /* Nothing to do until we know which group is in use */
+            || !TEST_int_eq(SSL_CTX_fill_key_share_pool(cctx), 0))
+        goto end;
+
+    for (i = 0; i < (int)OSSL_NELEM(ckeys); i++) {
+        /*
+         * Fill with 2 keys at first and then top up the 1 key used by the
+         * previous handshake.
+         */
+        if (i > 0
+                && (!TEST_int_eq(SSL_CTX_fill_key_share_pool(cctx),
+                                 i == 1 ? 2 : 1)
+                    || !TEST_int_eq(SSL_CTX_fill_key_share_pool(sctx),
+                                    i == 1 ? 2 : 1)))
+            goto end;
+        if (!TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+                                          NULL, NULL))
+                || !TEST_true(create_ssl_connection(serverssl, clientssl,
+                                                    SSL_ERROR_NONE))
+                || !TEST_true(SSL_get_peer_tmp_key(serverssl, &ckeys[i]))
+                || !TEST_true(SSL_get_peer_tmp_key(clientssl, &skeys[i])))
+            goto end;
+        SSL_free(serverssl);
+        SSL_free(clientssl);
+        serverssl = clientssl = NULL;
+    }
+
+    /* No key share was used twice */
+    for (i = 0; i < (int)OSSL_NELEM(ckeys); i++) {
+        for (j = 0; j < i; j++) {
+            if (!TEST_int_ne(EVP_PKEY_cmp(ckeys[i], ckeys[j]), 1)
+                    || !TEST_int_ne(EVP_PKEY_cmp(skeys[i], skeys[j]), 1))
+                goto end;
+        }
+    }
+
+    /* Resizing empties the pool and forgets its groups */
+    if (!TEST_true(SSL_CTX_set_key_share_pool_size(cctx, 3))
+            || !TEST_int_eq(SSL_CTX_fill_key_share_pool(cctx), 0))
+        goto end;
+
+    testresult = 1;
+
+ end:
+    for (i = 0; i < (int)OSSL_NELEM(ckeys); i++) {
+        EVP_PKEY_free(ckeys[i]);
+        EVP_PKEY_free(skeys[i]);
+    }
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+#endif
+
+#ifndef OPENSSL_NO_TLS1_2
+/*
+ * Test that the ClientHello cipher_suites template is reused, that it is
+ * discarded when the cipher list changes, and that a connection with other
+ * settings gets a template of its own.
+ */
+static int test_client_hello_ciphers(void)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL;
+    static const char *ciphers[] = {
+        "AES128-SHA256", "AES128-SHA256", "AES256-SHA256"
+    };
+    size_t i;
+    int testresult = 0;
+
+    if (!TEST_true(create_ssl_ctx_pair(TLS_server_method(), TLS_client_method(),
+                                       TLS1_VERSION, TLS1_2_VERSION,
+                                       &sctx, &cctx, cert, privkey))
+            || !TEST_true(SSL_CTX_set_cipher_list(sctx, "AES128-SHA256:"
+                                                        "AES256-SHA256:"
+                                                        "AES128-SHA")))
+        goto end;
+
+    for (i = 0; i < OSSL_NELEM(ciphers); i++) {
+        if (!TEST_true(SSL_CTX_set_cipher_list(cctx, ciphers[i]))
+                || !TEST_true(create_ssl_objects(sctx, cctx, &serverssl,
+                                                 &clientssl, NULL, NULL))
+                || !TEST_true(create_ssl_connection(serverssl, clientssl,
+                                                    SSL_ERROR_NONE))
+                || !TEST_str_eq(SSL_CIPHER_get_name(
+                                    SSL_get_current_cipher(clientssl)),
+                                ciphers[i]))
+            goto end;
+        SSL_free(serverssl);
+        SSL_free(clientssl);
+        serverssl = clientssl = NULL;
+
+        /* A second connection uses the template */
+        if (!TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+                                          NULL, NULL))
+                || !TEST_true(create_ssl_connection(serverssl, clientssl,
+                                                    SSL_ERROR_NONE))
+                || !TEST_str_eq(SSL_CIPHER_get_name(
+                                    SSL_get_current_cipher(clientssl)),
+                                ciphers[i]))
+            goto end;
+        SSL_free(serverssl);
+        SSL_free(clientssl);
+        serverssl = clientssl = NULL;
+    }
+
+#ifndef OPENSSL_NO_TLS1_1
+    /*
+     * The TLSv1.2 template includes AES128-SHA256, which a TLSv1.1 client
+     * must not offer.
+     */
+    if (!TEST_true(SSL_CTX_set_cipher_list(cctx, "AES128-SHA256:AES128-SHA")))
+        goto end;
+    for (i = 0; i < 2; i++) {
+        if (!TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+                                          NULL, NULL))
+                || (i == 1
+                    && !TEST_true(SSL_set_max_proto_version(clientssl,
+                                                            TLS1_1_VERSION)))
+                || !TEST_true(create_ssl_connection(serverssl, clientssl,
+                                                    SSL_ERROR_NONE))
+                || !TEST_str_eq(SSL_CIPHER_get_name(
+                                    SSL_get_current_cipher(clientssl)),
+                                i == 0 ? "AES128-SHA256" : "AES128-SHA"))
+            goto end;
+        SSL_free(serverssl);
+        SSL_free(clientssl);
+        serverssl = clientssl = NULL;
+    }
+#endif
+
+    testresult = 1;
+
+ end:
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+#endif
+
+#ifndef OPENSSL_NO_TLS1_2
+/*
+ * Test server cipher selection against the cipher list of the SSL_CTX, which
+ * is kept as a bitmap, and against the cipher list of the SSL.
+ * Test 0: Client preference
+ * Test 1: Server preference
+ */
+static int test_server_cipher_set(int tst)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL;
+    static const struct {
+        const char *srvr;
+        int use_ssl;
+        const char *expected[2];
+    } t[] = {
+        { "AES256-SHA256:AES128-SHA256", 0,
+          { "AES128-SHA256", "AES256-SHA256" } },
+        { "AES256-SHA256", 0, { "AES256-SHA256", "AES256-SHA256" } },
+        { "AES128-SHA256:AES256-SHA256", 0,
+          { "AES128-SHA256", "AES128-SHA256" } },
+        { "AES256-SHA256", 1, { "AES256-SHA256", "AES256-SHA256" } }
+    };
+    size_t i;
+    int testresult = 0;
+
+    if (!TEST_true(create_ssl_ctx_pair(TLS_server_method(), TLS_client_method(),
+                                       TLS1_VERSION, TLS1_2_VERSION,
+                                       &sctx, &cctx, cert, privkey))
+            || !TEST_true(SSL_CTX_set_cipher_list(cctx, "AES128-SHA256:"
+                                                        "AES256-SHA256")))
+        goto end;
+    if (tst == 1)
+        SSL_CTX_set_options(sctx, SSL_OP_CIPHER_SERVER_PREFERENCE);
+
+    for (i = 0; i < OSSL_NELEM(t); i++) {
+        if (!t[i].use_ssl
+                && !TEST_true(SSL_CTX_set_cipher_list(sctx, t[i].srvr)))
+            goto end;
+        if (!TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+                                          NULL, NULL)))
+            goto end;
+        if (t[i].use_ssl
+                && !TEST_true(SSL_set_cipher_list(serverssl, t[i].srvr)))
+            goto end;
+        if (!TEST_true(create_ssl_connection(serverssl, clientssl,
+                                             SSL_ERROR_NONE))
+                || !TEST_str_eq(SSL_CIPHER_get_name(
+                                    SSL_get_current_cipher(serverssl)),
+                                t[i].expected[tst]))
+            goto end;
+        SSL_free(serverssl);
+        SSL_free(clientssl);
+        serverssl = clientssl = NULL;
+    }
+
+    testresult = 1;
+
+ end:
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+#endif
+
+#if !defined(OPENSSL_NO_TLS1_3) && !defined(OPENSSL_NO_EC)
+/*
+ * Test that the ClientHello supported_groups and signature_algorithms
+ * templates are discarded when the groups or signature algorithms of the
+ * SSL_CTX change.
+ */
+static int test_client_hello_templates(void)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL;
+    static const struct {
+        const char *groups;
+        int group;
+        const char *sigalgs;
+        int hash;
+    } conf[] = {
+        { "P-256", NID_X9_62_prime256v1, "rsa_pss_rsae_sha256", NID_sha256 },
+        { "P-384", NID_secp384r1, "rsa_pss_rsae_sha256", NID_sha256 },
+        { "P-384", NID_secp384r1, "rsa_pss_rsae_sha384", NID_sha384 }
+    };
+    size_t i, j;
+    int testresult = 0, nid;
+
+    if (!TEST_true(create_ssl_ctx_pair(TLS_server_method(), TLS_client_method(),
+                                       TLS1_3_VERSION, TLS1_3_VERSION,
+                                       &sctx, &cctx, cert, privkey)))
+        goto end;
+
+    for (i = 0; i < OSSL_NELEM(conf); i++) {
+        /* The server only accepts what the client is configured with */
+        if (!TEST_true(SSL_CTX_set1_groups_list(sctx, conf[i].groups))
+                || !TEST_true(SSL_CTX_set1_groups_list(cctx, conf[i].groups))
+                || !TEST_true(SSL_CTX_set1_sigalgs_list(sctx, conf[i].sigalgs))
+                || !TEST_true(SSL_CTX_set1_sigalgs_list(cctx,
+                                                        conf[i].sigalgs)))
+            goto end;
+
+        /* The second connection uses the templates */
+        for (j = 0; j < 2; j++) {
+            if (!TEST_true(create_ssl_objects(sctx, cctx, &serverssl,
+                                              &clientssl, NULL, NULL))
+                    || !TEST_true(create_ssl_connection(serverssl, clientssl,
+                                                        SSL_ERROR_NONE))
+                    || !TEST_int_eq(SSL_get_shared_group(serverssl, 0),
+                                    conf[i].group)
+                    || !TEST_true(SSL_get_peer_signature_nid(clientssl, &nid))
+                    || !TEST_int_eq(nid, conf[i].hash))
+                goto end;
+            SSL_free(serverssl);
+            SSL_free(clientssl);
+            serverssl = clientssl = NULL;
+        }
+    }
+
+    testresult = 1;
+
+ end:
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+#endif
+
+#if !defined(OPENSSL_NO_TLS1_2) && !defined(OPENSSL_NO_EC)
+/*
+ * Test shared group and signature algorithm selection against the lists of
+ * the SSL_CTX and of the SSL, which are kept as bitmaps.
+ * Test 0: Client preference
+ * Test 1: Server preference
+ */
+static int test_server_group_sigalg_set(int tst)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL;
+    static const struct {
+        const char *groups;
+        const char *sigalgs;
+        int use_ssl;
+        int group[2];
+        int hash[2];
+    } t[] = {
+        { "P-384:P-256", "RSA+SHA512:RSA+SHA256", 0,
+          { NID_X9_62_prime256v1, NID_secp384r1 }, { NID_sha256, NID_sha512 } },
+        { "P-384", "RSA+SHA512", 0,
+          { NID_secp384r1, NID_secp384r1 }, { NID_sha512, NID_sha512 } },
+        { "P-256", "RSA+SHA256", 1,
+          { NID_X9_62_prime256v1, NID_X9_62_prime256v1 },
+          { NID_sha256, NID_sha256 } }
+    };
+    size_t i;
+    int hash, testresult = 0;
+
+    if (!TEST_true(create_ssl_ctx_pair(TLS_server_method(), TLS_client_method(),
+                                       TLS1_VERSION, TLS1_2_VERSION,
+                                       &sctx, &cctx, cert, privkey))
+            || !TEST_true(SSL_CTX_set1_groups_list(cctx, "P-256:P-384"))
+            || !TEST_true(SSL_CTX_set1_sigalgs_list(cctx,
+                                                    "RSA+SHA256:RSA+SHA512"))
+            || !TEST_true(SSL_CTX_set_cipher_list(cctx,
+                                                  "ECDHE-RSA-AES128-GCM-SHA256")))
+        goto end;
+    if (tst == 1)
+        SSL_CTX_set_options(sctx, SSL_OP_CIPHER_SERVER_PREFERENCE);
+
+    for (i = 0; i < OSSL_NELEM(t); i++) {
+        if (!t[i].use_ssl
+                && (!TEST_true(SSL_CTX_set1_groups_list(sctx, t[i].groups))
+                    || !TEST_true(SSL_CTX_set1_sigalgs_list(sctx,
+                                                            t[i].sigalgs))))
+            goto end;
+        if (!TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+                                          NULL, NULL)))
+            goto end;
+        if (t[i].use_ssl
+                && (!TEST_true(SSL_set1_groups_list(serverssl, t[i].groups))
+                    || !TEST_true(SSL_set1_sigalgs_list(serverssl,
+                                                        t[i].sigalgs))))
+            goto end;
+        if (!TEST_true(create_ssl_connection(serverssl, clientssl,
+                                             SSL_ERROR_NONE))
+                || !TEST_int_eq(SSL_get_shared_group(serverssl, 0),
+                                t[i].group[tst])
+                || !TEST_int_gt(SSL_get_shared_sigalgs(serverssl, 0, NULL,
+                                                       &hash, NULL, NULL,
+                                                       NULL), 0)
+                || !TEST_int_eq(hash, t[i].hash[tst]))
+            goto end;
+        SSL_free(serverssl);
+        SSL_free(clientssl);
+        serverssl = clientssl = NULL;
+    }
+
+    testresult = 1;
+
+ end:
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+#endif
+
+/*
+ * Test that the encoded Certificate message for a certificate with an explicit
+ * chain is cached and reused correctly, and that neither it nor the result of
+ * the security checks survive a change of the chain or the security level.
+ * Test 0: TLSv1.2
+ * Test 1: TLSv1.3
+ */
+static int test_cert_chain_cache(int tst)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL;
+    BIO *in = NULL;
+    X509 *rootx = NULL, *peer = NULL;
+    char *rootfile = NULL;
+    int i, chainlen, testresult = 0;
+
+#ifdef OPENSSL_NO_TLS1_2
+    if (tst == 0)
+        return 1;
+#endif
+#ifdef OPENSSL_NO_TLS1_3
+    if (tst == 1)
+        return 1;
+#endif
+
+    if (!TEST_ptr(rootfile = test_mk_file_path(certsdir, "rootcert.pem"))
+            || !TEST_ptr(in = BIO_new_file(rootfile, "r"))
+            || !TEST_ptr(rootx = PEM_read_bio_X509(in, NULL, NULL, NULL)))
+        goto end;
+
+    if (!TEST_true(create_ssl_ctx_pair(TLS_server_method(), TLS_client_method(),
+                                       tst == 0 ? TLS1_2_VERSION
+                                                : TLS1_3_VERSION,
+                                       tst == 0 ? TLS1_2_VERSION
+                                                : TLS1_3_VERSION,
+                                       &sctx, &cctx, cert, privkey))
+            || !TEST_true(SSL_CTX_add1_chain_cert(sctx, rootx)))
+        goto end;
+
+    /*
+     * Connection 1 uses the cached encoding and security check result of
+     * connection 0. Connection 2 is at a security level that our 2048 bit
+     * RSA key doesn't meet, so it must fail. Connection 3 is back at the
+     * original level but with the chain removed.
+     */
+    for (i = 0; i < 4; i++) {
+        if (i == 2)
+            SSL_CTX_set_security_level(sctx, 3);
+        if (i == 3) {
+            SSL_CTX_set_security_level(sctx, 1);
+            if (!TEST_true(SSL_CTX_clear_chain_certs(sctx)))
+                goto end;
+        }
+        if (!TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+                                          NULL, NULL)))
+            goto end;
+        if (i == 2) {
+            if (!TEST_false(create_ssl_connection(serverssl, clientssl,
+                                                  SSL_ERROR_SSL)))
+                goto end;
+        } else {
+            chainlen = i < 2 ? 2 : 1;
+            if (!TEST_true(create_ssl_connection(serverssl, clientssl,
+                                                 SSL_ERROR_NONE))
+                    || !TEST_int_eq(sk_X509_num(
+                                        SSL_get_peer_cert_chain(clientssl)),
+                                    chainlen)
+                    || !TEST_ptr(peer = SSL_get_peer_certificate(clientssl))
+                    || !TEST_int_eq(X509_cmp(peer, SSL_CTX_get0_certificate(
+                                                       sctx)), 0))
+                goto end;
+            if (chainlen == 2
+                    && !TEST_int_eq(X509_cmp(sk_X509_value(
+                                                 SSL_get_peer_cert_chain(
+                                                     clientssl), 1), rootx),
+                                    0))
+                goto end;
+            X509_free(peer);
+            peer = NULL;
+            SSL_shutdown(clientssl);
+            SSL_shutdown(serverssl);
+        }
+
+        SSL_free(serverssl);
+        SSL_free(clientssl);
+        serverssl = clientssl = NULL;
+    }
+
+    testresult = 1;
+
+ end:
+    X509_free(peer);
+    X509_free(rootx);
+    BIO_free(in);
+    OPENSSL_free(rootfile);
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+
+#ifndef OPENSSL_NO_TLS1_3
+static int cert_comp_available(int alg)
+{
+    switch (alg) {
+# ifndef OPENSSL_NO_COMP
+    case TLSEXT_comp_cert_zlib:
+        return COMP_get_type(COMP_zlib_oneshot()) != NID_undef;
+    case TLSEXT_comp_cert_brotli:
+        return COMP_get_type(COMP_brotli_oneshot()) != NID_undef;
+# endif
+    case TLSEXT_comp_cert_zstd:
+        /* Provided by the callbacks below */
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/*
+ * A stand-in compression algorithm that needs no external library, so that
+ * the negotiation is tested in every build: the output is the input with
+ * every byte inverted.
+ */
+static int cert_comp_compress_calls, cert_comp_expand_calls;
+
+static int cert_comp_invert(SSL *s, unsigned char *out, size_t outlen,
+                            const unsigned char *in, size_t inlen, void *arg)
+{
+    size_t i;
+
+    if (inlen > outlen || inlen > INT_MAX)
+        return 0;
+    for (i = 0; i < inlen; i++)
+        out[i] = (unsigned char)~in[i];
+    ++*(int *)arg;
+    return (int)inlen;
+}
+
+static int cert_comp_uninvert(SSL *s, unsigned char *out, size_t outlen,
+                              const unsigned char *in, size_t inlen, void *arg)
+{
+    /* The expanded length must be exactly what the server said it was */
+    if (inlen != outlen)
+        return 0;
+    return cert_comp_invert(s, out, outlen, in, inlen, arg);
+}
+
+/*
+ * Test TLSv1.3 certificate compression
+ * Test 0: Client and server both prefer zlib
+ * Test 1: Client and server both prefer brotli
+ * Test 2: Client prefers zlib, server prefers brotli: server choice wins
+ * Test 3: Client does not offer compression
+ * Test 4: Client offers an algorithm the server doesn't accept
+ * Test 5: Client and server both use an algorithm supplied by callbacks
+ */
+static int test_cert_compression(int tst)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL;
+    int zlib_brotli[] = { TLSEXT_comp_cert_zlib, TLSEXT_comp_cert_brotli };
+    int brotli_zlib[] = { TLSEXT_comp_cert_brotli, TLSEXT_comp_cert_zlib };
+    int zstd[] = { TLSEXT_comp_cert_zstd };
+    int *cprefs = zlib_brotli, *sprefs = zlib_brotli;
+    size_t cnum = 2, snum = 2;
+    int expected, i, testresult = 0;
+    BIO *in = NULL;
+    X509 *rootx = NULL;
+    char *rootfile = NULL;
+
+    switch (tst) {
+    case 0:
+        cnum = snum = 1;
+        expected = TLSEXT_comp_cert_zlib;
+        break;
+    case 1:
+        cprefs = sprefs = brotli_zlib;
+        cnum = snum = 1;
+        expected = TLSEXT_comp_cert_brotli;
+        break;
+    case 2:
+        sprefs = brotli_zlib;
+        expected = TLSEXT_comp_cert_brotli;
+        break;
+    case 3:
+        cnum = 0;
+        expected = TLSEXT_comp_cert_none;
+        break;
+    case 5:
+        cprefs = sprefs = zstd;
+        cnum = snum = 1;
+        expected = TLSEXT_comp_cert_zstd;
+        break;
+    default:
+        cprefs = brotli_zlib;
+        cnum = snum = 1;
+        expected = TLSEXT_comp_cert_none;
+        break;
+    }
+
+    if (expected != TLSEXT_comp_cert_none && !cert_comp_available(expected)) {
+        TEST_info("Certificate compression algorithm not available");
+        return 1;
+    }
+
+    if (!TEST_ptr(rootfile = test_mk_file_path(certsdir, "rootcert.pem"))
+            || !TEST_ptr(in = BIO_new_file(rootfile, "r"))
+            || !TEST_ptr(rootx = PEM_read_bio_X509(in, NULL, NULL, NULL)))
+        goto end;
+
+    /* An explicit chain makes the compressed certificate cacheable */
+    if (!TEST_true(create_ssl_ctx_pair(TLS_server_method(), TLS_client_method(),
+                                       TLS1_3_VERSION, 0,
+                                       &sctx, &cctx, cert, privkey))
+            || !TEST_true(SSL_CTX_add1_chain_cert(sctx, rootx)))
+        goto end;
+    cert_comp_compress_calls = cert_comp_expand_calls = 0;
+    if (tst == 5
+            && (!TEST_true(SSL_CTX_set_cert_comp_callbacks(
+                               sctx, TLSEXT_comp_cert_zstd, cert_comp_invert,
+                               cert_comp_uninvert, &cert_comp_compress_calls))
+                || !TEST_true(SSL_CTX_set_cert_comp_callbacks(
+                                  cctx, TLSEXT_comp_cert_zstd, cert_comp_invert,
+                                  cert_comp_uninvert,
+                                  &cert_comp_expand_calls))))
+        goto end;
+    if (!TEST_true(SSL_CTX_set1_cert_comp_preference(cctx, cprefs,
+                                                            cnum))
+            || !TEST_true(SSL_CTX_set1_cert_comp_preference(sctx, sprefs,
+                                                            snum)))
+        goto end;
+
+    /*
+     * The second connection uses the cached compressed certificate. The chain
+     * is then removed, and the third connection must not see the old one.
+     */
+    for (i = 0; i < 3; i++) {
+        if (i == 2 && !TEST_true(SSL_CTX_clear_chain_certs(sctx)))
+            goto end;
+        if (!TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+                                          NULL, NULL))
+                || !TEST_true(create_ssl_connection(serverssl, clientssl,
+                                                    SSL_ERROR_NONE))
+                || !TEST_int_eq(SSL_get_negotiated_server_cert_comp_alg(
+                                    serverssl), expected)
+                || !TEST_int_eq(SSL_get_negotiated_server_cert_comp_alg(
+                                    clientssl), expected)
+                || !TEST_int_eq(sk_X509_num(SSL_get_peer_cert_chain(clientssl)),
+                                i < 2 ? 2 : 1))
+            goto end;
+        if (i < 2
+                && !TEST_int_eq(X509_cmp(sk_X509_value(
+                                             SSL_get_peer_cert_chain(clientssl),
+                                             1), rootx), 0))
+            goto end;
+
+        SSL_shutdown(clientssl);
+        SSL_shutdown(serverssl);
+        SSL_free(serverssl);
+        SSL_free(clientssl);
+        serverssl = clientssl = NULL;
+    }
+
+    /* Compressed once for each chain, expanded on every connection */
+    if (tst == 5
+            && (!TEST_int_eq(cert_comp_compress_calls, 2)
+                || !TEST_int_eq(cert_comp_expand_calls, 3)))
+        goto end;
+
+    testresult = 1;
+
+ end:
+    X509_free(rootx);
+    BIO_free(in);
+    OPENSSL_free(rootfile);
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+#endif
+
 OPT_TEST_DECLARE_USAGE("certfile privkeyfile srpvfile tmpfile\n")
 
 int setup_tests(void)
@@ -7391,6 +8060,24 @@ int setup_tests(void)
     ADD_ALL_TESTS(test_multiblock_write, OSSL_NELEM(multiblock_cipherlist_data));
 #endif
     ADD_ALL_TESTS(test_servername, 10);
+#if !defined(OPENSSL_NO_TLS1_3) \
+    && (!defined(OPENSSL_NO_EC) || !defined(OPENSSL_NO_DH))
+    ADD_TEST(test_key_share_pool);
+#endif
+#ifndef OPENSSL_NO_TLS1_2
+    ADD_TEST(test_client_hello_ciphers);
+    ADD_ALL_TESTS(test_server_cipher_set, 2);
+#endif
+#if !defined(OPENSSL_NO_TLS1_3) && !defined(OPENSSL_NO_EC)
+    ADD_TEST(test_client_hello_templates);
+#endif
+#if !defined(OPENSSL_NO_TLS1_2) && !defined(OPENSSL_NO_EC)
+    ADD_ALL_TESTS(test_server_group_sigalg_set, 2);
+#endif
+    ADD_ALL_TESTS(test_cert_chain_cache, 2);
+#ifndef OPENSSL_NO_TLS1_3
+    ADD_ALL_TESTS(test_cert_compression, 6);
+#endif
     return 1;
 }
 
@@ -12,6 +12,7 @@
 #endif
 
 #include <openssl/crypto.h>
+#include <openssl/evp.h>
 #include "testutil.h"
 
 #if !defined(OPENSSL_THREADS) || defined(CRYPTO_TDEBUG)
@@ -184,10 +185,64 @@ static int test_thread_local(void)
     return 1;
 }
 
+/*
+ * The methods implicitly fetched for legacy EVP_MDs are cached per thread.
+ * Check that threads using that cache can stop, both with and without
+ * OPENSSL_thread_stop(), while other threads keep using theirs.
+ */
+static int implicit_fetch_thread_ok[2];
+
+static int implicit_fetch_digest(void)
+{
+    static const unsigned char msg[] = "abc";
+    static const unsigned char expected[] = {
+        0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea,
+        0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+        0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+        0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+    };
+    unsigned char md[EVP_MAX_MD_SIZE];
+    unsigned int mdlen;
+    int i;
+
+    for (i = 0; i < 2; i++)
+        if (!TEST_true(EVP_Digest(msg, sizeof(msg) - 1, md, &mdlen,
+                                  EVP_sha256(), NULL))
+                || !TEST_mem_eq(md, mdlen, expected, sizeof(expected)))
+            return 0;
+    return 1;
+}
+
+static void implicit_fetch_thread_cb(void)
+{
+    implicit_fetch_thread_ok[0] = implicit_fetch_digest();
+}
+
+static void implicit_fetch_thread_stop_cb(void)
+{
+    implicit_fetch_thread_ok[1] = implicit_fetch_digest();
+    OPENSSL_thread_stop();
+}
+
+static int test_implicit_fetch_threads(void)
+{
+    thread_t thread1, thread2;
+
+    return TEST_true(implicit_fetch_digest())
+           && TEST_true(run_thread(&thread1, implicit_fetch_thread_cb))
+           && TEST_true(run_thread(&thread2, implicit_fetch_thread_stop_cb))
+           && TEST_true(wait_for_thread(thread1))
+           && TEST_true(wait_for_thread(thread2))
+           && TEST_true(implicit_fetch_thread_ok[0])
+           && TEST_true(implicit_fetch_thread_ok[1])
+           && TEST_true(implicit_fetch_digest());
+}
+
 int setup_tests(void)
 {
     ADD_TEST(test_lock);
     ADD_TEST(test_once);
     ADD_TEST(test_thread_local);
+    ADD_TEST(test_implicit_fetch_threads);
     return 1;
 }
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * Internal tests for the lookup of TLS groups and signature algorithms by
+ * their code point, which also time the lookups against a scan of the same
+ * entries.
+ */
+
+#include <time.h>
+#include <openssl/ssl.h>
+#include "testutil.h"
+#include "../ssl/ssl_local.h"
+
+/* The number of times each known code point is looked up for the timing */
+#define LOOKUP_ROUNDS 20000
+
+/* More than there are groups or sigalgs, see t1_lib.c */
+#define MAX_ENTRIES 64
+
+typedef const void *LOOKUP_FN(uint16_t code);
+typedef uint16_t CODE_FN(const void *entry);
+
+static const void *group_lookup(uint16_t code)
+{
+    return tls1_group_id_lookup(code);
+}
+
+static uint16_t group_code(const void *entry)
+{
+    return ((const TLS_GROUP_INFO *)entry)->group_id;
+}
+
+static const void *sigalg_lookup(uint16_t code)
+{
+    return tls1_lookup_sigalg(code);
+}
+
+static uint16_t sigalg_code(const void *entry)
+{
+    return ((const SIGALG_LOOKUP *)entry)->sigalg;
+}
+
+/* Look |code| up the way it was done before there was a hash table */
+static const void *scan(const void **entries, size_t n, CODE_FN *code_of,
+                        uint16_t code)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++)
+        if (code_of(entries[i]) == code)
+            return entries[i];
+    return NULL;
+}
+
+static double ns_per_lookup(clock_t start, size_t n)
+{
+    return (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC
+           / ((double)n * LOOKUP_ROUNDS);
+}
+
+static int test_lookup(const char *name, LOOKUP_FN *lookup, CODE_FN *code_of)
+{
+    const void *entries[MAX_ENTRIES];
+    uint16_t codes[MAX_ENTRIES];
+    const void *entry;
+    size_t n = 0, i, r;
+    unsigned long code;
+    uintptr_t sink = 0;
+    clock_t start;
+    double hashed, scanned;
+
+    /* Every code point must give either nothing or its own entry */
+    for (code = 0; code <= 0xffff; code++) {
+        if ((entry = lookup((uint16_t)code)) == NULL)
+            continue;
+        if (!TEST_uint_eq(code_of(entry), code)
+                || !TEST_size_t_lt(n, MAX_ENTRIES))
+            return 0;
+        entries[n] = entry;
+        codes[n++] = (uint16_t)code;
+    }
+    if (n == 0) {
+        TEST_note("no %s in this build", name);
+        return 1;
+    }
+
+    start = clock();
+    for (r = 0; r < LOOKUP_ROUNDS; r++)
+        for (i = 0; i < n; i++)
+            sink += (uintptr_t)lookup(codes[i]);
+    hashed = ns_per_lookup(start, n);
+
+    start = clock();
+    for (r = 0; r < LOOKUP_ROUNDS; r++)
+        for (i = 0; i < n; i++)
+            sink -= (uintptr_t)scan(entries, n, code_of, codes[i]);
+    scanned = ns_per_lookup(start, n);
+
+    TEST_info("%zu %s: %.1f ns per lookup by hash, %.1f ns by scan",
+              n, name, hashed, scanned);
+    /* Both must have found the same entries */
+    return TEST_true(sink == 0);
+}
+
+static int test_group_lookup(void)
+{
+    return test_lookup("groups", group_lookup, group_code);
+}
+
+static int test_sigalg_lookup(void)
+{
+    return test_lookup("sigalgs", sigalg_lookup, sigalg_code);
+}
+
+int setup_tests(void)
+{
+    /* The lookup tables are filled in when libssl is initialised */
+    if (!TEST_true(OPENSSL_init_ssl(0, NULL)))
+        return 0;
+    ADD_TEST(test_group_lookup);
+    ADD_TEST(test_sigalg_lookup);
+    return 1;
+}
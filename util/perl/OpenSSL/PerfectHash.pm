@@ -0,0 +1,125 @@
+# Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+#
+# Licensed under the Apache License 2.0 (the "License").  You may not use
+# this file except in compliance with the License.  You can obtain a copy
+# in the file LICENSE in the source distribution or at
+# https://www.openssl.org/source/license.html
+
+package OpenSSL::PerfectHash;
+
+use strict;
+use warnings;
+
+use Exporter;
+use vars qw($VERSION @ISA @EXPORT_OK);
+
+$VERSION = '0.1';
+@ISA = qw(Exporter);
+@EXPORT_OK = qw(fnv1a perfect_hash format_numbers);
+
+=head1 NAME
+
+OpenSSL::PerfectHash - build perfect hash tables for generated C sources
+
+=head1 SYNOPSIS
+
+  use OpenSSL::PerfectHash qw(fnv1a perfect_hash format_numbers);
+
+  my $table = perfect_hash(@keys);
+
+=head1 DESCRIPTION
+
+The hash is FNV-1a over the bytes of the key, started from
+C<2166136261 ^ seed>.  The table is built with "hash and displace": keys
+are first spread over C<buckets> with seed 0, and each bucket then gets the
+first seed that puts all its keys in free C<slots>.  A lookup in C is
+therefore:
+
+  i = slot[fnv1a(seed[fnv1a(0, key) & (buckets - 1)], key) & (slots - 1)]
+
+followed by one compare of I<key> with the key at index I<i>, if I<i> isn't
+-1.  Any case folding is up to the caller, who must fold the keys given
+here and the keys hashed in C the same way.
+
+=over 4
+
+=item fnv1a SEED, KEY
+
+Returns the 32-bit hash of I<KEY> with I<SEED>.
+
+=item perfect_hash KEYS
+
+Returns a reference to a hash with the table for the list I<KEYS>:
+C<slots> and C<buckets> are the sizes, both powers of two, C<seeds> is a
+reference to the list of seeds per bucket and C<slot> a reference to the
+list of indexes into I<KEYS> per slot, with -1 for unused slots.
+
+=item format_numbers PER_LINE, NUMBERS
+
+Returns I<NUMBERS> formatted as the lines of a C array initialiser, with
+I<PER_LINE> numbers per line.
+
+=back
+
+=cut
+
+sub fnv1a {
+    my ($seed, $s) = @_;
+    my $h = (2166136261 ^ $seed) & 0xffffffff;
+
+    foreach (unpack 'C*', $s) {
+        $h ^= $_;
+        $h = ($h * 16777619) & 0xffffffff;
+    }
+    return $h;
+}
+
+sub perfect_hash {
+    my @keys = @_;
+    my $n = scalar @keys;
+
+    # A load factor of about 3/4 keeps the search for displacements short
+    my $slots = 1;
+    $slots <<= 1 while $slots * 3 < $n * 4;
+    my $buckets = 1;
+    $buckets <<= 1 while $buckets * 4 < $n;
+
+    my @bucket = map { [] } 1 .. $buckets;
+    push @{$bucket[fnv1a(0, $keys[$_]) & ($buckets - 1)]}, $_
+        foreach 0 .. $n - 1;
+
+    my @slot = (-1) x $slots;
+    my @seed = (0) x $buckets;
+    foreach my $b (sort { scalar @{$bucket[$b]} <=> scalar @{$bucket[$a]}
+                          || $a <=> $b } 0 .. $buckets - 1) {
+        my @members = @{$bucket[$b]};
+        next unless @members;
+      SEED:
+        for (my $s = 1; ; $s++) {
+            die "Can't find a perfect hash\n" if $s > 1000000;
+            my %taken;
+            foreach (@members) {
+                my $i = fnv1a($s, $keys[$_]) & ($slots - 1);
+                next SEED if $slot[$i] >= 0 || $taken{$i}++;
+            }
+            $slot[fnv1a($s, $keys[$_]) & ($slots - 1)] = $_ foreach @members;
+            $seed[$b] = $s;
+            last;
+        }
+    }
+
+    return { slots => $slots, buckets => $buckets,
+             seeds => [ @seed ], slot => [ @slot ] };
+}
+
+sub format_numbers {
+    my ($per_line, @numbers) = @_;
+    my $out = '';
+
+    while (my @line = splice @numbers, 0, $per_line) {
+        $out .= "    " . join(", ", @line) . ",\n";
+    }
+    return $out;
+}
+
+1;